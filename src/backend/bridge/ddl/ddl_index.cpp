@@ -10,6 +10,7 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include <cstring>
 #include <vector>
 #include <thread>
 
@@ -79,9 +80,7 @@ bool DDLIndex::CreateIndex(IndexInfo index_info) {
   if (table_name.empty()) return false;
   if (key_column_names.size() <= 0) return false;
 
-  // TODO: We currently only support btree as our index implementation
-  // TODO : Support other types based on "type" argument
-  IndexType our_index_type = INDEX_TYPE_BTREE;
+  IndexType our_index_type = index_info.GetMethodType();
 
   // Get the database oid and table oid
   oid_t database_oid = Bridge::GetCurrentDatabaseOid();
@@ -137,7 +136,12 @@ bool DDLIndex::CreateIndex(IndexInfo index_info) {
   index::Index *index = index::IndexFactory::GetInstance(metadata);
 
   // Record the built index in the table
-  data_table->AddIndex(index);
+  if (data_table->AddIndex(index) == false) {
+    LOG_WARN("Could not create index %s on %s, the keys are not unique.",
+             index_name.c_str(), table_name.c_str());
+    delete index;
+    return false;
+  }
 
   LOG_INFO("Created index(%lu)  %s on %s.", index_oid, index_name.c_str(),
            table_name.c_str());
@@ -196,8 +200,12 @@ IndexInfo *DDLIndex::ConstructIndexInfoByParsingIndexStmt(IndexStmt *Istmt) {
   }
 
   // Index method type
-  // TODO :: More access method types need
-  method_type = INDEX_TYPE_BTREE;
+  // Hash indexes only support equality lookups, all other methods map to btree
+  if (Istmt->accessMethod != NULL && strcmp(Istmt->accessMethod, "hash") == 0) {
+    method_type = INDEX_TYPE_HASH;
+  } else {
+    method_type = INDEX_TYPE_BTREE;
+  }
 
   IndexInfo *index_info =
       new IndexInfo(index_name, index_oid, table_name, method_type, type,
@@ -3,6 +3,7 @@
 #include "backend/bridge/ddl/format_transformer.h"
 #include "backend/common/exception.h"
 
+#include "catalog/pg_am.h"
 #include "catalog/pg_class.h"
 #include "access/heapam.h"
 #include "access/htup_details.h"
@@ -89,7 +90,8 @@ void raw_database_info::CollectRawTableAndIndex(void) {
       }
 
       case 'i': {
-        AddRawIndex(relation_oid, relation_name, raw_columns);
+        AddRawIndex(relation_oid, relation_name, pg_class->relam,
+                    raw_columns);
         break;
       }
 
@@ -280,6 +282,7 @@ void raw_database_info::AddRawTable(oid_t table_oid, std::string table_name,
 }
 
 void raw_database_info::AddRawIndex(oid_t index_oid, std::string index_name,
+                                    oid_t access_method_oid,
                                     std::vector<raw_column_info> raw_columns) {
   Relation pg_index_rel;
   HeapScanDesc pg_index_scan;
@@ -306,7 +309,12 @@ void raw_database_info::AddRawIndex(oid_t index_oid, std::string index_name,
         key_column_names.push_back(raw_column.GetColName());
       }
 
+      // Hash indexes only support equality lookups, all other access methods
+      // map to btree
       IndexType method_type = INDEX_TYPE_BTREE;
+      if (access_method_oid == HASH_AM_OID) {
+        method_type = INDEX_TYPE_HASH;
+      }
       IndexConstraintType type;
 
       if (pg_index->indisprimary) {
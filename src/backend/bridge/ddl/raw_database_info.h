@@ -40,6 +40,7 @@ class raw_database_info {
                    std::vector<raw_column_info> raw_columns);
 
   void AddRawIndex(oid_t index_oid, std::string index_name,
+                   oid_t access_method_oid,
                    std::vector<raw_column_info> raw_columns);
 
   void AddRawForeignKey(raw_foreign_key_info raw_foreign_key);
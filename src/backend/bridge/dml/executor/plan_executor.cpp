@@ -12,6 +12,8 @@
 
 #include "plan_executor.h"
 #include <cassert>
+#include <chrono>
+#include <thread>
 
 #include "backend/bridge/dml/mapper/mapper.h"
 #include "backend/bridge/dml/tuple/tuple_transformer.h"
@@ -19,6 +21,8 @@
 #include "backend/concurrency/transaction_manager.h"
 #include "backend/executor/executors.h"
 #include "backend/executor/executor_context.h"
+#include "backend/expression/container_tuple.h"
+#include "backend/planner/exchange_plan.h"
 #include "backend/storage/tuple_iterator.h"
 
 #include "access/tupdesc.h"
@@ -39,6 +43,8 @@ void CleanExecutorTree(executor::AbstractExecutor *root);
 
 /**
  * @brief Build a executor tree and execute it.
+ * A single statement transaction that lost a write-write conflict is retried
+ * a few times with a new snapshot, as nothing has been sent out yet.
  * @return status of execution.
  */
 peloton_status PlanExecutor::ExecutePlan(const planner::AbstractPlan *plan,
@@ -48,15 +54,10 @@ peloton_status PlanExecutor::ExecutePlan(const planner::AbstractPlan *plan,
 
   if (plan == nullptr) return p_status;
 
-  LOG_TRACE("PlanExecutor Start ");
-
-  bool status;
-  bool init_failure = false;
-  bool single_statement_txn = false;
-  List *slots = NULL;
-
   auto &txn_manager = concurrency::TransactionManager::GetInstance();
   auto txn = peloton::concurrency::current_txn;
+  bool single_statement_txn = false;
+
   // This happens for single statement queries in PG
   if (txn == nullptr) {
     single_statement_txn = true;
@@ -64,6 +65,48 @@ peloton_status PlanExecutor::ExecutePlan(const planner::AbstractPlan *plan,
   }
   assert(txn);
 
+  std::chrono::microseconds backoff(STATEMENT_RETRY_BACKOFF);
+  for (int retry_count = 0;; retry_count++) {
+    p_status = ExecutePlan(plan, param_list, tuple_desc, txn,
+                           single_statement_txn);
+
+    // Only a transaction aborted by a write-write conflict (or by wait-die)
+    // runs again, a failure would just fail again
+    if (single_statement_txn == false ||
+        p_status.m_result != Result::RESULT_ABORTED ||
+        retry_count == STATEMENT_RETRY_LIMIT) {
+      break;
+    }
+
+    LOG_INFO("Retrying single statement txn after write-write conflict");
+    std::this_thread::sleep_for(backoff);
+    backoff *= 2;
+
+    txn = txn_manager.BeginTransaction();
+  }
+
+  return p_status;
+}
+
+/**
+ * @brief Build a executor tree and execute it once in the given transaction.
+ * @return status of execution.
+ */
+peloton_status PlanExecutor::ExecutePlan(const planner::AbstractPlan *plan,
+                                         ParamListInfo param_list,
+                                         TupleDesc tuple_desc,
+                                         concurrency::Transaction *txn,
+                                         bool single_statement_txn) {
+  peloton_status p_status;
+
+  LOG_TRACE("PlanExecutor Start ");
+
+  bool status;
+  bool init_failure = false;
+  List *slots = NULL;
+
+  auto &txn_manager = concurrency::TransactionManager::GetInstance();
+
   LOG_TRACE("Txn ID = %lu ", txn->GetTransactionId());
   LOG_TRACE("Building the executor tree");
 
@@ -128,6 +171,9 @@ cleanup:
   LOG_TRACE("About to commit: single stmt: %d, init_failure: %d, status: %d",
             single_statement_txn, init_failure, txn->GetResult());
 
+  // Read the result before the transaction ends
+  p_status.m_result = txn->GetResult();
+
   // should we commit or abort ?
   if (single_statement_txn == true || init_failure == true) {
     auto status = txn->GetResult();
@@ -138,6 +184,12 @@ cleanup:
 
         break;
 
+      case Result::RESULT_ABORTED:
+        // Abort, lost a write-write conflict and may be retried
+        txn_manager.AbortTransaction();
+
+        break;
+
       case Result::RESULT_FAILURE:
       default:
         // Abort
@@ -150,7 +202,6 @@ cleanup:
   // Clean executor context
   delete executor_context;
 
-  p_status.m_result = txn->GetResult();
   return p_status;
 }
 
@@ -233,6 +284,11 @@ executor::AbstractExecutor *BuildExecutorTree(
           new executor::NestedLoopJoinExecutor(plan, executor_context);
       break;
 
+    case PLAN_NODE_TYPE_NESTLOOPINDEX:
+      child_executor =
+          new executor::NestedLoopIndexJoinExecutor(plan, executor_context);
+      break;
+
     case PLAN_NODE_TYPE_MERGEJOIN:
       child_executor = new executor::MergeJoinExecutor(plan, executor_context);
       break;
@@ -262,6 +318,10 @@ executor::AbstractExecutor *BuildExecutorTree(
       child_executor = new executor::OrderByExecutor(plan, executor_context);
       break;
 
+    case PLAN_NODE_TYPE_EXCHANGE:
+      child_executor = new executor::ExchangeExecutor(plan, executor_context);
+      break;
+
     default:
       LOG_ERROR("Unsupported plan node type : %d ", plan_node_type);
       break;
@@ -275,6 +335,22 @@ executor::AbstractExecutor *BuildExecutorTree(
       root = child_executor;
   }
 
+  // Every worker of an exchange runs its own copy of the pipeline below it
+  if (plan_node_type == PLAN_NODE_TYPE_EXCHANGE) {
+    auto exchange_executor =
+        static_cast<executor::ExchangeExecutor *>(child_executor);
+    auto exchange_plan = static_cast<const planner::ExchangePlan *>(plan);
+    assert(plan->GetChildren().size() == 1);
+
+    for (size_t worker = 0; worker < exchange_plan->GetWorkerCount();
+         worker++) {
+      BuildExecutorTree(exchange_executor, plan->GetChildren().front(),
+                        exchange_executor->AddWorkerContext());
+    }
+
+    return root;
+  }
+
   // Recurse
   auto children = plan->GetChildren();
   for (auto child : children) {
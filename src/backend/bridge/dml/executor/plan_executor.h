@@ -20,6 +20,11 @@
 #include "postmaster/peloton.h"
 
 namespace peloton {
+
+namespace concurrency {
+class Transaction;
+}
+
 namespace bridge {
 
 //===--------------------------------------------------------------------===//
@@ -43,6 +48,11 @@ class PlanExecutor {
                                     TupleDesc m_tuple_desc);
 
  private:
+  static peloton_status ExecutePlan(const planner::AbstractPlan *plan,
+                                    ParamListInfo m_param_list,
+                                    TupleDesc m_tuple_desc,
+                                    concurrency::Transaction *txn,
+                                    bool single_statement_txn);
 };
 
 }  // namespace bridge
@@ -140,7 +140,9 @@ struct MergeJoinPlanState : public AbstractJoinPlanState {
   MergeJoinClause mj_Clauses; /* array of length mj_NumClauses */
 };
 
-struct HashJoinPlanState : public AbstractJoinPlanState {};
+struct HashJoinPlanState : public AbstractJoinPlanState {
+  List *outer_hashkeys;
+};
 
 struct AggPlanState : public AbstractPlanState {
   const Agg *agg_plan;
@@ -437,6 +437,8 @@ HashJoinPlanState *DMLUtils::PrepareHashJoinState(HashJoinState *hj_state) {
   PrepareAbstractJoinPlanState(static_cast<AbstractJoinPlanState *>(info),
                                hj_state->js);
 
+  info->outer_hashkeys = CopyExprStateList(hj_state->hj_OuterHashKeys);
+
   return info;
 }
 
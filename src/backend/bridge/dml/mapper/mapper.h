@@ -199,6 +199,9 @@ class PlanTransformer {
 
   static const planner::ProjectInfo *BuildProjectInfoFromTLSkipJunk(
       List *targetLis);
+
+  static const planner::AbstractPlan *BuildParallelPipeline(
+      const planner::AbstractPlan *plan);
 };
 
 }  // namespace bridge
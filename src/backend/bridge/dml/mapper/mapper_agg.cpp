@@ -141,8 +141,11 @@ const planner::AbstractPlan *PlanTransformer::TransformAgg(
 
   ((planner::AggregatePlan *)retval)->SetColumnIds(column_ids);
 
-  // Find children
+  // Find children, the input of a sorted aggregation keeps its order
   auto lchild = TransformPlan(outerAbstractPlanState(plan_state));
+  if (agg_type != AGGREGATE_TYPE_SORTED) {
+    lchild = BuildParallelPipeline(lchild);
+  }
   retval->AddChild(lchild);
 
   return retval;
@@ -33,7 +33,7 @@ const planner::AbstractPlan *PlanTransformer::TransformHash(
   AbstractPlanState *subplan_state = outerAbstractPlanState(hash_state);
   auto plan_node = new planner::HashPlan(hashkeys);
   assert(subplan_state != nullptr);
-  plan_node->AddChild(TransformPlan(subplan_state));
+  plan_node->AddChild(BuildParallelPipeline(TransformPlan(subplan_state)));
 
   return plan_node;
 }
@@ -32,6 +32,14 @@ const planner::AbstractPlan *PlanTransformer::TransformHashJoin(
   planner::HashJoinPlan *plan_node = nullptr;
   PelotonJoinType join_type =
       PlanTransformer::TransformJoinType(hj_plan_state->jointype);
+
+  // Only the hash join executor runs semi and anti joins
+  if (hj_plan_state->jointype == JOIN_SEMI) {
+    join_type = JOIN_TYPE_SEMI;
+  } else if (hj_plan_state->jointype == JOIN_ANTI) {
+    join_type = JOIN_TYPE_ANTI;
+  }
+
   if (join_type == JOIN_TYPE_INVALID) {
     LOG_ERROR("unsupported join type: %d", hj_plan_state->jointype);
     return nullptr;
@@ -39,11 +47,10 @@ const planner::AbstractPlan *PlanTransformer::TransformHashJoin(
 
   LOG_INFO("Handle hash join with join type: %d", join_type);
 
-  /*
-  std::vector<planner::HashJoinPlan::JoinClause> join_clauses(
-      BuildHashJoinClauses(mj_plan_state->mj_Clauses,
-                            mj_plan_state->mj_NumClauses);
-  */
+  // The hash clauses are not part of the join qual, the executor compares
+  // the outer hash keys with the hash keys of the inner hash plan
+  auto outer_hash_keys = ExprTransformer::TransformExprList(
+      reinterpret_cast<ExprState *>(hj_plan_state->outer_hashkeys));
 
   expression::AbstractExpression *join_filter = ExprTransformer::TransformExpr(
       reinterpret_cast<ExprState *>(hj_plan_state->joinqual));
@@ -75,12 +82,13 @@ const planner::AbstractPlan *PlanTransformer::TransformHashJoin(
         hj_plan_state->tts_tupleDescriptor);
     result =
         new planner::ProjectionPlan(project_info.release(), project_schema);
-    plan_node = new planner::HashJoinPlan(join_type, predicate, nullptr);
+    plan_node = new planner::HashJoinPlan(join_type, predicate, nullptr,
+                                          outer_hash_keys);
     result->AddChild(plan_node);
   } else {
     LOG_INFO("We have direct mapping projection");
-    plan_node =
-        new planner::HashJoinPlan(join_type, predicate, project_info.release());
+    plan_node = new planner::HashJoinPlan(
+        join_type, predicate, project_info.release(), outer_hash_keys);
     result = plan_node;
   }
 
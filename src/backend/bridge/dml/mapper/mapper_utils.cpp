@@ -10,17 +10,23 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include <thread>
+
 #include "backend/bridge/dml/mapper/mapper.h"
 #include "backend/bridge/ddl/schema_transformer.h"
 #include "backend/catalog/manager.h"
 #include "backend/planner/projection_plan.h"
 #include "backend/planner/aggregate_plan.h"
 #include "backend/planner/abstract_scan_plan.h"
+#include "backend/planner/exchange_plan.h"
 #include "backend/expression/tuple_value_expression.h"
 
 namespace peloton {
 namespace bridge {
 
+// Tile groups of a table before its scan is split between workers
+static const oid_t PARALLEL_SCAN_MIN_TILE_GROUP_COUNT = 4;
+
 //===--------------------------------------------------------------------===//
 // Utils
 //===--------------------------------------------------------------------===//
@@ -440,6 +446,43 @@ const std::vector<oid_t> PlanTransformer::BuildColumnListFromTargetList(
   return rv;
 }
 
+/**
+ * @brief Put a pipeline under an exchange, so that all cores run it, if it
+ * scans a large enough table. Only a chain of projections and
+ * materializations over a sequential scan is split between workers.
+ * @return the exchange plan, or the pipeline itself.
+ */
+const planner::AbstractPlan *PlanTransformer::BuildParallelPipeline(
+    const planner::AbstractPlan *plan) {
+  size_t worker_count = std::thread::hardware_concurrency();
+  if (plan == nullptr || worker_count <= 1) return plan;
+
+  const planner::AbstractPlan *leaf = plan;
+  while (leaf->GetPlanNodeType() != PLAN_NODE_TYPE_SEQSCAN) {
+    auto plan_node_type = leaf->GetPlanNodeType();
+    if ((plan_node_type != PLAN_NODE_TYPE_PROJECTION &&
+         plan_node_type != PLAN_NODE_TYPE_MATERIALIZE) ||
+        leaf->GetChildren().size() != 1) {
+      return plan;
+    }
+    leaf = leaf->GetChildren().front();
+  }
+
+  auto target_table = static_cast<const planner::AbstractScan *>(leaf)
+                          ->GetTable();
+  if (target_table == nullptr || leaf->GetChildren().empty() == false ||
+      target_table->GetTileGroupCount() < PARALLEL_SCAN_MIN_TILE_GROUP_COUNT) {
+    return plan;
+  }
+
+  LOG_INFO("Running the scan of %s with %lu workers",
+           target_table->GetName().c_str(), worker_count);
+
+  auto exchange_plan = new planner::ExchangePlan(worker_count);
+  exchange_plan->AddChild(plan);
+  return exchange_plan;
+}
+
 void PlanTransformer::AnalyzePlan(planner::AbstractPlan *plan,
                                   PlanState *planstate) {
   std::vector<oid_t> target_list;
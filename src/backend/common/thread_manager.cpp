@@ -12,6 +12,8 @@
 
 #include "backend/common/thread_manager.h"
 
+#include <vector>
+
 namespace peloton {
 
 // global singleton
@@ -50,5 +52,30 @@ bool ThreadManager::DetachThread(std::shared_ptr<std::thread> thread) {
   }
 }
 
+void ThreadManager::RunInParallel(size_t part_count,
+                                  const std::function<void(size_t)> &worker) {
+  size_t thread_count = std::thread::hardware_concurrency();
+  if (thread_count > part_count) {
+    thread_count = part_count;
+  }
+
+  // The threads take the next part in turns
+  std::atomic<size_t> next_part(0);
+  auto take_parts = [&]() {
+    for (size_t part = next_part++; part < part_count; part = next_part++) {
+      worker(part);
+    }
+  };
+
+  std::vector<std::thread> threads;
+  for (size_t thread_itr = 1; thread_itr < thread_count; thread_itr++) {
+    threads.emplace_back(take_parts);
+  }
+  take_parts();
+
+  for (auto &thread : threads) {
+    thread.join();
+  }
+}
 
 }  // End peloton namespace
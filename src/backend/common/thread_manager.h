@@ -13,6 +13,7 @@
 #pragma once
 
 #include <atomic>
+#include <functional>
 #include <set>
 #include <mutex>
 #include <memory>
@@ -36,6 +37,10 @@ class ThreadManager {
 
   bool DetachThread(std::shared_ptr<std::thread> thread);
 
+  // Run the worker on every part, with as many threads as the hardware has
+  static void RunInParallel(size_t part_count,
+                            const std::function<void(size_t)> &worker);
+
  private:
 
   // thread pool
@@ -610,6 +610,15 @@ std::string IndexTypeToString(IndexType type) {
     case INDEX_TYPE_BWTREE: {
       return "BWTREE";
     }
+    case INDEX_TYPE_OLCBTREE: {
+      return "OLCBTREE";
+    }
+    case INDEX_TYPE_HASH: {
+      return "HASH";
+    }
+    case INDEX_TYPE_ART: {
+      return "ART";
+    }
   }
   return "INVALID";
 }
@@ -621,6 +630,12 @@ IndexType StringToIndexType(std::string str) {
     return INDEX_TYPE_BTREE;
   }  else if (str == "BWTREE") {
     return INDEX_TYPE_BWTREE;
+  }  else if (str == "OLCBTREE") {
+    return INDEX_TYPE_OLCBTREE;
+  }  else if (str == "HASH") {
+    return INDEX_TYPE_HASH;
+  }  else if (str == "ART") {
+    return INDEX_TYPE_ART;
   }
   return INDEX_TYPE_INVALID;
 }
@@ -707,6 +722,9 @@ std::string PlanNodeTypeToString(PlanNodeType type) {
     case PLAN_NODE_TYPE_PRINT: {
       return "PRINT";
     }
+    case PLAN_NODE_TYPE_EXCHANGE: {
+      return "EXCHANGE";
+    }
     case PLAN_NODE_TYPE_AGGREGATE: {
       return "AGGREGATE";
     }
@@ -778,6 +796,8 @@ PlanNodeType StringToPlanNodeType(std::string str) {
     return PLAN_NODE_TYPE_RECEIVE;
   } else if (str == "PRINT") {
     return PLAN_NODE_TYPE_PRINT;
+  } else if (str == "EXCHANGE") {
+    return PLAN_NODE_TYPE_EXCHANGE;
   } else if (str == "AGGREGATE") {
     return PLAN_NODE_TYPE_AGGREGATE;
   } else if (str == "HASHAGGREGATE") {
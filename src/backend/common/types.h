@@ -95,6 +95,25 @@ class Value;
 
 #define DEFAULT_TUPLES_PER_TILEGROUP 1000
 
+// Memory a sort may use before it spills to disk, in bytes
+#define DEFAULT_SORT_MEMORY_BUDGET (64 * 1024 * 1024)
+
+// Memory the groups of a hash aggregation may use before it spills to disk,
+// in bytes
+#define DEFAULT_AGGREGATE_MEMORY_BUDGET (64 * 1024 * 1024)
+
+// How long a write waits in total for a tuple slot latched by a younger
+// transaction, in microseconds
+#define TUPLE_SLOT_WAIT_LIMIT 10000
+
+// Longest single backoff of a write waiting for a tuple slot, in microseconds
+#define TUPLE_SLOT_MAX_BACKOFF 1000
+
+// How many times a single statement transaction is retried after it lost a
+// write-write conflict, and the first backoff in between, in microseconds
+#define STATEMENT_RETRY_LIMIT 3
+#define STATEMENT_RETRY_BACKOFF 100
+
 // Ref count starting point
 #define BASE_REF_COUNT 1
 
@@ -342,7 +361,10 @@ enum IndexType {
   INDEX_TYPE_INVALID = 0,  // invalid index type
 
   INDEX_TYPE_BTREE = 1,  // btree
-  INDEX_TYPE_BWTREE = 2  // bwtree
+  INDEX_TYPE_BWTREE = 2,  // bwtree
+  INDEX_TYPE_OLCBTREE = 3,  // btree with optimistic lock coupling
+  INDEX_TYPE_HASH = 4,  // hash table
+  INDEX_TYPE_ART = 5  // adaptive radix tree
 };
 
 enum IndexConstraintType {
@@ -382,6 +404,7 @@ enum PlanNodeType {
   PLAN_NODE_TYPE_SEND = 40,
   PLAN_NODE_TYPE_RECEIVE = 41,
   PLAN_NODE_TYPE_PRINT = 42,
+  PLAN_NODE_TYPE_EXCHANGE = 43,
 
   // Algebra Nodes
   PLAN_NODE_TYPE_AGGREGATE = 50,
@@ -462,7 +485,9 @@ enum PelotonJoinType {
   JOIN_TYPE_LEFT = 1,   // left
   JOIN_TYPE_RIGHT = 2,  // right
   JOIN_TYPE_INNER = 3,  // inner
-  JOIN_TYPE_OUTER = 4   // outer
+  JOIN_TYPE_OUTER = 4,  // outer
+  JOIN_TYPE_SEMI = 5,   // left rows with a match
+  JOIN_TYPE_ANTI = 6    // left rows without a match
 };
 
 //===--------------------------------------------------------------------===//
@@ -688,6 +713,12 @@ static const cid_t START_CID = 1;
 
 static const cid_t MAX_CID = std::numeric_limits<cid_t>::max();
 
+// For log sequence number
+
+typedef uint64_t lsn_t;
+
+static const lsn_t INVALID_LSN = 0;
+
 //===--------------------------------------------------------------------===//
 // ItemPointer
 //===--------------------------------------------------------------------===//
@@ -1116,4 +1116,60 @@ Value Value::GetMinValue(ValueType type) {
   }
 }
 
+Value Value::GetMaxValue(ValueType type) {
+  switch (type) {
+    case (VALUE_TYPE_TINYINT):
+      return GetTinyIntValue(INT8_MAX);
+      break;
+    case (VALUE_TYPE_SMALLINT):
+      return GetSmallIntValue(INT16_MAX);
+      break;
+    case (VALUE_TYPE_INTEGER):
+      return GetIntegerValue(INT32_MAX);
+      break;
+    case (VALUE_TYPE_BIGINT):
+      return GetBigIntValue(INT64_MAX);
+      break;
+    case (VALUE_TYPE_DOUBLE):
+      return GetDoubleValue(DBL_MAX);
+      break;
+    case (VALUE_TYPE_TIMESTAMP):
+      return GetTimestampValue(INT64_MAX);
+      break;
+    case (VALUE_TYPE_DECIMAL):
+      return GetDecimalValue(s_maxDecimalValue);
+      break;
+    case (VALUE_TYPE_BOOLEAN):
+      return GetTrue();
+      break;
+
+    // strings have no max value
+    case (VALUE_TYPE_VARCHAR):
+    case (VALUE_TYPE_INVALID):
+    case (VALUE_TYPE_NULL):
+    case (VALUE_TYPE_ADDRESS):
+    case (VALUE_TYPE_VARBINARY):
+    default: {
+      throw UnknownTypeException((int)type, "Can't get max value for type");
+    }
+  }
+}
+
+bool Value::HasMaxValue(ValueType type) {
+  switch (type) {
+    case (VALUE_TYPE_TINYINT):
+    case (VALUE_TYPE_SMALLINT):
+    case (VALUE_TYPE_INTEGER):
+    case (VALUE_TYPE_BIGINT):
+    case (VALUE_TYPE_DOUBLE):
+    case (VALUE_TYPE_TIMESTAMP):
+    case (VALUE_TYPE_DECIMAL):
+    case (VALUE_TYPE_BOOLEAN):
+      return true;
+
+    default:
+      return false;
+  }
+}
+
 }  // End peloton namespace
@@ -395,6 +395,12 @@ class Value {
   // Get min value
   static Value GetMinValue(ValueType);
 
+  // Get max value, throws for types without one such as varchar
+  static Value GetMaxValue(ValueType);
+
+  // Check if GetMaxValue supports the type
+  static bool HasMaxValue(ValueType);
+
   int GetIntegerForTestsOnly() { return GetInteger(); }
 
   ////////////////////////////////////////////////////////////
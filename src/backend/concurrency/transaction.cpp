@@ -30,6 +30,10 @@ void Transaction::RecordDelete(ItemPointer location) {
   deleted_tuples[location.block].push_back(location.offset);
 }
 
+void Transaction::RecordUpdate(ItemPointer location) {
+  updated_tuples[location.block].push_back(location.offset);
+}
+
 const std::map<oid_t, std::vector<oid_t>> &Transaction::GetInsertedTuples() {
   return inserted_tuples;
 }
@@ -38,9 +42,14 @@ const std::map<oid_t, std::vector<oid_t>> &Transaction::GetDeletedTuples() {
   return deleted_tuples;
 }
 
+const std::map<oid_t, std::vector<oid_t>> &Transaction::GetUpdatedTuples() {
+  return updated_tuples;
+}
+
 void Transaction::ResetState(void) {
   inserted_tuples.clear();
   deleted_tuples.clear();
+  updated_tuples.clear();
 }
 
 const std::string Transaction::GetInfo() const{
@@ -72,11 +72,16 @@ class Transaction : public Printable {
   // record deleted tuple
   void RecordDelete(ItemPointer location);
 
+  // record tuple updated in place
+  void RecordUpdate(ItemPointer location);
+
   const std::map<oid_t, std::vector<oid_t>> &GetInsertedTuples();
 
   const std::map<oid_t, std::vector<oid_t>> &GetDeletedTuples();
 
-  // reset inserted tuples and deleted tuples
+  const std::map<oid_t, std::vector<oid_t>> &GetUpdatedTuples();
+
+  // reset inserted, deleted and updated tuples
   // used by recovery (logging)
   void ResetState(void);
 
@@ -123,6 +128,9 @@ class Transaction : public Printable {
   // deleted tuples
   std::map<oid_t, std::vector<oid_t>> deleted_tuples;
 
+  // tuples updated in place
+  std::map<oid_t, std::vector<oid_t>> updated_tuples;
+
   // synch helpers
   std::mutex txn_mutex;
 
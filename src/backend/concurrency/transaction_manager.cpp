@@ -10,6 +10,7 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include <algorithm>
 #include <chrono>
 #include <thread>
 #include <iomanip>
@@ -58,8 +59,14 @@ txn_id_t TransactionManager::GetNextTransactionId() {
 
 // Begin a new transaction
 Transaction *TransactionManager::BeginTransaction() {
-  Transaction *next_txn =
-      new Transaction(GetNextTransactionId(), GetLastCommitId());
+  Transaction *next_txn;
+
+  // Take the snapshot and record it at once, see GetOldestSnapshot
+  {
+    std::lock_guard<std::mutex> lock(txn_table_mutex);
+    next_txn = new Transaction(GetNextTransactionId(), GetLastCommitId());
+    running_snapshots[next_txn->txn_id] = next_txn->GetLastCommitId();
+  }
 
   // Log the BEGIN TXN record
   {
@@ -78,6 +85,22 @@ Transaction *TransactionManager::BeginTransaction() {
   return next_txn;
 }
 
+cid_t TransactionManager::GetOldestSnapshot() {
+  std::lock_guard<std::mutex> lock(txn_table_mutex);
+
+  cid_t oldest_snapshot = GetLastCommitId();
+  for (auto running_snapshot : running_snapshots) {
+    oldest_snapshot = std::min(oldest_snapshot, running_snapshot.second);
+  }
+
+  return oldest_snapshot;
+}
+
+void TransactionManager::ReleaseSnapshot(Transaction *txn) {
+  std::lock_guard<std::mutex> lock(txn_table_mutex);
+  running_snapshots.erase(txn->txn_id);
+}
+
 bool TransactionManager::IsValid(txn_id_t txn_id) {
   return (txn_id < next_txn_id);
 }
@@ -98,6 +121,7 @@ void TransactionManager::ResetStates(void) {
     delete curr_txn;
   }
   txn_table.clear();
+  running_snapshots.clear();
 }
 
 void TransactionManager::EndTransaction(Transaction *txn,
@@ -175,6 +199,18 @@ void TransactionManager::CommitModifications(Transaction *txn, bool sync
       tile_group->CommitDeletedTuple(tuple_slot, txn->txn_id, txn->cid);
   }
 
+  // (C) commit in-place updates
+  auto updated_tuples = txn->GetUpdatedTuples();
+  cid_t oldest_snapshot =
+      updated_tuples.empty() ? INVALID_CID : GetOldestSnapshot();
+  for (auto entry : updated_tuples) {
+    oid_t tile_group_id = entry.first;
+    auto tile_group = manager.GetTileGroup(tile_group_id);
+    for (auto tuple_slot : entry.second)
+      tile_group->CommitUpdatedTuple(tuple_slot, txn->txn_id, txn->cid,
+                                     oldest_snapshot);
+  }
+
   // Log the COMMIT TXN record
   {
     auto &log_manager = logging::LogManager::GetInstance();
@@ -261,6 +297,8 @@ void TransactionManager::CommitTransaction(bool sync) {
   // end commit phase : increment last_cid and process pending txns if needed
   std::vector<Transaction *> committed_txns = EndCommitPhase(current_txn, sync);
 
+  ReleaseSnapshot(current_txn);
+
   // process all committed txns
   for (auto committed_txn : committed_txns) committed_txn->DecrementRefCount();
 
@@ -308,8 +346,18 @@ void TransactionManager::AbortTransaction() {
       tile_group->AbortDeletedTuple(tuple_slot, txn_id);
   }
 
+  // (C) rollback in-place updates
+  for (auto entry : current_txn->GetUpdatedTuples()) {
+    oid_t tile_group_id = entry.first;
+    auto tile_group = manager.GetTileGroup(tile_group_id);
+    for (auto tuple_slot : entry.second)
+      tile_group->AbortUpdatedTuple(tuple_slot, txn_id, last_cid);
+  }
+
   EndTransaction(current_txn, false);
 
+  ReleaseSnapshot(current_txn);
+
   // drop a reference
   current_txn->DecrementRefCount();
 
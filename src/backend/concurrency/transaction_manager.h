@@ -45,6 +45,10 @@ class TransactionManager {
   // Get last commit id for visibility checks
   cid_t GetLastCommitId() { return last_cid; }
 
+  // Get the oldest snapshot of the running transactions, transactions that
+  // begin later get a newer one
+  cid_t GetOldestSnapshot();
+
   //===--------------------------------------------------------------------===//
   // Transaction processing
   //===--------------------------------------------------------------------===//
@@ -87,6 +91,9 @@ class TransactionManager {
   void AbortTransaction();
 
  private:
+  // Forget the snapshot of a finished transaction
+  void ReleaseSnapshot(Transaction *txn);
+
   //===--------------------------------------------------------------------===//
   // MEMBERS
   //===--------------------------------------------------------------------===//
@@ -105,6 +112,11 @@ class TransactionManager {
   std::map<txn_id_t, Transaction *> txn_table;
 
   std::mutex txn_table_mutex;
+
+  // Snapshots of the running transactions
+  // Our transaction id -> our last commit id
+  // Sync access with txn_table_mutex
+  std::map<txn_id_t, cid_t> running_snapshots;
 };
 
 }  // End concurrency namespace
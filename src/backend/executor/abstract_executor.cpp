@@ -33,6 +33,8 @@ LogicalTile *AbstractExecutor::GetOutput() {
   return output.release();
 }
 
+LogicalTile *AbstractExecutor::GetEmptyOutput() { return nullptr; }
+
 /**
  * @brief Add child executor to this executor node.
  * @param child Child executor to add.
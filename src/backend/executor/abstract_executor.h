@@ -59,6 +59,11 @@ class AbstractExecutor {
   // in test cases.
   virtual LogicalTile *GetOutput();
 
+  // A tile with the output columns but no rows, for a parent that needs the
+  // column layout of an input that returned nothing. The caller owns it, it
+  // is nullptr if the executor cannot tell its columns before a row.
+  virtual LogicalTile *GetEmptyOutput();
+
   const planner::AbstractPlan *GetRawNode() const { return node_; }
 
  protected:
@@ -240,7 +240,9 @@ bool AbstractJoinExecutor::BuildOuterJoinOutput() {
       break;
     }
 
-    case JOIN_TYPE_INNER: {
+    case JOIN_TYPE_INNER:
+    case JOIN_TYPE_SEMI:
+    case JOIN_TYPE_ANTI: {
       return false;
     }
 
@@ -42,6 +42,10 @@ class AbstractJoinExecutor : public AbstractExecutor {
         return "JOIN_TYPE_INNER";
       case JOIN_TYPE_OUTER:
         return "JOIN_TYPE_OUTER";
+      case JOIN_TYPE_SEMI:
+        return "JOIN_TYPE_SEMI";
+      case JOIN_TYPE_ANTI:
+        return "JOIN_TYPE_ANTI";
       case JOIN_TYPE_INVALID:
       default:
         return "JOIN_TYPE_INVALID";
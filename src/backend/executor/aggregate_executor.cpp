@@ -16,11 +16,12 @@
 #include "backend/common/logger.h"
 #include "backend/executor/aggregator.h"
 #include "backend/executor/aggregate_executor.h"
+#include "backend/executor/exchange_executor.h"
 #include "backend/executor/logical_tile_factory.h"
 #include "backend/executor/executor_context.h"
 #include "backend/expression/container_tuple.h"
 #include "backend/planner/aggregate_plan.h"
-#include "backend/storage/table_factory.h"
+#include "backend/storage/tuple.h"
 
 namespace peloton {
 namespace executor {
@@ -33,10 +34,7 @@ AggregateExecutor::AggregateExecutor(const planner::AbstractPlan *node,
                                      ExecutorContext *executor_context)
     : AbstractExecutor(node, executor_context) {}
 
-AggregateExecutor::~AggregateExecutor() {
-  // clean up temporary aggregation table
-  delete output_table;
-}
+AggregateExecutor::~AggregateExecutor() {}
 
 /**
  * @brief Basic initialization.
@@ -50,11 +48,10 @@ bool AggregateExecutor::DInit() {
   // Grab info from plan node and check it
   const planner::AggregatePlan &node = GetPlanNode<planner::AggregatePlan>();
 
-  // Construct the output table
-  auto output_table_schema =
-      const_cast<catalog::Schema *>(node.GetOutputSchema());
+  // Construct the output tiles
+  auto output_schema = node.GetOutputSchema();
 
-  assert(output_table_schema->GetColumnCount() >= 1);
+  assert(output_schema->GetColumnCount() >= 1);
 
   // clean up result
   result_itr = START_OID;
@@ -63,14 +60,7 @@ bool AggregateExecutor::DInit() {
   // reset done
   done = false;
 
-  // clean up temporary aggregation table
-  delete output_table;
-
-  bool own_schema = false;
-  bool adapt_table = false;
-  output_table = storage::TableFactory::GetDataTable(
-      INVALID_OID, INVALID_OID, output_table_schema, "aggregate_temp_table",
-      DEFAULT_TUPLES_PER_TILEGROUP, own_schema, adapt_table);
+  result_builder.reset(new ResultTileBuilder(output_schema));
 
   return true;
 }
@@ -94,51 +84,62 @@ bool AggregateExecutor::DExecute() {
 
   // Grab info from plan node
   const planner::AggregatePlan &node = GetPlanNode<planner::AggregatePlan>();
-  auto transaction = executor_context_->GetTransaction();
-  auto transaction_id = transaction->GetTransactionId();
-
   // Get an aggregator
   std::unique_ptr<AbstractAggregator> aggregator(nullptr);
 
+  // Every worker of a parallel pipeline aggregates its own tiles, and the
+  // partial aggregates are merged once the workers are done
+  auto exchange = dynamic_cast<ExchangeExecutor *>(children_[0]);
+  if (exchange != nullptr &&
+      node.GetAggregateStrategy() != AGGREGATE_TYPE_SORTED) {
+    std::vector<std::unique_ptr<AbstractAggregator>> worker_aggregators(
+        exchange->GetWorkerCount());
+
+    auto status = exchange->RunWorkers(
+        [&](size_t worker, LogicalTile *worker_tile) -> bool {
+          std::unique_ptr<LogicalTile> tile(worker_tile);
+          auto &worker_aggregator = worker_aggregators[worker];
+          if (nullptr == worker_aggregator.get()) {
+            worker_aggregator.reset(BuildAggregator(
+                exchange->GetWorkerContext(worker), tile->GetColumnCount(),
+                node.GetMemoryBudget() / exchange->GetWorkerCount()));
+          }
+          return (nullptr != worker_aggregator.get() &&
+                  worker_aggregator->AdvanceTile(tile.get()));
+        });
+    if (status == false) {
+      return false;
+    }
+
+    for (auto &worker_aggregator : worker_aggregators) {
+      if (nullptr == worker_aggregator.get()) continue;
+
+      if (nullptr == aggregator.get()) {
+        aggregator = std::move(worker_aggregator);
+      } else if (aggregator->Merge(*worker_aggregator) == false) {
+        return false;
+      }
+    }
+  }
+
   // Get input tiles and aggregate them
-  while (children_[0]->Execute() == true) {
+  while (exchange == nullptr && children_[0]->Execute() == true) {
     std::unique_ptr<LogicalTile> tile(children_[0]->GetOutput());
 
     if (nullptr == aggregator.get()) {
       // Initialize the aggregator
-      switch (node.GetAggregateStrategy()) {
-        case AGGREGATE_TYPE_HASH:
-          LOG_INFO("Use HashAggregator");
-          aggregator.reset(new HashAggregator(
-              &node, output_table, executor_context_, tile->GetColumnCount()));
-          break;
-        case AGGREGATE_TYPE_SORTED:
-          LOG_INFO("Use SortedAggregator");
-          aggregator.reset(new SortedAggregator(
-              &node, output_table, executor_context_, tile->GetColumnCount()));
-          break;
-        case AGGREGATE_TYPE_PLAIN:
-          LOG_INFO("Use PlainAggregator");
-          aggregator.reset(
-              new PlainAggregator(&node, output_table, executor_context_));
-          break;
-        default:
-          LOG_ERROR("Invalid aggregate type. Return.");
-          return false;
+      aggregator.reset(BuildAggregator(executor_context_,
+                                       tile->GetColumnCount(),
+                                       node.GetMemoryBudget()));
+      if (nullptr == aggregator.get()) {
+        return false;
       }
     }
 
     LOG_INFO("Looping over tile..");
-
-    for (oid_t tuple_id : *tile) {
-      std::unique_ptr<expression::ContainerTuple<LogicalTile>> cur_tuple(
-          new expression::ContainerTuple<LogicalTile>(tile.get(), tuple_id));
-
-      if (aggregator->Advance(cur_tuple.get()) == false) {
-        return false;
-      }
+    if (aggregator->AdvanceTile(tile.get()) == false) {
+      return false;
     }
-    LOG_TRACE("Finished processing logical tile");
   }
 
   LOG_INFO("Finalizing..");
@@ -151,29 +152,19 @@ bool AggregateExecutor::DExecute() {
           "No tuples received and no group-by. Should insert a NULL tuple "
           "here.");
       std::unique_ptr<storage::Tuple> tuple(
-          new storage::Tuple(output_table->GetSchema(), true));
+          new storage::Tuple(result_builder->GetSchema(), true));
       tuple->SetAllNulls();
-      output_table->InsertTuple(transaction, tuple.get());
+      result_builder->AppendTuple(tuple.get());
     } else {
       done = true;
       return false;
     }
   }
 
-  // Transform output table into result
-  auto tile_group_count = output_table->GetTileGroupCount();
-
-  if (tile_group_count == 0) return false;
+  // Wrap the output rows into the result
+  result = result_builder->GetResultTiles();
 
-  for (oid_t tile_group_itr = 0; tile_group_itr < tile_group_count;
-       tile_group_itr++) {
-    auto tile_group = output_table->GetTileGroup(tile_group_itr);
-
-    // Get the logical tiles corresponding to the given tile group
-    auto logical_tile = LogicalTileFactory::WrapTileGroup(tile_group, transaction_id);
-
-    result.push_back(logical_tile);
-  }
+  if (result.empty()) return false;
 
   done = true;
   LOG_INFO("Result tiles : %lu ", result.size());
@@ -184,5 +175,34 @@ bool AggregateExecutor::DExecute() {
   return true;
 }
 
+/**
+ * @brief Creates the aggregator of the strategy of the plan.
+ * @return the aggregator, nullptr if the strategy is invalid.
+ */
+AbstractAggregator *AggregateExecutor::BuildAggregator(
+    ExecutorContext *executor_context, size_t num_input_columns,
+    size_t memory_budget) {
+  const planner::AggregatePlan &node = GetPlanNode<planner::AggregatePlan>();
+
+  switch (node.GetAggregateStrategy()) {
+    case AGGREGATE_TYPE_HASH:
+      LOG_INFO("Use HashAggregator");
+      return new HashAggregator(&node, result_builder.get(),
+                                executor_context, num_input_columns,
+                                memory_budget);
+    case AGGREGATE_TYPE_SORTED:
+      LOG_INFO("Use SortedAggregator");
+      return new SortedAggregator(&node, result_builder.get(),
+                                  executor_context, num_input_columns);
+    case AGGREGATE_TYPE_PLAIN:
+      LOG_INFO("Use PlainAggregator");
+      return new PlainAggregator(&node, result_builder.get(),
+                                 executor_context);
+    default:
+      LOG_ERROR("Invalid aggregate type. Return.");
+      return nullptr;
+  }
+}
+
 }  // namespace executor
 }  // namespace peloton
@@ -13,14 +13,17 @@
 #pragma once
 
 #include "backend/executor/abstract_executor.h"
-#include "backend/storage/data_table.h"
+#include "backend/executor/result_tile_builder.h"
 #include "backend/common/pool.h"
 
+#include <memory>
 #include <vector>
 
 namespace peloton {
 namespace executor {
 
+class AbstractAggregator;
+
 /**
  * The actual executor class templated on the type of aggregation that
  * should be performed.
@@ -32,6 +35,9 @@ namespace executor {
  * If it is instantiated using PLAN_NODE_TYPE_HASHAGGREGATE,
  * then the input does not need to be sorted and it will hash the group by key
  * to aggregate the tuples.
+ *
+ * Over a parallel pipeline (an exchange child), the hash and plain
+ * aggregations run in the workers and their partial aggregates are merged.
  */
 class AggregateExecutor : public AbstractExecutor {
  public:
@@ -50,6 +56,11 @@ class AggregateExecutor : public AbstractExecutor {
 
   bool DExecute();
 
+  // The groups of a hash aggregator may take up to the memory budget
+  AbstractAggregator *BuildAggregator(ExecutorContext *executor_context,
+                                      size_t num_input_columns,
+                                      size_t memory_budget);
+
   //===--------------------------------------------------------------------===//
   // Executor State
   //===--------------------------------------------------------------------===//
@@ -63,8 +74,8 @@ class AggregateExecutor : public AbstractExecutor {
   /** @brief Computed the result */
   bool done = false;
 
-  /** @brief Output table. */
-  storage::DataTable *output_table = nullptr;
+  /** @brief Output rows, in temporary tiles. */
+  std::unique_ptr<ResultTileBuilder> result_builder;
 };
 
 }  // namespace executor
@@ -11,15 +11,32 @@
 //===----------------------------------------------------------------------===//
 
 #include <set>
+#include <string>
+#include <utility>
 
 #include "backend/executor/aggregator.h"
 #include "backend/executor/executor_context.h"
+#include "backend/executor/hash_table.h"
 #include "backend/common/logger.h"
-#include "backend/storage/data_table.h"
+#include "backend/common/value_peeker.h"
+#include "backend/storage/tuple.h"
 
 namespace peloton {
 namespace executor {
 
+// Slots of the hash aggregation table before any group is added
+static const size_t initial_slot_count = 64;
+
+// Spilled rows are split into this many partitions on the bits of their hash
+static const size_t spill_partition_bits = 4;
+static const size_t spill_fan_out = 1 << spill_partition_bits;
+
+// Partitions are split until the hash runs out of bits
+static const size_t max_spill_level = 16;
+
+// Spilled rows aggregated at once
+static const size_t spill_batch_size = 1024;
+
 /*
  * Create an instance of an aggregator for the specified aggregate
  * type, column type, and result type. The object is constructed in
@@ -69,6 +86,16 @@ void Agg::Advance(const Value val) {
   }
 }
 
+void Agg::Merge(const Agg &other) {
+  if (is_distinct_) {
+    // The values are only advanced once all are known
+    distinct_set_.insert(other.distinct_set_.begin(),
+                         other.distinct_set_.end());
+  } else {
+    DMerge(other);
+  }
+}
+
 Value Agg::Finalize() {
   if (is_distinct_) {
     for (auto val : distinct_set_) {
@@ -80,7 +107,7 @@ Value Agg::Finalize() {
 
 /*
  * Helper method responsible for inserting the results of the aggregation
- * into a new tuple in the output tile group as well as passing through any
+ * into a new tuple in the output tiles as well as passing through any
  * additional columns from the input tile group.
  *
  * Output tuple is projected from two tuples:
@@ -88,28 +115,16 @@ Value Agg::Finalize() {
  * used to retrieve pass-through values;
  * Right is the tuple holding all aggregated values.
  */
-bool Helper(const planner::AggregatePlan *node, Agg **aggregates,
-            storage::DataTable *output_table,
+bool Helper(const planner::AggregatePlan *node,
+            std::vector<Value> &aggregate_values,
+            ResultTileBuilder *result_builder,
             const AbstractTuple *delegate_tuple,
             executor::ExecutorContext *econtext) {
-  auto schema = output_table->GetSchema();
+  auto schema = result_builder->GetSchema();
   std::unique_ptr<storage::Tuple> tuple(new storage::Tuple(schema, true));
 
   /*
-   * 1) Construct a vector of aggregated values
-   */
-  std::vector<Value> aggregate_values;
-  auto &aggregate_terms = node->GetUniqueAggTerms();
-  for (oid_t column_itr = 0; column_itr < aggregate_terms.size();
-       column_itr++) {
-    if (aggregates[column_itr] != nullptr) {
-      Value final_val = aggregates[column_itr]->Finalize();
-      aggregate_values.push_back(final_val);
-    }
-  }
-
-  /*
-   * 2) Evaluate filter predicate;
+   * 1) Evaluate filter predicate;
    * if fail, just return
    */
   std::unique_ptr<expression::ContainerTuple<std::vector<Value>>> aggref_tuple(
@@ -123,7 +138,7 @@ bool Helper(const planner::AggregatePlan *node, Agg **aggregates,
   }
 
   /*
-   * 3) Construct the tuple to insert using projectInfo
+   * 2) Construct the tuple to insert using projectInfo
    */
   node->GetProjectInfo()->Evaluate(tuple.get(), delegate_tuple,
                                    aggref_tuple.get(), econtext);
@@ -131,13 +146,42 @@ bool Helper(const planner::AggregatePlan *node, Agg **aggregates,
   LOG_TRACE("Tuple to Output :");
   LOG_TRACE("GROUP TUPLE :: %s", tuple->GetInfo().c_str());
 
-  auto location =
-      output_table->InsertTuple(econtext->GetTransaction(), tuple.get());
-  if (location.block == INVALID_OID) {
-    LOG_ERROR("Failed to insert tuple ");
-    return false;
+  result_builder->AppendTuple(tuple.get());
+
+  return true;
+}
+
+/*
+ * Finalize the aggregates of a group and output it.
+ */
+bool Helper(const planner::AggregatePlan *node, Agg **aggregates,
+            ResultTileBuilder *result_builder,
+            const AbstractTuple *delegate_tuple,
+            executor::ExecutorContext *econtext) {
+  /*
+   * 1) Construct a vector of aggregated values
+   */
+  std::vector<Value> aggregate_values;
+  auto &aggregate_terms = node->GetUniqueAggTerms();
+  for (oid_t column_itr = 0; column_itr < aggregate_terms.size();
+       column_itr++) {
+    if (aggregates[column_itr] != nullptr) {
+      Value final_val = aggregates[column_itr]->Finalize();
+      aggregate_values.push_back(final_val);
+    }
   }
 
+  return Helper(node, aggregate_values, result_builder, delegate_tuple,
+                econtext);
+}
+
+bool AbstractAggregator::AdvanceTile(LogicalTile *tile) {
+  for (oid_t tuple_id : *tile) {
+    expression::ContainerTuple<LogicalTile> cur_tuple(tile, tuple_id);
+    if (Advance(&cur_tuple) == false) {
+      return false;
+    }
+  }
   return true;
 }
 
@@ -145,89 +189,444 @@ bool Helper(const planner::AggregatePlan *node, Agg **aggregates,
 // Hash Aggregator
 //===--------------------------------------------------------------------===//
 HashAggregator::HashAggregator(const planner::AggregatePlan *node,
-                               storage::DataTable *output_table,
+                               ResultTileBuilder *result_builder,
                                executor::ExecutorContext *econtext,
-                               size_t num_input_columns)
-    : AbstractAggregator(node, output_table, econtext),
-      num_input_columns(num_input_columns) {
-  group_by_key_values.resize(node->GetGroupbyColIds().size(),
-                             ValueFactory::GetNullValue());
+                               size_t num_input_columns, size_t memory_budget)
+    : AbstractAggregator(node, result_builder, econtext),
+      num_input_columns(num_input_columns),
+      memory_budget_(memory_budget) {
+  ResizeSlots(initial_slot_count);
+}
+
+HashAggregator::~HashAggregator() {}
+
+bool HashAggregator::Advance(AbstractTuple *cur_tuple) {
+  return AdvanceBatch({cur_tuple});
+}
+
+bool HashAggregator::AdvanceTile(LogicalTile *tile) {
+  // Rows are spilled in the physical layout of the tiles
+  if (input_schema_ == nullptr) {
+    input_schema_.reset(tile->GetPhysicalSchema());
+  }
+
+  std::vector<expression::ContainerTuple<LogicalTile>> cur_tuples;
+  for (oid_t tuple_id : *tile) {
+    cur_tuples.emplace_back(tile, tuple_id);
+  }
+
+  std::vector<const AbstractTuple *> tuples;
+  for (auto &cur_tuple : cur_tuples) {
+    tuples.push_back(&cur_tuple);
+  }
+
+  return AdvanceBatch(tuples);
 }
 
-HashAggregator::~HashAggregator() {
-  for (auto entry : aggregates_map) {
-    // Clean up allocated storage
-    for (size_t aggno = 0; aggno < node->GetUniqueAggTerms().size(); aggno++) {
-      delete entry.second->aggregates[aggno];
+/**
+ * @brief Find the groups of a batch of rows, adding the new ones while they
+ * fit in the memory budget and spilling the rows of the others. Then advance
+ * every aggregate over the rows that were not spilled.
+ */
+bool HashAggregator::AdvanceBatch(
+    const std::vector<const AbstractTuple *> &tuples) {
+  auto &group_by_col_ids = node->GetGroupbyColIds();
+
+  batch_hashes_.resize(tuples.size());
+  batch_groups_.resize(tuples.size());
+  for (size_t tuple_itr = 0; tuple_itr < tuples.size(); tuple_itr++) {
+    size_t hash = 0;
+    for (auto column_id : group_by_col_ids) {
+      tuples[tuple_itr]->GetValue(column_id).HashCombine(hash);
     }
-    delete[] entry.second->aggregates;
+    batch_hashes_[tuple_itr] = HashTable::MixHash(hash);
+    __builtin_prefetch(&slots_[batch_hashes_[tuple_itr] & (slots_.size() - 1)]);
+  }
+
+  // No more spilling once the hash bits run out
+  bool can_spill =
+      (input_schema_ != nullptr && spill_level_ < max_spill_level);
+
+  for (size_t tuple_itr = 0; tuple_itr < tuples.size(); tuple_itr++) {
+    auto tuple = tuples[tuple_itr];
+    auto hash = batch_hashes_[tuple_itr];
 
-    delete entry.second;
+    oid_t group_itr = FindGroup(tuple, hash);
+    if (group_itr == INVALID_OID) {
+      // A group is always kept, so that every pass makes progress
+      if (can_spill && group_hashes_.empty() == false &&
+          GetMemorySize() > memory_budget_) {
+        if (SpillRow(tuple, hash) == false) {
+          return false;
+        }
+      } else {
+        LOG_TRACE("Group-by key not found. Start a new group.");
+        group_itr = AddGroup(tuple, hash);
+      }
+    }
+
+    batch_groups_[tuple_itr] = group_itr;
+  }
+
+  // Update the aggregation calculation, an aggregate at a time
+  for (oid_t aggno = 0; aggno < node->GetUniqueAggTerms().size(); aggno++) {
+    switch (node->GetUniqueAggTerms()[aggno].aggtype) {
+      case EXPRESSION_TYPE_AGGREGATE_COUNT:
+        AdvanceAggregate<EXPRESSION_TYPE_AGGREGATE_COUNT>(aggno, tuples);
+        break;
+      case EXPRESSION_TYPE_AGGREGATE_COUNT_STAR:
+        AdvanceAggregate<EXPRESSION_TYPE_AGGREGATE_COUNT_STAR>(aggno, tuples);
+        break;
+      case EXPRESSION_TYPE_AGGREGATE_SUM:
+        AdvanceAggregate<EXPRESSION_TYPE_AGGREGATE_SUM>(aggno, tuples);
+        break;
+      case EXPRESSION_TYPE_AGGREGATE_AVG:
+        AdvanceAggregate<EXPRESSION_TYPE_AGGREGATE_AVG>(aggno, tuples);
+        break;
+      case EXPRESSION_TYPE_AGGREGATE_MIN:
+        AdvanceAggregate<EXPRESSION_TYPE_AGGREGATE_MIN>(aggno, tuples);
+        break;
+      case EXPRESSION_TYPE_AGGREGATE_MAX:
+        AdvanceAggregate<EXPRESSION_TYPE_AGGREGATE_MAX>(aggno, tuples);
+        break;
+      default: {
+        auto agg_type = node->GetUniqueAggTerms()[aggno].aggtype;
+        std::string message =
+            "Unknown aggregate type " + std::to_string(agg_type);
+        throw UnknownTypeException(agg_type, message);
+      }
+    }
   }
+
+  return true;
 }
 
-bool HashAggregator::Advance(AbstractTuple *cur_tuple) {
-  AggregateList *aggregate_list;
+/**
+ * @brief Advance an aggregate of the groups over the rows of a batch. The
+ * type of the aggregate is resolved at compile time.
+ */
+template <ExpressionType AGG_TYPE>
+void HashAggregator::AdvanceAggregate(
+    oid_t aggno, const std::vector<const AbstractTuple *> &tuples) {
+  auto &term = node->GetUniqueAggTerms()[aggno];
+  size_t agg_count = node->GetUniqueAggTerms().size();
 
-  // Configure a group-by-key and search for the required group.
-  group_by_key_values.clear();
-  for (oid_t column_itr = 0; column_itr < node->GetGroupbyColIds().size();
-       column_itr++) {
-    Value cur_tuple_val =
-        cur_tuple->GetValue(node->GetGroupbyColIds()[column_itr]);
-    group_by_key_values.push_back(cur_tuple_val);
+  for (size_t tuple_itr = 0; tuple_itr < tuples.size(); tuple_itr++) {
+    auto group_itr = batch_groups_[tuple_itr];
+    if (group_itr == INVALID_OID) continue;
+
+    Value value = ValueFactory::GetIntegerValue(1);
+    if (term.expression) {
+      value = term.expression->Evaluate(tuples[tuple_itr], nullptr,
+                                        this->executor_context);
+    }
+
+    auto &state = group_states_[group_itr * agg_count + aggno];
+    if (term.distinct) {
+      state.distinct_agg->Advance(value);
+      continue;
+    }
+
+    if (AGG_TYPE != EXPRESSION_TYPE_AGGREGATE_COUNT_STAR && value.IsNull()) {
+      continue;
+    }
+
+    switch (AGG_TYPE) {
+      case EXPRESSION_TYPE_AGGREGATE_SUM:
+      case EXPRESSION_TYPE_AGGREGATE_AVG:
+        state.aggregate =
+            (state.count == 0) ? value : state.aggregate.OpAdd(value);
+        break;
+      case EXPRESSION_TYPE_AGGREGATE_MIN:
+        if (state.count == 0 || value.Compare(state.aggregate) < 0) {
+          state.aggregate = CopyValue(value);
+        }
+        break;
+      case EXPRESSION_TYPE_AGGREGATE_MAX:
+        if (state.count == 0 || value.Compare(state.aggregate) > 0) {
+          state.aggregate = CopyValue(value);
+        }
+        break;
+      default:
+        break;
+    }
+    state.count++;
   }
+}
 
-  auto map_itr = aggregates_map.find(group_by_key_values);
+/**
+ * @brief Fold the state of an aggregate of another group of the same key
+ * into this one.
+ */
+void HashAggregator::MergeState(const planner::AggregatePlan::AggTerm &term,
+                                AggregateState &state,
+                                const AggregateState &other_state) {
+  if (term.distinct) {
+    state.distinct_agg->Merge(*other_state.distinct_agg);
+    return;
+  }
 
-  // Group not found. Make a new entry in the hash for this new group.
-  if (map_itr == aggregates_map.end()) {
-    LOG_TRACE("Group-by key not found. Start a new group.");
-    // Allocate new aggregate list
-    aggregate_list = new AggregateList();
-    aggregate_list->aggregates = new Agg *[node->GetUniqueAggTerms().size()];
-    // Make a deep copy of the first tuple we meet
-    for (size_t col_id = 0; col_id < num_input_columns; col_id++) {
-      aggregate_list->first_tuple_values.push_back(
-          ValueFactory::Clone(cur_tuple->GetValue(col_id), nullptr));
-    };
+  if (other_state.count == 0) {
+    return;
+  }
 
-    for (oid_t aggno = 0; aggno < node->GetUniqueAggTerms().size(); aggno++) {
-      aggregate_list->aggregates[aggno] =
-          GetAggInstance(node->GetUniqueAggTerms()[aggno].aggtype);
+  switch (term.aggtype) {
+    case EXPRESSION_TYPE_AGGREGATE_SUM:
+    case EXPRESSION_TYPE_AGGREGATE_AVG:
+      state.aggregate = (state.count == 0)
+                            ? other_state.aggregate
+                            : state.aggregate.OpAdd(other_state.aggregate);
+      break;
+    case EXPRESSION_TYPE_AGGREGATE_MIN:
+      if (state.count == 0 ||
+          other_state.aggregate.Compare(state.aggregate) < 0) {
+        state.aggregate = CopyValue(other_state.aggregate);
+      }
+      break;
+    case EXPRESSION_TYPE_AGGREGATE_MAX:
+      if (state.count == 0 ||
+          other_state.aggregate.Compare(state.aggregate) > 0) {
+        state.aggregate = CopyValue(other_state.aggregate);
+      }
+      break;
+    default:
+      break;
+  }
+  state.count += other_state.count;
+}
 
-      bool distinct = node->GetUniqueAggTerms()[aggno].distinct;
-      aggregate_list->aggregates[aggno]->SetDistinct(distinct);
+Value HashAggregator::FinalizeState(const planner::AggregatePlan::AggTerm &term,
+                                    AggregateState &state) const {
+  if (term.distinct) {
+    return state.distinct_agg->Finalize();
+  }
+
+  switch (term.aggtype) {
+    case EXPRESSION_TYPE_AGGREGATE_COUNT:
+    case EXPRESSION_TYPE_AGGREGATE_COUNT_STAR:
+      return ValueFactory::GetBigIntValue(state.count);
+    case EXPRESSION_TYPE_AGGREGATE_AVG:
+      if (state.count == 0) {
+        return ValueFactory::GetNullValue();
+      }
+      return state.aggregate.OpDivide(
+          ValueFactory::GetDoubleValue(static_cast<double>(state.count)));
+    default:
+      if (state.count == 0) {
+        return ValueFactory::GetNullValue();
+      }
+      return state.aggregate;
+  }
+}
+
+/**
+ * @brief Probe the slots from the one of the hash until an empty one. Null
+ * keys are equal to each other.
+ */
+oid_t HashAggregator::FindGroup(const AbstractTuple *tuple,
+                                size_t hash) const {
+  auto &group_by_col_ids = node->GetGroupbyColIds();
+  size_t slot_mask = slots_.size() - 1;
+
+  for (size_t slot_itr = hash & slot_mask; slots_[slot_itr] != INVALID_OID;
+       slot_itr = (slot_itr + 1) & slot_mask) {
+    oid_t group_itr = slots_[slot_itr];
+    if (group_hashes_[group_itr] != hash) continue;
+
+    bool is_equal = true;
+    for (auto column_id : group_by_col_ids) {
+      const Value &lhs =
+          group_values_[group_itr * num_input_columns + column_id];
+      const Value rhs = tuple->GetValue(column_id);
+
+      if (lhs.IsNull() == true || rhs.IsNull() == true) {
+        is_equal = (lhs.IsNull() == rhs.IsNull());
+      } else {
+        is_equal = lhs.OpEquals(rhs).IsTrue();
+      }
+      if (is_equal == false) break;
     }
 
-    aggregates_map.insert(
-        HashAggregateMapType::value_type(group_by_key_values, aggregate_list));
+    if (is_equal == true) {
+      return group_itr;
+    }
+  }
+
+  return INVALID_OID;
+}
+
+oid_t HashAggregator::AddGroup(const AbstractTuple *tuple, size_t hash) {
+  oid_t group_itr = group_hashes_.size();
+
+  // Keep the slots at most half full
+  if ((group_itr + 1) * 2 > slots_.size()) {
+    ResizeSlots(slots_.size() * 2);
   }
-  // Otherwise, the list is the second item of the pair.
-  else {
-    aggregate_list = map_itr->second;
+
+  size_t slot_mask = slots_.size() - 1;
+  size_t slot_itr = hash & slot_mask;
+  while (slots_[slot_itr] != INVALID_OID) {
+    slot_itr = (slot_itr + 1) & slot_mask;
   }
+  slots_[slot_itr] = group_itr;
 
-  // Update the aggregation calculation
-  for (oid_t aggno = 0; aggno < node->GetUniqueAggTerms().size(); aggno++) {
-    auto predicate = node->GetUniqueAggTerms()[aggno].expression;
-    Value value = ValueFactory::GetIntegerValue(1);
-    if (predicate) {
-      value = node->GetUniqueAggTerms()[aggno].expression->Evaluate(
-          cur_tuple, nullptr, this->executor_context);
+  group_hashes_.push_back(hash);
+
+  // Make a deep copy of the first tuple we meet
+  for (oid_t col_id = 0; col_id < num_input_columns; col_id++) {
+    group_values_.push_back(CopyValue(tuple->GetValue(col_id)));
+  }
+
+  for (auto &term : node->GetUniqueAggTerms()) {
+    group_states_.emplace_back();
+    if (term.distinct) {
+      group_states_.back().distinct_agg.reset(GetAggInstance(term.aggtype));
+      group_states_.back().distinct_agg->SetDistinct(true);
+    }
+  }
+
+  return group_itr;
+}
+
+/**
+ * @brief Put every group in the slots again. The groups keep their hashes,
+ * so they are not hashed again.
+ */
+void HashAggregator::ResizeSlots(size_t slot_count) {
+  slots_.assign(slot_count, INVALID_OID);
+
+  size_t slot_mask = slot_count - 1;
+  for (oid_t group_itr = 0; group_itr < group_hashes_.size(); group_itr++) {
+    size_t slot_itr = group_hashes_[group_itr] & slot_mask;
+    while (slots_[slot_itr] != INVALID_OID) {
+      slot_itr = (slot_itr + 1) & slot_mask;
+    }
+    slots_[slot_itr] = group_itr;
+  }
+}
+
+Value HashAggregator::CopyValue(const Value &value) {
+  if (value.IsNull()) {
+    return value;
+  }
+
+  switch (value.GetValueType()) {
+    case VALUE_TYPE_VARCHAR:
+    case VALUE_TYPE_VARBINARY: {
+      if (group_pool_ == nullptr) {
+        group_pool_.reset(new VarlenPool(BACKEND_TYPE_MM));
+      }
+
+      auto length = ValuePeeker::PeekObjectLengthWithoutNull(value);
+      auto data = static_cast<const char *>(
+          ValuePeeker::PeekObjectValueWithoutNull(value));
+      group_data_size_ += length;
+
+      if (value.GetValueType() == VALUE_TYPE_VARCHAR) {
+        return ValueFactory::GetStringValue(std::string(data, length),
+                                            group_pool_.get());
+      }
+      return ValueFactory::GetBinaryValue(
+          reinterpret_cast<const unsigned char *>(data), length,
+          group_pool_.get());
+    }
+    default:
+      return value;
+  }
+}
+
+size_t HashAggregator::GetMemorySize() const {
+  return group_hashes_.capacity() * sizeof(size_t) +
+         group_values_.capacity() * sizeof(Value) +
+         group_states_.capacity() * sizeof(AggregateState) +
+         slots_.capacity() * sizeof(oid_t) + group_data_size_;
+}
+
+bool HashAggregator::SpillRow(const AbstractTuple *tuple, size_t hash) {
+  if (spill_partitions_.empty()) {
+    spill_partitions_.resize(spill_fan_out);
+  }
+
+  size_t shift = sizeof(size_t) * 8 - spill_partition_bits * (spill_level_ + 1);
+  auto &partition = spill_partitions_[(hash >> shift) & (spill_fan_out - 1)];
+  if (partition == nullptr) {
+    partition.reset(new SpillFile(input_schema_.get()));
+    if (partition->Open() == false) {
+      return false;
+    }
+  }
+
+  if (spill_tuple_ == nullptr) {
+    spill_tuple_.reset(new storage::Tuple(input_schema_.get(), true));
+    if (input_schema_->GetUninlinedColumnCount() > 0) {
+      spill_pool_.reset(new VarlenPool(BACKEND_TYPE_MM));
+    }
+  }
+
+  for (oid_t col_id = 0; col_id < num_input_columns; col_id++) {
+    spill_tuple_->SetValue(col_id, tuple->GetValue(col_id), spill_pool_.get());
+  }
+
+  bool status = partition->Write(spill_tuple_.get());
+  if (spill_pool_ != nullptr) spill_pool_->Purge();
+  return status;
+}
+
+bool HashAggregator::AggregateSpillFile(SpillFile *file) {
+  if (file->Rewind() == false) {
+    return false;
+  }
+
+  std::unique_ptr<VarlenPool> pool;
+  if (input_schema_->GetUninlinedColumnCount() > 0) {
+    pool.reset(new VarlenPool(BACKEND_TYPE_MM));
+  }
+
+  std::vector<std::unique_ptr<storage::Tuple>> batch;
+  std::vector<const AbstractTuple *> tuples;
+  bool is_done = false;
+  while (is_done == false) {
+    tuples.clear();
+    while (tuples.size() < spill_batch_size) {
+      if (batch.size() == tuples.size()) {
+        batch.emplace_back(new storage::Tuple(input_schema_.get(), true));
+      }
+      if (file->Read(batch[tuples.size()].get(), pool.get()) == false) {
+        is_done = true;
+        break;
+      }
+      tuples.push_back(batch[tuples.size()].get());
     }
-    aggregate_list->aggregates[aggno]->Advance(value);
+
+    if (AdvanceBatch(tuples) == false) {
+      return false;
+    }
+    if (pool != nullptr) pool->Purge();
   }
 
   return true;
 }
 
-bool HashAggregator::Finalize() {
-  for (auto entry : aggregates_map) {
+bool HashAggregator::OutputGroups() {
+  size_t agg_count = node->GetUniqueAggTerms().size();
+  std::vector<Value> first_tuple_values;
+  std::vector<Value> aggregate_values;
+
+  for (oid_t group_itr = 0; group_itr < group_hashes_.size(); group_itr++) {
+    auto first_value = group_values_.begin() + group_itr * num_input_columns;
+    first_tuple_values.assign(first_value, first_value + num_input_columns);
+
+    aggregate_values.clear();
+    for (oid_t aggno = 0; aggno < agg_count; aggno++) {
+      aggregate_values.push_back(
+          FinalizeState(node->GetUniqueAggTerms()[aggno],
+                        group_states_[group_itr * agg_count + aggno]));
+    }
+
     // Construct a container for the first tuple
     expression::ContainerTuple<std::vector<Value>> first_tuple(
-        &entry.second->first_tuple_values);
-    if (Helper(node, entry.second->aggregates, output_table, &first_tuple,
+        &first_tuple_values);
+    if (Helper(node, aggregate_values, result_builder, &first_tuple,
                this->executor_context) == false) {
       return false;
     }
@@ -236,15 +635,114 @@ bool HashAggregator::Finalize() {
   return true;
 }
 
+void HashAggregator::ClearGroups() {
+  std::vector<size_t>().swap(group_hashes_);
+  std::vector<Value>().swap(group_values_);
+  std::vector<AggregateState>().swap(group_states_);
+  if (group_pool_ != nullptr) group_pool_->Purge();
+  group_data_size_ = 0;
+  ResizeSlots(initial_slot_count);
+}
+
+/**
+ * @brief Output the groups in memory, and then aggregate the spilled
+ * partitions one at a time.
+ */
+bool HashAggregator::Finalize() {
+  std::vector<std::pair<std::unique_ptr<SpillFile>, size_t>> partitions;
+
+  for (;;) {
+    // Spilled rows may still belong to the groups in memory
+    for (auto &file : input_files_) {
+      if (AggregateSpillFile(file.get()) == false) {
+        return false;
+      }
+    }
+    input_files_.clear();
+
+    if (OutputGroups() == false) {
+      return false;
+    }
+    ClearGroups();
+
+    for (auto &partition : spill_partitions_) {
+      if (partition != nullptr) {
+        LOG_TRACE("Spilled %lu rows at level %lu",
+                  partition->GetTupleCount(), spill_level_);
+        partitions.emplace_back(std::move(partition), spill_level_);
+      }
+    }
+    spill_partitions_.clear();
+
+    if (partitions.empty()) {
+      return true;
+    }
+
+    // The rows of a partition share the hash bits of its level
+    input_files_.push_back(std::move(partitions.back().first));
+    spill_level_ = partitions.back().second + 1;
+    partitions.pop_back();
+  }
+}
+
+/**
+ * @brief Fold the groups of the other aggregator into this one, whatever
+ * the memory budget. The rows either one has spilled may belong to the
+ * groups of the other, so they are aggregated again before the groups are
+ * output.
+ */
+bool HashAggregator::Merge(AbstractAggregator &other) {
+  auto &other_aggregator = static_cast<HashAggregator &>(other);
+  size_t agg_count = node->GetUniqueAggTerms().size();
+
+  if (input_schema_ == nullptr) {
+    input_schema_ = std::move(other_aggregator.input_schema_);
+  }
+
+  std::vector<Value> other_values;
+  for (oid_t other_group_itr = 0;
+       other_group_itr < other_aggregator.group_hashes_.size();
+       other_group_itr++) {
+    auto first_value = other_aggregator.group_values_.begin() +
+                       other_group_itr * num_input_columns;
+    other_values.assign(first_value, first_value + num_input_columns);
+    expression::ContainerTuple<std::vector<Value>> other_tuple(&other_values);
+
+    auto hash = other_aggregator.group_hashes_[other_group_itr];
+    oid_t group_itr = FindGroup(&other_tuple, hash);
+    if (group_itr == INVALID_OID) {
+      group_itr = AddGroup(&other_tuple, hash);
+    }
+
+    for (oid_t aggno = 0; aggno < agg_count; aggno++) {
+      MergeState(
+          node->GetUniqueAggTerms()[aggno],
+          group_states_[group_itr * agg_count + aggno],
+          other_aggregator.group_states_[other_group_itr * agg_count + aggno]);
+    }
+  }
+
+  for (auto spill_files : {&spill_partitions_,
+                           &other_aggregator.spill_partitions_,
+                           &other_aggregator.input_files_}) {
+    for (auto &file : *spill_files) {
+      if (file != nullptr) input_files_.push_back(std::move(file));
+    }
+    spill_files->clear();
+  }
+
+  return true;
+}
+
 //===--------------------------------------------------------------------===//
 // Sort Aggregator
 //===--------------------------------------------------------------------===//
 
 SortedAggregator::SortedAggregator(const planner::AggregatePlan *node,
-                                   storage::DataTable *output_table,
+                                   ResultTileBuilder *result_builder,
                                    executor::ExecutorContext *econtext,
                                    size_t num_input_columns)
-    : AbstractAggregator(node, output_table, econtext),
+    : AbstractAggregator(node, result_builder, econtext),
       delegate_tuple_(&delegate_tuple_values_),  // Bind value vector to wrapper
                                                  // container tuple
       num_input_columns_(num_input_columns) {
@@ -284,7 +782,7 @@ bool SortedAggregator::Advance(AbstractTuple *next_tuple) {
         LOG_TRACE("Group-by columns changed.");
 
         // Call helper to output the current group result
-        if (!Helper(node, aggregates, output_table, &delegate_tuple_,
+        if (!Helper(node, aggregates, result_builder, &delegate_tuple_,
                     this->executor_context)) {
           return false;
         }
@@ -336,7 +834,7 @@ bool SortedAggregator::Advance(AbstractTuple *next_tuple) {
 bool SortedAggregator::Finalize() {
   // Call helper to output the current group result
   if (!delegate_tuple_values_.empty() &&
-      !Helper(node, aggregates, output_table, &delegate_tuple_,
+      !Helper(node, aggregates, result_builder, &delegate_tuple_,
               this->executor_context)) {
     return false;
   }
@@ -348,9 +846,9 @@ bool SortedAggregator::Finalize() {
 // Plain Aggregator
 //===--------------------------------------------------------------------===//
 PlainAggregator::PlainAggregator(const planner::AggregatePlan *node,
-                                 storage::DataTable *output_table,
+                                 ResultTileBuilder *result_builder,
                                  executor::ExecutorContext *econtext)
-    : AbstractAggregator(node, output_table, econtext) {
+    : AbstractAggregator(node, result_builder, econtext) {
   // allocate aggregators
   aggregates = new Agg *[node->GetUniqueAggTerms().size()];
   ::memset(aggregates, 0, sizeof(Agg *) * node->GetUniqueAggTerms().size());
@@ -380,7 +878,7 @@ bool PlainAggregator::Advance(AbstractTuple *next_tuple) {
 }
 
 bool PlainAggregator::Finalize() {
-  if (!Helper(node, aggregates, output_table, nullptr,
+  if (!Helper(node, aggregates, result_builder, nullptr,
               this->executor_context)) {
     return false;
   }
@@ -393,6 +891,16 @@ bool PlainAggregator::Finalize() {
   return true;
 }
 
+bool PlainAggregator::Merge(AbstractAggregator &other) {
+  auto &other_aggregator = static_cast<PlainAggregator &>(other);
+
+  for (oid_t aggno = 0; aggno < node->GetUniqueAggTerms().size(); aggno++) {
+    aggregates[aggno]->Merge(*other_aggregator.aggregates[aggno]);
+  }
+
+  return true;
+}
+
 PlainAggregator::~PlainAggregator() {
   // Clean up aggregators
   for (oid_t column_itr = 0; column_itr < node->GetUniqueAggTerms().size();
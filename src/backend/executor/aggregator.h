@@ -12,11 +12,15 @@
 
 #pragma once
 
-#include <unordered_map>
+#include <memory>
 #include <unordered_set>
+#include <vector>
 
+#include "backend/common/pool.h"
 #include "backend/common/value_factory.h"
 #include "backend/executor/abstract_executor.h"
+#include "backend/executor/result_tile_builder.h"
+#include "backend/executor/spill_file.h"
 #include "backend/planner/aggregate_plan.h"
 #include "backend/expression/container_tuple.h"
 
@@ -27,7 +31,7 @@
 namespace peloton {
 
 namespace storage {
-class DataTable;
+class Tuple;
 }
 
 namespace executor {
@@ -45,8 +49,12 @@ class Agg {
   void Advance(const Value val);
   Value Finalize();
 
+  // Fold in the values advanced by another aggregate of the same type
+  void Merge(const Agg &other);
+
   virtual void DAdvance(const Value val) = 0;
   virtual Value DFinalize() = 0;
+  virtual void DMerge(const Agg &other) = 0;
 
  private:
   typedef std::unordered_set<Value, Value::hash, Value::equal_to>
@@ -82,6 +90,13 @@ class SumAgg : public Agg {
     return aggregate;
   }
 
+  void DMerge(const Agg &other) {
+    auto &sum_agg = static_cast<const SumAgg &>(other);
+    if (sum_agg.have_advanced) {
+      DAdvance(sum_agg.aggregate);
+    }
+  }
+
  private:
   Value aggregate;
 
@@ -129,6 +144,19 @@ class AvgAgg : public Agg {
     return final_result;
   }
 
+  void DMerge(const Agg &other) {
+    auto &avg_agg = static_cast<const AvgAgg &>(other);
+    if (avg_agg.count == 0) {
+      return;
+    }
+    if (count == 0) {
+      aggregate = avg_agg.aggregate;
+    } else {
+      aggregate = aggregate.OpAdd(avg_agg.aggregate);
+    }
+    count += avg_agg.count;
+  }
+
  private:
   /** @brief aggregate initialized on first advance. */
   Value aggregate;
@@ -156,6 +184,10 @@ class CountAgg : public Agg {
 
   Value DFinalize() { return ValueFactory::GetBigIntValue(count); }
 
+  void DMerge(const Agg &other) {
+    count += static_cast<const CountAgg &>(other).count;
+  }
+
  private:
   int64_t count;
 };
@@ -168,6 +200,10 @@ class CountStarAgg : public Agg {
 
   Value DFinalize() { return ValueFactory::GetBigIntValue(count); }
 
+  void DMerge(const Agg &other) {
+    count += static_cast<const CountStarAgg &>(other).count;
+  }
+
  private:
   int64_t count;
 };
@@ -195,6 +231,13 @@ class MaxAgg : public Agg {
     return aggregate;
   }
 
+  void DMerge(const Agg &other) {
+    auto &max_agg = static_cast<const MaxAgg &>(other);
+    if (max_agg.have_advanced) {
+      DAdvance(max_agg.aggregate);
+    }
+  }
+
  private:
   Value aggregate;
 
@@ -225,6 +268,13 @@ class MinAgg : public Agg {
     return aggregate;
   }
 
+  void DMerge(const Agg &other) {
+    auto &min_agg = static_cast<const MinAgg &>(other);
+    if (min_agg.have_advanced) {
+      DAdvance(min_agg.aggregate);
+    }
+  }
+
  private:
   Value aggregate;
 
@@ -243,22 +293,33 @@ Agg *GetAggInstance(ExpressionType agg_type);
 class AbstractAggregator {
  public:
   AbstractAggregator(const planner::AggregatePlan *node,
-                     storage::DataTable *output_table,
+                     ResultTileBuilder *result_builder,
                      executor::ExecutorContext *econtext)
-      : node(node), output_table(output_table), executor_context(econtext) {}
+      : node(node),
+        result_builder(result_builder),
+        executor_context(econtext) {}
 
   virtual bool Advance(AbstractTuple *next_tuple) = 0;
 
+  // Advance over the visible rows of a tile
+  virtual bool AdvanceTile(LogicalTile *tile);
+
   virtual bool Finalize() = 0;
 
+  // Fold the groups of another aggregator of the same plan into this one.
+  // Only the aggregators of unsorted input can be merged.
+  virtual bool Merge(AbstractAggregator &other __attribute__((unused))) {
+    return false;
+  }
+
   virtual ~AbstractAggregator() {}
 
  protected:
   /** @brief Plan node */
   const planner::AggregatePlan *node;
 
-  /** @brief Output table */
-  storage::DataTable *output_table;
+  /** @brief Output rows */
+  ResultTileBuilder *result_builder;
 
   /** @brief Executor Context */
   executor::ExecutorContext *executor_context = nullptr;
@@ -266,54 +327,125 @@ class AbstractAggregator {
 
 /**
  * @brief Used when input is NOT sorted.
- * Will maintain an internal hash table.
+ *
+ * The groups are kept in flat arrays: the values of the first row of every
+ * group, and a fixed size state for every aggregate of every group, with
+ * their uninlined values copied into a pool. An open addressing table of
+ * group offsets finds the group of a row. The rows of a tile are hashed and
+ * matched to their groups first, and then every aggregate is advanced over
+ * all of them.
+ *
+ * When the groups take more than the memory budget, the rows of new groups
+ * are written to spill partitions on the high bits of their hash instead.
+ * Once the groups in memory are output, the partitions are aggregated one at
+ * a time in the same way, split on the next bits if they do not fit either.
  */
 class HashAggregator : public AbstractAggregator {
  public:
   HashAggregator(const planner::AggregatePlan *node,
-                 storage::DataTable *output_table,
-                 executor::ExecutorContext *econtext, size_t num_input_columns);
+                 ResultTileBuilder *result_builder,
+                 executor::ExecutorContext *econtext, size_t num_input_columns,
+                 size_t memory_budget);
 
   bool Advance(AbstractTuple *next_tuple) override;
 
+  bool AdvanceTile(LogicalTile *tile) override;
+
   bool Finalize() override;
 
+  bool Merge(AbstractAggregator &other) override;
+
   ~HashAggregator();
 
  private:
-  const size_t num_input_columns;
+  /** @brief State of an aggregate of a group */
+  struct AggregateState {
+    // SUM, AVG, MIN or MAX of the values so far
+    Value aggregate;
 
-  /** List of aggregates for a specific group. */
-  struct AggregateList {
-    // Keep a deep copy of the first tuple we met of this group
-    std::vector<Value> first_tuple_values;
+    // Non-null values advanced, or all rows for COUNT(*)
+    int64_t count = 0;
 
-    // The aggregates for each column for this group
-    Agg **aggregates;
+    // DISTINCT aggregates collect their values first
+    std::unique_ptr<Agg> distinct_agg;
   };
 
-  /** Hash function of internal hash table */
-  struct ValueVectorHasher
-      : std::unary_function<std::vector<Value>, std::size_t> {
-    // Generate a 64-bit number for the a vector of value
-    size_t operator()(const std::vector<Value> &values) const {
-      size_t seed = 0;
-      for (auto &v : values) {
-        v.HashCombine(seed);
-      }
-      return seed;
-    }
-  };
+  bool AdvanceBatch(const std::vector<const AbstractTuple *> &tuples);
+
+  template <ExpressionType AGG_TYPE>
+  void AdvanceAggregate(oid_t aggno,
+                        const std::vector<const AbstractTuple *> &tuples);
+
+  void MergeState(const planner::AggregatePlan::AggTerm &term,
+                  AggregateState &state, const AggregateState &other_state);
+
+  Value FinalizeState(const planner::AggregatePlan::AggTerm &term,
+                      AggregateState &state) const;
+
+  // Get the group with the key of the row, INVALID_OID if there is none
+  oid_t FindGroup(const AbstractTuple *tuple, size_t hash) const;
+
+  oid_t AddGroup(const AbstractTuple *tuple, size_t hash);
+
+  void ResizeSlots(size_t slot_count);
+
+  // Copy a value into the pool of the groups, if it is not inlined
+  Value CopyValue(const Value &value);
+
+  size_t GetMemorySize() const;
+
+  // Write a row of a new group to its spill partition
+  bool SpillRow(const AbstractTuple *tuple, size_t hash);
+
+  // Advance over the rows of a spill partition
+  bool AggregateSpillFile(SpillFile *file);
+
+  bool OutputGroups();
 
-  // Default equal_to should works well
-  typedef std::unordered_map<std::vector<Value>, AggregateList *,
-                             ValueVectorHasher> HashAggregateMapType;
+  void ClearGroups();
 
-  /** @brief Group by key values used */
-  std::vector<Value> group_by_key_values;
+  const size_t num_input_columns;
+
+  const size_t memory_budget_;
+
+  /** @brief Hash of the key of every group */
+  std::vector<size_t> group_hashes_;
+
+  /** @brief Values of the first row of every group */
+  std::vector<Value> group_values_;
+
+  /** @brief Aggregate states of every group */
+  std::vector<AggregateState> group_states_;
+
+  /** @brief Uninlined values of the groups */
+  std::unique_ptr<VarlenPool> group_pool_;
+
+  /** @brief Bytes of the uninlined values of the groups */
+  size_t group_data_size_ = 0;
 
-  /** @brief Hash table */
-  HashAggregateMapType aggregates_map;
+  /** @brief Open addressing table of group offsets */
+  std::vector<oid_t> slots_;
+
+  /** @brief Hashes and groups of the rows of a batch */
+  std::vector<size_t> batch_hashes_;
+  std::vector<oid_t> batch_groups_;
+
+  /** @brief Physical schema of the input rows, known after the first tile */
+  std::unique_ptr<catalog::Schema> input_schema_;
+
+  /** @brief Partitions of the rows spilled since the groups were output */
+  std::vector<std::unique_ptr<SpillFile>> spill_partitions_;
+
+  /** @brief Hash bits of the spill partitions are taken after this many
+   * levels of partitioning */
+  size_t spill_level_ = 0;
+
+  /** @brief Spilled rows to aggregate before the groups are output */
+  std::vector<std::unique_ptr<SpillFile>> input_files_;
+
+  /** @brief Copy of a row that is spilled */
+  std::unique_ptr<storage::Tuple> spill_tuple_;
+  std::unique_ptr<VarlenPool> spill_pool_;
 };
 
 /**
@@ -322,7 +454,7 @@ class HashAggregator : public AbstractAggregator {
 class SortedAggregator : public AbstractAggregator {
  public:
   SortedAggregator(const planner::AggregatePlan *node,
-                   storage::DataTable *output_table,
+                   ResultTileBuilder *result_builder,
                    executor::ExecutorContext *econtext,
                    size_t num_input_columns);
 
@@ -346,13 +478,15 @@ class SortedAggregator : public AbstractAggregator {
 class PlainAggregator : public AbstractAggregator {
  public:
   PlainAggregator(const planner::AggregatePlan *node,
-                  storage::DataTable *output_table,
+                  ResultTileBuilder *result_builder,
                   executor::ExecutorContext *econtext);
 
   bool Advance(AbstractTuple *next_tuple) override;
 
   bool Finalize() override;
 
+  bool Merge(AbstractAggregator &other) override;
+
   ~PlainAggregator();
 
  private:
@@ -23,6 +23,7 @@
 #include "backend/storage/data_table.h"
 #include "backend/storage/tile.h"
 #include "backend/storage/tile_group.h"
+#include "backend/storage/tile_group_header.h"
 
 namespace peloton {
 namespace executor {
@@ -75,10 +76,17 @@ bool DeleteExecutor::DExecute() {
 
   storage::Tile *tile = source_tile->GetBaseTile(0);
   storage::TileGroup *tile_group = tile->GetTileGroup();
+  auto transaction_ = executor_context_->GetTransaction();
+
+  // Older versions of tuples updated in place by a concurrent transaction
+  if (tile_group == nullptr) {
+    LOG_INFO("Tuples have been updated concurrently. Set txn aborted.");
+    transaction_->SetResult(peloton::Result::RESULT_ABORTED);
+    return false;
+  }
 
   auto &pos_lists = source_tile.get()->GetPositionLists();
   auto tile_group_id = tile_group->GetTileGroupId();
-  auto transaction_ = executor_context_->GetTransaction();
 
   LOG_INFO("Source tile : %p Tuples : %lu ", source_tile.get(),
            source_tile->GetTupleCount());
@@ -113,8 +121,14 @@ bool DeleteExecutor::DExecute() {
     bool status = target_table_->DeleteTuple(transaction_, delete_location);
 
     if (status == false) {
-      LOG_INFO("Fail to delete. Set txn failure");
-      transaction_->SetResult(peloton::Result::RESULT_FAILURE);
+      if (tile_group->GetHeader()->IsWriteConflict(
+              physical_tuple_id, transaction_->GetTransactionId())) {
+        LOG_INFO("Fail to delete. Set txn aborted");
+        transaction_->SetResult(peloton::Result::RESULT_ABORTED);
+      } else {
+        LOG_INFO("Fail to delete. Set txn failure");
+        transaction_->SetResult(peloton::Result::RESULT_FAILURE);
+      }
       return false;
     }
 
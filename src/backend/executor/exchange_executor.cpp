@@ -0,0 +1,202 @@
+//===----------------------------------------------------------------------===//
+//
+//                         PelotonDB
+//
+// exchange_executor.cpp
+//
+// Identification: src/backend/executor/exchange_executor.cpp
+//
+// Copyright (c) 2015, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "backend/executor/exchange_executor.h"
+
+#include <utility>
+
+#include "backend/common/logger.h"
+#include "backend/executor/logical_tile.h"
+
+namespace peloton {
+namespace executor {
+
+// Tiles a worker may get ahead of the parent, before it waits
+static const size_t EXCHANGE_TILES_PER_WORKER = 4;
+
+/**
+ * @brief Constructor for exchange executor.
+ * @param node Exchange node corresponding to this executor.
+ */
+ExchangeExecutor::ExchangeExecutor(const planner::AbstractPlan *node,
+                                   ExecutorContext *executor_context)
+    : AbstractExecutor(node, executor_context), stopped_(false) {}
+
+ExchangeExecutor::~ExchangeExecutor() { StopWorkers(); }
+
+ExecutorContext *ExchangeExecutor::AddWorkerContext() {
+  worker_contexts_.emplace_back(new ExecutorContext(
+      executor_context_->GetTransaction(), executor_context_->GetParams()));
+  worker_contexts_.back()->SetMorselScheduler(&morsel_scheduler_);
+  return worker_contexts_.back().get();
+}
+
+/**
+ * @brief Stop the workers of an earlier run and rewind the scans.
+ * @return true on success, false otherwise.
+ */
+bool ExchangeExecutor::DInit() {
+  assert(children_.size() > 0);
+  assert(children_.size() == worker_contexts_.size());
+
+  StopWorkers();
+  started_ = false;
+  morsel_scheduler_.Reset();
+
+  return true;
+}
+
+/**
+ * @brief Returns the next tile of any worker.
+ * @return true on success, false once all workers are done.
+ */
+bool ExchangeExecutor::DExecute() {
+  LOG_TRACE("Exchange executor :: %lu workers", children_.size());
+
+  if (started_ == false) {
+    started_ = true;
+    StartWorkers([this](size_t, LogicalTile *tile) -> bool {
+      std::unique_lock<std::mutex> lock(output_tiles_mutex_);
+      output_tiles_cv_.wait(lock, [this]() -> bool {
+        return stopped_ == true ||
+               output_tiles_.size() <
+                   EXCHANGE_TILES_PER_WORKER * children_.size();
+      });
+
+      if (stopped_ == true) {
+        delete tile;
+      } else {
+        output_tiles_.push_back(tile);
+        output_tiles_cv_.notify_all();
+      }
+      return true;
+    });
+  }
+
+  std::unique_lock<std::mutex> lock(output_tiles_mutex_);
+  output_tiles_cv_.wait(lock, [this]() -> bool {
+    return output_tiles_.empty() == false || running_worker_count_ == 0 ||
+           failed_ == true;
+  });
+
+  bool failed = failed_;
+  if (output_tiles_.empty() == false && failed == false) {
+    LogicalTile *tile = output_tiles_.front();
+    output_tiles_.pop_front();
+    output_tiles_cv_.notify_all();
+    lock.unlock();
+
+    SetOutput(tile);
+    return true;
+  }
+  lock.unlock();
+
+  if (failed == true) {
+    StopWorkers();
+  }
+  JoinWorkers();
+
+  return false;
+}
+
+bool ExchangeExecutor::RunWorkers(const TileConsumer &consumer) {
+  assert(started_ == false);
+
+  StartWorkers(consumer);
+  JoinWorkers();
+
+  return (failed_ == false);
+}
+
+void ExchangeExecutor::StartWorkers(const TileConsumer &consumer) {
+  assert(worker_threads_.empty());
+
+  stopped_ = false;
+  failed_ = false;
+  running_worker_count_ = children_.size();
+
+  for (size_t worker = 0; worker < children_.size(); worker++) {
+    worker_threads_.emplace_back(&ExchangeExecutor::RunWorker, this, worker,
+                                 consumer);
+  }
+}
+
+/**
+ * @brief Runs the pipeline of a worker until it is exhausted or the workers
+ * are stopped. A failure stops the other workers as well.
+ */
+void ExchangeExecutor::RunWorker(size_t worker, const TileConsumer &consumer) {
+  auto child = children_[worker];
+  bool status = true;
+
+  try {
+    while (stopped_ == false && child->Execute() == true) {
+      if (consumer(worker, child->GetOutput()) == false) {
+        status = false;
+        break;
+      }
+    }
+  } catch (...) {
+    std::lock_guard<std::mutex> lock(output_tiles_mutex_);
+    if (worker_exception_ == nullptr) {
+      worker_exception_ = std::current_exception();
+    }
+    status = false;
+  }
+
+  std::lock_guard<std::mutex> lock(output_tiles_mutex_);
+  if (status == false) {
+    LOG_ERROR("Worker %lu of exchange failed", worker);
+    failed_ = true;
+    stopped_ = true;
+  }
+  running_worker_count_--;
+  output_tiles_cv_.notify_all();
+}
+
+/**
+ * @brief Waits for all workers. An exception thrown by a worker is thrown
+ * again here, on the thread of the caller.
+ */
+void ExchangeExecutor::JoinWorkers() {
+  for (auto &worker_thread : worker_threads_) {
+    worker_thread.join();
+  }
+  worker_threads_.clear();
+
+  if (worker_exception_ != nullptr) {
+    std::exception_ptr worker_exception;
+    std::swap(worker_exception, worker_exception_);
+    std::rethrow_exception(worker_exception);
+  }
+}
+
+void ExchangeExecutor::StopWorkers() {
+  {
+    std::lock_guard<std::mutex> lock(output_tiles_mutex_);
+    stopped_ = true;
+    output_tiles_cv_.notify_all();
+  }
+
+  for (auto &worker_thread : worker_threads_) {
+    worker_thread.join();
+  }
+  worker_threads_.clear();
+
+  for (auto tile : output_tiles_) {
+    delete tile;
+  }
+  output_tiles_.clear();
+}
+
+}  // namespace executor
+}  // namespace peloton
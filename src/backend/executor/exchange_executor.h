@@ -0,0 +1,125 @@
+//===----------------------------------------------------------------------===//
+//
+//                         PelotonDB
+//
+// exchange_executor.h
+//
+// Identification: src/backend/executor/exchange_executor.h
+//
+// Copyright (c) 2015, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "backend/executor/abstract_executor.h"
+#include "backend/executor/executor_context.h"
+#include "backend/executor/morsel_scheduler.h"
+
+namespace peloton {
+namespace executor {
+
+/**
+ * @brief Exchange executor.
+ *
+ * Every child is the root of the copy of the pipeline run by one worker
+ * thread, built with the context of that worker. The workers share a morsel
+ * scheduler, so their scans split the tile groups of the table between them.
+ *
+ * The tiles of all workers are returned one at a time, in no particular
+ * order. A parent that only consumes its input can instead run the workers
+ * to completion with a consumer called on the thread of each worker, which
+ * keeps per worker state (partial aggregates, hashed batches) and merges it
+ * once the workers are done.
+ */
+class ExchangeExecutor : public AbstractExecutor {
+ public:
+  ExchangeExecutor(const ExchangeExecutor &) = delete;
+  ExchangeExecutor &operator=(const ExchangeExecutor &) = delete;
+  ExchangeExecutor(ExchangeExecutor &&) = delete;
+  ExchangeExecutor &operator=(ExchangeExecutor &&) = delete;
+
+  explicit ExchangeExecutor(const planner::AbstractPlan *node,
+                            ExecutorContext *executor_context);
+
+  ~ExchangeExecutor();
+
+  /**
+   * @brief Consumes a tile of the given worker, on the thread of the
+   * worker. Takes the ownership of the tile.
+   * @return false to stop all workers.
+   */
+  typedef std::function<bool(size_t, LogicalTile *)> TileConsumer;
+
+  // Add the context of the next worker, to build its pipeline with
+  ExecutorContext *AddWorkerContext();
+
+  inline ExecutorContext *GetWorkerContext(size_t worker) const {
+    return worker_contexts_[worker].get();
+  }
+
+  inline size_t GetWorkerCount() const { return children_.size(); }
+
+  // Run the pipelines of all workers to completion, passing their tiles to
+  // the consumer
+  bool RunWorkers(const TileConsumer &consumer);
+
+ protected:
+  bool DInit();
+
+  bool DExecute();
+
+ private:
+  void StartWorkers(const TileConsumer &consumer);
+
+  void RunWorker(size_t worker, const TileConsumer &consumer);
+
+  void JoinWorkers();
+
+  // Stop the workers and drop the tiles they have not handed out
+  void StopWorkers();
+
+  //===--------------------------------------------------------------------===//
+  // Executor State
+  //===--------------------------------------------------------------------===//
+
+  MorselScheduler morsel_scheduler_;
+
+  std::vector<std::unique_ptr<ExecutorContext>> worker_contexts_;
+
+  std::vector<std::thread> worker_threads_;
+
+  /** @brief The workers were started to return their tiles */
+  bool started_ = false;
+
+  /** @brief Workers whose pipeline is not exhausted yet */
+  size_t running_worker_count_ = 0;
+
+  /** @brief Set once a consumer fails or the workers are stopped */
+  std::atomic<bool> stopped_;
+
+  bool failed_ = false;
+
+  /** @brief First exception thrown by a worker, thrown again by the caller */
+  std::exception_ptr worker_exception_;
+
+  /** @brief Tiles of the workers, not returned yet */
+  std::deque<LogicalTile *> output_tiles_;
+
+  std::mutex output_tiles_mutex_;
+
+  std::condition_variable output_tiles_cv_;
+};
+
+}  // namespace executor
+}  // namespace peloton
@@ -18,6 +18,8 @@
 namespace peloton {
 namespace executor {
 
+class MorselScheduler;
+
 //===--------------------------------------------------------------------===//
 // Executor Context
 //===--------------------------------------------------------------------===//
@@ -43,6 +45,13 @@ class ExecutorContext {
   // Get a varlen pool (will construct the pool only if needed)
   VarlenPool *GetExecutorContextPool();
 
+  // Scheduler of the parallel pipeline run with this context, if any
+  MorselScheduler *GetMorselScheduler() const { return morsel_scheduler_; }
+
+  void SetMorselScheduler(MorselScheduler *morsel_scheduler) {
+    morsel_scheduler_ = morsel_scheduler;
+  }
+
   // num of tuple processed
   uint32_t num_processed = 0;
 
@@ -59,6 +68,9 @@ class ExecutorContext {
 
   // pool
   std::unique_ptr<VarlenPool> pool_;
+
+  // morsel scheduler
+  MorselScheduler *morsel_scheduler_ = nullptr;
 };
 
 }  // namespace executor
@@ -18,11 +18,13 @@
 #include "backend/executor/limit_executor.h"
 #include "backend/executor/materialization_executor.h"
 #include "backend/executor/seq_scan_executor.h"
+#include "backend/executor/exchange_executor.h"
 #include "backend/executor/index_scan_executor.h"
 #include "backend/executor/insert_executor.h"
 #include "backend/executor/delete_executor.h"
 #include "backend/executor/update_executor.h"
 #include "backend/executor/nested_loop_join_executor.h"
+#include "backend/executor/nested_loop_index_join_executor.h"
 #include "backend/executor/merge_join_executor.h"
 #include "backend/executor/hash_join_executor.h"
 #include "backend/executor/hash_executor.h"
@@ -2,9 +2,9 @@
 //
 //                         PelotonDB
 //
-// hash_set_op_executor.cpp
+// hash_executor.cpp
 //
-// Identification: src/backend/executor/hash_set_op_executor.cpp
+// Identification: src/backend/executor/hash_executor.cpp
 //
 // Copyright (c) 2015, Carnegie Mellon University Database Group
 //
@@ -14,8 +14,10 @@
 #include <vector>
 
 #include "backend/common/logger.h"
+#include "backend/common/thread_manager.h"
 #include "backend/common/value.h"
 #include "backend/executor/logical_tile.h"
+#include "backend/executor/exchange_executor.h"
 #include "backend/executor/hash_executor.h"
 #include "backend/planner/hash_plan.h"
 #include "backend/expression/tuple_value_expression.h"
@@ -41,6 +43,10 @@ bool HashExecutor::DInit() {
   done_ = false;
   result_itr = 0;
 
+  hash_table_.reset();
+  child_tiles_.clear();
+  column_ids_.clear();
+
   return true;
 }
 
@@ -50,9 +56,12 @@ bool HashExecutor::DExecute() {
   if (done_ == false) {
     const planner::HashPlan &node = GetPlanNode<planner::HashPlan>();
 
-    // First, get all the input logical tiles
+    // First, get all the non-empty input logical tiles
     while (children_[0]->Execute()) {
-      child_tiles_.emplace_back(children_[0]->GetOutput());
+      std::unique_ptr<LogicalTile> child_tile(children_[0]->GetOutput());
+      if (child_tile->GetTupleCount() > 0) {
+        child_tiles_.push_back(std::move(child_tile));
+      }
     }
 
     if (child_tiles_.size() == 0) {
@@ -77,39 +86,59 @@ bool HashExecutor::DExecute() {
       column_ids_.push_back(tuple_value->GetColumnId());
     }
 
-    // Construct the hash table by going over each child logical tile and
-    // hashing
-    for (size_t child_tile_itr = 0; child_tile_itr < child_tiles_.size();
-         child_tile_itr++) {
-      auto tile = child_tiles_[child_tile_itr].get();
-
-      // Go over all tuples in the logical tile
-      for (oid_t tuple_id : *tile) {
-        // Key : container tuple with a subset of tuple attributes
-        // Value : < child_tile offset, tuple offset >
-        hash_table_[HashMapType::key_type(tile, tuple_id, &column_ids_)].insert(
-            std::make_pair(child_tile_itr, tuple_id));
+    hash_table_.reset(new HashTable(
+        column_ids_,
+        HashTable::GetColumnTypes(child_tiles_.front().get(), column_ids_)));
+
+    size_t tuple_count = 0;
+    for (auto &child_tile : child_tiles_) {
+      tuple_count += child_tile->GetTupleCount();
+    }
+    hash_table_->Reserve(tuple_count);
+
+    // The tiles of a parallel pipeline are hashed and inserted in parallel
+    // as well
+    if (dynamic_cast<ExchangeExecutor *>(children_[0]) != nullptr) {
+      std::vector<HashTable::Batch> batches(child_tiles_.size());
+      std::vector<std::vector<oid_t>> null_key_rows(child_tiles_.size());
+      ThreadManager::RunInParallel(child_tiles_.size(), [&](size_t tile_itr) {
+        hash_table_->HashRows(child_tiles_[tile_itr].get(), column_ids_,
+                              batches[tile_itr], &null_key_rows[tile_itr]);
+      });
+      hash_table_->InsertInParallel(batches);
+    } else {
+      // Construct the hash table by going over each child logical tile and
+      // hashing
+      HashTable::Batch batch;
+      std::vector<oid_t> null_key_rows;
+      for (oid_t tile_itr = 0; tile_itr < child_tiles_.size(); tile_itr++) {
+        hash_table_->HashRows(child_tiles_[tile_itr].get(), column_ids_, batch,
+                              &null_key_rows);
+        hash_table_->Insert(batch, tile_itr);
       }
     }
 
+    LOG_TRACE("Hash Executor : %lu entries in %lu partitions",
+              hash_table_->GetEntryCount(), hash_table_->GetPartitionCount());
+
     done_ = true;
   }
 
   // Return logical tiles one at a time
-  while (result_itr < child_tiles_.size()) {
-    if (child_tiles_[result_itr]->GetTupleCount() == 0) {
-      result_itr++;
-      continue;
-    } else {
-      SetOutput(child_tiles_[result_itr++].release());
-      LOG_TRACE("Hash Executor : true -- return tile one at a time ");
-      return true;
-    }
+  if (result_itr < child_tiles_.size()) {
+    SetOutput(child_tiles_[result_itr++].release());
+    LOG_TRACE("Hash Executor : true -- return tile one at a time ");
+    return true;
   }
 
   LOG_TRACE("Hash Executor : false -- done ");
   return false;
 }
 
+LogicalTile *HashExecutor::GetEmptyOutput() {
+  assert(children_.size() == 1);
+  return children_[0]->GetEmptyOutput();
+}
+
 } /* namespace executor */
 } /* namespace peloton */
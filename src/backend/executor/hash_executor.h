@@ -2,7 +2,7 @@
 //
 //                         PelotonDB
 //
-// hash_set_op_executor.h
+// hash_executor.h
 //
 // Identification: src/backend/executor/hash_executor.h
 //
@@ -12,15 +12,13 @@
 
 #pragma once
 
-#include <unordered_map>
-#include <unordered_set>
+#include <memory>
+#include <vector>
 
 #include "backend/common/types.h"
 #include "backend/executor/abstract_executor.h"
+#include "backend/executor/hash_table.h"
 #include "backend/executor/logical_tile.h"
-#include "backend/expression/container_tuple.h"
-
-#include <boost/functional/hash.hpp>
 
 namespace peloton {
 namespace executor {
@@ -28,6 +26,11 @@ namespace executor {
 /**
  * @brief Hash executor.
  *
+ * Builds a hash table over the rows of the child tiles and then returns the
+ * non-empty child tiles one at a time, in the order of the tile offsets of
+ * the hash table entries. Rows with a null key match no other row, so they
+ * are left out of the table. The tiles of a parallel pipeline (an exchange
+ * child) are hashed and inserted in parallel.
  */
 class HashExecutor : public AbstractExecutor {
  public:
@@ -39,20 +42,15 @@ class HashExecutor : public AbstractExecutor {
   explicit HashExecutor(const planner::AbstractPlan *node,
                         ExecutorContext *executor_context);
 
-  /** @brief Type definitions for hash table */
-  typedef std::unordered_map<
-      expression::ContainerTuple<LogicalTile>,
-      std::unordered_set<std::pair<size_t, oid_t>,
-                         boost::hash<std::pair<size_t, oid_t>>>,
-      expression::ContainerTupleHasher<LogicalTile>,
-      expression::ContainerTupleComparator<LogicalTile>> HashMapType;
-
-  inline HashMapType &GetHashTable() { return this->hash_table_; }
+  inline const HashTable &GetHashTable() const { return *hash_table_; }
 
   inline const std::vector<oid_t> &GetHashKeyIds() const {
     return this->column_ids_;
   }
 
+  // The hashed tiles are the tiles of the child
+  LogicalTile *GetEmptyOutput();
+
  protected:
   bool DInit();
 
@@ -60,7 +58,7 @@ class HashExecutor : public AbstractExecutor {
 
  private:
   /** @brief Hash table */
-  HashMapType hash_table_;
+  std::unique_ptr<HashTable> hash_table_;
 
   /** @brief Input tiles from child node */
   std::vector<std::unique_ptr<LogicalTile>> child_tiles_;
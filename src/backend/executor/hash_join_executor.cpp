@@ -10,18 +10,25 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include <numeric>
+#include <string>
 #include <vector>
 
+#include "backend/common/exception.h"
 #include "backend/common/types.h"
 #include "backend/common/logger.h"
 #include "backend/executor/logical_tile_factory.h"
 #include "backend/executor/hash_join_executor.h"
 #include "backend/expression/abstract_expression.h"
 #include "backend/expression/container_tuple.h"
+#include "backend/expression/tuple_value_expression.h"
 
 namespace peloton {
 namespace executor {
 
+// Left rows probed ahead of the bucket prefetched for them
+static const size_t HASH_JOIN_PREFETCH_DISTANCE = 8;
+
 /**
  * @brief Constructor for hash join executor.
  * @param node Hash join node corresponding to this executor.
@@ -30,6 +37,13 @@ HashJoinExecutor::HashJoinExecutor(const planner::AbstractPlan *node,
                                    ExecutorContext *executor_context)
     : AbstractJoinExecutor(node, executor_context) {}
 
+HashJoinExecutor::~HashJoinExecutor() {
+  // Clean up the tiles that were never returned
+  for (auto output_tile : buffered_output_tiles) {
+    delete output_tile;
+  }
+}
+
 bool HashJoinExecutor::DInit() {
   assert(children_.size() == 2);
 
@@ -40,6 +54,28 @@ bool HashJoinExecutor::DInit() {
 
   hash_executor_ = reinterpret_cast<HashExecutor *>(children_[1]);
 
+  const planner::HashJoinPlan &node = GetPlanNode<planner::HashJoinPlan>();
+
+  // The left keys are compared with the right keys in the same order
+  left_key_column_ids_.clear();
+  for (auto &hash_key : node.GetOuterHashKeys()) {
+    assert(hash_key->GetExpressionType() == EXPRESSION_TYPE_VALUE_TUPLE);
+    auto tuple_value =
+        reinterpret_cast<const expression::TupleValueExpression *>(
+            hash_key.get());
+    left_key_column_ids_.push_back(tuple_value->GetColumnId());
+  }
+
+  for (auto output_tile : buffered_output_tiles) {
+    delete output_tile;
+  }
+  buffered_output_tiles.clear();
+  right_tile_matches_.clear();
+
+  left_child_done_ = false;
+  right_child_done_ = false;
+  right_child_empty_ = false;
+
   return true;
 }
 
@@ -49,36 +85,255 @@ bool HashJoinExecutor::DInit() {
  * @return true on success, false otherwise.
  */
 bool HashJoinExecutor::DExecute() {
+  LOG_INFO("********** Hash %s Join executor :: 2 children ",
+           GetJoinTypeString());
+
   // Loop until we have non-empty result join logical tile or exit
+  for (;;) {
+    if (buffered_output_tiles.empty() == false) {
+      SetOutput(buffered_output_tiles.front());
+      buffered_output_tiles.pop_front();
+      return true;
+    }
+
+    // Build outer join output when done
+    if (left_child_done_ == true) {
+      return BuildOuterJoinOutput();
+    }
+
+    //===--------------------------------------------------------------------===//
+    // Pick right and left tiles
+    //===--------------------------------------------------------------------===//
+
+    // Get all the logical tiles from RIGHT child, the hash executor builds
+    // its hash table before it returns the first one
+    if (right_child_done_ == false) {
+      while (children_[1]->Execute() == true) {
+        BufferRightTile(children_[1]->GetOutput());
+      }
+      right_child_done_ = true;
+
+      // The left rows are still returned without a match, padded with the
+      // null columns of the empty right input
+      if (right_result_tiles_.empty() &&
+          (join_type_ == JOIN_TYPE_LEFT || join_type_ == JOIN_TYPE_OUTER ||
+           join_type_ == JOIN_TYPE_ANTI)) {
+        BufferRightTile(GetEmptyChildOutput(1));
+        right_child_empty_ = true;
+      }
+      right_tile_matches_.resize(right_result_tiles_.size());
+    }
+
+    if (right_result_tiles_.empty()) {
+      LOG_TRACE("Right child returned nothing. Exit.");
+      return false;
+    }
+
+    // Get next logical tile from LEFT child
+    if (children_[0]->Execute() == false) {
+      LOG_TRACE("Left child is exhausted.");
+      left_child_done_ = true;
+
+      // Likewise the right rows of an empty left input
+      if (left_result_tiles_.empty() &&
+          (join_type_ == JOIN_TYPE_RIGHT || join_type_ == JOIN_TYPE_OUTER)) {
+        BufferLeftTile(GetEmptyChildOutput(0));
+      }
+      continue;
+    }
+
+    BufferLeftTile(children_[0]->GetOutput());
+
+    // There is no hash table to probe, the left rows have no match
+    if (right_child_empty_ == true) {
+      if (join_type_ == JOIN_TYPE_ANTI) {
+        auto left_tile = left_result_tiles_.back().get();
+        BufferRightNullRows(left_tile, std::vector<oid_t>(left_tile->begin(),
+                                                          left_tile->end()));
+      }
+      continue;
+    }
+
+    //===--------------------------------------------------------------------===//
+    // Build Join Tile
+    //===--------------------------------------------------------------------===//
+
+    ProbeLeftTile();
+  }
+}
+
+/**
+ * @brief Probe the hash table with the rows of the last left tile, and build
+ * an output tile for every right tile with matching rows. Semi and anti joins
+ * return the left rows with and without a match, padded with nulls.
+ */
+void HashJoinExecutor::ProbeLeftTile() {
+  auto left_tile_itr = left_result_tiles_.size() - 1;
+  auto left_tile = left_result_tiles_.back().get();
+
+  //===--------------------------------------------------------------------===//
+  // Hash the keys of the left tile
+  //===--------------------------------------------------------------------===//
 
-  // Build outer join output when done
+  auto &hash_table = hash_executor_->GetHashTable();
+
+  // A null key matches no right row
+  std::vector<oid_t> null_key_rows;
+  hash_table.HashRows(left_tile, left_key_column_ids_, probe_batch_,
+                      &null_key_rows);
+
+  std::vector<oid_t> null_padded_rows;
+  if (join_type_ == JOIN_TYPE_ANTI) {
+    null_padded_rows.swap(null_key_rows);
+  }
+
+  // Probe the rows in the order of the hash table partitions
+  auto &probe_hashes = probe_batch_.hashes;
+  std::vector<oid_t> probe_order(probe_hashes.size());
+  auto partition_count = hash_table.GetPartitionCount();
+  if (partition_count == 1) {
+    std::iota(probe_order.begin(), probe_order.end(), 0);
+  } else {
+    std::vector<size_t> partition_offsets(partition_count + 1, 0);
+    for (auto hash : probe_hashes) {
+      partition_offsets[hash_table.GetPartition(hash) + 1]++;
+    }
+    for (size_t partition_itr = 0; partition_itr < partition_count;
+         partition_itr++) {
+      partition_offsets[partition_itr + 1] += partition_offsets[partition_itr];
+    }
+    for (oid_t probe_itr = 0; probe_itr < probe_hashes.size(); probe_itr++) {
+      auto partition = hash_table.GetPartition(probe_hashes[probe_itr]);
+      probe_order[partition_offsets[partition]++] = probe_itr;
+    }
+  }
 
   //===--------------------------------------------------------------------===//
-  // Pick right and left tiles
+  // Find the matching right rows
   //===--------------------------------------------------------------------===//
 
-  // Get all the logical tiles from RIGHT child
+  std::vector<oid_t> matched_right_tiles;
+
+  for (size_t order_itr = 0; order_itr < probe_order.size(); order_itr++) {
+    if (order_itr + HASH_JOIN_PREFETCH_DISTANCE < probe_order.size()) {
+      auto prefetch_itr = probe_order[order_itr + HASH_JOIN_PREFETCH_DISTANCE];
+      hash_table.Prefetch(probe_hashes[prefetch_itr]);
+    }
+
+    auto probe_itr = probe_order[order_itr];
+    auto left_row = probe_batch_.rows[probe_itr];
+    bool has_right_match = false;
+
+    hash_table.FindAll(probe_batch_, probe_itr, [&](oid_t entry_itr) -> bool {
+      auto &entry = hash_table.GetEntry(entry_itr);
+      if (MatchesRightRow(left_tile, left_row, entry) == false) {
+        return true;
+      }
+
+      has_right_match = true;
 
-  // Get next logical tile from LEFT child
+      // Semi and anti joins only look for the first match
+      if (join_type_ == JOIN_TYPE_SEMI || join_type_ == JOIN_TYPE_ANTI) {
+        return false;
+      }
+
+      auto &matches = right_tile_matches_[entry.tile_itr];
+      if (matches.empty()) {
+        matched_right_tiles.push_back(entry.tile_itr);
+      }
+      matches.emplace_back(left_row, entry.tuple_id);
+
+      RecordMatchedRightRow(entry.tile_itr, entry.tuple_id);
+      return true;
+    });
+
+    if (has_right_match == true) {
+      RecordMatchedLeftRow(left_tile_itr, left_row);
+      if (join_type_ == JOIN_TYPE_SEMI) {
+        null_padded_rows.push_back(left_row);
+      }
+    } else if (join_type_ == JOIN_TYPE_ANTI) {
+      null_padded_rows.push_back(left_row);
+    }
+  }
 
   //===--------------------------------------------------------------------===//
-  // Build Join Tile
+  // Build the output tiles
   //===--------------------------------------------------------------------===//
 
-  // Build output join logical tile
+  for (auto right_tile_itr : matched_right_tiles) {
+    auto right_tile = right_result_tiles_[right_tile_itr].get();
+    auto &matches = right_tile_matches_[right_tile_itr];
+
+    auto output_tile = BuildOutputLogicalTile(left_tile, right_tile);
+    LogicalTile::PositionListsBuilder pos_lists_builder(left_tile, right_tile);
+    for (auto &match : matches) {
+      pos_lists_builder.AddRow(match.first, match.second);
+    }
+    matches.clear();
+
+    output_tile->SetPositionListsAndVisibility(pos_lists_builder.Release());
+    buffered_output_tiles.push_back(output_tile.release());
+  }
+
+  if (null_padded_rows.empty() == false) {
+    BufferRightNullRows(left_tile, null_padded_rows);
+  }
+}
 
-  // Build position lists
+/**
+ * @brief Build an output tile of left rows padded with nulls.
+ */
+void HashJoinExecutor::BufferRightNullRows(
+    LogicalTile *left_tile, const std::vector<oid_t> &left_rows) {
+  auto right_tile = right_result_tiles_.front().get();
 
-  // Get the hash table from the hash executor
+  auto output_tile = BuildOutputLogicalTile(left_tile, right_tile);
+  LogicalTile::PositionListsBuilder pos_lists_builder(left_tile, right_tile);
+  for (auto left_row : left_rows) {
+    pos_lists_builder.AddRightNullRow(left_row);
+  }
 
-  // Go over the left logical tile
-  // For each tuple, find matching tuples in the hash table built on top of the
-  // right table
-  // Go over the matching right tuples
+  output_tile->SetPositionListsAndVisibility(pos_lists_builder.Release());
+  buffered_output_tiles.push_back(output_tile.release());
+}
 
-  // Check if we have any join tuples
+/**
+ * @brief Get a tile with the columns of a child that returned no rows, so
+ * that the rows of the other input can be padded with its nulls.
+ */
+LogicalTile *HashJoinExecutor::GetEmptyChildOutput(size_t child_idx) {
+  auto empty_tile = children_[child_idx]->GetEmptyOutput();
+  if (empty_tile == nullptr) {
+    throw ExecutorException("Could not get the columns of an empty " +
+                            std::string(child_idx == 0 ? "left" : "right") +
+                            " join input");
+  }
+  return empty_tile;
+}
 
-  return false;
+/**
+ * @brief Check the join predicate on a right row with the key of the left
+ * row.
+ */
+bool HashJoinExecutor::MatchesRightRow(LogicalTile *left_tile, oid_t left_row,
+                                       const HashTable::Entry &entry) {
+  auto right_tile = right_result_tiles_[entry.tile_itr].get();
+
+  // Join predicate exists
+  if (predicate_ != nullptr) {
+    expression::ContainerTuple<executor::LogicalTile> left_tuple(left_tile,
+                                                                 left_row);
+    expression::ContainerTuple<executor::LogicalTile> right_tuple(
+        right_tile, entry.tuple_id);
+
+    if (predicate_->Evaluate(&left_tuple, &right_tuple, executor_context_)
+            .IsFalse()) {
+      return false;
+    }
+  }
+
+  return true;
 }
 
 }  // namespace executor
@@ -13,14 +13,23 @@
 #pragma once
 
 #include <deque>
+#include <utility>
+#include <vector>
 
 #include "backend/executor/abstract_join_executor.h"
 #include "backend/planner/hash_join_plan.h"
 #include "backend/executor/hash_executor.h"
+#include "backend/executor/hash_table.h"
 
 namespace peloton {
 namespace executor {
 
+/**
+ * Hash join of the left child with the hash table that the hash executor
+ * builds over the right child. Every left tile is probed as a whole: the
+ * keys of its rows are hashed first, and the rows are probed in the order of
+ * the hash table partitions.
+ */
 class HashJoinExecutor : public AbstractJoinExecutor {
   HashJoinExecutor(const HashJoinExecutor &) = delete;
   HashJoinExecutor &operator=(const HashJoinExecutor &) = delete;
@@ -29,20 +38,40 @@ class HashJoinExecutor : public AbstractJoinExecutor {
   explicit HashJoinExecutor(const planner::AbstractPlan *node,
                             ExecutorContext *executor_context);
 
+  ~HashJoinExecutor();
+
  protected:
   bool DInit();
 
   bool DExecute();
 
  private:
+  void ProbeLeftTile();
+
+  void BufferRightNullRows(LogicalTile *left_tile,
+                           const std::vector<oid_t> &left_rows);
+
+  LogicalTile *GetEmptyChildOutput(size_t child_idx);
+
+  bool MatchesRightRow(LogicalTile *left_tile, oid_t left_row,
+                       const HashTable::Entry &entry);
+
   HashExecutor *hash_executor_ = nullptr;
 
   std::deque<LogicalTile *> buffered_output_tiles;
 
-  // logical tile iterators
-  size_t left_logical_tile_itr_ = 0;
-  size_t right_logical_tile_itr_ = 0;
+  // key columns of the left tiles
+  std::vector<oid_t> left_key_column_ids_;
+
+  // hashed keys of the probed left tile
+  HashTable::Batch probe_batch_;
+
+  // matching <left row, right row> pairs of the probed left tile, per right
+  // tile
+  std::vector<std::vector<std::pair<oid_t, oid_t>>> right_tile_matches_;
 
+  // the right child returned no rows, and there is no hash table
+  bool right_child_empty_ = false;
 };
 
 }  // namespace executor
@@ -10,6 +10,7 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include <numeric>
 #include <utility>
 #include <vector>
 
@@ -77,10 +78,24 @@ bool HashSetOpExecutor::ExecuteHelper() {
 
   if (left_tiles_.size() == 0) return false;
 
-  // Scan the left child's input and update the counters
-  for (auto &tile : left_tiles_) {
-    for (oid_t tuple_id : *tile) {
-      htable_[HashSetOpMapType::key_type(tile.get(), tuple_id)].left++;
+  // All columns make up the key
+  std::vector<oid_t> column_ids(left_tiles_.front()->GetColumnCount());
+  std::iota(column_ids.begin(), column_ids.end(), 0);
+  htable_.reset(new HashTable(
+      column_ids,
+      HashTable::GetColumnTypes(left_tiles_.front().get(), column_ids)));
+
+  // Scan the left child's input and update the counters, remembering the
+  // key of every left row
+  HashTable::Batch batch;
+  std::vector<std::vector<oid_t>> left_row_entries(left_tiles_.size());
+  for (oid_t tile_itr = 0; tile_itr < left_tiles_.size(); tile_itr++) {
+    htable_->HashRows(left_tiles_[tile_itr].get(), column_ids, batch);
+    htable_->FindOrInsert(batch, tile_itr, left_row_entries[tile_itr]);
+
+    counters_.resize(htable_->GetEntryCount());
+    for (auto entry_itr : left_row_entries[tile_itr]) {
+      counters_[entry_itr].left++;
     }
   }
 
@@ -89,12 +104,13 @@ bool HashSetOpExecutor::ExecuteHelper() {
     // Each right tile can be destroyed after processing
     std::unique_ptr<LogicalTile> tile(children_[1]->GetOutput());
 
-    for (oid_t tuple_id : *tile) {
-      auto it = htable_.find(HashSetOpMapType::key_type(tile.get(), tuple_id));
+    htable_->HashRows(tile.get(), column_ids, batch);
+    for (size_t batch_itr = 0; batch_itr < batch.rows.size(); batch_itr++) {
+      auto entry_itr = htable_->Find(batch, batch_itr);
       // Do nothing if this key never appears in the left child
       // because it shouldn't show up in the result anyway
-      if (it != htable_.end()) {
-        it->second.right++;
+      if (entry_itr != INVALID_OID) {
+        counters_[entry_itr].right++;
       }
     }
   }
@@ -102,53 +118,34 @@ bool HashSetOpExecutor::ExecuteHelper() {
   // Calculate the output number for each key
   switch (set_op_) {
     case SETOP_TYPE_INTERSECT:
-      CalculateCopies<SETOP_TYPE_INTERSECT>(htable_);
+      CalculateCopies<SETOP_TYPE_INTERSECT>(counters_);
       break;
     case SETOP_TYPE_INTERSECT_ALL:
-      CalculateCopies<SETOP_TYPE_INTERSECT_ALL>(htable_);
+      CalculateCopies<SETOP_TYPE_INTERSECT_ALL>(counters_);
       break;
     case SETOP_TYPE_EXCEPT:
-      CalculateCopies<SETOP_TYPE_EXCEPT>(htable_);
+      CalculateCopies<SETOP_TYPE_EXCEPT>(counters_);
       break;
     case SETOP_TYPE_EXCEPT_ALL:
-      CalculateCopies<SETOP_TYPE_EXCEPT_ALL>(htable_);
+      CalculateCopies<SETOP_TYPE_EXCEPT_ALL>(counters_);
       break;
     case SETOP_TYPE_INVALID:
       return false;
   }
 
-  /*
-   * A bit cumbersome here:
-   * Since the first tuple of each group is used as the representative key
-   * in the hash table,
-   * we cannot invalidate it otherwise subsequent key comparison will fail
-   * (due to safety check in LogicalTile::GetValue()).
-   * Instead, we skip the first tuple and process it in a second round.
-   */
-
-  // 1st round
-  for (auto &tile : left_tiles_) {
-    for (oid_t tuple_id : *tile) {
-      auto it = htable_.find(HashSetOpMapType::key_type(tile.get(), tuple_id));
-
-      assert(it != htable_.end());
-
-      if (it->first.GetContainer() == tile.get() &&
-          it->first.GetTupleId() == tuple_id)
-        continue;
-      else if (it->second.left > 0)
-        it->second.left--;
+  // Keep the first copies of every key. The keys of the left rows were
+  // looked up before, so invalidating rows does not affect the comparisons.
+  for (oid_t tile_itr = 0; tile_itr < left_tiles_.size(); tile_itr++) {
+    auto &tile = left_tiles_[tile_itr];
+    auto &row_entries = left_row_entries[tile_itr];
+    std::vector<oid_t> rows(tile->begin(), tile->end());
+
+    for (size_t row_itr = 0; row_itr < rows.size(); row_itr++) {
+      auto &counter = counters_[row_entries[row_itr]];
+      if (counter.left > 0)
+        counter.left--;
       else
-        tile->RemoveVisibility(tuple_id);
-    }
-  }
-
-  // 2nd round
-  for (auto &item : htable_) {
-    // We should have at most one quota left
-    assert(item.second.left == 1 || item.second.left == 0);
-    if (item.second.left == 0) {
-      item.first.GetContainer()->RemoveVisibility(item.first.GetTupleId());
+        tile->RemoveVisibility(rows[row_itr]);
     }
   }
 
@@ -163,22 +160,22 @@ bool HashSetOpExecutor::ExecuteHelper() {
  * and store it in the left counter.
  */
 template <SetOpType SETOP>
-bool HashSetOpExecutor::CalculateCopies(HashSetOpMapType &htable) {
-  for (auto &item : htable) {
+bool HashSetOpExecutor::CalculateCopies(std::vector<counter_pair_t> &counters) {
+  for (auto &counter : counters) {
     switch (SETOP) {
       case SETOP_TYPE_INTERSECT:
-        item.second.left = (item.second.right > 0) ? 1 : 0;
+        counter.left = (counter.right > 0) ? 1 : 0;
         break;
       case SETOP_TYPE_INTERSECT_ALL:
-        item.second.left = std::min(item.second.left, item.second.right);
+        counter.left = std::min(counter.left, counter.right);
         break;
       case SETOP_TYPE_EXCEPT:
-        item.second.left = (item.second.right > 0) ? 0 : 1;
+        counter.left = (counter.right > 0) ? 0 : 1;
         break;
       case SETOP_TYPE_EXCEPT_ALL:
-        item.second.left = (item.second.left > item.second.right)
-                               ? (item.second.left - item.second.right)
-                               : 0;
+        counter.left = (counter.left > counter.right)
+                           ? (counter.left - counter.right)
+                           : 0;
         break;
       default:
         return false;
@@ -12,12 +12,13 @@
 
 #pragma once
 
-#include <unordered_map>
+#include <memory>
+#include <vector>
 
 #include "backend/common/types.h"
 #include "backend/executor/abstract_executor.h"
+#include "backend/executor/hash_table.h"
 #include "backend/executor/logical_tile.h"
-#include "backend/expression/container_tuple.h"
 
 namespace peloton {
 namespace executor {
@@ -59,21 +60,19 @@ class HashSetOpExecutor : public AbstractExecutor {
     size_t right = 0;
   } counter_pair_t;
 
-  /** @brief Type definitions for hash table */
-  typedef std::unordered_map<
-      expression::ContainerTuple<LogicalTile>, counter_pair_t,
-      expression::ContainerTupleHasher<LogicalTile>,
-      expression::ContainerTupleComparator<LogicalTile>> HashSetOpMapType;
-
   /* Helper functions */
 
   bool ExecuteHelper();
 
   template <SetOpType SETOP>
-  bool CalculateCopies(HashSetOpMapType &htable);
+  bool CalculateCopies(std::vector<counter_pair_t> &counters);
+
+  /** @brief Hash table over the rows of the left child, with all columns as
+   * the key */
+  std::unique_ptr<HashTable> htable_;
 
-  /** @brief Hash table */
-  HashSetOpMapType htable_;
+  /** @brief Counters of every key in the hash table, by entry */
+  std::vector<counter_pair_t> counters_;
 
   /** @brief The specified set-op type */
   SetOpType set_op_ = SETOP_TYPE_INVALID;
@@ -0,0 +1,376 @@
+//===----------------------------------------------------------------------===//
+//
+//                         PelotonDB
+//
+// hash_table.cpp
+//
+// Identification: src/backend/executor/hash_table.cpp
+//
+// Copyright (c) 2015, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <cassert>
+#include <cstring>
+#include <vector>
+
+#include "backend/common/thread_manager.h"
+#include "backend/common/value.h"
+#include "backend/common/value_peeker.h"
+#include "backend/executor/hash_table.h"
+#include "backend/storage/tile.h"
+
+namespace peloton {
+namespace executor {
+
+// Size of a partition that should stay in the L2 cache
+static const size_t HASH_PARTITION_SIZE = 256 * 1024;
+
+// Partitions are sized up front, more of them would thrash the TLB
+static const size_t MAX_RADIX_BITS = 8;
+
+// An encoded key column holds the integer value and a null flag
+static const size_t ENCODED_COLUMN_SIZE = sizeof(int64_t) + 1;
+
+static bool IsIntegerType(ValueType type) {
+  switch (type) {
+    case VALUE_TYPE_TINYINT:
+    case VALUE_TYPE_SMALLINT:
+    case VALUE_TYPE_INTEGER:
+    case VALUE_TYPE_BIGINT:
+    case VALUE_TYPE_TIMESTAMP:
+    case VALUE_TYPE_BOOLEAN:
+      return true;
+    default:
+      return false;
+  }
+}
+
+static int64_t GetIntegerValue(const Value &value) {
+  switch (value.GetValueType()) {
+    case VALUE_TYPE_TINYINT:
+      return ValuePeeker::PeekTinyInt(value);
+    case VALUE_TYPE_SMALLINT:
+      return ValuePeeker::PeekSmallInt(value);
+    case VALUE_TYPE_INTEGER:
+      return ValuePeeker::PeekInteger(value);
+    case VALUE_TYPE_BIGINT:
+      return ValuePeeker::PeekBigInt(value);
+    case VALUE_TYPE_TIMESTAMP:
+      return ValuePeeker::PeekTimestamp(value);
+    case VALUE_TYPE_BOOLEAN:
+      return ValuePeeker::PeekBoolean(value);
+    default:
+      assert(false);
+      return 0;
+  }
+}
+
+HashTable::HashTable(const std::vector<oid_t> &column_ids,
+                     const std::vector<ValueType> &column_types)
+    : column_ids_(column_ids), encode_keys_(true), key_size_(0) {
+  assert(column_ids.size() == column_types.size());
+
+  for (auto column_type : column_types) {
+    encode_keys_ = encode_keys_ && IsIntegerType(column_type);
+  }
+  if (encode_keys_ == true) {
+    key_size_ = column_ids.size() * ENCODED_COLUMN_SIZE;
+  }
+
+  partitions_.resize(1);
+  ResizePartition(partitions_[0], 1);
+}
+
+std::vector<ValueType> HashTable::GetColumnTypes(
+    LogicalTile *tile, const std::vector<oid_t> &column_ids) {
+  std::vector<ValueType> column_types;
+  for (auto column_id : column_ids) {
+    auto &column_info = tile->GetColumnInfo(column_id);
+    column_types.push_back(column_info.base_tile->GetSchema()->GetType(
+        column_info.origin_column_id));
+  }
+  return column_types;
+}
+
+/**
+ * @brief Size an empty table for the given number of entries. The table is
+ * partitioned until a partition fits in the cache, and every partition gets
+ * enough groups for its share of the entries.
+ */
+void HashTable::Reserve(size_t entry_count) {
+  assert(entries_.empty());
+
+  size_t entry_size = sizeof(Entry) + key_size_ + sizeof(oid_t) + 1;
+  size_t table_size = entry_count * entry_size;
+
+  radix_bits_ = 0;
+  while (radix_bits_ < MAX_RADIX_BITS &&
+         (table_size >> radix_bits_) > HASH_PARTITION_SIZE) {
+    radix_bits_++;
+  }
+
+  // Keep the partitions at most 7/8 full
+  size_t partition_entry_count = (entry_count >> radix_bits_) + 1;
+  size_t slot_count = partition_entry_count + partition_entry_count / 7 + 1;
+  size_t group_count = 1;
+  while (group_count * GROUP_SIZE < slot_count) {
+    group_count *= 2;
+  }
+
+  partitions_.clear();
+  partitions_.resize(static_cast<size_t>(1) << radix_bits_);
+  for (auto &partition : partitions_) {
+    ResizePartition(partition, group_count);
+  }
+}
+
+void HashTable::HashRows(LogicalTile *tile,
+                         const std::vector<oid_t> &column_ids, Batch &batch,
+                         std::vector<oid_t> *null_key_rows) const {
+  assert(column_ids.size() == column_ids_.size());
+
+  batch.tile = tile;
+  batch.column_ids = &column_ids;
+  batch.rows.clear();
+  batch.hashes.clear();
+  batch.keys.clear();
+
+  for (oid_t tuple_id : *tile) {
+    size_t hash = 0;
+    bool has_null = false;
+    size_t key_offset = batch.keys.size();
+    batch.keys.resize(key_offset + key_size_);
+
+    for (oid_t column_itr = 0; column_itr < column_ids.size(); column_itr++) {
+      const Value value = tile->GetValue(tuple_id, column_ids[column_itr]);
+      bool is_null = value.IsNull();
+      has_null = has_null || is_null;
+
+      if (encode_keys_ == true) {
+        int64_t integer_value = (is_null == true) ? 0 : GetIntegerValue(value);
+        char *column_key =
+            &batch.keys[key_offset + column_itr * ENCODED_COLUMN_SIZE];
+        memcpy(column_key, &integer_value, sizeof(int64_t));
+        column_key[sizeof(int64_t)] = is_null;
+
+        hash = (hash + static_cast<size_t>(integer_value)) *
+                   0x9e3779b97f4a7c15ULL +
+               is_null;
+      } else {
+        value.HashCombine(hash);
+      }
+    }
+
+    if (has_null == true && null_key_rows != nullptr) {
+      null_key_rows->push_back(tuple_id);
+      batch.keys.resize(key_offset);
+      continue;
+    }
+
+    batch.rows.push_back(tuple_id);
+    batch.hashes.push_back(MixHash(hash));
+  }
+}
+
+void HashTable::Insert(const Batch &batch, oid_t tile_itr) {
+  if (tiles_.size() <= tile_itr) {
+    tiles_.resize(tile_itr + 1, nullptr);
+  }
+  tiles_[tile_itr] = batch.tile;
+
+  // Equal keys get an entry each
+  for (size_t batch_itr = 0; batch_itr < batch.rows.size(); batch_itr++) {
+    auto hash = batch.hashes[batch_itr];
+    InsertEntry(partitions_[GetPartition(hash)],
+                AddEntry(batch, batch_itr, tile_itr));
+  }
+}
+
+void HashTable::InsertInParallel(const std::vector<Batch> &batches) {
+  assert(entries_.empty());
+
+  // The entries of a batch follow the entries of the batches before it
+  std::vector<size_t> batch_offsets(batches.size() + 1, 0);
+  tiles_.resize(batches.size(), nullptr);
+  for (oid_t tile_itr = 0; tile_itr < batches.size(); tile_itr++) {
+    tiles_[tile_itr] = batches[tile_itr].tile;
+    batch_offsets[tile_itr + 1] =
+        batch_offsets[tile_itr] + batches[tile_itr].rows.size();
+  }
+
+  size_t entry_count = batch_offsets.back();
+  entries_.resize(entry_count);
+  key_arena_.resize(entry_count * key_size_);
+
+  ThreadManager::RunInParallel(batches.size(), [&](size_t tile_itr) {
+    auto &batch = batches[tile_itr];
+    auto batch_offset = batch_offsets[tile_itr];
+    for (size_t batch_itr = 0; batch_itr < batch.rows.size(); batch_itr++) {
+      auto &entry = entries_[batch_offset + batch_itr];
+      entry.hash = batch.hashes[batch_itr];
+      entry.tile_itr = tile_itr;
+      entry.tuple_id = batch.rows[batch_itr];
+    }
+
+    if (encode_keys_ == true && batch.rows.empty() == false) {
+      memcpy(&key_arena_[batch_offset * key_size_], batch.keys.data(),
+             batch.rows.size() * key_size_);
+    }
+  });
+
+  // Group the entries by partition
+  std::vector<size_t> partition_offsets(partitions_.size() + 1, 0);
+  for (auto &entry : entries_) {
+    partition_offsets[GetPartition(entry.hash) + 1]++;
+  }
+  for (size_t partition_itr = 0; partition_itr < partitions_.size();
+       partition_itr++) {
+    partition_offsets[partition_itr + 1] += partition_offsets[partition_itr];
+  }
+
+  std::vector<oid_t> partition_entries(entry_count);
+  std::vector<size_t> next_offsets(partition_offsets);
+  for (oid_t entry_itr = 0; entry_itr < entry_count; entry_itr++) {
+    auto partition_itr = GetPartition(entries_[entry_itr].hash);
+    partition_entries[next_offsets[partition_itr]++] = entry_itr;
+  }
+
+  ThreadManager::RunInParallel(partitions_.size(), [&](size_t partition_itr) {
+    auto &partition = partitions_[partition_itr];
+    for (size_t offset = partition_offsets[partition_itr];
+         offset < partition_offsets[partition_itr + 1]; offset++) {
+      InsertEntry(partition, partition_entries[offset]);
+    }
+  });
+}
+
+void HashTable::FindOrInsert(const Batch &batch, oid_t tile_itr,
+                             std::vector<oid_t> &entry_itrs) {
+  if (tiles_.size() <= tile_itr) {
+    tiles_.resize(tile_itr + 1, nullptr);
+  }
+  tiles_[tile_itr] = batch.tile;
+
+  entry_itrs.clear();
+  for (size_t batch_itr = 0; batch_itr < batch.rows.size(); batch_itr++) {
+    auto hash = batch.hashes[batch_itr];
+    auto &partition = partitions_[GetPartition(hash)];
+    if ((partition.entry_count + 1) * 8 > partition.tags.size() * 7) {
+      ResizePartition(partition, (partition.group_mask + 1) * 2);
+    }
+
+    oid_t found_entry_itr = INVALID_OID;
+    size_t slot_itr =
+        ProbeSlots(partition, hash, [&](oid_t entry_itr) -> bool {
+          if (entries_[entry_itr].hash != hash ||
+              KeyEquals(batch, batch_itr, entry_itr) == false) {
+            return true;
+          }
+          found_entry_itr = entry_itr;
+          return false;
+        });
+
+    if (found_entry_itr == INVALID_OID) {
+      found_entry_itr = AddEntry(batch, batch_itr, tile_itr);
+      FillSlot(partition, slot_itr, found_entry_itr);
+    }
+    entry_itrs.push_back(found_entry_itr);
+  }
+}
+
+/**
+ * @brief Compare the key of a row of the batch with the key of an entry,
+ * in the arena if the keys are encoded. Null keys are equal to each other.
+ */
+bool HashTable::KeyEquals(const Batch &batch, size_t batch_itr,
+                          oid_t entry_itr) const {
+  if (encode_keys_ == true) {
+    return memcmp(&batch.keys[batch_itr * key_size_],
+                  &key_arena_[entry_itr * key_size_], key_size_) == 0;
+  }
+
+  auto &entry = entries_[entry_itr];
+  auto entry_tile = tiles_[entry.tile_itr];
+  auto tuple_id = batch.rows[batch_itr];
+
+  for (oid_t column_itr = 0; column_itr < column_ids_.size(); column_itr++) {
+    const Value lhs =
+        batch.tile->GetValue(tuple_id, (*batch.column_ids)[column_itr]);
+    const Value rhs =
+        entry_tile->GetValue(entry.tuple_id, column_ids_[column_itr]);
+
+    if (lhs.IsNull() == true || rhs.IsNull() == true) {
+      if (lhs.IsNull() != rhs.IsNull()) {
+        return false;
+      }
+    } else if (lhs.OpEquals(rhs).IsFalse()) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+oid_t HashTable::AddEntry(const Batch &batch, size_t batch_itr,
+                          oid_t tile_itr) {
+  Entry entry;
+  entry.hash = batch.hashes[batch_itr];
+  entry.tile_itr = tile_itr;
+  entry.tuple_id = batch.rows[batch_itr];
+  entries_.push_back(entry);
+
+  if (encode_keys_ == true) {
+    auto key = batch.keys.begin() + batch_itr * key_size_;
+    key_arena_.insert(key_arena_.end(), key, key + key_size_);
+  }
+
+  return entries_.size() - 1;
+}
+
+void HashTable::InsertEntry(Partition &partition, oid_t entry_itr) {
+  if ((partition.entry_count + 1) * 8 > partition.tags.size() * 7) {
+    ResizePartition(partition, (partition.group_mask + 1) * 2);
+  }
+
+  auto hash = entries_[entry_itr].hash;
+  FillSlot(partition,
+           ProbeSlots(partition, hash, [](oid_t) -> bool { return true; }),
+           entry_itr);
+}
+
+void HashTable::FillSlot(Partition &partition, size_t slot_itr,
+                         oid_t entry_itr) {
+  assert(partition.tags[slot_itr] == EMPTY_TAG);
+  partition.tags[slot_itr] = GetTag(entries_[entry_itr].hash);
+  partition.slots[slot_itr] = entry_itr;
+  partition.entry_count++;
+}
+
+/**
+ * @brief Move the entries of a partition to the given number of groups.
+ * The entries keep their hashes, so they are not hashed again.
+ */
+void HashTable::ResizePartition(Partition &partition, size_t group_count) {
+  std::vector<uint8_t> old_tags(group_count * GROUP_SIZE, 0);
+  std::vector<oid_t> old_slots(group_count * GROUP_SIZE, INVALID_OID);
+  old_tags.swap(partition.tags);
+  old_slots.swap(partition.slots);
+  partition.group_mask = group_count - 1;
+  partition.entry_count = 0;
+
+  for (size_t slot_itr = 0; slot_itr < old_tags.size(); slot_itr++) {
+    if (old_tags[slot_itr] == EMPTY_TAG) {
+      continue;
+    }
+
+    auto entry_itr = old_slots[slot_itr];
+    auto hash = entries_[entry_itr].hash;
+    FillSlot(partition,
+             ProbeSlots(partition, hash, [](oid_t) -> bool { return true; }),
+             entry_itr);
+  }
+}
+
+}  // namespace executor
+}  // namespace peloton
@@ -0,0 +1,280 @@
+//===----------------------------------------------------------------------===//
+//
+//                         PelotonDB
+//
+// hash_table.h
+//
+// Identification: src/backend/executor/hash_table.h
+//
+// Copyright (c) 2015, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+#include "backend/common/types.h"
+#include "backend/executor/logical_tile.h"
+
+namespace peloton {
+namespace executor {
+
+/**
+ * @brief Open addressing hash table over the rows of logical tiles, shared
+ * by the hash based executors.
+ *
+ * The slots are probed linearly a group of 16 slots at a time. Every slot
+ * has a one byte tag holding seven bits of the hash of its entry, and the
+ * tags of a group are matched against the probed hash at once. The rows of
+ * a tile are hashed together, before they are inserted or probed. When all
+ * key columns are integers, the keys are encoded into a compact arena while
+ * they are hashed and compared there, otherwise they are compared through
+ * the tiles of the rows. A table larger than the L2 cache is split into
+ * partitions on the high bits of the hash.
+ *
+ * A table of integer keys must be probed with integer keys.
+ */
+class HashTable {
+ public:
+  HashTable(const HashTable &) = delete;
+  HashTable &operator=(const HashTable &) = delete;
+  HashTable(HashTable &&) = delete;
+  HashTable &operator=(HashTable &&) = delete;
+
+  /** @brief Row of a tile in the table */
+  struct Entry {
+    size_t hash;
+
+    // offset of the tile, as given when the row was inserted
+    oid_t tile_itr;
+
+    oid_t tuple_id;
+  };
+
+  /** @brief Hashed keys of the rows of a tile */
+  struct Batch {
+    LogicalTile *tile = nullptr;
+
+    const std::vector<oid_t> *column_ids = nullptr;
+
+    std::vector<oid_t> rows;
+
+    std::vector<size_t> hashes;
+
+    // encoded keys of the rows, when the table keeps its keys in the arena
+    std::vector<char> keys;
+  };
+
+  HashTable(const std::vector<oid_t> &column_ids,
+            const std::vector<ValueType> &column_types);
+
+  /**
+   * @brief Spread the bits of a key hash over the whole word. The partition
+   * is taken from the high bits and the tag from the low bits, but the hash
+   * of a small integer has no high bits set.
+   */
+  static inline size_t MixHash(size_t hash) {
+    hash ^= hash >> 33;
+    hash *= 0xff51afd7ed558ccdULL;
+    hash ^= hash >> 33;
+    hash *= 0xc4ceb9fe1a85ec53ULL;
+    hash ^= hash >> 33;
+    return hash;
+  }
+
+  // Get the types of the given columns of a tile
+  static std::vector<ValueType> GetColumnTypes(
+      LogicalTile *tile, const std::vector<oid_t> &column_ids);
+
+  // Size an empty table for the given number of entries
+  void Reserve(size_t entry_count);
+
+  // Hash the keys of the visible rows of a tile. Rows with a null key are
+  // left out and collected when null_key_rows is given, otherwise null keys
+  // are equal to each other.
+  void HashRows(LogicalTile *tile, const std::vector<oid_t> &column_ids,
+                Batch &batch,
+                std::vector<oid_t> *null_key_rows = nullptr) const;
+
+  // Add all rows of the batch, an entry for every row
+  void Insert(const Batch &batch, oid_t tile_itr);
+
+  // Add all rows of the batches to an empty table, the rows of a batch under
+  // its offset. The entries are added a batch at a time and the slots are
+  // filled a partition at a time, both in parallel.
+  void InsertInParallel(const std::vector<Batch> &batches);
+
+  // Add the rows of the batch whose key is not in the table yet, and get the
+  // entry of the key of every row
+  void FindOrInsert(const Batch &batch, oid_t tile_itr,
+                    std::vector<oid_t> &entry_itrs);
+
+  // Find an entry with the key of a row of the batch, INVALID_OID if none
+  oid_t Find(const Batch &batch, size_t batch_itr) const {
+    oid_t found_entry_itr = INVALID_OID;
+    FindAll(batch, batch_itr, [&found_entry_itr](oid_t entry_itr) -> bool {
+      found_entry_itr = entry_itr;
+      return false;
+    });
+    return found_entry_itr;
+  }
+
+  // Visit the entries with the key of a row of the batch until the visitor
+  // returns false
+  template <typename EntryVisitor>
+  void FindAll(const Batch &batch, size_t batch_itr,
+               EntryVisitor visitor) const {
+    auto hash = batch.hashes[batch_itr];
+    ProbeSlots(partitions_[GetPartition(hash)], hash,
+               [&](oid_t entry_itr) -> bool {
+                 if (entries_[entry_itr].hash != hash ||
+                     KeyEquals(batch, batch_itr, entry_itr) == false) {
+                   return true;
+                 }
+                 return visitor(entry_itr);
+               });
+  }
+
+  // Bring the first slots probed for the hash into the cache
+  inline void Prefetch(size_t hash) const {
+    auto &partition = partitions_[GetPartition(hash)];
+    size_t slot_itr = GetFirstGroup(partition, hash) * GROUP_SIZE;
+    __builtin_prefetch(&partition.tags[slot_itr]);
+    __builtin_prefetch(&partition.slots[slot_itr]);
+  }
+
+  inline size_t GetPartitionCount() const { return partitions_.size(); }
+
+  inline size_t GetPartition(size_t hash) const {
+    return (radix_bits_ == 0) ? 0
+                              : hash >> (sizeof(size_t) * 8 - radix_bits_);
+  }
+
+  inline const Entry &GetEntry(oid_t entry_itr) const {
+    return entries_[entry_itr];
+  }
+
+  inline size_t GetEntryCount() const { return entries_.size(); }
+
+ private:
+  static const size_t GROUP_SIZE = 16;
+
+  static const size_t TAG_BITS = 7;
+
+  // Tag of an empty slot, the tags of used slots have the high bit set
+  static const uint8_t EMPTY_TAG = 0;
+
+  struct Partition {
+    // tag of every slot
+    std::vector<uint8_t> tags;
+
+    // entry of every used slot
+    std::vector<oid_t> slots;
+
+    size_t group_mask = 0;
+
+    size_t entry_count = 0;
+  };
+
+  static inline uint8_t GetTag(size_t hash) {
+    return static_cast<uint8_t>(0x80 | (hash & 0x7f));
+  }
+
+  static inline size_t GetFirstGroup(const Partition &partition,
+                                     size_t hash) {
+    return (hash >> TAG_BITS) & partition.group_mask;
+  }
+
+  /**
+   * @brief Visit the entries of the slots whose tag matches the hash, in
+   * probe order, until the visitor returns false or a group with an empty
+   * slot ends the probe. The table is never full, so every probe ends.
+   * @return the first empty slot, or the capacity of the partition if the
+   * visitor stopped the probe.
+   */
+  template <typename EntryVisitor>
+  size_t ProbeSlots(const Partition &partition, size_t hash,
+                    EntryVisitor visitor) const {
+    uint8_t tag = GetTag(hash);
+    size_t group_itr = GetFirstGroup(partition, hash);
+
+    for (;;) {
+      const uint8_t *group_tags = &partition.tags[group_itr * GROUP_SIZE];
+
+      uint32_t match_mask = 0;
+      uint32_t empty_mask = 0;
+#ifdef __SSE2__
+      __m128i group = _mm_loadu_si128(
+          reinterpret_cast<const __m128i *>(group_tags));
+      match_mask = _mm_movemask_epi8(
+          _mm_cmpeq_epi8(group, _mm_set1_epi8(static_cast<char>(tag))));
+      empty_mask =
+          _mm_movemask_epi8(_mm_cmpeq_epi8(group, _mm_setzero_si128()));
+#else
+      for (size_t slot_itr = 0; slot_itr < GROUP_SIZE; slot_itr++) {
+        match_mask |= (uint32_t)(group_tags[slot_itr] == tag) << slot_itr;
+        empty_mask |= (uint32_t)(group_tags[slot_itr] == EMPTY_TAG)
+                      << slot_itr;
+      }
+#endif
+
+      while (match_mask != 0) {
+        size_t slot_itr = group_itr * GROUP_SIZE + __builtin_ctz(match_mask);
+        if (visitor(partition.slots[slot_itr]) == false) {
+          return partition.tags.size();
+        }
+        match_mask &= match_mask - 1;
+      }
+
+      if (empty_mask != 0) {
+        return group_itr * GROUP_SIZE + __builtin_ctz(empty_mask);
+      }
+
+      group_itr = (group_itr + 1) & partition.group_mask;
+    }
+  }
+
+  bool KeyEquals(const Batch &batch, size_t batch_itr,
+                 oid_t entry_itr) const;
+
+  oid_t AddEntry(const Batch &batch, size_t batch_itr, oid_t tile_itr);
+
+  // Put the entry in the next empty slot of its partition, which grows when
+  // it gets too full
+  void InsertEntry(Partition &partition, oid_t entry_itr);
+
+  // Put the entry in the given empty slot of its partition
+  void FillSlot(Partition &partition, size_t slot_itr, oid_t entry_itr);
+
+  void ResizePartition(Partition &partition, size_t group_count);
+
+  /** @brief Key columns of the rows in the table */
+  std::vector<oid_t> column_ids_;
+
+  /** @brief Keys are encoded into the arena */
+  bool encode_keys_;
+
+  size_t key_size_;
+
+  std::vector<Entry> entries_;
+
+  /** @brief Encoded keys of the entries */
+  std::vector<char> key_arena_;
+
+  /** @brief Tiles of the entries, by tile offset */
+  std::vector<LogicalTile *> tiles_;
+
+  std::vector<Partition> partitions_;
+
+  size_t radix_bits_ = 0;
+};
+
+}  // namespace executor
+}  // namespace peloton
@@ -12,11 +12,14 @@
 
 #include "backend/executor/index_scan_executor.h"
 
+#include <algorithm>
 #include <memory>
+#include <numeric>
 #include <utility>
 #include <vector>
 
 #include "backend/common/types.h"
+#include "backend/catalog/manager.h"
 #include "backend/executor/logical_tile.h"
 #include "backend/executor/logical_tile_factory.h"
 #include "backend/executor/executor_context.h"
@@ -24,12 +27,20 @@
 #include "backend/expression/container_tuple.h"
 #include "backend/index/index.h"
 #include "backend/storage/data_table.h"
+#include "backend/storage/tile.h"
 #include "backend/storage/tile_group.h"
+#include "backend/storage/tile_group_header.h"
+#include "backend/storage/tuple.h"
 #include "backend/common/logger.h"
 
 namespace peloton {
 namespace executor {
 
+// Index entries read by the first lookup, every later lookup reads twice as
+// many up to the maximum
+static const size_t INDEX_SCAN_MIN_BATCH_SIZE = 64;
+static const size_t INDEX_SCAN_MAX_BATCH_SIZE = 4096;
+
 /**
  * @brief Constructor for indexscan executor.
  * @param node Indexscan node corresponding to this executor.
@@ -39,7 +50,10 @@ IndexScanExecutor::IndexScanExecutor(const planner::AbstractPlan *node,
     : AbstractScanExecutor(node, executor_context) {}
 
 IndexScanExecutor::~IndexScanExecutor() {
-  // Nothing to do here
+  // Clean up the tiles that were never returned
+  for (; result_itr < result.size(); result_itr++) {
+    delete result[result_itr];
+  }
 }
 
 /**
@@ -59,7 +73,15 @@ bool IndexScanExecutor::DInit() {
   index_ = node.GetIndex();
   assert(index_ != nullptr);
 
+  // Clean up the tiles of a previous scan that were never returned
+  for (; result_itr < result.size(); result_itr++) {
+    delete result[result_itr];
+  }
+
   result_itr = START_OID;
+  result.clear();
+  cursor_.reset();
+  batch_size_ = INDEX_SCAN_MIN_BATCH_SIZE;
   done_ = false;
 
   column_ids_ = node.GetColumnIds();
@@ -92,48 +114,109 @@ bool IndexScanExecutor::DInit() {
     std::iota(full_column_ids_.begin(), full_column_ids_.end(), 0);
   }
 
+  // Read the projected columns straight from the index entries if they are
+  // all key columns and nothing else is filtered on
+  index_only_ = (predicate_ == nullptr && column_ids_.size() != 0);
+  output_key_column_ids_.clear();
+
+  auto indexed_columns = index_->GetKeySchema()->GetIndexedColumns();
+  for (oid_t column_itr = 0; index_only_ && column_itr < column_ids_.size();
+       column_itr++) {
+    auto indexed_column_itr = std::find(
+        indexed_columns.begin(), indexed_columns.end(), column_ids_[column_itr]);
+    if (indexed_column_itr == indexed_columns.end()) {
+      index_only_ = false;
+    } else {
+      output_key_column_ids_.push_back(
+          std::distance(indexed_columns.begin(), indexed_column_itr));
+    }
+  }
+
+  LOG_TRACE("Index only scan : %d", index_only_);
+
   return true;
 }
 
 /**
  * @brief Creates logical tile(s) after scanning index.
+ * The index is scanned lazily, one batch of locations at a time, so a parent
+ * that stops pulling early never reads the rest of the index range.
  * @return true on success, false otherwise.
  */
 bool IndexScanExecutor::DExecute() {
   LOG_INFO("Index Scan executor :: 0 child");
 
-  if (!done_) {
-    auto status = ExecIndexLookup();
-    if (status == false) return false;
-    ExecPredication();
-    ExecProjection();
-  }
+  while (true) {
+    while (result_itr < result.size()) {  // Avoid returning empty tiles
+      if (result[result_itr]->GetTupleCount() == 0) {
+        delete result[result_itr];
+        result_itr++;
+        continue;
+      } else {
+        SetOutput(result[result_itr]);
+        result_itr++;
+        return true;
+      }
 
-  // Already performed the index lookup
-  assert(done_);
+    }  // end while
 
-  while (result_itr < result.size()) {  // Avoid returning empty tiles
-    if (result[result_itr]->GetTupleCount() == 0) {
-      result_itr++;
-      continue;
-    } else {
-      SetOutput(result[result_itr]);
-      result_itr++;
-      return true;
-    }
+    if (done_) return false;
+
+    // Look up the next batch
+    result.clear();
+    result_itr = START_OID;
 
-  }  // end while
+    if (cursor_ == nullptr) {
+      cursor_ = index_->GetScanCursor(values_, key_column_ids_, expr_types_,
+                                      SCAN_DIRECTION_TYPE_FORWARD);
+      if (cursor_->HasKeys() == false) index_only_ = false;
+    }
 
-  return false;
+    if (index_only_) {
+      auto status = ExecIndexOnlyLookup();
+      if (status == false) return false;
+    } else {
+      auto status = ExecIndexLookup();
+      if (status == false) return false;
+      ExecPredication();
+      ExecProjection();
+    }
+  }
 }
 
 void IndexScanExecutor::ExecPredication() {
-  if (nullptr == predicate_) return;
+  // A tuple updated in place keeps the index entries of its older keys,
+  // so its visible version has to match the scan keys again
+  bool check_keys = (key_column_ids_.size() != 0);
+  if (nullptr == predicate_ && check_keys == false) return;
+
+  auto index_schema = index_->GetKeySchema();
+  auto indexed_columns = index_schema->GetIndexedColumns();
+  storage::Tuple key(index_schema, true);
+  auto pool = executor_context_->GetExecutorContextPool();
+
   unsigned int removed_count = 0;
   for (auto tile : result) {
     for (auto tuple_id : *tile) {
       expression::ContainerTuple<LogicalTile> tuple(tile, tuple_id);
-      if (predicate_->Evaluate(&tuple, nullptr, executor_context_).IsFalse()) {
+
+      if (check_keys) {
+        for (oid_t key_column_itr = 0; key_column_itr < indexed_columns.size();
+             key_column_itr++) {
+          key.SetValue(key_column_itr,
+                       tuple.GetValue(indexed_columns[key_column_itr]), pool);
+        }
+
+        if (index::Index::Compare(key, key_column_ids_, expr_types_,
+                                  values_) == false) {
+          removed_count++;
+          tile->RemoveVisibility(tuple_id);
+          continue;
+        }
+      }
+
+      if (nullptr != predicate_ &&
+          predicate_->Evaluate(&tuple, nullptr, executor_context_).IsFalse()) {
         removed_count++;
         tile->RemoveVisibility(tuple_id);
       }
@@ -142,6 +225,42 @@ void IndexScanExecutor::ExecPredication() {
   LOG_INFO("predicate removed %d row", removed_count);
 }
 
+/**
+ * @brief Checks whether the version of a tuple visible to the transaction has
+ * the key of an index entry.
+ * @param tile_group Tile group of the tuple.
+ * @param tuple_id Slot of the tuple.
+ * @param key_tile Keys of the index entries.
+ * @param key_offset Row of the key of the entry in the key tile.
+ * @return false if the visible version has another key or none is visible.
+ */
+bool IndexScanExecutor::IsVisibleKey(storage::TileGroup *tile_group,
+                                     oid_t tuple_id,
+                                     storage::Tile *key_tile,
+                                     oid_t key_offset) {
+  auto transaction_ = executor_context_->GetTransaction();
+
+  storage::Tuple tuple(table_->GetSchema(), true);
+  if (tile_group->CopyVisibleVersion(tuple_id,
+                                     transaction_->GetTransactionId(),
+                                     transaction_->GetLastCommitId(),
+                                     &tuple) == false) {
+    return false;
+  }
+
+  auto indexed_columns = index_->GetKeySchema()->GetIndexedColumns();
+  for (oid_t key_column_itr = 0; key_column_itr < indexed_columns.size();
+       key_column_itr++) {
+    if (key_tile->GetValue(key_offset, key_column_itr)
+            .Compare(tuple.GetValue(indexed_columns[key_column_itr])) !=
+        VALUE_COMPARE_EQUAL) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
 void IndexScanExecutor::ExecProjection() {
   if (column_ids_.size() == 0) return;
 
@@ -153,28 +272,150 @@ void IndexScanExecutor::ExecProjection() {
 bool IndexScanExecutor::ExecIndexLookup() {
   assert(!done_);
 
+  // The keys tell which entry of a tuple updated in place to follow
+  std::unique_ptr<storage::Tile> key_tile;
+  if (cursor_->HasKeys() == true) {
+    key_tile.reset(storage::TileFactory::GetTempTile(*index_->GetKeySchema(),
+                                                     batch_size_));
+  }
+
   std::vector<ItemPointer> tuple_locations;
+  auto status =
+      (key_tile != nullptr)
+          ? cursor_->GetNextKeyBatch(tuple_locations, batch_size_,
+                                     key_tile.get())
+          : cursor_->GetNextBatch(tuple_locations, batch_size_);
+  if (status == false) {
+    done_ = true;
+    return false;
+  }
 
-  if (0 == key_column_ids_.size()) {
-    tuple_locations = index_->ScanAllKeys();
-  } else {
-    tuple_locations = index_->Scan(values_, key_column_ids_, expr_types_,
-                                   SCAN_DIRECTION_TYPE_FORWARD);
+  // Start small for queries that only need a few rows
+  if (batch_size_ < INDEX_SCAN_MAX_BATCH_SIZE) {
+    batch_size_ *= 2;
   }
 
   LOG_INFO("Tuple_locations.size(): %lu", tuple_locations.size());
 
-  if (tuple_locations.size() == 0) return false;
-
   auto transaction_ = executor_context_->GetTransaction();
   txn_id_t txn_id = transaction_->GetTransactionId();
   cid_t commit_id = transaction_->GetLastCommitId();
 
+  // A tuple updated in place has an entry for each of its keys, maybe in
+  // other batches, only return it from the entry of its visible key
+  if (key_tile != nullptr) {
+    auto &manager = catalog::Manager::GetInstance();
+    std::shared_ptr<storage::TileGroup> tile_group;
+
+    oid_t location_count = 0;
+    for (oid_t location_itr = 0; location_itr < tuple_locations.size();
+         location_itr++) {
+      auto &location = tuple_locations[location_itr];
+      if (tile_group == nullptr ||
+          tile_group->GetTileGroupId() != location.block) {
+        tile_group = manager.GetTileGroup(location.block);
+      }
+
+      if (tile_group->GetHeader()->GetPrevItemPointer(location.offset).block ==
+              INVALID_OID ||
+          IsVisibleKey(tile_group.get(), location.offset, key_tile.get(),
+                       location_itr)) {
+        tuple_locations[location_count++] = location;
+      }
+    }
+    tuple_locations.resize(location_count);
+  }
+
   // Get the logical tiles corresponding to the given tuple locations
   result = LogicalTileFactory::WrapTileGroups(tuple_locations, full_column_ids_,
                                               txn_id, commit_id);
 
-  done_ = true;
+  LOG_TRACE("Result tiles : %lu", result.size());
+
+  return true;
+}
+
+/**
+ * @brief Looks up the next batch of an index only scan.
+ * The keys of the batch are copied into a temporary tile. A tuple that was
+ * never updated in place still holds the key of its index entry, so only its
+ * visibility is checked in the tile group header and its data tiles are never
+ * read. The other tuples may be visible in an older version under another
+ * key, so they are read from the table as usual.
+ * @return false if the cursor is exhausted, true otherwise.
+ */
+bool IndexScanExecutor::ExecIndexOnlyLookup() {
+  assert(!done_);
+
+  std::shared_ptr<storage::Tile> key_tile(storage::TileFactory::GetTempTile(
+      *index_->GetKeySchema(), batch_size_));
+
+  std::vector<ItemPointer> tuple_locations;
+  if (cursor_->GetNextKeyBatch(tuple_locations, batch_size_, key_tile.get()) ==
+      false) {
+    done_ = true;
+    return false;
+  }
+
+  // Start small for queries that only need a few rows
+  if (batch_size_ < INDEX_SCAN_MAX_BATCH_SIZE) {
+    batch_size_ *= 2;
+  }
+
+  LOG_INFO("Tuple_locations.size(): %lu", tuple_locations.size());
+
+  auto transaction_ = executor_context_->GetTransaction();
+  txn_id_t txn_id = transaction_->GetTransactionId();
+  cid_t commit_id = transaction_->GetLastCommitId();
+
+  auto &manager = catalog::Manager::GetInstance();
+  std::shared_ptr<storage::TileGroup> tile_group;
+  storage::TileGroupHeader *tile_group_header = nullptr;
+
+  std::vector<oid_t> position_list;
+  std::vector<ItemPointer> updated_locations;
+  for (oid_t location_itr = 0; location_itr < tuple_locations.size();
+       location_itr++) {
+    auto &location = tuple_locations[location_itr];
+    if (tile_group == nullptr ||
+        tile_group->GetTileGroupId() != location.block) {
+      tile_group = manager.GetTileGroup(location.block);
+      tile_group_header = tile_group->GetHeader();
+    }
+
+    // Check the visibility before the version chain, an update in between
+    // links its delta before it hides the slot
+    bool visible =
+        tile_group_header->IsVisible(location.offset, txn_id, commit_id);
+    if (tile_group_header->GetPrevItemPointer(location.offset).block !=
+        INVALID_OID) {
+      // Only from the entry of its visible key, see ExecIndexLookup
+      if (IsVisibleKey(tile_group.get(), location.offset, key_tile.get(),
+                       location_itr)) {
+        updated_locations.push_back(location);
+      }
+    } else if (visible) {
+      position_list.push_back(location_itr);
+    }
+  }
+
+  if (updated_locations.empty() == false) {
+    result = LogicalTileFactory::WrapTileGroups(
+        updated_locations, full_column_ids_, txn_id, commit_id);
+    ExecPredication();
+    ExecProjection();
+  }
+
+  // Project the key columns of the visible entries
+  LogicalTile *logical_tile = LogicalTileFactory::GetTile();
+  logical_tile->AddPositionList(std::move(position_list));
+
+  const int position_list_idx = 0;
+  for (auto key_column_id : output_key_column_ids_) {
+    logical_tile->AddColumn(key_tile, key_column_id, position_list_idx);
+  }
+
+  result.push_back(logical_tile);
 
   LOG_TRACE("Result tiles : %lu", result.size());
 
@@ -12,9 +12,11 @@
 
 #pragma once
 
+#include <memory>
 #include <vector>
 
 #include "backend/executor/abstract_scan_executor.h"
+#include "backend/index/index.h"
 #include "backend/planner/index_scan_plan.h"
 
 namespace peloton {
@@ -46,6 +48,11 @@ class IndexScanExecutor : public AbstractScanExecutor {
   //===--------------------------------------------------------------------===//
   bool ExecIndexLookup();
 
+  bool ExecIndexOnlyLookup();
+
+  bool IsVisibleKey(storage::TileGroup *tile_group, oid_t tuple_id,
+                    storage::Tile *key_tile, oid_t key_offset);
+
   void ExecProjection();
 
   void ExecPredication();
@@ -54,15 +61,27 @@ class IndexScanExecutor : public AbstractScanExecutor {
   // Executor State
   //===--------------------------------------------------------------------===//
 
-  /** @brief Result of index scan. */
+  /** @brief Result of the current batch of the index scan. */
   std::vector<LogicalTile *> result;
 
   /** @brief Result itr */
   oid_t result_itr = INVALID_OID;
 
-  /** @brief Computed the result */
+  /** @brief Cursor over the index entries, opened by the first lookup */
+  std::unique_ptr<index::IndexScanCursor> cursor_;
+
+  /** @brief Locations fetched by the next lookup, doubled up to a maximum */
+  size_t batch_size_ = 0;
+
+  /** @brief Exhausted the cursor */
   bool done_ = false;
 
+  /** @brief Read the projected columns from the index entries */
+  bool index_only_ = false;
+
+  /** @brief Key columns of the projected columns, for index only scans */
+  std::vector<oid_t> output_key_column_ids_;
+
   //===--------------------------------------------------------------------===//
   // Plan Info
   //===--------------------------------------------------------------------===//
@@ -12,10 +12,13 @@
 
 #include "backend/executor/limit_executor.h"
 
+#include <limits>
+
 #include "backend/planner/limit_plan.h"
 #include "backend/common/logger.h"
 #include "backend/common/types.h"
 #include "backend/executor/logical_tile.h"
+#include "backend/executor/order_by_executor.h"
 
 namespace peloton {
 namespace executor {
@@ -38,6 +41,15 @@ bool LimitExecutor::DInit() {
   num_skipped_ = 0;
   num_returned_ = 0;
 
+  // A sort below only has to find the tuples that are skipped or returned
+  const planner::LimitPlan &node = GetPlanNode<planner::LimitPlan>();
+  auto order_by = dynamic_cast<OrderByExecutor *>(children_[0]);
+  if (order_by != nullptr &&
+      node.GetLimit() <= std::numeric_limits<size_t>::max() -
+                             node.GetOffset()) {
+    order_by->SetLimit(node.GetLimit() + node.GetOffset());
+  }
+
   return true;
 }
 
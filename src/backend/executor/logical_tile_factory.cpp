@@ -13,6 +13,7 @@
 #include "backend/executor/logical_tile_factory.h"
 
 #include <memory>
+#include <unordered_set>
 #include <utility>
 
 #include "backend/common/types.h"
@@ -21,6 +22,7 @@
 #include "backend/storage/tile_group.h"
 #include "backend/storage/data_table.h"
 #include "backend/storage/tile_group_header.h"
+#include "backend/storage/tuple.h"
 
 namespace peloton {
 namespace executor {
@@ -130,33 +132,151 @@ std::vector<LogicalTile *> LogicalTileFactory::WrapTileGroups(
 
   // Construct a logical tile for each block
   for (auto block : blocks) {
-    LogicalTile *logical_tile = LogicalTileFactory::GetTile();
-
     auto &manager = catalog::Manager::GetInstance();
     auto tile_group = manager.GetTileGroup(block.first);
     storage::TileGroupHeader *tile_group_header = tile_group.get()->GetHeader();
 
-    // Add relevant columns to logical tile
-    logical_tile->AddColumns(tile_group, column_ids);
-
     // Print tile group visibility
     // tile_group_header->PrintVisibility(txn_id, commit_id);
 
-    // Add visible tuples to logical tile
+    // Find visible tuples and older versions of tuples being updated in place
     std::vector<oid_t> position_list;
+    std::vector<oid_t> version_tuple_ids;
+    std::vector<uint32_t> slot_versions(tile_group->GetNextTupleSlot());
+    std::unordered_set<oid_t> seen_tuple_ids;
     for (auto tuple_id : block.second) {
+      // A tuple updated in place can be found under several of its keys
+      if (seen_tuple_ids.insert(tuple_id).second == false) continue;
+
+      slot_versions[tuple_id] = tile_group_header->BeginSlotRead(tuple_id);
       if (tile_group_header->IsVisible(tuple_id, txn_id, commit_id)) {
         position_list.push_back(tuple_id);
+      } else if (tile_group_header->GetPrevItemPointer(tuple_id).block !=
+                 INVALID_OID) {
+        version_tuple_ids.push_back(tuple_id);
       }
     }
 
-    logical_tile->AddPositionList(std::move(position_list));
+    // Copy visible tuples, they can be updated in place later
+    result.push_back(WrapTupleCopies(tile_group, position_list, slot_versions,
+                                     column_ids, version_tuple_ids));
+
+    // Copy the visible versions of the rest
+    std::vector<std::unique_ptr<storage::Tuple>> version_tuples;
+    for (auto tuple_id : version_tuple_ids) {
+      auto schema = tile_group->GetAbstractTable()->GetSchema();
+      std::unique_ptr<storage::Tuple> tuple(new storage::Tuple(schema, true));
+      if (tile_group->CopyVisibleVersion(tuple_id, txn_id, commit_id,
+                                         tuple.get())) {
+        version_tuples.push_back(std::move(tuple));
+      }
+    }
 
-    result.push_back(logical_tile);
+    if (version_tuples.empty() == false) {
+      result.push_back(WrapTuples(version_tuples, column_ids));
+    }
   }
 
   return result;
 }
 
+/**
+ * @brief Convenience method to construct a logical tile over copies of the
+ * given tuples, e.g. older versions of tuples updated in place.
+ * The tuples are copied into a temporary tile that doesn't belong to any tile
+ * group, so they can be read but not modified.
+ * @param tuples Tuples with the schema of the table.
+ * @param column_ids Columns of the table to be added to the logical tile.
+ *
+ * @return Logical tile wrapping the tuples.
+ */
+LogicalTile *LogicalTileFactory::WrapTuples(
+    const std::vector<std::unique_ptr<storage::Tuple>> &tuples,
+    const std::vector<oid_t> &column_ids) {
+  assert(tuples.size() > 0);
+
+  auto schema = tuples[0]->GetSchema();
+  std::shared_ptr<storage::Tile> temp_tile(
+      storage::TileFactory::GetTempTile(*schema, tuples.size()));
+
+  for (oid_t tuple_itr = 0; tuple_itr < tuples.size(); tuple_itr++) {
+    temp_tile->InsertTuple(tuple_itr, tuples[tuple_itr].get());
+  }
+
+  std::unique_ptr<LogicalTile> new_tile(new LogicalTile());
+
+  const int position_list_idx = 0;
+  new_tile->AddPositionList(CreateIdentityPositionList(tuples.size()));
+
+  for (auto column_id : column_ids) {
+    new_tile->AddColumn(temp_tile, column_id, position_list_idx);
+  }
+
+  return new_tile.release();
+}
+
+/**
+ * @brief Convenience method to construct a logical tile over copies of the
+ * visible tuples at the given positions of a tile group. Unlike references
+ * to the slots, the copies stay consistent when the tuples are updated in
+ * place later.
+ * The first position list holds the slots the tuples were copied from and
+ * the temporary tile refers to the tile group, so that the tuples can still
+ * be updated or deleted. The columns are read through the second one.
+ * @param tile_group Tile group of the tuples.
+ * @param position_list Slots of the tuples.
+ * @param slot_versions Versions of the slots when the tuples were found
+ *        visible, indexed by slot.
+ * @param column_ids Columns of the table to be copied.
+ * @param changed_tuple_ids Slots a writer has been in meanwhile, not copied.
+ *
+ * @return Logical tile wrapping the copies.
+ */
+LogicalTile *LogicalTileFactory::WrapTupleCopies(
+    const std::shared_ptr<storage::TileGroup> &tile_group,
+    const std::vector<oid_t> &position_list,
+    const std::vector<uint32_t> &slot_versions,
+    const std::vector<oid_t> &column_ids,
+    std::vector<oid_t> &changed_tuple_ids) {
+  std::unique_ptr<LogicalTile> new_tile(new LogicalTile());
+
+  if (position_list.empty()) {
+    new_tile->AddColumns(tile_group, column_ids);
+    new_tile->AddPositionList(std::vector<oid_t>());
+    return new_tile.release();
+  }
+
+  auto schema = tile_group->GetAbstractTable()->GetSchema();
+  std::vector<catalog::Column> columns;
+  for (auto column_id : column_ids) {
+    columns.push_back(schema->GetColumn(column_id));
+  }
+  catalog::Schema temp_schema(columns);
+
+  std::shared_ptr<storage::Tile> temp_tile(storage::TileFactory::GetTempTile(
+      temp_schema, position_list.size(), tile_group.get()));
+
+  std::vector<oid_t> tuple_ids;
+  for (auto tuple_id : position_list) {
+    if (tile_group->CopyTuple(tuple_id, slot_versions[tuple_id], column_ids,
+                              temp_tile.get(), tuple_ids.size())) {
+      tuple_ids.push_back(tuple_id);
+    } else {
+      changed_tuple_ids.push_back(tuple_id);
+    }
+  }
+
+  const int position_list_idx = 1;
+  auto tuple_count = tuple_ids.size();
+  new_tile->AddPositionList(std::move(tuple_ids));
+  new_tile->AddPositionList(CreateIdentityPositionList(tuple_count));
+
+  for (oid_t column_itr = 0; column_itr < column_ids.size(); column_itr++) {
+    new_tile->AddColumn(temp_tile, column_itr, position_list_idx);
+  }
+
+  return new_tile.release();
+}
+
 }  // namespace executor
 }  // namespace peloton
@@ -23,6 +23,7 @@ namespace storage {
 class Tile;
 class TileGroup;
 class AbstractTable;
+class Tuple;
 }
 
 //===--------------------------------------------------------------------===//
@@ -46,6 +47,17 @@ class LogicalTileFactory {
   static std::vector<LogicalTile *> WrapTileGroups(
       const std::vector<ItemPointer> tuple_locations,
       const std::vector<oid_t> column_ids, txn_id_t txn_id, cid_t commit_id);
+
+  static LogicalTile *WrapTuples(
+      const std::vector<std::unique_ptr<storage::Tuple>> &tuples,
+      const std::vector<oid_t> &column_ids);
+
+  static LogicalTile *WrapTupleCopies(
+      const std::shared_ptr<storage::TileGroup> &tile_group,
+      const std::vector<oid_t> &position_list,
+      const std::vector<uint32_t> &slot_versions,
+      const std::vector<oid_t> &column_ids,
+      std::vector<oid_t> &changed_tuple_ids);
 };
 
 }  // namespace executor
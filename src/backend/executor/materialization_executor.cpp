@@ -12,7 +12,9 @@
 
 #include "backend/executor/materialization_executor.h"
 
+#include <algorithm>
 #include <cassert>
+#include <cstring>
 #include <memory>
 #include <utility>
 
@@ -27,19 +29,59 @@
 namespace peloton {
 namespace executor {
 
+namespace {
+
+// Ways of copying the columns of a base tile into the new tile
+enum MaterializationType {
+  // memcpy of the bytes of the columns, whole runs of rows at a time
+  MATERIALIZATION_TYPE_COPY,
+  // one pass over the rows for every column
+  MATERIALIZATION_TYPE_COLUMN,
+  // one pass over the rows for all of the columns
+  MATERIALIZATION_TYPE_ROW
+};
+
+const size_t cache_line_size = 64;
+
+// Tiles up to this size stay in the cache over all of the column passes
+const size_t cache_size = 256 * 1024;
+
+// Estimate the cache lines that a pass over tuple_count of the first
+// span_count rows of a tile touches, reading length bytes of every row
+size_t GetCacheLineCount(size_t tuple_count, size_t span_count,
+                         size_t tuple_length, size_t length) {
+  size_t row_line_count = (length + cache_line_size - 1) / cache_line_size;
+  size_t tile_line_count =
+      (span_count * tuple_length + cache_line_size - 1) / cache_line_size;
+  return std::min(tuple_count * row_line_count, tile_line_count);
+}
+
+// Pick how to copy the columns of a base tile into the new tile
+MaterializationType ChooseMaterialization(
+    LogicalTile *source_tile,
+    const std::unordered_map<oid_t, oid_t> &old_to_new_cols,
+    const std::vector<oid_t> &old_column_ids, storage::Tile *dest_tile,
+    size_t &old_begin, size_t &new_begin, size_t &length);
+
+// Contiguous-run materialization
+void MaterializeByCopy(LogicalTile *source_tile,
+                       const std::vector<oid_t> &old_column_ids,
+                       storage::Tile *dest_tile, size_t old_begin,
+                       size_t new_begin, size_t length);
+
 // Row-oriented materialization
 void MaterializeRowAtAtATime(
     LogicalTile *source_tile,
     const std::unordered_map<oid_t, oid_t> &old_to_new_cols,
-    const std::unordered_map<storage::Tile *, std::vector<oid_t>> &tile_to_cols,
-    storage::Tile *dest_tile);
+    const std::vector<oid_t> &old_column_ids, storage::Tile *dest_tile);
 
 // Column-oriented materialization
 void MaterializeColumnAtATime(
     LogicalTile *source_tile,
     const std::unordered_map<oid_t, oid_t> &old_to_new_cols,
-    const std::unordered_map<storage::Tile *, std::vector<oid_t>> &tile_to_cols,
-    storage::Tile *dest_tile);
+    const std::vector<oid_t> &old_column_ids, storage::Tile *dest_tile);
+
+}  // namespace
 
 /**
  * @brief Constructor for the materialization executor.
@@ -92,206 +134,364 @@ void MaterializationExecutor::GenerateTileToColMap(
  * @param tile_to_cols Map from base tile to columns in that tile
  *        to be materialized.
  * @param dest_tile New tile to copy data into.
+ *
+ * The columns of every base tile are copied in the way that is cheapest for
+ * them, so that the column groups of a hybrid tile group each get their own.
  */
 void MaterializationExecutor::MaterializeByTiles(
     LogicalTile *source_tile,
     const std::unordered_map<oid_t, oid_t> &old_to_new_cols,
     const std::unordered_map<storage::Tile *, std::vector<oid_t>> &tile_to_cols,
     storage::Tile *dest_tile) {
-  bool row_wise_materialization = true;
+  for (const auto &kv : tile_to_cols) {
+    const std::vector<oid_t> &old_column_ids = kv.second;
+
+    size_t old_begin = 0, new_begin = 0, length = 0;
+    auto materialization_type =
+        ChooseMaterialization(source_tile, old_to_new_cols, old_column_ids,
+                              dest_tile, old_begin, new_begin, length);
+
+    switch (materialization_type) {
+      case MATERIALIZATION_TYPE_COPY:
+        MaterializeByCopy(source_tile, old_column_ids, dest_tile, old_begin,
+                          new_begin, length);
+        break;
+      case MATERIALIZATION_TYPE_ROW:
+        MaterializeRowAtAtATime(source_tile, old_to_new_cols, old_column_ids,
+                                dest_tile);
+        break;
+      case MATERIALIZATION_TYPE_COLUMN:
+        MaterializeColumnAtATime(source_tile, old_to_new_cols, old_column_ids,
+                                 dest_tile);
+        break;
+    }
+  }
+}
 
-  if (peloton_layout_mode == LAYOUT_COLUMN) row_wise_materialization = false;
+namespace {
 
-  // TODO: Make this a parameter
-  auto dest_tile_column_count = dest_tile->GetColumnCount();
-  oid_t column_count_threshold = 20;
-  if (peloton_layout_mode == LAYOUT_HYBRID &&
-      dest_tile_column_count <= column_count_threshold)
-    row_wise_materialization = false;
+/**
+ * @brief Picks how to copy the columns of a base tile into the new tile.
+ * @param old_column_ids Columns of the source tile in the base tile.
+ * @param old_begin Set to the first byte of the columns in a base row, for
+ *        MATERIALIZATION_TYPE_COPY.
+ * @param new_begin Set to the first byte of the columns in a new row.
+ * @param length Set to the bytes of the columns.
+ *
+ * Inlined fixed width columns that are next to each other in the same order
+ * in both rows are copied with memcpy. Otherwise, the choice is between one
+ * pass over the rows for every column and a single pass for all of them,
+ * by the cache lines that the passes touch: few rows out of a wide base row
+ * favor the single pass, while narrow columns and tiles that fit in the
+ * cache favor the column passes, which have the tighter loop.
+ */
+MaterializationType ChooseMaterialization(
+    LogicalTile *source_tile,
+    const std::unordered_map<oid_t, oid_t> &old_to_new_cols,
+    const std::vector<oid_t> &old_column_ids, storage::Tile *dest_tile,
+    size_t &old_begin, size_t &new_begin, size_t &length) {
+  assert(old_column_ids.empty() == false);
+
+  auto &first_column_info = source_tile->GetColumnInfo(old_column_ids[0]);
+  storage::Tile *old_tile = first_column_info.base_tile.get();
+  auto old_schema = old_tile->GetSchema();
+  auto new_schema = dest_tile->GetSchema();
+
+  // Bytes that the columns span in both rows
+  old_begin = old_schema->GetLength();
+  new_begin = new_schema->GetLength();
+  size_t old_end = 0, new_end = 0;
+  size_t column_length_sum = 0;
+  bool is_copyable = true;
+
+  size_t tuple_count = source_tile->GetTupleCount();
+  size_t span_count = old_tile->GetAllocatedTupleCount();
+  size_t column_line_count = 0;
+
+  for (oid_t old_col_id : old_column_ids) {
+    auto &column_info = source_tile->GetColumnInfo(old_col_id);
+    oid_t old_column_id = column_info.origin_column_id;
+
+    auto it = old_to_new_cols.find(old_col_id);
+    assert(it != old_to_new_cols.end());
+    oid_t new_column_id = it->second;
+
+    size_t old_offset = old_schema->GetOffset(old_column_id);
+    size_t new_offset = new_schema->GetOffset(new_column_id);
+    size_t column_length = old_schema->GetLength(old_column_id);
+    auto column_type = old_schema->GetType(old_column_id);
+
+    old_begin = std::min(old_begin, old_offset);
+    old_end = std::max(old_end, old_offset + column_length);
+    new_begin = std::min(new_begin, new_offset);
+    new_end = std::max(new_end,
+                       new_offset + new_schema->GetLength(new_column_id));
+    column_length_sum += column_length;
+
+    // The bytes of the column are the value only when inlined and not
+    // variable length
+    if (column_info.position_list_idx != first_column_info.position_list_idx ||
+        old_schema->IsInlined(old_column_id) == false ||
+        new_schema->IsInlined(new_column_id) == false ||
+        column_type == VALUE_TYPE_VARCHAR ||
+        column_type == VALUE_TYPE_VARBINARY ||
+        column_type != new_schema->GetType(new_column_id) ||
+        column_length != new_schema->GetLength(new_column_id)) {
+      is_copyable = false;
+    }
 
-  // Materialize as needed
-  if (row_wise_materialization == true) {
-    MaterializeRowAtAtATime(source_tile, old_to_new_cols, tile_to_cols,
-                            dest_tile);
-  } else {
-    MaterializeColumnAtATime(source_tile, old_to_new_cols, tile_to_cols,
-                             dest_tile);
+    column_line_count += GetCacheLineCount(
+        tuple_count, span_count, old_schema->GetLength(), column_length);
+    column_line_count += GetCacheLineCount(
+        tuple_count, tuple_count, new_schema->GetLength(), column_length);
+  }
+
+  // The columns are at the same distances from each other in both rows
+  if (is_copyable) {
+    for (oid_t old_col_id : old_column_ids) {
+      auto &column_info = source_tile->GetColumnInfo(old_col_id);
+      size_t old_offset =
+          old_schema->GetOffset(column_info.origin_column_id);
+      size_t new_offset =
+          new_schema->GetOffset(old_to_new_cols.find(old_col_id)->second);
+      if (old_offset - old_begin != new_offset - new_begin) {
+        is_copyable = false;
+        break;
+      }
+    }
+  }
+
+  // No gaps between the columns
+  length = old_end - old_begin;
+  if (is_copyable && column_length_sum == length) {
+    return MATERIALIZATION_TYPE_COPY;
+  }
+
+  if (span_count * old_schema->GetLength() +
+          tuple_count * new_schema->GetLength() <=
+      cache_size) {
+    return MATERIALIZATION_TYPE_COLUMN;
+  }
+
+  size_t row_line_count =
+      GetCacheLineCount(tuple_count, span_count, old_schema->GetLength(),
+                        old_end - old_begin) +
+      GetCacheLineCount(tuple_count, tuple_count, new_schema->GetLength(),
+                        new_end - new_begin);
+
+  return (row_line_count < column_line_count) ? MATERIALIZATION_TYPE_ROW
+                                              : MATERIALIZATION_TYPE_COLUMN;
+}
+
+/**
+ * @brief Copies the bytes of the columns of every row with memcpy. Whole
+ *        rows that follow each other in the base tile are copied with a
+ *        single memcpy.
+ */
+void MaterializeByCopy(LogicalTile *source_tile,
+                       const std::vector<oid_t> &old_column_ids,
+                       storage::Tile *dest_tile, size_t old_begin,
+                       size_t new_begin, size_t length) {
+  auto &column_info = source_tile->GetColumnInfo(old_column_ids[0]);
+  storage::Tile *old_tile = column_info.base_tile.get();
+  auto &column_position_list =
+      source_tile->GetPositionList(column_info.position_list_idx);
+
+  const size_t tuple_length = dest_tile->GetSchema()->GetLength();
+  const bool is_whole_row =
+      (length == tuple_length && length == old_tile->GetSchema()->GetLength());
+
+  // Run of rows to copy
+  oid_t run_base_tuple_id = INVALID_OID;
+  oid_t run_new_tuple_id = 0;
+  size_t run_tuple_count = 0;
+
+  oid_t new_tuple_id = 0;
+  for (oid_t old_tuple_id : *source_tile) {
+    oid_t base_tuple_id = column_position_list[old_tuple_id];
+
+    if (run_tuple_count == 0 || is_whole_row == false ||
+        base_tuple_id != run_base_tuple_id + run_tuple_count) {
+      if (run_tuple_count > 0) {
+        ::memcpy(dest_tile->GetTupleLocation(run_new_tuple_id) + new_begin,
+                 old_tile->GetTupleLocation(run_base_tuple_id) + old_begin,
+                 (run_tuple_count - 1) * tuple_length + length);
+      }
+
+      run_base_tuple_id = base_tuple_id;
+      run_new_tuple_id = new_tuple_id;
+      run_tuple_count = 0;
+    }
+
+    run_tuple_count++;
+    new_tuple_id++;
+  }
+
+  if (run_tuple_count > 0) {
+    ::memcpy(dest_tile->GetTupleLocation(run_new_tuple_id) + new_begin,
+             old_tile->GetTupleLocation(run_base_tuple_id) + old_begin,
+             (run_tuple_count - 1) * tuple_length + length);
   }
 }
 
 void MaterializeRowAtAtATime(
     LogicalTile *source_tile,
     const std::unordered_map<oid_t, oid_t> &old_to_new_cols,
-    const std::unordered_map<storage::Tile *, std::vector<oid_t>> &tile_to_cols,
-    storage::Tile *dest_tile) {
-  ///////////////////////////
-  // EACH PHYSICAL TILE
-  ///////////////////////////
-  // Copy over all data from each base tile.
-  for (const auto &kv : tile_to_cols) {
-    const std::vector<oid_t> &old_column_ids = kv.second;
+    const std::vector<oid_t> &old_column_ids, storage::Tile *dest_tile) {
+  auto &schema = source_tile->GetSchema();
+  oid_t new_tuple_id = 0;
 
-    auto &schema = source_tile->GetSchema();
-    oid_t new_tuple_id = 0;
+  auto &column_position_lists = source_tile->GetPositionLists();
 
-    auto &column_position_lists = source_tile->GetPositionLists();
+  // Get old column information
+  std::vector<oid_t> old_column_position_idxs;
+  std::vector<size_t> old_column_offsets;
+  std::vector<ValueType> old_column_types;
+  std::vector<bool> old_is_inlineds;
+  std::vector<storage::Tile *> old_tiles;
+
+  // Get new column information
+  std::vector<size_t> new_column_offsets;
+  std::vector<bool> new_is_inlineds;
+  std::vector<size_t> new_column_lengths;
+
+  // Amortize schema lookups once per column
+  for (oid_t old_col_id : old_column_ids) {
+    auto &column_info = schema[old_col_id];
+
+    // Get the position list
+    old_column_position_idxs.push_back(column_info.position_list_idx);
 
     // Get old column information
-    std::vector<oid_t> old_column_position_idxs;
-    std::vector<size_t> old_column_offsets;
-    std::vector<ValueType> old_column_types;
-    std::vector<bool> old_is_inlineds;
-    std::vector<storage::Tile *> old_tiles;
+    storage::Tile *old_tile = column_info.base_tile.get();
+    old_tiles.push_back(old_tile);
+    auto old_schema = old_tile->GetSchema();
+    oid_t old_column_id = column_info.origin_column_id;
+    const size_t old_column_offset = old_schema->GetOffset(old_column_id);
+    old_column_offsets.push_back(old_column_offset);
+    const ValueType old_column_type = old_schema->GetType(old_column_id);
+    old_column_types.push_back(old_column_type);
+    const bool old_is_inlined = old_schema->IsInlined(old_column_id);
+    old_is_inlineds.push_back(old_is_inlined);
+
+    // Old to new column mapping
+    auto it = old_to_new_cols.find(old_col_id);
+    assert(it != old_to_new_cols.end());
 
     // Get new column information
-    std::vector<size_t> new_column_offsets;
-    std::vector<bool> new_is_inlineds;
-    std::vector<size_t> new_column_lengths;
-
-    // Amortize schema lookups once per column
-    for (oid_t old_col_id : old_column_ids) {
-      auto &column_info = schema[old_col_id];
-
-      // Get the position list
-      old_column_position_idxs.push_back(column_info.position_list_idx);
-
-      // Get old column information
-      storage::Tile *old_tile = column_info.base_tile.get();
-      old_tiles.push_back(old_tile);
-      auto old_schema = old_tile->GetSchema();
-      oid_t old_column_id = column_info.origin_column_id;
-      const size_t old_column_offset = old_schema->GetOffset(old_column_id);
-      old_column_offsets.push_back(old_column_offset);
-      const ValueType old_column_type = old_schema->GetType(old_column_id);
-      old_column_types.push_back(old_column_type);
-      const bool old_is_inlined = old_schema->IsInlined(old_column_id);
-      old_is_inlineds.push_back(old_is_inlined);
-
-      // Old to new column mapping
-      auto it = old_to_new_cols.find(old_col_id);
-      assert(it != old_to_new_cols.end());
-
-      // Get new column information
-      oid_t new_column_id = it->second;
-      auto new_schema = dest_tile->GetSchema();
-      const size_t new_column_offset = new_schema->GetOffset(new_column_id);
-      new_column_offsets.push_back(new_column_offset);
-      const bool new_is_inlined = new_schema->IsInlined(new_column_id);
-      new_is_inlineds.push_back(new_is_inlined);
-      const size_t new_column_length =
-          new_schema->GetAppropriateLength(new_column_id);
-      new_column_lengths.push_back(new_column_length);
-    }
+    oid_t new_column_id = it->second;
+    auto new_schema = dest_tile->GetSchema();
+    const size_t new_column_offset = new_schema->GetOffset(new_column_id);
+    new_column_offsets.push_back(new_column_offset);
+    const bool new_is_inlined = new_schema->IsInlined(new_column_id);
+    new_is_inlineds.push_back(new_is_inlined);
+    const size_t new_column_length =
+        new_schema->GetAppropriateLength(new_column_id);
+    new_column_lengths.push_back(new_column_length);
+  }
 
-    assert(new_column_offsets.size() == old_column_ids.size());
+  assert(new_column_offsets.size() == old_column_ids.size());
 
+  ///////////////////////////
+  // EACH TUPLE
+  ///////////////////////////
+  // Copy all values in the tuple to the physical tile
+  // This uses fast getter and setter functions
+  for (oid_t old_tuple_id : *source_tile) {
     ///////////////////////////
-    // EACH TUPLE
+    // EACH COLUMN
     ///////////////////////////
-    // Copy all values in the tuple to the physical tile
-    // This uses fast getter and setter functions
-    for (oid_t old_tuple_id : *source_tile) {
-      ///////////////////////////
-      // EACH COLUMN
-      ///////////////////////////
-      // Go over each column in given base physical tile
-      oid_t col_itr = 0;
-
-      for (oid_t old_col_id : old_column_position_idxs) {
-        auto &column_position_list = column_position_lists[old_col_id];
+    // Go over each column in given base physical tile
+    oid_t col_itr = 0;
 
-        oid_t base_tuple_id = column_position_list[old_tuple_id];
+    for (oid_t old_col_id : old_column_position_idxs) {
+      auto &column_position_list = column_position_lists[old_col_id];
 
-        auto value = old_tiles[col_itr]->GetValueFast(
-            base_tuple_id, old_column_offsets[col_itr],
-            old_column_types[col_itr], old_is_inlineds[col_itr]);
+      oid_t base_tuple_id = column_position_list[old_tuple_id];
 
-        LOG_TRACE("Old Tuple : %lu Column : %lu ", old_tuple_id, old_col_id);
-        LOG_TRACE("New Tuple : %lu Column : %lu ", new_tuple_id, new_column_offsets[col_itr]);
+      auto value = old_tiles[col_itr]->GetValueFast(
+          base_tuple_id, old_column_offsets[col_itr],
+          old_column_types[col_itr], old_is_inlineds[col_itr]);
 
-        dest_tile->SetValueFast(
-            value, new_tuple_id, new_column_offsets[col_itr],
-            new_is_inlineds[col_itr], new_column_lengths[col_itr]);
+      LOG_TRACE("Old Tuple : %lu Column : %lu ", old_tuple_id, old_col_id);
+      LOG_TRACE("New Tuple : %lu Column : %lu ", new_tuple_id,
+                new_column_offsets[col_itr]);
 
-        // Go to next column
-        col_itr++;
-      }
+      dest_tile->SetValueFast(
+          value, new_tuple_id, new_column_offsets[col_itr],
+          new_is_inlineds[col_itr], new_column_lengths[col_itr]);
 
-      // Go to next tuple
-      new_tuple_id++;
+      // Go to next column
+      col_itr++;
     }
+
+    // Go to next tuple
+    new_tuple_id++;
   }
 }
 
 void MaterializeColumnAtATime(
     LogicalTile *source_tile,
     const std::unordered_map<oid_t, oid_t> &old_to_new_cols,
-    const std::unordered_map<storage::Tile *, std::vector<oid_t>> &tile_to_cols,
-    storage::Tile *dest_tile) {
+    const std::vector<oid_t> &old_column_ids, storage::Tile *dest_tile) {
   ///////////////////////////
-  // EACH PHYSICAL TILE
+  // EACH COLUMN
   ///////////////////////////
-  // Copy over all data from each base tile.
-  for (const auto &kv : tile_to_cols) {
-    const std::vector<oid_t> &old_column_ids = kv.second;
+  // Go over each column in given base physical tile
+  for (oid_t old_col_id : old_column_ids) {
+    auto &column_info = source_tile->GetColumnInfo(old_col_id);
+
+    // Amortize schema lookups once per column
+    storage::Tile *old_tile = column_info.base_tile.get();
+    auto old_schema = old_tile->GetSchema();
 
+    // Get old column information
+    oid_t old_column_id = column_info.origin_column_id;
+    const size_t old_column_offset = old_schema->GetOffset(old_column_id);
+    const ValueType old_column_type = old_schema->GetType(old_column_id);
+    const bool old_is_inlined = old_schema->IsInlined(old_column_id);
+
+    // Old to new column mapping
+    auto it = old_to_new_cols.find(old_col_id);
+    assert(it != old_to_new_cols.end());
+
+    // Get new column information
+    oid_t new_column_id = it->second;
+    auto new_schema = dest_tile->GetSchema();
+    const size_t new_column_offset = new_schema->GetOffset(new_column_id);
+    const bool new_is_inlined = new_schema->IsInlined(new_column_id);
+    const size_t new_column_length =
+        new_schema->GetAppropriateLength(new_column_id);
+
+    // Get the position list
+    auto &column_position_list =
+        source_tile->GetPositionList(column_info.position_list_idx);
+    oid_t new_tuple_id = 0;
+
+    // Copy all values in the column to the physical tile
+    // This uses fast getter and setter functions
     ///////////////////////////
-    // EACH COLUMN
+    // EACH TUPLE
     ///////////////////////////
-    // Go over each column in given base physical tile
-    for (oid_t old_col_id : old_column_ids) {
-      auto &column_info = source_tile->GetColumnInfo(old_col_id);
+    for (oid_t old_tuple_id : *source_tile) {
+      oid_t base_tuple_id = column_position_list[old_tuple_id];
+      auto value = old_tile->GetValueFast(base_tuple_id, old_column_offset,
+                                          old_column_type, old_is_inlined);
 
-      // Amortize schema lookups once per column
-      storage::Tile *old_tile = column_info.base_tile.get();
-      auto old_schema = old_tile->GetSchema();
-
-      // Get old column information
-      oid_t old_column_id = column_info.origin_column_id;
-      const size_t old_column_offset = old_schema->GetOffset(old_column_id);
-      const ValueType old_column_type = old_schema->GetType(old_column_id);
-      const bool old_is_inlined = old_schema->IsInlined(old_column_id);
-
-      // Old to new column mapping
-      auto it = old_to_new_cols.find(old_col_id);
-      assert(it != old_to_new_cols.end());
-
-      // Get new column information
-      oid_t new_column_id = it->second;
-      auto new_schema = dest_tile->GetSchema();
-      const size_t new_column_offset = new_schema->GetOffset(new_column_id);
-      const bool new_is_inlined = new_schema->IsInlined(new_column_id);
-      const size_t new_column_length =
-          new_schema->GetAppropriateLength(new_column_id);
-
-      // Get the position list
-      auto &column_position_list =
-          source_tile->GetPositionList(column_info.position_list_idx);
-      oid_t new_tuple_id = 0;
-
-      // Copy all values in the column to the physical tile
-      // This uses fast getter and setter functions
-      ///////////////////////////
-      // EACH TUPLE
-      ///////////////////////////
-      for (oid_t old_tuple_id : *source_tile) {
-        oid_t base_tuple_id = column_position_list[old_tuple_id];
-        auto value = old_tile->GetValueFast(base_tuple_id, old_column_offset,
-                                            old_column_type, old_is_inlined);
-
-        LOG_TRACE("Old Tuple : %lu Column : %lu ", old_tuple_id, old_col_id);
-        LOG_TRACE("New Tuple : %lu Column : %lu ", new_tuple_id, new_column_id);
-
-        dest_tile->SetValueFast(value, new_tuple_id, new_column_offset,
-                                new_is_inlined, new_column_length);
-
-        // Go to next tuple
-        new_tuple_id++;
-      }
+      LOG_TRACE("Old Tuple : %lu Column : %lu ", old_tuple_id, old_col_id);
+      LOG_TRACE("New Tuple : %lu Column : %lu ", new_tuple_id, new_column_id);
+
+      dest_tile->SetValueFast(value, new_tuple_id, new_column_offset,
+                              new_is_inlined, new_column_length);
+
+      // Go to next tuple
+      new_tuple_id++;
     }
   }
 }
 
+}  // namespace
+
 std::unordered_map<oid_t, oid_t> MaterializationExecutor::BuildIdentityMapping(
     const catalog::Schema *schema) {
   std::unordered_map<oid_t, oid_t> old_to_new_cols;
@@ -303,10 +503,58 @@ std::unordered_map<oid_t, oid_t> MaterializationExecutor::BuildIdentityMapping(
   return old_to_new_cols;
 }
 
+/**
+ * @brief Checks whether a logical tile wraps all the rows of a single
+ *        temporary tile, in the layout of the output.
+ *
+ * Temporary tiles are the outputs of other executors, they do not belong to
+ * a table and nothing else changes them, so they can be passed on.
+ */
+bool MaterializationExecutor::IsPhysicalTile(
+    LogicalTile *source_tile, const catalog::Schema *output_schema,
+    const std::unordered_map<oid_t, oid_t> &old_to_new_cols) {
+  if (source_tile->GetColumnCount() == 0 ||
+      old_to_new_cols.size() != source_tile->GetColumnCount() ||
+      old_to_new_cols.size() != output_schema->GetColumnCount()) {
+    return false;
+  }
+
+  auto &first_column_info = source_tile->GetColumnInfo(0);
+  storage::Tile *base_tile = first_column_info.base_tile.get();
+  auto base_schema = base_tile->GetSchema();
+  if (base_tile->GetHeader() != nullptr || *base_schema != *output_schema ||
+      base_schema->GetLength() != output_schema->GetLength()) {
+    return false;
+  }
+
+  for (const auto &kv : old_to_new_cols) {
+    auto &column_info = source_tile->GetColumnInfo(kv.first);
+    if (column_info.base_tile.get() != base_tile ||
+        column_info.origin_column_id != kv.second ||
+        column_info.position_list_idx != first_column_info.position_list_idx) {
+      return false;
+    }
+  }
+
+  // Every row once, in order
+  auto &position_list =
+      source_tile->GetPositionList(first_column_info.position_list_idx);
+  if (position_list.size() != base_tile->GetAllocatedTupleCount() ||
+      source_tile->GetTupleCount() != position_list.size()) {
+    return false;
+  }
+  for (oid_t tuple_id = 0; tuple_id < position_list.size(); tuple_id++) {
+    if (position_list[tuple_id] != tuple_id) return false;
+  }
+
+  return true;
+}
+
 /**
  * @brief Create a physical tile for the given logical tile
  * @param source_tile Source tile from which the physical tile is created
- * @return a logical tile wrapper for the created physical tile
+ * @return a logical tile wrapper for the created physical tile, or the source
+ *         tile itself when it already is one
  */
 LogicalTile *MaterializationExecutor::Physify(LogicalTile *source_tile) {
   std::unique_ptr<catalog::Schema> source_tile_schema(
@@ -336,6 +584,12 @@ LogicalTile *MaterializationExecutor::Physify(LogicalTile *source_tile) {
     }
   }
 
+  // Nothing to copy when the source tile already is a physical tile of
+  // the output.
+  if (IsPhysicalTile(source_tile, output_schema, old_to_new_cols)) {
+    return source_tile;
+  }
+
   // Generate mappings.
   std::unordered_map<storage::Tile *, std::vector<oid_t>> tile_to_cols;
   GenerateTileToColMap(old_to_new_cols, source_tile, tile_to_cols);
@@ -387,6 +641,7 @@ bool MaterializationExecutor::DExecute() {
   if (physify_flag) {
     /* create a physical tile and a logical tile wrapper to be the output */
     output_tile = Physify(source_tile.get());
+    if (output_tile == source_tile.get()) source_tile.release();
   } else {
     /* just pass thru the underlying logical tile */
     output_tile = source_tile.release();
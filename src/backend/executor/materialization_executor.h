@@ -61,6 +61,10 @@ class MaterializationExecutor : public AbstractExecutor {
           tile_to_cols,
       storage::Tile *dest_tile);
 
+  bool IsPhysicalTile(LogicalTile *source_tile,
+                      const catalog::Schema *output_schema,
+                      const std::unordered_map<oid_t, oid_t> &old_to_new_cols);
+
   LogicalTile *Physify(LogicalTile *source_tile);
   std::unordered_map<oid_t, oid_t> BuildIdentityMapping(
       const catalog::Schema *schema);
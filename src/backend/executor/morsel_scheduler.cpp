@@ -0,0 +1,38 @@
+//===----------------------------------------------------------------------===//
+//
+//                         PelotonDB
+//
+// morsel_scheduler.cpp
+//
+// Identification: src/backend/executor/morsel_scheduler.cpp
+//
+// Copyright (c) 2015, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "backend/executor/morsel_scheduler.h"
+
+namespace peloton {
+namespace executor {
+
+std::atomic<oid_t> &MorselScheduler::GetTileGroupCursor(
+    const planner::AbstractPlan *scan) {
+  std::lock_guard<std::mutex> lock(cursors_mutex_);
+
+  auto &cursor = tile_group_cursors_[scan];
+  if (cursor == nullptr) {
+    cursor.reset(new std::atomic<oid_t>(START_OID));
+  }
+  return *cursor;
+}
+
+void MorselScheduler::Reset() {
+  std::lock_guard<std::mutex> lock(cursors_mutex_);
+
+  for (auto &entry : tile_group_cursors_) {
+    entry.second->store(START_OID);
+  }
+}
+
+}  // namespace executor
+}  // namespace peloton
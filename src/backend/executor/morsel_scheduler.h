@@ -0,0 +1,63 @@
+//===----------------------------------------------------------------------===//
+//
+//                         PelotonDB
+//
+// morsel_scheduler.h
+//
+// Identification: src/backend/executor/morsel_scheduler.h
+//
+// Copyright (c) 2015, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <atomic>
+#include <map>
+#include <memory>
+#include <mutex>
+
+#include "backend/common/types.h"
+
+namespace peloton {
+
+namespace planner {
+class AbstractPlan;
+}
+
+namespace executor {
+
+/**
+ * @brief Hands out the tile groups of the tables scanned by a parallel
+ * pipeline to its workers.
+ *
+ * A tile group is the unit of work (the morsel). Every scan of the pipeline
+ * has a cursor shared by the copies of the scan in all workers, and a worker
+ * takes the next tile group of a cursor once it is done with the last one,
+ * so the faster workers end up scanning more of the table.
+ */
+class MorselScheduler {
+ public:
+  MorselScheduler(const MorselScheduler &) = delete;
+  MorselScheduler &operator=(const MorselScheduler &) = delete;
+  MorselScheduler(MorselScheduler &&) = delete;
+  MorselScheduler &operator=(MorselScheduler &&) = delete;
+
+  MorselScheduler() {}
+
+  // Get the cursor over the tile groups read by the scan plan
+  std::atomic<oid_t> &GetTileGroupCursor(const planner::AbstractPlan *scan);
+
+  // Start all cursors at the first tile group again
+  void Reset();
+
+ private:
+  std::mutex cursors_mutex_;
+
+  /** @brief Next tile group to scan, by scan plan */
+  std::map<const planner::AbstractPlan *, std::unique_ptr<std::atomic<oid_t>>>
+      tile_group_cursors_;
+};
+
+}  // namespace executor
+}  // namespace peloton
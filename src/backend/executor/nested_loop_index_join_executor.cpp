@@ -0,0 +1,301 @@
+//===----------------------------------------------------------------------===//
+//
+//                         PelotonDB
+//
+// nested_loop_index_join_executor.cpp
+//
+// Identification: src/backend/executor/nested_loop_index_join_executor.cpp
+//
+// Copyright (c) 2015, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "backend/executor/nested_loop_index_join_executor.h"
+
+#include <algorithm>
+#include <memory>
+#include <numeric>
+#include <utility>
+#include <vector>
+
+#include "backend/common/types.h"
+#include "backend/common/logger.h"
+#include "backend/concurrency/transaction.h"
+#include "backend/executor/executor_context.h"
+#include "backend/executor/logical_tile.h"
+#include "backend/executor/logical_tile_factory.h"
+#include "backend/expression/abstract_expression.h"
+#include "backend/expression/container_tuple.h"
+#include "backend/index/index.h"
+#include "backend/storage/data_table.h"
+#include "backend/storage/tuple.h"
+
+namespace peloton {
+namespace executor {
+
+// Outer rows looked up in the index together
+static const size_t NESTED_LOOP_INDEX_JOIN_BATCH_SIZE = 1024;
+
+/**
+ * @brief Constructor for nested loop index join executor.
+ * @param node Nested loop index join node corresponding to this executor.
+ */
+NestedLoopIndexJoinExecutor::NestedLoopIndexJoinExecutor(
+    const planner::AbstractPlan *node, ExecutorContext *executor_context)
+    : AbstractJoinExecutor(node, executor_context) {}
+
+NestedLoopIndexJoinExecutor::~NestedLoopIndexJoinExecutor() {
+  // Clean up the tiles that were never returned
+  for (auto output_tile : buffered_output_tiles) {
+    delete output_tile;
+  }
+}
+
+/**
+ * @brief Do some basic checks and grab the inner table and index.
+ * The inner table is read through its index, so there is only the outer
+ * child.
+ * @return true on success, false otherwise.
+ */
+bool NestedLoopIndexJoinExecutor::DInit() {
+  assert(children_.size() == 1);
+
+  const planner::NestedLoopIndexJoinPlan &node =
+      GetPlanNode<planner::NestedLoopIndexJoinPlan>();
+
+  predicate_ = node.GetPredicate();
+  proj_info_ = node.GetProjInfo();
+  join_type_ = node.GetJoinType();
+
+  // Inner rows without a match are never looked up
+  if (join_type_ != JOIN_TYPE_INNER && join_type_ != JOIN_TYPE_LEFT) {
+    LOG_ERROR("Unsupported join type for nested loop index join : %s",
+              GetJoinTypeString());
+    return false;
+  }
+
+  inner_table_ = node.GetInnerTable();
+  inner_index_ = node.GetInnerIndex();
+  outer_key_column_ids_ = node.GetOuterKeyColumnIds();
+  inner_column_ids_ = node.GetInnerColumnIds();
+
+  assert(inner_table_ != nullptr);
+  assert(inner_index_ != nullptr);
+  assert(outer_key_column_ids_.size() ==
+         inner_index_->GetKeySchema()->GetColumnCount());
+
+  full_column_ids_.resize(inner_table_->GetSchema()->GetColumnCount());
+  std::iota(full_column_ids_.begin(), full_column_ids_.end(), 0);
+
+  for (auto output_tile : buffered_output_tiles) {
+    delete output_tile;
+  }
+  buffered_output_tiles.clear();
+  outer_tile_.reset();
+  outer_rows_.clear();
+  outer_row_itr_ = 0;
+
+  return true;
+}
+
+/**
+ * @brief Creates logical tiles from the outer tiles and the inner rows found
+ * in the index.
+ * @return true on success, false otherwise.
+ */
+bool NestedLoopIndexJoinExecutor::DExecute() {
+  LOG_INFO("********** Nested Loop Index %s Join executor :: 1 child ",
+           GetJoinTypeString());
+
+  // Loop until we have non-empty result tile or exit
+  for (;;) {
+    if (buffered_output_tiles.empty() == false) {
+      SetOutput(buffered_output_tiles.front());
+      buffered_output_tiles.pop_front();
+      return true;
+    }
+
+    // Pick the next outer tile once the rows of this one are joined
+    if (outer_row_itr_ == outer_rows_.size()) {
+      if (children_[0]->Execute() == false) {
+        LOG_TRACE("Outer child is exhausted.");
+        return false;
+      }
+
+      outer_tile_.reset(children_[0]->GetOutput());
+      outer_rows_.assign(outer_tile_->begin(), outer_tile_->end());
+      outer_row_itr_ = 0;
+      continue;
+    }
+
+    JoinOuterBatch();
+  }
+}
+
+/**
+ * @brief Looks up the keys of a batch of outer rows in the index at once.
+ * The inner tuples found are wrapped per tile group, and every visible inner
+ * row is paired with the outer rows of its key. A tuple updated in place
+ * keeps the index entries of its older keys, so its visible version is
+ * matched by key again rather than by the entry it was found under.
+ */
+void NestedLoopIndexJoinExecutor::JoinOuterBatch() {
+  size_t batch_end = outer_rows_.size();
+  if (batch_end - outer_row_itr_ > NESTED_LOOP_INDEX_JOIN_BATCH_SIZE) {
+    batch_end = outer_row_itr_ + NESTED_LOOP_INDEX_JOIN_BATCH_SIZE;
+  }
+
+  auto key_schema = inner_index_->GetKeySchema();
+  auto indexed_columns = key_schema->GetIndexedColumns();
+  auto pool = executor_context_->GetExecutorContextPool();
+
+  //===--------------------------------------------------------------------===//
+  // Look up the outer keys
+  //===--------------------------------------------------------------------===//
+
+  // A null key matches no inner row
+  std::vector<std::unique_ptr<storage::Tuple>> keys;
+  std::vector<const storage::Tuple *> probe_keys;
+  std::vector<oid_t> probe_rows;
+  for (size_t row_itr = outer_row_itr_; row_itr < batch_end; row_itr++) {
+    std::unique_ptr<storage::Tuple> key(new storage::Tuple(key_schema, true));
+    bool has_null = false;
+    for (oid_t key_column_itr = 0; key_column_itr < outer_key_column_ids_.size();
+         key_column_itr++) {
+      auto value = outer_tile_->GetValue(outer_rows_[row_itr],
+                                         outer_key_column_ids_[key_column_itr]);
+      has_null = has_null || value.IsNull();
+      key->SetValue(key_column_itr, value, pool);
+    }
+    if (has_null == true) continue;
+
+    probe_keys.push_back(key.get());
+    probe_rows.push_back(outer_rows_[row_itr]);
+    keys.push_back(std::move(key));
+  }
+
+  std::vector<std::vector<ItemPointer>> probe_locations;
+  inner_index_->MultiScanKey(probe_keys, probe_locations);
+
+  std::vector<ItemPointer> inner_locations;
+  for (auto &locations : probe_locations) {
+    inner_locations.insert(inner_locations.end(), locations.begin(),
+                           locations.end());
+  }
+
+  auto transaction = executor_context_->GetTransaction();
+  std::vector<std::unique_ptr<LogicalTile>> inner_tiles;
+  for (auto inner_tile : LogicalTileFactory::WrapTileGroups(
+           inner_locations, full_column_ids_,
+           transaction->GetTransactionId(), transaction->GetLastCommitId())) {
+    inner_tiles.emplace_back(inner_tile);
+  }
+
+  //===--------------------------------------------------------------------===//
+  // Pair the inner rows with the outer rows of their keys
+  //===--------------------------------------------------------------------===//
+
+  std::vector<oid_t> probe_order(probe_keys.size());
+  std::iota(probe_order.begin(), probe_order.end(), 0);
+  std::sort(probe_order.begin(), probe_order.end(),
+            [&probe_keys](const oid_t &lhs, const oid_t &rhs) -> bool {
+    return probe_keys[lhs]->Compare(*probe_keys[rhs]) < 0;
+  });
+
+  std::vector<bool> outer_row_matched(probe_keys.size(), false);
+  storage::Tuple inner_key(key_schema, true);
+
+  for (auto &inner_tile : inner_tiles) {
+    std::vector<std::pair<oid_t, oid_t>> pairs;
+
+    for (auto inner_row : *inner_tile) {
+      for (oid_t key_column_itr = 0; key_column_itr < indexed_columns.size();
+           key_column_itr++) {
+        inner_key.SetValue(
+            key_column_itr,
+            inner_tile->GetValue(inner_row, indexed_columns[key_column_itr]),
+            pool);
+      }
+
+      auto probe = std::lower_bound(
+          probe_order.begin(), probe_order.end(), inner_key,
+          [&probe_keys](const oid_t &probe, const storage::Tuple &key)
+              -> bool { return probe_keys[probe]->Compare(key) < 0; });
+      for (; probe != probe_order.end(); probe++) {
+        if (probe_keys[*probe]->Compare(inner_key) != 0) break;
+        pairs.emplace_back(*probe, inner_row);
+      }
+    }
+
+    if (pairs.empty()) continue;
+
+    // The join predicate refers to the inner columns of the output
+    inner_tile->ProjectColumns(full_column_ids_, inner_column_ids_);
+
+    auto output_tile = BuildOutputLogicalTile(outer_tile_.get(),
+                                              inner_tile.get());
+    LogicalTile::PositionListsBuilder pos_lists_builder(outer_tile_.get(),
+                                                        inner_tile.get());
+
+    for (auto &pair : pairs) {
+      auto outer_row = probe_rows[pair.first];
+
+      if (predicate_ != nullptr) {
+        expression::ContainerTuple<LogicalTile> outer_tuple(outer_tile_.get(),
+                                                            outer_row);
+        expression::ContainerTuple<LogicalTile> inner_tuple(inner_tile.get(),
+                                                            pair.second);
+        if (predicate_->Evaluate(&outer_tuple, &inner_tuple, executor_context_)
+                .IsFalse()) {
+          continue;
+        }
+      }
+
+      outer_row_matched[pair.first] = true;
+      pos_lists_builder.AddRow(outer_row, pair.second);
+    }
+
+    if (pos_lists_builder.Size() > 0) {
+      output_tile->SetPositionListsAndVisibility(pos_lists_builder.Release());
+      buffered_output_tiles.push_back(output_tile.release());
+    }
+  }
+
+  //===--------------------------------------------------------------------===//
+  // Pad the outer rows without a match
+  //===--------------------------------------------------------------------===//
+
+  if (join_type_ == JOIN_TYPE_LEFT) {
+    std::unique_ptr<LogicalTile> inner_tile(BuildEmptyInnerTile());
+    auto output_tile = BuildOutputLogicalTile(outer_tile_.get(),
+                                              inner_tile.get());
+    LogicalTile::PositionListsBuilder pos_lists_builder(outer_tile_.get(),
+                                                        inner_tile.get());
+
+    size_t probe_itr = 0;
+    for (size_t row_itr = outer_row_itr_; row_itr < batch_end; row_itr++) {
+      auto outer_row = outer_rows_[row_itr];
+      if (probe_itr < probe_rows.size() && probe_rows[probe_itr] == outer_row) {
+        if (outer_row_matched[probe_itr++] == true) continue;
+      }
+      pos_lists_builder.AddRightNullRow(outer_row);
+    }
+
+    if (pos_lists_builder.Size() > 0) {
+      output_tile->SetPositionListsAndVisibility(pos_lists_builder.Release());
+      buffered_output_tiles.push_back(output_tile.release());
+    }
+  }
+
+  outer_row_itr_ = batch_end;
+}
+
+LogicalTile *NestedLoopIndexJoinExecutor::BuildEmptyInnerTile() {
+  LogicalTile *inner_tile = LogicalTileFactory::GetTile();
+  inner_tile->AddColumns(inner_table_->GetTileGroup(0), inner_column_ids_);
+  inner_tile->AddPositionList(std::vector<oid_t>());
+  return inner_tile;
+}
+
+}  // namespace executor
+}  // namespace peloton
@@ -0,0 +1,90 @@
+//===----------------------------------------------------------------------===//
+//
+//                         PelotonDB
+//
+// nested_loop_index_join_executor.h
+//
+// Identification: src/backend/executor/nested_loop_index_join_executor.h
+//
+// Copyright (c) 2015, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <deque>
+#include <memory>
+#include <vector>
+
+#include "backend/executor/abstract_join_executor.h"
+#include "backend/planner/nested_loop_index_join_plan.h"
+
+namespace peloton {
+
+namespace index {
+class Index;
+}
+
+namespace storage {
+class DataTable;
+}
+
+namespace executor {
+
+class NestedLoopIndexJoinExecutor : public AbstractJoinExecutor {
+  NestedLoopIndexJoinExecutor(const NestedLoopIndexJoinExecutor &) = delete;
+  NestedLoopIndexJoinExecutor &operator=(const NestedLoopIndexJoinExecutor &) =
+      delete;
+
+ public:
+  explicit NestedLoopIndexJoinExecutor(const planner::AbstractPlan *node,
+                                       ExecutorContext *executor_context);
+
+  ~NestedLoopIndexJoinExecutor();
+
+ protected:
+  bool DInit();
+
+  bool DExecute();
+
+ private:
+  // Join the next batch of rows of the outer tile
+  void JoinOuterBatch();
+
+  // Build a logical tile with the inner columns but no rows, the right side
+  // of the rows without a match
+  LogicalTile *BuildEmptyInnerTile();
+
+  //===--------------------------------------------------------------------===//
+  // Executor State
+  //===--------------------------------------------------------------------===//
+
+  /** @brief Output tiles of the last batch */
+  std::deque<LogicalTile *> buffered_output_tiles;
+
+  /** @brief Tile of the outer child being joined */
+  std::unique_ptr<LogicalTile> outer_tile_;
+
+  /** @brief Visible rows of the outer tile */
+  std::vector<oid_t> outer_rows_;
+
+  /** @brief First outer row of the next batch */
+  size_t outer_row_itr_ = 0;
+
+  //===--------------------------------------------------------------------===//
+  // Plan Info
+  //===--------------------------------------------------------------------===//
+
+  storage::DataTable *inner_table_ = nullptr;
+
+  index::Index *inner_index_ = nullptr;
+
+  std::vector<oid_t> outer_key_column_ids_;
+
+  std::vector<oid_t> inner_column_ids_;
+
+  std::vector<oid_t> full_column_ids_;
+};
+
+}  // namespace executor
+}  // namespace peloton
@@ -10,12 +10,18 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include <algorithm>
+
+#include "backend/common/exception.h"
 #include "backend/common/logger.h"
 #include "backend/common/pool.h"
+#include "backend/common/value_peeker.h"
 #include "backend/executor/logical_tile.h"
-#include "backend/executor/logical_tile_factory.h"
+#include "backend/executor/result_tile_builder.h"
 #include "backend/executor/order_by_executor.h"
+#include "backend/executor/tuple_sorter.h"
 #include "backend/executor/executor_context.h"
+#include "backend/expression/container_tuple.h"
 
 #include "backend/planner/order_by_plan.h"
 #include "backend/storage/tile.h"
@@ -23,6 +29,26 @@
 namespace peloton {
 namespace executor {
 
+namespace {
+
+// Most runs merged at once, each needs an open file and a read buffer
+const size_t merge_fan_in = 64;
+
+// Memory held by a copy of an input tuple, in bytes
+size_t GetTupleSize(const storage::Tuple *tuple,
+                    const catalog::Schema *schema) {
+  size_t tuple_size = sizeof(storage::Tuple) + schema->GetLength();
+  for (oid_t itr = 0; itr < schema->GetUninlinedColumnCount(); itr++) {
+    Value value = tuple->GetValue(schema->GetUninlinedColumn(itr));
+    if (value.IsNull() == false) {
+      tuple_size += ValuePeeker::PeekObjectLengthWithoutNull(value);
+    }
+  }
+  return tuple_size;
+}
+
+}  // namespace
+
 /**
  * @brief Constructor
  * @param node  OrderByNode plan node corresponding to this executor
@@ -33,10 +59,18 @@ OrderByExecutor::OrderByExecutor(const planner::AbstractPlan *node,
 
 OrderByExecutor::~OrderByExecutor() {}
 
+void OrderByExecutor::SetLimit(size_t limit) {
+  has_limit_ = true;
+  is_top_n_ = true;
+  limit_ = limit;
+}
+
 bool OrderByExecutor::DInit() {
   assert(children_.size() == 1);
 
   sort_done_ = false;
+  is_top_n_ = has_limit_;
+  num_tuples_ = 0;
   num_tuples_returned_ = 0;
 
   return true;
@@ -47,46 +81,38 @@ bool OrderByExecutor::DExecute() {
 
   if (!sort_done_) DoSort();
 
-  if (!(num_tuples_returned_ < sort_buffer_.size())) {
+  if (!(num_tuples_returned_ < num_tuples_)) {
     return false;
   }
 
   assert(sort_done_);
   assert(input_schema_.get());
-  assert(input_tiles_.size() > 0);
 
   // Returned tiles must be newly created physical tiles,
   // which have the same physical schema as input tiles.
   size_t tile_size = std::min(size_t(DEFAULT_TUPLES_PER_TILEGROUP),
-                              sort_buffer_.size() - num_tuples_returned_);
+                              num_tuples_ - num_tuples_returned_);
 
-  std::shared_ptr<storage::Tile> ptile(storage::TileFactory::GetTile(
-      BACKEND_TYPE_MM, INVALID_OID, INVALID_OID, INVALID_OID, INVALID_OID,
-      nullptr, *input_schema_, nullptr, tile_size));
+  ResultTileBuilder result_builder(input_schema_.get(), tile_size);
 
   for (size_t id = 0; id < tile_size; id++) {
-    oid_t source_tile_id =
-        sort_buffer_[num_tuples_returned_ + id].item_pointer.block;
-    oid_t source_tuple_id =
-        sort_buffer_[num_tuples_returned_ + id].item_pointer.offset;
-    // Insert a physical tuple into physical tile
-    for (oid_t col = 0; col < input_schema_->GetColumnCount(); col++) {
-      ptile.get()->SetValue(
-          input_tiles_[source_tile_id]->GetValue(source_tuple_id, col), id,
-          col);
-    }
+    storage::Tuple *tuple = GetNextTuple();
+    assert(tuple != nullptr);
+
+    // Copy the physical tuple into the physical tile
+    result_builder.AppendTuple(tuple);
+
+    num_tuples_returned_++;
   }
 
   // Create an owner wrapper of this physical tile
-  std::vector<std::shared_ptr<storage::Tile>> singleton({ptile});
-  std::unique_ptr<LogicalTile> ltile(LogicalTileFactory::WrapTiles(singleton));
-  assert(ltile->GetTupleCount() == tile_size);
-
-  SetOutput(ltile.release());
+  auto result = result_builder.GetResultTiles();
+  assert(result.size() == 1);
+  assert(result[0]->GetTupleCount() == tile_size);
 
-  num_tuples_returned_ += tile_size;
+  SetOutput(result[0]);
 
-  assert(num_tuples_returned_ <= sort_buffer_.size());
+  assert(num_tuples_returned_ <= num_tuples_);
 
   return true;
 }
@@ -97,97 +123,261 @@ bool OrderByExecutor::DoSort() {
   assert(!sort_done_);
   assert(executor_context_ != nullptr);
 
-  // Extract all data from child
+  // Grab data from plan node
+  const planner::OrderByPlan &node = GetPlanNode<planner::OrderByPlan>();
+  sort_keys_ = node.GetSortKeys();
+  descend_flags_ = node.GetDescendFlags();
+
+  // Copy all tuples from child into the sort buffer, spilling sorted runs
+  // whenever it is full
   while (children_[0]->Execute()) {
-    input_tiles_.emplace_back(children_[0]->GetOutput());
+    std::unique_ptr<LogicalTile> tile(children_[0]->GetOutput());
+
+    if (input_schema_ == nullptr) {
+      input_schema_.reset(tile->GetPhysicalSchema());
+      sorter_.reset(
+          new TupleSorter(input_schema_.get(), sort_keys_, descend_flags_));
+      if (input_schema_->GetUninlinedColumnCount() > 0) {
+        sort_pool_.reset(new VarlenPool(BACKEND_TYPE_MM));
+      }
+    }
+
+    for (oid_t tuple_id : *tile) {
+      if (is_top_n_) {
+        AddTopNTuple(tile.get(), tuple_id);
+
+        // Too many tuples are needed to keep them all, sort the ones kept
+        // so far and the rest with spilling
+        if (sort_buffer_size_ > node.GetMemoryBudget()) is_top_n_ = false;
+      } else {
+        AddTuple(tile.get(), tuple_id);
+        if (sort_buffer_size_ > node.GetMemoryBudget()) SpillSortBuffer();
+      }
+    }
   }
 
-  /** Number of valid tuples to be sorted. */
-  size_t count = 0;
-  for (auto &tile : input_tiles_) {
-    count += tile->GetTupleCount();
+  if (input_schema_ == nullptr) {
+    sort_done_ = true;
+    return true;
   }
 
-  if (count == 0) return true;
+  if (runs_.empty()) {
+    // Finally ... sort it !
+    sorter_->Sort(sort_buffer_);
+    num_tuples_ = sort_buffer_.size();
+  } else {
+    if (sort_buffer_.empty() == false) SpillSortBuffer();
 
-  // Grab data from plan node
-  const planner::OrderByPlan &node = GetPlanNode<planner::OrderByPlan>();
-  descend_flags_ = node.GetDescendFlags();
+    for (auto &run : runs_) {
+      num_tuples_ += run->GetTupleCount();
+    }
+
+    // Merge the oldest runs into one until all can be merged at once
+    while (runs_.size() > merge_fan_in) {
+      std::vector<std::unique_ptr<SpillFile>> merged_runs(
+          std::make_move_iterator(runs_.begin()),
+          std::make_move_iterator(runs_.begin() + merge_fan_in));
+      runs_.erase(runs_.begin(), runs_.begin() + merge_fan_in);
 
-  // Extract the schema for sort keys.
-  input_schema_.reset(input_tiles_[0]->GetPhysicalSchema());
-  std::vector<catalog::Column> sort_key_columns;
-  for (auto id : node.GetSortKeys()) {
-    sort_key_columns.push_back(input_schema_->GetColumn(id));
-  }
-  sort_key_tuple_schema_.reset(new catalog::Schema(sort_key_columns));
-  auto executor_pool = executor_context_->GetExecutorContextPool();
-
-  // Extract all valid tuples into a single std::vector (the sort buffer)
-  sort_buffer_.reserve(count);
-  for (oid_t tile_id = 0; tile_id < input_tiles_.size(); tile_id++) {
-    for (oid_t tuple_id : *input_tiles_[tile_id]) {
-      // Extract the sort key tuple
-      std::unique_ptr<storage::Tuple> tuple(
-          new storage::Tuple(sort_key_tuple_schema_.get(), true));
-      for (oid_t id = 0; id < node.GetSortKeys().size(); id++) {
-        tuple->SetValue(id, input_tiles_[tile_id]->GetValue(
-                                tuple_id, node.GetSortKeys()[id]),
-                        executor_pool);
+      std::unique_ptr<SpillFile> run(new SpillFile(input_schema_.get()));
+      if (run->Open() == false) {
+        throw ExecutorException("Could not create a sort run");
       }
-      // Inert the sort key tuple into sort buffer
-      sort_buffer_.emplace_back(sort_buffer_entry_t(
-          ItemPointer(tile_id, tuple_id), std::move(tuple)));
-    }
-  }
 
-  assert(count == sort_buffer_.size());
-
-  // Prepare the compare function
-  // Note: This is a less-than comparer, NOT an equality comparer.
-  struct TupleComparer {
-    TupleComparer(std::vector<bool> &_descend_flags)
-        : descend_flags(_descend_flags) {}
-
-    bool operator()(const storage::Tuple *ta, const storage::Tuple *tb) {
-      for (oid_t id = 0; id < descend_flags.size(); id++) {
-        if (!descend_flags[id]) {
-          if (ta->GetValue(id).OpLessThan(tb->GetValue(id)).IsTrue()) {
-            return true;
-          } else if (ta->GetValue(id)
-                         .OpGreaterThan(tb->GetValue(id))
-                         .IsTrue()) {
-            return false;
-          }
-        } else {
-          if (tb->GetValue(id).OpLessThan(ta->GetValue(id)).IsTrue()) {
-            return true;
-          } else if (tb->GetValue(id)
-                         .OpGreaterThan(ta->GetValue(id))
-                         .IsTrue()) {
-            return false;
-          }
+      StartMerge(std::move(merged_runs));
+      for (auto tuple = GetNextMergedTuple(); tuple != nullptr;
+           tuple = GetNextMergedTuple()) {
+        if (run->Write(tuple) == false) {
+          throw ExecutorException("Could not write a sort run");
         }
       }
-      return false;  // Will return false if all keys equal
-    }
 
-    std::vector<bool> descend_flags;
-  };
+      if (run->Rewind() == false) {
+        throw ExecutorException("Could not read a sort run");
+      }
+      runs_.push_back(std::move(run));
+    }
 
-  TupleComparer comp(descend_flags_);
+    StartMerge(std::move(runs_));
+    runs_.clear();
+  }
 
-  // Finally ... sort it !
-  std::sort(
-      sort_buffer_.begin(), sort_buffer_.end(),
-      [&comp](const sort_buffer_entry_t &a, const sort_buffer_entry_t &b) {
-        return comp(a.tuple.get(), b.tuple.get());
-      });
+  if (has_limit_) {
+    num_tuples_ = std::min(num_tuples_, limit_);
+  }
 
   sort_done_ = true;
 
   return true;
 }
 
+/**
+ * @brief Copy an input tuple into the sort buffer.
+ */
+void OrderByExecutor::AddTuple(LogicalTile *tile, oid_t tuple_id) {
+  std::unique_ptr<storage::Tuple> tuple(
+      new storage::Tuple(input_schema_.get(), true));
+  for (oid_t col = 0; col < input_schema_->GetColumnCount(); col++) {
+    tuple->SetValue(col, tile->GetValue(tuple_id, col), sort_pool_.get());
+  }
+
+  sort_buffer_size_ += GetTupleSize(tuple.get(), input_schema_.get());
+  sort_buffer_.push_back(std::move(tuple));
+  sort_buffer_copy_count_++;
+}
+
+/**
+ * @brief Keep an input tuple if it is among the first limit ones in sort
+ * order so far. Only those are copied, the heap evicts the last one.
+ */
+void OrderByExecutor::AddTopNTuple(LogicalTile *tile, oid_t tuple_id) {
+  if (limit_ == 0) return;
+
+  auto comp = [this](const std::unique_ptr<storage::Tuple> &ta,
+                     const std::unique_ptr<storage::Tuple> &tb) {
+    return (*sorter_)(ta.get(), tb.get());
+  };
+
+  if (sort_buffer_.size() == limit_) {
+    expression::ContainerTuple<LogicalTile> input_tuple(tile, tuple_id);
+    if ((*sorter_)(&input_tuple, sort_buffer_.front().get()) == false) return;
+
+    std::pop_heap(sort_buffer_.begin(), sort_buffer_.end(), comp);
+    sort_buffer_size_ -=
+        GetTupleSize(sort_buffer_.back().get(), input_schema_.get());
+    sort_buffer_.pop_back();
+  }
+
+  AddTuple(tile, tuple_id);
+  std::push_heap(sort_buffer_.begin(), sort_buffer_.end(), comp);
+
+  // Evicted tuples leave their uninlined values behind in the pool
+  if (sort_pool_ != nullptr && sort_buffer_copy_count_ > 2 * limit_) {
+    CompactSortBuffer();
+  }
+}
+
+/**
+ * @brief Copy the sort buffer into a new pool, to free the uninlined values
+ * of the tuples that are gone.
+ */
+void OrderByExecutor::CompactSortBuffer() {
+  std::unique_ptr<VarlenPool> pool(new VarlenPool(BACKEND_TYPE_MM));
+
+  for (auto &tuple : sort_buffer_) {
+    std::unique_ptr<storage::Tuple> copy(
+        new storage::Tuple(input_schema_.get(), true));
+    for (oid_t col = 0; col < input_schema_->GetColumnCount(); col++) {
+      copy->SetValue(col, tuple->GetValue(col), pool.get());
+    }
+    tuple = std::move(copy);
+  }
+
+  sort_pool_ = std::move(pool);
+  sort_buffer_copy_count_ = sort_buffer_.size();
+}
+
+/**
+ * @brief Sort the buffer and write it to disk as a sorted run.
+ */
+void OrderByExecutor::SpillSortBuffer() {
+  sorter_->Sort(sort_buffer_);
+
+  std::unique_ptr<SpillFile> run(new SpillFile(input_schema_.get()));
+  if (run->Open() == false) {
+    throw ExecutorException("Could not create a sort run");
+  }
+
+  for (auto &tuple : sort_buffer_) {
+    if (run->Write(tuple.get()) == false) {
+      throw ExecutorException("Could not write a sort run");
+    }
+  }
+
+  if (run->Rewind() == false) {
+    throw ExecutorException("Could not read a sort run");
+  }
+
+  LOG_TRACE("Spilled a sorted run of %lu tuples", sort_buffer_.size());
+  runs_.push_back(std::move(run));
+
+  sort_buffer_.clear();
+  if (sort_pool_ != nullptr) sort_pool_->Purge();
+  sort_buffer_size_ = 0;
+  sort_buffer_copy_count_ = 0;
+}
+
+/**
+ * @brief Start a k-way merge of sorted runs, reading the first tuple of
+ * each of them.
+ */
+void OrderByExecutor::StartMerge(std::vector<std::unique_ptr<SpillFile>> &&
+                                     runs) {
+  merge_runs_.clear();
+  merge_runs_.resize(runs.size());
+  merge_heap_.clear();
+  merge_run_itr_ = INVALID_OID;
+
+  for (oid_t run_itr = 0; run_itr < runs.size(); run_itr++) {
+    auto &run = merge_runs_[run_itr];
+    run.file = std::move(runs[run_itr]);
+    if (input_schema_->GetUninlinedColumnCount() > 0) {
+      run.pool.reset(new VarlenPool(BACKEND_TYPE_MM));
+    }
+    run.tuple.reset(new storage::Tuple(input_schema_.get(), true));
+
+    if (run.file->Read(run.tuple.get(), run.pool.get())) {
+      merge_heap_.push_back(run_itr);
+    }
+  }
+
+  // Min-heap on the current tuples of the runs
+  std::make_heap(merge_heap_.begin(), merge_heap_.end(),
+                 [this](oid_t a, oid_t b) {
+                   return (*sorter_)(merge_runs_[b].tuple.get(),
+                                     merge_runs_[a].tuple.get());
+                 });
+}
+
+/**
+ * @brief Next tuple of the merge in sort order.
+ * @return The tuple, valid until the next call, or nullptr after the last.
+ */
+storage::Tuple *OrderByExecutor::GetNextMergedTuple() {
+  auto heap_comp = [this](oid_t a, oid_t b) {
+    return (*sorter_)(merge_runs_[b].tuple.get(), merge_runs_[a].tuple.get());
+  };
+
+  // Advance the run of the tuple returned last
+  if (merge_run_itr_ != INVALID_OID) {
+    auto &run = merge_runs_[merge_run_itr_];
+    if (run.pool != nullptr) run.pool->Purge();
+
+    if (run.file->Read(run.tuple.get(), run.pool.get())) {
+      merge_heap_.push_back(merge_run_itr_);
+      std::push_heap(merge_heap_.begin(), merge_heap_.end(), heap_comp);
+    } else {
+      // Close the run once it is consumed
+      run = merge_run_t();
+    }
+    merge_run_itr_ = INVALID_OID;
+  }
+
+  if (merge_heap_.empty()) return nullptr;
+
+  std::pop_heap(merge_heap_.begin(), merge_heap_.end(), heap_comp);
+  merge_run_itr_ = merge_heap_.back();
+  merge_heap_.pop_back();
+
+  return merge_runs_[merge_run_itr_].tuple.get();
+}
+
+storage::Tuple *OrderByExecutor::GetNextTuple() {
+  if (merge_runs_.empty()) {
+    return sort_buffer_[num_tuples_returned_].get();
+  }
+  return GetNextMergedTuple();
+}
+
 } /* namespace executor */
 } /* namespace peloton */
@@ -12,8 +12,13 @@
 
 #pragma once
 
+#include <memory>
+#include <vector>
+
 #include "backend/common/types.h"
 #include "backend/executor/abstract_executor.h"
+#include "backend/executor/spill_file.h"
+#include "backend/executor/tuple_sorter.h"
 #include "backend/storage/tuple.h"
 
 namespace peloton {
@@ -25,10 +30,11 @@ namespace executor {
 /**
  * @warning This is a pipeline breaker and a materialization point.
  *
- * TODO Currently, we store all input tiles and sort result in memory
- * until this executor is destroyed, which is sometimes necessary.
- * But can we let it release the RAM earlier as long as the executor
- * is not needed any more (e.g., with a LIMIT sitting on top)?
+ * Input tuples are copied into a sort buffer that may grow up to the memory
+ * budget of the plan. A full buffer is sorted and spilled to a temporary
+ * file as a sorted run, and the runs are merged while the result is
+ * returned. If only the first tuples are needed (a LIMIT on top), a bounded
+ * heap keeps those instead and nothing is spilled.
  */
 class OrderByExecutor : public AbstractExecutor {
  public:
@@ -42,6 +48,10 @@ class OrderByExecutor : public AbstractExecutor {
 
   ~OrderByExecutor();
 
+  // Only return the first tuples in sort order, up to the limit.
+  // Has to be set before the executor is run.
+  void SetLimit(size_t limit);
+
  protected:
   bool DInit();
 
@@ -50,49 +60,76 @@ class OrderByExecutor : public AbstractExecutor {
  private:
   bool DoSort();
 
-  bool sort_done_ = false;
+  void AddTuple(LogicalTile *tile, oid_t tuple_id);
 
-  /**
-   * IMPORTANT This type must be move-constructible and move-assignable
-   * in order to be correctly sorted by STL sort
-   */
-  struct sort_buffer_entry_t {
-    ItemPointer item_pointer;
-    std::unique_ptr<storage::Tuple> tuple;
+  void AddTopNTuple(LogicalTile *tile, oid_t tuple_id);
 
-    sort_buffer_entry_t(ItemPointer ipt, std::unique_ptr<storage::Tuple> &&tp)
-        : item_pointer(ipt), tuple(std::move(tp)) {}
+  void CompactSortBuffer();
 
-    sort_buffer_entry_t(sort_buffer_entry_t &&rhs) {
-      item_pointer = rhs.item_pointer;
-      tuple = std::move(rhs.tuple);
-    }
+  void SpillSortBuffer();
 
-    sort_buffer_entry_t &operator=(sort_buffer_entry_t &&rhs) {
-      item_pointer = rhs.item_pointer;
-      tuple = std::move(rhs.tuple);
-      return *this;
-    }
+  void StartMerge(std::vector<std::unique_ptr<SpillFile>> &&runs);
 
-    sort_buffer_entry_t(const sort_buffer_entry_t &) = delete;
-    sort_buffer_entry_t &operator=(const sort_buffer_entry_t &) = delete;
-  };
+  storage::Tuple *GetNextMergedTuple();
+
+  storage::Tuple *GetNextTuple();
 
-  /** All tiles returned by child. */
-  std::vector<std::unique_ptr<LogicalTile>> input_tiles_;
+  bool sort_done_ = false;
+
+  /** @brief Sorted run being merged, with its current tuple */
+  struct merge_run_t {
+    std::unique_ptr<SpillFile> file;
+    std::unique_ptr<VarlenPool> pool;
+    std::unique_ptr<storage::Tuple> tuple;
+  };
 
   /** Physical (not logical) schema of input tiles */
   std::unique_ptr<catalog::Schema> input_schema_;
 
-  /** All valid tuples in sorted order */
-  std::vector<sort_buffer_entry_t> sort_buffer_;
-
-  /** Tuples in sort_buffer only contains the sort keys */
-  std::unique_ptr<catalog::Schema> sort_key_tuple_schema_;
+  /** Column ids of the sort keys in the input tiles */
+  std::vector<oid_t> sort_keys_;
 
   /** ASC/DESC flags */
   std::vector<bool> descend_flags_;
 
+  /** Sorts and compares tuples on the sort keys */
+  std::unique_ptr<TupleSorter> sorter_;
+
+  /** Copies of the input tuples not spilled yet. A max-heap of the first
+   * tuples in sort order when there is a limit. */
+  std::vector<std::unique_ptr<storage::Tuple>> sort_buffer_;
+
+  /** Uninlined values of the sort buffer, null if there are none */
+  std::unique_ptr<VarlenPool> sort_pool_;
+
+  /** Approximate memory used by the sort buffer, in bytes */
+  size_t sort_buffer_size_ = 0;
+
+  /** Tuples copied into the sort buffer since its pool was compacted */
+  size_t sort_buffer_copy_count_ = 0;
+
+  /** Sorted runs spilled to disk */
+  std::vector<std::unique_ptr<SpillFile>> runs_;
+
+  /** Runs being merged */
+  std::vector<merge_run_t> merge_runs_;
+
+  /** Min-heap of the runs being merged that have tuples left */
+  std::vector<oid_t> merge_heap_;
+
+  /** Run the last merged tuple came from, to be advanced on the next one */
+  oid_t merge_run_itr_ = INVALID_OID;
+
+  bool has_limit_ = false;
+
+  size_t limit_ = 0;
+
+  /** Whether the sort buffer is a heap of the first tuples up to the limit */
+  bool is_top_n_ = false;
+
+  /** Number of tuples to return */
+  size_t num_tuples_ = 0;
+
   /** How many tuples have been returned to parent */
   size_t num_tuples_returned_ = 0;
 };
@@ -0,0 +1,89 @@
+//===----------------------------------------------------------------------===//
+//
+//                         PelotonDB
+//
+// result_tile_builder.cpp
+//
+// Identification: src/backend/executor/result_tile_builder.cpp
+//
+// Copyright (c) 2015, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "backend/executor/result_tile_builder.h"
+
+#include <cassert>
+#include <cstring>
+#include <numeric>
+
+#include "backend/catalog/schema.h"
+#include "backend/executor/logical_tile.h"
+#include "backend/executor/logical_tile_factory.h"
+#include "backend/storage/tile.h"
+#include "backend/storage/tuple.h"
+
+namespace peloton {
+namespace executor {
+
+ResultTileBuilder::ResultTileBuilder(const catalog::Schema *schema,
+                                     size_t tile_size)
+    : schema_(schema), tile_size_(tile_size) {
+  assert(schema_ != nullptr);
+  assert(tile_size_ > 0);
+}
+
+void ResultTileBuilder::AppendTuple(const storage::Tuple *tuple) {
+  if (tiles_.empty() || tile_tuple_count_ == tile_size_) {
+    tiles_.emplace_back(
+        storage::TileFactory::GetTempTile(*schema_, tile_size_));
+    tile_tuple_count_ = 0;
+  }
+
+  auto tile = tiles_.back().get();
+  if (schema_->IsInlined()) {
+    ::memcpy(tile->GetTupleLocation(tile_tuple_count_), tuple->GetData(),
+             schema_->GetLength());
+  } else {
+    for (oid_t column_itr = 0; column_itr < schema_->GetColumnCount();
+         column_itr++) {
+      tile->SetValue(tuple->GetValue(column_itr), tile_tuple_count_,
+                     column_itr);
+    }
+  }
+
+  tile_tuple_count_++;
+  tuple_count_++;
+}
+
+std::vector<LogicalTile *> ResultTileBuilder::GetResultTiles() {
+  std::vector<LogicalTile *> result;
+
+  for (size_t tile_itr = 0; tile_itr < tiles_.size(); tile_itr++) {
+    // Only the last tile may have unused slots, they are left out
+    size_t tile_tuple_count =
+        (tile_itr + 1 == tiles_.size()) ? tile_tuple_count_ : tile_size_;
+
+    std::vector<oid_t> position_list(tile_tuple_count);
+    std::iota(position_list.begin(), position_list.end(), 0);
+
+    std::unique_ptr<LogicalTile> logical_tile(LogicalTileFactory::GetTile());
+    const oid_t position_list_idx =
+        logical_tile->AddPositionList(std::move(position_list));
+    for (oid_t column_itr = 0; column_itr < schema_->GetColumnCount();
+         column_itr++) {
+      logical_tile->AddColumn(tiles_[tile_itr], column_itr,
+                              position_list_idx);
+    }
+
+    result.push_back(logical_tile.release());
+  }
+
+  tiles_.clear();
+  tile_tuple_count_ = 0;
+  tuple_count_ = 0;
+
+  return result;
+}
+
+}  // namespace executor
+}  // namespace peloton
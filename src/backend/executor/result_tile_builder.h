@@ -0,0 +1,83 @@
+//===----------------------------------------------------------------------===//
+//
+//                         PelotonDB
+//
+// result_tile_builder.h
+//
+// Identification: src/backend/executor/result_tile_builder.h
+//
+// Copyright (c) 2015, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include "backend/common/types.h"
+
+namespace peloton {
+
+namespace catalog {
+class Schema;
+}
+
+namespace storage {
+class Tile;
+class Tuple;
+}
+
+namespace executor {
+
+class LogicalTile;
+
+/**
+ * @brief Collects the result rows of an executor into physical tiles.
+ *
+ * The rows are appended to temporary tiles of a fixed number of slots, which
+ * do not belong to a table or tile group. Nothing is transactional: there is
+ * no tile group header, no constraint check and no visibility check, the
+ * rows are written once and then wrapped as logical tiles.
+ *
+ * Inlined rows are copied with a single memcpy, uninlined values are copied
+ * into the pool of their tile so that the tiles do not reference the memory
+ * of the executor.
+ */
+class ResultTileBuilder {
+ public:
+  ResultTileBuilder(const ResultTileBuilder &) = delete;
+  ResultTileBuilder &operator=(const ResultTileBuilder &) = delete;
+  ResultTileBuilder(ResultTileBuilder &&) = delete;
+  ResultTileBuilder &operator=(ResultTileBuilder &&) = delete;
+
+  ResultTileBuilder(const catalog::Schema *schema,
+                    size_t tile_size = DEFAULT_TUPLES_PER_TILEGROUP);
+
+  // Copy a tuple of the schema into the next row
+  void AppendTuple(const storage::Tuple *tuple);
+
+  // Wrap the rows appended so far into logical tiles, in order. The caller
+  // owns them, and the builder starts over empty.
+  std::vector<LogicalTile *> GetResultTiles();
+
+  const catalog::Schema *GetSchema() const { return schema_; }
+
+  size_t GetTupleCount() const { return tuple_count_; }
+
+ private:
+  const catalog::Schema *schema_;
+
+  /** @brief Number of rows of every tile */
+  size_t tile_size_;
+
+  std::vector<std::shared_ptr<storage::Tile>> tiles_;
+
+  /** @brief Rows in the last tile */
+  size_t tile_tuple_count_ = 0;
+
+  size_t tuple_count_ = 0;
+};
+
+}  // namespace executor
+}  // namespace peloton
@@ -12,7 +12,9 @@
 
 #include "backend/executor/seq_scan_executor.h"
 
+#include <algorithm>
 #include <memory>
+#include <numeric>
 #include <utility>
 #include <vector>
 
@@ -20,11 +22,13 @@
 #include "backend/executor/logical_tile.h"
 #include "backend/executor/logical_tile_factory.h"
 #include "backend/executor/executor_context.h"
+#include "backend/executor/morsel_scheduler.h"
 #include "backend/expression/abstract_expression.h"
 #include "backend/expression/container_tuple.h"
 #include "backend/storage/data_table.h"
 #include "backend/storage/tile_group_header.h"
 #include "backend/storage/tile.h"
+#include "backend/storage/tuple.h"
 #include "backend/common/logger.h"
 
 namespace peloton {
@@ -53,14 +57,26 @@ bool SeqScanExecutor::DInit() {
   target_table_ = node.GetTable();
 
   current_tile_group_offset_ = START_OID;
+  tile_group_cursor_ = nullptr;
 
   if (target_table_ != nullptr) {
     table_tile_group_count_ = target_table_->GetTileGroupCount();
 
+    // Take turns with the other workers of a parallel pipeline
+    auto morsel_scheduler = executor_context_->GetMorselScheduler();
+    if (morsel_scheduler != nullptr) {
+      tile_group_cursor_ = &morsel_scheduler->GetTileGroupCursor(&node);
+    }
+
     if (column_ids_.empty()) {
       column_ids_.resize(target_table_->GetSchema()->GetColumnCount());
       std::iota(column_ids_.begin(), column_ids_.end(), 0);
     }
+
+    if (predicate_ != nullptr) {
+      compiled_predicate_ = expression::PredicateCompiler::Compile(
+          predicate_, target_table_->GetSchema(), executor_context_);
+    }
   }
 
   return true;
@@ -111,8 +127,19 @@ bool SeqScanExecutor::DExecute() {
     assert(target_table_ != nullptr);
     assert(column_ids_.size() > 0);
 
+    // Older versions found in the previous tile group
+    if (version_tile_ != nullptr) {
+      SetOutput(version_tile_.release());
+      return true;
+    }
+
     // Retrieve next tile group.
-    while (current_tile_group_offset_ < table_tile_group_count_) {
+    for (;;) {
+      if (tile_group_cursor_ != nullptr) {
+        current_tile_group_offset_ = (*tile_group_cursor_)++;
+      }
+      if (current_tile_group_offset_ >= table_tile_group_count_) break;
+
       auto tile_group =
           target_table_->GetTileGroup(current_tile_group_offset_++);
 
@@ -126,34 +153,76 @@ bool SeqScanExecutor::DExecute() {
       // Print tile group visibility
       // tile_group_header->PrintVisibility(txn_id, commit_id);
 
-      // Construct logical tile.
-      std::unique_ptr<LogicalTile> logical_tile(LogicalTileFactory::GetTile());
-      logical_tile->AddColumns(tile_group, column_ids_);
-
       // Construct position list by looping through tile group
-      // and applying the predicate.
+      // and applying the predicate to all visible tuples at once.
       std::vector<oid_t> position_list;
+      std::vector<oid_t> version_tuple_ids;
+      std::vector<uint32_t> slot_versions(active_tuple_count);
       for (oid_t tuple_id = 0; tuple_id < active_tuple_count; tuple_id++) {
+        slot_versions[tuple_id] = tile_group_header->BeginSlotRead(tuple_id);
         if (tile_group_header->IsVisible(tuple_id, txn_id, commit_id) ==
             false) {
+          // An older version might be visible if updated in place
+          if (tile_group_header->GetPrevItemPointer(tuple_id).block !=
+              INVALID_OID) {
+            version_tuple_ids.push_back(tuple_id);
+          }
           continue;
         }
 
-        expression::ContainerTuple<storage::TileGroup> tuple(tile_group.get(),
-                                                             tuple_id);
-        if (predicate_ == nullptr) {
-          position_list.push_back(tuple_id);
-        } else {
-          auto eval =
-              predicate_->Evaluate(&tuple, nullptr, executor_context_).IsTrue();
-          if (eval == true) position_list.push_back(tuple_id);
+        position_list.push_back(tuple_id);
+      }
+
+      if (compiled_predicate_ != nullptr && position_list.empty() == false) {
+        std::vector<oid_t> visible_tuple_ids(position_list);
+        compiled_predicate_->Select(tile_group.get(), position_list,
+                                    executor_context_);
+
+        // The predicate may have dropped a tuple on values a writer was
+        // changing meanwhile, check it again on a copy
+        for (auto tuple_id : visible_tuple_ids) {
+          if (std::binary_search(position_list.begin(), position_list.end(),
+                                 tuple_id) == false &&
+              tile_group_header->ValidateSlotRead(
+                  tuple_id, slot_versions[tuple_id]) == false) {
+            version_tuple_ids.push_back(tuple_id);
+          }
+        }
+      }
+
+      // Copy the selected tuples, they can be updated in place later. The
+      // ones a writer has been in meanwhile are copied again below.
+      std::unique_ptr<LogicalTile> logical_tile(
+          LogicalTileFactory::WrapTupleCopies(tile_group, position_list,
+                                              slot_versions, column_ids_,
+                                              version_tuple_ids));
+
+      // Copy the visible versions of the rest, checking again against a
+      // writer overwriting the slot meanwhile
+      std::vector<std::unique_ptr<storage::Tuple>> version_tuples;
+      for (auto tuple_id : version_tuple_ids) {
+        std::unique_ptr<storage::Tuple> version(
+            new storage::Tuple(target_table_->GetSchema(), true));
+        if (tile_group->CopyVisibleVersion(tuple_id, txn_id, commit_id,
+                                           version.get()) &&
+            (predicate_ == nullptr ||
+             predicate_->Evaluate(version.get(), nullptr, executor_context_)
+                 .IsTrue())) {
+          version_tuples.push_back(std::move(version));
         }
       }
 
-      logical_tile->AddPositionList(std::move(position_list));
+      if (version_tuples.empty() == false) {
+        version_tile_.reset(
+            LogicalTileFactory::WrapTuples(version_tuples, column_ids_));
+      }
 
       // Don't return empty tiles
       if (0 == logical_tile->GetTupleCount()) {
+        if (version_tile_ != nullptr) {
+          SetOutput(version_tile_.release());
+          return true;
+        }
         continue;
       }
 
@@ -165,5 +234,25 @@ bool SeqScanExecutor::DExecute() {
   return false;
 }
 
+/**
+ * @brief Creates a logical tile with the scanned columns and no rows.
+ * @return The empty tile, nullptr if the child cannot tell its columns.
+ */
+LogicalTile *SeqScanExecutor::GetEmptyOutput() {
+  if (children_.size() == 1) {
+    return children_[0]->GetEmptyOutput();
+  }
+
+  assert(target_table_ != nullptr);
+  assert(column_ids_.size() > 0);
+
+  // Every tile group of the table has the same columns
+  std::unique_ptr<LogicalTile> logical_tile(LogicalTileFactory::GetTile());
+  logical_tile->AddColumns(target_table_->GetTileGroup(0), column_ids_);
+  logical_tile->AddPositionList(std::vector<oid_t>());
+
+  return logical_tile.release();
+}
+
 }  // namespace executor
 }  // namespace peloton
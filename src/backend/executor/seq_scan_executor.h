@@ -12,8 +12,12 @@
 
 #pragma once
 
+#include <atomic>
+#include <memory>
+
 #include "backend/planner/seq_scan_plan.h"
 #include "backend/executor/abstract_scan_executor.h"
+#include "backend/expression/predicate_compiler.h"
 
 namespace peloton {
 namespace executor {
@@ -28,6 +32,8 @@ class SeqScanExecutor : public AbstractScanExecutor {
   explicit SeqScanExecutor(const planner::AbstractPlan *node,
                            ExecutorContext *executor_context);
 
+  LogicalTile *GetEmptyOutput();
+
  protected:
   bool DInit();
 
@@ -44,6 +50,17 @@ class SeqScanExecutor : public AbstractScanExecutor {
   /** @brief Keeps track of the number of tile groups to scan. */
   oid_t table_tile_group_count_ = INVALID_OID;
 
+  /** @brief Next tile group to scan, shared with the other workers of a
+   * parallel pipeline. Null if the scan runs on its own. */
+  std::atomic<oid_t> *tile_group_cursor_ = nullptr;
+
+  /** @brief Older versions of tuples updated in place, to be returned after
+   * the logical tile of their tile group. */
+  std::unique_ptr<LogicalTile> version_tile_;
+
+  /** @brief Predicate compiled for the schema of the table. */
+  std::unique_ptr<expression::CompiledPredicate> compiled_predicate_;
+
   //===--------------------------------------------------------------------===//
   // Plan Info
   //===--------------------------------------------------------------------===//
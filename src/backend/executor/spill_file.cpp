@@ -0,0 +1,122 @@
+//===----------------------------------------------------------------------===//
+//
+//                         PelotonDB
+//
+// spill_file.cpp
+//
+// Identification: src/backend/executor/spill_file.cpp
+//
+// Copyright (c) 2015, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "backend/executor/spill_file.h"
+
+#include <cerrno>
+#include <cstring>
+
+#include "backend/common/exception.h"
+#include "backend/common/logger.h"
+#include "backend/common/serializer.h"
+#include "backend/storage/tuple.h"
+
+namespace peloton {
+namespace executor {
+
+// Serializes into a buffer that grows with the largest tuple written
+class SpillSerializeOutput : public SerializeOutput {
+ public:
+  SpillSerializeOutput() : buffer_(initial_size) {
+    Initialize(buffer_.data(), buffer_.size());
+  }
+
+  void Reset() { SetPosition(0); }
+
+ protected:
+  void Expand(size_t minimum_desired) {
+    buffer_.resize(minimum_desired * 2);
+    Initialize(buffer_.data(), buffer_.size());
+  }
+
+ private:
+  static const size_t initial_size = 1024;
+
+  std::vector<char> buffer_;
+};
+
+SpillFile::SpillFile(const catalog::Schema *schema)
+    : schema_(schema), output_(new SpillSerializeOutput()) {}
+
+SpillFile::~SpillFile() {
+  if (file_ != nullptr) {
+    fclose(file_);
+  }
+}
+
+bool SpillFile::Open() {
+  assert(file_ == nullptr);
+
+  file_ = tmpfile();
+  if (file_ == nullptr) {
+    LOG_ERROR("Could not create a spill file : %s", strerror(errno));
+    return false;
+  }
+
+  return true;
+}
+
+bool SpillFile::Write(storage::Tuple *tuple) {
+  assert(file_ != nullptr);
+
+  // The tuple starts with its length
+  output_->Reset();
+  tuple->SerializeTo(*output_);
+
+  if (fwrite(output_->Data(), output_->Size(), 1, file_) != 1) {
+    LOG_ERROR("Could not write to a spill file : %s", strerror(errno));
+    return false;
+  }
+
+  tuple_count_++;
+  return true;
+}
+
+bool SpillFile::Rewind() {
+  assert(file_ != nullptr);
+
+  if (fflush(file_) != 0 || fseek(file_, 0, SEEK_SET) != 0) {
+    LOG_ERROR("Could not rewind a spill file : %s", strerror(errno));
+    return false;
+  }
+
+  return true;
+}
+
+bool SpillFile::Read(storage::Tuple *tuple, VarlenPool *pool) {
+  assert(file_ != nullptr);
+
+  // Only the end of the file between two tuples is a clean end
+  int32_t length;
+  size_t length_size = fread(&length, 1, sizeof(length), file_);
+  if (length_size == 0 && feof(file_)) {
+    return false;
+  }
+  if (length_size != sizeof(length)) {
+    throw ExecutorException("Spill file ends within a tuple length");
+  }
+
+  input_buffer_.resize(sizeof(length) + ntohl(length));
+  memcpy(input_buffer_.data(), &length, sizeof(length));
+  if (input_buffer_.size() > sizeof(length) &&
+      fread(input_buffer_.data() + sizeof(length),
+            input_buffer_.size() - sizeof(length), 1, file_) != 1) {
+    throw ExecutorException("Spill file ends within a tuple");
+  }
+
+  ReferenceSerializeInputBE input(input_buffer_.data(), input_buffer_.size());
+  tuple->DeserializeFrom(input, pool);
+  return true;
+}
+
+}  // namespace executor
+}  // namespace peloton
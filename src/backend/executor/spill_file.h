@@ -0,0 +1,88 @@
+//===----------------------------------------------------------------------===//
+//
+//                         PelotonDB
+//
+// spill_file.h
+//
+// Identification: src/backend/executor/spill_file.h
+//
+// Copyright (c) 2015, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <cstdio>
+#include <memory>
+#include <vector>
+
+#include "backend/common/types.h"
+
+namespace peloton {
+
+class VarlenPool;
+
+namespace catalog {
+class Schema;
+}
+
+namespace storage {
+class Tuple;
+}
+
+namespace executor {
+
+class SpillSerializeOutput;
+
+/**
+ * @brief A temporary file of tuples, for executors that run out of memory.
+ *
+ * Tuples are appended in the serialization format of storage::Tuple and read
+ * back in the same order after the file is rewound. The file is removed when
+ * it is closed.
+ */
+class SpillFile {
+ public:
+  SpillFile(const SpillFile &) = delete;
+  SpillFile &operator=(const SpillFile &) = delete;
+  SpillFile(SpillFile &&) = delete;
+  SpillFile &operator=(SpillFile &&) = delete;
+
+  explicit SpillFile(const catalog::Schema *schema);
+
+  ~SpillFile();
+
+  // Create the file. Returns false if it could not be created.
+  bool Open();
+
+  bool Write(storage::Tuple *tuple);
+
+  // Finish writing and start reading from the first tuple
+  bool Rewind();
+
+  // Read the next tuple, uninlined values are allocated in the pool.
+  // Returns false at the end of the file, throws an ExecutorException if the
+  // file ends within a tuple.
+  bool Read(storage::Tuple *tuple, VarlenPool *pool);
+
+  size_t GetTupleCount() const { return tuple_count_; }
+
+  const catalog::Schema *GetSchema() const { return schema_; }
+
+ private:
+  /** @brief Schema of the tuples in the file */
+  const catalog::Schema *schema_;
+
+  FILE *file_ = nullptr;
+
+  size_t tuple_count_ = 0;
+
+  /** @brief Serialized tuple being written */
+  std::unique_ptr<SpillSerializeOutput> output_;
+
+  /** @brief Serialized tuple being read */
+  std::vector<char> input_buffer_;
+};
+
+}  // namespace executor
+}  // namespace peloton
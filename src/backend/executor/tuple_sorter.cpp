@@ -0,0 +1,252 @@
+//===----------------------------------------------------------------------===//
+//
+//                         PelotonDB
+//
+// tuple_sorter.cpp
+//
+// Identification: src/backend/executor/tuple_sorter.cpp
+//
+// Copyright (c) 2015, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "backend/executor/tuple_sorter.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+
+#include "backend/catalog/schema.h"
+#include "backend/common/abstract_tuple.h"
+#include "backend/index/index_key.h"
+#include "backend/storage/tuple.h"
+
+namespace peloton {
+namespace executor {
+
+namespace {
+
+const size_t max_prefix_word_count = 4;
+
+// Buckets of the radix sort up to this size are sorted with std::sort
+const size_t radix_sort_threshold = 64;
+
+inline uint64_t LoadBigEndian(const uint8_t *bytes) {
+  uint64_t value = 0;
+  for (size_t byte_itr = 0; byte_itr < sizeof(uint64_t); byte_itr++) {
+    value = (value << 8) | bytes[byte_itr];
+  }
+  return value;
+}
+
+/**
+ * @brief Normalized key of a tuple, its words compare in sort order.
+ */
+template <size_t WORDS>
+struct SortEntry {
+  uint64_t prefix[WORDS];
+  storage::Tuple *tuple;
+};
+
+template <size_t WORDS>
+inline uint8_t GetPrefixByte(const SortEntry<WORDS> &entry, size_t byte_itr) {
+  return static_cast<uint8_t>(entry.prefix[byte_itr / 8] >>
+                              (56 - 8 * (byte_itr % 8)));
+}
+
+template <size_t WORDS>
+inline int ComparePrefix(const SortEntry<WORDS> &a, const SortEntry<WORDS> &b) {
+  for (size_t word_itr = 0; word_itr < WORDS; word_itr++) {
+    if (a.prefix[word_itr] != b.prefix[word_itr]) {
+      return (a.prefix[word_itr] < b.prefix[word_itr]) ? -1 : 1;
+    }
+  }
+  return 0;
+}
+
+/**
+ * @brief MSD radix sort of the entries on their prefix bytes, starting with
+ * the given byte. The bytes before it are equal for all entries.
+ */
+template <size_t WORDS>
+void RadixSort(SortEntry<WORDS> *begin, SortEntry<WORDS> *end,
+               SortEntry<WORDS> *scratch, size_t byte_itr,
+               const TupleSorter &sorter) {
+  size_t count = end - begin;
+
+  // Tuples only have to be compared when their prefixes tie
+  auto compare = [&sorter](const SortEntry<WORDS> &a,
+                           const SortEntry<WORDS> &b) {
+    int prefix_compare = ComparePrefix(a, b);
+    if (prefix_compare != 0) return prefix_compare < 0;
+    return sorter.IsPrefixComplete() == false && sorter(a.tuple, b.tuple);
+  };
+
+  if (count <= radix_sort_threshold || byte_itr == WORDS * 8) {
+    if (byte_itr < WORDS * 8 || sorter.IsPrefixComplete() == false) {
+      std::sort(begin, end, compare);
+    }
+    return;
+  }
+
+  size_t bucket_sizes[256] = {0};
+  for (auto entry = begin; entry != end; entry++) {
+    bucket_sizes[GetPrefixByte(*entry, byte_itr)]++;
+  }
+
+  // Skip bytes that are the same for all entries
+  if (bucket_sizes[GetPrefixByte(*begin, byte_itr)] == count) {
+    RadixSort(begin, end, scratch, byte_itr + 1, sorter);
+    return;
+  }
+
+  size_t bucket_offsets[256];
+  size_t offset = 0;
+  for (size_t bucket_itr = 0; bucket_itr < 256; bucket_itr++) {
+    bucket_offsets[bucket_itr] = offset;
+    offset += bucket_sizes[bucket_itr];
+  }
+
+  for (auto entry = begin; entry != end; entry++) {
+    scratch[bucket_offsets[GetPrefixByte(*entry, byte_itr)]++] = *entry;
+  }
+  std::copy(scratch, scratch + count, begin);
+
+  offset = 0;
+  for (size_t bucket_itr = 0; bucket_itr < 256; bucket_itr++) {
+    if (bucket_sizes[bucket_itr] > 1) {
+      RadixSort(begin + offset, begin + offset + bucket_sizes[bucket_itr],
+                scratch, byte_itr + 1, sorter);
+    }
+    offset += bucket_sizes[bucket_itr];
+  }
+}
+
+}  // namespace
+
+TupleSorter::TupleSorter(const catalog::Schema *schema,
+                         const std::vector<oid_t> &sort_keys,
+                         const std::vector<bool> &descend_flags)
+    : sort_keys_(sort_keys), descend_flags_(descend_flags) {
+  assert(sort_keys_.size() == descend_flags_.size());
+
+  // Encode the leading keys that fit, up to the first string
+  size_t prefix_length = 0;
+  is_prefix_complete_ = true;
+  for (oid_t key_itr = 0; key_itr < sort_keys_.size(); key_itr++) {
+    auto type = schema->GetType(sort_keys_[key_itr]);
+    if (index::KeyNormalizer::IsEncodable(type) == false) {
+      is_prefix_complete_ = false;
+      break;
+    }
+
+    size_t length = index::KeyNormalizer::GetColumnLength(type);
+    if (prefix_length + length > max_prefix_word_count * 8) {
+      is_prefix_complete_ = false;
+      break;
+    }
+
+    prefix_keys_.push_back(
+        {sort_keys_[key_itr], type, descend_flags_[key_itr], length});
+    prefix_length += length;
+
+    // Strings are cut off in the prefix
+    if (index::KeyNormalizer::IsString(type) == true) {
+      is_prefix_complete_ = false;
+      break;
+    }
+  }
+
+  prefix_word_count_ = (prefix_length + 7) / 8;
+}
+
+void TupleSorter::Sort(std::vector<std::unique_ptr<storage::Tuple>> &tuples)
+    const {
+  switch (prefix_word_count_) {
+    case 0:
+      std::sort(tuples.begin(), tuples.end(),
+                [this](const std::unique_ptr<storage::Tuple> &ta,
+                       const std::unique_ptr<storage::Tuple> &tb) {
+        return (*this)(ta.get(), tb.get());
+      });
+      break;
+    case 1:
+      SortWithPrefix<1>(tuples);
+      break;
+    case 2:
+      SortWithPrefix<2>(tuples);
+      break;
+    case 3:
+      SortWithPrefix<3>(tuples);
+      break;
+    case 4:
+      SortWithPrefix<4>(tuples);
+      break;
+    default:
+      assert(false);
+  }
+}
+
+template <size_t WORDS>
+void TupleSorter::SortWithPrefix(
+    std::vector<std::unique_ptr<storage::Tuple>> &tuples) const {
+  if (tuples.size() < 2) return;
+
+  // Normalized keys in a contiguous buffer
+  std::vector<SortEntry<WORDS>> entries(tuples.size());
+  uint8_t prefix[WORDS * 8];
+  for (size_t tuple_itr = 0; tuple_itr < tuples.size(); tuple_itr++) {
+    auto &entry = entries[tuple_itr];
+    EncodePrefix(tuples[tuple_itr].get(), prefix);
+    for (size_t word_itr = 0; word_itr < WORDS; word_itr++) {
+      entry.prefix[word_itr] = LoadBigEndian(prefix + word_itr * 8);
+    }
+    entry.tuple = tuples[tuple_itr].get();
+  }
+
+  std::vector<SortEntry<WORDS>> scratch(entries.size());
+  RadixSort(entries.data(), entries.data() + entries.size(), scratch.data(),
+            0, *this);
+
+  // Move the tuples into sort order
+  for (auto &tuple : tuples) {
+    tuple.release();
+  }
+  for (size_t tuple_itr = 0; tuple_itr < tuples.size(); tuple_itr++) {
+    tuples[tuple_itr].reset(entries[tuple_itr].tuple);
+  }
+}
+
+bool TupleSorter::operator()(const AbstractTuple *ta,
+                             const AbstractTuple *tb) const {
+  for (oid_t id = 0; id < sort_keys_.size(); id++) {
+    int compare =
+        ta->GetValue(sort_keys_[id]).Compare(tb->GetValue(sort_keys_[id]));
+    if (compare != VALUE_COMPARE_EQUAL) {
+      return descend_flags_[id] ? (compare > 0) : (compare < 0);
+    }
+  }
+  return false;  // Will return false if all keys equal
+}
+
+void TupleSorter::EncodePrefix(const AbstractTuple *tuple,
+                               uint8_t *prefix) const {
+  ::memset(prefix, 0, GetPrefixSize());
+
+  for (auto &key : prefix_keys_) {
+    index::KeyNormalizer::EncodeColumn(tuple->GetValue(key.column_id),
+                                       key.type,
+                                       reinterpret_cast<char *>(prefix));
+
+    if (key.descend) {
+      for (size_t byte_itr = 0; byte_itr < key.length; byte_itr++) {
+        prefix[byte_itr] = ~prefix[byte_itr];
+      }
+    }
+
+    prefix += key.length;
+  }
+}
+
+}  // namespace executor
+}  // namespace peloton
@@ -0,0 +1,104 @@
+//===----------------------------------------------------------------------===//
+//
+//                         PelotonDB
+//
+// tuple_sorter.h
+//
+// Identification: src/backend/executor/tuple_sorter.h
+//
+// Copyright (c) 2015, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "backend/common/types.h"
+
+namespace peloton {
+
+class AbstractTuple;
+
+namespace catalog {
+class Schema;
+}
+
+namespace storage {
+class Tuple;
+}
+
+namespace executor {
+
+/**
+ * @brief Sorts tuples on a list of sort keys, for the sort based executors.
+ *
+ * The sort keys of every tuple are first encoded into a normalized key, a
+ * fixed width prefix of up to 32 bytes whose unsigned byte order is the sort
+ * order: every key is encoded like an index key by index::KeyNormalizer,
+ * inverted for descending keys. The (prefix, tuple) pairs are then sorted
+ * with an MSD radix sort on the prefix bytes, falling back to std::sort for
+ * small buckets. Tuples are only compared key by key when their prefixes
+ * tie and the prefix does not hold all of the sort keys (strings and types
+ * without an encoding end it).
+ *
+ * NULL comes before any other value, and after it for descending keys.
+ */
+class TupleSorter {
+ public:
+  TupleSorter(const TupleSorter &) = delete;
+  TupleSorter &operator=(const TupleSorter &) = delete;
+  TupleSorter(TupleSorter &&) = delete;
+  TupleSorter &operator=(TupleSorter &&) = delete;
+
+  TupleSorter(const catalog::Schema *schema,
+              const std::vector<oid_t> &sort_keys,
+              const std::vector<bool> &descend_flags);
+
+  // Sort the tuples in place
+  void Sort(std::vector<std::unique_ptr<storage::Tuple>> &tuples) const;
+
+  // Less-than comparer on the sort keys, NOT an equality comparer
+  bool operator()(const AbstractTuple *ta, const AbstractTuple *tb) const;
+
+  // Get the length of the normalized key prefix in bytes
+  size_t GetPrefixSize() const { return prefix_word_count_ * sizeof(uint64_t); }
+
+  // Whether the prefix holds all of the sort keys, so that tuples with
+  // equal prefixes are equal
+  bool IsPrefixComplete() const { return is_prefix_complete_; }
+
+  // Encode the sort keys of the tuple into a prefix of GetPrefixSize() bytes
+  void EncodePrefix(const AbstractTuple *tuple, uint8_t *prefix) const;
+
+ private:
+  template <size_t WORDS>
+  void SortWithPrefix(std::vector<std::unique_ptr<storage::Tuple>> &tuples)
+      const;
+
+  /** @brief Sort key in the prefix */
+  struct PrefixKey {
+    oid_t column_id;
+    ValueType type;
+    bool descend;
+
+    // bytes of the NULL flag and the value
+    size_t length;
+  };
+
+  std::vector<oid_t> sort_keys_;
+
+  std::vector<bool> descend_flags_;
+
+  /** @brief Leading sort keys encoded in the prefix */
+  std::vector<PrefixKey> prefix_keys_;
+
+  size_t prefix_word_count_ = 0;
+
+  bool is_prefix_complete_ = false;
+};
+
+}  // namespace executor
+}  // namespace peloton
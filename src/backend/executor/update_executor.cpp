@@ -24,6 +24,9 @@
 #include "backend/concurrency/transaction_manager.h"
 #include "backend/storage/data_table.h"
 #include "backend/storage/tile.h"
+#include "backend/storage/tile_group.h"
+#include "backend/storage/tile_group_header.h"
+#include "backend/storage/tuple.h"
 
 namespace peloton {
 namespace executor {
@@ -53,6 +56,103 @@ bool UpdateExecutor::DInit() {
   assert(target_table_);
   assert(project_info_);
 
+  // Find out the columns modified by the projection.
+  // The remaining columns are mapped to themselves.
+  in_place_update_ = true;
+  updated_column_ids_.clear();
+
+  for (auto &target : project_info_->GetTargetList()) {
+    updated_column_ids_.push_back(target.first);
+  }
+
+  for (auto &dm : project_info_->GetDirectMapList()) {
+    auto tuple_index = dm.second.first;
+    auto src_col_id = dm.second.second;
+    if (tuple_index != 0) {
+      in_place_update_ = false;
+    } else if (dm.first != src_col_id) {
+      updated_column_ids_.push_back(dm.first);
+    }
+  }
+
+  LOG_TRACE("Update in place : %d", in_place_update_);
+
+  return true;
+}
+
+/**
+ * @brief Overwrite the modified columns of a tuple in its slot.
+ * Only the new values of the modified columns are computed, the old values
+ * are kept by the tile group to serve older snapshots.
+ * @return true on success, false otherwise.
+ */
+bool UpdateExecutor::UpdateInPlace(concurrency::Transaction *transaction,
+                                   storage::TileGroup *tile_group,
+                                   oid_t physical_tuple_id) {
+  expression::ContainerTuple<storage::TileGroup> old_tuple(tile_group,
+                                                           physical_tuple_id);
+
+  // (A) Execute the projections of the modified columns
+  std::vector<Value> values;
+  values.reserve(updated_column_ids_.size());
+
+  for (auto &target : project_info_->GetTargetList()) {
+    values.push_back(
+        target.second->Evaluate(&old_tuple, nullptr, executor_context_));
+  }
+
+  for (auto &dm : project_info_->GetDirectMapList()) {
+    if (dm.first != dm.second.second) {
+      values.push_back(old_tuple.GetValue(dm.second.second));
+    }
+  }
+
+  // (B) Overwrite the tuple, recorded first so that an abort restores it
+  // even if the new key turns out to be taken
+  auto location = ItemPointer(tile_group->GetTileGroupId(), physical_tuple_id);
+  transaction->RecordUpdate(location);
+
+  bool status = target_table_->UpdateTuple(transaction, location,
+                                           updated_column_ids_, values);
+  if (status == false) {
+    // We still hold the tuple if the new key was taken or the tuple was
+    // deleted by ourselves
+    if (tile_group->GetHeader()->IsWriteConflict(
+            physical_tuple_id, transaction->GetTransactionId())) {
+      LOG_INFO("Fail to update tuple in place. Set txn aborted.");
+      transaction->SetResult(Result::RESULT_ABORTED);
+    } else {
+      LOG_INFO("Fail to update tuple in place. Set txn failure.");
+      transaction->SetResult(Result::RESULT_FAILURE);
+    }
+    return false;
+  }
+
+  executor_context_->num_processed += 1;  // updated one
+
+  // Logging
+  {
+    auto &log_manager = logging::LogManager::GetInstance();
+
+    if (log_manager.IsInLoggingMode()) {
+      auto schema = target_table_->GetSchema();
+      std::unique_ptr<storage::Tuple> new_tuple(
+          new storage::Tuple(schema, true));
+      for (oid_t column_itr = 0; column_itr < schema->GetColumnCount();
+           column_itr++) {
+        new_tuple->SetValue(column_itr, old_tuple.GetValue(column_itr),
+                            executor_context_->GetExecutorContextPool());
+      }
+
+      auto logger = log_manager.GetBackendLogger();
+      auto record = logger->GetTupleRecord(
+          LOGRECORD_TYPE_TUPLE_UPDATE, transaction->GetTransactionId(),
+          target_table_->GetOid(), location, location, new_tuple.get());
+
+      logger->Log(record);
+    }
+  }
+
   return true;
 }
 
@@ -77,6 +177,14 @@ bool UpdateExecutor::DExecute() {
   storage::Tile *tile = source_tile->GetBaseTile(0);
   storage::TileGroup *tile_group = tile->GetTileGroup();
   auto transaction_ = executor_context_->GetTransaction();
+
+  // Older versions of tuples updated in place by a concurrent transaction
+  if (tile_group == nullptr) {
+    LOG_INFO("Tuples have been updated concurrently. Set txn aborted.");
+    transaction_->SetResult(Result::RESULT_ABORTED);
+    return false;
+  }
+
   auto tile_group_id = tile_group->GetTileGroupId();
 
   // Update tuples in given table
@@ -85,12 +193,24 @@ bool UpdateExecutor::DExecute() {
     LOG_INFO("Visible Tuple id : %lu, Physical Tuple id : %lu ",
              visible_tuple_id, physical_tuple_id);
 
+    if (in_place_update_) {
+      if (UpdateInPlace(transaction_, tile_group, physical_tuple_id) == false)
+        return false;
+      continue;
+    }
+
     // (A) Try to delete the tuple first
     auto delete_location = ItemPointer(tile_group_id, physical_tuple_id);
     bool status = target_table_->DeleteTuple(transaction_, delete_location);
     if (status == false) {
-      LOG_INFO("Fail to delete old tuple. Set txn failure.");
-      transaction_->SetResult(Result::RESULT_FAILURE);
+      if (tile_group->GetHeader()->IsWriteConflict(
+              physical_tuple_id, transaction_->GetTransactionId())) {
+        LOG_INFO("Fail to delete old tuple. Set txn aborted.");
+        transaction_->SetResult(Result::RESULT_ABORTED);
+      } else {
+        LOG_INFO("Fail to delete old tuple. Set txn failure.");
+        transaction_->SetResult(Result::RESULT_FAILURE);
+      }
       return false;
     }
     transaction_->RecordDelete(delete_location);
@@ -19,6 +19,15 @@
 #include "backend/planner/update_plan.h"
 
 namespace peloton {
+
+namespace concurrency {
+class Transaction;
+}
+
+namespace storage {
+class TileGroup;
+}
+
 namespace executor {
 
 class UpdateExecutor : public AbstractExecutor {
@@ -35,8 +44,18 @@ class UpdateExecutor : public AbstractExecutor {
   bool DExecute();
 
  private:
+  bool UpdateInPlace(concurrency::Transaction *transaction,
+                     storage::TileGroup *tile_group, oid_t physical_tuple_id);
+
   storage::DataTable *target_table_ = nullptr;
   const planner::ProjectInfo *project_info_ = nullptr;
+
+  /** @brief Columns modified by the projection */
+  std::vector<oid_t> updated_column_ids_;
+
+  /** @brief Update tuples in place unless the projection reads from
+   * another tuple */
+  bool in_place_update_ = false;
 };
 
 }  // namespace executor
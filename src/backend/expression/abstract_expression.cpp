@@ -19,7 +19,9 @@
 #include "backend/common/types.h"
 #include "backend/expression/expression_util.h"
 #include "backend/expression/abstract_expression.h"
+#include "backend/expression/container_tuple.h"
 #include "backend/executor/executor_context.h"
+#include "backend/storage/tile_group.h"
 
 namespace peloton {
 namespace expression {
@@ -43,6 +45,27 @@ AbstractExpression::~AbstractExpression() {
   delete m_right;
 }
 
+void AbstractExpression::EvaluateSelection(
+    storage::TileGroup *tile_group, std::vector<oid_t> &positions,
+    executor::ExecutorContext *context) const {
+  size_t selected_count = 0;
+  for (oid_t position : positions) {
+    ContainerTuple<storage::TileGroup> tuple(tile_group, position);
+    if (Evaluate(&tuple, nullptr, context).IsTrue()) {
+      positions[selected_count++] = position;
+    }
+  }
+  positions.resize(selected_count);
+}
+
+bool AbstractExpression::EvaluateVector(
+    __attribute__((unused)) storage::TileGroup *tile_group,
+    __attribute__((unused)) const std::vector<oid_t> &positions,
+    __attribute__((unused)) ValueVector &result,
+    __attribute__((unused)) executor::ExecutorContext *context) const {
+  return false;
+}
+
 bool AbstractExpression::HasParameter() const {
   if (m_left && m_left->HasParameter()) return true;
   return (m_right && m_right->HasParameter());
@@ -33,8 +33,14 @@ namespace executor {
 class ExecutorContext;
 }
 
+namespace storage {
+class TileGroup;
+}
+
 namespace expression {
 
+struct ValueVector;
+
 //===--------------------------------------------------------------------===//
 // AbstractExpression
 //===--------------------------------------------------------------------===//
@@ -62,6 +68,20 @@ class AbstractExpression : public Printable {
                          const AbstractTuple *tuple2,
                          executor::ExecutorContext *context) const = 0;
 
+  // Keep the positions of the tile group (in ascending order) for which the
+  // expression is true. Expressions with a batch kernel evaluate all
+  // positions at once, the others one tuple at a time.
+  virtual void EvaluateSelection(storage::TileGroup *tile_group,
+                                 std::vector<oid_t> &positions,
+                                 executor::ExecutorContext *context) const;
+
+  // Evaluate a numeric expression for all positions of the tile group at
+  // once. Returns false if the expression has no batch kernel.
+  virtual bool EvaluateVector(storage::TileGroup *tile_group,
+                              const std::vector<oid_t> &positions,
+                              ValueVector &result,
+                              executor::ExecutorContext *context) const;
+
   /** return true if self or descendent should be substitute()'d */
   virtual bool HasParameter() const;
 
@@ -17,6 +17,7 @@
 #include "backend/expression/parameter_value_expression.h"
 #include "backend/expression/constant_value_expression.h"
 #include "backend/expression/tuple_value_expression.h"
+#include "backend/expression/vectorized_kernels.h"
 
 #include <string>
 #include <cassert>
@@ -224,6 +225,15 @@ class ComparisonExpression : public AbstractExpression {
     return OP::compare_withoutNull(lnv, rnv);
   }
 
+  void EvaluateSelection(storage::TileGroup *tile_group,
+                         std::vector<oid_t> &positions,
+                         executor::ExecutorContext *context) const {
+    if (SelectComparison(m_type, m_left, m_right, tile_group, positions,
+                         context) == false) {
+      AbstractExpression::EvaluateSelection(tile_group, positions, context);
+    }
+  }
+
   inline const char *traceEval(const AbstractTuple *tuple1,
                                const AbstractTuple *tuple2,
                                executor::ExecutorContext *context) const {
@@ -15,6 +15,7 @@
 #include "backend/common/serializer.h"
 
 #include "backend/expression/abstract_expression.h"
+#include "backend/expression/vectorized_kernels.h"
 
 #include <string>
 
@@ -37,6 +38,13 @@ class ConjunctionExpression : public AbstractExpression {
   Value Evaluate(const AbstractTuple *tuple1, const AbstractTuple *tuple2,
                  executor::ExecutorContext *context) const;
 
+  void EvaluateSelection(storage::TileGroup *tile_group,
+                         std::vector<oid_t> &positions,
+                         executor::ExecutorContext *context) const {
+    SelectConjunction(m_type, m_left, m_right, tile_group, positions,
+                      context);
+  }
+
   std::string DebugInfo(const std::string &spacer) const {
     return (spacer + "ConjunctionExpression\n");
   }
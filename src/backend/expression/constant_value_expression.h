@@ -13,6 +13,7 @@
 #pragma once
 
 #include "backend/expression/abstract_expression.h"
+#include "backend/expression/vectorized_kernels.h"
 #include "backend/common/value_factory.h"
 
 #include <string>
@@ -44,6 +45,13 @@ class ConstantValueExpression : public AbstractExpression {
     return this->value;
   }
 
+  bool EvaluateVector(__attribute__((unused)) storage::TileGroup *tile_group,
+                      const std::vector<oid_t> &positions, ValueVector &result,
+                      __attribute__((unused))
+                      executor::ExecutorContext *context) const {
+    return BroadcastValue(value, positions.size(), result);
+  }
+
   std::string DebugInfo(const std::string &spacer) const {
     return spacer + "OptimizedConstantValueExpression:" + value.GetInfo().c_str() + "\n";
   }
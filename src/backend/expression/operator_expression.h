@@ -15,6 +15,7 @@
 #include "backend/common/serializer.h"
 
 #include "backend/expression/abstract_expression.h"
+#include "backend/expression/vectorized_kernels.h"
 
 #include <string>
 #include <cassert>
@@ -72,6 +73,15 @@ class OperatorIsNullExpression : public AbstractExpression {
     }
   }
 
+  void EvaluateSelection(storage::TileGroup *tile_group,
+                         std::vector<oid_t> &positions,
+                         executor::ExecutorContext *context) const {
+    assert(m_left);
+    if (SelectIsNull(m_left, tile_group, positions, context) == false) {
+      AbstractExpression::EvaluateSelection(tile_group, positions, context);
+    }
+  }
+
   std::string DebugInfo(const std::string &spacer) const {
     return (spacer + "OperatorIsNullExpression");
   }
@@ -202,6 +212,19 @@ class OperatorExpression : public AbstractExpression {
                    m_right->Evaluate(tuple1, tuple2, context));
   }
 
+  bool EvaluateVector(storage::TileGroup *tile_group,
+                      const std::vector<oid_t> &positions, ValueVector &result,
+                      executor::ExecutorContext *context) const {
+    assert(m_left);
+    assert(m_right);
+    ValueVector left_values, right_values;
+    return m_left->EvaluateVector(tile_group, positions, left_values,
+                                  context) &&
+           m_right->EvaluateVector(tile_group, positions, right_values,
+                                   context) &&
+           ComputeArithmetic(m_type, left_values, right_values, result);
+  }
+
   std::string DebugInfo(const std::string &spacer) const {
     return (spacer + "OptimizedOperatorExpression");
   }
@@ -12,6 +12,7 @@
 
 #include "backend/common/logger.h"
 #include "backend/expression/parameter_value_expression.h"
+#include "backend/expression/vectorized_kernels.h"
 #include "backend/executor/executor_context.h"
 
 namespace peloton {
@@ -34,5 +35,13 @@ Value ParameterValueExpression::Evaluate(
   return params[m_valueIdx];
 }
 
+bool ParameterValueExpression::EvaluateVector(
+    __attribute__((unused)) storage::TileGroup *tile_group,
+    const std::vector<oid_t> &positions, ValueVector &result,
+    executor::ExecutorContext *context) const {
+  return BroadcastValue(Evaluate(nullptr, nullptr, context), positions.size(),
+                        result);
+}
+
 }  // End expression namespace
 }  // End peloton namespace
@@ -39,6 +39,10 @@ class ParameterValueExpression : public AbstractExpression {
                  __attribute__((unused)) const AbstractTuple *tuple2,
                  executor::ExecutorContext *context) const;
 
+  bool EvaluateVector(storage::TileGroup *tile_group,
+                      const std::vector<oid_t> &positions, ValueVector &result,
+                      executor::ExecutorContext *context) const;
+
   bool HasParameter() const {
     // this class represents a parameter.
     return true;
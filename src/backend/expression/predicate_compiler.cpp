@@ -0,0 +1,735 @@
+//===----------------------------------------------------------------------===//
+//
+//                         PelotonDB
+//
+// predicate_compiler.cpp
+//
+// Identification: src/backend/expression/predicate_compiler.cpp
+//
+// Copyright (c) 2015, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "backend/expression/predicate_compiler.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+#include <iterator>
+#include <string>
+#include <utility>
+
+#include "backend/catalog/schema.h"
+#include "backend/common/logger.h"
+#include "backend/common/value_peeker.h"
+#include "backend/expression/abstract_expression.h"
+#include "backend/expression/tuple_value_expression.h"
+#include "backend/expression/vector_expression.h"
+#include "backend/expression/vectorized_kernels.h"
+#include "backend/storage/tile_group.h"
+
+namespace peloton {
+namespace expression {
+
+namespace {
+
+//===--------------------------------------------------------------------===//
+// Constants
+//===--------------------------------------------------------------------===//
+
+template <typename C>
+C ConstantAs(const Value &value);
+
+template <>
+int64_t ConstantAs<int64_t>(const Value &value) {
+  return ValuePeeker::PeekAsBigInt(value);
+}
+
+template <>
+double ConstantAs<double>(const Value &value) {
+  return ValuePeeker::PeekDouble(value.CastAs(VALUE_TYPE_DOUBLE));
+}
+
+/**
+ * @brief Get the type a numeric column and its constants compare as, DOUBLE
+ * if any of them is one and BIGINT otherwise.
+ * @return false if there is no kernel for the types.
+ */
+bool GetCompareType(ValueType column_type, const std::vector<Value> &constants,
+                    bool &as_double) {
+  if (IsNumericType(column_type) == false) return false;
+
+  as_double = (column_type == VALUE_TYPE_DOUBLE);
+  bool timestamp = (column_type == VALUE_TYPE_TIMESTAMP);
+  for (auto &constant : constants) {
+    if (IsNumericType(constant.GetValueType()) == false) return false;
+    as_double |= (constant.GetValueType() == VALUE_TYPE_DOUBLE);
+    timestamp |= (constant.GetValueType() == VALUE_TYPE_TIMESTAMP);
+  }
+
+  return (as_double && timestamp) == false;
+}
+
+inline oid_t GetColumnId(const AbstractExpression *column) {
+  return static_cast<const TupleValueExpression *>(column)->GetColumnId();
+}
+
+//===--------------------------------------------------------------------===//
+// Predicates
+//===--------------------------------------------------------------------===//
+
+class InterpretedPredicate : public CompiledPredicate {
+ public:
+  explicit InterpretedPredicate(const AbstractExpression *predicate)
+      : predicate_(predicate) {}
+
+  void Select(storage::TileGroup *tile_group, std::vector<oid_t> &positions,
+              executor::ExecutorContext *context) const {
+    predicate_->EvaluateSelection(tile_group, positions, context);
+  }
+
+ private:
+  const AbstractExpression *predicate_;
+};
+
+// A comparison with NULL, never true
+class FalsePredicate : public CompiledPredicate {
+ public:
+  void Select(__attribute__((unused)) storage::TileGroup *tile_group,
+              std::vector<oid_t> &positions,
+              __attribute__((unused))
+              executor::ExecutorContext *context) const {
+    positions.clear();
+  }
+};
+
+class AndPredicate : public CompiledPredicate {
+ public:
+  explicit AndPredicate(std::vector<std::unique_ptr<CompiledPredicate>> &&
+                            operands)
+      : operands_(std::move(operands)) {}
+
+  void Select(storage::TileGroup *tile_group, std::vector<oid_t> &positions,
+              executor::ExecutorContext *context) const {
+    for (auto &operand : operands_) {
+      if (positions.empty()) break;
+      operand->Select(tile_group, positions, context);
+    }
+  }
+
+ private:
+  std::vector<std::unique_ptr<CompiledPredicate>> operands_;
+};
+
+// Every operand only runs over the positions the ones before did not select
+class OrPredicate : public CompiledPredicate {
+ public:
+  explicit OrPredicate(std::vector<std::unique_ptr<CompiledPredicate>> &&
+                           operands)
+      : operands_(std::move(operands)) {}
+
+  void Select(storage::TileGroup *tile_group, std::vector<oid_t> &positions,
+              executor::ExecutorContext *context) const {
+    std::vector<oid_t> selected_positions, operand_positions,
+        merged_positions;
+
+    for (auto &operand : operands_) {
+      if (positions.empty()) break;
+
+      operand_positions = positions;
+      operand->Select(tile_group, operand_positions, context);
+      if (operand_positions.empty()) continue;
+
+      merged_positions.clear();
+      std::merge(selected_positions.begin(), selected_positions.end(),
+                 operand_positions.begin(), operand_positions.end(),
+                 std::back_inserter(merged_positions));
+      selected_positions.swap(merged_positions);
+
+      auto end = std::set_difference(
+          positions.begin(), positions.end(), operand_positions.begin(),
+          operand_positions.end(), positions.begin());
+      positions.erase(end, positions.end());
+    }
+
+    positions.swap(selected_positions);
+  }
+
+ private:
+  std::vector<std::unique_ptr<CompiledPredicate>> operands_;
+};
+
+template <typename T, typename C, typename CMP>
+class ColumnConstantPredicate : public CompiledPredicate {
+ public:
+  ColumnConstantPredicate(oid_t column_id, const Value &constant)
+      : column_id_(column_id), constant_(ConstantAs<C>(constant)) {}
+
+  void Select(storage::TileGroup *tile_group, std::vector<oid_t> &positions,
+              __attribute__((unused))
+              executor::ExecutorContext *context) const {
+    ColumnLayout column;
+    GetColumnLayout(tile_group, column_id_, column);
+    SelectColumnConstantKernel<T, C, CMP>(column, constant_, positions);
+  }
+
+ private:
+  oid_t column_id_;
+  C constant_;
+};
+
+template <typename T, typename C, typename LOWER, typename UPPER>
+class ColumnRangePredicate : public CompiledPredicate {
+ public:
+  ColumnRangePredicate(oid_t column_id, const Value &lower, const Value &upper)
+      : column_id_(column_id),
+        lower_(ConstantAs<C>(lower)),
+        upper_(ConstantAs<C>(upper)) {}
+
+  void Select(storage::TileGroup *tile_group, std::vector<oid_t> &positions,
+              __attribute__((unused))
+              executor::ExecutorContext *context) const {
+    ColumnLayout column;
+    GetColumnLayout(tile_group, column_id_, column);
+
+    LOWER lower_compare;
+    UPPER upper_compare;
+    size_t selected_count = 0;
+    for (oid_t position : positions) {
+      T value = ReadColumn<T>(column, position);
+      positions[selected_count] = position;
+      selected_count += (IsNullValue(value) == false) &
+                        lower_compare(static_cast<C>(value), lower_) &
+                        upper_compare(static_cast<C>(value), upper_);
+    }
+    positions.resize(selected_count);
+  }
+
+ private:
+  oid_t column_id_;
+  C lower_;
+  C upper_;
+};
+
+template <typename T, typename C>
+class ColumnInListPredicate : public CompiledPredicate {
+ public:
+  ColumnInListPredicate(oid_t column_id, const std::vector<Value> &values)
+      : column_id_(column_id) {
+    for (auto &value : values) {
+      values_.push_back(ConstantAs<C>(value));
+    }
+    std::sort(values_.begin(), values_.end());
+    values_.erase(std::unique(values_.begin(), values_.end()), values_.end());
+  }
+
+  void Select(storage::TileGroup *tile_group, std::vector<oid_t> &positions,
+              __attribute__((unused))
+              executor::ExecutorContext *context) const {
+    ColumnLayout column;
+    GetColumnLayout(tile_group, column_id_, column);
+
+    size_t selected_count = 0;
+    for (oid_t position : positions) {
+      T value = ReadColumn<T>(column, position);
+      positions[selected_count] = position;
+      selected_count +=
+          (IsNullValue(value) == false) &&
+          std::binary_search(values_.begin(), values_.end(),
+                             static_cast<C>(value));
+    }
+    positions.resize(selected_count);
+  }
+
+ private:
+  oid_t column_id_;
+
+  /** @brief Distinct values of the list, in ascending order */
+  std::vector<C> values_;
+};
+
+template <typename T, typename CMP>
+class ColumnColumnPredicate : public CompiledPredicate {
+ public:
+  ColumnColumnPredicate(oid_t left_column_id, oid_t right_column_id)
+      : left_column_id_(left_column_id), right_column_id_(right_column_id) {}
+
+  void Select(storage::TileGroup *tile_group, std::vector<oid_t> &positions,
+              __attribute__((unused))
+              executor::ExecutorContext *context) const {
+    ColumnLayout left_column, right_column;
+    GetColumnLayout(tile_group, left_column_id_, left_column);
+    GetColumnLayout(tile_group, right_column_id_, right_column);
+
+    CMP compare;
+    size_t selected_count = 0;
+    for (oid_t position : positions) {
+      T left = ReadColumn<T>(left_column, position);
+      T right = ReadColumn<T>(right_column, position);
+      positions[selected_count] = position;
+      selected_count += (IsNullValue(left) == false) &
+                        (IsNullValue(right) == false) & compare(left, right);
+    }
+    positions.resize(selected_count);
+  }
+
+ private:
+  oid_t left_column_id_;
+  oid_t right_column_id_;
+};
+
+// Compares the same way as Value does for VARCHAR, without building one
+template <typename CMP>
+class StringColumnConstantPredicate : public CompiledPredicate {
+ public:
+  StringColumnConstantPredicate(oid_t column_id, bool inlined,
+                                const Value &constant)
+      : column_id_(column_id),
+        inlined_(inlined),
+        constant_(static_cast<const char *>(
+                      ValuePeeker::PeekObjectValueWithoutNull(constant)),
+                  ValuePeeker::PeekObjectLengthWithoutNull(constant)) {}
+
+  void Select(storage::TileGroup *tile_group, std::vector<oid_t> &positions,
+              __attribute__((unused))
+              executor::ExecutorContext *context) const {
+    ColumnLayout column;
+    GetColumnLayout(tile_group, column_id_, column);
+
+    CMP compare;
+    size_t selected_count = 0;
+    for (oid_t position : positions) {
+      auto value = Value::InitFromTupleStorage(
+          column.base + position * column.stride, VALUE_TYPE_VARCHAR,
+          inlined_);
+      if (value.IsNull()) continue;
+
+      auto data = static_cast<const char *>(
+          ValuePeeker::PeekObjectValueWithoutNull(value));
+      int32_t length = ValuePeeker::PeekObjectLengthWithoutNull(value);
+      int32_t constant_length = constant_.size();
+      int result = ::strncmp(data, constant_.data(),
+                             std::min(length, constant_length));
+      if (result == 0) result = length - constant_length;
+
+      if (compare(result, 0)) positions[selected_count++] = position;
+    }
+    positions.resize(selected_count);
+  }
+
+ private:
+  oid_t column_id_;
+  bool inlined_;
+  std::string constant_;
+};
+
+//===--------------------------------------------------------------------===//
+// Instantiation
+//===--------------------------------------------------------------------===//
+
+// Instantiate the predicate for the storage type of the column and the type
+// its constants compare as
+template <template <typename, typename> class PREDICATE, typename... Args>
+CompiledPredicate *MakeColumnPredicate(ValueType column_type, bool as_double,
+                                       Args &&... args) {
+  if (as_double) {
+    switch (column_type) {
+      case VALUE_TYPE_TINYINT:
+        return new PREDICATE<int8_t, double>(std::forward<Args>(args)...);
+      case VALUE_TYPE_SMALLINT:
+        return new PREDICATE<int16_t, double>(std::forward<Args>(args)...);
+      case VALUE_TYPE_INTEGER:
+        return new PREDICATE<int32_t, double>(std::forward<Args>(args)...);
+      case VALUE_TYPE_BIGINT:
+        return new PREDICATE<int64_t, double>(std::forward<Args>(args)...);
+      case VALUE_TYPE_DOUBLE:
+        return new PREDICATE<double, double>(std::forward<Args>(args)...);
+      default:
+        return nullptr;
+    }
+  }
+
+  switch (column_type) {
+    case VALUE_TYPE_TINYINT:
+      return new PREDICATE<int8_t, int64_t>(std::forward<Args>(args)...);
+    case VALUE_TYPE_SMALLINT:
+      return new PREDICATE<int16_t, int64_t>(std::forward<Args>(args)...);
+    case VALUE_TYPE_INTEGER:
+      return new PREDICATE<int32_t, int64_t>(std::forward<Args>(args)...);
+    case VALUE_TYPE_BIGINT:
+    case VALUE_TYPE_TIMESTAMP:
+      return new PREDICATE<int64_t, int64_t>(std::forward<Args>(args)...);
+    default:
+      return nullptr;
+  }
+}
+
+template <typename CMP>
+struct ColumnConstant {
+  template <typename T, typename C>
+  using Predicate = ColumnConstantPredicate<T, C, CMP>;
+
+  static CompiledPredicate *Make(const catalog::Schema *schema,
+                                 oid_t column_id, const Value &constant) {
+    auto column_type = schema->GetType(column_id);
+
+    if (column_type == VALUE_TYPE_VARCHAR) {
+      if (constant.GetValueType() != VALUE_TYPE_VARCHAR) return nullptr;
+      return new StringColumnConstantPredicate<CMP>(
+          column_id, schema->IsInlined(column_id), constant);
+    }
+
+    bool as_double;
+    if (GetCompareType(column_type, {constant}, as_double) == false) {
+      return nullptr;
+    }
+    return MakeColumnPredicate<Predicate>(column_type, as_double, column_id,
+                                          constant);
+  }
+};
+
+template <typename CMP>
+struct ColumnColumn {
+  static CompiledPredicate *Make(const catalog::Schema *schema,
+                                 oid_t left_column_id, oid_t right_column_id) {
+    auto column_type = schema->GetType(left_column_id);
+    if (column_type != schema->GetType(right_column_id)) return nullptr;
+
+    switch (column_type) {
+      case VALUE_TYPE_TINYINT:
+        return new ColumnColumnPredicate<int8_t, CMP>(left_column_id,
+                                                      right_column_id);
+      case VALUE_TYPE_SMALLINT:
+        return new ColumnColumnPredicate<int16_t, CMP>(left_column_id,
+                                                       right_column_id);
+      case VALUE_TYPE_INTEGER:
+        return new ColumnColumnPredicate<int32_t, CMP>(left_column_id,
+                                                       right_column_id);
+      case VALUE_TYPE_BIGINT:
+      case VALUE_TYPE_TIMESTAMP:
+        return new ColumnColumnPredicate<int64_t, CMP>(left_column_id,
+                                                       right_column_id);
+      case VALUE_TYPE_DOUBLE:
+        return new ColumnColumnPredicate<double, CMP>(left_column_id,
+                                                      right_column_id);
+      default:
+        return nullptr;
+    }
+  }
+};
+
+template <typename LOWER, typename UPPER>
+struct ColumnRange {
+  template <typename T, typename C>
+  using Predicate = ColumnRangePredicate<T, C, LOWER, UPPER>;
+};
+
+template <typename T, typename C>
+using ColumnInList = ColumnInListPredicate<T, C>;
+
+// Instantiate MAKER::Make with the comparator of the comparison
+template <template <typename> class MAKER, typename... Args>
+CompiledPredicate *MakeComparison(ExpressionType comparison, Args &&... args) {
+  switch (comparison) {
+    case EXPRESSION_TYPE_COMPARE_EQUAL:
+      return MAKER<CompareEqual>::Make(std::forward<Args>(args)...);
+    case EXPRESSION_TYPE_COMPARE_NOTEQUAL:
+      return MAKER<CompareNotEqual>::Make(std::forward<Args>(args)...);
+    case EXPRESSION_TYPE_COMPARE_LESSTHAN:
+      return MAKER<CompareLessThan>::Make(std::forward<Args>(args)...);
+    case EXPRESSION_TYPE_COMPARE_GREATERTHAN:
+      return MAKER<CompareGreaterThan>::Make(std::forward<Args>(args)...);
+    case EXPRESSION_TYPE_COMPARE_LESSTHANOREQUALTO:
+      return MAKER<CompareLessThanOrEqual>::Make(std::forward<Args>(args)...);
+    case EXPRESSION_TYPE_COMPARE_GREATERTHANOREQUALTO:
+      return MAKER<CompareGreaterThanOrEqual>::Make(
+          std::forward<Args>(args)...);
+    default:
+      return nullptr;
+  }
+}
+
+CompiledPredicate *MakeColumnRange(const catalog::Schema *schema,
+                                   oid_t column_id,
+                                   ExpressionType lower_comparison,
+                                   const Value &lower,
+                                   ExpressionType upper_comparison,
+                                   const Value &upper) {
+  auto column_type = schema->GetType(column_id);
+  bool as_double;
+  if (GetCompareType(column_type, {lower, upper}, as_double) == false) {
+    return nullptr;
+  }
+
+  bool lower_inclusive =
+      (lower_comparison == EXPRESSION_TYPE_COMPARE_GREATERTHANOREQUALTO);
+  bool upper_inclusive =
+      (upper_comparison == EXPRESSION_TYPE_COMPARE_LESSTHANOREQUALTO);
+
+  if (lower_inclusive && upper_inclusive) {
+    return MakeColumnPredicate<
+        ColumnRange<CompareGreaterThanOrEqual,
+                    CompareLessThanOrEqual>::template Predicate>(
+        column_type, as_double, column_id, lower, upper);
+  } else if (lower_inclusive) {
+    return MakeColumnPredicate<ColumnRange<
+        CompareGreaterThanOrEqual, CompareLessThan>::template Predicate>(
+        column_type, as_double, column_id, lower, upper);
+  } else if (upper_inclusive) {
+    return MakeColumnPredicate<ColumnRange<
+        CompareGreaterThan, CompareLessThanOrEqual>::template Predicate>(
+        column_type, as_double, column_id, lower, upper);
+  }
+  return MakeColumnPredicate<
+      ColumnRange<CompareGreaterThan, CompareLessThan>::template Predicate>(
+      column_type, as_double, column_id, lower, upper);
+}
+
+//===--------------------------------------------------------------------===//
+// Shapes
+//===--------------------------------------------------------------------===//
+
+bool IsColumnOf(const AbstractExpression *expression,
+                const catalog::Schema *schema) {
+  return IsColumn(expression) &&
+         GetColumnId(expression) < schema->GetColumnCount();
+}
+
+// Operands of nested conjunctions of the same type, a AND (b AND c)
+void FlattenConjunction(const AbstractExpression *predicate,
+                        ExpressionType conjunction,
+                        std::vector<const AbstractExpression *> &operands) {
+  if (predicate->GetExpressionType() == conjunction) {
+    FlattenConjunction(predicate->GetLeft(), conjunction, operands);
+    FlattenConjunction(predicate->GetRight(), conjunction, operands);
+  } else {
+    operands.push_back(predicate);
+  }
+}
+
+/**
+ * @brief One side of a range, a column compared with a constant.
+ */
+struct RangeBound {
+  size_t operand_itr;
+  oid_t column_id;
+  ExpressionType comparison;
+  Value constant;
+};
+
+// Get the bound if the operand compares a column with a constant, with the
+// column on the left
+bool GetRangeBound(const AbstractExpression *operand,
+                   const catalog::Schema *schema,
+                   executor::ExecutorContext *context, RangeBound &bound) {
+  auto comparison = operand->GetExpressionType();
+  if (comparison != EXPRESSION_TYPE_COMPARE_LESSTHAN &&
+      comparison != EXPRESSION_TYPE_COMPARE_LESSTHANOREQUALTO &&
+      comparison != EXPRESSION_TYPE_COMPARE_GREATERTHAN &&
+      comparison != EXPRESSION_TYPE_COMPARE_GREATERTHANOREQUALTO) {
+    return false;
+  }
+
+  auto left = operand->GetLeft();
+  auto right = operand->GetRight();
+  if (IsConstant(left) && IsColumnOf(right, schema)) {
+    std::swap(left, right);
+    comparison = FlipComparison(comparison);
+  } else if (IsColumnOf(left, schema) == false || IsConstant(right) == false) {
+    return false;
+  }
+
+  bound.column_id = GetColumnId(left);
+  bound.comparison = comparison;
+  bound.constant = right->Evaluate(nullptr, nullptr, context);
+  return bound.constant.IsNull() == false;
+}
+
+inline bool IsLowerBound(const RangeBound &bound) {
+  return bound.comparison == EXPRESSION_TYPE_COMPARE_GREATERTHAN ||
+         bound.comparison == EXPRESSION_TYPE_COMPARE_GREATERTHANOREQUALTO;
+}
+
+}  // namespace
+
+std::unique_ptr<CompiledPredicate> PredicateCompiler::Compile(
+    const AbstractExpression *predicate, const catalog::Schema *schema,
+    executor::ExecutorContext *context) {
+  assert(predicate != nullptr);
+  return std::unique_ptr<CompiledPredicate>(
+      CompileExpression(predicate, schema, context));
+}
+
+CompiledPredicate *PredicateCompiler::CompileExpression(
+    const AbstractExpression *predicate, const catalog::Schema *schema,
+    executor::ExecutorContext *context) {
+  CompiledPredicate *compiled = nullptr;
+
+  switch (predicate->GetExpressionType()) {
+    case EXPRESSION_TYPE_CONJUNCTION_AND:
+    case EXPRESSION_TYPE_CONJUNCTION_OR:
+      compiled = CompileConjunction(predicate, schema, context);
+      break;
+
+    case EXPRESSION_TYPE_COMPARE_EQUAL:
+    case EXPRESSION_TYPE_COMPARE_NOTEQUAL:
+    case EXPRESSION_TYPE_COMPARE_LESSTHAN:
+    case EXPRESSION_TYPE_COMPARE_GREATERTHAN:
+    case EXPRESSION_TYPE_COMPARE_LESSTHANOREQUALTO:
+    case EXPRESSION_TYPE_COMPARE_GREATERTHANOREQUALTO:
+      compiled = CompileComparison(predicate, schema, context);
+      break;
+
+    case EXPRESSION_TYPE_COMPARE_IN:
+      compiled = CompileInList(predicate, schema, context);
+      break;
+
+    default:
+      break;
+  }
+
+  if (compiled == nullptr) {
+    LOG_TRACE("Interpreting %s",
+              ExpressionTypeToString(predicate->GetExpressionType()).c_str());
+    compiled = new InterpretedPredicate(predicate);
+  }
+  return compiled;
+}
+
+/**
+ * @brief Compiles AND and OR over all operands at once. The comparisons of
+ * an AND that bound the same column from below and above become a range.
+ */
+CompiledPredicate *PredicateCompiler::CompileConjunction(
+    const AbstractExpression *predicate, const catalog::Schema *schema,
+    executor::ExecutorContext *context) {
+  auto conjunction = predicate->GetExpressionType();
+  std::vector<const AbstractExpression *> operands;
+  FlattenConjunction(predicate, conjunction, operands);
+
+  std::vector<std::unique_ptr<CompiledPredicate>> compiled_operands(
+      operands.size());
+  std::vector<bool> in_range(operands.size(), false);
+
+  if (conjunction == EXPRESSION_TYPE_CONJUNCTION_AND) {
+    std::vector<RangeBound> bounds;
+    for (size_t operand_itr = 0; operand_itr < operands.size();
+         operand_itr++) {
+      RangeBound bound;
+      bound.operand_itr = operand_itr;
+      if (GetRangeBound(operands[operand_itr], schema, context, bound)) {
+        bounds.push_back(bound);
+      }
+    }
+
+    // Pair the first lower and upper bound of a column not in a range yet
+    for (auto &lower : bounds) {
+      if (IsLowerBound(lower) == false || in_range[lower.operand_itr]) {
+        continue;
+      }
+
+      for (auto &upper : bounds) {
+        if (IsLowerBound(upper) || upper.column_id != lower.column_id ||
+            in_range[upper.operand_itr]) {
+          continue;
+        }
+
+        auto range =
+            MakeColumnRange(schema, lower.column_id, lower.comparison,
+                            lower.constant, upper.comparison, upper.constant);
+        if (range != nullptr) {
+          // The range takes the place of the first of its bounds
+          auto first = std::min(lower.operand_itr, upper.operand_itr);
+          compiled_operands[first].reset(range);
+          in_range[lower.operand_itr] = true;
+          in_range[upper.operand_itr] = true;
+        }
+        break;
+      }
+    }
+  }
+
+  for (size_t operand_itr = 0; operand_itr < operands.size(); operand_itr++) {
+    if (in_range[operand_itr] == false) {
+      compiled_operands[operand_itr].reset(
+          CompileExpression(operands[operand_itr], schema, context));
+    }
+  }
+
+  // Drop the bounds the ranges replaced
+  compiled_operands.erase(
+      std::remove(compiled_operands.begin(), compiled_operands.end(), nullptr),
+      compiled_operands.end());
+
+  if (conjunction == EXPRESSION_TYPE_CONJUNCTION_AND) {
+    return new AndPredicate(std::move(compiled_operands));
+  }
+  return new OrPredicate(std::move(compiled_operands));
+}
+
+CompiledPredicate *PredicateCompiler::CompileComparison(
+    const AbstractExpression *predicate, const catalog::Schema *schema,
+    executor::ExecutorContext *context) {
+  auto comparison = predicate->GetExpressionType();
+  auto left = predicate->GetLeft();
+  auto right = predicate->GetRight();
+
+  if (IsConstant(left) && IsColumnOf(right, schema)) {
+    std::swap(left, right);
+    comparison = FlipComparison(comparison);
+  }
+
+  if (IsColumnOf(left, schema) == false) return nullptr;
+
+  // Column against constant
+  if (IsConstant(right)) {
+    Value constant = right->Evaluate(nullptr, nullptr, context);
+    if (constant.IsNull()) return new FalsePredicate();
+
+    return MakeComparison<ColumnConstant>(comparison, schema,
+                                          GetColumnId(left), constant);
+  }
+
+  // Column against column
+  if (IsColumnOf(right, schema)) {
+    return MakeComparison<ColumnColumn>(comparison, schema, GetColumnId(left),
+                                        GetColumnId(right));
+  }
+
+  return nullptr;
+}
+
+CompiledPredicate *PredicateCompiler::CompileInList(
+    const AbstractExpression *predicate, const catalog::Schema *schema,
+    executor::ExecutorContext *context) {
+  auto left = predicate->GetLeft();
+  auto right = predicate->GetRight();
+  if (IsColumnOf(left, schema) == false ||
+      right->GetExpressionType() != EXPRESSION_TYPE_VALUE_VECTOR) {
+    return nullptr;
+  }
+
+  // NULL is in no list
+  std::vector<Value> values;
+  for (auto argument :
+       static_cast<const VectorExpression *>(right)->GetArgs()) {
+    if (IsConstant(argument) == false) return nullptr;
+
+    Value value = argument->Evaluate(nullptr, nullptr, context);
+    if (value.IsNull() == false) values.push_back(value);
+  }
+  if (values.empty()) return new FalsePredicate();
+
+  auto column_id = GetColumnId(left);
+  auto column_type = schema->GetType(column_id);
+  bool as_double;
+  if (GetCompareType(column_type, values, as_double) == false) {
+    return nullptr;
+  }
+
+  return MakeColumnPredicate<ColumnInList>(column_type, as_double, column_id,
+                                           values);
+}
+
+}  // End expression namespace
+}  // End peloton namespace
@@ -0,0 +1,90 @@
+//===----------------------------------------------------------------------===//
+//
+//                         PelotonDB
+//
+// predicate_compiler.h
+//
+// Identification: src/backend/expression/predicate_compiler.h
+//
+// Copyright (c) 2015, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include "backend/common/types.h"
+
+namespace peloton {
+
+namespace catalog {
+class Schema;
+}
+
+namespace executor {
+class ExecutorContext;
+}
+
+namespace storage {
+class TileGroup;
+}
+
+namespace expression {
+
+class AbstractExpression;
+
+/**
+ * @brief A predicate compiled for the tile groups of one table.
+ */
+class CompiledPredicate {
+ public:
+  virtual ~CompiledPredicate() {}
+
+  // Keep the positions of the tile group (in ascending order) for which the
+  // predicate is true
+  virtual void Select(storage::TileGroup *tile_group,
+                      std::vector<oid_t> &positions,
+                      executor::ExecutorContext *context) const = 0;
+};
+
+/**
+ * @brief Compiles scan predicates into kernels without interpretation.
+ *
+ * The common shapes of predicates (a column against a constant, against
+ * another column, within a range, in a list of constants, and conjunctions
+ * and disjunctions of those) are mapped onto kernels that are templated on
+ * the storage type of their columns and on the operator, and only look up
+ * where the columns are in each tile group. Constants and parameters are
+ * bound once, when the predicate is compiled. Every other expression is
+ * handed to the interpreter.
+ */
+class PredicateCompiler {
+ public:
+  // Compile the predicate over the tuples of a table with the given schema.
+  // The predicate has to outlive the compiled one.
+  static std::unique_ptr<CompiledPredicate> Compile(
+      const AbstractExpression *predicate, const catalog::Schema *schema,
+      executor::ExecutorContext *context);
+
+ private:
+  static CompiledPredicate *CompileExpression(
+      const AbstractExpression *predicate, const catalog::Schema *schema,
+      executor::ExecutorContext *context);
+
+  static CompiledPredicate *CompileConjunction(
+      const AbstractExpression *predicate, const catalog::Schema *schema,
+      executor::ExecutorContext *context);
+
+  static CompiledPredicate *CompileComparison(
+      const AbstractExpression *predicate, const catalog::Schema *schema,
+      executor::ExecutorContext *context);
+
+  static CompiledPredicate *CompileInList(const AbstractExpression *predicate,
+                                          const catalog::Schema *schema,
+                                          executor::ExecutorContext *context);
+};
+
+}  // End expression namespace
+}  // End peloton namespace
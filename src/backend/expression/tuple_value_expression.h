@@ -13,6 +13,7 @@
 #pragma once
 
 #include "backend/expression/abstract_expression.h"
+#include "backend/expression/vectorized_kernels.h"
 #include "backend/storage/tuple.h"
 
 #include <string>
@@ -56,6 +57,15 @@ class TupleValueExpression : public AbstractExpression {
     }
   }
 
+  // Batches are read from the tile group given for the first tuple
+  bool EvaluateVector(storage::TileGroup *tile_group,
+                      const std::vector<oid_t> &positions, ValueVector &result,
+                      __attribute__((unused))
+                      executor::ExecutorContext *context) const {
+    return tuple_idx == 0 &&
+           GatherColumn(tile_group, value_idx, positions, result);
+  }
+
   std::string DebugInfo(const std::string &spacer) const {
     std::ostringstream buffer;
     buffer << spacer << "Optimized Column Reference[" << tuple_idx << ", "
@@ -0,0 +1,520 @@
+//===----------------------------------------------------------------------===//
+//
+//                         PelotonDB
+//
+// vectorized_kernels.cpp
+//
+// Identification: src/backend/expression/vectorized_kernels.cpp
+//
+// Copyright (c) 2015, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "backend/expression/vectorized_kernels.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <iterator>
+
+#include "backend/common/value_peeker.h"
+#include "backend/expression/abstract_expression.h"
+#include "backend/expression/tuple_value_expression.h"
+#include "backend/storage/tile.h"
+#include "backend/storage/tile_group.h"
+
+namespace peloton {
+namespace expression {
+
+namespace {
+
+// The arithmetic operators fail where Value throws (overflow, division by
+// zero, infinite results), so the tuple at a time path reports the error.
+struct ArithmeticPlus {
+  inline bool operator()(int64_t left, int64_t right, int64_t &result) const {
+    return __builtin_add_overflow(left, right, &result) == false;
+  }
+  inline bool operator()(double left, double right, double &result) const {
+    result = left + right;
+    return std::isfinite(result);
+  }
+};
+
+struct ArithmeticMinus {
+  inline bool operator()(int64_t left, int64_t right, int64_t &result) const {
+    return __builtin_sub_overflow(left, right, &result) == false;
+  }
+  inline bool operator()(double left, double right, double &result) const {
+    result = left - right;
+    return std::isfinite(result);
+  }
+};
+
+struct ArithmeticMultiply {
+  inline bool operator()(int64_t left, int64_t right, int64_t &result) const {
+    return __builtin_mul_overflow(left, right, &result) == false;
+  }
+  inline bool operator()(double left, double right, double &result) const {
+    result = left * right;
+    return std::isfinite(result);
+  }
+};
+
+struct ArithmeticDivide {
+  inline bool operator()(int64_t left, int64_t right, int64_t &result) const {
+    if (right == 0) return false;
+    result = left / right;
+    return true;
+  }
+  inline bool operator()(double left, double right, double &result) const {
+    result = left / right;
+    return std::isfinite(result);
+  }
+};
+
+//===--------------------------------------------------------------------===//
+// Kernels
+//===--------------------------------------------------------------------===//
+
+template <typename T, typename R>
+void GatherColumnKernel(const ColumnLayout &column,
+                        const std::vector<oid_t> &positions,
+                        std::vector<R> &result, R null_value) {
+  result.resize(positions.size());
+  for (size_t itr = 0; itr < positions.size(); itr++) {
+    T value = ReadColumn<T>(column, positions[itr]);
+    result[itr] = IsNullValue(value) ? null_value : static_cast<R>(value);
+  }
+}
+
+template <typename T, typename CMP>
+void SelectVectorsKernel(const std::vector<T> &left,
+                         const std::vector<T> &right,
+                         std::vector<oid_t> &positions) {
+  CMP compare;
+  size_t selected_count = 0;
+  for (size_t itr = 0; itr < positions.size(); itr++) {
+    positions[selected_count] = positions[itr];
+    selected_count += (IsNullValue(left[itr]) == false) &
+                      (IsNullValue(right[itr]) == false) &
+                      compare(left[itr], right[itr]);
+  }
+  positions.resize(selected_count);
+}
+
+template <typename T, typename OP>
+bool ComputeArithmeticKernel(const std::vector<T> &left,
+                             const std::vector<T> &right,
+                             std::vector<T> &result, T null_value) {
+  OP op;
+  result.resize(left.size());
+  for (size_t itr = 0; itr < left.size(); itr++) {
+    if (IsNullValue(left[itr]) || IsNullValue(right[itr])) {
+      result[itr] = null_value;
+    } else if (op(left[itr], right[itr], result[itr]) == false) {
+      return false;
+    }
+  }
+  return true;
+}
+
+//===--------------------------------------------------------------------===//
+// Dispatch on the types of the operands
+//===--------------------------------------------------------------------===//
+
+template <typename CMP>
+bool SelectColumnConstantByType(const ColumnLayout &column,
+                                const Value &constant,
+                                std::vector<oid_t> &positions) {
+  // Comparisons with NULL are never true
+  if (constant.IsNull()) {
+    positions.clear();
+    return true;
+  }
+
+  ValueType constant_type = constant.GetValueType();
+  if (IsNumericType(constant_type) == false) return false;
+
+  if (column.type == VALUE_TYPE_DOUBLE || constant_type == VALUE_TYPE_DOUBLE) {
+    if (column.type == VALUE_TYPE_TIMESTAMP ||
+        constant_type == VALUE_TYPE_TIMESTAMP) {
+      return false;
+    }
+
+    double value =
+        ValuePeeker::PeekDouble(constant.CastAs(VALUE_TYPE_DOUBLE));
+    switch (column.type) {
+      case VALUE_TYPE_TINYINT:
+        SelectColumnConstantKernel<int8_t, double, CMP>(column, value,
+                                                        positions);
+        return true;
+      case VALUE_TYPE_SMALLINT:
+        SelectColumnConstantKernel<int16_t, double, CMP>(column, value,
+                                                         positions);
+        return true;
+      case VALUE_TYPE_INTEGER:
+        SelectColumnConstantKernel<int32_t, double, CMP>(column, value,
+                                                         positions);
+        return true;
+      case VALUE_TYPE_BIGINT:
+        SelectColumnConstantKernel<int64_t, double, CMP>(column, value,
+                                                         positions);
+        return true;
+      case VALUE_TYPE_DOUBLE:
+        SelectColumnConstantKernel<double, double, CMP>(column, value,
+                                                        positions);
+        return true;
+      default:
+        return false;
+    }
+  }
+
+  int64_t value = ValuePeeker::PeekAsBigInt(constant);
+  switch (column.type) {
+    case VALUE_TYPE_TINYINT:
+      SelectColumnConstantKernel<int8_t, int64_t, CMP>(column, value,
+                                                       positions);
+      return true;
+    case VALUE_TYPE_SMALLINT:
+      SelectColumnConstantKernel<int16_t, int64_t, CMP>(column, value,
+                                                        positions);
+      return true;
+    case VALUE_TYPE_INTEGER:
+      SelectColumnConstantKernel<int32_t, int64_t, CMP>(column, value,
+                                                        positions);
+      return true;
+    case VALUE_TYPE_BIGINT:
+    case VALUE_TYPE_TIMESTAMP:
+      SelectColumnConstantKernel<int64_t, int64_t, CMP>(column, value,
+                                                        positions);
+      return true;
+    default:
+      return false;
+  }
+}
+
+bool SelectColumnConstant(ExpressionType comparison,
+                          const ColumnLayout &column, const Value &constant,
+                          std::vector<oid_t> &positions) {
+  switch (comparison) {
+    case EXPRESSION_TYPE_COMPARE_EQUAL:
+      return SelectColumnConstantByType<CompareEqual>(column, constant,
+                                                      positions);
+    case EXPRESSION_TYPE_COMPARE_NOTEQUAL:
+      return SelectColumnConstantByType<CompareNotEqual>(column, constant,
+                                                         positions);
+    case EXPRESSION_TYPE_COMPARE_LESSTHAN:
+      return SelectColumnConstantByType<CompareLessThan>(column, constant,
+                                                         positions);
+    case EXPRESSION_TYPE_COMPARE_GREATERTHAN:
+      return SelectColumnConstantByType<CompareGreaterThan>(column, constant,
+                                                            positions);
+    case EXPRESSION_TYPE_COMPARE_LESSTHANOREQUALTO:
+      return SelectColumnConstantByType<CompareLessThanOrEqual>(
+          column, constant, positions);
+    case EXPRESSION_TYPE_COMPARE_GREATERTHANOREQUALTO:
+      return SelectColumnConstantByType<CompareGreaterThanOrEqual>(
+          column, constant, positions);
+    default:
+      return false;
+  }
+}
+
+template <typename CMP>
+bool SelectVectorsByType(ValueVector &left, ValueVector &right,
+                         std::vector<oid_t> &positions) {
+  if (left.value_type == VALUE_TYPE_DOUBLE ||
+      right.value_type == VALUE_TYPE_DOUBLE) {
+    if (left.value_type == VALUE_TYPE_TIMESTAMP ||
+        right.value_type == VALUE_TYPE_TIMESTAMP) {
+      return false;
+    }
+
+    left.ToDouble();
+    right.ToDouble();
+    SelectVectorsKernel<double, CMP>(left.doubles, right.doubles, positions);
+    return true;
+  }
+
+  SelectVectorsKernel<int64_t, CMP>(left.bigints, right.bigints, positions);
+  return true;
+}
+
+bool SelectVectors(ExpressionType comparison, ValueVector &left,
+                   ValueVector &right, std::vector<oid_t> &positions) {
+  switch (comparison) {
+    case EXPRESSION_TYPE_COMPARE_EQUAL:
+      return SelectVectorsByType<CompareEqual>(left, right, positions);
+    case EXPRESSION_TYPE_COMPARE_NOTEQUAL:
+      return SelectVectorsByType<CompareNotEqual>(left, right, positions);
+    case EXPRESSION_TYPE_COMPARE_LESSTHAN:
+      return SelectVectorsByType<CompareLessThan>(left, right, positions);
+    case EXPRESSION_TYPE_COMPARE_GREATERTHAN:
+      return SelectVectorsByType<CompareGreaterThan>(left, right, positions);
+    case EXPRESSION_TYPE_COMPARE_LESSTHANOREQUALTO:
+      return SelectVectorsByType<CompareLessThanOrEqual>(left, right,
+                                                         positions);
+    case EXPRESSION_TYPE_COMPARE_GREATERTHANOREQUALTO:
+      return SelectVectorsByType<CompareGreaterThanOrEqual>(left, right,
+                                                            positions);
+    default:
+      return false;
+  }
+}
+
+template <typename OP>
+bool ComputeArithmeticByType(const ValueVector &left, const ValueVector &right,
+                             ValueVector &result) {
+  if (left.value_type == VALUE_TYPE_TIMESTAMP ||
+      right.value_type == VALUE_TYPE_TIMESTAMP) {
+    return false;
+  }
+
+  if (left.value_type == VALUE_TYPE_DOUBLE ||
+      right.value_type == VALUE_TYPE_DOUBLE) {
+    ValueVector left_doubles(left), right_doubles(right);
+    left_doubles.ToDouble();
+    right_doubles.ToDouble();
+
+    result.value_type = VALUE_TYPE_DOUBLE;
+    return ComputeArithmeticKernel<double, OP>(
+        left_doubles.doubles, right_doubles.doubles, result.doubles,
+        DOUBLE_NULL);
+  }
+
+  result.value_type = VALUE_TYPE_BIGINT;
+  return ComputeArithmeticKernel<int64_t, OP>(left.bigints, right.bigints,
+                                              result.bigints, INT64_NULL);
+}
+
+}  // namespace
+
+//===--------------------------------------------------------------------===//
+// Tile Memory
+//===--------------------------------------------------------------------===//
+
+bool IsColumn(const AbstractExpression *expression) {
+  return expression->GetExpressionType() == EXPRESSION_TYPE_VALUE_TUPLE &&
+         static_cast<const TupleValueExpression *>(expression)
+                 ->GetTupleIdx() == 0;
+}
+
+bool IsConstant(const AbstractExpression *expression) {
+  return expression->GetExpressionType() == EXPRESSION_TYPE_VALUE_CONSTANT ||
+         expression->GetExpressionType() == EXPRESSION_TYPE_VALUE_PARAMETER;
+}
+
+bool GetColumnLayout(storage::TileGroup *tile_group, oid_t column_id,
+                     ColumnLayout &column) {
+  oid_t tile_offset, tile_column_id;
+  tile_group->LocateTileAndColumn(column_id, tile_offset, tile_column_id);
+
+  auto tile = tile_group->GetTile(tile_offset);
+  auto schema = tile->GetSchema();
+
+  column.type = schema->GetType(tile_column_id);
+  column.base = tile->GetTupleLocation(0) + schema->GetOffset(tile_column_id);
+  column.stride = schema->GetLength();
+
+  return IsNumericType(column.type);
+}
+
+//===--------------------------------------------------------------------===//
+// Value Vector
+//===--------------------------------------------------------------------===//
+
+bool ValueVector::IsNull(size_t index) const {
+  if (value_type == VALUE_TYPE_DOUBLE) {
+    return IsNullValue(doubles[index]);
+  }
+  return IsNullValue(bigints[index]);
+}
+
+void ValueVector::ToDouble() {
+  if (value_type == VALUE_TYPE_DOUBLE) return;
+  assert(value_type == VALUE_TYPE_BIGINT);
+
+  doubles.resize(bigints.size());
+  for (size_t itr = 0; itr < bigints.size(); itr++) {
+    doubles[itr] = IsNullValue(bigints[itr])
+                       ? DOUBLE_NULL
+                       : static_cast<double>(bigints[itr]);
+  }
+  bigints.clear();
+  value_type = VALUE_TYPE_DOUBLE;
+}
+
+//===--------------------------------------------------------------------===//
+// Kernels
+//===--------------------------------------------------------------------===//
+
+bool GatherColumn(storage::TileGroup *tile_group, oid_t column_id,
+                  const std::vector<oid_t> &positions, ValueVector &result) {
+  ColumnLayout column;
+  if (GetColumnLayout(tile_group, column_id, column) == false) return false;
+
+  switch (column.type) {
+    case VALUE_TYPE_TINYINT:
+      result.value_type = VALUE_TYPE_BIGINT;
+      GatherColumnKernel<int8_t, int64_t>(column, positions, result.bigints,
+                                          INT64_NULL);
+      return true;
+    case VALUE_TYPE_SMALLINT:
+      result.value_type = VALUE_TYPE_BIGINT;
+      GatherColumnKernel<int16_t, int64_t>(column, positions, result.bigints,
+                                           INT64_NULL);
+      return true;
+    case VALUE_TYPE_INTEGER:
+      result.value_type = VALUE_TYPE_BIGINT;
+      GatherColumnKernel<int32_t, int64_t>(column, positions, result.bigints,
+                                           INT64_NULL);
+      return true;
+    case VALUE_TYPE_BIGINT:
+    case VALUE_TYPE_TIMESTAMP:
+      result.value_type = column.type;
+      GatherColumnKernel<int64_t, int64_t>(column, positions, result.bigints,
+                                           INT64_NULL);
+      return true;
+    case VALUE_TYPE_DOUBLE:
+      result.value_type = VALUE_TYPE_DOUBLE;
+      GatherColumnKernel<double, double>(column, positions, result.doubles,
+                                         DOUBLE_NULL);
+      return true;
+    default:
+      return false;
+  }
+}
+
+bool BroadcastValue(const Value &value, size_t count, ValueVector &result) {
+  ValueType value_type = value.GetValueType();
+  if (IsNumericType(value_type) == false) return false;
+
+  if (value_type == VALUE_TYPE_DOUBLE) {
+    result.value_type = VALUE_TYPE_DOUBLE;
+    result.doubles.assign(
+        count, value.IsNull() ? DOUBLE_NULL : ValuePeeker::PeekDouble(value));
+    return true;
+  }
+
+  result.value_type =
+      (value_type == VALUE_TYPE_TIMESTAMP) ? value_type : VALUE_TYPE_BIGINT;
+  result.bigints.assign(count, ValuePeeker::PeekAsBigInt(value));
+  return true;
+}
+
+bool ComputeArithmetic(ExpressionType op, const ValueVector &left,
+                       const ValueVector &right, ValueVector &result) {
+  assert(left.GetSize() == right.GetSize());
+
+  switch (op) {
+    case EXPRESSION_TYPE_OPERATOR_PLUS:
+      return ComputeArithmeticByType<ArithmeticPlus>(left, right, result);
+    case EXPRESSION_TYPE_OPERATOR_MINUS:
+      return ComputeArithmeticByType<ArithmeticMinus>(left, right, result);
+    case EXPRESSION_TYPE_OPERATOR_MULTIPLY:
+      return ComputeArithmeticByType<ArithmeticMultiply>(left, right, result);
+    case EXPRESSION_TYPE_OPERATOR_DIVIDE:
+      return ComputeArithmeticByType<ArithmeticDivide>(left, right, result);
+    default:
+      return false;
+  }
+}
+
+bool SelectComparison(ExpressionType comparison,
+                      const AbstractExpression *left,
+                      const AbstractExpression *right,
+                      storage::TileGroup *tile_group,
+                      std::vector<oid_t> &positions,
+                      executor::ExecutorContext *context) {
+  // Column against a constant, read in place
+  const AbstractExpression *column_expr = nullptr;
+  const AbstractExpression *constant_expr = nullptr;
+  if (IsColumn(left) && IsConstant(right)) {
+    column_expr = left;
+    constant_expr = right;
+  } else if (IsConstant(left) && IsColumn(right)) {
+    column_expr = right;
+    constant_expr = left;
+    comparison = FlipComparison(comparison);
+  }
+
+  if (column_expr != nullptr) {
+    auto column_id =
+        static_cast<const TupleValueExpression *>(column_expr)->GetColumnId();
+    ColumnLayout column;
+    if (GetColumnLayout(tile_group, column_id, column) == true) {
+      Value constant = constant_expr->Evaluate(nullptr, nullptr, context);
+      if (SelectColumnConstant(comparison, column, constant, positions)) {
+        return true;
+      }
+    }
+  }
+
+  // Any other numeric operands
+  ValueVector left_values, right_values;
+  if (left->EvaluateVector(tile_group, positions, left_values, context) ==
+          false ||
+      right->EvaluateVector(tile_group, positions, right_values, context) ==
+          false) {
+    return false;
+  }
+
+  return SelectVectors(comparison, left_values, right_values, positions);
+}
+
+bool SelectIsNull(const AbstractExpression *operand,
+                  storage::TileGroup *tile_group, std::vector<oid_t> &positions,
+                  executor::ExecutorContext *context) {
+  ValueVector values;
+  if (operand->EvaluateVector(tile_group, positions, values, context) ==
+      false) {
+    return false;
+  }
+
+  size_t selected_count = 0;
+  for (size_t itr = 0; itr < positions.size(); itr++) {
+    positions[selected_count] = positions[itr];
+    selected_count += values.IsNull(itr);
+  }
+  positions.resize(selected_count);
+
+  return true;
+}
+
+void SelectConjunction(ExpressionType conjunction,
+                       const AbstractExpression *left,
+                       const AbstractExpression *right,
+                       storage::TileGroup *tile_group,
+                       std::vector<oid_t> &positions,
+                       executor::ExecutorContext *context) {
+  // AND narrows the positions down, one operand after the other
+  if (conjunction == EXPRESSION_TYPE_CONJUNCTION_AND) {
+    left->EvaluateSelection(tile_group, positions, context);
+    if (positions.empty() == false) {
+      right->EvaluateSelection(tile_group, positions, context);
+    }
+    return;
+  }
+
+  assert(conjunction == EXPRESSION_TYPE_CONJUNCTION_OR);
+
+  // OR only evaluates the right operand where the left one was not true
+  std::vector<oid_t> left_positions(positions);
+  left->EvaluateSelection(tile_group, left_positions, context);
+
+  std::vector<oid_t> right_positions;
+  std::set_difference(positions.begin(), positions.end(),
+                      left_positions.begin(), left_positions.end(),
+                      std::back_inserter(right_positions));
+  if (right_positions.empty() == false) {
+    right->EvaluateSelection(tile_group, right_positions, context);
+  }
+
+  positions.clear();
+  std::merge(left_positions.begin(), left_positions.end(),
+             right_positions.begin(), right_positions.end(),
+             std::back_inserter(positions));
+}
+
+}  // End expression namespace
+}  // End peloton namespace
@@ -0,0 +1,234 @@
+//===----------------------------------------------------------------------===//
+//
+//                         PelotonDB
+//
+// vectorized_kernels.h
+//
+// Identification: src/backend/expression/vectorized_kernels.h
+//
+// Copyright (c) 2015, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "backend/common/types.h"
+#include "backend/common/value.h"
+
+namespace peloton {
+
+namespace executor {
+class ExecutorContext;
+}
+
+namespace storage {
+class TileGroup;
+}
+
+namespace expression {
+
+class AbstractExpression;
+
+/**
+ * @brief Values of a numeric expression for a batch of tuples, one for each
+ * position the expression was evaluated for.
+ *
+ * Integers are widened to BIGINT and floating point numbers to DOUBLE,
+ * timestamps keep their type. NULL is kept with the sentinels of the tuple
+ * storage (INT64_NULL, DOUBLE_NULL).
+ */
+struct ValueVector {
+  ValueType value_type = VALUE_TYPE_INVALID;
+
+  /** @brief Values of BIGINT and TIMESTAMP vectors */
+  std::vector<int64_t> bigints;
+
+  /** @brief Values of DOUBLE vectors */
+  std::vector<double> doubles;
+
+  size_t GetSize() const {
+    return (value_type == VALUE_TYPE_DOUBLE) ? doubles.size() : bigints.size();
+  }
+
+  bool IsNull(size_t index) const;
+
+  // Widen a BIGINT vector to DOUBLE
+  void ToDouble();
+};
+
+//===--------------------------------------------------------------------===//
+// Tile Memory
+//===--------------------------------------------------------------------===//
+
+inline bool IsNullValue(int8_t value) { return value == INT8_NULL; }
+inline bool IsNullValue(int16_t value) { return value == INT16_NULL; }
+inline bool IsNullValue(int32_t value) { return value == INT32_NULL; }
+inline bool IsNullValue(int64_t value) { return value == INT64_NULL; }
+inline bool IsNullValue(double value) { return value <= DOUBLE_NULL; }
+
+// Fixed width types the kernels read from tile memory
+inline bool IsNumericType(ValueType type) {
+  switch (type) {
+    case VALUE_TYPE_TINYINT:
+    case VALUE_TYPE_SMALLINT:
+    case VALUE_TYPE_INTEGER:
+    case VALUE_TYPE_BIGINT:
+    case VALUE_TYPE_TIMESTAMP:
+    case VALUE_TYPE_DOUBLE:
+      return true;
+    default:
+      return false;
+  }
+}
+
+/**
+ * @brief A column of a tile group in tile memory. The value of the tuple at
+ * a position starts at base + position * stride.
+ */
+struct ColumnLayout {
+  ValueType type;
+  const char *base;
+  size_t stride;
+};
+
+// Locate a column of the tile group. Returns false if it is not numeric,
+// the layout is still set.
+bool GetColumnLayout(storage::TileGroup *tile_group, oid_t column_id,
+                     ColumnLayout &column);
+
+template <typename T>
+inline T ReadColumn(const ColumnLayout &column, oid_t position) {
+  return *reinterpret_cast<const T *>(column.base + position * column.stride);
+}
+
+// A column of the tuples the batch is evaluated for
+bool IsColumn(const AbstractExpression *expression);
+
+// A constant or a parameter, the same for all tuples of the batch
+bool IsConstant(const AbstractExpression *expression);
+
+//===--------------------------------------------------------------------===//
+// Comparisons
+//===--------------------------------------------------------------------===//
+
+struct CompareEqual {
+  template <typename T>
+  inline bool operator()(T left, T right) const {
+    return left == right;
+  }
+};
+
+struct CompareNotEqual {
+  template <typename T>
+  inline bool operator()(T left, T right) const {
+    return left != right;
+  }
+};
+
+struct CompareLessThan {
+  template <typename T>
+  inline bool operator()(T left, T right) const {
+    return left < right;
+  }
+};
+
+struct CompareGreaterThan {
+  template <typename T>
+  inline bool operator()(T left, T right) const {
+    return left > right;
+  }
+};
+
+struct CompareLessThanOrEqual {
+  template <typename T>
+  inline bool operator()(T left, T right) const {
+    return left <= right;
+  }
+};
+
+struct CompareGreaterThanOrEqual {
+  template <typename T>
+  inline bool operator()(T left, T right) const {
+    return left >= right;
+  }
+};
+
+// The comparison with its operands swapped, a < b as b > a
+inline ExpressionType FlipComparison(ExpressionType comparison) {
+  switch (comparison) {
+    case EXPRESSION_TYPE_COMPARE_LESSTHAN:
+      return EXPRESSION_TYPE_COMPARE_GREATERTHAN;
+    case EXPRESSION_TYPE_COMPARE_GREATERTHAN:
+      return EXPRESSION_TYPE_COMPARE_LESSTHAN;
+    case EXPRESSION_TYPE_COMPARE_LESSTHANOREQUALTO:
+      return EXPRESSION_TYPE_COMPARE_GREATERTHANOREQUALTO;
+    case EXPRESSION_TYPE_COMPARE_GREATERTHANOREQUALTO:
+      return EXPRESSION_TYPE_COMPARE_LESSTHANOREQUALTO;
+    default:
+      return comparison;
+  }
+}
+
+// The selected positions are written in place without a branch on the
+// outcome of the comparison, which the CPU would not predict well
+template <typename T, typename C, typename CMP>
+void SelectColumnConstantKernel(const ColumnLayout &column, C constant,
+                                std::vector<oid_t> &positions) {
+  CMP compare;
+  size_t selected_count = 0;
+  for (oid_t position : positions) {
+    T value = ReadColumn<T>(column, position);
+    positions[selected_count] = position;
+    selected_count += (IsNullValue(value) == false) &
+                      compare(static_cast<C>(value), constant);
+  }
+  positions.resize(selected_count);
+}
+
+//===--------------------------------------------------------------------===//
+// Batch kernels of the expressions
+//
+// The kernels run over the positions of one tile group and read fixed width
+// columns straight from tile memory. Positions are in ascending order. A
+// kernel returns false when it does not apply to its operands (a VARCHAR
+// column, a DECIMAL constant), and leaves the positions alone so the caller
+// can evaluate them one tuple at a time instead.
+//===--------------------------------------------------------------------===//
+
+// Read a fixed width column of the tile group for all positions
+bool GatherColumn(storage::TileGroup *tile_group, oid_t column_id,
+                  const std::vector<oid_t> &positions, ValueVector &result);
+
+// Repeat a numeric value for all positions
+bool BroadcastValue(const Value &value, size_t count, ValueVector &result);
+
+// Compute left <op> right for +, -, * and /
+bool ComputeArithmetic(ExpressionType op, const ValueVector &left,
+                       const ValueVector &right, ValueVector &result);
+
+// Keep the positions for which left <comparison> right is true
+bool SelectComparison(ExpressionType comparison,
+                      const AbstractExpression *left,
+                      const AbstractExpression *right,
+                      storage::TileGroup *tile_group,
+                      std::vector<oid_t> &positions,
+                      executor::ExecutorContext *context);
+
+// Keep the positions for which the operand is NULL
+bool SelectIsNull(const AbstractExpression *operand,
+                  storage::TileGroup *tile_group, std::vector<oid_t> &positions,
+                  executor::ExecutorContext *context);
+
+// Keep the positions for which the AND or OR of the operands is true
+void SelectConjunction(ExpressionType conjunction,
+                       const AbstractExpression *left,
+                       const AbstractExpression *right,
+                       storage::TileGroup *tile_group,
+                       std::vector<oid_t> &positions,
+                       executor::ExecutorContext *context);
+
+}  // End expression namespace
+}  // End peloton namespace
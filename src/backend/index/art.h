@@ -0,0 +1,1094 @@
+//===----------------------------------------------------------------------===//
+//
+//                         PelotonDB
+//
+// art.h
+//
+// Identification: src/backend/index/art.h
+//
+// Copyright (c) 2015, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "backend/index/epoch_manager.h"
+
+namespace peloton {
+namespace index {
+
+/**
+ * Adaptive radix tree with optimistic lock coupling (Leis et al., "The
+ * Adaptive Radix Tree", ICDE 2013, and "The ART of Practical
+ * Synchronization", DaMoN 2016).
+ *
+ * Keys are byte strings ordered by memcmp, none of which is a prefix of
+ * another one. Inner nodes branch on one byte of the key and grow from 4 to
+ * 16, 48 and 256 children as needed. Every inner node stores the bytes that
+ * all keys below it share after the byte of its parent (path compression),
+ * and every key is stored in a leaf right below the first node where it
+ * differs from all other keys (lazy expansion). A leaf holds all values of
+ * its key.
+ *
+ * Nodes are latched the same way as in OLCBTree. A node that is replaced by
+ * a larger one, or removed once its last value is deleted, is marked
+ * obsolete so that the readers that reach it restart. Every operation runs
+ * in an epoch, and such nodes are handed to the epoch manager, which frees
+ * them once no reader can still follow a stale pointer to them. Inner nodes
+ * are never shrunk or merged.
+ *
+ * The key type provides its encoding through GetBytes() and GetLength().
+ */
+template <typename KeyType, typename ValueType, class ValueEqualityChecker>
+class ART {
+  ART(ART const &) = delete;
+
+ public:
+  ART() : memory_footprint(0) {
+    // The root never changes, so it has room for all children
+    root = new Node256(nullptr, 0);
+    memory_footprint += sizeof(Node256);
+  }
+
+  ~ART() {
+    epoch_manager.FreeAllGarbage();
+    FreeNode(root);
+  }
+
+  void Insert(const KeyType &key, const ValueType &value) {
+    EpochGuard guard(epoch_manager);
+    InsertEntry(key, value, nullptr);
+  }
+
+  // Insert the pair unless the predicate holds for a value with the same key,
+  // the check and the insert are atomic
+  bool ConditionalInsert(const KeyType &key, const ValueType &value,
+                         std::function<bool(const ValueType &)> predicate) {
+    EpochGuard guard(epoch_manager);
+    return InsertEntry(key, value, &predicate);
+  }
+
+  // Delete all copies of the pair
+  void Delete(const KeyType &key, const ValueType &value) {
+    EpochGuard guard(epoch_manager);
+    while (true) {
+      bool restart = false;
+      InnerNode *node;
+      uint64_t version;
+      uint8_t byte;
+      Leaf *leaf = FindLeaf(key, node, version, byte, restart);
+      if (restart) {
+        continue;
+      }
+
+      // Nothing to delete
+      if (leaf == nullptr) {
+        return;
+      }
+
+      uint64_t leaf_version = ReadLockOrRestart(leaf, restart);
+      if (restart) {
+        continue;
+      }
+
+      UpgradeToWriteLockOrRestart(node, version, restart);
+      if (restart) {
+        continue;
+      }
+
+      UpgradeToWriteLockOrRestart(leaf, leaf_version, restart);
+      if (restart) {
+        WriteUnlock(node);
+        continue;
+      }
+
+      auto last = std::remove_if(leaf->values, leaf->values + leaf->count,
+                                 [&](const ValueType &leaf_value) -> bool {
+        return value_equals(leaf_value, value);
+      });
+      leaf->count = last - leaf->values;
+
+      // Remove the key with its last value
+      if (leaf->count == 0) {
+        RemoveChild(node, byte);
+        WriteUnlockObsolete(leaf);
+        Retire(leaf);
+      } else {
+        WriteUnlock(leaf);
+      }
+
+      WriteUnlock(node);
+      return;
+    }
+  }
+
+  // Get the values of the given key
+  void GetValues(const KeyType &key, std::vector<ValueType> &values) {
+    EpochGuard guard(epoch_manager);
+    while (true) {
+      bool restart = false;
+      InnerNode *node;
+      uint64_t version;
+      uint8_t byte;
+      Leaf *leaf = FindLeaf(key, node, version, byte, restart);
+      if (restart) {
+        continue;
+      }
+
+      if (leaf == nullptr || ReadLeaf(leaf, values, false) == true) {
+        return;
+      }
+    }
+  }
+
+  // Visit the entries in key order, starting at the first key not less than
+  // start_key (or the smallest key if start_key is nullptr), until the
+  // visitor returns false
+  void Scan(const KeyType *start_key,
+            std::function<bool(const KeyType &, const ValueType &)> visitor) {
+    EpochGuard guard(epoch_manager);
+    ScanNode(root, 0, start_key, visitor);
+  }
+
+  size_t GetMemoryFootprint() const {
+    return sizeof(ART) + memory_footprint.load();
+  }
+
+ private:
+  //===--------------------------------------------------------------------===//
+  // Nodes
+  //===--------------------------------------------------------------------===//
+
+  enum NodeType : uint8_t {
+    NODE_TYPE_LEAF,
+    NODE_TYPE_4,
+    NODE_TYPE_16,
+    NODE_TYPE_48,
+    NODE_TYPE_256
+  };
+
+  struct Node {
+    Node(NodeType type) : version(0), type(type) {}
+
+    // bit 0 marks obsolete nodes, bit 1 is the latch, the remaining bits
+    // count the modifications
+    std::atomic<uint64_t> version;
+
+    NodeType type;
+  };
+
+  struct Leaf : public Node {
+    Leaf(const KeyType &key, uint32_t capacity)
+        : Node(NODE_TYPE_LEAF),
+          key(key),
+          count(0),
+          capacity(capacity),
+          values(new ValueType[capacity]) {}
+
+    ~Leaf() { delete[] values; }
+
+    const KeyType key;
+
+    uint32_t count;
+
+    uint32_t capacity;
+
+    ValueType *values;
+  };
+
+  struct InnerNode : public Node {
+    InnerNode(NodeType type, const uint8_t *prefix, uint32_t prefix_length)
+        : Node(type),
+          count(0),
+          prefix(nullptr),
+          prefix_length(prefix_length) {
+      if (prefix_length > 0) {
+        this->prefix = new uint8_t[prefix_length];
+        ::memcpy(this->prefix, prefix, prefix_length);
+      }
+    }
+
+    ~InnerNode() { delete[] prefix; }
+
+    // number of children
+    uint16_t count;
+
+    // the compressed path, only ever shortened in place
+    uint8_t *prefix;
+
+    uint32_t prefix_length;
+  };
+
+  // The children are sorted by their bytes
+  struct Node4 : public InnerNode {
+    Node4(const uint8_t *prefix, uint32_t prefix_length)
+        : InnerNode(NODE_TYPE_4, prefix, prefix_length) {}
+
+    uint8_t keys[4];
+
+    Node *children[4];
+  };
+
+  struct Node16 : public InnerNode {
+    Node16(const uint8_t *prefix, uint32_t prefix_length)
+        : InnerNode(NODE_TYPE_16, prefix, prefix_length) {}
+
+    uint8_t keys[16];
+
+    Node *children[16];
+  };
+
+  // Every byte maps to the slot of its child
+  struct Node48 : public InnerNode {
+    Node48(const uint8_t *prefix, uint32_t prefix_length)
+        : InnerNode(NODE_TYPE_48, prefix, prefix_length) {
+      ::memset(child_index, EMPTY_SLOT, sizeof(child_index));
+      std::fill(children, children + 48, nullptr);
+    }
+
+    static const uint8_t EMPTY_SLOT = 48;
+
+    uint8_t child_index[256];
+
+    Node *children[48];
+  };
+
+  struct Node256 : public InnerNode {
+    Node256(const uint8_t *prefix, uint32_t prefix_length)
+        : InnerNode(NODE_TYPE_256, prefix, prefix_length) {
+      std::fill(children, children + 256, nullptr);
+    }
+
+    Node *children[256];
+  };
+
+  //===--------------------------------------------------------------------===//
+  // Version Latches
+  //===--------------------------------------------------------------------===//
+
+  static uint64_t ReadLockOrRestart(Node *node, bool &restart) {
+    uint64_t version = node->version.load();
+    if (version & (LATCH_BIT | OBSOLETE_BIT)) {
+      std::this_thread::yield();
+      restart = true;
+    }
+    return version;
+  }
+
+  static void CheckOrRestart(Node *node, uint64_t version, bool &restart) {
+    if (node->version.load() != version) {
+      restart = true;
+    }
+  }
+
+  static void UpgradeToWriteLockOrRestart(Node *node, uint64_t version,
+                                          bool &restart) {
+    if (node->version.compare_exchange_strong(version, version + LATCH_BIT) ==
+        false) {
+      restart = true;
+    }
+  }
+
+  static void WriteUnlock(Node *node) { node->version.fetch_add(LATCH_BIT); }
+
+  static void WriteUnlockObsolete(Node *node) {
+    node->version.fetch_add(LATCH_BIT + OBSOLETE_BIT);
+  }
+
+  // Latch a node and its parent, which has to exist
+  static bool LockNodeAndParent(InnerNode *parent, uint64_t parent_version,
+                                InnerNode *node, uint64_t version) {
+    assert(parent != nullptr);
+    bool restart = false;
+
+    UpgradeToWriteLockOrRestart(parent, parent_version, restart);
+    if (restart) {
+      return false;
+    }
+
+    UpgradeToWriteLockOrRestart(node, version, restart);
+    if (restart) {
+      WriteUnlock(parent);
+      return false;
+    }
+
+    return true;
+  }
+
+  //===--------------------------------------------------------------------===//
+  // Inner Nodes
+  //===--------------------------------------------------------------------===//
+
+  // Count of a node read without its latch, bounded for torn reads
+  static size_t GetCount(const InnerNode *node, size_t capacity) {
+    return std::min<size_t>(node->count, capacity);
+  }
+
+  static Node *FindChild(InnerNode *node, uint8_t byte) {
+    switch (node->type) {
+      case NODE_TYPE_4: {
+        Node4 *node4 = static_cast<Node4 *>(node);
+        size_t count = GetCount(node4, 4);
+        for (size_t child_itr = 0; child_itr < count; child_itr++) {
+          if (node4->keys[child_itr] == byte) {
+            return node4->children[child_itr];
+          }
+        }
+        return nullptr;
+      }
+      case NODE_TYPE_16: {
+        Node16 *node16 = static_cast<Node16 *>(node);
+        size_t count = GetCount(node16, 16);
+        for (size_t child_itr = 0; child_itr < count; child_itr++) {
+          if (node16->keys[child_itr] == byte) {
+            return node16->children[child_itr];
+          }
+        }
+        return nullptr;
+      }
+      case NODE_TYPE_48: {
+        Node48 *node48 = static_cast<Node48 *>(node);
+        uint8_t slot = node48->child_index[byte];
+        if (slot == Node48::EMPTY_SLOT) {
+          return nullptr;
+        }
+        return node48->children[slot];
+      }
+      case NODE_TYPE_256:
+      default:
+        return static_cast<Node256 *>(node)->children[byte];
+    }
+  }
+
+  static bool IsFull(const InnerNode *node) {
+    switch (node->type) {
+      case NODE_TYPE_4:
+        return node->count == 4;
+      case NODE_TYPE_16:
+        return node->count == 16;
+      case NODE_TYPE_48:
+        return node->count == 48;
+      case NODE_TYPE_256:
+      default:
+        return false;
+    }
+  }
+
+  // Insert the child at its sorted position among the keys
+  template <typename SortedNode>
+  static void AddSortedChild(SortedNode *node, uint8_t byte, Node *child) {
+    size_t offset = std::upper_bound(node->keys, node->keys + node->count,
+                                     byte) - node->keys;
+    std::move_backward(node->keys + offset, node->keys + node->count,
+                       node->keys + node->count + 1);
+    std::move_backward(node->children + offset, node->children + node->count,
+                       node->children + node->count + 1);
+    node->keys[offset] = byte;
+    node->children[offset] = child;
+    node->count++;
+  }
+
+  template <typename SortedNode>
+  static void RemoveSortedChild(SortedNode *node, uint8_t byte) {
+    size_t offset = std::find(node->keys, node->keys + node->count, byte) -
+                    node->keys;
+    assert(offset < node->count);
+    std::move(node->keys + offset + 1, node->keys + node->count,
+              node->keys + offset);
+    std::move(node->children + offset + 1, node->children + node->count,
+              node->children + offset);
+    node->count--;
+  }
+
+  // Add a child to a node that is not full
+  static void AddChild(InnerNode *node, uint8_t byte, Node *child) {
+    assert(IsFull(node) == false);
+
+    switch (node->type) {
+      case NODE_TYPE_4:
+        AddSortedChild(static_cast<Node4 *>(node), byte, child);
+        break;
+      case NODE_TYPE_16:
+        AddSortedChild(static_cast<Node16 *>(node), byte, child);
+        break;
+      case NODE_TYPE_48: {
+        Node48 *node48 = static_cast<Node48 *>(node);
+        uint8_t slot = 0;
+        while (node48->children[slot] != nullptr) {
+          slot++;
+        }
+        node48->children[slot] = child;
+        node48->child_index[byte] = slot;
+        node48->count++;
+      } break;
+      case NODE_TYPE_256:
+      default:
+        static_cast<Node256 *>(node)->children[byte] = child;
+        node->count++;
+        break;
+    }
+  }
+
+  static void ChangeChild(InnerNode *node, uint8_t byte, Node *child) {
+    switch (node->type) {
+      case NODE_TYPE_4: {
+        Node4 *node4 = static_cast<Node4 *>(node);
+        node4->children[std::find(node4->keys, node4->keys + node4->count,
+                                  byte) - node4->keys] = child;
+      } break;
+      case NODE_TYPE_16: {
+        Node16 *node16 = static_cast<Node16 *>(node);
+        node16->children[std::find(node16->keys, node16->keys + node16->count,
+                                   byte) - node16->keys] = child;
+      } break;
+      case NODE_TYPE_48: {
+        Node48 *node48 = static_cast<Node48 *>(node);
+        node48->children[node48->child_index[byte]] = child;
+      } break;
+      case NODE_TYPE_256:
+      default:
+        static_cast<Node256 *>(node)->children[byte] = child;
+        break;
+    }
+  }
+
+  static void RemoveChild(InnerNode *node, uint8_t byte) {
+    switch (node->type) {
+      case NODE_TYPE_4:
+        RemoveSortedChild(static_cast<Node4 *>(node), byte);
+        break;
+      case NODE_TYPE_16:
+        RemoveSortedChild(static_cast<Node16 *>(node), byte);
+        break;
+      case NODE_TYPE_48: {
+        Node48 *node48 = static_cast<Node48 *>(node);
+        node48->children[node48->child_index[byte]] = nullptr;
+        node48->child_index[byte] = Node48::EMPTY_SLOT;
+        node48->count--;
+      } break;
+      case NODE_TYPE_256:
+      default:
+        static_cast<Node256 *>(node)->children[byte] = nullptr;
+        node->count--;
+        break;
+    }
+  }
+
+  // Copy a full node into a node of the next larger type
+  InnerNode *Grow(InnerNode *node) {
+    switch (node->type) {
+      case NODE_TYPE_4: {
+        Node4 *node4 = static_cast<Node4 *>(node);
+        Node16 *node16 = new Node16(node->prefix, node->prefix_length);
+        std::copy(node4->keys, node4->keys + node4->count, node16->keys);
+        std::copy(node4->children, node4->children + node4->count,
+                  node16->children);
+        node16->count = node4->count;
+        memory_footprint += sizeof(Node16) + node->prefix_length;
+        return node16;
+      }
+      case NODE_TYPE_16: {
+        Node16 *node16 = static_cast<Node16 *>(node);
+        Node48 *node48 = new Node48(node->prefix, node->prefix_length);
+        for (uint8_t child_itr = 0; child_itr < node16->count; child_itr++) {
+          node48->child_index[node16->keys[child_itr]] = child_itr;
+          node48->children[child_itr] = node16->children[child_itr];
+        }
+        node48->count = node16->count;
+        memory_footprint += sizeof(Node48) + node->prefix_length;
+        return node48;
+      }
+      case NODE_TYPE_48:
+      default: {
+        Node48 *node48 = static_cast<Node48 *>(node);
+        Node256 *node256 = new Node256(node->prefix, node->prefix_length);
+        for (size_t byte_itr = 0; byte_itr < 256; byte_itr++) {
+          uint8_t slot = node48->child_index[byte_itr];
+          if (slot != Node48::EMPTY_SLOT) {
+            node256->children[byte_itr] = node48->children[slot];
+          }
+        }
+        node256->count = node48->count;
+        memory_footprint += sizeof(Node256) + node->prefix_length;
+        return node256;
+      }
+    }
+  }
+
+  // Drop the first bytes of the compressed path
+  static void CutPrefix(InnerNode *node, uint32_t length) {
+    assert(length <= node->prefix_length);
+    ::memmove(node->prefix, node->prefix + length,
+              node->prefix_length - length);
+    node->prefix_length -= length;
+  }
+
+  //===--------------------------------------------------------------------===//
+  // Leaves
+  //===--------------------------------------------------------------------===//
+
+  Leaf *NewLeaf(const KeyType &key, const ValueType &value) {
+    Leaf *leaf = new Leaf(key, 1);
+    leaf->values[0] = value;
+    leaf->count = 1;
+    memory_footprint += sizeof(Leaf) + sizeof(ValueType);
+    return leaf;
+  }
+
+  static bool KeyEquals(const KeyType &lhs, const KeyType &rhs) {
+    return lhs.GetLength() == rhs.GetLength() &&
+           ::memcmp(lhs.GetBytes(), rhs.GetBytes(), lhs.GetLength()) == 0;
+  }
+
+  static bool KeyLess(const KeyType &lhs, const KeyType &rhs) {
+    size_t length = std::min(lhs.GetLength(), rhs.GetLength());
+    int diff = ::memcmp(lhs.GetBytes(), rhs.GetBytes(), length);
+    if (diff != 0) {
+      return diff < 0;
+    }
+    return lhs.GetLength() < rhs.GetLength();
+  }
+
+  // Copy the values of a leaf, returns false if the leaf has been replaced
+  // unless obsolete leaves are allowed
+  bool ReadLeaf(Leaf *leaf, std::vector<ValueType> &values,
+                bool allow_obsolete) {
+    std::vector<ValueType> leaf_values;
+
+    while (true) {
+      uint64_t version = leaf->version.load();
+      if (version & LATCH_BIT) {
+        std::this_thread::yield();
+        continue;
+      }
+      if ((version & OBSOLETE_BIT) && allow_obsolete == false) {
+        return false;
+      }
+
+      size_t count = std::min(leaf->count, leaf->capacity);
+      leaf_values.assign(leaf->values, leaf->values + count);
+
+      if (leaf->version.load() == version) {
+        values.insert(values.end(), leaf_values.begin(), leaf_values.end());
+        return true;
+      }
+    }
+  }
+
+  // Leaf of the given key, and the node holding it with its version and the
+  // byte of the leaf, or nullptr if the key is not in the tree
+  Leaf *FindLeaf(const KeyType &key, InnerNode *&node, uint64_t &version,
+                 uint8_t &byte, bool &restart) {
+    const uint8_t *bytes = key.GetBytes();
+    size_t length = key.GetLength();
+    size_t depth = 0;
+
+    node = root;
+    version = ReadLockOrRestart(node, restart);
+    if (restart) {
+      return nullptr;
+    }
+
+    while (true) {
+      size_t prefix_length = node->prefix_length;
+      if (depth + prefix_length >= length ||
+          (prefix_length > 0 &&
+           ::memcmp(node->prefix, bytes + depth, prefix_length) != 0)) {
+        CheckOrRestart(node, version, restart);
+        return nullptr;
+      }
+      depth += prefix_length;
+
+      byte = bytes[depth];
+      Node *child = FindChild(node, byte);
+      CheckOrRestart(node, version, restart);
+      if (restart || child == nullptr) {
+        return nullptr;
+      }
+
+      if (child->type == NODE_TYPE_LEAF) {
+        Leaf *leaf = static_cast<Leaf *>(child);
+        if (KeyEquals(leaf->key, key) == false) {
+          return nullptr;
+        }
+        return leaf;
+      }
+
+      uint64_t child_version = ReadLockOrRestart(child, restart);
+      if (restart) {
+        return nullptr;
+      }
+      CheckOrRestart(node, version, restart);
+      if (restart) {
+        return nullptr;
+      }
+
+      node = static_cast<InnerNode *>(child);
+      version = child_version;
+      depth++;
+    }
+  }
+
+  //===--------------------------------------------------------------------===//
+  // Insert
+  //===--------------------------------------------------------------------===//
+
+  enum InsertResult {
+    INSERT_RESULT_RESTART,
+    INSERT_RESULT_INSERTED,
+    INSERT_RESULT_REJECTED
+  };
+
+  bool InsertEntry(const KeyType &key, const ValueType &value,
+                   std::function<bool(const ValueType &)> *predicate) {
+    while (true) {
+      switch (TryInsertEntry(key, value, predicate)) {
+        case INSERT_RESULT_INSERTED:
+          return true;
+        case INSERT_RESULT_REJECTED:
+          return false;
+        case INSERT_RESULT_RESTART:
+        default:
+          break;
+      }
+    }
+  }
+
+  InsertResult TryInsertEntry(
+      const KeyType &key, const ValueType &value,
+      std::function<bool(const ValueType &)> *predicate) {
+    const uint8_t *bytes = key.GetBytes();
+    size_t length = key.GetLength();
+    size_t depth = 0;
+
+    bool restart = false;
+    InnerNode *node = root;
+    uint64_t version = ReadLockOrRestart(node, restart);
+    if (restart) {
+      return INSERT_RESULT_RESTART;
+    }
+
+    InnerNode *parent = nullptr;
+    uint64_t parent_version = 0;
+    uint8_t parent_byte = 0;
+
+    while (true) {
+      size_t prefix_length = node->prefix_length;
+      size_t mismatch = 0;
+      while (mismatch < prefix_length && depth + mismatch < length &&
+             node->prefix[mismatch] == bytes[depth + mismatch]) {
+        mismatch++;
+      }
+
+      // The key leaves the compressed path, split it with a new node
+      if (mismatch < prefix_length) {
+        CheckOrRestart(node, version, restart);
+        if (restart) {
+          return INSERT_RESULT_RESTART;
+        }
+        // No key is a prefix of another one
+        assert(depth + mismatch < length);
+
+        if (LockNodeAndParent(parent, parent_version, node, version) ==
+            false) {
+          return INSERT_RESULT_RESTART;
+        }
+
+        InnerNode *new_node = new Node4(node->prefix, mismatch);
+        memory_footprint += sizeof(Node4) + mismatch;
+        AddChild(new_node, node->prefix[mismatch], node);
+        AddChild(new_node, bytes[depth + mismatch], NewLeaf(key, value));
+        CutPrefix(node, mismatch + 1);
+        ChangeChild(parent, parent_byte, new_node);
+
+        WriteUnlock(node);
+        WriteUnlock(parent);
+        return INSERT_RESULT_INSERTED;
+      }
+      depth += prefix_length;
+
+      if (depth >= length) {
+        CheckOrRestart(node, version, restart);
+        assert(restart);
+        return INSERT_RESULT_RESTART;
+      }
+
+      uint8_t byte = bytes[depth];
+      Node *child = FindChild(node, byte);
+      CheckOrRestart(node, version, restart);
+      if (restart) {
+        return INSERT_RESULT_RESTART;
+      }
+
+      // Add the key below the node, in a larger node if it is full
+      if (child == nullptr) {
+        if (IsFull(node)) {
+          if (LockNodeAndParent(parent, parent_version, node, version) ==
+              false) {
+            return INSERT_RESULT_RESTART;
+          }
+
+          InnerNode *new_node = Grow(node);
+          AddChild(new_node, byte, NewLeaf(key, value));
+          ChangeChild(parent, parent_byte, new_node);
+
+          WriteUnlockObsolete(node);
+          Retire(node);
+          WriteUnlock(parent);
+          return INSERT_RESULT_INSERTED;
+        }
+
+        UpgradeToWriteLockOrRestart(node, version, restart);
+        if (restart) {
+          return INSERT_RESULT_RESTART;
+        }
+
+        AddChild(node, byte, NewLeaf(key, value));
+        WriteUnlock(node);
+        return INSERT_RESULT_INSERTED;
+      }
+
+      if (child->type == NODE_TYPE_LEAF) {
+        Leaf *leaf = static_cast<Leaf *>(child);
+        if (KeyEquals(leaf->key, key) == true) {
+          return InsertIntoLeaf(node, version, byte, leaf, value, predicate);
+        }
+
+        // Expand the path to the leaf down to where the keys differ
+        UpgradeToWriteLockOrRestart(node, version, restart);
+        if (restart) {
+          return INSERT_RESULT_RESTART;
+        }
+
+        const uint8_t *leaf_bytes = leaf->key.GetBytes();
+        size_t leaf_length = leaf->key.GetLength();
+        size_t begin = depth + 1;
+        size_t common = 0;
+        while (begin + common < length && begin + common < leaf_length &&
+               bytes[begin + common] == leaf_bytes[begin + common]) {
+          common++;
+        }
+        assert(begin + common < length && begin + common < leaf_length);
+
+        InnerNode *new_node = new Node4(bytes + begin, common);
+        memory_footprint += sizeof(Node4) + common;
+        AddChild(new_node, leaf_bytes[begin + common], leaf);
+        AddChild(new_node, bytes[begin + common], NewLeaf(key, value));
+        ChangeChild(node, byte, new_node);
+
+        WriteUnlock(node);
+        return INSERT_RESULT_INSERTED;
+      }
+
+      uint64_t child_version = ReadLockOrRestart(child, restart);
+      if (restart) {
+        return INSERT_RESULT_RESTART;
+      }
+      CheckOrRestart(node, version, restart);
+      if (restart) {
+        return INSERT_RESULT_RESTART;
+      }
+
+      parent = node;
+      parent_version = version;
+      parent_byte = byte;
+      node = static_cast<InnerNode *>(child);
+      version = child_version;
+      depth++;
+    }
+  }
+
+  // Add a value to the leaf of its key, a full leaf is replaced by one with
+  // twice the capacity
+  InsertResult InsertIntoLeaf(
+      InnerNode *node, uint64_t version, uint8_t byte, Leaf *leaf,
+      const ValueType &value,
+      std::function<bool(const ValueType &)> *predicate) {
+    bool restart = false;
+    uint64_t leaf_version = ReadLockOrRestart(leaf, restart);
+    if (restart) {
+      return INSERT_RESULT_RESTART;
+    }
+    CheckOrRestart(node, version, restart);
+    if (restart) {
+      return INSERT_RESULT_RESTART;
+    }
+
+    bool full = (leaf->count == leaf->capacity);
+    if (full) {
+      UpgradeToWriteLockOrRestart(node, version, restart);
+      if (restart) {
+        return INSERT_RESULT_RESTART;
+      }
+    }
+
+    UpgradeToWriteLockOrRestart(leaf, leaf_version, restart);
+    if (restart) {
+      if (full) {
+        WriteUnlock(node);
+      }
+      return INSERT_RESULT_RESTART;
+    }
+
+    InsertResult result = INSERT_RESULT_INSERTED;
+    if (predicate != nullptr) {
+      for (uint32_t value_itr = 0; value_itr < leaf->count; value_itr++) {
+        if ((*predicate)(leaf->values[value_itr]) == true) {
+          result = INSERT_RESULT_REJECTED;
+          break;
+        }
+      }
+    }
+
+    if (result == INSERT_RESULT_REJECTED) {
+      WriteUnlock(leaf);
+    } else if (full == false) {
+      leaf->values[leaf->count] = value;
+      leaf->count++;
+      WriteUnlock(leaf);
+    } else {
+      Leaf *new_leaf = new Leaf(leaf->key, leaf->capacity * 2);
+      memory_footprint += sizeof(Leaf) + new_leaf->capacity * sizeof(ValueType);
+      std::copy(leaf->values, leaf->values + leaf->count, new_leaf->values);
+      new_leaf->values[leaf->count] = value;
+      new_leaf->count = leaf->count + 1;
+      ChangeChild(node, byte, new_leaf);
+
+      WriteUnlockObsolete(leaf);
+      Retire(leaf);
+    }
+
+    if (full) {
+      WriteUnlock(node);
+    }
+    return result;
+  }
+
+  //===--------------------------------------------------------------------===//
+  // Scan
+  //===--------------------------------------------------------------------===//
+
+  // Copy the compressed path and the children of a node in byte order.
+  // Obsolete nodes are read as well, a scan may see a slightly stale tree.
+  void ReadInnerNode(InnerNode *node, std::vector<uint8_t> &prefix,
+                     std::vector<std::pair<uint8_t, Node *>> &children) {
+    while (true) {
+      uint64_t version = node->version.load();
+      if (version & LATCH_BIT) {
+        std::this_thread::yield();
+        continue;
+      }
+
+      prefix.assign(node->prefix, node->prefix + node->prefix_length);
+      children.clear();
+
+      switch (node->type) {
+        case NODE_TYPE_4: {
+          Node4 *node4 = static_cast<Node4 *>(node);
+          size_t count = GetCount(node4, 4);
+          for (size_t child_itr = 0; child_itr < count; child_itr++) {
+            children.push_back(std::make_pair(node4->keys[child_itr],
+                                              node4->children[child_itr]));
+          }
+        } break;
+        case NODE_TYPE_16: {
+          Node16 *node16 = static_cast<Node16 *>(node);
+          size_t count = GetCount(node16, 16);
+          for (size_t child_itr = 0; child_itr < count; child_itr++) {
+            children.push_back(std::make_pair(node16->keys[child_itr],
+                                              node16->children[child_itr]));
+          }
+        } break;
+        case NODE_TYPE_48: {
+          Node48 *node48 = static_cast<Node48 *>(node);
+          for (size_t byte_itr = 0; byte_itr < 256; byte_itr++) {
+            uint8_t slot = node48->child_index[byte_itr];
+            if (slot != Node48::EMPTY_SLOT) {
+              children.push_back(std::make_pair(
+                  static_cast<uint8_t>(byte_itr), node48->children[slot]));
+            }
+          }
+        } break;
+        case NODE_TYPE_256:
+        default: {
+          Node256 *node256 = static_cast<Node256 *>(node);
+          for (size_t byte_itr = 0; byte_itr < 256; byte_itr++) {
+            if (node256->children[byte_itr] != nullptr) {
+              children.push_back(std::make_pair(
+                  static_cast<uint8_t>(byte_itr), node256->children[byte_itr]));
+            }
+          }
+        } break;
+      }
+
+      if (node->version.load() == version) {
+        return;
+      }
+    }
+  }
+
+  // Visit the keys below the node that are not less than the start key,
+  // returns false once the visitor stops the scan
+  bool ScanNode(InnerNode *node, size_t depth, const KeyType *start_key,
+                std::function<bool(const KeyType &, const ValueType &)> &
+                    visitor) {
+    std::vector<uint8_t> prefix;
+    std::vector<std::pair<uint8_t, Node *>> children;
+    ReadInnerNode(node, prefix, children);
+
+    const uint8_t *start_bytes = nullptr;
+    size_t start_length = 0;
+    if (start_key != nullptr) {
+      start_bytes = start_key->GetBytes();
+      start_length = start_key->GetLength();
+
+      // Compare the compressed path with the start key
+      size_t compare_length = std::min(prefix.size(), start_length - depth);
+      int diff = ::memcmp(prefix.data(), start_bytes + depth, compare_length);
+      if (diff < 0) {
+        return true;
+      } else if (diff > 0 || compare_length < prefix.size()) {
+        start_key = nullptr;
+      }
+    }
+    depth += prefix.size();
+
+    std::vector<ValueType> values;
+    for (auto &child : children) {
+      if (child.second == nullptr) {
+        continue;
+      }
+
+      // Only the child on the path of the start key may hold smaller keys
+      const KeyType *child_start_key = nullptr;
+      if (start_key != nullptr && depth < start_length) {
+        if (child.first < start_bytes[depth]) {
+          continue;
+        } else if (child.first == start_bytes[depth]) {
+          child_start_key = start_key;
+        }
+      }
+
+      if (child.second->type != NODE_TYPE_LEAF) {
+        if (ScanNode(static_cast<InnerNode *>(child.second), depth + 1,
+                     child_start_key, visitor) == false) {
+          return false;
+        }
+        continue;
+      }
+
+      Leaf *leaf = static_cast<Leaf *>(child.second);
+      if (child_start_key != nullptr && KeyLess(leaf->key, *child_start_key)) {
+        continue;
+      }
+
+      values.clear();
+      ReadLeaf(leaf, values, true);
+      for (auto &value : values) {
+        if (visitor(leaf->key, value) == false) {
+          return false;
+        }
+      }
+    }
+
+    return true;
+  }
+
+  //===--------------------------------------------------------------------===//
+  // Memory Management
+  //===--------------------------------------------------------------------===//
+
+  // Free a replaced or removed node once no reader can reach it anymore
+  void Retire(Node *node) {
+    epoch_manager.RetireGarbage(node, &ART::FreeGarbage, this);
+  }
+
+  static void FreeGarbage(void *context, void *garbage) {
+    auto tree = static_cast<ART *>(context);
+    auto node = static_cast<Node *>(garbage);
+    tree->memory_footprint -= GetNodeSize(node);
+    DeleteNode(node);
+  }
+
+  // Bytes of the node counted in the memory footprint
+  static size_t GetNodeSize(Node *node) {
+    switch (node->type) {
+      case NODE_TYPE_LEAF:
+        return sizeof(Leaf) +
+               static_cast<Leaf *>(node)->capacity * sizeof(ValueType);
+      case NODE_TYPE_4:
+        return sizeof(Node4) + static_cast<InnerNode *>(node)->prefix_length;
+      case NODE_TYPE_16:
+        return sizeof(Node16) + static_cast<InnerNode *>(node)->prefix_length;
+      case NODE_TYPE_48:
+        return sizeof(Node48) + static_cast<InnerNode *>(node)->prefix_length;
+      case NODE_TYPE_256:
+      default:
+        return sizeof(Node256) + static_cast<InnerNode *>(node)->prefix_length;
+    }
+  }
+
+  static void DeleteNode(Node *node) {
+    switch (node->type) {
+      case NODE_TYPE_LEAF:
+        delete static_cast<Leaf *>(node);
+        break;
+      case NODE_TYPE_4:
+        delete static_cast<Node4 *>(node);
+        break;
+      case NODE_TYPE_16:
+        delete static_cast<Node16 *>(node);
+        break;
+      case NODE_TYPE_48:
+        delete static_cast<Node48 *>(node);
+        break;
+      case NODE_TYPE_256:
+      default:
+        delete static_cast<Node256 *>(node);
+        break;
+    }
+  }
+
+  void FreeNode(Node *node) {
+    if (node->type != NODE_TYPE_LEAF) {
+      std::vector<uint8_t> prefix;
+      std::vector<std::pair<uint8_t, Node *>> children;
+      ReadInnerNode(static_cast<InnerNode *>(node), prefix, children);
+      for (auto &child : children) {
+        if (child.second != nullptr) {
+          FreeNode(child.second);
+        }
+      }
+    }
+    DeleteNode(node);
+  }
+
+  //===--------------------------------------------------------------------===//
+  // Members
+  //===--------------------------------------------------------------------===//
+
+  static const uint64_t OBSOLETE_BIT = 1;
+
+  static const uint64_t LATCH_BIT = 2;
+
+  ValueEqualityChecker value_equals;
+
+  InnerNode *root;
+
+  std::atomic<size_t> memory_footprint;
+
+  EpochManager epoch_manager;
+};
+
+}  // End index namespace
+}  // End peloton namespace
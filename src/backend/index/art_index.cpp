@@ -0,0 +1,178 @@
+//===----------------------------------------------------------------------===//
+//
+//                         PelotonDB
+//
+// art_index.cpp
+//
+// Identification: src/backend/index/art_index.cpp
+//
+// Copyright (c) 2015, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "backend/common/logger.h"
+#include "backend/index/art_index.h"
+#include "backend/index/index_key.h"
+#include "backend/index/index_scan_cursor.h"
+#include "backend/storage/tuple.h"
+
+#include <algorithm>
+#include <limits>
+
+namespace peloton {
+namespace index {
+
+template <typename KeyType, typename ValueType, class KeyEqualityChecker>
+ARTIndex<KeyType, ValueType, KeyEqualityChecker>::ARTIndex(
+    IndexMetadata *metadata)
+    : Index(metadata), equals(metadata) {}
+
+template <typename KeyType, typename ValueType, class KeyEqualityChecker>
+ARTIndex<KeyType, ValueType, KeyEqualityChecker>::~ARTIndex() {}
+
+template <typename KeyType, typename ValueType, class KeyEqualityChecker>
+bool ARTIndex<KeyType, ValueType, KeyEqualityChecker>::InsertEntry(
+    const storage::Tuple *key, const ItemPointer location) {
+  KeyType index_key;
+  index_key.SetFromKey(key);
+
+  // Insert the key, val pair
+  container.Insert(index_key, location);
+
+  return true;
+}
+
+template <typename KeyType, typename ValueType, class KeyEqualityChecker>
+bool ARTIndex<KeyType, ValueType, KeyEqualityChecker>::ConditionalInsertEntry(
+    const storage::Tuple *key, const ItemPointer location,
+    std::function<bool(const ItemPointer &)> predicate) {
+  KeyType index_key;
+  index_key.SetFromKey(key);
+
+  // Check the existing entries with the same key and insert atomically
+  return container.ConditionalInsert(index_key, location, predicate);
+}
+
+template <typename KeyType, typename ValueType, class KeyEqualityChecker>
+bool ARTIndex<KeyType, ValueType, KeyEqualityChecker>::DeleteEntry(
+    const storage::Tuple *key, const ItemPointer location) {
+  KeyType index_key;
+  index_key.SetFromKey(key);
+
+  // Delete the < key, location > pair
+  container.Delete(index_key, location);
+
+  return true;
+}
+
+template <typename KeyType, typename ValueType, class KeyEqualityChecker>
+std::vector<ItemPointer>
+ARTIndex<KeyType, ValueType, KeyEqualityChecker>::Scan(
+    const std::vector<Value> &values,
+    const std::vector<oid_t> &key_column_ids,
+    const std::vector<ExpressionType> &expr_types,
+    const ScanDirectionType& scan_direction) {
+  std::vector<ItemPointer> result;
+
+  switch(scan_direction){
+    case SCAN_DIRECTION_TYPE_FORWARD:
+    case SCAN_DIRECTION_TYPE_BACKWARD: {
+
+      // Scan the key range in forward direction in one batch
+      auto cursor = GetScanCursor(values, key_column_ids, expr_types,
+                                  SCAN_DIRECTION_TYPE_FORWARD);
+      cursor->GetNextBatch(result, std::numeric_limits<size_t>::max());
+
+      // Children are only visited in forward direction
+      if (scan_direction == SCAN_DIRECTION_TYPE_BACKWARD) {
+        std::reverse(result.begin(), result.end());
+      }
+
+    }
+    break;
+
+    case SCAN_DIRECTION_TYPE_INVALID:
+    default:
+      throw Exception("Invalid scan direction \n");
+      break;
+  }
+
+  return result;
+}
+
+template <typename KeyType, typename ValueType, class KeyEqualityChecker>
+std::vector<ItemPointer>
+ARTIndex<KeyType, ValueType, KeyEqualityChecker>::ScanAllKeys() {
+  std::vector<ItemPointer> result;
+
+  // scan all entries
+  container.Scan(nullptr, [&](const KeyType &, const ItemPointer &location) {
+    result.push_back(location);
+    return true;
+  });
+
+  return result;
+}
+
+/**
+ * @brief Return all locations related to this key.
+ */
+template <typename KeyType, typename ValueType, class KeyEqualityChecker>
+std::vector<ItemPointer>
+ARTIndex<KeyType, ValueType, KeyEqualityChecker>::ScanKey(
+    const storage::Tuple *key) {
+  std::vector<ItemPointer> result;
+  KeyType index_key;
+  index_key.SetFromKey(key);
+
+  // find the <key, location> pairs
+  container.GetValues(index_key, result);
+
+  return result;
+}
+
+template <typename KeyType, typename ValueType, class KeyEqualityChecker>
+std::unique_ptr<IndexScanCursor>
+ARTIndex<KeyType, ValueType, KeyEqualityChecker>::GetScanCursor(
+    const std::vector<Value> &values,
+    const std::vector<oid_t> &key_column_ids,
+    const std::vector<ExpressionType> &expr_types,
+    const ScanDirectionType& scan_direction) {
+  if (scan_direction == SCAN_DIRECTION_TYPE_INVALID) {
+    throw Exception("Invalid scan direction \n");
+  }
+
+  // Reverse scans collect the locations up front
+  if (scan_direction == SCAN_DIRECTION_TYPE_BACKWARD) {
+    return std::unique_ptr<IndexScanCursor>(new MaterializedIndexScanCursor(
+        Scan(values, key_column_ids, expr_types, scan_direction)));
+  }
+
+  // Every batch seeks to where the last one stopped
+  auto scan_function = [this](
+      const KeyType *scan_begin_key,
+      std::function<bool(const KeyType &, const ItemPointer &)> visitor) {
+    container.Scan(scan_begin_key, visitor);
+  };
+
+  return std::unique_ptr<IndexScanCursor>(
+      new OrderedIndexScanCursor<KeyType, KeyEqualityChecker>(
+          metadata, GetPool(), scan_function, values, key_column_ids,
+          expr_types));
+}
+
+template <typename KeyType, typename ValueType, class KeyEqualityChecker>
+std::string
+ARTIndex<KeyType, ValueType, KeyEqualityChecker>::GetTypeName() const {
+  return "ART";
+}
+
+// Explicit template instantiation
+template class ARTIndex<ARTKey<16>, ItemPointer, ARTKeyEqualityChecker<16>>;
+template class ARTIndex<ARTKey<32>, ItemPointer, ARTKeyEqualityChecker<32>>;
+template class ARTIndex<ARTKey<64>, ItemPointer, ARTKeyEqualityChecker<64>>;
+template class ARTIndex<ARTKey<128>, ItemPointer, ARTKeyEqualityChecker<128>>;
+template class ARTIndex<ARTKey<256>, ItemPointer, ARTKeyEqualityChecker<256>>;
+
+}  // End index namespace
+}  // End peloton namespace
@@ -0,0 +1,92 @@
+//===----------------------------------------------------------------------===//
+//
+//                         PelotonDB
+//
+// art_index.h
+//
+// Identification: src/backend/index/art_index.h
+//
+// Copyright (c) 2015, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <vector>
+#include <string>
+#include <map>
+
+#include "backend/catalog/manager.h"
+#include "backend/common/platform.h"
+#include "backend/common/types.h"
+#include "backend/index/index.h"
+#include "backend/index/index_key.h"
+
+#include "backend/index/art.h"
+
+namespace peloton {
+namespace index {
+
+/**
+ * Adaptive radix tree-based index implementation.
+ *
+ * The keys are stored in their complete memcmp-comparable encoding, so
+ * string keys only take the space of their actual bytes.
+ *
+ * @see Index
+ */
+template <typename KeyType, typename ValueType, class KeyEqualityChecker>
+class ARTIndex : public Index {
+  friend class IndexFactory;
+
+  // Define the container type
+  typedef ART<KeyType, ValueType, ItemPointerEqualityChecker> MapType;
+
+ public:
+  ARTIndex(IndexMetadata *metadata);
+
+  ~ARTIndex();
+
+  bool InsertEntry(const storage::Tuple *key, const ItemPointer location);
+
+  bool ConditionalInsertEntry(
+      const storage::Tuple *key, const ItemPointer location,
+      std::function<bool(const ItemPointer &)> predicate);
+
+  bool DeleteEntry(const storage::Tuple *key, const ItemPointer location);
+
+  std::vector<ItemPointer> Scan(const std::vector<Value> &values,
+                                const std::vector<oid_t> &key_column_ids,
+                                const std::vector<ExpressionType> &expr_types,
+                                const ScanDirectionType& scan_direction);
+
+  std::vector<ItemPointer> ScanAllKeys();
+
+  std::vector<ItemPointer> ScanKey(const storage::Tuple *key);
+
+  std::unique_ptr<IndexScanCursor> GetScanCursor(
+      const std::vector<Value> &values,
+      const std::vector<oid_t> &key_column_ids,
+      const std::vector<ExpressionType> &expr_types,
+      const ScanDirectionType& scan_direction);
+
+  std::string GetTypeName() const;
+
+  bool Cleanup() {
+    return true;
+  }
+
+  size_t GetMemoryFootprint() {
+    return container.GetMemoryFootprint();
+  }
+
+ protected:
+  // container
+  MapType container;
+
+  // equality checker
+  KeyEqualityChecker equals;
+};
+
+}  // End index namespace
+}  // End peloton namespace
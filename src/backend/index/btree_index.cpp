@@ -11,13 +11,21 @@
 //===----------------------------------------------------------------------===//
 
 #include "backend/index/btree_index.h"
+#include "backend/index/index_builder.h"
 #include "backend/index/index_key.h"
+#include "backend/index/index_scan_cursor.h"
 #include "backend/common/logger.h"
 #include "backend/storage/tuple.h"
 
+#include <algorithm>
+#include <limits>
+
 namespace peloton {
 namespace index {
 
+// Entries walked from the last key of a batch before descending the tree
+static const size_t MULTI_SCAN_KEY_WALK_LENGTH = 16;
+
 template <typename KeyType, typename ValueType, class KeyComparator, class KeyEqualityChecker>
 BTreeIndex<KeyType, ValueType, KeyComparator, KeyEqualityChecker>::BTreeIndex(
     IndexMetadata *metadata)
@@ -47,6 +55,35 @@ bool BTreeIndex<KeyType, ValueType, KeyComparator, KeyEqualityChecker>::InsertEn
   return true;
 }
 
+template <typename KeyType, typename ValueType, class KeyComparator, class KeyEqualityChecker>
+bool BTreeIndex<KeyType, ValueType, KeyComparator, KeyEqualityChecker>::ConditionalInsertEntry(
+    const storage::Tuple *key, const ItemPointer location,
+    std::function<bool(const ItemPointer &)> predicate) {
+  KeyType index_key;
+  index_key.SetFromKey(key);
+
+  {
+    index_lock.WriteLock();
+
+    // Check the existing entries with the same key
+    auto entries = container.equal_range(index_key);
+    for (auto entry = entries.first; entry != entries.second; ++entry) {
+      if (predicate(entry->second) == true) {
+        index_lock.Unlock();
+        return false;
+      }
+    }
+
+    // Insert the key, val pair right after the existing entries
+    container.insert(entries.second,
+                     std::pair<KeyType, ValueType>(index_key, location));
+
+    index_lock.Unlock();
+  }
+
+  return true;
+}
+
 template <typename KeyType, typename ValueType, class KeyComparator, class KeyEqualityChecker>
 bool BTreeIndex<KeyType, ValueType, KeyComparator, KeyEqualityChecker>::DeleteEntry(
     const storage::Tuple *key, const ItemPointer location) {
@@ -84,6 +121,42 @@ bool BTreeIndex<KeyType, ValueType, KeyComparator, KeyEqualityChecker>::DeleteEn
   return true;
 }
 
+template <typename KeyType, typename ValueType, class KeyComparator, class KeyEqualityChecker>
+void BTreeIndex<KeyType, ValueType, KeyComparator, KeyEqualityChecker>::BulkLoad(
+    size_t part_count, const ScanPartFunction &scan_part) {
+  // Only an empty tree can be built bottom up
+  if (container.empty() == false) {
+    Index::BulkLoad(part_count, scan_part);
+    return;
+  }
+
+  // Sort the entries in parallel, keeping the entries of a key in location
+  // order like the inserts do
+  std::vector<std::pair<KeyType, ValueType>> entries;
+  ItemPointerComparator location_comparator;
+  IndexBuilder::ExtractSortedEntries(
+      this, part_count, scan_part,
+      [&](const std::pair<KeyType, ValueType> &lhs,
+          const std::pair<KeyType, ValueType> &rhs) -> bool {
+        if (comparator(lhs.first, rhs.first)) {
+          return true;
+        } else if (comparator(rhs.first, lhs.first)) {
+          return false;
+        }
+        return location_comparator(lhs.second, rhs.second);
+      },
+      entries);
+
+  {
+    index_lock.WriteLock();
+
+    // Build the tree from its leaves
+    container.bulk_load(entries.begin(), entries.end());
+
+    index_lock.Unlock();
+  }
+}
+
 template <typename KeyType, typename ValueType, class KeyComparator, class KeyEqualityChecker>
 std::vector<ItemPointer>
 BTreeIndex<KeyType, ValueType, KeyComparator, KeyEqualityChecker>::Scan(
@@ -92,84 +165,83 @@ BTreeIndex<KeyType, ValueType, KeyComparator, KeyEqualityChecker>::Scan(
     const std::vector<ExpressionType> &expr_types,
     const ScanDirectionType& scan_direction) {
   std::vector<ItemPointer> result;
-  KeyType index_key;
+  IndexScanBounds bounds(metadata->GetKeySchema(), values, key_column_ids,
+                         expr_types);
 
-  {
-    index_lock.ReadLock();
+  switch(scan_direction){
+    case SCAN_DIRECTION_TYPE_FORWARD:
+    case SCAN_DIRECTION_TYPE_BACKWARD: {
 
-    // Check if we have leading (leftmost) column equality
-    // refer : http://www.postgresql.org/docs/8.2/static/indexes-multicolumn.html
-    oid_t leading_column_id = 0;
-    auto key_column_ids_itr = std::find(
-        key_column_ids.begin(), key_column_ids.end(), leading_column_id);
-
-    // SPECIAL CASE : leading column id is one of the key column ids
-    // and is involved in a equality constraint
-    bool special_case = false;
-    if (key_column_ids_itr != key_column_ids.end()) {
-      auto offset = std::distance(key_column_ids.begin(), key_column_ids_itr);
-      if (expr_types[offset] == EXPRESSION_TYPE_COMPARE_EQUAL) {
-        special_case = true;
+      // Skip scans visit the prefixes in forward direction
+      if (scan_direction == SCAN_DIRECTION_TYPE_BACKWARD &&
+          bounds.GetSkipColumnCount() == 0) {
+        ReverseScan(bounds, values, key_column_ids, expr_types, result);
+        break;
       }
-    }
 
-    LOG_TRACE("Special case : %d ", special_case);
+      // Scan the key range in forward direction in one batch
+      auto cursor = GetScanCursor(values, key_column_ids, expr_types,
+                                  SCAN_DIRECTION_TYPE_FORWARD);
+      cursor->GetNextBatch(result, std::numeric_limits<size_t>::max());
 
-    auto scan_begin_itr = container.begin();
-    std::unique_ptr<storage::Tuple> start_key;
-    bool all_constraints_are_equal = false;
+      if (scan_direction == SCAN_DIRECTION_TYPE_BACKWARD) {
+        std::reverse(result.begin(), result.end());
+      }
 
-    // If it is a special case, we can figure out the range to scan in the index
-    if (special_case == true) {
+    }
+    break;
 
-      start_key.reset(new storage::Tuple(metadata->GetKeySchema(), true));
-      index_key.SetFromKey(start_key.get());
+    case SCAN_DIRECTION_TYPE_INVALID:
+    default:
+      throw Exception("Invalid scan direction \n");
+      break;
+  }
+
+  return result;
+}
+
+template <typename KeyType, typename ValueType, class KeyComparator, class KeyEqualityChecker>
+void BTreeIndex<KeyType, ValueType, KeyComparator, KeyEqualityChecker>::ReverseScan(
+    const IndexScanBounds &bounds,
+    const std::vector<Value> &values,
+    const std::vector<oid_t> &key_column_ids,
+    const std::vector<ExpressionType> &expr_types,
+    std::vector<ItemPointer> &result) {
+  std::unique_ptr<storage::Tuple> end_key(
+      new storage::Tuple(metadata->GetKeySchema(), true));
+  KeyType index_key;
 
-      // Construct the lower bound key tuple
-      all_constraints_are_equal =
-          ConstructLowerBoundTuple(start_key.get(), values, key_column_ids, expr_types);
-      LOG_TRACE("All constraints are equal : %d ", all_constraints_are_equal);
+  {
+    index_lock.ReadLock();
 
-      // Set scan begin iterator
-      scan_begin_itr = container.equal_range(index_key).first;
+    // Start right after the upper bound key if we can construct it
+    auto scan_end_itr = container.end();
+    if (bounds.ConstructUpperBoundKey(end_key.get(), nullptr, GetPool()) ==
+        true) {
+      index_key.SetFromKey(end_key.get());
+      scan_end_itr = container.upper_bound(index_key);
     }
 
-    switch(scan_direction){
-      case SCAN_DIRECTION_TYPE_FORWARD:
-      case SCAN_DIRECTION_TYPE_BACKWARD: {
-
-        // Scan the index entries in forward direction
-        for (auto scan_itr = scan_begin_itr; scan_itr != container.end(); scan_itr++) {
-          auto scan_current_key = scan_itr->first;
-          auto tuple = scan_current_key.GetTupleForComparison(metadata->GetKeySchema());
-
-          // Compare the current key in the scan with "values" based on "expression types"
-          // For instance, "5" EXPR_GREATER_THAN "2" is true
-          if (Compare(tuple, key_column_ids, expr_types, values) == true) {
-            ItemPointer location = scan_itr->second;
-            result.push_back(location);
-          }
-          else {
-            // We can stop scanning if we know that all constraints are equal
-            if(all_constraints_are_equal == true) {
-              break;
-            }
-          }
-        }
+    // Scan the index entries in backward direction down to the lower bound
+    for (auto scan_itr = scan_end_itr; scan_itr != container.begin();) {
+      scan_itr--;
+      auto scan_current_key = scan_itr->first;
+      auto tuple = scan_current_key.GetTupleForComparison(metadata->GetKeySchema());
 
+      if (bounds.IsAfterUpperBound(tuple) == true) {
+        continue;
       }
-      break;
-
-      case SCAN_DIRECTION_TYPE_INVALID:
-      default:
-        throw Exception("Invalid scan direction \n");
+      if (bounds.IsBeforeLowerBound(tuple) == true) {
         break;
+      }
+
+      if (Compare(tuple, key_column_ids, expr_types, values) == true) {
+        result.push_back(scan_itr->second);
+      }
     }
 
     index_lock.Unlock();
   }
-
-  return result;
 }
 
 template <typename KeyType, typename ValueType, class KeyComparator, class KeyEqualityChecker>
@@ -221,6 +293,110 @@ BTreeIndex<KeyType, ValueType, KeyComparator, KeyEqualityChecker>::ScanKey(
   return result;
 }
 
+/**
+ * @brief Return the locations of a batch of keys.
+ * The keys are probed in key order under one latch. A key close to the last
+ * one is found by walking on from the entry of the last key, only keys
+ * further away descend from the root again.
+ */
+template <typename KeyType, typename ValueType, class KeyComparator, class KeyEqualityChecker>
+void BTreeIndex<KeyType, ValueType, KeyComparator, KeyEqualityChecker>::MultiScanKey(
+    const std::vector<const storage::Tuple *> &keys,
+    std::vector<std::vector<ItemPointer>> &locations) {
+  std::vector<KeyType> index_keys(keys.size());
+  std::vector<oid_t> key_order(keys.size());
+  for (oid_t key_itr = 0; key_itr < keys.size(); key_itr++) {
+    index_keys[key_itr].SetFromKey(keys[key_itr]);
+    key_order[key_itr] = key_itr;
+  }
+
+  std::sort(key_order.begin(), key_order.end(),
+            [this, &index_keys](const oid_t &lhs, const oid_t &rhs) -> bool {
+    return comparator(index_keys[lhs], index_keys[rhs]);
+  });
+
+  locations.assign(keys.size(), std::vector<ItemPointer>());
+
+  {
+    index_lock.ReadLock();
+
+    auto scan_itr = container.end();
+    bool has_position = false;
+    for (auto key_itr : key_order) {
+      auto &index_key = index_keys[key_itr];
+
+      // Walk a few entries on from the last key before descending
+      bool found = false;
+      if (has_position == true) {
+        size_t walk_length = 0;
+        while (scan_itr != container.end() &&
+               walk_length < MULTI_SCAN_KEY_WALK_LENGTH &&
+               comparator(scan_itr->first, index_key)) {
+          scan_itr++;
+          walk_length++;
+        }
+        found = (scan_itr == container.end() ||
+                 comparator(scan_itr->first, index_key) == false);
+      }
+
+      if (found == false) {
+        scan_itr = container.lower_bound(index_key);
+        has_position = true;
+      }
+
+      for (auto entry = scan_itr; entry != container.end(); entry++) {
+        if (comparator(index_key, entry->first) == true) {
+          break;
+        }
+        locations[key_itr].push_back(entry->second);
+      }
+    }
+
+    index_lock.Unlock();
+  }
+}
+
+template <typename KeyType, typename ValueType, class KeyComparator, class KeyEqualityChecker>
+std::unique_ptr<IndexScanCursor>
+BTreeIndex<KeyType, ValueType, KeyComparator, KeyEqualityChecker>::GetScanCursor(
+    const std::vector<Value> &values,
+    const std::vector<oid_t> &key_column_ids,
+    const std::vector<ExpressionType> &expr_types,
+    const ScanDirectionType& scan_direction) {
+  if (scan_direction == SCAN_DIRECTION_TYPE_INVALID) {
+    throw Exception("Invalid scan direction \n");
+  }
+
+  // Reverse scans collect the locations up front
+  if (scan_direction == SCAN_DIRECTION_TYPE_BACKWARD) {
+    return std::unique_ptr<IndexScanCursor>(new MaterializedIndexScanCursor(
+        Scan(values, key_column_ids, expr_types, scan_direction)));
+  }
+
+  // Every batch latches the index and seeks to where the last one stopped
+  auto scan_function = [this](
+      const KeyType *scan_begin_key,
+      std::function<bool(const KeyType &, const ItemPointer &)> visitor) {
+    PelotonReadLock lock(index_lock);
+
+    auto scan_itr = container.begin();
+    if (scan_begin_key != nullptr) {
+      scan_itr = container.lower_bound(*scan_begin_key);
+    }
+
+    for (; scan_itr != container.end(); scan_itr++) {
+      if (visitor(scan_itr->first, scan_itr->second) == false) {
+        break;
+      }
+    }
+  };
+
+  return std::unique_ptr<IndexScanCursor>(
+      new OrderedIndexScanCursor<KeyType, KeyEqualityChecker>(
+          metadata, GetPool(), scan_function, values, key_column_ids,
+          expr_types));
+}
+
 template <typename KeyType, typename ValueType, class KeyComparator, class KeyEqualityChecker>
 std::string
 BTreeIndex<KeyType, ValueType, KeyComparator, KeyEqualityChecker>::GetTypeName() const {
@@ -26,6 +26,8 @@
 namespace peloton {
 namespace index {
 
+class IndexScanBounds;
+
 /**
  * STX B+tree-based index implementation.
  *
@@ -45,8 +47,14 @@ class BTreeIndex : public Index {
 
   bool InsertEntry(const storage::Tuple *key, const ItemPointer location);
 
+  bool ConditionalInsertEntry(
+      const storage::Tuple *key, const ItemPointer location,
+      std::function<bool(const ItemPointer &)> predicate);
+
   bool DeleteEntry(const storage::Tuple *key, const ItemPointer location);
 
+  void BulkLoad(size_t part_count, const ScanPartFunction &scan_part);
+
   std::vector<ItemPointer> Scan(const std::vector<Value> &values,
                                 const std::vector<oid_t> &key_column_ids,
                                 const std::vector<ExpressionType> &expr_types,
@@ -56,6 +64,15 @@ class BTreeIndex : public Index {
 
   std::vector<ItemPointer> ScanKey(const storage::Tuple *key);
 
+  void MultiScanKey(const std::vector<const storage::Tuple *> &keys,
+                    std::vector<std::vector<ItemPointer>> &locations);
+
+  std::unique_ptr<IndexScanCursor> GetScanCursor(
+      const std::vector<Value> &values,
+      const std::vector<oid_t> &key_column_ids,
+      const std::vector<ExpressionType> &expr_types,
+      const ScanDirectionType& scan_direction);
+
   std::string GetTypeName() const;
 
   bool Cleanup() {
@@ -67,6 +84,13 @@ class BTreeIndex : public Index {
   }
 
  protected:
+  // Scan the key range in backward direction
+  void ReverseScan(const IndexScanBounds &bounds,
+                   const std::vector<Value> &values,
+                   const std::vector<oid_t> &key_column_ids,
+                   const std::vector<ExpressionType> &expr_types,
+                   std::vector<ItemPointer> &result);
+
   MapType container;
 
   // equality checker and comparator
@@ -12,16 +12,1191 @@
 
 #pragma once
 
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "backend/common/exception.h"
+#include "backend/index/epoch_manager.h"
+
 namespace peloton {
 namespace index {
 
-// Look up the stx btree interface for background.
-// peloton/third_party/stx/btree.h
-template <typename KeyType, typename ValueType, class KeyComparator>
+//===--------------------------------------------------------------------===//
+// BW Tree
+//===--------------------------------------------------------------------===//
+
+/**
+ * Latch-free B+tree (Levandoski et al., "The Bw-Tree: A B-tree for New
+ * Hardware Platforms", ICDE 2013).
+ *
+ * Nodes are addressed by logical page ids (PIDs) that the mapping table
+ * translates to the newest record of the node. Updates never modify a node
+ * in place; they prepend a delta record and install it with a CAS on the
+ * mapping table entry. Long delta chains are consolidated into a new base
+ * node, and the replaced records are reclaimed through the epoch manager.
+ *
+ * Structure modifications are split into steps that are each a single CAS:
+ * - split : a split delta moves the upper half of a node into a new right
+ *           sibling, then an index term for the sibling is posted to the
+ *           parent. Until then, readers reach the sibling through the side
+ *           link of the split node.
+ * - merge : a remove delta freezes an underfull leaf, a merge delta hands its
+ *           records over to the left sibling, then the index term of the
+ *           removed leaf is deleted from the parent. Threads that run into a
+ *           removed leaf restart their traversal until the merge completes.
+ * Inner nodes are split but never merged, and a leaf merge never runs at the
+ * same time as an inner node split, so that the parent of the removed leaf
+ * keeps its separators while the merge is in progress. The PID of a removed
+ * leaf goes back to the mapping table through the epoch manager, which holds
+ * at most 16M nodes at a time.
+ *
+ * Duplicate keys are supported; entries with equal keys are kept in insertion
+ * order, and deleting a < key, value > pair removes all its copies.
+ */
+template <typename KeyType, typename ValueType, class KeyComparator,
+          class KeyEqualityChecker, class ValueEqualityChecker>
 class BWTree {
+  BWTree(BWTree const &) = delete;
+
+ public:
+  typedef uint64_t PID;
+  typedef std::pair<KeyType, ValueType> KeyValuePair;
+
+  // < separator key, child > pair of an inner node, the key of the first
+  // child is the low key of the node
+  typedef std::pair<KeyType, PID> Separator;
+
+  BWTree(const KeyComparator &comparator, const KeyEqualityChecker &key_equals)
+      : comparator(comparator), key_equals(key_equals), next_pid(0),
+        memory_footprint(0), active_merges(0), active_inner_splits(0) {
+    for (size_t chunk_itr = 0; chunk_itr < MAPPING_TABLE_CHUNK_COUNT;
+         chunk_itr++) {
+      mapping_table[chunk_itr].store(nullptr);
+    }
+
+    // The tree starts out as an empty leaf
+    Node *root = new LeafNode(0);
+    RegisterNode(root);
+    root_pid.store(AllocatePID(root));
+  }
+
+  ~BWTree() {
+    epoch_manager.FreeAllGarbage();
+
+    PID pid_count = std::min<PID>(next_pid.load(),
+                                  MAPPING_TABLE_CHUNK_SIZE *
+                                  MAPPING_TABLE_CHUNK_COUNT);
+    for (PID pid = 0; pid < pid_count; pid++) {
+      Node *node = GetNode(pid);
+      if (node != nullptr) {
+        FreeChain(node);
+      }
+    }
+
+    for (size_t chunk_itr = 0; chunk_itr < MAPPING_TABLE_CHUNK_COUNT;
+         chunk_itr++) {
+      delete[] mapping_table[chunk_itr].load();
+    }
+  }
+
+  void Insert(const KeyType &key, const ValueType &value) {
+    EpochGuard guard(epoch_manager);
+    PID pid;
+
+    while (true) {
+      Node *head = FindNode(&key, 0, pid);
+      Node *delta = new LeafInsertDelta(head, key, value);
+      if (InstallNode(pid, head, delta)) {
+        RegisterNode(delta);
+        break;
+      }
+      delete delta;
+    }
+
+    AdjustNode(pid);
+  }
+
+  // Insert the pair unless the predicate holds for a value with the same key,
+  // the check and the insert are atomic
+  bool ConditionalInsert(const KeyType &key, const ValueType &value,
+                         std::function<bool(const ValueType &)> predicate) {
+    EpochGuard guard(epoch_manager);
+    PID pid;
+    std::vector<ValueType> values;
+
+    while (true) {
+      Node *head = FindNode(&key, 0, pid);
+
+      values.clear();
+      CollectLeafValues(head, key, values);
+      for (auto &existing_value : values) {
+        if (predicate(existing_value) == true) {
+          return false;
+        }
+      }
+
+      Node *delta = new LeafInsertDelta(head, key, value);
+      if (InstallNode(pid, head, delta)) {
+        RegisterNode(delta);
+        break;
+      }
+      delete delta;
+    }
+
+    AdjustNode(pid);
+    return true;
+  }
+
+  void Delete(const KeyType &key, const ValueType &value) {
+    EpochGuard guard(epoch_manager);
+    PID pid;
+    std::vector<ValueType> values;
+
+    while (true) {
+      Node *head = FindNode(&key, 0, pid);
+
+      values.clear();
+      CollectLeafValues(head, key, values);
+      size_t match_count = std::count_if(
+          values.begin(), values.end(), [&](const ValueType &existing_value) {
+            return value_equals(existing_value, value);
+          });
+
+      // Nothing to delete
+      if (match_count == 0) {
+        return;
+      }
+
+      Node *delta = new LeafDeleteDelta(head, key, value);
+      delta->item_count -= match_count;
+      if (InstallNode(pid, head, delta)) {
+        RegisterNode(delta);
+        break;
+      }
+      delete delta;
+    }
+
+    AdjustNode(pid);
+  }
+
+  // Get the values of the given key in insertion order
+  void GetValues(const KeyType &key, std::vector<ValueType> &values) {
+    EpochGuard guard(epoch_manager);
+    PID pid;
+
+    Node *head = FindNode(&key, 0, pid);
+    CollectLeafValues(head, key, values);
+  }
+
+  // Visit the entries in key order, starting at the first key not less than
+  // start_key (or the smallest key if start_key is nullptr), until the
+  // visitor returns false
+  void Scan(const KeyType *start_key,
+            std::function<bool(const KeyType &, const ValueType &)> visitor) {
+    EpochGuard guard(epoch_manager);
+    PID pid;
+    std::vector<KeyValuePair> items;
+
+    bool has_lower_key = (start_key != nullptr);
+    KeyType lower_key;
+    if (has_lower_key) {
+      lower_key = *start_key;
+    }
+
+    Node *head = FindNode(start_key, 0, pid);
+    while (true) {
+      items.clear();
+      CollectLeafItems(head, items);
+
+      // Skip the entries we have already visited in case leaves were merged
+      auto item_itr = items.begin();
+      if (has_lower_key) {
+        item_itr = std::lower_bound(
+            items.begin(), items.end(), lower_key,
+            [this](const KeyValuePair &item, const KeyType &key) {
+              return comparator(item.first, key);
+            });
+      }
+
+      for (; item_itr != items.end(); ++item_itr) {
+        if (visitor(item_itr->first, item_itr->second) == false) {
+          return;
+        }
+      }
+
+      if (head->has_high_key == false) {
+        return;
+      }
+
+      // Continue with the leaf that now holds the high key
+      lower_key = head->high_key;
+      has_lower_key = true;
+      head = FindNode(&lower_key, 0, pid);
+    }
+  }
+
+  size_t GetMemoryFootprint() const {
+    size_t chunk_count =
+        (std::min<PID>(next_pid.load(),
+                       MAPPING_TABLE_CHUNK_SIZE * MAPPING_TABLE_CHUNK_COUNT) +
+         MAPPING_TABLE_CHUNK_SIZE - 1) / MAPPING_TABLE_CHUNK_SIZE;
+
+    return sizeof(BWTree) + memory_footprint.load() +
+           chunk_count * MAPPING_TABLE_CHUNK_SIZE * sizeof(std::atomic<Node *>);
+  }
+
+  void PerformGarbageCollection() {
+    epoch_manager.PerformGarbageCollection();
+  }
+
+ private:
+  //===--------------------------------------------------------------------===//
+  // Nodes
+  //===--------------------------------------------------------------------===//
+
+  enum NodeType {
+    NODE_TYPE_LEAF,
+    NODE_TYPE_LEAF_INSERT,
+    NODE_TYPE_LEAF_DELETE,
+    NODE_TYPE_LEAF_SPLIT,
+    NODE_TYPE_LEAF_REMOVE,
+    NODE_TYPE_LEAF_MERGE,
+
+    NODE_TYPE_INNER,
+    NODE_TYPE_INNER_INSERT,
+    NODE_TYPE_INNER_DELETE,
+    NODE_TYPE_INNER_SPLIT
+  };
+
+  /**
+   * Record of a delta chain. Every record carries the attributes of the
+   * logical node as of that record, so that readers never have to walk the
+   * chain to find the key range of a node.
+   */
+  struct Node {
+    Node(NodeType type, size_t level)
+        : type(type), level(level), depth(0), item_count(0),
+          has_low_key(false), has_high_key(false), next(INVALID_PID),
+          child(nullptr) {}
+
+    Node(NodeType type, Node *child)
+        : type(type), level(child->level), depth(child->depth + 1),
+          item_count(child->item_count), has_low_key(child->has_low_key),
+          low_key(child->low_key), has_high_key(child->has_high_key),
+          high_key(child->high_key), next(child->next), child(child) {}
+
+    virtual ~Node() {}
+
+    void CopyRange(const Node *node) {
+      has_low_key = node->has_low_key;
+      low_key = node->low_key;
+      has_high_key = node->has_high_key;
+      high_key = node->high_key;
+      next = node->next;
+    }
+
+    NodeType type;
+
+    // leaves are at level 0
+    size_t level;
+
+    // number of deltas down to the base node
+    size_t depth;
+
+    // number of entries of the logical node
+    size_t item_count;
+
+    // the node holds the keys in [low_key, high_key), a missing key is
+    // treated as infinity
+    bool has_low_key;
+    KeyType low_key;
+    bool has_high_key;
+    KeyType high_key;
+
+    // right sibling
+    PID next;
+
+    // next older record, nullptr for base nodes
+    Node *child;
+  };
+
+  struct LeafNode : public Node {
+    LeafNode(size_t level) : Node(NODE_TYPE_LEAF, level) {}
+
+    // sorted by key
+    std::vector<KeyValuePair> items;
+  };
+
+  struct LeafInsertDelta : public Node {
+    LeafInsertDelta(Node *child, const KeyType &key, const ValueType &value)
+        : Node(NODE_TYPE_LEAF_INSERT, child), key(key), value(value) {
+      this->item_count++;
+    }
+
+    KeyType key;
+    ValueType value;
+  };
+
+  struct LeafDeleteDelta : public Node {
+    LeafDeleteDelta(Node *child, const KeyType &key, const ValueType &value)
+        : Node(NODE_TYPE_LEAF_DELETE, child), key(key), value(value) {}
+
+    KeyType key;
+    ValueType value;
+  };
+
+  // The split key and the new sibling are the high key and next of the delta
+  struct SplitDelta : public Node {
+    SplitDelta(NodeType type, Node *child) : Node(type, child) {}
+  };
+
+  struct LeafRemoveDelta : public Node {
+    LeafRemoveDelta(Node *child) : Node(NODE_TYPE_LEAF_REMOVE, child) {}
+  };
+
+  struct LeafMergeDelta : public Node {
+    LeafMergeDelta(Node *child, Node *right)
+        : Node(NODE_TYPE_LEAF_MERGE, child), merge_key(right->low_key),
+          right(right) {
+      this->item_count += right->item_count;
+      this->has_high_key = right->has_high_key;
+      this->high_key = right->high_key;
+      this->next = right->next;
+    }
+
+    KeyType merge_key;
+
+    // records of the removed right sibling, owned by this delta
+    Node *right;
+  };
+
+  struct InnerNode : public Node {
+    InnerNode(size_t level) : Node(NODE_TYPE_INNER, level) {}
+
+    // sorted by key, the key of the first separator is not used
+    std::vector<Separator> separators;
+  };
+
+  struct InnerInsertDelta : public Node {
+    InnerInsertDelta(Node *child, const KeyType &key, PID pid)
+        : Node(NODE_TYPE_INNER_INSERT, child), key(key), pid(pid) {
+      this->item_count++;
+    }
+
+    KeyType key;
+    PID pid;
+  };
+
+  struct InnerDeleteDelta : public Node {
+    InnerDeleteDelta(Node *child, const KeyType &key)
+        : Node(NODE_TYPE_INNER_DELETE, child), key(key) {
+      this->item_count--;
+    }
+
+    KeyType key;
+  };
+
+  //===--------------------------------------------------------------------===//
+  // Mapping Table
+  //===--------------------------------------------------------------------===//
+
+  PID AllocatePID(Node *node) {
+    // Reuse the PID of a removed leaf if there is one
+    {
+      std::lock_guard<std::mutex> lock(free_pids_mutex);
+      if (free_pids.empty() == false) {
+        PID pid = free_pids.back();
+        free_pids.pop_back();
+        GetSlot(pid).store(node);
+        return pid;
+      }
+    }
+
+    PID pid = next_pid.fetch_add(1);
+    if (pid >= MAPPING_TABLE_CHUNK_SIZE * MAPPING_TABLE_CHUNK_COUNT) {
+      throw IndexException("BWTree mapping table is full");
+    }
+
+    auto &chunk = mapping_table[pid / MAPPING_TABLE_CHUNK_SIZE];
+    std::atomic<Node *> *slots = chunk.load();
+
+    // Chunks are allocated on demand
+    if (slots == nullptr) {
+      std::atomic<Node *> *new_slots =
+          new std::atomic<Node *>[MAPPING_TABLE_CHUNK_SIZE];
+      for (size_t slot_itr = 0; slot_itr < MAPPING_TABLE_CHUNK_SIZE;
+           slot_itr++) {
+        new_slots[slot_itr].store(nullptr);
+      }
+
+      if (chunk.compare_exchange_strong(slots, new_slots)) {
+        slots = new_slots;
+      } else {
+        delete[] new_slots;
+      }
+    }
+
+    slots[pid % MAPPING_TABLE_CHUNK_SIZE].store(node);
+    return pid;
+  }
+
+  std::atomic<Node *> &GetSlot(PID pid) const {
+    return mapping_table[pid / MAPPING_TABLE_CHUNK_SIZE]
+        .load()[pid % MAPPING_TABLE_CHUNK_SIZE];
+  }
+
+  Node *GetNode(PID pid) const { return GetSlot(pid).load(); }
+
+  // Hand back a PID nobody can reach anymore
+  void ReleasePID(PID pid) {
+    GetSlot(pid).store(nullptr);
+
+    std::lock_guard<std::mutex> lock(free_pids_mutex);
+    free_pids.push_back(pid);
+  }
+
+  bool InstallNode(PID pid, Node *expected, Node *node) {
+    return GetSlot(pid).compare_exchange_strong(expected, node);
+  }
+
+  //===--------------------------------------------------------------------===//
+  // Traversal
+  //===--------------------------------------------------------------------===//
+
+  bool KeyLessEqual(const KeyType &lhs, const KeyType &rhs) const {
+    return comparator(rhs, lhs) == false;
+  }
+
+  // Whether a delta newer than the given record inserts or deletes the key
+  bool IsKeyOverridden(const Node *head, const Node *node,
+                       const KeyType &key) const {
+    for (; head != node; head = head->child) {
+      if (head->type == NODE_TYPE_INNER_INSERT &&
+          key_equals(static_cast<const InnerInsertDelta *>(head)->key, key)) {
+        return true;
+      } else if (head->type == NODE_TYPE_INNER_DELETE &&
+                 key_equals(static_cast<const InnerDeleteDelta *>(head)->key,
+                            key)) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  // Child of an inner node that holds the key, or the leftmost child if the
+  // key is nullptr
+  PID FindChild(const Node *head, const KeyType *key) const {
+    const InnerInsertDelta *best = nullptr;
+    const Node *node = head;
+
+    // Newest separator inserted by a delta that is not larger than the key
+    for (; node->type != NODE_TYPE_INNER; node = node->child) {
+      if (key == nullptr || node->type != NODE_TYPE_INNER_INSERT) {
+        continue;
+      }
+
+      auto delta = static_cast<const InnerInsertDelta *>(node);
+      if (KeyLessEqual(delta->key, *key) &&
+          (best == nullptr || comparator(best->key, delta->key)) &&
+          IsKeyOverridden(head, node, delta->key) == false) {
+        best = delta;
+      }
+    }
+
+    auto &separators = static_cast<const InnerNode *>(node)->separators;
+    if (key == nullptr) {
+      return separators.front().second;
+    }
+
+    // Largest separator of the base node that is not larger than the key
+    // and has not been deleted or replaced since
+    auto separator_itr = std::upper_bound(
+        separators.begin() + 1, separators.end(), *key,
+        [this](const KeyType &key, const Separator &separator) {
+          return comparator(key, separator.first);
+        });
+    size_t offset = std::distance(separators.begin(), separator_itr) - 1;
+    while (offset > 0 &&
+           IsKeyOverridden(head, node, separators[offset].first) == true) {
+      offset--;
+    }
+
+    if (best != nullptr &&
+        (offset == 0 || comparator(separators[offset].first, best->key))) {
+      return best->pid;
+    }
+    return separators[offset].second;
+  }
+
+  // Head of the node at the given level that holds the key, or of the
+  // leftmost node if the key is nullptr
+  Node *FindNode(const KeyType *key, const size_t level, PID &pid) {
+    while (true) {
+      pid = root_pid.load();
+      Node *node = GetNode(pid);
+
+      // The root is being split and the new root is not installed yet
+      if (node->level < level) {
+        std::this_thread::yield();
+        continue;
+      }
+
+      while (true) {
+        node = GetNode(pid);
+
+        // The node is being merged into its left sibling
+        if (node == nullptr || node->type == NODE_TYPE_LEAF_REMOVE) {
+          break;
+        }
+
+        // The node has been split, the key is on the right
+        if (key != nullptr && node->has_high_key &&
+            KeyLessEqual(node->high_key, *key)) {
+          pid = node->next;
+          continue;
+        }
+
+        if (node->level == level) {
+          return node;
+        }
+
+        pid = FindChild(node, key);
+      }
+
+      std::this_thread::yield();
+    }
+  }
+
+  //===--------------------------------------------------------------------===//
+  // Logical Nodes
+  //===--------------------------------------------------------------------===//
+
+  void ApplyLeafDelta(std::vector<KeyValuePair> &items,
+                      const Node *node) const {
+    auto key_comparator = [this](const KeyValuePair &lhs,
+                                 const KeyValuePair &rhs) {
+      return comparator(lhs.first, rhs.first);
+    };
+
+    if (node->type == NODE_TYPE_LEAF_INSERT) {
+      auto delta = static_cast<const LeafInsertDelta *>(node);
+      KeyValuePair item(delta->key, delta->value);
+
+      // Keep the values of a key in insertion order
+      items.insert(std::upper_bound(items.begin(), items.end(), item,
+                                    key_comparator),
+                   item);
+    } else {
+      auto delta = static_cast<const LeafDeleteDelta *>(node);
+      KeyValuePair item(delta->key, delta->value);
+
+      auto range =
+          std::equal_range(items.begin(), items.end(), item, key_comparator);
+      auto last = std::remove_if(range.first, range.second,
+                                 [&](const KeyValuePair &existing_item) {
+        return value_equals(existing_item.second, delta->value);
+      });
+      items.erase(last, range.second);
+    }
+  }
+
+  // Entries of a leaf in key order
+  void CollectLeafItems(const Node *node,
+                        std::vector<KeyValuePair> &items) const {
+    std::vector<const Node *> deltas;
+    while (node->type == NODE_TYPE_LEAF_INSERT ||
+           node->type == NODE_TYPE_LEAF_DELETE) {
+      deltas.push_back(node);
+      node = node->child;
+    }
+
+    switch (node->type) {
+      case NODE_TYPE_LEAF: {
+        auto &base_items = static_cast<const LeafNode *>(node)->items;
+        items.insert(items.end(), base_items.begin(), base_items.end());
+      } break;
+
+      case NODE_TYPE_LEAF_SPLIT: {
+        // Drop the entries that moved to the right sibling
+        size_t start = items.size();
+        CollectLeafItems(node->child, items);
+        auto split_itr = std::lower_bound(
+            items.begin() + start, items.end(), node->high_key,
+            [this](const KeyValuePair &item, const KeyType &key) {
+              return comparator(item.first, key);
+            });
+        items.erase(split_itr, items.end());
+      } break;
+
+      case NODE_TYPE_LEAF_MERGE: {
+        CollectLeafItems(node->child, items);
+        CollectLeafItems(static_cast<const LeafMergeDelta *>(node)->right,
+                         items);
+      } break;
+
+      case NODE_TYPE_LEAF_REMOVE:
+        CollectLeafItems(node->child, items);
+        break;
+
+      default:
+        assert(false);
+        break;
+    }
+
+    for (auto delta_itr = deltas.rbegin(); delta_itr != deltas.rend();
+         ++delta_itr) {
+      ApplyLeafDelta(items, *delta_itr);
+    }
+  }
+
+  // Values of the given key in a leaf
+  void CollectLeafValues(const Node *node, const KeyType &key,
+                         std::vector<ValueType> &values) const {
+    switch (node->type) {
+      case NODE_TYPE_LEAF: {
+        auto &items = static_cast<const LeafNode *>(node)->items;
+        auto item_itr = std::lower_bound(
+            items.begin(), items.end(), key,
+            [this](const KeyValuePair &item, const KeyType &key) {
+              return comparator(item.first, key);
+            });
+        for (; item_itr != items.end() && !comparator(key, item_itr->first);
+             ++item_itr) {
+          values.push_back(item_itr->second);
+        }
+      } break;
+
+      case NODE_TYPE_LEAF_INSERT: {
+        CollectLeafValues(node->child, key, values);
+        auto delta = static_cast<const LeafInsertDelta *>(node);
+        if (key_equals(delta->key, key)) {
+          values.push_back(delta->value);
+        }
+      } break;
+
+      case NODE_TYPE_LEAF_DELETE: {
+        CollectLeafValues(node->child, key, values);
+        auto delta = static_cast<const LeafDeleteDelta *>(node);
+        if (key_equals(delta->key, key)) {
+          values.erase(std::remove_if(values.begin(), values.end(),
+                                      [&](const ValueType &value) {
+                         return value_equals(value, delta->value);
+                       }),
+                       values.end());
+        }
+      } break;
+
+      case NODE_TYPE_LEAF_SPLIT:
+        if (comparator(key, node->high_key)) {
+          CollectLeafValues(node->child, key, values);
+        }
+        break;
+
+      case NODE_TYPE_LEAF_MERGE: {
+        auto delta = static_cast<const LeafMergeDelta *>(node);
+        if (comparator(key, delta->merge_key)) {
+          CollectLeafValues(node->child, key, values);
+        } else {
+          CollectLeafValues(delta->right, key, values);
+        }
+      } break;
+
+      case NODE_TYPE_LEAF_REMOVE:
+        CollectLeafValues(node->child, key, values);
+        break;
+
+      default:
+        assert(false);
+        break;
+    }
+  }
+
+  // Separators of an inner node in key order
+  void CollectInnerSeparators(const Node *node,
+                              std::vector<Separator> &separators) const {
+    std::vector<const Node *> deltas;
+    while (node->type == NODE_TYPE_INNER_INSERT ||
+           node->type == NODE_TYPE_INNER_DELETE) {
+      deltas.push_back(node);
+      node = node->child;
+    }
+
+    auto separator_comparator = [this](const Separator &separator,
+                                       const KeyType &key) {
+      return comparator(separator.first, key);
+    };
+
+    if (node->type == NODE_TYPE_INNER) {
+      separators = static_cast<const InnerNode *>(node)->separators;
+    } else {
+      assert(node->type == NODE_TYPE_INNER_SPLIT);
+
+      // Drop the separators that moved to the right sibling
+      CollectInnerSeparators(node->child, separators);
+      separators.erase(
+          std::lower_bound(separators.begin() + 1, separators.end(),
+                           node->high_key, separator_comparator),
+          separators.end());
+    }
+
+    for (auto delta_itr = deltas.rbegin(); delta_itr != deltas.rend();
+         ++delta_itr) {
+      const Node *delta = *delta_itr;
+
+      if (delta->type == NODE_TYPE_INNER_INSERT) {
+        auto insert_delta = static_cast<const InnerInsertDelta *>(delta);
+        auto separator_itr =
+            std::lower_bound(separators.begin() + 1, separators.end(),
+                             insert_delta->key, separator_comparator);
+        separators.insert(separator_itr,
+                          Separator(insert_delta->key, insert_delta->pid));
+      } else {
+        auto delete_delta = static_cast<const InnerDeleteDelta *>(delta);
+        auto separator_itr =
+            std::lower_bound(separators.begin() + 1, separators.end(),
+                             delete_delta->key, separator_comparator);
+        if (separator_itr != separators.end() &&
+            key_equals(separator_itr->first, delete_delta->key)) {
+          separators.erase(separator_itr);
+        }
+      }
+    }
+  }
+
+  // Whether the inner node routes the key to a child of its own
+  bool HasSeparator(const Node *node, const KeyType &key) const {
+    for (; node->type != NODE_TYPE_INNER; node = node->child) {
+      if (node->type == NODE_TYPE_INNER_INSERT &&
+          key_equals(static_cast<const InnerInsertDelta *>(node)->key, key)) {
+        return true;
+      } else if (node->type == NODE_TYPE_INNER_DELETE &&
+                 key_equals(static_cast<const InnerDeleteDelta *>(node)->key,
+                            key)) {
+        return false;
+      }
+    }
+
+    auto &separators = static_cast<const InnerNode *>(node)->separators;
+    auto separator_itr = std::lower_bound(
+        separators.begin() + 1, separators.end(), key,
+        [this](const Separator &separator, const KeyType &key) {
+          return comparator(separator.first, key);
+        });
+    return separator_itr != separators.end() &&
+           key_equals(separator_itr->first, key);
+  }
+
+  //===--------------------------------------------------------------------===//
+  // Structure Modifications
+  //===--------------------------------------------------------------------===//
+
+  // Consolidate, split or merge the node after an update if needed
+  void AdjustNode(PID pid) {
+    Node *head = GetNode(pid);
+    if (head == nullptr || head->type == NODE_TYPE_LEAF_REMOVE ||
+        head->depth < MAX_DELTA_CHAIN_LENGTH) {
+      return;
+    }
+
+    Node *base = ConsolidateNode(pid, head);
+    if (base == nullptr) {
+      return;
+    }
+
+    if (base->level == 0) {
+      if (base->item_count > LEAF_NODE_MAX_SIZE) {
+        SplitNode(pid, base);
+      } else if (base->item_count < LEAF_NODE_MIN_SIZE && base->has_low_key) {
+        MergeNode(pid, base);
+      }
+    } else if (base->item_count > INNER_NODE_MAX_SIZE) {
+      SplitNode(pid, base);
+    }
+  }
+
+  // Replace a delta chain with a base node, return nullptr if the chain
+  // changed in the meantime
+  Node *ConsolidateNode(PID pid, Node *head) {
+    Node *base;
+
+    if (head->level == 0) {
+      LeafNode *leaf = new LeafNode(0);
+      CollectLeafItems(head, leaf->items);
+      leaf->item_count = leaf->items.size();
+      base = leaf;
+    } else {
+      InnerNode *inner = new InnerNode(head->level);
+      CollectInnerSeparators(head, inner->separators);
+      inner->item_count = inner->separators.size();
+      base = inner;
+    }
+    base->CopyRange(head);
+
+    if (InstallNode(pid, head, base) == false) {
+      delete base;
+      return nullptr;
+    }
+
+    RegisterNode(base);
+    RetireChain(head);
+    return base;
+  }
+
+  // Move the upper half of a base node into a new right sibling
+  void SplitNode(PID pid, Node *base) {
+    Node *right;
+    size_t split_offset;
+
+    if (base->level == 0) {
+      auto &items = static_cast<LeafNode *>(base)->items;
+
+      // All values of a key must stay in the same leaf
+      split_offset = items.size() / 2;
+      while (split_offset > 0 &&
+             key_equals(items[split_offset - 1].first,
+                        items[split_offset].first)) {
+        split_offset--;
+      }
+      if (split_offset == 0) {
+        split_offset = items.size() / 2;
+        while (split_offset < items.size() &&
+               key_equals(items[split_offset - 1].first,
+                          items[split_offset].first)) {
+          split_offset++;
+        }
+        if (split_offset == items.size()) {
+          return;
+        }
+      }
+
+      LeafNode *leaf = new LeafNode(0);
+      leaf->items.assign(items.begin() + split_offset, items.end());
+      leaf->item_count = leaf->items.size();
+      leaf->low_key = items[split_offset].first;
+      right = leaf;
+    } else {
+      auto &separators = static_cast<InnerNode *>(base)->separators;
+      split_offset = separators.size() / 2;
+
+      InnerNode *inner = new InnerNode(base->level);
+      inner->separators.assign(separators.begin() + split_offset,
+                               separators.end());
+      inner->item_count = inner->separators.size();
+      inner->low_key = separators[split_offset].first;
+      right = inner;
+    }
+
+    right->has_low_key = true;
+    right->has_high_key = base->has_high_key;
+    right->high_key = base->high_key;
+    right->next = base->next;
+    PID right_pid = AllocatePID(right);
+
+    Node *delta = new SplitDelta(
+        base->level == 0 ? NODE_TYPE_LEAF_SPLIT : NODE_TYPE_INNER_SPLIT, base);
+    delta->item_count = split_offset;
+    delta->has_high_key = true;
+    delta->high_key = right->low_key;
+    delta->next = right_pid;
+
+    // The parent of a leaf being merged must keep its separators
+    bool installed = false;
+    if (base->level == 0 || BeginInnerSplit()) {
+      installed = InstallNode(pid, base, delta);
+      if (base->level != 0) {
+        EndInnerSplit();
+      }
+    }
+
+    if (installed == false) {
+      // Nobody knows about the right sibling yet
+      ReleasePID(right_pid);
+      delete right;
+      delete delta;
+      return;
+    }
+
+    RegisterNode(right);
+    RegisterNode(delta);
+
+    InsertIndexTerm(pid, base->level + 1, right->low_key, right_pid);
+  }
+
+  // Post the separator of a new right sibling to the parent level
+  void InsertIndexTerm(PID left_pid, const size_t level, const KeyType &key,
+                       PID right_pid) {
+    while (true) {
+      PID pid = root_pid.load();
+
+      if (GetNode(pid)->level < level) {
+        // Grow the tree if we split the root
+        if (pid == left_pid) {
+          InnerNode *root = new InnerNode(level);
+          root->separators.push_back(Separator(KeyType(), left_pid));
+          root->separators.push_back(Separator(key, right_pid));
+          root->item_count = root->separators.size();
+          RegisterNode(root);
+          root_pid.store(AllocatePID(root));
+          return;
+        }
+
+        // Wait for the thread that split the root
+        std::this_thread::yield();
+        continue;
+      }
+
+      Node *head = FindNode(&key, level, pid);
+      if (HasSeparator(head, key) == true) {
+        return;
+      }
+
+      Node *delta = new InnerInsertDelta(head, key, right_pid);
+      if (InstallNode(pid, head, delta)) {
+        RegisterNode(delta);
+        AdjustNode(pid);
+        return;
+      }
+      delete delta;
+    }
+  }
+
+  // Merge an underfull leaf into its left sibling
+  void MergeNode(PID pid, Node *base) {
+    if (BeginMerge() == false) {
+      return;
+    }
+
+    // (A) Freeze the leaf
+    Node *remove = new LeafRemoveDelta(base);
+    if (InstallNode(pid, base, remove) == false) {
+      delete remove;
+      EndMerge();
+      return;
+    }
+    RegisterNode(remove);
+
+    // (B) Find the left sibling through the parent, the leaf must not be the
+    // leftmost child so that its range falls to the left sibling
+    const KeyType &merge_key = base->low_key;
+    PID parent_pid;
+    Node *parent = FindNode(&merge_key, 1, parent_pid);
+
+    std::vector<Separator> separators;
+    CollectInnerSeparators(parent, separators);
+
+    PID left_pid = INVALID_PID;
+    for (size_t separator_itr = 1; separator_itr < separators.size();
+         separator_itr++) {
+      if (separators[separator_itr].second == pid) {
+        left_pid = separators[separator_itr - 1].second;
+        break;
+      }
+    }
+
+    // (C) Hand the entries over to the left sibling, which may have been
+    // split since the parent was updated
+    bool merged = false;
+    while (left_pid != INVALID_PID && left_pid != pid) {
+      Node *left = GetNode(left_pid);
+      if (left == nullptr || left->type == NODE_TYPE_LEAF_REMOVE) {
+        break;
+      }
+
+      if (left->next == pid) {
+        Node *delta = new LeafMergeDelta(left, base);
+        if (InstallNode(left_pid, left, delta)) {
+          RegisterNode(delta);
+          merged = true;
+          break;
+        }
+        delete delta;
+        continue;
+      }
+
+      if (left->has_high_key == false ||
+          comparator(merge_key, left->high_key)) {
+        break;
+      }
+      left_pid = left->next;
+    }
+
+    if (merged == false) {
+      // Nobody may update a frozen leaf, so the undo cannot fail
+      bool restored = InstallNode(pid, remove, base);
+      assert(restored);
+      (void)restored;
+      RetireNode(remove);
+      EndMerge();
+      return;
+    }
+
+    // (D) Remove the index term of the leaf from the parent
+    while (true) {
+      parent = FindNode(&merge_key, 1, parent_pid);
+      Node *delta = new InnerDeleteDelta(parent, merge_key);
+      if (InstallNode(parent_pid, parent, delta)) {
+        RegisterNode(delta);
+        break;
+      }
+      delete delta;
+    }
+
+    // The entries are owned by the merge delta now
+    GetSlot(pid).store(nullptr);
+    RetireNode(remove);
+    RetirePID(pid);
+    EndMerge();
+
+    AdjustNode(parent_pid);
+  }
+
+  // A leaf merge and an inner node split never overlap, either of them backs
+  // off and is retried on a later consolidation
+  bool BeginMerge() {
+    active_merges++;
+    if (active_inner_splits.load() > 0) {
+      active_merges--;
+      return false;
+    }
+    return true;
+  }
+
+  void EndMerge() { active_merges--; }
+
+  bool BeginInnerSplit() {
+    active_inner_splits++;
+    if (active_merges.load() > 0) {
+      active_inner_splits--;
+      return false;
+    }
+    return true;
+  }
+
+  void EndInnerSplit() { active_inner_splits--; }
+
+  //===--------------------------------------------------------------------===//
+  // Memory Management
+  //===--------------------------------------------------------------------===//
+
+  static size_t GetNodeSize(const Node *node) {
+    switch (node->type) {
+      case NODE_TYPE_LEAF:
+        return sizeof(LeafNode) +
+               static_cast<const LeafNode *>(node)->items.capacity() *
+                   sizeof(KeyValuePair);
+      case NODE_TYPE_LEAF_INSERT:
+        return sizeof(LeafInsertDelta);
+      case NODE_TYPE_LEAF_DELETE:
+        return sizeof(LeafDeleteDelta);
+      case NODE_TYPE_LEAF_MERGE:
+        return sizeof(LeafMergeDelta);
+      case NODE_TYPE_INNER:
+        return sizeof(InnerNode) +
+               static_cast<const InnerNode *>(node)->separators.capacity() *
+                   sizeof(Separator);
+      case NODE_TYPE_INNER_INSERT:
+        return sizeof(InnerInsertDelta);
+      case NODE_TYPE_INNER_DELETE:
+        return sizeof(InnerDeleteDelta);
+      default:
+        return sizeof(Node);
+    }
+  }
+
+  void RegisterNode(const Node *node) {
+    memory_footprint += GetNodeSize(node);
+  }
+
+  void FreeNode(Node *node) {
+    memory_footprint -= GetNodeSize(node);
+    delete node;
+  }
+
+  // Free a delta chain along with the records of the leaves merged into it
+  void FreeChain(Node *node) {
+    // A remove delta does not own the records below it
+    if (node->type == NODE_TYPE_LEAF_REMOVE) {
+      FreeNode(node);
+      return;
+    }
+
+    while (node != nullptr) {
+      Node *child = node->child;
+      if (node->type == NODE_TYPE_LEAF_MERGE) {
+        FreeChain(static_cast<LeafMergeDelta *>(node)->right);
+      }
+      FreeNode(node);
+      node = child;
+    }
+  }
+
+  static void FreeGarbage(void *context, void *garbage) {
+    static_cast<BWTree *>(context)->FreeChain(static_cast<Node *>(garbage));
+  }
+
+  void RetireChain(Node *node) {
+    epoch_manager.RetireGarbage(node, &BWTree::FreeGarbage, this);
+  }
+
+  void RetireNode(Node *node) {
+    assert(node->type == NODE_TYPE_LEAF_REMOVE);
+    epoch_manager.RetireGarbage(node, &BWTree::FreeGarbage, this);
+  }
+
+  static void FreePID(void *context, void *garbage) {
+    PID *pid = static_cast<PID *>(garbage);
+    static_cast<BWTree *>(context)->ReleasePID(*pid);
+    delete pid;
+  }
+
+  // Threads that looked the PID of a removed leaf up before its index term
+  // was deleted may still hold it, so it is reused only once they are gone
+  void RetirePID(PID pid) {
+    epoch_manager.RetireGarbage(new PID(pid), &BWTree::FreePID, this);
+  }
+
+  //===--------------------------------------------------------------------===//
+  // Members
+  //===--------------------------------------------------------------------===//
+
+  static const PID INVALID_PID = UINT64_MAX;
+
+  static const size_t MAPPING_TABLE_CHUNK_SIZE = 1 << 12;
+  static const size_t MAPPING_TABLE_CHUNK_COUNT = 1 << 12;
+
+  static const size_t MAX_DELTA_CHAIN_LENGTH = 8;
+  static const size_t LEAF_NODE_MAX_SIZE = 128;
+  static const size_t LEAF_NODE_MIN_SIZE = 16;
+  static const size_t INNER_NODE_MAX_SIZE = 128;
+
+  KeyComparator comparator;
+  KeyEqualityChecker key_equals;
+  ValueEqualityChecker value_equals;
+
+  // PID -> newest record of the node, in chunks allocated on demand
+  std::atomic<std::atomic<Node *> *> mapping_table[MAPPING_TABLE_CHUNK_COUNT];
+
+  std::atomic<PID> next_pid;
+
+  // PIDs of removed leaves, mapped to nullptr until they are reused
+  std::vector<PID> free_pids;
+  std::mutex free_pids_mutex;
+
+  std::atomic<PID> root_pid;
+
+  std::atomic<size_t> memory_footprint;
 
-  // Add your declarations here
+  std::atomic<int64_t> active_merges;
+  std::atomic<int64_t> active_inner_splits;
 
+  EpochManager epoch_manager;
 };
 
 }  // End index namespace
@@ -2,9 +2,9 @@
 //
 //                         PelotonDB
 //
-// btree_index.cpp
+// bwtree_index.cpp
 //
-// Identification: src/backend/index/btree_index.cpp
+// Identification: src/backend/index/bwtree_index.cpp
 //
 // Copyright (c) 2015, Carnegie Mellon University Database Group
 //
@@ -13,8 +13,12 @@
 #include "backend/common/logger.h"
 #include "backend/index/bwtree_index.h"
 #include "backend/index/index_key.h"
+#include "backend/index/index_scan_cursor.h"
 #include "backend/storage/tuple.h"
 
+#include <algorithm>
+#include <limits>
+
 namespace peloton {
 namespace index {
 
@@ -22,39 +26,80 @@ template <typename KeyType, typename ValueType, class KeyComparator, class KeyEq
 BWTreeIndex<KeyType, ValueType, KeyComparator, KeyEqualityChecker>::BWTreeIndex(
     IndexMetadata *metadata)
     : Index(metadata),
+      container(KeyComparator(metadata), KeyEqualityChecker(metadata)),
       equals(metadata),
-      comparator(metadata) {
-  // Add your implementation here
-}
+      comparator(metadata) {}
 
 template <typename KeyType, typename ValueType, class KeyComparator, class KeyEqualityChecker>
-BWTreeIndex<KeyType, ValueType, KeyComparator, KeyEqualityChecker>::~BWTreeIndex() {
-  // Add your implementation here
-}
+BWTreeIndex<KeyType, ValueType, KeyComparator, KeyEqualityChecker>::~BWTreeIndex() {}
 
 template <typename KeyType, typename ValueType, class KeyComparator, class KeyEqualityChecker>
 bool BWTreeIndex<KeyType, ValueType, KeyComparator, KeyEqualityChecker>::InsertEntry(
-    __attribute__((unused)) const storage::Tuple *key, __attribute__((unused)) const ItemPointer location) {
-  // Add your implementation here
-  return false;
+    const storage::Tuple *key, const ItemPointer location) {
+  KeyType index_key;
+  index_key.SetFromKey(key);
+
+  // Insert the key, val pair
+  container.Insert(index_key, location);
+
+  return true;
+}
+
+template <typename KeyType, typename ValueType, class KeyComparator, class KeyEqualityChecker>
+bool BWTreeIndex<KeyType, ValueType, KeyComparator, KeyEqualityChecker>::ConditionalInsertEntry(
+    const storage::Tuple *key, const ItemPointer location,
+    std::function<bool(const ItemPointer &)> predicate) {
+  KeyType index_key;
+  index_key.SetFromKey(key);
+
+  // Check the existing entries with the same key and insert atomically
+  return container.ConditionalInsert(index_key, location, predicate);
 }
 
 template <typename KeyType, typename ValueType, class KeyComparator, class KeyEqualityChecker>
 bool BWTreeIndex<KeyType, ValueType, KeyComparator, KeyEqualityChecker>::DeleteEntry(
-    __attribute__((unused)) const storage::Tuple *key, __attribute__((unused)) const ItemPointer location) {
-  // Add your implementation here
-  return false;
+    const storage::Tuple *key, const ItemPointer location) {
+  KeyType index_key;
+  index_key.SetFromKey(key);
+
+  // Delete the < key, location > pair
+  container.Delete(index_key, location);
+
+  return true;
 }
 
 template <typename KeyType, typename ValueType, class KeyComparator, class KeyEqualityChecker>
 std::vector<ItemPointer>
 BWTreeIndex<KeyType, ValueType, KeyComparator, KeyEqualityChecker>::Scan(
-    __attribute__((unused)) const std::vector<Value> &values,
-    __attribute__((unused)) const std::vector<oid_t> &key_column_ids,
-    __attribute__((unused)) const std::vector<ExpressionType> &expr_types,
-    __attribute__((unused)) const ScanDirectionType& scan_direction) {
+    const std::vector<Value> &values,
+    const std::vector<oid_t> &key_column_ids,
+    const std::vector<ExpressionType> &expr_types,
+    const ScanDirectionType& scan_direction) {
   std::vector<ItemPointer> result;
-  // Add your implementation here
+
+  switch(scan_direction){
+    case SCAN_DIRECTION_TYPE_FORWARD:
+    case SCAN_DIRECTION_TYPE_BACKWARD: {
+
+      // Scan the key range in forward direction in one batch
+      auto cursor = GetScanCursor(values, key_column_ids, expr_types,
+                                  SCAN_DIRECTION_TYPE_FORWARD);
+      cursor->GetNextBatch(result, std::numeric_limits<size_t>::max());
+
+      // The leaves are only linked in forward direction
+      if (scan_direction == SCAN_DIRECTION_TYPE_BACKWARD) {
+        std::reverse(result.begin(), result.end());
+      }
+
+    }
+    break;
+
+    case SCAN_DIRECTION_TYPE_INVALID:
+    default:
+      throw Exception("Invalid scan direction \n");
+      break;
+  }
+
   return result;
 }
 
@@ -62,7 +107,13 @@ template <typename KeyType, typename ValueType, class KeyComparator, class KeyEq
 std::vector<ItemPointer>
 BWTreeIndex<KeyType, ValueType, KeyComparator, KeyEqualityChecker>::ScanAllKeys() {
   std::vector<ItemPointer> result;
-  // Add your implementation here
+
+  // scan all entries
+  container.Scan(nullptr, [&](const KeyType &, const ItemPointer &location) {
+    result.push_back(location);
+    return true;
+  });
+
   return result;
 }
 
@@ -72,12 +123,47 @@ BWTreeIndex<KeyType, ValueType, KeyComparator, KeyEqualityChecker>::ScanAllKeys(
 template <typename KeyType, typename ValueType, class KeyComparator, class KeyEqualityChecker>
 std::vector<ItemPointer>
 BWTreeIndex<KeyType, ValueType, KeyComparator, KeyEqualityChecker>::ScanKey(
-    __attribute__((unused)) const storage::Tuple *key) {
+    const storage::Tuple *key) {
   std::vector<ItemPointer> result;
-  // Add your implementation here
+  KeyType index_key;
+  index_key.SetFromKey(key);
+
+  // find the <key, location> pairs
+  container.GetValues(index_key, result);
+
   return result;
 }
 
+template <typename KeyType, typename ValueType, class KeyComparator, class KeyEqualityChecker>
+std::unique_ptr<IndexScanCursor>
+BWTreeIndex<KeyType, ValueType, KeyComparator, KeyEqualityChecker>::GetScanCursor(
+    const std::vector<Value> &values,
+    const std::vector<oid_t> &key_column_ids,
+    const std::vector<ExpressionType> &expr_types,
+    const ScanDirectionType& scan_direction) {
+  if (scan_direction == SCAN_DIRECTION_TYPE_INVALID) {
+    throw Exception("Invalid scan direction \n");
+  }
+
+  // Reverse scans collect the locations up front
+  if (scan_direction == SCAN_DIRECTION_TYPE_BACKWARD) {
+    return std::unique_ptr<IndexScanCursor>(new MaterializedIndexScanCursor(
+        Scan(values, key_column_ids, expr_types, scan_direction)));
+  }
+
+  // Every batch seeks to where the last one stopped
+  auto scan_function = [this](
+      const KeyType *scan_begin_key,
+      std::function<bool(const KeyType &, const ItemPointer &)> visitor) {
+    container.Scan(scan_begin_key, visitor);
+  };
+
+  return std::unique_ptr<IndexScanCursor>(
+      new OrderedIndexScanCursor<KeyType, KeyEqualityChecker>(
+          metadata, GetPool(), scan_function, values, key_column_ids,
+          expr_types));
+}
+
 template <typename KeyType, typename ValueType, class KeyComparator, class KeyEqualityChecker>
 std::string
 BWTreeIndex<KeyType, ValueType, KeyComparator, KeyEqualityChecker>::GetTypeName() const {
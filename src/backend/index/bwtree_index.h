@@ -2,9 +2,9 @@
 //
 //                         PelotonDB
 //
-// btree_index.h
+// bwtree_index.h
 //
-// Identification: src/backend/index/btree_index.h
+// Identification: src/backend/index/bwtree_index.h
 //
 // Copyright (c) 2015, Carnegie Mellon University Database Group
 //
@@ -20,6 +20,7 @@
 #include "backend/common/platform.h"
 #include "backend/common/types.h"
 #include "backend/index/index.h"
+#include "backend/index/index_key.h"
 
 #include "backend/index/bwtree.h"
 
@@ -35,7 +36,9 @@ template <typename KeyType, typename ValueType, class KeyComparator, class KeyEq
 class BWTreeIndex : public Index {
   friend class IndexFactory;
 
-  typedef BWTree<KeyType, ValueType, KeyComparator> MapType;
+  // Define the container type
+  typedef BWTree<KeyType, ValueType, KeyComparator, KeyEqualityChecker,
+                 ItemPointerEqualityChecker> MapType;
 
  public:
   BWTreeIndex(IndexMetadata *metadata);
@@ -44,6 +47,10 @@ class BWTreeIndex : public Index {
 
   bool InsertEntry(const storage::Tuple *key, const ItemPointer location);
 
+  bool ConditionalInsertEntry(
+      const storage::Tuple *key, const ItemPointer location,
+      std::function<bool(const ItemPointer &)> predicate);
+
   bool DeleteEntry(const storage::Tuple *key, const ItemPointer location);
 
   std::vector<ItemPointer> Scan(const std::vector<Value> &values,
@@ -55,16 +62,21 @@ class BWTreeIndex : public Index {
 
   std::vector<ItemPointer> ScanKey(const storage::Tuple *key);
 
+  std::unique_ptr<IndexScanCursor> GetScanCursor(
+      const std::vector<Value> &values,
+      const std::vector<oid_t> &key_column_ids,
+      const std::vector<ExpressionType> &expr_types,
+      const ScanDirectionType& scan_direction);
+
   std::string GetTypeName() const;
 
-  // TODO: Implement this
   bool Cleanup() {
+    container.PerformGarbageCollection();
     return true;
   }
 
-  // TODO: Implement this
   size_t GetMemoryFootprint() {
-    return 0;
+    return container.GetMemoryFootprint();
   }
 
  protected:
@@ -74,9 +86,6 @@ class BWTreeIndex : public Index {
   // equality checker and comparator
   KeyEqualityChecker equals;
   KeyComparator comparator;
-
-  // synch helper
-  RWLock index_lock;
 };
 
 }  // End index namespace
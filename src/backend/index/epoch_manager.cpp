@@ -0,0 +1,114 @@
+//===----------------------------------------------------------------------===//
+//
+//                         PelotonDB
+//
+// epoch_manager.cpp
+//
+// Identification: src/backend/index/epoch_manager.cpp
+//
+// Copyright (c) 2015, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "backend/index/epoch_manager.h"
+
+namespace peloton {
+namespace index {
+
+// Collect garbage once this many nodes are waiting to be freed
+static const size_t GARBAGE_COLLECTION_THRESHOLD = 256;
+
+EpochManager::EpochManager()
+    : current_epoch(0), garbage_list(nullptr), garbage_count(0) {
+  active_threads[0].store(0);
+  active_threads[1].store(0);
+  gc_in_progress.clear();
+}
+
+EpochManager::~EpochManager() { FreeAllGarbage(); }
+
+uint64_t EpochManager::JoinEpoch() {
+  while (true) {
+    uint64_t epoch = current_epoch.load();
+    active_threads[epoch % 2]++;
+
+    // The epoch may have advanced before we were counted
+    if (current_epoch.load() == epoch) {
+      return epoch;
+    }
+    active_threads[epoch % 2]--;
+  }
+}
+
+void EpochManager::LeaveEpoch(const uint64_t epoch) {
+  active_threads[epoch % 2]--;
+
+  if (garbage_count.load() >= GARBAGE_COLLECTION_THRESHOLD) {
+    PerformGarbageCollection();
+  }
+}
+
+void EpochManager::RetireGarbage(void *garbage, FreeFunction free_function,
+                                 void *context) {
+  GarbageNode *garbage_node = new GarbageNode();
+  garbage_node->epoch = current_epoch.load();
+  garbage_node->garbage = garbage;
+  garbage_node->free_function = free_function;
+  garbage_node->context = context;
+
+  PushGarbage(garbage_node);
+  garbage_count++;
+}
+
+void EpochManager::PushGarbage(GarbageNode *garbage_node) {
+  GarbageNode *head = garbage_list.load();
+  do {
+    garbage_node->next = head;
+  } while (garbage_list.compare_exchange_weak(head, garbage_node) == false);
+}
+
+void EpochManager::PerformGarbageCollection() {
+  if (gc_in_progress.test_and_set()) {
+    return;
+  }
+
+  // Threads of the previous epoch share a counter with the next epoch, and
+  // the threads of all older epochs have left before the epoch advanced
+  uint64_t epoch = current_epoch.load();
+  if (active_threads[(epoch + 1) % 2].load() == 0) {
+    GarbageNode *garbage_node = garbage_list.exchange(nullptr);
+
+    // Garbage retired before the current epoch is unreachable
+    while (garbage_node != nullptr) {
+      GarbageNode *next = garbage_node->next;
+      if (garbage_node->epoch < epoch) {
+        garbage_node->free_function(garbage_node->context,
+                                    garbage_node->garbage);
+        delete garbage_node;
+        garbage_count--;
+      } else {
+        PushGarbage(garbage_node);
+      }
+      garbage_node = next;
+    }
+
+    current_epoch.store(epoch + 1);
+  }
+
+  gc_in_progress.clear();
+}
+
+void EpochManager::FreeAllGarbage() {
+  GarbageNode *garbage_node = garbage_list.exchange(nullptr);
+
+  while (garbage_node != nullptr) {
+    GarbageNode *next = garbage_node->next;
+    garbage_node->free_function(garbage_node->context, garbage_node->garbage);
+    delete garbage_node;
+    garbage_count--;
+    garbage_node = next;
+  }
+}
+
+}  // End index namespace
+}  // End peloton namespace
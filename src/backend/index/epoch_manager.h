@@ -0,0 +1,96 @@
+//===----------------------------------------------------------------------===//
+//
+//                         PelotonDB
+//
+// epoch_manager.h
+//
+// Identification: src/backend/index/epoch_manager.h
+//
+// Copyright (c) 2015, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+namespace peloton {
+namespace index {
+
+/**
+ * Epoch-based reclamation of memory unlinked from a structure that readers
+ * traverse without latches.
+ *
+ * Threads join the current epoch before they dereference any shared node and
+ * leave it when they are done. Garbage is tagged with the epoch in which it
+ * was unlinked, and it is only freed after every thread that joined that
+ * epoch (or an earlier one) has left.
+ */
+class EpochManager {
+  EpochManager(EpochManager const &) = delete;
+
+ public:
+  typedef void (*FreeFunction)(void *context, void *garbage);
+
+  EpochManager();
+
+  ~EpochManager();
+
+  uint64_t JoinEpoch();
+
+  void LeaveEpoch(const uint64_t epoch);
+
+  // Hand over unlinked memory, freed later with free_function(context, garbage)
+  void RetireGarbage(void *garbage, FreeFunction free_function, void *context);
+
+  // Free the garbage no thread can reach anymore and advance the epoch
+  void PerformGarbageCollection();
+
+  // Free all garbage, only safe once no thread is in any epoch
+  void FreeAllGarbage();
+
+ private:
+  struct GarbageNode {
+    uint64_t epoch;
+    void *garbage;
+    FreeFunction free_function;
+    void *context;
+    GarbageNode *next;
+  };
+
+  void PushGarbage(GarbageNode *garbage_node);
+
+  std::atomic<uint64_t> current_epoch;
+
+  // threads in the even and odd epochs
+  std::atomic<int64_t> active_threads[2];
+
+  std::atomic<GarbageNode *> garbage_list;
+
+  std::atomic<size_t> garbage_count;
+
+  std::atomic_flag gc_in_progress;
+};
+
+/**
+ * Scoped membership in the current epoch.
+ */
+class EpochGuard {
+  EpochGuard(EpochGuard const &) = delete;
+
+ public:
+  EpochGuard(EpochManager &epoch_manager)
+      : epoch_manager(epoch_manager), epoch(epoch_manager.JoinEpoch()) {}
+
+  ~EpochGuard() { epoch_manager.LeaveEpoch(epoch); }
+
+ private:
+  EpochManager &epoch_manager;
+
+  uint64_t epoch;
+};
+
+}  // End index namespace
+}  // End peloton namespace
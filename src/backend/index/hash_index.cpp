@@ -0,0 +1,188 @@
+//===----------------------------------------------------------------------===//
+//
+//                         PelotonDB
+//
+// hash_index.cpp
+//
+// Identification: src/backend/index/hash_index.cpp
+//
+// Copyright (c) 2015, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "backend/common/exception.h"
+#include "backend/common/logger.h"
+#include "backend/index/hash_index.h"
+#include "backend/index/index_key.h"
+#include "backend/storage/tuple.h"
+
+namespace peloton {
+namespace index {
+
+template <typename KeyType, typename ValueType, class KeyHasher, class KeyEqualityChecker>
+HashIndex<KeyType, ValueType, KeyHasher, KeyEqualityChecker>::HashIndex(
+    IndexMetadata *metadata)
+    : Index(metadata),
+      container(KeyHasher(metadata), KeyEqualityChecker(metadata)),
+      hasher(metadata),
+      equals(metadata) {}
+
+template <typename KeyType, typename ValueType, class KeyHasher, class KeyEqualityChecker>
+HashIndex<KeyType, ValueType, KeyHasher, KeyEqualityChecker>::~HashIndex() {}
+
+template <typename KeyType, typename ValueType, class KeyHasher, class KeyEqualityChecker>
+bool HashIndex<KeyType, ValueType, KeyHasher, KeyEqualityChecker>::InsertEntry(
+    const storage::Tuple *key, const ItemPointer location) {
+  KeyType index_key;
+  index_key.SetFromKey(key);
+
+  // Insert the key, val pair
+  container.Insert(index_key, location);
+
+  return true;
+}
+
+template <typename KeyType, typename ValueType, class KeyHasher, class KeyEqualityChecker>
+bool HashIndex<KeyType, ValueType, KeyHasher, KeyEqualityChecker>::ConditionalInsertEntry(
+    const storage::Tuple *key, const ItemPointer location,
+    std::function<bool(const ItemPointer &)> predicate) {
+  KeyType index_key;
+  index_key.SetFromKey(key);
+
+  // Check the existing entries with the same key and insert atomically
+  return container.ConditionalInsert(index_key, location, predicate);
+}
+
+template <typename KeyType, typename ValueType, class KeyHasher, class KeyEqualityChecker>
+bool HashIndex<KeyType, ValueType, KeyHasher, KeyEqualityChecker>::DeleteEntry(
+    const storage::Tuple *key, const ItemPointer location) {
+  KeyType index_key;
+  index_key.SetFromKey(key);
+
+  // Delete the < key, location > pair
+  container.Delete(index_key, location);
+
+  return true;
+}
+
+template <typename KeyType, typename ValueType, class KeyHasher, class KeyEqualityChecker>
+std::vector<ItemPointer>
+HashIndex<KeyType, ValueType, KeyHasher, KeyEqualityChecker>::Scan(
+    const std::vector<Value> &values,
+    const std::vector<oid_t> &key_column_ids,
+    const std::vector<ExpressionType> &expr_types,
+    const ScanDirectionType& scan_direction) {
+  std::vector<ItemPointer> result;
+  KeyType index_key;
+
+  if (scan_direction == SCAN_DIRECTION_TYPE_INVALID) {
+    throw Exception("Invalid scan direction \n");
+  }
+
+  // Only a lookup with equality constraints on all key columns can be hashed
+  oid_t column_count = metadata->GetColumnCount();
+  for (oid_t column_itr = 0; column_itr < column_count; column_itr++) {
+    auto key_column_ids_itr = std::find(key_column_ids.begin(),
+                                        key_column_ids.end(), column_itr);
+    if (key_column_ids_itr == key_column_ids.end() ||
+        expr_types[std::distance(key_column_ids.begin(), key_column_ids_itr)] !=
+            EXPRESSION_TYPE_COMPARE_EQUAL) {
+      throw IndexException("Hash index " + GetName() +
+                           " only supports equality lookups on all key columns");
+    }
+  }
+
+  std::unique_ptr<storage::Tuple> start_key(
+      new storage::Tuple(metadata->GetKeySchema(), true));
+  ConstructLowerBoundTuple(start_key.get(), values, key_column_ids, expr_types);
+  index_key.SetFromKey(start_key.get());
+
+  // Check the other constraints once, they only depend on the key
+  if (key_column_ids.size() > column_count &&
+      Compare(*start_key, key_column_ids, expr_types, values) == false) {
+    return result;
+  }
+
+  // find the <key, location> pairs
+  container.GetValues(index_key, result);
+
+  return result;
+}
+
+template <typename KeyType, typename ValueType, class KeyHasher, class KeyEqualityChecker>
+std::vector<ItemPointer>
+HashIndex<KeyType, ValueType, KeyHasher, KeyEqualityChecker>::ScanAllKeys() {
+  std::vector<ItemPointer> result;
+
+  // scan all entries in no particular order
+  container.Scan([&](const KeyType &, const ItemPointer &location) {
+    result.push_back(location);
+    return true;
+  });
+
+  return result;
+}
+
+/**
+ * @brief Return all locations related to this key.
+ */
+template <typename KeyType, typename ValueType, class KeyHasher, class KeyEqualityChecker>
+std::vector<ItemPointer>
+HashIndex<KeyType, ValueType, KeyHasher, KeyEqualityChecker>::ScanKey(
+    const storage::Tuple *key) {
+  std::vector<ItemPointer> result;
+  KeyType index_key;
+  index_key.SetFromKey(key);
+
+  // find the <key, location> pairs
+  container.GetValues(index_key, result);
+
+  return result;
+}
+
+template <typename KeyType, typename ValueType, class KeyHasher, class KeyEqualityChecker>
+std::string
+HashIndex<KeyType, ValueType, KeyHasher, KeyEqualityChecker>::GetTypeName() const {
+  return "Hash";
+}
+
+// Explicit template instantiation
+template class HashIndex<IntsKey<1>, ItemPointer, IntsHasher<1>,
+IntsEqualityChecker<1>>;
+template class HashIndex<IntsKey<2>, ItemPointer, IntsHasher<2>,
+IntsEqualityChecker<2>>;
+template class HashIndex<IntsKey<3>, ItemPointer, IntsHasher<3>,
+IntsEqualityChecker<3>>;
+template class HashIndex<IntsKey<4>, ItemPointer, IntsHasher<4>,
+IntsEqualityChecker<4>>;
+
+template class HashIndex<GenericKey<4>, ItemPointer, GenericHasher<4>,
+GenericEqualityChecker<4>>;
+template class HashIndex<GenericKey<8>, ItemPointer, GenericHasher<8>,
+GenericEqualityChecker<8>>;
+template class HashIndex<GenericKey<12>, ItemPointer, GenericHasher<12>,
+GenericEqualityChecker<12>>;
+template class HashIndex<GenericKey<16>, ItemPointer, GenericHasher<16>,
+GenericEqualityChecker<16>>;
+template class HashIndex<GenericKey<24>, ItemPointer, GenericHasher<24>,
+GenericEqualityChecker<24>>;
+template class HashIndex<GenericKey<32>, ItemPointer, GenericHasher<32>,
+GenericEqualityChecker<32>>;
+template class HashIndex<GenericKey<48>, ItemPointer, GenericHasher<48>,
+GenericEqualityChecker<48>>;
+template class HashIndex<GenericKey<64>, ItemPointer, GenericHasher<64>,
+GenericEqualityChecker<64>>;
+template class HashIndex<GenericKey<96>, ItemPointer, GenericHasher<96>,
+GenericEqualityChecker<96>>;
+template class HashIndex<GenericKey<128>, ItemPointer, GenericHasher<128>,
+GenericEqualityChecker<128>>;
+template class HashIndex<GenericKey<256>, ItemPointer, GenericHasher<256>,
+GenericEqualityChecker<256>>;
+template class HashIndex<GenericKey<512>, ItemPointer, GenericHasher<512>,
+GenericEqualityChecker<512>>;
+
+template class HashIndex<TupleKey, ItemPointer, TupleKeyHasher,
+TupleKeyEqualityChecker>;
+
+}  // End index namespace
+}  // End peloton namespace
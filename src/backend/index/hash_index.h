@@ -0,0 +1,85 @@
+//===----------------------------------------------------------------------===//
+//
+//                         PelotonDB
+//
+// hash_index.h
+//
+// Identification: src/backend/index/hash_index.h
+//
+// Copyright (c) 2015, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <vector>
+#include <string>
+
+#include "backend/catalog/manager.h"
+#include "backend/common/platform.h"
+#include "backend/common/types.h"
+#include "backend/index/index.h"
+#include "backend/index/index_key.h"
+
+#include "backend/index/hash_table.h"
+
+namespace peloton {
+namespace index {
+
+/**
+ * Hash table-based index implementation.
+ *
+ * Only supports lookups with equality predicates on every key column, range
+ * scans are rejected.
+ *
+ * @see Index
+ */
+template <typename KeyType, typename ValueType, class KeyHasher, class KeyEqualityChecker>
+class HashIndex : public Index {
+  friend class IndexFactory;
+
+  // Define the container type
+  typedef HashTable<KeyType, ValueType, KeyHasher, KeyEqualityChecker,
+                    ItemPointerEqualityChecker> MapType;
+
+ public:
+  HashIndex(IndexMetadata *metadata);
+
+  ~HashIndex();
+
+  bool InsertEntry(const storage::Tuple *key, const ItemPointer location);
+
+  bool ConditionalInsertEntry(
+      const storage::Tuple *key, const ItemPointer location,
+      std::function<bool(const ItemPointer &)> predicate);
+
+  bool DeleteEntry(const storage::Tuple *key, const ItemPointer location);
+
+  std::vector<ItemPointer> Scan(const std::vector<Value> &values,
+                                const std::vector<oid_t> &key_column_ids,
+                                const std::vector<ExpressionType> &expr_types,
+                                const ScanDirectionType& scan_direction);
+
+  std::vector<ItemPointer> ScanAllKeys();
+
+  std::vector<ItemPointer> ScanKey(const storage::Tuple *key);
+
+  std::string GetTypeName() const;
+
+  bool Cleanup() { return true; }
+
+  size_t GetMemoryFootprint() {
+    return container.GetMemoryFootprint();
+  }
+
+ protected:
+  // container
+  MapType container;
+
+  // hasher and equality checker
+  KeyHasher hasher;
+  KeyEqualityChecker equals;
+};
+
+}  // End index namespace
+}  // End peloton namespace
@@ -0,0 +1,402 @@
+//===----------------------------------------------------------------------===//
+//
+//                         PelotonDB
+//
+// hash_table.h
+//
+// Identification: src/backend/index/hash_table.h
+//
+// Copyright (c) 2015, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <cassert>
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+#include "backend/common/platform.h"
+
+namespace peloton {
+namespace index {
+
+/**
+ * Concurrent hash table for point lookups.
+ *
+ * The table is partitioned by the high bits of the hash into segments, each
+ * an open addressing table with linear probing under its own reader-writer
+ * latch. Lookups only share the latch of one segment, and writers to
+ * different segments never wait for each other.
+ *
+ * A segment grows incrementally: once it is too full, a new slot array is
+ * allocated and every later write to the segment migrates a few slots of the
+ * old array, while lookups probe both arrays until the migration completes.
+ * No operation ever rehashes the whole table.
+ *
+ * Every < key, value > pair takes its own slot, so a key may have several
+ * values.
+ */
+template <typename KeyType, typename ValueType, class KeyHasher,
+          class KeyEqualityChecker, class ValueEqualityChecker>
+class HashTable {
+  HashTable(HashTable const &) = delete;
+
+ public:
+  HashTable(const KeyHasher &hasher, const KeyEqualityChecker &key_equals)
+      : hasher(hasher), key_equals(key_equals) {}
+
+  ~HashTable() {
+    for (size_t segment_itr = 0; segment_itr < SEGMENT_COUNT; segment_itr++) {
+      delete[] segments[segment_itr].slots;
+      delete[] segments[segment_itr].old_slots;
+    }
+  }
+
+  void Insert(const KeyType &key, const ValueType &value) {
+    size_t hash = Hash(key);
+    Segment &segment = GetSegment(hash);
+
+    PelotonWriteLock lock(segment.latch);
+    PrepareInsert(segment);
+    InsertIntoSlots(segment, hash, key, value);
+  }
+
+  // Insert the pair unless the predicate holds for a value with the same key,
+  // the check and the insert are atomic
+  bool ConditionalInsert(const KeyType &key, const ValueType &value,
+                         std::function<bool(const ValueType &)> predicate) {
+    size_t hash = Hash(key);
+    Segment &segment = GetSegment(hash);
+
+    PelotonWriteLock lock(segment.latch);
+    bool found = false;
+    FindEntries(segment, hash, key, [&](Slot &slot) -> bool {
+      if (predicate(slot.value) == true) {
+        found = true;
+        return false;
+      }
+      return true;
+    });
+
+    if (found == true) {
+      return false;
+    }
+
+    PrepareInsert(segment);
+    InsertIntoSlots(segment, hash, key, value);
+    return true;
+  }
+
+  // Delete all copies of the pair
+  void Delete(const KeyType &key, const ValueType &value) {
+    size_t hash = Hash(key);
+    Segment &segment = GetSegment(hash);
+
+    PelotonWriteLock lock(segment.latch);
+    MigrateSlots(segment, MIGRATION_BATCH);
+
+    FindEntries(segment, hash, key, [&](Slot &slot) -> bool {
+      if (value_equals(slot.value, value) == true) {
+        if (IsOldSlot(segment, slot)) {
+          segment.old_entry_count--;
+        }
+        slot.state = SLOT_DELETED;
+        segment.entry_count--;
+      }
+      return true;
+    });
+  }
+
+  void GetValues(const KeyType &key, std::vector<ValueType> &values) {
+    size_t hash = Hash(key);
+    Segment &segment = GetSegment(hash);
+
+    PelotonReadLock lock(segment.latch);
+    FindEntries(segment, hash, key, [&](Slot &slot) -> bool {
+      values.push_back(slot.value);
+      return true;
+    });
+  }
+
+  // Visit every entry in no particular order until the visitor returns false
+  void Scan(std::function<bool(const KeyType &, const ValueType &)> visitor) {
+    for (size_t segment_itr = 0; segment_itr < SEGMENT_COUNT; segment_itr++) {
+      Segment &segment = segments[segment_itr];
+
+      PelotonReadLock lock(segment.latch);
+      if (ScanSlots(segment.old_slots, segment.old_capacity, visitor) == false ||
+          ScanSlots(segment.slots, segment.capacity, visitor) == false) {
+        return;
+      }
+    }
+  }
+
+  size_t GetMemoryFootprint() const {
+    size_t footprint = sizeof(HashTable);
+
+    for (size_t segment_itr = 0; segment_itr < SEGMENT_COUNT; segment_itr++) {
+      const Segment &segment = segments[segment_itr];
+
+      PelotonReadLock lock(segment.latch);
+      footprint += (segment.capacity + segment.old_capacity) * sizeof(Slot);
+    }
+
+    return footprint;
+  }
+
+ private:
+  //===--------------------------------------------------------------------===//
+  // Slots and Segments
+  //===--------------------------------------------------------------------===//
+
+  enum SlotState : uint8_t { SLOT_EMPTY = 0, SLOT_OCCUPIED, SLOT_DELETED };
+
+  struct Slot {
+    Slot() : hash(0), state(SLOT_EMPTY) {}
+
+    // kept to skip most key comparisons and to migrate without rehashing
+    size_t hash;
+
+    SlotState state;
+
+    KeyType key;
+
+    ValueType value;
+  };
+
+  struct Segment {
+    Segment()
+        : slots(nullptr),
+          capacity(0),
+          used_count(0),
+          old_slots(nullptr),
+          old_capacity(0),
+          migrated_count(0),
+          old_entry_count(0),
+          entry_count(0) {}
+
+    mutable RWLock latch;
+
+    Slot *slots;
+
+    size_t capacity;
+
+    // occupied and deleted slots in the current array
+    size_t used_count;
+
+    // array being migrated into the current one, if the segment is growing
+    Slot *old_slots;
+
+    size_t old_capacity;
+
+    size_t migrated_count;
+
+    // entries not yet migrated out of the old array
+    size_t old_entry_count;
+
+    // entries in both arrays
+    size_t entry_count;
+  };
+
+  size_t Hash(const KeyType &key) const {
+    // Spread the bits, the key hashers are not meant for power of two tables
+    uint64_t hash = hasher(key);
+    hash ^= hash >> 33;
+    hash *= 0xff51afd7ed558ccdULL;
+    hash ^= hash >> 33;
+    hash *= 0xc4ceb9fe1a85ec53ULL;
+    hash ^= hash >> 33;
+    return hash;
+  }
+
+  Segment &GetSegment(size_t hash) {
+    return segments[hash >> (sizeof(size_t) * 8 - SEGMENT_BITS)];
+  }
+
+  bool IsOldSlot(const Segment &segment, const Slot &slot) const {
+    return segment.old_slots != nullptr && &slot >= segment.old_slots &&
+           &slot < segment.old_slots + segment.old_capacity;
+  }
+
+  //===--------------------------------------------------------------------===//
+  // Probing
+  //===--------------------------------------------------------------------===//
+
+  // Visit the slots holding the key in both arrays until the visitor returns
+  // false, returns false if the visitor stopped the probe
+  template <typename Visitor>
+  bool FindEntries(Segment &segment, size_t hash, const KeyType &key,
+                   Visitor visitor) {
+    if (ProbeSlots(segment.old_slots, segment.old_capacity, hash, key,
+                   visitor) == false) {
+      return false;
+    }
+    return ProbeSlots(segment.slots, segment.capacity, hash, key, visitor);
+  }
+
+  template <typename Visitor>
+  bool ProbeSlots(Slot *slots, size_t capacity, size_t hash,
+                  const KeyType &key, Visitor &visitor) {
+    if (slots == nullptr) {
+      return true;
+    }
+
+    // Deleted slots do not end the probe, the array always has an empty slot
+    size_t mask = capacity - 1;
+    for (size_t slot_itr = hash & mask; slots[slot_itr].state != SLOT_EMPTY;
+         slot_itr = (slot_itr + 1) & mask) {
+      Slot &slot = slots[slot_itr];
+      if (slot.state == SLOT_OCCUPIED && slot.hash == hash &&
+          key_equals(slot.key, key) == true) {
+        if (visitor(slot) == false) {
+          return false;
+        }
+      }
+    }
+
+    return true;
+  }
+
+  bool ScanSlots(
+      Slot *slots, size_t capacity,
+      std::function<bool(const KeyType &, const ValueType &)> &visitor) {
+    for (size_t slot_itr = 0; slots != nullptr && slot_itr < capacity;
+         slot_itr++) {
+      if (slots[slot_itr].state == SLOT_OCCUPIED &&
+          visitor(slots[slot_itr].key, slots[slot_itr].value) == false) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  //===--------------------------------------------------------------------===//
+  // Insertion and Growth
+  //===--------------------------------------------------------------------===//
+
+  void InsertIntoSlots(Segment &segment, size_t hash, const KeyType &key,
+                       const ValueType &value) {
+    size_t mask = segment.capacity - 1;
+    size_t slot_itr = hash & mask;
+    while (segment.slots[slot_itr].state == SLOT_OCCUPIED) {
+      slot_itr = (slot_itr + 1) & mask;
+    }
+
+    Slot &slot = segment.slots[slot_itr];
+    if (slot.state == SLOT_EMPTY) {
+      segment.used_count++;
+    }
+    slot.hash = hash;
+    slot.key = key;
+    slot.value = value;
+    slot.state = SLOT_OCCUPIED;
+    segment.entry_count++;
+  }
+
+  // Make room for one more entry in the current array. The used slots and the
+  // entries still to be migrated stay within the load factor, so the array
+  // never fills up before the migration completes.
+  void PrepareInsert(Segment &segment) {
+    MigrateSlots(segment, MIGRATION_BATCH);
+
+    while (IsOverloaded(segment.used_count + segment.old_entry_count + 1,
+                        segment.capacity)) {
+      if (segment.old_slots != nullptr) {
+        // Still growing, finish the previous migration first
+        MigrateSlots(segment, segment.old_capacity);
+      } else {
+        Grow(segment);
+      }
+    }
+  }
+
+  bool IsOverloaded(size_t used_count, size_t capacity) const {
+    return used_count * MAX_LOAD_DENOMINATOR > capacity * MAX_LOAD_NUMERATOR;
+  }
+
+  void Grow(Segment &segment) {
+    // Size the new array for the live entries, leaving it half empty
+    size_t capacity = INITIAL_CAPACITY;
+    while (capacity < (segment.entry_count + 1) * 2) {
+      capacity *= 2;
+    }
+
+    segment.old_slots = segment.slots;
+    segment.old_capacity = segment.capacity;
+    segment.migrated_count = 0;
+    segment.old_entry_count = segment.entry_count;
+
+    segment.slots = new Slot[capacity];
+    segment.capacity = capacity;
+    segment.used_count = 0;
+  }
+
+  // Move up to slot_count slots of the old array into the current one
+  void MigrateSlots(Segment &segment, size_t slot_count) {
+    if (segment.old_slots == nullptr) {
+      return;
+    }
+
+    size_t mask = segment.capacity - 1;
+    while (slot_count > 0 && segment.migrated_count < segment.old_capacity) {
+      Slot &old_slot = segment.old_slots[segment.migrated_count];
+
+      if (old_slot.state == SLOT_OCCUPIED) {
+        size_t slot_itr = old_slot.hash & mask;
+        while (segment.slots[slot_itr].state == SLOT_OCCUPIED) {
+          slot_itr = (slot_itr + 1) & mask;
+        }
+
+        Slot &slot = segment.slots[slot_itr];
+        if (slot.state == SLOT_EMPTY) {
+          segment.used_count++;
+        }
+        slot = old_slot;
+
+        // Keep the probe sequences of the old array intact
+        old_slot.state = SLOT_DELETED;
+        segment.old_entry_count--;
+      }
+
+      segment.migrated_count++;
+      slot_count--;
+    }
+
+    if (segment.migrated_count == segment.old_capacity) {
+      assert(segment.old_entry_count == 0);
+      delete[] segment.old_slots;
+      segment.old_slots = nullptr;
+      segment.old_capacity = 0;
+      segment.migrated_count = 0;
+    }
+  }
+
+  //===--------------------------------------------------------------------===//
+  // Members
+  //===--------------------------------------------------------------------===//
+
+  // 2^SEGMENT_BITS segments, each with its own latch
+  static const size_t SEGMENT_BITS = 6;
+  static const size_t SEGMENT_COUNT = 1 << SEGMENT_BITS;
+
+  // slots allocated by the first insert into a segment
+  static const size_t INITIAL_CAPACITY = 16;
+
+  // old slots migrated by every write to a growing segment
+  static const size_t MIGRATION_BATCH = 16;
+
+  // used slots in an array never exceed 3/4 of its capacity
+  static const size_t MAX_LOAD_NUMERATOR = 3;
+  static const size_t MAX_LOAD_DENOMINATOR = 4;
+
+  KeyHasher hasher;
+  KeyEqualityChecker key_equals;
+  ValueEqualityChecker value_equals;
+
+  Segment segments[SEGMENT_COUNT];
+};
+
+}  // End index namespace
+}  // End peloton namespace
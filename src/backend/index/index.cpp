@@ -11,6 +11,8 @@
 //===----------------------------------------------------------------------===//
 
 #include "backend/index/index.h"
+#include "backend/index/index_builder.h"
+#include "backend/index/index_scan_cursor.h"
 #include "backend/common/exception.h"
 #include "backend/common/logger.h"
 #include "backend/common/pool.h"
@@ -182,7 +184,33 @@ bool Index::ConstructLowerBoundTuple(storage::Tuple *index_key,
   return all_constraints_equal;
 }
 
-Index::Index(IndexMetadata *metadata) : metadata(metadata) {
+bool IndexScanCursor::GetNextKeyBatch(
+    __attribute__((unused)) std::vector<ItemPointer> &locations,
+    __attribute__((unused)) const size_t batch_size,
+    __attribute__((unused)) storage::Tile *key_tile) {
+  throw IndexException("Index scan cursor cannot return keys");
+}
+
+std::unique_ptr<IndexScanCursor> Index::GetScanCursor(
+    const std::vector<Value> &values,
+    const std::vector<oid_t> &key_column_ids,
+    const std::vector<ExpressionType> &expr_types,
+    const ScanDirectionType& scan_direction) {
+  std::vector<ItemPointer> locations;
+
+  // Collect all the locations up front
+  if (key_column_ids.size() == 0) {
+    locations = ScanAllKeys();
+  } else {
+    locations = Scan(values, key_column_ids, expr_types, scan_direction);
+  }
+
+  return std::unique_ptr<IndexScanCursor>(
+      new MaterializedIndexScanCursor(std::move(locations)));
+}
+
+Index::Index(IndexMetadata *metadata)
+    : metadata(metadata), building(false) {
   index_oid = metadata->GetOid();
   // initialize counters
   lookup_counter = insert_counter = delete_counter = update_counter = 0;
@@ -191,6 +219,87 @@ Index::Index(IndexMetadata *metadata) : metadata(metadata) {
   pool = new VarlenPool(BACKEND_TYPE_MM);
 }
 
+void Index::MultiScanKey(const std::vector<const storage::Tuple *> &keys,
+                         std::vector<std::vector<ItemPointer>> &locations) {
+  locations.resize(keys.size());
+  for (oid_t key_itr = 0; key_itr < keys.size(); key_itr++) {
+    locations[key_itr] = ScanKey(keys[key_itr]);
+  }
+}
+
+// buffered entries that writers wait for when the build finishes
+static const size_t FINAL_BUILD_ENTRY_COUNT = 1024;
+
+void Index::BulkLoad(size_t part_count, const ScanPartFunction &scan_part) {
+  // Every worker inserts the entries of its parts, the index latches itself
+  ThreadManager::RunInParallel(part_count, [&](size_t part) {
+    IndexBuilder::ScanKeys(this, part, scan_part,
+                           [&](const storage::Tuple *key,
+                               const ItemPointer &location) {
+      InsertEntry(key, location);
+    });
+  });
+}
+
+void Index::StartBuild() {
+  std::lock_guard<std::mutex> lock(build_mutex);
+  building = true;
+}
+
+void Index::InsertBuildEntry(const storage::Tuple *key,
+                             const ItemPointer location) {
+  {
+    std::lock_guard<std::mutex> lock(build_mutex);
+    if (building == true) {
+      std::unique_ptr<storage::Tuple> entry_key(
+          new storage::Tuple(GetKeySchema(), true));
+      entry_key->Copy(key->GetData(), pool);
+      build_entries.emplace_back(std::move(entry_key), location);
+      return;
+    }
+  }
+
+  // The build may have indexed the tuple already
+  ConditionalInsertEntry(key, location, [&](const ItemPointer &entry) -> bool {
+    return entry.block == location.block && entry.offset == location.offset;
+  });
+}
+
+void Index::FinishBuild() {
+  std::vector<std::pair<std::unique_ptr<storage::Tuple>, ItemPointer>> entries;
+
+  // Insert the buffered entries without blocking the writers while there are
+  // many of them, and the last ones before the writers insert directly
+  while (true) {
+    std::unique_lock<std::mutex> lock(build_mutex);
+    entries.swap(build_entries);
+
+    if (entries.size() <= FINAL_BUILD_ENTRY_COUNT) {
+      InsertMissingEntries(entries);
+      building = false;
+      return;
+    }
+
+    lock.unlock();
+    InsertMissingEntries(entries);
+    entries.clear();
+  }
+}
+
+void Index::InsertMissingEntries(
+    std::vector<std::pair<std::unique_ptr<storage::Tuple>, ItemPointer>> &
+        entries) {
+  // The tuples inserted while the build scanned them are in both
+  for (auto &entry : entries) {
+    auto &location = entry.second;
+    ConditionalInsertEntry(entry.first.get(), location,
+                           [&](const ItemPointer &existing) -> bool {
+      return existing.block == location.block &&
+             existing.offset == location.offset;
+    });
+  }
+}
+
 const std::string Index::GetInfo() const {
   std::stringstream os;
 
@@ -12,6 +12,10 @@
 
 #pragma once
 
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <mutex>
 #include <vector>
 #include <string>
 
@@ -28,6 +32,7 @@ class Schema;
 }
 
 namespace storage {
+class Tile;
 class Tuple;
 }
 
@@ -91,6 +96,36 @@ class IndexMetadata  {
   bool unique_keys;
 };
 
+//===--------------------------------------------------------------------===//
+// IndexScanCursor
+//===--------------------------------------------------------------------===//
+
+/**
+ * Cursor over the entries matching an index scan.
+ *
+ * Each batch is read separately, so the index is not latched between batches
+ * and a consumer that stops early never reads the rest of the range. Entries
+ * inserted or deleted while the cursor is open may or may not be returned.
+ */
+class IndexScanCursor {
+ public:
+  virtual ~IndexScanCursor() {}
+
+  // append up to batch_size more locations, returns false once the cursor is
+  // exhausted and nothing was appended
+  virtual bool GetNextBatch(std::vector<ItemPointer> &locations,
+                            const size_t batch_size) = 0;
+
+  // check if the cursor can return the keys of the locations
+  virtual bool HasKeys() const { return false; }
+
+  // same as GetNextBatch, also copying the key of every location appended
+  // into the key tile, at the same offset as the location
+  virtual bool GetNextKeyBatch(std::vector<ItemPointer> &locations,
+                               const size_t batch_size,
+                               storage::Tile *key_tile);
+};
+
 //===--------------------------------------------------------------------===//
 // Index
 //===--------------------------------------------------------------------===//
@@ -118,10 +153,46 @@ class Index : public Printable {
   virtual bool InsertEntry(const storage::Tuple *key,
                            const ItemPointer location) = 0;
 
+  // insert an index entry linked to given tuple only if no existing entry
+  // with the same key satisfies the predicate (e.g. is visible to the
+  // inserting transaction). The check and the insert happen atomically.
+  virtual bool ConditionalInsertEntry(
+      const storage::Tuple *key, const ItemPointer location,
+      std::function<bool(const ItemPointer &)> predicate) = 0;
+
   // delete the index entry linked to given tuple and location
   virtual bool DeleteEntry(const storage::Tuple *key,
                            const ItemPointer location) = 0;
 
+  //===--------------------------------------------------------------------===//
+  // Build
+  //===--------------------------------------------------------------------===//
+
+  // Passes every tuple of one part of a table to the entry callback, the
+  // tuples have all columns of the table
+  typedef std::function<void(const AbstractTuple &, const ItemPointer &)>
+      BuildEntryFunction;
+
+  typedef std::function<void(size_t, const BuildEntryFunction &)>
+      ScanPartFunction;
+
+  // load the entries of all parts into the empty index, scanning the parts
+  // in parallel. No other thread may modify the index meanwhile, writers
+  // buffer their entries instead (see StartBuild).
+  virtual void BulkLoad(size_t part_count, const ScanPartFunction &scan_part);
+
+  // From now on, writers buffer their entries until FinishBuild
+  void StartBuild();
+
+  bool IsBuilding() const { return building; }
+
+  // Buffer the entry while the index is built, or insert it unless the
+  // index has it already
+  void InsertBuildEntry(const storage::Tuple *key, const ItemPointer location);
+
+  // Insert the buffered entries, writers insert directly afterwards
+  void FinishBuild();
+
   //===--------------------------------------------------------------------===//
   // Accessors
   //===--------------------------------------------------------------------===//
@@ -139,6 +210,20 @@ class Index : public Printable {
 
   virtual std::vector<ItemPointer> ScanKey(const storage::Tuple *key) = 0;
 
+  // find the entries of a batch of keys, the locations of keys[i] go to
+  // locations[i]. Ordered indexes probe the keys in key order, so that close
+  // keys share the leaves instead of descending the tree for every key.
+  virtual void MultiScanKey(const std::vector<const storage::Tuple *> &keys,
+                            std::vector<std::vector<ItemPointer>> &locations);
+
+  // open a cursor over the entries Scan would return, or over all entries
+  // when there are no key columns. The cursor must not outlive the index.
+  virtual std::unique_ptr<IndexScanCursor> GetScanCursor(
+      const std::vector<Value> &values,
+      const std::vector<oid_t> &key_column_ids,
+      const std::vector<ExpressionType> &exprs,
+      const ScanDirectionType& scan_direction);
+
   //===--------------------------------------------------------------------===//
   // STATS
   //===--------------------------------------------------------------------===//
@@ -200,6 +285,11 @@ class Index : public Printable {
  protected:
   Index(IndexMetadata *schema);
 
+  // Insert the entries that are not in the index already
+  void InsertMissingEntries(
+      std::vector<std::pair<std::unique_ptr<storage::Tuple>, ItemPointer>> &
+          entries);
+
   // Set the lower bound tuple for index iteration
   bool ConstructLowerBoundTuple(storage::Tuple *index_key,
                           const std::vector<Value> &values,
@@ -228,6 +318,14 @@ class Index : public Printable {
 
   // pool
   VarlenPool *pool = nullptr;
+
+  // entries of the writers while the index is built
+  std::atomic<bool> building;
+
+  std::mutex build_mutex;
+
+  std::vector<std::pair<std::unique_ptr<storage::Tuple>, ItemPointer>>
+      build_entries;
 };
 
 }  // End index namespace
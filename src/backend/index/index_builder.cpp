@@ -0,0 +1,42 @@
+//===----------------------------------------------------------------------===//
+//
+//                         PelotonDB
+//
+// index_builder.cpp
+//
+// Identification: src/backend/index/index_builder.cpp
+//
+// Copyright (c) 2015, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "backend/index/index_builder.h"
+#include "backend/catalog/schema.h"
+#include "backend/storage/tuple.h"
+
+#include <memory>
+
+namespace peloton {
+namespace index {
+
+void IndexBuilder::ScanKeys(
+    Index *index, size_t part, const Index::ScanPartFunction &scan_part,
+    const std::function<void(const storage::Tuple *, const ItemPointer &)> &
+        visitor) {
+  auto key_schema = index->GetKeySchema();
+  auto indexed_columns = key_schema->GetIndexedColumns();
+  std::unique_ptr<storage::Tuple> key(new storage::Tuple(key_schema, true));
+
+  scan_part(part, [&](const AbstractTuple &tuple,
+                      const ItemPointer &location) {
+    for (oid_t column_itr = 0; column_itr < indexed_columns.size();
+         column_itr++) {
+      key->SetValue(column_itr, tuple.GetValue(indexed_columns[column_itr]),
+                    index->GetPool());
+    }
+    visitor(key.get(), location);
+  });
+}
+
+}  // End index namespace
+}  // End peloton namespace
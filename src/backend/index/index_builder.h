@@ -0,0 +1,95 @@
+//===----------------------------------------------------------------------===//
+//
+//                         PelotonDB
+//
+// index_builder.h
+//
+// Identification: src/backend/index/index_builder.h
+//
+// Copyright (c) 2015, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <algorithm>
+#include <functional>
+#include <vector>
+
+#include "backend/common/thread_manager.h"
+#include "backend/common/types.h"
+#include "backend/index/index.h"
+
+namespace peloton {
+namespace index {
+
+/**
+ * Helpers to build an index from the tuples of a table in parallel.
+ *
+ * The table is split into parts that the workers scan independently, every
+ * worker extracting the keys of its parts with its own key tuple.
+ */
+class IndexBuilder {
+ public:
+  // Pass the key of every tuple of the part to the visitor
+  static void ScanKeys(
+      Index *index, size_t part, const Index::ScanPartFunction &scan_part,
+      const std::function<void(const storage::Tuple *, const ItemPointer &)> &
+          visitor);
+
+  // Collect the < key, location > entries of all parts in sorted order.
+  // Every worker sorts the entries of its part, then neighbouring runs are
+  // merged pairwise in parallel until one run is left.
+  template <typename Entry, class EntryComparator>
+  static void ExtractSortedEntries(Index *index, size_t part_count,
+                                   const Index::ScanPartFunction &scan_part,
+                                   EntryComparator entry_less,
+                                   std::vector<Entry> &entries) {
+    std::vector<std::vector<Entry>> runs(part_count);
+
+    ThreadManager::RunInParallel(part_count, [&](size_t part) {
+      auto &run = runs[part];
+      ScanKeys(index, part, scan_part, [&](const storage::Tuple *key,
+                                           const ItemPointer &location) {
+        run.emplace_back();
+        run.back().first.SetFromKey(key);
+        run.back().second = location;
+      });
+      std::sort(run.begin(), run.end(), entry_less);
+    });
+
+    // Concatenate the runs, remembering where each one begins
+    std::vector<size_t> run_offsets;
+    for (auto &run : runs) {
+      run_offsets.push_back(entries.size());
+      entries.insert(entries.end(), run.begin(), run.end());
+      std::vector<Entry>().swap(run);
+    }
+    run_offsets.push_back(entries.size());
+
+    while (run_offsets.size() > 2) {
+      size_t run_count = run_offsets.size() - 1;
+
+      ThreadManager::RunInParallel(run_count / 2, [&](size_t pair) {
+        std::inplace_merge(entries.begin() + run_offsets[2 * pair],
+                           entries.begin() + run_offsets[2 * pair + 1],
+                           entries.begin() + run_offsets[2 * pair + 2],
+                           entry_less);
+      });
+
+      // An odd run is left for the next round
+      std::vector<size_t> merged_run_offsets;
+      for (size_t offset_itr = 0; offset_itr < run_offsets.size();
+           offset_itr += 2) {
+        merged_run_offsets.push_back(run_offsets[offset_itr]);
+      }
+      if (merged_run_offsets.back() != entries.size()) {
+        merged_run_offsets.push_back(entries.size());
+      }
+      run_offsets.swap(merged_run_offsets);
+    }
+  }
+};
+
+}  // End index namespace
+}  // End peloton namespace
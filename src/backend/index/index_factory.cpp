@@ -20,15 +20,129 @@
 
 #include "backend/index/btree_index.h"
 #include "backend/index/bwtree_index.h"
+#include "backend/index/olc_btree_index.h"
+#include "backend/index/hash_index.h"
+#include "backend/index/art_index.h"
 
 namespace peloton {
 namespace index {
 
+namespace {
+
+//===--------------------------------------------------------------------===//
+// Key Types
+//===--------------------------------------------------------------------===//
+
+// Key, comparator, hasher and equality checker of keys up to KeySize bytes
+
+template <std::size_t KeySize>
+struct GenericKeyTypes {
+  typedef GenericKey<KeySize> Key;
+  typedef GenericComparator<KeySize> Comparator;
+  typedef GenericHasher<KeySize> Hasher;
+  typedef GenericEqualityChecker<KeySize> EqualityChecker;
+};
+
+template <std::size_t KeySize>
+struct IntsKeyTypes {
+  static const std::size_t WORD_COUNT = KeySize / sizeof(uint64_t);
+
+  typedef IntsKey<WORD_COUNT> Key;
+  typedef IntsComparator<WORD_COUNT> Comparator;
+  typedef IntsHasher<WORD_COUNT> Hasher;
+  typedef IntsEqualityChecker<WORD_COUNT> EqualityChecker;
+};
+
+template <std::size_t KeySize>
+struct ARTKeyTypes {
+  typedef ARTKey<KeySize> Key;
+  typedef ARTKeyEqualityChecker<KeySize> EqualityChecker;
+};
+
+struct TupleKeyTypes {
+  typedef TupleKey Key;
+  typedef TupleKeyComparator Comparator;
+  typedef TupleKeyHasher Hasher;
+  typedef TupleKeyEqualityChecker EqualityChecker;
+};
+
+//===--------------------------------------------------------------------===//
+// Index Types
+//===--------------------------------------------------------------------===//
+
+template <class KeyTypes>
+using BTreeIndexOf =
+    BTreeIndex<typename KeyTypes::Key, ItemPointer,
+               typename KeyTypes::Comparator,
+               typename KeyTypes::EqualityChecker>;
+
+template <class KeyTypes>
+using BWTreeIndexOf =
+    BWTreeIndex<typename KeyTypes::Key, ItemPointer,
+                typename KeyTypes::Comparator,
+                typename KeyTypes::EqualityChecker>;
+
+template <class KeyTypes>
+using OLCBTreeIndexOf =
+    OLCBTreeIndex<typename KeyTypes::Key, ItemPointer,
+                  typename KeyTypes::Comparator,
+                  typename KeyTypes::EqualityChecker>;
+
+template <class KeyTypes>
+using HashIndexOf =
+    HashIndex<typename KeyTypes::Key, ItemPointer, typename KeyTypes::Hasher,
+              typename KeyTypes::EqualityChecker>;
+
+template <class KeyTypes>
+using ARTIndexOf = ARTIndex<typename KeyTypes::Key, ItemPointer,
+                            typename KeyTypes::EqualityChecker>;
+
+//===--------------------------------------------------------------------===//
+// Key Sizes
+//===--------------------------------------------------------------------===//
+
+template <std::size_t... KeySizes>
+struct KeySizeList {};
+
+typedef KeySizeList<4, 8, 12, 16, 24, 32, 48, 64, 96, 128, 256, 512>
+    GenericKeySizes;
+
+typedef KeySizeList<sizeof(uint64_t), sizeof(uint64_t) * 2,
+                    sizeof(uint64_t) * 3> IntsKeySizes;
+
+typedef KeySizeList<16, 32, 64, 128> ARTKeySizes;
+
+// Create the index on the key types of the first key size that fits the
+// key, or on the fallback key types if none does
+template <template <class> class IndexOf,
+          template <std::size_t> class KeyTypesOf, class FallbackKeyTypes>
+Index *CreateIndex(IndexMetadata *metadata,
+                   size_t key_size __attribute__((unused)), KeySizeList<>) {
+  return new IndexOf<FallbackKeyTypes>(metadata);
+}
+
+template <template <class> class IndexOf,
+          template <std::size_t> class KeyTypesOf, class FallbackKeyTypes,
+          std::size_t KeySize, std::size_t... KeySizes>
+Index *CreateIndex(IndexMetadata *metadata, size_t key_size,
+                   KeySizeList<KeySize, KeySizes...>) {
+  if (key_size <= KeySize) {
+    return new IndexOf<KeyTypesOf<KeySize>>(metadata);
+  }
+  return CreateIndex<IndexOf, KeyTypesOf, FallbackKeyTypes>(
+      metadata, key_size, KeySizeList<KeySizes...>());
+}
+
+}  // namespace
+
 Index *IndexFactory::GetInstance(IndexMetadata *metadata) {
   bool ints_only = false;
 
   LOG_TRACE("Creating index %s", metadata->GetName().c_str());
   const auto key_size = metadata->key_schema->GetLength();
+  // generic keys also store the normalized encoding of the key
+  const auto generic_key_size =
+      KeyNormalizer::GetLength(metadata->key_schema) + key_size;
 
   auto index_type = metadata->GetIndexMethodType();
   LOG_TRACE("Index type : %d", index_type);
@@ -39,129 +153,63 @@ Index *IndexFactory::GetInstance(IndexMetadata *metadata) {
   }
 
   if (ints_only && (index_type == INDEX_TYPE_BTREE)) {
-    if (key_size <= sizeof(uint64_t)) {
-      return new BTreeIndex<IntsKey<1>, ItemPointer, IntsComparator<1>,
-                            IntsEqualityChecker<1>>(metadata);
-    } else if (key_size <= sizeof(int64_t) * 2) {
-      return new BTreeIndex<IntsKey<2>, ItemPointer, IntsComparator<2>,
-                            IntsEqualityChecker<2>>(metadata);
-    } else if (key_size <= sizeof(int64_t) * 3) {
-      return new BTreeIndex<IntsKey<3>, ItemPointer, IntsComparator<3>,
-                            IntsEqualityChecker<3>>(metadata);
-    } else if (key_size <= sizeof(int64_t) * 4) {
-      return new BTreeIndex<IntsKey<4>, ItemPointer, IntsComparator<4>,
-                            IntsEqualityChecker<4>>(metadata);
-    } else {
-      throw IndexException(
-          "We currently only support tree index on non-unique "
-          "integer keys of size 32 bytes or smaller...");
-    }
+    return CreateIndex<BTreeIndexOf, IntsKeyTypes,
+                       IntsKeyTypes<sizeof(int64_t) * 4>>(
+        metadata, key_size, IntsKeySizes());
   }
 
   if (index_type == INDEX_TYPE_BTREE) {
-    if (key_size <= 4) {
-      return new BTreeIndex<GenericKey<4>, ItemPointer, GenericComparator<4>,
-                            GenericEqualityChecker<4>>(metadata);
-    } else if (key_size <= 8) {
-      return new BTreeIndex<GenericKey<8>, ItemPointer, GenericComparator<8>,
-                            GenericEqualityChecker<8>>(metadata);
-    } else if (key_size <= 12) {
-      return new BTreeIndex<GenericKey<12>, ItemPointer, GenericComparator<12>,
-                            GenericEqualityChecker<12>>(metadata);
-    } else if (key_size <= 16) {
-      return new BTreeIndex<GenericKey<16>, ItemPointer, GenericComparator<16>,
-                            GenericEqualityChecker<16>>(metadata);
-    } else if (key_size <= 24) {
-      return new BTreeIndex<GenericKey<24>, ItemPointer, GenericComparator<24>,
-                            GenericEqualityChecker<24>>(metadata);
-    } else if (key_size <= 32) {
-      return new BTreeIndex<GenericKey<32>, ItemPointer, GenericComparator<32>,
-                            GenericEqualityChecker<32>>(metadata);
-    } else if (key_size <= 48) {
-      return new BTreeIndex<GenericKey<48>, ItemPointer, GenericComparator<48>,
-                            GenericEqualityChecker<48>>(metadata);
-    } else if (key_size <= 64) {
-      return new BTreeIndex<GenericKey<64>, ItemPointer, GenericComparator<64>,
-                            GenericEqualityChecker<64>>(metadata);
-    } else if (key_size <= 96) {
-      return new BTreeIndex<GenericKey<96>, ItemPointer, GenericComparator<96>,
-                            GenericEqualityChecker<96>>(metadata);
-    } else if (key_size <= 128) {
-      return new BTreeIndex<GenericKey<128>, ItemPointer, GenericComparator<128>,
-                            GenericEqualityChecker<128>>(metadata);
-    } else if (key_size <= 256) {
-      return new BTreeIndex<GenericKey<256>, ItemPointer, GenericComparator<256>,
-                            GenericEqualityChecker<256>>(metadata);
-    } else if (key_size <= 512) {
-      return new BTreeIndex<GenericKey<512>, ItemPointer, GenericComparator<512>,
-                            GenericEqualityChecker<512>>(metadata);
-    } else {
-      return new BTreeIndex<TupleKey, ItemPointer, TupleKeyComparator,
-                            TupleKeyEqualityChecker>(metadata);
-    }
+    return CreateIndex<BTreeIndexOf, GenericKeyTypes, TupleKeyTypes>(
+        metadata, generic_key_size, GenericKeySizes());
   }
 
   if (ints_only && (index_type == INDEX_TYPE_BWTREE)) {
-    if (key_size <= sizeof(uint64_t)) {
-      return new BWTreeIndex<IntsKey<1>, ItemPointer, IntsComparator<1>,
-                            IntsEqualityChecker<1>>(metadata);
-    } else if (key_size <= sizeof(int64_t) * 2) {
-      return new BWTreeIndex<IntsKey<2>, ItemPointer, IntsComparator<2>,
-                            IntsEqualityChecker<2>>(metadata);
-    } else if (key_size <= sizeof(int64_t) * 3) {
-      return new BWTreeIndex<IntsKey<3>, ItemPointer, IntsComparator<3>,
-                            IntsEqualityChecker<3>>(metadata);
-    } else if (key_size <= sizeof(int64_t) * 4) {
-      return new BWTreeIndex<IntsKey<4>, ItemPointer, IntsComparator<4>,
-                            IntsEqualityChecker<4>>(metadata);
-    } else {
-      throw IndexException(
-          "We currently only support tree index on non-unique "
-          "integer keys of size 32 bytes or smaller...");
-    }
+    return CreateIndex<BWTreeIndexOf, IntsKeyTypes,
+                       IntsKeyTypes<sizeof(int64_t) * 4>>(
+        metadata, key_size, IntsKeySizes());
   }
 
   if (index_type == INDEX_TYPE_BWTREE) {
-    if (key_size <= 4) {
-      return new BWTreeIndex<GenericKey<4>, ItemPointer, GenericComparator<4>,
-                            GenericEqualityChecker<4>>(metadata);
-    } else if (key_size <= 8) {
-      return new BWTreeIndex<GenericKey<8>, ItemPointer, GenericComparator<8>,
-                            GenericEqualityChecker<8>>(metadata);
-    } else if (key_size <= 12) {
-      return new BWTreeIndex<GenericKey<12>, ItemPointer, GenericComparator<12>,
-                            GenericEqualityChecker<12>>(metadata);
-    } else if (key_size <= 16) {
-      return new BWTreeIndex<GenericKey<16>, ItemPointer, GenericComparator<16>,
-                            GenericEqualityChecker<16>>(metadata);
-    } else if (key_size <= 24) {
-      return new BWTreeIndex<GenericKey<24>, ItemPointer, GenericComparator<24>,
-                            GenericEqualityChecker<24>>(metadata);
-    } else if (key_size <= 32) {
-      return new BWTreeIndex<GenericKey<32>, ItemPointer, GenericComparator<32>,
-                            GenericEqualityChecker<32>>(metadata);
-    } else if (key_size <= 48) {
-      return new BWTreeIndex<GenericKey<48>, ItemPointer, GenericComparator<48>,
-                            GenericEqualityChecker<48>>(metadata);
-    } else if (key_size <= 64) {
-      return new BWTreeIndex<GenericKey<64>, ItemPointer, GenericComparator<64>,
-                            GenericEqualityChecker<64>>(metadata);
-    } else if (key_size <= 96) {
-      return new BWTreeIndex<GenericKey<96>, ItemPointer, GenericComparator<96>,
-                            GenericEqualityChecker<96>>(metadata);
-    } else if (key_size <= 128) {
-      return new BWTreeIndex<GenericKey<128>, ItemPointer, GenericComparator<128>,
-                            GenericEqualityChecker<128>>(metadata);
-    } else if (key_size <= 256) {
-      return new BWTreeIndex<GenericKey<256>, ItemPointer, GenericComparator<256>,
-                            GenericEqualityChecker<256>>(metadata);
-    } else if (key_size <= 512) {
-      return new BWTreeIndex<GenericKey<512>, ItemPointer, GenericComparator<512>,
-                            GenericEqualityChecker<512>>(metadata);
-    } else {
-      return new BWTreeIndex<TupleKey, ItemPointer, TupleKeyComparator,
-                            TupleKeyEqualityChecker>(metadata);
+    return CreateIndex<BWTreeIndexOf, GenericKeyTypes, TupleKeyTypes>(
+        metadata, generic_key_size, GenericKeySizes());
+  }
+
+  if (ints_only && (index_type == INDEX_TYPE_OLCBTREE)) {
+    return CreateIndex<OLCBTreeIndexOf, IntsKeyTypes,
+                       IntsKeyTypes<sizeof(int64_t) * 4>>(
+        metadata, key_size, IntsKeySizes());
+  }
+
+  if (index_type == INDEX_TYPE_OLCBTREE) {
+    return CreateIndex<OLCBTreeIndexOf, GenericKeyTypes, TupleKeyTypes>(
+        metadata, generic_key_size, GenericKeySizes());
+  }
+
+  if (ints_only && (index_type == INDEX_TYPE_HASH)) {
+    return CreateIndex<HashIndexOf, IntsKeyTypes,
+                       IntsKeyTypes<sizeof(int64_t) * 4>>(
+        metadata, key_size, IntsKeySizes());
+  }
+
+  if (index_type == INDEX_TYPE_HASH) {
+    return CreateIndex<HashIndexOf, GenericKeyTypes, TupleKeyTypes>(
+        metadata, generic_key_size, GenericKeySizes());
+  }
+
+  if (index_type == INDEX_TYPE_ART) {
+    if (KeyNormalizer::IsComparable(metadata->key_schema) == false) {
+      throw IndexException(
+          "We currently only support radix tree index on keys of "
+          "numeric, timestamp and string types...");
     }
+
+    // The keys are kept inline up to the length of keys whose strings fill
+    // their columns
+    size_t art_key_size = KeyNormalizer::GetCompleteLength(
+                              metadata->key_schema) +
+                          metadata->key_schema->GetLength();
+    return CreateIndex<ARTIndexOf, ARTKeyTypes, ARTKeyTypes<256>>(
+        metadata, art_key_size, ARTKeySizes());
   }
 
   throw IndexException("Unsupported index scheme.");
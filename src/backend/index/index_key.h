@@ -12,9 +12,12 @@
 
 #pragma once
 
+#include <algorithm>
 #include <cassert>
+#include <cstring>
 #include <iostream>
 #include <sstream>
+#include <string>
 
 #include "backend/common/value_peeker.h"
 #include "backend/common/logger.h"
@@ -165,7 +168,7 @@ class IntsKey {
   }
 
   const storage::Tuple GetTupleForComparison(
-      __attribute__((unused)) const catalog::Schema *key_schema) {
+      __attribute__((unused)) const catalog::Schema *key_schema) const {
     throw IndexException("Tuple conversion not supported");
   }
 
@@ -378,11 +381,11 @@ class IntsEqualityChecker {
 };
 
 /**
- *
+ * Hash function object for an array of uint64_t
  */
 template <std::size_t KeySize>
 struct IntsHasher : std::unary_function<IntsKey<KeySize>, std::size_t> {
-  IntsHasher(catalog::Schema *key_schema) {}
+  IntsHasher(index::IndexMetadata *metadata) {}
 
   inline size_t operator()(IntsKey<KeySize> const &p) const {
     size_t seed = 0;
@@ -393,27 +396,387 @@ struct IntsHasher : std::unary_function<IntsKey<KeySize>, std::size_t> {
   }
 };
 
+/**
+ * Binary encoding of the key columns whose byte order matches the order of
+ * the values, so that keys compare with a single memcmp.
+ *
+ * Every column starts with a null flag byte, so that nulls come first.
+ * Integers and timestamps are stored big-endian with the sign bit flipped,
+ * decimals the same with their high word first, and doubles with the sign
+ * bit flipped or all bits inverted if negative. Strings keep a prefix of up
+ * to STRING_PREFIX_LENGTH bytes, padded with zeros, followed by a length
+ * byte that saturates once the prefix is full. The encoding therefore only
+ * decides the order up to and including the first string column: keys with
+ * equal encodings have to compare the values from that column on.
+ *
+ * The complete encoding instead keeps the whole strings, so that it decides
+ * the order of all keys and no encoding is a prefix of another one. Varchars
+ * are cut at their first null character, as they compare like C strings,
+ * and followed by a null character and their length. Varbinaries escape
+ * their null bytes and end with two null bytes.
+ */
+class KeyNormalizer {
+ public:
+  // Check if values of the type have an encoding
+  static bool IsEncodable(ValueType column_type) {
+    switch (column_type) {
+      case VALUE_TYPE_BOOLEAN:
+      case VALUE_TYPE_TINYINT:
+      case VALUE_TYPE_SMALLINT:
+      case VALUE_TYPE_INTEGER:
+      case VALUE_TYPE_BIGINT:
+      case VALUE_TYPE_TIMESTAMP:
+      case VALUE_TYPE_DOUBLE:
+      case VALUE_TYPE_DECIMAL:
+      case VALUE_TYPE_VARCHAR:
+      case VALUE_TYPE_VARBINARY:
+        return true;
+      default:
+        return false;
+    }
+  }
+
+  // Check if the encoding of the type only keeps a prefix of the values
+  static bool IsString(ValueType column_type) {
+    return column_type == VALUE_TYPE_VARCHAR ||
+           column_type == VALUE_TYPE_VARBINARY;
+  }
+
+  // Length of the encoding of a column of the type, with its null flag
+  static size_t GetColumnLength(ValueType column_type) {
+    return NULL_FLAG_LENGTH + GetValueLength(column_type);
+  }
+
+  // Write the null flag and the encoding of the value of a column of the
+  // type into the buffer, GetColumnLength(column_type) bytes
+  static void EncodeColumn(const Value &value, ValueType column_type,
+                           char *buffer) {
+    if (value.IsNull()) {
+      ::memset(buffer, 0, GetColumnLength(column_type));
+    } else {
+      buffer[0] = 1;
+      EncodeValue(value, column_type, buffer + NULL_FLAG_LENGTH);
+    }
+  }
+
+  // Length of the encoding of keys with the schema
+  static size_t GetLength(const catalog::Schema *key_schema) {
+    size_t length = 0;
+    oid_t column_count = key_schema->GetColumnCount();
+    for (oid_t column_itr = 0; column_itr < column_count; column_itr++) {
+      auto column_type = key_schema->GetType(column_itr);
+      if (IsEncodable(column_type) == false) {
+        break;
+      }
+
+      length += GetColumnLength(column_type);
+      if (IsString(column_type) == true) {
+        break;
+      }
+    }
+    return length;
+  }
+
+  // First column whose order the encoding does not fully decide
+  static oid_t GetFallbackColumn(const catalog::Schema *key_schema) {
+    oid_t column_count = key_schema->GetColumnCount();
+    for (oid_t column_itr = 0; column_itr < column_count; column_itr++) {
+      auto column_type = key_schema->GetType(column_itr);
+      if (IsEncodable(column_type) == false || IsString(column_type) == true) {
+        return column_itr;
+      }
+    }
+    return column_count;
+  }
+
+  // Check if the complete encoding supports all columns of the schema
+  static bool IsComparable(const catalog::Schema *key_schema) {
+    oid_t column_count = key_schema->GetColumnCount();
+    for (oid_t column_itr = 0; column_itr < column_count; column_itr++) {
+      if (IsEncodable(key_schema->GetType(column_itr)) == false) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  // Length of the complete encoding of the key tuple
+  static size_t GetCompleteLength(const storage::Tuple *tuple) {
+    const catalog::Schema *key_schema = tuple->GetSchema();
+    oid_t column_count = key_schema->GetColumnCount();
+    size_t length = 0;
+
+    for (oid_t column_itr = 0; column_itr < column_count; column_itr++) {
+      auto column_type = key_schema->GetType(column_itr);
+      assert(IsEncodable(column_type));
+
+      if (IsString(column_type) == false) {
+        length += GetColumnLength(column_type);
+        continue;
+      }
+
+      length += NULL_FLAG_LENGTH;
+      const Value value = tuple->GetValue(column_itr);
+      if (value.IsNull()) {
+        continue;
+      }
+
+      size_t value_length = ValuePeeker::PeekObjectLengthWithoutNull(value);
+      const char *string_value = reinterpret_cast<const char *>(
+          ValuePeeker::PeekObjectValueWithoutNull(value));
+
+      if (column_type == VALUE_TYPE_VARCHAR) {
+        length += strnlen(string_value, value_length) + 1 + sizeof(uint32_t);
+      } else {
+        length += value_length +
+                  std::count(string_value, string_value + value_length, 0) +
+                  2;
+      }
+    }
+    return length;
+  }
+
+  // Length of the complete encoding of keys with the schema whose strings
+  // fill the size of their columns
+  static size_t GetCompleteLength(const catalog::Schema *key_schema) {
+    oid_t column_count = key_schema->GetColumnCount();
+    size_t length = 0;
+
+    for (oid_t column_itr = 0; column_itr < column_count; column_itr++) {
+      auto column_type = key_schema->GetType(column_itr);
+      length += NULL_FLAG_LENGTH;
+      if (column_type == VALUE_TYPE_VARCHAR) {
+        length += key_schema->GetAppropriateLength(column_itr) + 1 +
+                  sizeof(uint32_t);
+      } else if (column_type == VALUE_TYPE_VARBINARY) {
+        length += key_schema->GetAppropriateLength(column_itr) + 2;
+      } else {
+        length += GetValueLength(column_type);
+      }
+    }
+    return length;
+  }
+
+  // Write the complete encoding of the key tuple into the buffer, which has
+  // room for GetCompleteLength(tuple) bytes
+  static void EncodeComplete(const storage::Tuple *tuple, char *buffer) {
+    const catalog::Schema *key_schema = tuple->GetSchema();
+    oid_t column_count = key_schema->GetColumnCount();
+
+    for (oid_t column_itr = 0; column_itr < column_count; column_itr++) {
+      auto column_type = key_schema->GetType(column_itr);
+      assert(IsEncodable(column_type));
+
+      const Value value = tuple->GetValue(column_itr);
+      if (IsString(column_type) == false) {
+        EncodeColumn(value, column_type, buffer);
+        buffer += GetColumnLength(column_type);
+        continue;
+      }
+
+      if (value.IsNull()) {
+        *buffer++ = 0;
+        continue;
+      }
+      *buffer++ = 1;
+
+      size_t length = ValuePeeker::PeekObjectLengthWithoutNull(value);
+      const char *string_value = reinterpret_cast<const char *>(
+          ValuePeeker::PeekObjectValueWithoutNull(value));
+
+      if (column_type == VALUE_TYPE_VARCHAR) {
+        size_t string_length = strnlen(string_value, length);
+        ::memcpy(buffer, string_value, string_length);
+        buffer += string_length;
+        *buffer++ = 0;
+        EncodeBigEndian<uint32_t>(length, buffer);
+        buffer += sizeof(uint32_t);
+      } else {
+        for (size_t byte_itr = 0; byte_itr < length; byte_itr++) {
+          *buffer++ = string_value[byte_itr];
+          if (string_value[byte_itr] == 0) {
+            *buffer++ = static_cast<char>(0xFF);
+          }
+        }
+        *buffer++ = 0;
+        *buffer++ = 0;
+      }
+    }
+  }
+
+  // Write the encoding of the key tuple into the buffer
+  static void Encode(const storage::Tuple *tuple, char *buffer) {
+    const catalog::Schema *key_schema = tuple->GetSchema();
+    oid_t column_count = key_schema->GetColumnCount();
+    for (oid_t column_itr = 0; column_itr < column_count; column_itr++) {
+      auto column_type = key_schema->GetType(column_itr);
+      if (IsEncodable(column_type) == false) {
+        break;
+      }
+
+      EncodeColumn(tuple->GetValue(column_itr), column_type, buffer);
+      buffer += GetColumnLength(column_type);
+
+      if (IsString(column_type) == true) {
+        break;
+      }
+    }
+  }
+
+ private:
+  static const size_t NULL_FLAG_LENGTH = 1;
+
+  static const size_t STRING_PREFIX_LENGTH = 16;
+
+  static size_t GetValueLength(ValueType column_type) {
+    switch (column_type) {
+      case VALUE_TYPE_BOOLEAN:
+      case VALUE_TYPE_TINYINT:
+        return sizeof(int8_t);
+      case VALUE_TYPE_SMALLINT:
+        return sizeof(int16_t);
+      case VALUE_TYPE_INTEGER:
+        return sizeof(int32_t);
+      case VALUE_TYPE_BIGINT:
+      case VALUE_TYPE_TIMESTAMP:
+      case VALUE_TYPE_DOUBLE:
+        return sizeof(int64_t);
+      case VALUE_TYPE_DECIMAL:
+        return 2 * sizeof(uint64_t);
+      case VALUE_TYPE_VARCHAR:
+      case VALUE_TYPE_VARBINARY:
+        return STRING_PREFIX_LENGTH + 1;
+      default:
+        return 0;
+    }
+  }
+
+  template <typename UnsignedType>
+  static void EncodeBigEndian(UnsignedType value, char *buffer) {
+    for (int byte_itr = sizeof(UnsignedType) - 1; byte_itr >= 0; byte_itr--) {
+      buffer[byte_itr] = static_cast<char>(value & 0xFF);
+      value >>= 8;
+    }
+  }
+
+  static void EncodeValue(const Value &value, ValueType column_type,
+                          char *buffer) {
+    switch (column_type) {
+      case VALUE_TYPE_BOOLEAN:
+        *buffer = ValuePeeker::PeekBoolean(value) ? 1 : 0;
+        break;
+      case VALUE_TYPE_TINYINT:
+        EncodeBigEndian(
+            ConvertSignedValueToUnsignedValue<INT8_MAX, int8_t, uint8_t>(
+                ValuePeeker::PeekTinyInt(value)),
+            buffer);
+        break;
+      case VALUE_TYPE_SMALLINT:
+        EncodeBigEndian(
+            ConvertSignedValueToUnsignedValue<INT16_MAX, int16_t, uint16_t>(
+                ValuePeeker::PeekSmallInt(value)),
+            buffer);
+        break;
+      case VALUE_TYPE_INTEGER:
+        EncodeBigEndian(
+            ConvertSignedValueToUnsignedValue<INT32_MAX, int32_t, uint32_t>(
+                ValuePeeker::PeekInteger(value)),
+            buffer);
+        break;
+      case VALUE_TYPE_BIGINT:
+        EncodeBigEndian(
+            ConvertSignedValueToUnsignedValue<INT64_MAX, int64_t, uint64_t>(
+                ValuePeeker::PeekBigInt(value)),
+            buffer);
+        break;
+      case VALUE_TYPE_TIMESTAMP:
+        EncodeBigEndian(
+            ConvertSignedValueToUnsignedValue<INT64_MAX, int64_t, uint64_t>(
+                ValuePeeker::PeekTimestamp(value)),
+            buffer);
+        break;
+      case VALUE_TYPE_DOUBLE: {
+        double double_value = ValuePeeker::PeekDouble(value);
+        // -0.0 equals 0.0
+        if (double_value == 0) {
+          double_value = 0;
+        }
+
+        uint64_t bits;
+        ::memcpy(&bits, &double_value, sizeof(bits));
+        if (bits >> 63) {
+          bits = ~bits;
+        } else {
+          bits |= (uint64_t)1 << 63;
+        }
+        EncodeBigEndian(bits, buffer);
+      } break;
+      case VALUE_TYPE_DECIMAL: {
+        // two's complement, low word first
+        TTInt decimal_value = ValuePeeker::PeekDecimal(value);
+        uint64_t high_word = decimal_value.table[1] ^ ((uint64_t)1 << 63);
+        EncodeBigEndian<uint64_t>(high_word, buffer);
+        EncodeBigEndian<uint64_t>(decimal_value.table[0],
+                                  buffer + sizeof(uint64_t));
+      } break;
+      case VALUE_TYPE_VARCHAR:
+      case VALUE_TYPE_VARBINARY: {
+        size_t length = ValuePeeker::PeekObjectLengthWithoutNull(value);
+        const char *string_value = reinterpret_cast<const char *>(
+            ValuePeeker::PeekObjectValueWithoutNull(value));
+
+        size_t prefix_length =
+            (length < STRING_PREFIX_LENGTH) ? length : STRING_PREFIX_LENGTH;
+        // Varchars compare like C strings up to their first null character
+        if (column_type == VALUE_TYPE_VARCHAR) {
+          prefix_length = strnlen(string_value, prefix_length);
+        }
+
+        ::memcpy(buffer, string_value, prefix_length);
+        ::memset(buffer + prefix_length, 0,
+                 STRING_PREFIX_LENGTH - prefix_length);
+        buffer[STRING_PREFIX_LENGTH] = static_cast<char>(
+            (length <= STRING_PREFIX_LENGTH) ? length
+                                             : STRING_PREFIX_LENGTH + 1);
+      } break;
+      default:
+        break;
+    }
+  }
+};
+
 /**
  * Key object for indexes of mixed types.
- * Using storage::Tuple to store columns.
+ * Stores the normalized encoding of the key columns, followed by the key
+ * tuple to read the values from.
  */
 template <std::size_t KeySize>
 class GenericKey {
  public:
   inline void SetFromKey(const storage::Tuple *tuple) {
     assert(tuple);
-    ::memcpy(data, tuple->GetData(), KeySize);
+    const catalog::Schema *key_schema = tuple->GetSchema();
+    size_t normalized_length = KeyNormalizer::GetLength(key_schema);
+    assert(normalized_length + key_schema->GetLength() <= KeySize);
+
+    KeyNormalizer::Encode(tuple, data);
+    ::memcpy(data + normalized_length, tuple->GetData(),
+             key_schema->GetLength());
   }
 
   const storage::Tuple GetTupleForComparison(
-      const catalog::Schema *key_schema) {
-    return storage::Tuple(key_schema, data);
+      const catalog::Schema *key_schema) const {
+    return storage::Tuple(key_schema,
+                          const_cast<char *>(data) +
+                              KeyNormalizer::GetLength(key_schema));
   }
 
   inline const Value ToValueFast(const catalog::Schema *schema,
+                                 size_t normalized_length,
                                  int column_id) const {
     const ValueType column_type = schema->GetType(column_id);
-    const char *data_ptr = &data[schema->GetOffset(column_id)];
+    const char *data_ptr =
+        &data[normalized_length + schema->GetOffset(column_id)];
     const bool is_inlined = schema->IsInlined(column_id);
 
     return Value::InitFromTupleStorage(data_ptr, column_type, is_inlined);
@@ -433,26 +796,26 @@ class GenericComparator {
  public:
   /** Type information passed to the constuctor as it's not in the key itself */
   GenericComparator(index::IndexMetadata *metadata)
-      : schema(metadata->GetKeySchema()) {}
+      : schema(metadata->GetKeySchema()),
+        normalized_length(KeyNormalizer::GetLength(schema)),
+        fallback_column_id(KeyNormalizer::GetFallbackColumn(schema)) {}
 
   inline bool operator()(const GenericKey<KeySize> &lhs,
                          const GenericKey<KeySize> &rhs) const {
-    /*
-    storage::Tuple lhTuple(schema);
-    lhTuple.MoveToTuple(reinterpret_cast<const void *>(&lhs));
-    storage::Tuple rhTuple(schema);
-    rhTuple.MoveToTuple(reinterpret_cast<const void *>(&rhs));
-    // lexicographical compare could be faster for fixed N
-    int diff = lhTuple.Compare(rhTuple);
-    return diff < 0;
-    */
+    // The encodings decide the order unless they are equal
+    int diff = ::memcmp(lhs.data, rhs.data, normalized_length);
+    if (diff) {
+      return diff < 0;
+    }
 
-    for (oid_t column_itr = 0; column_itr < schema->GetColumnCount();
-         column_itr++) {
-      const Value lhs_value = lhs.ToValueFast(schema, column_itr);
-      const Value rhs_value = rhs.ToValueFast(schema, column_itr);
+    for (oid_t column_itr = fallback_column_id;
+         column_itr < schema->GetColumnCount(); column_itr++) {
+      const Value lhs_value =
+          lhs.ToValueFast(schema, normalized_length, column_itr);
+      const Value rhs_value =
+          rhs.ToValueFast(schema, normalized_length, column_itr);
 
-      int diff = lhs_value.Compare(rhs_value);
+      diff = lhs_value.Compare(rhs_value);
 
       if (diff) {
         return diff < 0;
@@ -464,6 +827,10 @@ class GenericComparator {
   }
 
   const catalog::Schema *schema;
+
+  size_t normalized_length;
+
+  oid_t fallback_column_id;
 };
 
 /**
@@ -474,18 +841,36 @@ class GenericEqualityChecker {
  public:
   /** Type information passed to the constuctor as it's not in the key itself */
   GenericEqualityChecker(index::IndexMetadata *metadata)
-      : schema(metadata->GetKeySchema()) {}
+      : schema(metadata->GetKeySchema()),
+        normalized_length(KeyNormalizer::GetLength(schema)),
+        fallback_column_id(KeyNormalizer::GetFallbackColumn(schema)) {}
 
   inline bool operator()(const GenericKey<KeySize> &lhs,
                          const GenericKey<KeySize> &rhs) const {
-    storage::Tuple lhTuple(schema);
-    lhTuple.MoveToTuple(reinterpret_cast<const void *>(&lhs));
-    storage::Tuple rhTuple(schema);
-    rhTuple.MoveToTuple(reinterpret_cast<const void *>(&rhs));
-    return lhTuple.EqualsNoSchemaCheck(rhTuple);
+    if (::memcmp(lhs.data, rhs.data, normalized_length) != 0) {
+      return false;
+    }
+
+    for (oid_t column_itr = fallback_column_id;
+         column_itr < schema->GetColumnCount(); column_itr++) {
+      const Value lhs_value =
+          lhs.ToValueFast(schema, normalized_length, column_itr);
+      const Value rhs_value =
+          rhs.ToValueFast(schema, normalized_length, column_itr);
+
+      if (lhs_value.Compare(rhs_value) != VALUE_COMPARE_EQUAL) {
+        return false;
+      }
+    }
+
+    return true;
   }
 
   const catalog::Schema *schema;
+
+  size_t normalized_length;
+
+  oid_t fallback_column_id;
 };
 
 /**
@@ -495,16 +880,109 @@ template <std::size_t KeySize>
 struct GenericHasher : std::unary_function<GenericKey<KeySize>, std::size_t> {
   /** Type information passed to the constuctor as it's not in the key itself */
   GenericHasher(index::IndexMetadata *metadata)
-      : schema(metadata->GetKeySchema()) {}
+      : schema(metadata->GetKeySchema()),
+        normalized_length(KeyNormalizer::GetLength(schema)) {}
 
   /** Generate a 64-bit number for the key value */
   inline size_t operator()(GenericKey<KeySize> const &p) const {
     storage::Tuple pTuple(schema);
-    pTuple.MoveToTuple(reinterpret_cast<const void *>(&p));
+    pTuple.MoveToTuple(
+        reinterpret_cast<const void *>(p.data + normalized_length));
     return pTuple.HashCode();
   }
 
   const catalog::Schema *schema;
+
+  size_t normalized_length;
+};
+
+/**
+ * Key object for radix tree indexes.
+ * Stores the complete encoding of the key, followed by the key tuple to read
+ * the values from. Both are kept inline when they fit into KeySize bytes,
+ * longer keys (such as strings of multibyte characters) are allocated.
+ */
+template <std::size_t KeySize>
+class ARTKey {
+ public:
+  ARTKey() : key_length(0), length(0), overflow(nullptr) {}
+
+  ARTKey(const ARTKey &other) : ARTKey() { *this = other; }
+
+  ~ARTKey() { delete[] overflow; }
+
+  ARTKey &operator=(const ARTKey &other) {
+    if (this != &other) {
+      ::memcpy(Reserve(other.length), other.GetData(), other.length);
+      key_length = other.key_length;
+    }
+    return *this;
+  }
+
+  inline void SetFromKey(const storage::Tuple *tuple) {
+    assert(tuple);
+    size_t tuple_length = tuple->GetSchema()->GetLength();
+    key_length = KeyNormalizer::GetCompleteLength(tuple);
+
+    char *buffer = Reserve(key_length + tuple_length);
+    KeyNormalizer::EncodeComplete(tuple, buffer);
+    ::memcpy(buffer + key_length, tuple->GetData(), tuple_length);
+  }
+
+  const storage::Tuple GetTupleForComparison(
+      const catalog::Schema *key_schema) const {
+    return storage::Tuple(key_schema,
+                          const_cast<char *>(GetData() + key_length));
+  }
+
+  // The encoded key
+  inline const uint8_t *GetBytes() const {
+    return reinterpret_cast<const uint8_t *>(GetData());
+  }
+
+  inline size_t GetLength() const { return key_length; }
+
+ private:
+  inline const char *GetData() const {
+    return overflow != nullptr ? overflow : data;
+  }
+
+  // Room for the given number of bytes, whose previous contents are lost
+  char *Reserve(size_t new_length) {
+    delete[] overflow;
+    overflow = nullptr;
+    length = new_length;
+    if (length <= KeySize) {
+      return data;
+    }
+    overflow = new char[length];
+    return overflow;
+  }
+
+  char data[KeySize];
+
+  size_t key_length;
+
+  // length of the encoding and the key tuple
+  size_t length;
+
+  char *overflow;
+};
+
+/**
+ * Equality-checking function object
+ */
+template <std::size_t KeySize>
+class ARTKeyEqualityChecker {
+ public:
+  ARTKeyEqualityChecker(
+      __attribute__((unused)) index::IndexMetadata *metadata) {}
+
+  inline bool operator()(const ARTKey<KeySize> &lhs,
+                         const ARTKey<KeySize> &rhs) const {
+    return lhs.GetLength() == rhs.GetLength() &&
+           ::memcmp(lhs.GetBytes(), rhs.GetBytes(), lhs.GetLength()) == 0;
+  }
 };
 
 /*
@@ -636,5 +1114,48 @@ class TupleKeyEqualityChecker {
   const catalog::Schema *schema;
 };
 
+/**
+ * Hash function object for TupleKeys
+ */
+class TupleKeyHasher {
+ public:
+  TupleKeyHasher(index::IndexMetadata *metadata)
+      : schema(metadata->GetKeySchema()) {}
+
+  inline size_t operator()(const TupleKey &p) const {
+    storage::Tuple pTuple = p.GetTupleForComparison(p.key_tuple_schema);
+    size_t seed = 0;
+
+    for (unsigned int col_itr = 0; col_itr < schema->GetColumnCount();
+         ++col_itr) {
+      pTuple.GetValue(p.ColumnForIndexColumn(col_itr)).HashCombine(seed);
+    }
+    return seed;
+  }
+
+  const catalog::Schema *schema;
+};
+
+/**
+ * Equality-checking function object for index entries
+ */
+class ItemPointerEqualityChecker {
+ public:
+  inline bool operator()(const ItemPointer &lhs, const ItemPointer &rhs) const {
+    return (lhs.block == rhs.block) && (lhs.offset == rhs.offset);
+  }
+};
+
+/**
+ * Function object returns true if lhs < rhs, orders index entries of a key
+ */
+class ItemPointerComparator {
+ public:
+  inline bool operator()(const ItemPointer &lhs, const ItemPointer &rhs) const {
+    return (lhs.block < rhs.block) ||
+           ((lhs.block == rhs.block) && (lhs.offset < rhs.offset));
+  }
+};
+
 }  // End index namespace
 }  // End peloton namespace
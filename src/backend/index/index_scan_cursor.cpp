@@ -0,0 +1,260 @@
+//===----------------------------------------------------------------------===//
+//
+//                         PelotonDB
+//
+// index_scan_cursor.cpp
+//
+// Identification: src/backend/index/index_scan_cursor.cpp
+//
+// Copyright (c) 2015, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "backend/index/index_scan_cursor.h"
+#include "backend/common/logger.h"
+#include "backend/common/value_factory.h"
+#include "backend/catalog/schema.h"
+
+namespace peloton {
+namespace index {
+
+IndexScanBounds::IndexScanBounds(const catalog::Schema *key_schema,
+                                 const std::vector<Value> &values,
+                                 const std::vector<oid_t> &key_column_ids,
+                                 const std::vector<ExpressionType> &expr_types)
+    : key_schema(key_schema),
+      column_bounds(key_schema->GetColumnCount()),
+      skip_column_count(0),
+      bounded_column_count(0) {
+  // Keep the tightest bounds of every column
+  for (size_t predicate_itr = 0; predicate_itr < key_column_ids.size();
+       predicate_itr++) {
+    const Value &value = values[predicate_itr];
+    if (value.IsNull()) {
+      continue;
+    }
+
+    ColumnBound &column_bound = column_bounds[key_column_ids[predicate_itr]];
+    auto expr_type = expr_types[predicate_itr];
+
+    bool lower_bound = false;
+    bool upper_bound = false;
+    bool inclusive = true;
+    switch (expr_type) {
+      case EXPRESSION_TYPE_COMPARE_EQUAL:
+        lower_bound = upper_bound = true;
+        break;
+      case EXPRESSION_TYPE_COMPARE_GREATERTHAN:
+        lower_bound = true;
+        inclusive = false;
+        break;
+      case EXPRESSION_TYPE_COMPARE_GREATERTHANOREQUALTO:
+        lower_bound = true;
+        break;
+      case EXPRESSION_TYPE_COMPARE_LESSTHAN:
+        upper_bound = true;
+        inclusive = false;
+        break;
+      case EXPRESSION_TYPE_COMPARE_LESSTHANOREQUALTO:
+        upper_bound = true;
+        break;
+      default:
+        // other predicates only filter the entries
+        break;
+    }
+
+    if (lower_bound == true) {
+      int diff = VALUE_COMPARE_GREATERTHAN;
+      if (column_bound.has_lower_bound == true) {
+        diff = value.Compare(column_bound.lower_bound);
+      }
+      if (diff == VALUE_COMPARE_GREATERTHAN ||
+          (diff == VALUE_COMPARE_EQUAL && inclusive == false)) {
+        column_bound.has_lower_bound = true;
+        column_bound.lower_bound_inclusive = inclusive;
+        column_bound.lower_bound = value;
+      }
+    }
+
+    if (upper_bound == true) {
+      int diff = VALUE_COMPARE_LESSTHAN;
+      if (column_bound.has_upper_bound == true) {
+        diff = value.Compare(column_bound.upper_bound);
+      }
+      if (diff == VALUE_COMPARE_LESSTHAN ||
+          (diff == VALUE_COMPARE_EQUAL && inclusive == false)) {
+        column_bound.has_upper_bound = true;
+        column_bound.upper_bound_inclusive = inclusive;
+        column_bound.upper_bound = value;
+      }
+    }
+  }
+
+  // Skip the leading columns without bounds
+  oid_t column_count = column_bounds.size();
+  oid_t column_itr = 0;
+  while (column_itr < column_count &&
+         column_bounds[column_itr].has_lower_bound == false &&
+         column_bounds[column_itr].has_upper_bound == false) {
+    column_itr++;
+  }
+
+  if (column_itr == column_count) {
+    return;
+  }
+  skip_column_count = column_itr;
+
+  // The equality columns, then one range column
+  while (column_itr < column_count &&
+         IsPointBound(column_bounds[column_itr]) == true) {
+    column_itr++;
+  }
+  if (column_itr < column_count &&
+      (column_bounds[column_itr].has_lower_bound == true ||
+       column_bounds[column_itr].has_upper_bound == true)) {
+    column_itr++;
+  }
+  bounded_column_count = column_itr - skip_column_count;
+
+  LOG_TRACE("Skipped columns : %lu Bounded columns : %lu", skip_column_count,
+            bounded_column_count);
+}
+
+bool IndexScanBounds::IsPointBound(const ColumnBound &column_bound) const {
+  return column_bound.has_lower_bound == true &&
+         column_bound.has_upper_bound == true &&
+         column_bound.lower_bound_inclusive == true &&
+         column_bound.upper_bound_inclusive == true &&
+         column_bound.lower_bound.Compare(column_bound.upper_bound) ==
+             VALUE_COMPARE_EQUAL;
+}
+
+void IndexScanBounds::ConstructLowerBoundKey(storage::Tuple *key,
+                                             const AbstractTuple *prefix_key,
+                                             VarlenPool *pool) const {
+  oid_t column_count = column_bounds.size();
+  for (oid_t column_itr = 0; column_itr < column_count; column_itr++) {
+    const ColumnBound &column_bound = column_bounds[column_itr];
+
+    if (column_itr < skip_column_count) {
+      key->SetValue(column_itr, prefix_key->GetValue(column_itr), pool);
+    } else if (column_itr < skip_column_count + bounded_column_count &&
+               column_bound.has_lower_bound == true) {
+      key->SetValue(column_itr, column_bound.lower_bound, pool);
+    }
+    // Nulls come before all other values
+    else {
+      key->SetValue(column_itr, ValueFactory::GetNullValueByType(
+                                    key_schema->GetType(column_itr)),
+                    pool);
+    }
+  }
+}
+
+bool IndexScanBounds::ConstructUpperBoundKey(storage::Tuple *key,
+                                             const AbstractTuple *prefix_key,
+                                             VarlenPool *pool) const {
+  if (IsBounded() == false) {
+    return false;
+  }
+
+  oid_t column_itr = 0;
+  for (; column_itr < skip_column_count; column_itr++) {
+    key->SetValue(column_itr, prefix_key->GetValue(column_itr), pool);
+  }
+
+  for (; column_itr < skip_column_count + bounded_column_count; column_itr++) {
+    const ColumnBound &column_bound = column_bounds[column_itr];
+    if (column_bound.has_upper_bound == false) {
+      break;
+    }
+    key->SetValue(column_itr, column_bound.upper_bound, pool);
+  }
+
+  return SetMaxValues(key, column_itr, pool);
+}
+
+bool IndexScanBounds::ConstructPrefixEndKey(storage::Tuple *key,
+                                            const AbstractTuple &prefix_key,
+                                            VarlenPool *pool) const {
+  for (oid_t column_itr = 0; column_itr < skip_column_count; column_itr++) {
+    key->SetValue(column_itr, prefix_key.GetValue(column_itr), pool);
+  }
+
+  return SetMaxValues(key, skip_column_count, pool);
+}
+
+bool IndexScanBounds::SetMaxValues(storage::Tuple *key,
+                                   oid_t begin_column_id,
+                                   VarlenPool *pool) const {
+  oid_t column_count = column_bounds.size();
+  for (oid_t column_itr = begin_column_id; column_itr < column_count;
+       column_itr++) {
+    auto value_type = key_schema->GetType(column_itr);
+    if (Value::HasMaxValue(value_type) == false) {
+      return false;
+    }
+    key->SetValue(column_itr, Value::GetMaxValue(value_type), pool);
+  }
+
+  return true;
+}
+
+bool IndexScanBounds::IsBeforeLowerBound(const AbstractTuple &key) const {
+  // Compare the bounded columns in key order
+  for (oid_t column_itr = skip_column_count;
+       column_itr < skip_column_count + bounded_column_count; column_itr++) {
+    const ColumnBound &column_bound = column_bounds[column_itr];
+    if (column_bound.has_lower_bound == false) {
+      return false;
+    }
+
+    int diff = key.GetValue(column_itr).Compare(column_bound.lower_bound);
+    if (diff == VALUE_COMPARE_LESSTHAN) {
+      return true;
+    } else if (diff == VALUE_COMPARE_GREATERTHAN) {
+      return false;
+    } else if (column_bound.lower_bound_inclusive == false) {
+      return true;
+    }
+  }
+
+  return false;
+}
+
+bool IndexScanBounds::IsAfterUpperBound(const AbstractTuple &key) const {
+  // Compare the bounded columns in key order
+  for (oid_t column_itr = skip_column_count;
+       column_itr < skip_column_count + bounded_column_count; column_itr++) {
+    const ColumnBound &column_bound = column_bounds[column_itr];
+    if (column_bound.has_upper_bound == false) {
+      return false;
+    }
+
+    int diff = key.GetValue(column_itr).Compare(column_bound.upper_bound);
+    if (diff == VALUE_COMPARE_GREATERTHAN) {
+      return true;
+    } else if (diff == VALUE_COMPARE_LESSTHAN) {
+      return false;
+    } else if (column_bound.upper_bound_inclusive == false) {
+      return true;
+    }
+  }
+
+  return false;
+}
+
+bool IndexScanBounds::HasSamePrefix(const AbstractTuple &lhs,
+                                    const AbstractTuple &rhs) const {
+  for (oid_t column_itr = 0; column_itr < skip_column_count; column_itr++) {
+    if (lhs.GetValue(column_itr).Compare(rhs.GetValue(column_itr)) !=
+        VALUE_COMPARE_EQUAL) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+}  // End index namespace
+}  // End peloton namespace
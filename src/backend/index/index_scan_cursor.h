@@ -0,0 +1,374 @@
+//===----------------------------------------------------------------------===//
+//
+//                         PelotonDB
+//
+// index_scan_cursor.h
+//
+// Identification: src/backend/index/index_scan_cursor.h
+//
+// Copyright (c) 2015, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <algorithm>
+#include <functional>
+#include <memory>
+#include <set>
+#include <vector>
+
+#include "backend/common/types.h"
+#include "backend/index/index.h"
+#include "backend/index/index_key.h"
+#include "backend/storage/tile.h"
+#include "backend/storage/tuple.h"
+
+namespace peloton {
+namespace index {
+
+/**
+ * Cursor over locations that were collected up front, for indexes that
+ * cannot resume a scan.
+ *
+ * A tuple updated in place has an entry for every key it had, its location is
+ * returned only once.
+ */
+class MaterializedIndexScanCursor : public IndexScanCursor {
+ public:
+  MaterializedIndexScanCursor(std::vector<ItemPointer> &&locations)
+      : locations(std::move(locations)), location_itr(0) {
+    std::set<ItemPointer, ItemPointerComparator> seen_locations;
+    auto end = std::remove_if(
+        this->locations.begin(), this->locations.end(),
+        [&seen_locations](const ItemPointer &location) -> bool {
+          return seen_locations.insert(location).second == false;
+        });
+    this->locations.erase(end, this->locations.end());
+  }
+
+  bool GetNextBatch(std::vector<ItemPointer> &batch, const size_t batch_size) {
+    if (location_itr == locations.size()) {
+      return false;
+    }
+
+    size_t batch_end = locations.size();
+    if (batch_end - location_itr > batch_size) {
+      batch_end = location_itr + batch_size;
+    }
+
+    batch.insert(batch.end(), locations.begin() + location_itr,
+                 locations.begin() + batch_end);
+    location_itr = batch_end;
+    return true;
+  }
+
+ private:
+  std::vector<ItemPointer> locations;
+
+  size_t location_itr;
+};
+
+/**
+ * Key range of an ordered index scan, derived from the scan predicates.
+ *
+ * The leading key columns without predicates are skipped: the range applies
+ * within every distinct prefix of them. The range covers the next columns
+ * with equality predicates and at most one more column with range
+ * predicates, predicates on later columns only filter the entries.
+ */
+class IndexScanBounds {
+ public:
+  IndexScanBounds(const catalog::Schema *key_schema,
+                  const std::vector<Value> &values,
+                  const std::vector<oid_t> &key_column_ids,
+                  const std::vector<ExpressionType> &expr_types);
+
+  // Check if the predicates restrict the range of keys to scan
+  bool IsBounded() const { return bounded_column_count > 0; }
+
+  oid_t GetSkipColumnCount() const { return skip_column_count; }
+
+  // Construct the first key of the range, taking the skipped columns from
+  // the prefix key
+  void ConstructLowerBoundKey(storage::Tuple *key,
+                              const AbstractTuple *prefix_key,
+                              VarlenPool *pool) const;
+
+  // Construct the last key of the range, returns false if the range is not
+  // bounded or a column has no max value
+  bool ConstructUpperBoundKey(storage::Tuple *key,
+                              const AbstractTuple *prefix_key,
+                              VarlenPool *pool) const;
+
+  // Construct a key not less than any key with the same prefix, returns false
+  // if a column has no max value
+  bool ConstructPrefixEndKey(storage::Tuple *key,
+                             const AbstractTuple &prefix_key,
+                             VarlenPool *pool) const;
+
+  bool IsBeforeLowerBound(const AbstractTuple &key) const;
+
+  bool IsAfterUpperBound(const AbstractTuple &key) const;
+
+  bool HasSamePrefix(const AbstractTuple &lhs, const AbstractTuple &rhs) const;
+
+ private:
+  struct ColumnBound {
+    ColumnBound()
+        : has_lower_bound(false),
+          lower_bound_inclusive(false),
+          has_upper_bound(false),
+          upper_bound_inclusive(false) {}
+
+    bool has_lower_bound;
+    bool lower_bound_inclusive;
+    Value lower_bound;
+
+    bool has_upper_bound;
+    bool upper_bound_inclusive;
+    Value upper_bound;
+  };
+
+  bool IsPointBound(const ColumnBound &column_bound) const;
+
+  // Fill the key columns starting at the given one with max values
+  bool SetMaxValues(storage::Tuple *key, oid_t begin_column_id,
+                    VarlenPool *pool) const;
+
+  const catalog::Schema *key_schema;
+
+  std::vector<ColumnBound> column_bounds;
+
+  oid_t skip_column_count;
+
+  // columns after the skipped ones that bound the range
+  oid_t bounded_column_count;
+};
+
+/**
+ * Cursor over an ordered index.
+ *
+ * The scan starts at the lower bound key and stops at the first key after
+ * the upper bound. When leading key columns are skipped, the cursor seeks to
+ * the range within every prefix and past the prefix once the range ends.
+ * Every batch resumes at the first key not yet returned, skipping the entries
+ * of that key already returned. The scan function visits the entries in key
+ * order starting at the first key not less than the given key (or at the
+ * first entry, given nullptr) until the visitor returns false, and latches
+ * the index only while it runs.
+ */
+template <typename KeyType, class KeyEqualityChecker>
+class OrderedIndexScanCursor : public IndexScanCursor {
+ public:
+  typedef std::function<bool(const KeyType &, const ItemPointer &)> Visitor;
+
+  typedef std::function<void(const KeyType *, Visitor)> ScanFunction;
+
+  OrderedIndexScanCursor(IndexMetadata *metadata, VarlenPool *pool,
+                         ScanFunction scan_function,
+                         const std::vector<Value> &values,
+                         const std::vector<oid_t> &key_column_ids,
+                         const std::vector<ExpressionType> &expr_types)
+      : key_schema(metadata->GetKeySchema()),
+        key_column_count(key_schema->GetColumnCount()),
+        key_equals(metadata),
+        pool(pool),
+        scan_function(scan_function),
+        bounds(key_schema, values, key_column_ids, expr_types),
+        values(values),
+        key_column_ids(key_column_ids),
+        expr_types(expr_types),
+        bound_key_tuple(new storage::Tuple(key_schema, true)),
+        has_seek_key(false),
+        has_last_key(false),
+        has_prefix(false),
+        prefix_finished(false),
+        exhausted(false) {
+    // A skip scan finds the first prefix at the first entry
+    if (bounds.IsBounded() == true && bounds.GetSkipColumnCount() == 0) {
+      bounds.ConstructLowerBoundKey(bound_key_tuple.get(), nullptr, pool);
+      seek_key.SetFromKey(bound_key_tuple.get());
+      has_seek_key = true;
+    }
+  }
+
+  bool GetNextBatch(std::vector<ItemPointer> &locations,
+                    const size_t batch_size) {
+    return ScanBatch(locations, batch_size, nullptr);
+  }
+
+  bool HasKeys() const { return true; }
+
+  bool GetNextKeyBatch(std::vector<ItemPointer> &locations,
+                       const size_t batch_size, storage::Tile *key_tile) {
+    return ScanBatch(locations, batch_size, key_tile);
+  }
+
+ private:
+  enum ScanStop { SCAN_STOP_END, SCAN_STOP_SEEK, SCAN_STOP_BATCH_FULL };
+
+  bool ScanBatch(std::vector<ItemPointer> &locations, const size_t batch_size,
+                 storage::Tile *key_tile) {
+    if (exhausted == true) {
+      return false;
+    }
+
+    size_t location_count = 0;
+    ScanStop scan_stop;
+
+    do {
+      scan_stop = SCAN_STOP_END;
+      const KeyType *scan_begin_key = nullptr;
+      if (has_seek_key == true) {
+        scan_begin_key = &seek_key;
+      }
+
+      scan_function(scan_begin_key, [&](const KeyType &scan_current_key,
+                                        const ItemPointer &location) -> bool {
+        auto tuple = scan_current_key.GetTupleForComparison(key_schema);
+
+        if (bounds.GetSkipColumnCount() > 0) {
+          bool same_prefix =
+              (has_prefix == true &&
+               bounds.HasSamePrefix(
+                   tuple, prefix_key.GetTupleForComparison(key_schema)));
+
+          if (same_prefix == false) {
+            prefix_key = scan_current_key;
+            has_prefix = true;
+            prefix_finished = false;
+
+            // Seek to the range within the new prefix
+            if (bounds.IsBeforeLowerBound(tuple) == true) {
+              bounds.ConstructLowerBoundKey(bound_key_tuple.get(), &tuple,
+                                            pool);
+              Seek(scan_stop);
+              return false;
+            }
+          } else if (prefix_finished == true) {
+            return true;
+          }
+
+          // Seek past the prefix once its range ends, or walk past it if
+          // the key has no max value
+          if (bounds.IsAfterUpperBound(tuple) == true) {
+            prefix_finished = true;
+            if (bounds.ConstructPrefixEndKey(bound_key_tuple.get(), tuple,
+                                             pool) == true) {
+              Seek(scan_stop);
+              return false;
+            }
+            return true;
+          }
+        } else if (bounds.IsAfterUpperBound(tuple) == true) {
+          return false;
+        }
+
+        if (bounds.IsBeforeLowerBound(tuple) == true) {
+          return true;
+        }
+
+        bool is_last_key =
+            (has_last_key == true && key_equals(scan_current_key, last_key));
+        if (is_last_key == true &&
+            last_key_locations.find(location) != last_key_locations.end()) {
+          return true;
+        }
+
+        if (Index::Compare(tuple, key_column_ids, expr_types, values) ==
+            false) {
+          return true;
+        }
+
+        // Stop at the first match that does not fit, so that an exhausted
+        // scan is noticed without another batch. The entries of its key
+        // before it were all returned.
+        if (location_count == batch_size) {
+          seek_key = scan_current_key;
+          has_seek_key = true;
+          scan_stop = SCAN_STOP_BATCH_FULL;
+          return false;
+        }
+
+        if (is_last_key == false) {
+          last_key = scan_current_key;
+          has_last_key = true;
+          last_key_locations.clear();
+        }
+        last_key_locations.insert(location);
+
+        if (key_tile != nullptr) {
+          oid_t key_offset = locations.size();
+          for (oid_t column_itr = 0; column_itr < key_column_count;
+               column_itr++) {
+            key_tile->SetValue(tuple.GetValue(column_itr), key_offset,
+                               column_itr);
+          }
+        }
+
+        locations.push_back(location);
+        location_count++;
+        return true;
+      });
+    } while (scan_stop == SCAN_STOP_SEEK);
+
+    if (scan_stop == SCAN_STOP_END) {
+      exhausted = true;
+    }
+
+    return (location_count > 0);
+  }
+
+  // Continue the scan at the bound key just constructed
+  void Seek(ScanStop &scan_stop) {
+    seek_key.SetFromKey(bound_key_tuple.get());
+    has_seek_key = true;
+    scan_stop = SCAN_STOP_SEEK;
+  }
+
+  const catalog::Schema *key_schema;
+
+  oid_t key_column_count;
+
+  KeyEqualityChecker key_equals;
+
+  VarlenPool *pool;
+
+  ScanFunction scan_function;
+
+  IndexScanBounds bounds;
+
+  std::vector<Value> values;
+
+  std::vector<oid_t> key_column_ids;
+
+  std::vector<ExpressionType> expr_types;
+
+  // owns the data the bound keys may point to
+  std::unique_ptr<storage::Tuple> bound_key_tuple;
+
+  // the key the next scan starts from
+  bool has_seek_key;
+
+  KeyType seek_key;
+
+  // the key of the last location returned, and all its locations returned
+  bool has_last_key;
+
+  KeyType last_key;
+
+  std::set<ItemPointer, ItemPointerComparator> last_key_locations;
+
+  // the prefix of the skipped columns being scanned
+  bool has_prefix;
+
+  KeyType prefix_key;
+
+  bool prefix_finished;
+
+  bool exhausted;
+};
+
+}  // End index namespace
+}  // End peloton namespace
@@ -0,0 +1,875 @@
+//===----------------------------------------------------------------------===//
+//
+//                         PelotonDB
+//
+// olc_btree.h
+//
+// Identification: src/backend/index/olc_btree.h
+//
+// Copyright (c) 2015, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <cstdint>
+#include <functional>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace peloton {
+namespace index {
+
+/**
+ * B+tree with optimistic lock coupling (Leis et al., "The ART of Practical
+ * Synchronization", DaMoN 2016).
+ *
+ * Every node has a version latch. Readers never write to shared memory: they
+ * remember the version of a node, read it, and restart if the version has
+ * changed by the time they move on to the next node. Writers upgrade the
+ * version latch of the nodes they modify, so only the nodes touched by an
+ * insert or delete are latched, and a full node is split on the way down
+ * while its parent is latched.
+ *
+ * Entries are ordered by < key, value >, which keeps the entries of a key
+ * together even when they span several leaves. Leaves are chained through
+ * their right siblings for range scans. Nodes are never merged or freed
+ * before the tree is destroyed, so readers can follow stale pointers safely.
+ */
+template <typename KeyType, typename ValueType, class KeyComparator,
+          class KeyEqualityChecker, class ValueComparator>
+class OLCBTree {
+  OLCBTree(OLCBTree const &) = delete;
+
+ public:
+  OLCBTree(const KeyComparator &comparator, const KeyEqualityChecker &key_equals)
+      : comparator(comparator), key_equals(key_equals), memory_footprint(0) {
+    LeafNode *leaf = new LeafNode();
+    memory_footprint += sizeof(LeafNode);
+    root.store(leaf);
+  }
+
+  ~OLCBTree() { FreeNode(root.load()); }
+
+  void Insert(const KeyType &key, const ValueType &value) {
+    InsertEntry(key, value, nullptr);
+  }
+
+  // Insert the pair unless the predicate holds for a value with the same key,
+  // the check and the insert are atomic
+  bool ConditionalInsert(const KeyType &key, const ValueType &value,
+                         std::function<bool(const ValueType &)> predicate) {
+    return InsertEntry(key, value, &predicate);
+  }
+
+  // Delete all copies of the pair
+  void Delete(const KeyType &key, const ValueType &value) {
+    Entry entry(key, value);
+
+    while (true) {
+      uint64_t version;
+      LeafNode *leaf = FindLeaf(&entry.first, &entry.second,
+                                SEARCH_MODE_ENTRY_LOWER_BOUND, version);
+
+      // The copies may span several leaves
+      std::vector<std::pair<LeafNode *, uint64_t>> leaves;
+      size_t match_count = 0;
+      bool restart = false;
+
+      while (true) {
+        bool stop = false;
+        size_t count = GetCount(leaf);
+        for (size_t entry_itr = 0; entry_itr < count; entry_itr++) {
+          if (EntryLess(entry, leaf->entries[entry_itr])) {
+            stop = true;
+            break;
+          }
+          if (EntryLess(leaf->entries[entry_itr], entry) == false) {
+            match_count++;
+          }
+        }
+
+        LeafNode *next = leaf->next;
+        CheckOrRestart(leaf, version, restart);
+        if (restart) {
+          break;
+        }
+
+        leaves.push_back(std::make_pair(leaf, version));
+        if (stop == true || next == nullptr) {
+          break;
+        }
+
+        leaf = next;
+        version = ReadLockOrRestart(leaf, restart);
+        if (restart) {
+          break;
+        }
+      }
+
+      if (restart) {
+        continue;
+      }
+
+      // Nothing to delete
+      if (match_count == 0) {
+        return;
+      }
+
+      if (WriteLockLeaves(leaves) == false) {
+        continue;
+      }
+
+      for (auto &locked_leaf : leaves) {
+        RemoveFromLeaf(locked_leaf.first, entry);
+        WriteUnlock(locked_leaf.first);
+      }
+      return;
+    }
+  }
+
+  // Get the values of the given key in < value > order
+  void GetValues(const KeyType &key, std::vector<ValueType> &values) {
+    Scan(&key, [&](const KeyType &entry_key, const ValueType &value) {
+      if (key_equals(entry_key, key) == false) {
+        return false;
+      }
+      values.push_back(value);
+      return true;
+    });
+  }
+
+  // Get the values of a batch of keys sorted in key order, the values of
+  // keys[i] go to values[i]. The copy of the last leaf is searched for the
+  // next key, then its right sibling, which is prefetched, so a batch of close
+  // keys descends the tree only a few times.
+  void MultiGetValues(const std::vector<KeyType> &keys,
+                      std::vector<std::vector<ValueType>> &values) {
+    values.assign(keys.size(), std::vector<ValueType>());
+    std::vector<Entry> entries;
+    LeafNode *next = nullptr;
+    bool has_leaf = false;
+
+    for (size_t key_itr = 0; key_itr < keys.size(); key_itr++) {
+      auto &key = keys[key_itr];
+
+      if (has_leaf == true && next != nullptr &&
+          (entries.empty() || comparator(entries.back().first, key))) {
+        next = ReadNextLeaf(next, entries);
+      }
+
+      if (has_leaf == false || entries.empty() ||
+          comparator(entries.back().first, key)) {
+        uint64_t version;
+        LeafNode *leaf = FindLeaf(&key, nullptr, SEARCH_MODE_KEY_LOWER_BOUND,
+                                  version);
+        next = ReadNextLeaf(leaf, entries);
+        has_leaf = true;
+      }
+
+      auto entry_itr = std::lower_bound(
+          entries.begin(), entries.end(), key,
+          [this](const Entry &entry, const KeyType &search_key) {
+            return comparator(entry.first, search_key);
+          });
+
+      // The values of the key may continue in the right siblings
+      while (true) {
+        for (; entry_itr != entries.end(); ++entry_itr) {
+          if (comparator(key, entry_itr->first)) {
+            break;
+          }
+          values[key_itr].push_back(entry_itr->second);
+        }
+
+        if (entry_itr != entries.end() || next == nullptr) {
+          break;
+        }
+
+        next = ReadNextLeaf(next, entries);
+        entry_itr = entries.begin();
+      }
+    }
+  }
+
+  // Visit the entries in key order, starting at the first key not less than
+  // start_key (or the smallest key if start_key is nullptr), until the
+  // visitor returns false
+  void Scan(const KeyType *start_key,
+            std::function<bool(const KeyType &, const ValueType &)> visitor) {
+    uint64_t version;
+    LeafNode *leaf = FindLeaf(start_key, nullptr, SEARCH_MODE_KEY_LOWER_BOUND,
+                              version);
+    std::vector<Entry> entries;
+
+    while (leaf != nullptr) {
+      // Visit a consistent copy of the leaf, no latch is held meanwhile
+      LeafNode *next = ReadLeaf(leaf, entries);
+
+      auto entry_itr = entries.begin();
+      if (start_key != nullptr) {
+        entry_itr = std::lower_bound(
+            entries.begin(), entries.end(), *start_key,
+            [this](const Entry &entry, const KeyType &key) {
+              return comparator(entry.first, key);
+            });
+      }
+
+      for (; entry_itr != entries.end(); ++entry_itr) {
+        if (visitor(entry_itr->first, entry_itr->second) == false) {
+          return;
+        }
+      }
+
+      leaf = next;
+    }
+  }
+
+  // Load entries sorted by < key, value > into the empty tree bottom up,
+  // returns false if the tree is not empty. Readers may run meanwhile, but
+  // no writers.
+  bool BulkLoad(const std::vector<std::pair<KeyType, ValueType>> &entries) {
+    Node *first_leaf = root.load();
+    if (first_leaf->is_leaf == false || first_leaf->count > 0) {
+      return false;
+    }
+    if (entries.empty()) {
+      return true;
+    }
+
+    // Spread the entries evenly over as few leaves as possible, the empty
+    // root becomes the first leaf once the other nodes are built
+    size_t leaf_count =
+        (entries.size() + LEAF_NODE_CAPACITY - 1) / LEAF_NODE_CAPACITY;
+    std::vector<Node *> level;
+    std::vector<const Entry *> low_entries;
+    LeafNode *second_leaf = nullptr;
+
+    for (size_t leaf_itr = 0; leaf_itr < leaf_count; leaf_itr++) {
+      size_t begin = entries.size() * leaf_itr / leaf_count;
+      low_entries.push_back(&entries[begin]);
+
+      if (leaf_itr == 0) {
+        level.push_back(first_leaf);
+        continue;
+      }
+
+      size_t end = entries.size() * (leaf_itr + 1) / leaf_count;
+      LeafNode *leaf = new LeafNode();
+      memory_footprint += sizeof(LeafNode);
+      std::copy(entries.begin() + begin, entries.begin() + end, leaf->entries);
+      leaf->count = end - begin;
+
+      if (leaf_itr == 1) {
+        second_leaf = leaf;
+      } else {
+        static_cast<LeafNode *>(level.back())->next = leaf;
+      }
+      level.push_back(leaf);
+    }
+
+    // Group every level into parents, separated by the lowest entry of the
+    // right child
+    while (level.size() > 1) {
+      size_t inner_count = (level.size() + INNER_NODE_CAPACITY) /
+                           (INNER_NODE_CAPACITY + 1);
+      std::vector<Node *> parents;
+      std::vector<const Entry *> parent_low_entries;
+
+      for (size_t inner_itr = 0; inner_itr < inner_count; inner_itr++) {
+        size_t begin = level.size() * inner_itr / inner_count;
+        size_t end = level.size() * (inner_itr + 1) / inner_count;
+        InnerNode *inner = new InnerNode();
+        memory_footprint += sizeof(InnerNode);
+
+        inner->children[0] = level[begin];
+        for (size_t child_itr = begin + 1; child_itr < end; child_itr++) {
+          inner->separators[child_itr - begin - 1] = *low_entries[child_itr];
+          inner->children[child_itr - begin] = level[child_itr];
+        }
+        inner->count = end - begin - 1;
+
+        parents.push_back(inner);
+        parent_low_entries.push_back(low_entries[begin]);
+      }
+
+      level.swap(parents);
+      low_entries.swap(parent_low_entries);
+    }
+
+    // Readers of the empty root restart once it is latched
+    LeafNode *leaf = static_cast<LeafNode *>(first_leaf);
+    size_t end = entries.size() / leaf_count;
+    leaf->version.fetch_add(LATCH_BIT);
+    std::copy(entries.begin(), entries.begin() + end, leaf->entries);
+    leaf->count = end;
+    leaf->next = second_leaf;
+    root.store(level[0]);
+    WriteUnlock(leaf);
+    return true;
+  }
+
+  size_t GetMemoryFootprint() const {
+    return sizeof(OLCBTree) + memory_footprint.load();
+  }
+
+ private:
+  typedef std::pair<KeyType, ValueType> Entry;
+
+  //===--------------------------------------------------------------------===//
+  // Nodes
+  //===--------------------------------------------------------------------===//
+
+  struct Node {
+    Node(bool is_leaf) : version(0), is_leaf(is_leaf), count(0) {}
+
+    // bit 1 is the latch, the remaining bits count the modifications
+    std::atomic<uint64_t> version;
+
+    bool is_leaf;
+
+    // number of entries or separators
+    uint32_t count;
+  };
+
+  // Node sizes are about a page, but with a few entries at least for wide keys
+  static const size_t NODE_SIZE = 4096;
+
+  static const size_t LEAF_NODE_CAPACITY =
+      (NODE_SIZE / sizeof(Entry) > 4) ? (NODE_SIZE / sizeof(Entry)) : 4;
+
+  static const size_t INNER_NODE_CAPACITY =
+      (NODE_SIZE / (sizeof(Entry) + sizeof(Node *)) > 4)
+          ? (NODE_SIZE / (sizeof(Entry) + sizeof(Node *)))
+          : 4;
+
+  struct LeafNode : public Node {
+    LeafNode() : Node(true), next(nullptr) {}
+
+    Entry entries[LEAF_NODE_CAPACITY];
+
+    // right sibling
+    LeafNode *next;
+  };
+
+  // The child i holds the entries between separator i-1 and separator i
+  struct InnerNode : public Node {
+    InnerNode() : Node(false) {}
+
+    Entry separators[INNER_NODE_CAPACITY];
+
+    Node *children[INNER_NODE_CAPACITY + 1];
+  };
+
+  //===--------------------------------------------------------------------===//
+  // Version Latches
+  //===--------------------------------------------------------------------===//
+
+  static uint64_t ReadLockOrRestart(Node *node, bool &restart) {
+    uint64_t version = node->version.load();
+    if (version & LATCH_BIT) {
+      std::this_thread::yield();
+      restart = true;
+    }
+    return version;
+  }
+
+  static void CheckOrRestart(Node *node, uint64_t version, bool &restart) {
+    if (node->version.load() != version) {
+      restart = true;
+    }
+  }
+
+  static void UpgradeToWriteLockOrRestart(Node *node, uint64_t version,
+                                          bool &restart) {
+    if (node->version.compare_exchange_strong(version, version + LATCH_BIT) ==
+        false) {
+      restart = true;
+    }
+  }
+
+  static void WriteUnlock(Node *node) { node->version.fetch_add(LATCH_BIT); }
+
+  // Latch leaves in left to right order, or none of them
+  static bool WriteLockLeaves(
+      std::vector<std::pair<LeafNode *, uint64_t>> &leaves) {
+    for (size_t leaf_itr = 0; leaf_itr < leaves.size(); leaf_itr++) {
+      bool restart = false;
+      UpgradeToWriteLockOrRestart(leaves[leaf_itr].first,
+                                  leaves[leaf_itr].second, restart);
+      if (restart) {
+        while (leaf_itr-- > 0) {
+          WriteUnlock(leaves[leaf_itr].first);
+        }
+        return false;
+      }
+    }
+    return true;
+  }
+
+  //===--------------------------------------------------------------------===//
+  // Search
+  //===--------------------------------------------------------------------===//
+
+  enum SearchMode {
+    // first entry with a key not less than the search key
+    SEARCH_MODE_KEY_LOWER_BOUND,
+
+    // first entry not less than the search entry
+    SEARCH_MODE_ENTRY_LOWER_BOUND,
+
+    // first entry greater than the search entry
+    SEARCH_MODE_ENTRY_UPPER_BOUND
+  };
+
+  bool EntryLess(const Entry &lhs, const Entry &rhs) const {
+    if (comparator(lhs.first, rhs.first)) {
+      return true;
+    } else if (comparator(rhs.first, lhs.first)) {
+      return false;
+    }
+    return value_comparator(lhs.second, rhs.second);
+  }
+
+  // Number of entries that precede the search target, the search key is
+  // nullptr for the leftmost position
+  size_t Search(const Entry *entries, size_t count, const KeyType *key,
+                const ValueType *value, SearchMode mode) const {
+    if (key == nullptr) {
+      return 0;
+    }
+
+    return std::partition_point(entries, entries + count,
+                                [&](const Entry &entry) -> bool {
+             switch (mode) {
+               case SEARCH_MODE_KEY_LOWER_BOUND:
+                 return comparator(entry.first, *key);
+               case SEARCH_MODE_ENTRY_LOWER_BOUND:
+                 return EntryLess(entry, Entry(*key, *value));
+               case SEARCH_MODE_ENTRY_UPPER_BOUND:
+               default:
+                 return EntryLess(Entry(*key, *value), entry) == false;
+             }
+           }) - entries;
+  }
+
+  // Count of a node read without its latch, bounded for torn reads
+  static size_t GetCount(const Node *node) {
+    size_t capacity = INNER_NODE_CAPACITY;
+    if (node->is_leaf) {
+      capacity = LEAF_NODE_CAPACITY;
+    }
+    return std::min<size_t>(node->count, capacity);
+  }
+
+  // Leaf at the search position and its version
+  LeafNode *FindLeaf(const KeyType *key, const ValueType *value,
+                     SearchMode mode, uint64_t &version) {
+    while (true) {
+      bool restart = false;
+      Node *node = root.load();
+      version = ReadLockOrRestart(node, restart);
+
+      while (restart == false && node->is_leaf == false) {
+        InnerNode *inner = static_cast<InnerNode *>(node);
+        Node *child = inner->children[Search(
+            inner->separators, GetCount(inner), key, value, mode)];
+        CheckOrRestart(inner, version, restart);
+        if (restart) {
+          break;
+        }
+
+        node = child;
+        version = ReadLockOrRestart(node, restart);
+      }
+
+      if (restart == false) {
+        return static_cast<LeafNode *>(node);
+      }
+    }
+  }
+
+  // Copy the entries of a leaf and return its right sibling
+  LeafNode *ReadLeaf(LeafNode *leaf, std::vector<Entry> &entries) {
+    while (true) {
+      bool restart = false;
+      uint64_t version = ReadLockOrRestart(leaf, restart);
+      if (restart) {
+        continue;
+      }
+
+      entries.assign(leaf->entries, leaf->entries + GetCount(leaf));
+      LeafNode *next = leaf->next;
+
+      CheckOrRestart(leaf, version, restart);
+      if (restart == false) {
+        return next;
+      }
+    }
+  }
+
+  // Copy the entries of a leaf and prefetch its right sibling
+  LeafNode *ReadNextLeaf(LeafNode *leaf, std::vector<Entry> &entries) {
+    LeafNode *next = ReadLeaf(leaf, entries);
+    if (next != nullptr) {
+      __builtin_prefetch(next);
+    }
+    return next;
+  }
+
+  //===--------------------------------------------------------------------===//
+  // Insert
+  //===--------------------------------------------------------------------===//
+
+  enum InsertResult {
+    INSERT_RESULT_RESTART,
+    INSERT_RESULT_INSERTED,
+    INSERT_RESULT_REJECTED
+  };
+
+  bool InsertEntry(const KeyType &key, const ValueType &value,
+                   std::function<bool(const ValueType &)> *predicate) {
+    while (true) {
+      switch (TryInsertEntry(Entry(key, value), predicate)) {
+        case INSERT_RESULT_INSERTED:
+          return true;
+        case INSERT_RESULT_REJECTED:
+          return false;
+        case INSERT_RESULT_RESTART:
+        default:
+          break;
+      }
+    }
+  }
+
+  InsertResult TryInsertEntry(
+      const Entry &entry, std::function<bool(const ValueType &)> *predicate) {
+    bool restart = false;
+    Node *node = root.load();
+    uint64_t version = ReadLockOrRestart(node, restart);
+    if (restart) {
+      return INSERT_RESULT_RESTART;
+    }
+
+    InnerNode *parent = nullptr;
+    uint64_t parent_version = 0;
+
+    while (node->is_leaf == false) {
+      InnerNode *inner = static_cast<InnerNode *>(node);
+
+      // Split full inner nodes on the way down, so that a parent always has
+      // room for one more separator
+      if (inner->count == INNER_NODE_CAPACITY) {
+        if (LockForSplit(parent, parent_version, inner, version) == false) {
+          return INSERT_RESULT_RESTART;
+        }
+
+        Entry separator;
+        InnerNode *right = SplitInner(inner, separator);
+        InsertSeparator(parent, inner, separator, right);
+
+        WriteUnlock(inner);
+        if (parent != nullptr) {
+          WriteUnlock(parent);
+        }
+        return INSERT_RESULT_RESTART;
+      }
+
+      if (parent != nullptr) {
+        CheckOrRestart(parent, parent_version, restart);
+        if (restart) {
+          return INSERT_RESULT_RESTART;
+        }
+      }
+
+      parent = inner;
+      parent_version = version;
+
+      node = inner->children[Search(inner->separators, GetCount(inner),
+                                    &entry.first, &entry.second,
+                                    SEARCH_MODE_ENTRY_UPPER_BOUND)];
+      CheckOrRestart(inner, version, restart);
+      if (restart) {
+        return INSERT_RESULT_RESTART;
+      }
+
+      version = ReadLockOrRestart(node, restart);
+      if (restart) {
+        return INSERT_RESULT_RESTART;
+      }
+    }
+
+    LeafNode *leaf = static_cast<LeafNode *>(node);
+
+    if (leaf->count == LEAF_NODE_CAPACITY) {
+      if (LockForSplit(parent, parent_version, leaf, version) == false) {
+        return INSERT_RESULT_RESTART;
+      }
+
+      Entry separator;
+      LeafNode *right = SplitLeaf(leaf, separator);
+      InsertSeparator(parent, leaf, separator, right);
+
+      WriteUnlock(leaf);
+      if (parent != nullptr) {
+        WriteUnlock(parent);
+      }
+      return INSERT_RESULT_RESTART;
+    }
+
+    if (parent != nullptr) {
+      CheckOrRestart(parent, parent_version, restart);
+      if (restart) {
+        return INSERT_RESULT_RESTART;
+      }
+    }
+
+    if (predicate != nullptr) {
+      return ConditionalInsertIntoLeaf(leaf, version, entry, *predicate);
+    }
+
+    UpgradeToWriteLockOrRestart(leaf, version, restart);
+    if (restart) {
+      return INSERT_RESULT_RESTART;
+    }
+
+    InsertIntoLeaf(leaf, entry);
+    WriteUnlock(leaf);
+    return INSERT_RESULT_INSERTED;
+  }
+
+  // The values of the key may span several leaves around the target leaf,
+  // all of them are latched while the predicate is checked
+  InsertResult ConditionalInsertIntoLeaf(
+      LeafNode *target, uint64_t target_version, const Entry &entry,
+      std::function<bool(const ValueType &)> &predicate) {
+    bool restart = false;
+    uint64_t version;
+    LeafNode *leaf = FindLeaf(&entry.first, nullptr,
+                              SEARCH_MODE_KEY_LOWER_BOUND, version);
+
+    std::vector<std::pair<LeafNode *, uint64_t>> leaves;
+    std::vector<ValueType> values;
+    bool found_target = false;
+
+    while (true) {
+      bool stop = false;
+      size_t count = GetCount(leaf);
+      for (size_t entry_itr = 0; entry_itr < count; entry_itr++) {
+        auto &leaf_entry = leaf->entries[entry_itr];
+        if (comparator(entry.first, leaf_entry.first)) {
+          stop = true;
+          break;
+        }
+        if (comparator(leaf_entry.first, entry.first) == false) {
+          values.push_back(leaf_entry.second);
+        }
+      }
+
+      LeafNode *next = leaf->next;
+      CheckOrRestart(leaf, version, restart);
+      if (restart) {
+        return INSERT_RESULT_RESTART;
+      }
+
+      if (leaf == target) {
+        if (version != target_version) {
+          return INSERT_RESULT_RESTART;
+        }
+        found_target = true;
+      }
+
+      leaves.push_back(std::make_pair(leaf, version));
+
+      // The target leaf always comes before the first larger key
+      if (stop == true || next == nullptr) {
+        if (found_target == false) {
+          return INSERT_RESULT_RESTART;
+        }
+        break;
+      }
+
+      leaf = next;
+      version = ReadLockOrRestart(leaf, restart);
+      if (restart) {
+        return INSERT_RESULT_RESTART;
+      }
+    }
+
+    if (WriteLockLeaves(leaves) == false) {
+      return INSERT_RESULT_RESTART;
+    }
+
+    InsertResult result = INSERT_RESULT_INSERTED;
+    for (auto &existing_value : values) {
+      if (predicate(existing_value) == true) {
+        result = INSERT_RESULT_REJECTED;
+        break;
+      }
+    }
+
+    if (result == INSERT_RESULT_INSERTED) {
+      InsertIntoLeaf(target, entry);
+    }
+
+    for (auto &locked_leaf : leaves) {
+      WriteUnlock(locked_leaf.first);
+    }
+    return result;
+  }
+
+  // Latch a full node and its parent, or the root pointer if it has none
+  bool LockForSplit(InnerNode *parent, uint64_t parent_version, Node *node,
+                    uint64_t version) {
+    bool restart = false;
+
+    if (parent != nullptr) {
+      UpgradeToWriteLockOrRestart(parent, parent_version, restart);
+      if (restart) {
+        return false;
+      }
+    }
+
+    UpgradeToWriteLockOrRestart(node, version, restart);
+    if (restart) {
+      if (parent != nullptr) {
+        WriteUnlock(parent);
+      }
+      return false;
+    }
+
+    // Another thread has grown the tree
+    if (parent == nullptr && node != root.load()) {
+      WriteUnlock(node);
+      return false;
+    }
+
+    return true;
+  }
+
+  void InsertIntoLeaf(LeafNode *leaf, const Entry &entry) {
+    assert(leaf->count < LEAF_NODE_CAPACITY);
+
+    size_t offset = Search(leaf->entries, leaf->count, &entry.first,
+                           &entry.second, SEARCH_MODE_ENTRY_UPPER_BOUND);
+    std::move_backward(leaf->entries + offset, leaf->entries + leaf->count,
+                       leaf->entries + leaf->count + 1);
+    leaf->entries[offset] = entry;
+    leaf->count++;
+  }
+
+  void RemoveFromLeaf(LeafNode *leaf, const Entry &entry) {
+    auto last = std::remove_if(leaf->entries, leaf->entries + leaf->count,
+                               [&](const Entry &leaf_entry) -> bool {
+      return EntryLess(leaf_entry, entry) == false &&
+             EntryLess(entry, leaf_entry) == false;
+    });
+    leaf->count = last - leaf->entries;
+  }
+
+  LeafNode *SplitLeaf(LeafNode *leaf, Entry &separator) {
+    LeafNode *right = new LeafNode();
+    memory_footprint += sizeof(LeafNode);
+
+    size_t split_offset = leaf->count / 2;
+    std::copy(leaf->entries + split_offset, leaf->entries + leaf->count,
+              right->entries);
+    right->count = leaf->count - split_offset;
+    right->next = leaf->next;
+
+    leaf->count = split_offset;
+    leaf->next = right;
+
+    separator = right->entries[0];
+    return right;
+  }
+
+  InnerNode *SplitInner(InnerNode *inner, Entry &separator) {
+    InnerNode *right = new InnerNode();
+    memory_footprint += sizeof(InnerNode);
+
+    // The middle separator moves up to the parent
+    size_t split_offset = inner->count / 2;
+    std::copy(inner->separators + split_offset + 1,
+              inner->separators + inner->count, right->separators);
+    std::copy(inner->children + split_offset + 1,
+              inner->children + inner->count + 1, right->children);
+    right->count = inner->count - split_offset - 1;
+
+    separator = inner->separators[split_offset];
+    inner->count = split_offset;
+    return right;
+  }
+
+  // Add the separator of a new right sibling to the latched parent, or grow
+  // the tree if the split node is the root
+  void InsertSeparator(InnerNode *parent, Node *left, const Entry &separator,
+                       Node *right) {
+    if (parent == nullptr) {
+      InnerNode *new_root = new InnerNode();
+      memory_footprint += sizeof(InnerNode);
+
+      new_root->count = 1;
+      new_root->separators[0] = separator;
+      new_root->children[0] = left;
+      new_root->children[1] = right;
+      root.store(new_root);
+      return;
+    }
+
+    assert(parent->count < INNER_NODE_CAPACITY);
+
+    size_t offset = 0;
+    while (parent->children[offset] != left) {
+      offset++;
+    }
+
+    std::move_backward(parent->separators + offset,
+                       parent->separators + parent->count,
+                       parent->separators + parent->count + 1);
+    std::move_backward(parent->children + offset + 1,
+                       parent->children + parent->count + 1,
+                       parent->children + parent->count + 2);
+    parent->separators[offset] = separator;
+    parent->children[offset + 1] = right;
+    parent->count++;
+  }
+
+  //===--------------------------------------------------------------------===//
+  // Memory Management
+  //===--------------------------------------------------------------------===//
+
+  void FreeNode(Node *node) {
+    if (node->is_leaf) {
+      delete static_cast<LeafNode *>(node);
+      return;
+    }
+
+    InnerNode *inner = static_cast<InnerNode *>(node);
+    for (size_t child_itr = 0; child_itr <= inner->count; child_itr++) {
+      FreeNode(inner->children[child_itr]);
+    }
+    delete inner;
+  }
+
+  //===--------------------------------------------------------------------===//
+  // Members
+  //===--------------------------------------------------------------------===//
+
+  static const uint64_t LATCH_BIT = 2;
+
+  KeyComparator comparator;
+  KeyEqualityChecker key_equals;
+  ValueComparator value_comparator;
+
+  std::atomic<Node *> root;
+
+  std::atomic<size_t> memory_footprint;
+};
+
+}  // End index namespace
+}  // End peloton namespace
@@ -0,0 +1,274 @@
+//===----------------------------------------------------------------------===//
+//
+//                         PelotonDB
+//
+// olc_btree_index.cpp
+//
+// Identification: src/backend/index/olc_btree_index.cpp
+//
+// Copyright (c) 2015, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "backend/common/logger.h"
+#include "backend/index/olc_btree_index.h"
+#include "backend/index/index_builder.h"
+#include "backend/index/index_key.h"
+#include "backend/index/index_scan_cursor.h"
+#include "backend/storage/tuple.h"
+
+#include <algorithm>
+#include <limits>
+
+namespace peloton {
+namespace index {
+
+template <typename KeyType, typename ValueType, class KeyComparator, class KeyEqualityChecker>
+OLCBTreeIndex<KeyType, ValueType, KeyComparator, KeyEqualityChecker>::OLCBTreeIndex(
+    IndexMetadata *metadata)
+    : Index(metadata),
+      container(KeyComparator(metadata), KeyEqualityChecker(metadata)),
+      equals(metadata),
+      comparator(metadata) {}
+
+template <typename KeyType, typename ValueType, class KeyComparator, class KeyEqualityChecker>
+OLCBTreeIndex<KeyType, ValueType, KeyComparator, KeyEqualityChecker>::~OLCBTreeIndex() {}
+
+template <typename KeyType, typename ValueType, class KeyComparator, class KeyEqualityChecker>
+bool OLCBTreeIndex<KeyType, ValueType, KeyComparator, KeyEqualityChecker>::InsertEntry(
+    const storage::Tuple *key, const ItemPointer location) {
+  KeyType index_key;
+  index_key.SetFromKey(key);
+
+  // Insert the key, val pair
+  container.Insert(index_key, location);
+
+  return true;
+}
+
+template <typename KeyType, typename ValueType, class KeyComparator, class KeyEqualityChecker>
+bool OLCBTreeIndex<KeyType, ValueType, KeyComparator, KeyEqualityChecker>::ConditionalInsertEntry(
+    const storage::Tuple *key, const ItemPointer location,
+    std::function<bool(const ItemPointer &)> predicate) {
+  KeyType index_key;
+  index_key.SetFromKey(key);
+
+  // Check the existing entries with the same key and insert atomically
+  return container.ConditionalInsert(index_key, location, predicate);
+}
+
+template <typename KeyType, typename ValueType, class KeyComparator, class KeyEqualityChecker>
+bool OLCBTreeIndex<KeyType, ValueType, KeyComparator, KeyEqualityChecker>::DeleteEntry(
+    const storage::Tuple *key, const ItemPointer location) {
+  KeyType index_key;
+  index_key.SetFromKey(key);
+
+  // Delete the < key, location > pair
+  container.Delete(index_key, location);
+
+  return true;
+}
+
+template <typename KeyType, typename ValueType, class KeyComparator, class KeyEqualityChecker>
+void OLCBTreeIndex<KeyType, ValueType, KeyComparator, KeyEqualityChecker>::BulkLoad(
+    size_t part_count, const ScanPartFunction &scan_part) {
+  // Sort the entries in parallel in the < key, location > order of the tree
+  std::vector<std::pair<KeyType, ValueType>> entries;
+  ItemPointerComparator location_comparator;
+  IndexBuilder::ExtractSortedEntries(
+      this, part_count, scan_part,
+      [&](const std::pair<KeyType, ValueType> &lhs,
+          const std::pair<KeyType, ValueType> &rhs) -> bool {
+        if (comparator(lhs.first, rhs.first)) {
+          return true;
+        } else if (comparator(rhs.first, lhs.first)) {
+          return false;
+        }
+        return location_comparator(lhs.second, rhs.second);
+      },
+      entries);
+
+  // Insert the entries one by one into a populated tree
+  if (container.BulkLoad(entries) == false) {
+    for (auto &entry : entries) {
+      container.Insert(entry.first, entry.second);
+    }
+  }
+}
+
+template <typename KeyType, typename ValueType, class KeyComparator, class KeyEqualityChecker>
+std::vector<ItemPointer>
+OLCBTreeIndex<KeyType, ValueType, KeyComparator, KeyEqualityChecker>::Scan(
+    const std::vector<Value> &values,
+    const std::vector<oid_t> &key_column_ids,
+    const std::vector<ExpressionType> &expr_types,
+    const ScanDirectionType& scan_direction) {
+  std::vector<ItemPointer> result;
+
+  switch(scan_direction){
+    case SCAN_DIRECTION_TYPE_FORWARD:
+    case SCAN_DIRECTION_TYPE_BACKWARD: {
+
+      // Scan the key range in forward direction in one batch
+      auto cursor = GetScanCursor(values, key_column_ids, expr_types,
+                                  SCAN_DIRECTION_TYPE_FORWARD);
+      cursor->GetNextBatch(result, std::numeric_limits<size_t>::max());
+
+      // The leaves are only linked in forward direction
+      if (scan_direction == SCAN_DIRECTION_TYPE_BACKWARD) {
+        std::reverse(result.begin(), result.end());
+      }
+
+    }
+    break;
+
+    case SCAN_DIRECTION_TYPE_INVALID:
+    default:
+      throw Exception("Invalid scan direction \n");
+      break;
+  }
+
+  return result;
+}
+
+template <typename KeyType, typename ValueType, class KeyComparator, class KeyEqualityChecker>
+std::vector<ItemPointer>
+OLCBTreeIndex<KeyType, ValueType, KeyComparator, KeyEqualityChecker>::ScanAllKeys() {
+  std::vector<ItemPointer> result;
+
+  // scan all entries
+  container.Scan(nullptr, [&](const KeyType &, const ItemPointer &location) {
+    result.push_back(location);
+    return true;
+  });
+
+  return result;
+}
+
+/**
+ * @brief Return all locations related to this key.
+ */
+template <typename KeyType, typename ValueType, class KeyComparator, class KeyEqualityChecker>
+std::vector<ItemPointer>
+OLCBTreeIndex<KeyType, ValueType, KeyComparator, KeyEqualityChecker>::ScanKey(
+    const storage::Tuple *key) {
+  std::vector<ItemPointer> result;
+  KeyType index_key;
+  index_key.SetFromKey(key);
+
+  // find the <key, location> pairs
+  container.GetValues(index_key, result);
+
+  return result;
+}
+
+/**
+ * @brief Return the locations of a batch of keys, probed in key order.
+ */
+template <typename KeyType, typename ValueType, class KeyComparator, class KeyEqualityChecker>
+void OLCBTreeIndex<KeyType, ValueType, KeyComparator, KeyEqualityChecker>::MultiScanKey(
+    const std::vector<const storage::Tuple *> &keys,
+    std::vector<std::vector<ItemPointer>> &locations) {
+  std::vector<KeyType> index_keys(keys.size());
+  std::vector<oid_t> key_order(keys.size());
+  for (oid_t key_itr = 0; key_itr < keys.size(); key_itr++) {
+    index_keys[key_itr].SetFromKey(keys[key_itr]);
+    key_order[key_itr] = key_itr;
+  }
+
+  std::sort(key_order.begin(), key_order.end(),
+            [this, &index_keys](const oid_t &lhs, const oid_t &rhs) -> bool {
+    return comparator(index_keys[lhs], index_keys[rhs]);
+  });
+
+  std::vector<KeyType> sorted_keys;
+  sorted_keys.reserve(keys.size());
+  for (auto key_itr : key_order) {
+    sorted_keys.push_back(index_keys[key_itr]);
+  }
+
+  std::vector<std::vector<ItemPointer>> sorted_locations;
+  container.MultiGetValues(sorted_keys, sorted_locations);
+
+  locations.resize(keys.size());
+  for (oid_t sorted_itr = 0; sorted_itr < key_order.size(); sorted_itr++) {
+    locations[key_order[sorted_itr]] = std::move(sorted_locations[sorted_itr]);
+  }
+}
+
+template <typename KeyType, typename ValueType, class KeyComparator, class KeyEqualityChecker>
+std::unique_ptr<IndexScanCursor>
+OLCBTreeIndex<KeyType, ValueType, KeyComparator, KeyEqualityChecker>::GetScanCursor(
+    const std::vector<Value> &values,
+    const std::vector<oid_t> &key_column_ids,
+    const std::vector<ExpressionType> &expr_types,
+    const ScanDirectionType& scan_direction) {
+  if (scan_direction == SCAN_DIRECTION_TYPE_INVALID) {
+    throw Exception("Invalid scan direction \n");
+  }
+
+  // Reverse scans collect the locations up front
+  if (scan_direction == SCAN_DIRECTION_TYPE_BACKWARD) {
+    return std::unique_ptr<IndexScanCursor>(new MaterializedIndexScanCursor(
+        Scan(values, key_column_ids, expr_types, scan_direction)));
+  }
+
+  // Every batch seeks to where the last one stopped
+  auto scan_function = [this](
+      const KeyType *scan_begin_key,
+      std::function<bool(const KeyType &, const ItemPointer &)> visitor) {
+    container.Scan(scan_begin_key, visitor);
+  };
+
+  return std::unique_ptr<IndexScanCursor>(
+      new OrderedIndexScanCursor<KeyType, KeyEqualityChecker>(
+          metadata, GetPool(), scan_function, values, key_column_ids,
+          expr_types));
+}
+
+template <typename KeyType, typename ValueType, class KeyComparator, class KeyEqualityChecker>
+std::string
+OLCBTreeIndex<KeyType, ValueType, KeyComparator, KeyEqualityChecker>::GetTypeName() const {
+  return "OLCBTree";
+}
+
+// Explicit template instantiation
+template class OLCBTreeIndex<IntsKey<1>, ItemPointer, IntsComparator<1>,
+IntsEqualityChecker<1>>;
+template class OLCBTreeIndex<IntsKey<2>, ItemPointer, IntsComparator<2>,
+IntsEqualityChecker<2>>;
+template class OLCBTreeIndex<IntsKey<3>, ItemPointer, IntsComparator<3>,
+IntsEqualityChecker<3>>;
+template class OLCBTreeIndex<IntsKey<4>, ItemPointer, IntsComparator<4>,
+IntsEqualityChecker<4>>;
+
+template class OLCBTreeIndex<GenericKey<4>, ItemPointer, GenericComparator<4>,
+GenericEqualityChecker<4>>;
+template class OLCBTreeIndex<GenericKey<8>, ItemPointer, GenericComparator<8>,
+GenericEqualityChecker<8>>;
+template class OLCBTreeIndex<GenericKey<12>, ItemPointer, GenericComparator<12>,
+GenericEqualityChecker<12>>;
+template class OLCBTreeIndex<GenericKey<16>, ItemPointer, GenericComparator<16>,
+GenericEqualityChecker<16>>;
+template class OLCBTreeIndex<GenericKey<24>, ItemPointer, GenericComparator<24>,
+GenericEqualityChecker<24>>;
+template class OLCBTreeIndex<GenericKey<32>, ItemPointer, GenericComparator<32>,
+GenericEqualityChecker<32>>;
+template class OLCBTreeIndex<GenericKey<48>, ItemPointer, GenericComparator<48>,
+GenericEqualityChecker<48>>;
+template class OLCBTreeIndex<GenericKey<64>, ItemPointer, GenericComparator<64>,
+GenericEqualityChecker<64>>;
+template class OLCBTreeIndex<GenericKey<96>, ItemPointer, GenericComparator<96>,
+GenericEqualityChecker<96>>;
+template class OLCBTreeIndex<GenericKey<128>, ItemPointer, GenericComparator<128>,
+GenericEqualityChecker<128>>;
+template class OLCBTreeIndex<GenericKey<256>, ItemPointer, GenericComparator<256>,
+GenericEqualityChecker<256>>;
+template class OLCBTreeIndex<GenericKey<512>, ItemPointer, GenericComparator<512>,
+GenericEqualityChecker<512>>;
+
+template class OLCBTreeIndex<TupleKey, ItemPointer, TupleKeyComparator,
+TupleKeyEqualityChecker>;
+
+}  // End index namespace
+}  // End peloton namespace
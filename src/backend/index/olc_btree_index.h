@@ -0,0 +1,96 @@
+//===----------------------------------------------------------------------===//
+//
+//                         PelotonDB
+//
+// olc_btree_index.h
+//
+// Identification: src/backend/index/olc_btree_index.h
+//
+// Copyright (c) 2015, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <vector>
+#include <string>
+#include <map>
+
+#include "backend/catalog/manager.h"
+#include "backend/common/platform.h"
+#include "backend/common/types.h"
+#include "backend/index/index.h"
+#include "backend/index/index_key.h"
+
+#include "backend/index/olc_btree.h"
+
+namespace peloton {
+namespace index {
+
+/**
+ * Optimistic lock coupling B+tree-based index implementation.
+ *
+ * @see Index
+ */
+template <typename KeyType, typename ValueType, class KeyComparator, class KeyEqualityChecker>
+class OLCBTreeIndex : public Index {
+  friend class IndexFactory;
+
+  // Define the container type
+  typedef OLCBTree<KeyType, ValueType, KeyComparator, KeyEqualityChecker,
+                   ItemPointerComparator> MapType;
+
+ public:
+  OLCBTreeIndex(IndexMetadata *metadata);
+
+  ~OLCBTreeIndex();
+
+  bool InsertEntry(const storage::Tuple *key, const ItemPointer location);
+
+  bool ConditionalInsertEntry(
+      const storage::Tuple *key, const ItemPointer location,
+      std::function<bool(const ItemPointer &)> predicate);
+
+  bool DeleteEntry(const storage::Tuple *key, const ItemPointer location);
+
+  void BulkLoad(size_t part_count, const ScanPartFunction &scan_part);
+
+  std::vector<ItemPointer> Scan(const std::vector<Value> &values,
+                                const std::vector<oid_t> &key_column_ids,
+                                const std::vector<ExpressionType> &expr_types,
+                                const ScanDirectionType& scan_direction);
+
+  std::vector<ItemPointer> ScanAllKeys();
+
+  std::vector<ItemPointer> ScanKey(const storage::Tuple *key);
+
+  void MultiScanKey(const std::vector<const storage::Tuple *> &keys,
+                    std::vector<std::vector<ItemPointer>> &locations);
+
+  std::unique_ptr<IndexScanCursor> GetScanCursor(
+      const std::vector<Value> &values,
+      const std::vector<oid_t> &key_column_ids,
+      const std::vector<ExpressionType> &expr_types,
+      const ScanDirectionType& scan_direction);
+
+  std::string GetTypeName() const;
+
+  bool Cleanup() {
+    return true;
+  }
+
+  size_t GetMemoryFootprint() {
+    return container.GetMemoryFootprint();
+  }
+
+ protected:
+  // container
+  MapType container;
+
+  // equality checker and comparator
+  KeyEqualityChecker equals;
+  KeyComparator comparator;
+};
+
+}  // End index namespace
+}  // End peloton namespace
@@ -13,6 +13,7 @@
 #include "backend_logger.h"
 
 #include "backend/common/logger.h"
+#include "backend/logging/log_manager.h"
 #include "backend/logging/loggers/aries_backend_logger.h"
 #include "backend/logging/loggers/peloton_backend_logger.h"
 
@@ -38,34 +39,32 @@ BackendLogger *BackendLogger::GetBackendLogger(LoggingType logging_type) {
 }
 
 /**
- * @brief set the wait flush to false
- */
-void BackendLogger::Commit(void) {
-  std::lock_guard<std::mutex> lock(flush_notify_mutex);
-  // Only need to commit if they are waiting for us to flush
-  if (wait_for_flushing) {
-    wait_for_flushing = false;
-    flush_notify_cv.notify_all();
-  }
-}
-
-/**
- * @brief set the wait flush to true and truncate local_queue with commit_offset
+ * @brief truncate local_queue with commit_offset
  * @param offset
  */
 void BackendLogger::TruncateLocalQueue(oid_t offset) {
-  // Lock notify first, make sure is_wait_for_flush will not return premature
-  std::lock_guard<std::mutex> lock(flush_notify_mutex);
   {
     std::lock_guard<std::mutex> lock(local_queue_mutex);
 
     // cleanup the queue
     local_queue.erase(local_queue.begin(), local_queue.begin() + offset);
   }
+}
 
-  // let's wait for the frontend logger to flush !
-  // the frontend logger will call our Commit to reset it.
-  wait_for_flushing = true;
+/**
+ * @brief Assign the next lsn to the record and add it to the local queue.
+ * The lsn is assigned under the queue lock so that the frontend logger never
+ * misses a record with an lsn smaller than the one it has observed.
+ * @param log record
+ */
+void BackendLogger::EnqueueLogRecord(LogRecord *record) {
+  auto &log_manager = LogManager::GetInstance();
+
+  {
+    std::lock_guard<std::mutex> lock(local_queue_mutex);
+    logged_lsn = log_manager.GetNextLsn();
+    local_queue.push_back(record);
+  }
 }
 
 /**
@@ -80,22 +79,6 @@ LogRecord *BackendLogger::GetLogRecord(oid_t offset) {
   }
 }
 
-/**
- * @brief if we still have log record in local queue or waiting for flushing
- * @return true otherwise false
- */
-bool BackendLogger::IsWaitingForFlushing(void) {
-  // Sometimes, the backend logger has some log records even if
-  // wait_for_flushing is false.
-  // For example, if backend logger enqueues the log record right after
-  // frontend logger collect data and not truncated yet.
-  if (wait_for_flushing || GetLocalQueueSize() > 0) {
-    return true;
-  } else {
-    return false;
-  }
-}
-
 bool BackendLogger::IsConnectedToFrontend(void) const {
   return connected_to_frontend;
 }
@@ -104,11 +87,12 @@ void BackendLogger::SetConnectedToFrontend(bool isConnected) {
   connected_to_frontend = isConnected;
 }
 
+/**
+ * @brief Wait for the group commit that makes our last log record durable
+ */
 void BackendLogger::WaitForFlushing(void) {
-  std::unique_lock<std::mutex> wait_lock(flush_notify_mutex);
-  while (IsWaitingForFlushing()) {
-    flush_notify_cv.wait(wait_lock);
-  }
+  auto &log_manager = LogManager::GetInstance();
+  log_manager.WaitForDurableLsn(logged_lsn);
 }
 
 /**
@@ -14,7 +14,6 @@
 
 #include <vector>
 #include <mutex>
-#include <condition_variable>
 
 #include "backend/logging/logger.h"
 #include "backend/logging/log_record.h"
@@ -41,8 +40,6 @@ class BackendLogger : public Logger {
   // Get the log record in the local queue at given offset
   LogRecord *GetLogRecord(oid_t offset);
 
-  void Commit(void);
-
   bool IsConnectedToFrontend(void) const;
 
   void SetConnectedToFrontend(bool isConnected);
@@ -50,10 +47,14 @@ class BackendLogger : public Logger {
   // Truncate the log file at given offset
   void TruncateLocalQueue(oid_t offset);
 
+  // Wait until all the log records of this backend are durable
   void WaitForFlushing(void);
 
   size_t GetLocalQueueSize(void);
 
+  // lsn of the last record of this backend
+  lsn_t GetLoggedLsn(void) const { return logged_lsn; }
+
   //===--------------------------------------------------------------------===//
   // Virtual Functions
   //===--------------------------------------------------------------------===//
@@ -74,18 +75,15 @@ class BackendLogger : public Logger {
                                     oid_t db_oid = INVALID_OID) = 0;
 
  protected:
-  bool IsWaitingForFlushing(void);
+  // Assign a log sequence number to the record and enqueue it
+  void EnqueueLogRecord(LogRecord *record);
 
   std::vector<LogRecord *> local_queue;
   std::mutex local_queue_mutex;
 
-  // wait for the frontend to flush
+  // lsn of the last record enqueued by this backend
   // need to ensure synchronous commit
-  bool wait_for_flushing = false;
-
-  // Used for notify any waiting thread that backend is flushed
-  std::mutex flush_notify_mutex;
-  std::condition_variable flush_notify_cv;
+  lsn_t logged_lsn = INVALID_LSN;
 
   // is this backend connected to frontend ?
   bool connected_to_frontend = false;
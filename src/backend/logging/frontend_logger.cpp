@@ -10,6 +10,7 @@
  *-------------------------------------------------------------------------
  */
 
+#include <algorithm>
 #include <thread>
 
 #include "backend/common/logger.h"
@@ -107,6 +108,10 @@ void FrontendLogger::MainLoop(void) {
 
     // Flush the data to the file
     FlushLogRecords();
+
+    // Release the committers whose log records are durable now
+    log_manager.SetDurableLsn(collected_lsn);
+    AdaptGroupCommitDelay();
   }
 
   /////////////////////////////////////////////////////////////////////
@@ -119,6 +124,7 @@ void FrontendLogger::MainLoop(void) {
   // flush any remaining log records
   CollectLogRecordsFromBackendLoggers();
   FlushLogRecords();
+  log_manager.SetDurableLsn(collected_lsn);
 
   /////////////////////////////////////////////////////////////////////
   // SLEEP MODE
@@ -134,6 +140,8 @@ void FrontendLogger::MainLoop(void) {
  * @brief Collect the log records from BackendLoggers
  */
 void FrontendLogger::CollectLogRecordsFromBackendLoggers() {
+  auto &log_manager = LogManager::GetInstance();
+
   /*
    * Don't use "while(!need_to_collect_new_log_records)",
    * we want the frontend check all backend periodically even no backend
@@ -142,10 +150,12 @@ void FrontendLogger::CollectLogRecordsFromBackendLoggers() {
    * instead of a huge submission when the txn is committed.
    */
   if (need_to_collect_new_log_records == false) {
-    auto sleep_period = std::chrono::microseconds(wait_timeout);
-    std::this_thread::sleep_for(sleep_period);
+    WaitForFlushRequest();
   }
 
+  // Every record up to this lsn is already in some local queue
+  collected_lsn = log_manager.GetCurrentLsn();
+
   {
     std::lock_guard<std::mutex> lock(backend_logger_mutex);
 
@@ -182,6 +192,58 @@ void FrontendLogger::AddBackendLogger(BackendLogger *backend_logger) {
   }
 }
 
+/**
+ * @brief Wake up the frontend logger to flush the log records right away.
+ * Called by committers waiting for their log records to become durable.
+ */
+void FrontendLogger::RequestFlush(void) {
+  std::lock_guard<std::mutex> lock(flush_request_mutex);
+
+  flush_requested = true;
+  flush_request_count++;
+  flush_request_cv.notify_one();
+}
+
+/**
+ * @brief Sleep until a committer requests a flush or the timeout expires.
+ * Under load, keep the group open a little longer so that more committers can
+ * share the same flush.
+ */
+void FrontendLogger::WaitForFlushRequest(void) {
+  std::unique_lock<std::mutex> wait_lock(flush_request_mutex);
+
+  if (flush_requested == false) {
+    auto sleep_period = std::chrono::microseconds(wait_timeout);
+    flush_request_cv.wait_for(wait_lock, sleep_period);
+  }
+
+  if (flush_requested == true && group_commit_delay > 0) {
+    wait_lock.unlock();
+    auto group_commit_period = std::chrono::microseconds(group_commit_delay);
+    std::this_thread::sleep_for(group_commit_period);
+    wait_lock.lock();
+  }
+
+  // These committers will be released by the upcoming flush
+  group_commit_size = flush_request_count;
+  flush_request_count = 0;
+  flush_requested = false;
+}
+
+/**
+ * @brief Grow the group commit window when several committers shared the last
+ * flush and shrink it otherwise, so that a lone committer pays for a single
+ * fsync while a busy system gets larger batches.
+ */
+void FrontendLogger::AdaptGroupCommitDelay(void) {
+  if (group_commit_size > 1) {
+    group_commit_delay = std::max(group_commit_delay * 2, (int64_t)1);
+    group_commit_delay = std::min(group_commit_delay, max_group_commit_delay);
+  } else {
+    group_commit_delay /= 2;
+  }
+}
+
 bool FrontendLogger::RemoveBackendLogger(BackendLogger *_backend_logger) {
   {
     std::lock_guard<std::mutex> lock(backend_logger_mutex);
@@ -45,6 +45,9 @@ class FrontendLogger : public Logger {
 
   bool RemoveBackendLogger(BackendLogger *backend_logger);
 
+  // Wake up the main loop to flush without waiting for the timeout
+  void RequestFlush(void);
+
   //===--------------------------------------------------------------------===//
   // Virtual Functions
   //===--------------------------------------------------------------------===//
@@ -56,6 +59,12 @@ class FrontendLogger : public Logger {
   virtual void DoRecovery(void) = 0;
 
  protected:
+  // Wait for a flush request from a committer or the timeout
+  void WaitForFlushRequest(void);
+
+  // Adjust the group commit window based on the last batch
+  void AdaptGroupCommitDelay(void);
+
   // Associated backend loggers
   std::vector<BackendLogger *> backend_loggers;
 
@@ -72,6 +81,31 @@ class FrontendLogger : public Logger {
 
   // used to indicate if backend has new logs
   bool need_to_collect_new_log_records = false;
+
+  //===--------------------------------------------------------------------===//
+  // Group Commit
+  //===--------------------------------------------------------------------===//
+
+  // Used by committers to wake up the frontend logger
+  std::mutex flush_request_mutex;
+  std::condition_variable flush_request_cv;
+  bool flush_requested = false;
+
+  // # of flush requests since the last collection
+  size_t flush_request_count = 0;
+
+  // # of committers released by the last flush
+  size_t group_commit_size = 0;
+
+  // extra time to wait for more committers to join a group
+  // (in microseconds)
+  int64_t group_commit_delay = 0;
+
+  // upper bound on the group commit window (in microseconds)
+  int64_t max_group_commit_delay = 1000;
+
+  // lsn up to which the collected log records go
+  lsn_t collected_lsn = INVALID_LSN;
 };
 
 }  // namespace logging
@@ -164,6 +164,9 @@ bool LogManager::RemoveBackendLogger(BackendLogger *backend_logger) {
 FrontendLogger *LogManager::GetFrontendLogger() { return frontend_logger; }
 
 bool LogManager::RemoveFrontendLogger() {
+  // Make sure no committer is requesting a flush meanwhile
+  std::lock_guard<std::mutex> lock(durable_lsn_mutex);
+
   // Erase frontend logger
   delete frontend_logger;
 
@@ -205,6 +208,65 @@ void LogManager::SetLoggingStatus(LoggingStatus logging_status_) {
     // notify everyone about the status change
     logging_status_cv.notify_all();
   }
+
+  // committers must not wait for a frontend logger that went to sleep
+  {
+    std::lock_guard<std::mutex> lock(durable_lsn_mutex);
+    durable_lsn_cv.notify_all();
+  }
+}
+
+//===--------------------------------------------------------------------===//
+// Group Commit
+//===--------------------------------------------------------------------===//
+
+/**
+ * @brief Wait until the frontend logger has flushed all log records up to the
+ * given lsn. The frontend logger is woken up right away instead of waiting for
+ * its timeout, and every committer waiting at that point joins the same flush.
+ * Each committer requests a single flush: a request that arrives while a flush
+ * is running stays pending for the next one, which covers the lsn.
+ * @param lsn
+ */
+void LogManager::WaitForDurableLsn(lsn_t lsn) {
+  std::unique_lock<std::mutex> wait_lock(durable_lsn_mutex);
+  bool flush_requested = false;
+
+  while (durable_lsn < lsn) {
+    // Nobody is going to flush our records
+    if (frontend_logger == nullptr ||
+        logging_status == LOGGING_STATUS_TYPE_SLEEP ||
+        logging_status == LOGGING_STATUS_TYPE_INVALID) {
+      LOG_WARN("No frontend logger to flush lsn : %lu", lsn);
+      break;
+    }
+
+    // Woken up by a flush of earlier records, keep waiting for ours
+    if (flush_requested == false) {
+      frontend_logger->RequestFlush();
+      flush_requested = true;
+    }
+    durable_lsn_cv.wait(wait_lock);
+  }
+}
+
+/**
+ * @brief Publish the durable lsn after a flush and wake up the committers
+ * @param lsn
+ */
+void LogManager::SetDurableLsn(lsn_t lsn) {
+  std::lock_guard<std::mutex> lock(durable_lsn_mutex);
+
+  if (lsn > durable_lsn) {
+    durable_lsn = lsn;
+  }
+
+  durable_lsn_cv.notify_all();
+}
+
+lsn_t LogManager::GetDurableLsn(void) {
+  std::lock_guard<std::mutex> lock(durable_lsn_mutex);
+  return durable_lsn;
 }
 
 void LogManager::SetLogFileName(std::string log_file) {
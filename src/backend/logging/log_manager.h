@@ -13,6 +13,7 @@
 #pragma once
 
 #include "backend/logging/logger.h"
+#include <atomic>
 #include <mutex>
 #include <map>
 #include <vector>
@@ -102,6 +103,24 @@ class LogManager {
     return (peloton_logging_mode == LOGGING_TYPE_NVM_NVM);
   }
 
+  //===--------------------------------------------------------------------===//
+  // Group Commit
+  //===--------------------------------------------------------------------===//
+
+  // Get the next log sequence number
+  lsn_t GetNextLsn(void) { return ++next_lsn; }
+
+  // Get the last assigned log sequence number
+  lsn_t GetCurrentLsn(void) const { return next_lsn; }
+
+  // Block until all log records up to the given lsn are durable
+  void WaitForDurableLsn(lsn_t lsn);
+
+  // Release all the committers whose log records are durable
+  void SetDurableLsn(lsn_t lsn);
+
+  lsn_t GetDurableLsn(void);
+
  private:
   LogManager();
   ~LogManager();
@@ -130,6 +149,16 @@ class LogManager {
   bool syncronization_commit = false;
 
   std::string log_file_name;
+
+  // last assigned log sequence number
+  std::atomic<lsn_t> next_lsn = ATOMIC_VAR_INIT(INVALID_LSN);
+
+  // all log records up to this lsn have been flushed
+  lsn_t durable_lsn = INVALID_LSN;
+
+  // To synch the committers waiting for their records to be flushed
+  std::mutex durable_lsn_mutex;
+  std::condition_variable durable_lsn_cv;
 };
 
 }  // namespace logging
@@ -125,14 +125,6 @@ void AriesFrontendLogger::FlushLogRecords(void) {
     delete record;
   }
   global_queue.clear();
-
-  // Commit each backend logger
-  {
-    std::lock_guard<std::mutex> lock(backend_logger_mutex);
-    for (auto backend_logger : backend_loggers) {
-      backend_logger->Commit();
-    }
-  }
 }
 
 //===--------------------------------------------------------------------===//
@@ -523,9 +515,38 @@ void AriesFrontendLogger::UpdateTuple(concurrency::Transaction *recovery_txn) {
     return;
   }
 
-  // First, redo the delete
   ItemPointer delete_location = tuple_record.GetDeleteLocation();
+  ItemPointer insert_location = tuple_record.GetInsertLocation();
 
+  // The tuple was updated in place, so overwrite it in its slot
+  if (delete_location.block == insert_location.block &&
+      delete_location.offset == insert_location.offset) {
+    auto &manager = catalog::Manager::GetInstance();
+    auto tile_group = manager.GetTileGroup(insert_location.block);
+
+    auto column_count = table->GetSchema()->GetColumnCount();
+    std::vector<oid_t> column_ids;
+    std::vector<Value> values;
+    for (oid_t column_itr = 0; column_itr < column_count; column_itr++) {
+      column_ids.push_back(column_itr);
+      values.push_back(tuple->GetValue(column_itr));
+    }
+
+    bool status = false;
+    if (tile_group != nullptr) {
+      status = tile_group->UpdateTuple(
+          recovery_txn->GetTransactionId(), insert_location.offset,
+          recovery_txn->GetLastCommitId(), column_ids, values);
+    }
+    if (status == false) {
+      recovery_txn->SetResult(Result::RESULT_FAILURE);
+    }
+
+    delete tuple;
+    return;
+  }
+
+  // First, redo the delete
   bool status = table->DeleteTuple(recovery_txn, delete_location);
   if (status == false) {
     recovery_txn->SetResult(Result::RESULT_FAILURE);
@@ -33,10 +33,7 @@ void PelotonBackendLogger::Log(LogRecord *record) {
   // Enqueue the serialized log record into the queue
   record->Serialize(output_buffer);
 
-  {
-    std::lock_guard<std::mutex> lock(local_queue_mutex);
-    local_queue.push_back(record);
-  }
+  EnqueueLogRecord(record);
 }
 
 LogRecord *PelotonBackendLogger::GetTupleRecord(LogRecordType log_record_type,
@@ -37,6 +37,13 @@ bool ReadTransactionRecordHeader(TransactionRecord &txn_record, FILE *log_file,
 bool ReadTupleRecordHeader(TupleRecord &tuple_record, FILE *log_file,
                            size_t log_file_size);
 
+// A tuple updated in place keeps its slot, so it must not be marked deleted
+static bool IsInPlaceUpdate(const ItemPointer &delete_location,
+                            const ItemPointer &insert_location) {
+  return delete_location.block == insert_location.block &&
+         delete_location.offset == insert_location.offset;
+}
+
 /**
  * @brief create NVM backed log pool
  */
@@ -191,14 +198,6 @@ void PelotonFrontendLogger::FlushLogRecords(void) {
   for (txn_id_t txn_id : not_committed_txn_list) {
     global_peloton_log_record_pool.RemoveTransactionLogList(txn_id);
   }
-
-  // Notify the backend loggers
-  {
-    std::lock_guard<std::mutex> lock(backend_logger_mutex);
-    for (auto backend_logger : backend_loggers) {
-      backend_logger->Commit();
-    }
-  }
 }
 
 size_t PelotonFrontendLogger::WriteLogRecords(
@@ -287,15 +286,18 @@ std::set<storage::TileGroupHeader *> PelotonFrontendLogger::ToggleCommitMarks(
         } break;
 
         case LOGRECORD_TYPE_PELOTON_TUPLE_UPDATE: {
-          // Set delete commit mark
           auto delete_location = record->GetDeleteLocation();
-          auto info = SetDeleteCommitMark(delete_location);
-          current_commit_id = info.first;
-          tile_group_headers.insert(info.second);
+          auto insert_location = record->GetInsertLocation();
+
+          // Set delete commit mark, unless the tuple was updated in place
+          if (IsInPlaceUpdate(delete_location, insert_location) == false) {
+            auto info = SetDeleteCommitMark(delete_location);
+            current_commit_id = info.first;
+            tile_group_headers.insert(info.second);
+          }
 
           // Set insert commit mark
-          auto insert_location = record->GetInsertLocation();
-          info = SetInsertCommitMark(insert_location);
+          auto info = SetInsertCommitMark(insert_location);
           current_commit_id = info.first;
           tile_group_headers.insert(info.second);
         } break;
@@ -468,9 +470,11 @@ void PelotonFrontendLogger::DoRecovery() {
             ReadTupleRecordHeader(update_record, log_file, log_file_size);
 
             auto delete_location = update_record.GetDeleteLocation();
-            SetDeleteCommitMark(delete_location);
-
             auto insert_location = update_record.GetInsertLocation();
+            if (IsInPlaceUpdate(delete_location, insert_location) == false) {
+              SetDeleteCommitMark(delete_location);
+            }
+
             auto info = SetInsertCommitMark(insert_location);
             current_commit_id = info.first;
           } break;
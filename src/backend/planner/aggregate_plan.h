@@ -77,6 +77,10 @@ class AggregatePlan : public AbstractPlan {
 
   PelotonAggType GetAggregateStrategy() const { return agg_strategy_; }
 
+  size_t GetMemoryBudget() const { return memory_budget_; }
+
+  void SetMemoryBudget(size_t memory_budget) { memory_budget_ = memory_budget; }
+
   inline PlanNodeType GetPlanNodeType() const {
     return PlanNodeType::PLAN_NODE_TYPE_AGGREGATE_V2;
   }
@@ -114,6 +118,9 @@ class AggregatePlan : public AbstractPlan {
 
   /** @brief Columns involved */
   std::vector<oid_t> column_ids_;
+
+  /** @brief Memory the groups of a hash aggregation may use, in bytes */
+  size_t memory_budget_ = DEFAULT_AGGREGATE_MEMORY_BUDGET;
 };
 }
 }
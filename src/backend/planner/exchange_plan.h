@@ -0,0 +1,54 @@
+//===----------------------------------------------------------------------===//
+//
+//                         PelotonDB
+//
+// exchange_plan.h
+//
+// Identification: src/backend/planner/exchange_plan.h
+//
+// Copyright (c) 2015, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <string>
+
+#include "abstract_plan.h"
+#include "backend/common/types.h"
+
+namespace peloton {
+namespace planner {
+
+/**
+ * @brief Exchange plan node.
+ *
+ * The pipeline below the exchange is run by a number of workers at once,
+ * every worker with its own copy of the executors. The sequential scans of
+ * the pipeline hand out the tile groups of their table to the workers one
+ * at a time, so every tuple is read by one worker. The pipeline must have a
+ * single leaf, a sequential scan, and the order of its output is lost.
+ */
+class ExchangePlan : public AbstractPlan {
+ public:
+  ExchangePlan(const ExchangePlan &) = delete;
+  ExchangePlan &operator=(const ExchangePlan &) = delete;
+  ExchangePlan(ExchangePlan &&) = delete;
+  ExchangePlan &operator=(ExchangePlan &&) = delete;
+
+  explicit ExchangePlan(size_t worker_count) : worker_count_(worker_count) {}
+
+  inline size_t GetWorkerCount() const { return worker_count_; }
+
+  inline PlanNodeType GetPlanNodeType() const {
+    return PLAN_NODE_TYPE_EXCHANGE;
+  }
+
+  const std::string GetInfo() const { return "Exchange"; }
+
+ private:
+  const size_t worker_count_;
+};
+
+}  // namespace planner
+}  // namespace peloton
@@ -31,10 +31,19 @@ class HashJoinPlan : public AbstractJoinPlan {
   HashJoinPlan(HashJoinPlan &&) = delete;
   HashJoinPlan &operator=(HashJoinPlan &&) = delete;
 
+  typedef const expression::AbstractExpression HashKeyType;
+  typedef std::unique_ptr<HashKeyType> HashKeyPtrType;
+
+  /**
+   * The outer hash keys are compared with the hash keys of the inner hash
+   * plan, in the same order.
+   */
   HashJoinPlan(PelotonJoinType join_type,
                const expression::AbstractExpression *predicate,
-               const ProjectInfo *proj_info)
-      : AbstractJoinPlan(join_type, predicate, proj_info) {}
+               const ProjectInfo *proj_info,
+               std::vector<HashKeyPtrType> &outer_hash_keys)
+      : AbstractJoinPlan(join_type, predicate, proj_info),
+        outer_hash_keys_(std::move(outer_hash_keys)) {}
 
   inline PlanNodeType GetPlanNodeType() const {
     return PLAN_NODE_TYPE_HASHJOIN;
@@ -42,7 +51,12 @@ class HashJoinPlan : public AbstractJoinPlan {
 
   const std::string GetInfo() const { return "HashJoin"; }
 
+  inline const std::vector<HashKeyPtrType> &GetOuterHashKeys() const {
+    return this->outer_hash_keys_;
+  }
+
  private:
+  std::vector<HashKeyPtrType> outer_hash_keys_;
 };
 
 }  // namespace planner
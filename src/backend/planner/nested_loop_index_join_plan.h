@@ -0,0 +1,94 @@
+//===----------------------------------------------------------------------===//
+//
+//                         PelotonDB
+//
+// nested_loop_index_join_plan.h
+//
+// Identification: src/backend/planner/nested_loop_index_join_plan.h
+//
+// Copyright (c) 2015, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "abstract_join_plan.h"
+#include "backend/common/types.h"
+#include "backend/expression/abstract_expression.h"
+#include "backend/planner/project_info.h"
+
+namespace peloton {
+
+namespace index {
+class Index;
+}
+
+namespace storage {
+class DataTable;
+}
+
+namespace planner {
+
+/**
+ * Join that looks up the rows of the outer child in an index of the inner
+ * table. The outer key columns give the value of every key column of the
+ * index, the join predicate is checked on the pairs found.
+ */
+class NestedLoopIndexJoinPlan : public AbstractJoinPlan {
+ public:
+  NestedLoopIndexJoinPlan(const NestedLoopIndexJoinPlan &) = delete;
+  NestedLoopIndexJoinPlan &operator=(const NestedLoopIndexJoinPlan &) = delete;
+  NestedLoopIndexJoinPlan(NestedLoopIndexJoinPlan &&) = delete;
+  NestedLoopIndexJoinPlan &operator=(NestedLoopIndexJoinPlan &&) = delete;
+
+  NestedLoopIndexJoinPlan(PelotonJoinType join_type,
+                          const expression::AbstractExpression *predicate,
+                          const ProjectInfo *proj_info,
+                          storage::DataTable *inner_table,
+                          index::Index *inner_index,
+                          const std::vector<oid_t> &outer_key_column_ids,
+                          const std::vector<oid_t> &inner_column_ids)
+      : AbstractJoinPlan(join_type, predicate, proj_info),
+        inner_table_(inner_table),
+        inner_index_(inner_index),
+        outer_key_column_ids_(outer_key_column_ids),
+        inner_column_ids_(inner_column_ids) {}
+
+  inline PlanNodeType GetPlanNodeType() const {
+    return PLAN_NODE_TYPE_NESTLOOPINDEX;
+  }
+
+  storage::DataTable *GetInnerTable() const { return inner_table_; }
+
+  index::Index *GetInnerIndex() const { return inner_index_; }
+
+  const std::vector<oid_t> &GetOuterKeyColumnIds() const {
+    return outer_key_column_ids_;
+  }
+
+  const std::vector<oid_t> &GetInnerColumnIds() const {
+    return inner_column_ids_;
+  }
+
+  const std::string GetInfo() const { return "NestedLoopIndexJoin"; }
+
+ private:
+  /** @brief Table looked up for every outer row */
+  storage::DataTable *inner_table_;
+
+  /** @brief Index of the inner table */
+  index::Index *inner_index_;
+
+  /** @brief Outer columns with the values of the index key columns */
+  const std::vector<oid_t> outer_key_column_ids_;
+
+  /** @brief Inner columns of the output */
+  const std::vector<oid_t> inner_column_ids_;
+};
+
+}  // namespace planner
+}  // namespace peloton
@@ -49,6 +49,10 @@ class OrderByPlan : public AbstractPlan {
     return output_column_ids_;
   }
 
+  size_t GetMemoryBudget() const { return memory_budget_; }
+
+  void SetMemoryBudget(size_t memory_budget) { memory_budget_ = memory_budget; }
+
   inline PlanNodeType GetPlanNodeType() const { return PLAN_NODE_TYPE_ORDERBY; }
 
   const std::string GetInfo() const { return "OrderBy"; }
@@ -67,6 +71,10 @@ class OrderByPlan : public AbstractPlan {
    * Now we just output the same schema as input tiles.
    */
   const std::vector<oid_t> output_column_ids_;
+
+  /** @brief Memory the sort may use before it spills sorted runs to disk,
+   * in bytes. */
+  size_t memory_budget_ = DEFAULT_SORT_MEMORY_BUDGET;
 };
 }
 }
@@ -10,6 +10,8 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include <algorithm>
+#include <atomic>
 #include <mutex>
 #include <utility>
 
@@ -18,6 +20,8 @@
 #include "backend/storage/database.h"
 #include "backend/common/exception.h"
 #include "backend/common/logger.h"
+#include "backend/common/thread_manager.h"
+#include "backend/expression/container_tuple.h"
 #include "backend/index/index.h"
 #include "backend/benchmark/hyadapt/configuration.h"
 #include "backend/storage/tile_group.h"
@@ -41,9 +45,6 @@ bool peloton_fsm;
 namespace peloton {
 namespace storage {
 
-bool ContainsVisibleEntry(std::vector<ItemPointer> &locations,
-                          const concurrency::Transaction *transaction);
-
 DataTable::DataTable(catalog::Schema *schema, std::string table_name,
                      oid_t database_oid, oid_t table_oid,
                      size_t tuples_per_tilegroup, bool own_schema,
@@ -83,31 +84,6 @@ DataTable::~DataTable() {
   // AbstractTable cleans up the schema
 }
 
-/**
- * Check if the locations contains at least one visible entry to the transaction
- */
-bool ContainsVisibleEntry(std::vector<ItemPointer> &locations,
-                          const concurrency::Transaction *transaction) {
-  auto &manager = catalog::Manager::GetInstance();
-
-  for (auto loc : locations) {
-    oid_t tile_group_id = loc.block;
-    oid_t tuple_offset = loc.offset;
-
-    auto tile_group = manager.GetTileGroup(tile_group_id);
-    auto header = tile_group->GetHeader();
-
-    auto transaction_id = transaction->GetTransactionId();
-    auto last_commit_id = transaction->GetLastCommitId();
-    bool visible =
-        header->IsVisible(tuple_offset, transaction_id, last_commit_id);
-
-    if (visible) return true;
-  }
-
-  return false;
-}
-
 //===--------------------------------------------------------------------===//
 // TUPLE HELPER OPERATIONS
 //===--------------------------------------------------------------------===//
@@ -215,9 +191,8 @@ ItemPointer DataTable::InsertTuple(const concurrency::Transaction *transaction,
 
 /**
  * @brief Insert a tuple into all indexes. If index is primary/unique,
- * check visibility of existing
- * index entries.
- * @warning This still doesn't guarantee serializability.
+ * check visibility of existing index entries and insert in one step
+ * under the index latch.
  *
  * @returns True on success, false if a visible entry exists (in case of
  *primary/unique).
@@ -226,9 +201,10 @@ bool DataTable::InsertInIndexes(const concurrency::Transaction *transaction,
                                 const storage::Tuple *tuple,
                                 ItemPointer location) {
   int index_count = GetIndexCount();
+  std::vector<std::unique_ptr<storage::Tuple>> keys;
+  std::vector<std::pair<index::Index *, std::unique_ptr<storage::Tuple>>>
+      build_keys;
 
-  // (A) Check existence for primary/unique indexes
-  // FIXME Since this is NOT protected by a lock, concurrent insert may happen.
   for (int index_itr = index_count - 1; index_itr >= 0; --index_itr) {
     auto index = GetIndex(index_itr);
     auto index_schema = index->GetKeySchema();
@@ -236,40 +212,256 @@ bool DataTable::InsertInIndexes(const concurrency::Transaction *transaction,
     std::unique_ptr<storage::Tuple> key(new storage::Tuple(index_schema, true));
     key->SetFromTuple(tuple, indexed_columns, index->GetPool());
 
+    // Leave the entry to the index build, once the tuple is inserted
+    if (index->IsBuilding() == true) {
+      build_keys.emplace_back(index, std::move(key));
+      keys.emplace_back(nullptr);
+      continue;
+    }
+
+    // Conflict if the version of an existing tuple visible to the
+    // transaction still has the key
+    auto is_visible = [&](const ItemPointer &entry) -> bool {
+      return IsVisibleWithKey(transaction, entry, index, key.get());
+    };
+
     switch (index->GetIndexType()) {
       case INDEX_CONSTRAINT_TYPE_PRIMARY_KEY:
       case INDEX_CONSTRAINT_TYPE_UNIQUE: {
-        auto locations = index->ScanKey(key.get());
-        auto exist_visible = ContainsVisibleEntry(locations, transaction);
-        if (exist_visible) {
+        auto status =
+            index->ConditionalInsertEntry(key.get(), location, is_visible);
+        if (status == false) {
           LOG_WARN("A visible index entry exists.");
+
+          // Undo the entries added to the preceding indexes
+          for (oid_t key_itr = 0; key_itr < keys.size(); key_itr++) {
+            if (keys[key_itr] == nullptr) continue;
+            auto inserted_index = GetIndex(index_count - 1 - key_itr);
+            inserted_index->DeleteEntry(keys[key_itr].get(), location);
+          }
+
           return false;
         }
+        LOG_INFO("Index constraint check on %s passed.",
+                 index->GetName().c_str());
       } break;
 
       case INDEX_CONSTRAINT_TYPE_DEFAULT:
-      default:
-        break;
+      default: {
+        auto status = index->InsertEntry(key.get(), location);
+        (void)status;
+        assert(status);
+      } break;
     }
-    LOG_INFO("Index constraint check on %s passed.", index->GetName().c_str());
+
+    keys.push_back(std::move(key));
   }
 
-  // (B) Insert into index
-  for (int index_itr = index_count - 1; index_itr >= 0; --index_itr) {
-    auto index = GetIndex(index_itr);
+  for (auto &build_key : build_keys) {
+    build_key.first->InsertBuildEntry(build_key.second.get(), location);
+  }
+
+  return true;
+}
+
+/**
+ * @brief Add the new keys of a tuple updated in place to the indexes.
+ * The tuple keeps its location, so only the indexes on the updated columns
+ * are touched, and only if the key differs from the one it replaced. The
+ * entries of the older keys are kept for the older versions of the tuple
+ * until no snapshot can see them (see TileGroup::ReclaimDeltas), so a key
+ * that goes back to an older one may already have an entry, but it is still
+ * checked against the other tuples with that key.
+ *
+ * @returns True on success, false if a visible entry exists (in case of
+ *primary/unique).
+ */
+bool DataTable::UpdateInIndexes(const concurrency::Transaction *transaction,
+                                ItemPointer location,
+                                const std::vector<oid_t> &column_ids,
+                                const std::vector<Value> &old_values) {
+  assert(old_values.size() == column_ids.size());
+
+  std::vector<std::pair<index::Index *, std::unique_ptr<storage::Tuple>>> keys;
+  std::vector<std::pair<index::Index *, std::unique_ptr<storage::Tuple>>>
+      build_keys;
+
+  auto tile_group = GetTileGroupById(location.block);
+  expression::ContainerTuple<storage::TileGroup> tuple(tile_group.get(),
+                                                       location.offset);
+
+  for (auto index : indexes) {
     auto index_schema = index->GetKeySchema();
     auto indexed_columns = index_schema->GetIndexedColumns();
+
+    // Skip the indexes whose key is the same as before the update
+    bool key_updated = false;
+    for (oid_t column_itr = 0; column_itr < column_ids.size(); column_itr++) {
+      auto column_id = column_ids[column_itr];
+      if (std::find(indexed_columns.begin(), indexed_columns.end(),
+                    column_id) != indexed_columns.end() &&
+          old_values[column_itr].Compare(tuple.GetValue(column_id)) !=
+              VALUE_COMPARE_EQUAL) {
+        key_updated = true;
+        break;
+      }
+    }
+    if (key_updated == false) continue;
+
     std::unique_ptr<storage::Tuple> key(new storage::Tuple(index_schema, true));
-    key->SetFromTuple(tuple, indexed_columns, index->GetPool());
+    for (oid_t key_column_itr = 0; key_column_itr < indexed_columns.size();
+         key_column_itr++) {
+      key->SetValue(key_column_itr,
+                    tuple.GetValue(indexed_columns[key_column_itr]),
+                    index->GetPool());
+    }
+
+    // Leave the entry to the index build, once the tuple is updated
+    if (index->IsBuilding() == true) {
+      build_keys.emplace_back(index, std::move(key));
+      continue;
+    }
+
+    auto is_unique = (index->GetIndexType() ==
+                          INDEX_CONSTRAINT_TYPE_PRIMARY_KEY ||
+                      index->GetIndexType() == INDEX_CONSTRAINT_TYPE_UNIQUE);
+    auto is_visible = [&](const ItemPointer &entry) -> bool {
+      return IsVisibleWithKey(transaction, entry, index, key.get());
+    };
+
+    // The key went back to an older key of the tuple, whose entry is kept
+    auto entries = index->ScanKey(key.get());
+    bool has_entry = false;
+    for (auto &entry : entries) {
+      if (entry.block == location.block && entry.offset == location.offset) {
+        has_entry = true;
+        break;
+      }
+    }
+
+    bool status = true;
+    if (has_entry == true) {
+      // No entry to add, but another visible tuple may have the key by now
+      if (is_unique == false) continue;
+
+      for (auto &entry : entries) {
+        if ((entry.block != location.block ||
+             entry.offset != location.offset) &&
+            is_visible(entry)) {
+          status = false;
+          break;
+        }
+      }
+
+      if (status == true) continue;
+    } else if (is_unique == true) {
+      status = index->ConditionalInsertEntry(key.get(), location, is_visible);
+    } else {
+      status = index->InsertEntry(key.get(), location);
+    }
+
+    if (status == false) {
+      LOG_WARN("A visible index entry exists.");
+
+      // Undo the entries added to the preceding indexes
+      for (auto &inserted_key : keys) {
+        inserted_key.first->DeleteEntry(inserted_key.second.get(), location);
+      }
 
-    auto status = index->InsertEntry(key.get(), location);
-    (void)status;
-    assert(status);
+      return false;
+    }
+
+    keys.emplace_back(index, std::move(key));
+  }
+
+  for (auto &build_key : build_keys) {
+    build_key.first->InsertBuildEntry(build_key.second.get(), location);
   }
 
   return true;
 }
 
+/**
+ * @brief Delete the index entries of versions of a tuple updated in place
+ * that no transaction will read anymore, the versions of a rolled back update
+ * or older versions no snapshot can see. A key that one of the kept versions
+ * of the tuple still has keeps its entry.
+ * Only called by the holder of the latch of the slot, so no update of the
+ * tuple adds an entry meanwhile.
+ */
+void DataTable::DeleteInIndexes(
+    ItemPointer location, const std::vector<const storage::Tuple *> &dropped,
+    const std::vector<const storage::Tuple *> &kept) {
+  for (auto index : indexes) {
+    // The entries of an index being built are left to the build
+    if (index->IsBuilding() == true) continue;
+
+    auto index_schema = index->GetKeySchema();
+    auto indexed_columns = index_schema->GetIndexedColumns();
+
+    std::vector<std::unique_ptr<storage::Tuple>> keys;
+    for (auto version : kept) {
+      keys.emplace_back(new storage::Tuple(index_schema, true));
+      keys.back()->SetFromTuple(version, indexed_columns, index->GetPool());
+    }
+
+    for (auto version : dropped) {
+      std::unique_ptr<storage::Tuple> key(
+          new storage::Tuple(index_schema, true));
+      key->SetFromTuple(version, indexed_columns, index->GetPool());
+
+      // Kept, or deleted already
+      bool has_key = false;
+      for (auto &other_key : keys) {
+        if (key->EqualsNoSchemaCheck(*other_key)) {
+          has_key = true;
+          break;
+        }
+      }
+      if (has_key == true) continue;
+
+      index->DeleteEntry(key.get(), location);
+      keys.push_back(std::move(key));
+    }
+  }
+}
+
+/**
+ * @brief Check if the version of a tuple visible to the transaction has the
+ * given key. A tuple updated in place keeps the index entries of its older
+ * keys, so an index entry alone doesn't mean that the tuple has the key.
+ */
+bool DataTable::IsVisibleWithKey(const concurrency::Transaction *transaction,
+                                 const ItemPointer &location,
+                                 const index::Index *index,
+                                 const storage::Tuple *key) const {
+  auto &manager = catalog::Manager::GetInstance();
+  auto tile_group = manager.GetTileGroup(location.block);
+  auto transaction_id = transaction->GetTransactionId();
+  auto last_commit_id = transaction->GetLastCommitId();
+  auto indexed_columns = index->GetKeySchema()->GetIndexedColumns();
+
+  auto has_key = [&](const AbstractTuple &tuple) -> bool {
+    for (oid_t key_column_itr = 0; key_column_itr < indexed_columns.size();
+         key_column_itr++) {
+      if (key->GetValue(key_column_itr)
+              .Compare(tuple.GetValue(indexed_columns[key_column_itr])) !=
+          VALUE_COMPARE_EQUAL)
+        return false;
+    }
+    return true;
+  };
+
+  // Either the version in the slot or an older version is visible
+  storage::Tuple tuple(schema, true);
+  if (tile_group->CopyVisibleVersion(location.offset, transaction_id,
+                                     last_commit_id, &tuple)) {
+    return has_key(tuple);
+  }
+
+  return false;
+}
+
 //===--------------------------------------------------------------------===//
 // DELETE
 //===--------------------------------------------------------------------===//
@@ -309,6 +501,65 @@ bool DataTable::DeleteTuple(const concurrency::Transaction *transaction,
   return true;
 }
 
+//===--------------------------------------------------------------------===//
+// UPDATE
+//===--------------------------------------------------------------------===//
+
+/**
+ * @brief Try to update the given columns of a tuple in place.
+ * It may fail because the tuple has been latched, conflict with a future
+ *delete, or the new key is taken in a primary/unique index. The tuple is
+ *modified before the indexes are checked, so the caller has to record the
+ *update in the transaction even if it fails.
+ *
+ * @param transaction   The current transaction.
+ * @param location      ItemPointer of the tuple to update.
+ * @param column_ids    Offsets of the updated columns.
+ * @param values        New values of the updated columns.
+ * @return True on success, false on failure.
+ */
+bool DataTable::UpdateTuple(const concurrency::Transaction *transaction,
+                            ItemPointer location,
+                            const std::vector<oid_t> &column_ids,
+                            const std::vector<Value> &values) {
+  // First, check NULL constraints
+  for (oid_t column_itr = 0; column_itr < column_ids.size(); column_itr++) {
+    if (values[column_itr].IsNull() &&
+        schema->AllowNull(column_ids[column_itr]) == false) {
+      throw ConstraintException("Not NULL constraint violated : column " +
+                                std::to_string(column_ids[column_itr]));
+    }
+  }
+
+  auto tile_group = GetTileGroupById(location.block);
+  txn_id_t transaction_id = transaction->GetTransactionId();
+  cid_t last_cid = transaction->GetLastCommitId();
+
+  // Update slot in underlying tile group
+  std::vector<Value> old_values;
+  auto status = tile_group->UpdateTuple(transaction_id, location.offset,
+                                        last_cid, column_ids, values,
+                                        &old_values);
+  if (status == false) {
+    LOG_WARN("Failed to update tuple in the tile group : %lu , Txn_id : %lu ",
+             location.block, transaction_id);
+    return false;
+  }
+
+  // Index checks and updates
+  if (HasIndexOnColumns(column_ids) &&
+      UpdateInIndexes(transaction, location, column_ids, old_values) ==
+          false) {
+    LOG_WARN("Index constraint violated");
+    return false;
+  }
+
+  LOG_TRACE("Updated location :: block = %lu offset = %lu ", location.block,
+            location.offset);
+
+  return true;
+}
+
 //===--------------------------------------------------------------------===//
 // STATS
 //===--------------------------------------------------------------------===//
@@ -574,19 +825,140 @@ const std::string DataTable::GetInfo() const {
 // INDEX
 //===--------------------------------------------------------------------===//
 
-void DataTable::AddIndex(index::Index *index) {
+bool DataTable::AddIndex(index::Index *index) {
+  // Writers leave their entries to the build from now on
+  index->StartBuild();
+
   {
     std::lock_guard<std::mutex> lock(table_mutex);
     indexes.push_back(index);
   }
 
-  // Update index stats
+  BuildIndex(index);
+  index->FinishBuild();
+
+  // Neither the build nor the writers it buffered checked the keys
   auto index_type = index->GetIndexType();
+  if ((index_type == INDEX_CONSTRAINT_TYPE_PRIMARY_KEY ||
+       index_type == INDEX_CONSTRAINT_TYPE_UNIQUE) &&
+      CheckUniqueKeys(index) == false) {
+    LOG_WARN("Duplicate keys in the table, dropping index %s.",
+             index->GetName().c_str());
+    DropIndexWithOid(index->GetOid());
+    return false;
+  }
+
+  // Update index stats
   if (index_type == INDEX_CONSTRAINT_TYPE_PRIMARY_KEY) {
     has_primary_key = true;
   } else if (index_type == INDEX_CONSTRAINT_TYPE_UNIQUE) {
     unique_constraint_count++;
   }
+
+  return true;
+}
+
+/**
+ * @brief Add the entries of all tuples in the table to a new index, scanning
+ * the tile groups in parallel. Every slot with a tuple is indexed, the
+ * visibility checks filter the entries of tuples not visible to a
+ * transaction. The tile groups added meanwhile only hold tuples inserted
+ * after the build has started, which are left to the writers.
+ */
+void DataTable::BuildIndex(index::Index *index) {
+  size_t tile_group_count = GetTileGroupCount();
+
+  index->BulkLoad(tile_group_count, [&](
+      size_t tile_group_offset,
+      const index::Index::BuildEntryFunction &add_entry) {
+    auto tile_group = GetTileGroup(tile_group_offset);
+    auto tile_group_header = tile_group->GetHeader();
+    auto tile_group_id = tile_group->GetTileGroupId();
+    oid_t tuple_count = tile_group->GetNextTupleSlot();
+
+    for (oid_t tuple_id = 0; tuple_id < tuple_count; tuple_id++) {
+      if (tile_group_header->GetTransactionId(tuple_id) == INVALID_TXN_ID) {
+        continue;
+      }
+
+      expression::ContainerTuple<storage::TileGroup> tuple(tile_group.get(),
+                                                           tuple_id);
+      add_entry(tuple, ItemPointer(tile_group_id, tuple_id));
+    }
+  });
+}
+
+/**
+ * @brief Check that no two tuples of the table have the same key in a new
+ * unique index. The latest version of every live tuple counts, whether its
+ * transaction has committed or not, so that the writers whose entries were
+ * buffered by the build cannot commit a duplicate after the check. A
+ * transaction that is still running may abort later, the check fails
+ * conservatively then.
+ *
+ * @returns True if every key is held by one tuple at most.
+ */
+bool DataTable::CheckUniqueKeys(index::Index *index) {
+  auto key_schema = index->GetKeySchema();
+  auto indexed_columns = key_schema->GetIndexedColumns();
+  auto &manager = catalog::Manager::GetInstance();
+  std::atomic<bool> unique(true);
+
+  auto is_live = [](TileGroupHeader *tile_group_header, oid_t tuple_id) {
+    return tile_group_header->GetTransactionId(tuple_id) != INVALID_TXN_ID &&
+           tile_group_header->GetEndCommitId(tuple_id) == MAX_CID;
+  };
+
+  ThreadManager::RunInParallel(GetTileGroupCount(), [&](
+      size_t tile_group_offset) {
+    auto tile_group = GetTileGroup(tile_group_offset);
+    auto tile_group_header = tile_group->GetHeader();
+    auto tile_group_id = tile_group->GetTileGroupId();
+    oid_t tuple_count = tile_group->GetNextTupleSlot();
+    storage::Tuple key(key_schema, true);
+
+    for (oid_t tuple_id = 0; tuple_id < tuple_count && unique; tuple_id++) {
+      if (is_live(tile_group_header, tuple_id) == false) continue;
+
+      expression::ContainerTuple<storage::TileGroup> tuple(tile_group.get(),
+                                                           tuple_id);
+      for (oid_t key_column_itr = 0; key_column_itr < indexed_columns.size();
+           key_column_itr++) {
+        key.SetValue(key_column_itr,
+                     tuple.GetValue(indexed_columns[key_column_itr]),
+                     index->GetPool());
+      }
+
+      // Any other live tuple under the key that still has it
+      for (auto &location : index->ScanKey(&key)) {
+        if (location.block == tile_group_id && location.offset == tuple_id)
+          continue;
+
+        auto other_tile_group = manager.GetTileGroup(location.block);
+        if (is_live(other_tile_group->GetHeader(), location.offset) == false)
+          continue;
+
+        expression::ContainerTuple<storage::TileGroup> other_tuple(
+            other_tile_group.get(), location.offset);
+        bool has_key = true;
+        for (oid_t key_column_itr = 0;
+             key_column_itr < indexed_columns.size() && has_key;
+             key_column_itr++) {
+          has_key = key.GetValue(key_column_itr)
+                        .Compare(other_tuple.GetValue(
+                            indexed_columns[key_column_itr])) ==
+                    VALUE_COMPARE_EQUAL;
+        }
+
+        if (has_key == true) {
+          unique = false;
+          break;
+        }
+      }
+    }
+  });
+
+  return unique;
 }
 
 index::Index *DataTable::GetIndexWithOid(const oid_t index_oid) const {
@@ -620,6 +992,19 @@ index::Index *DataTable::GetIndex(const oid_t index_offset) const {
 
 oid_t DataTable::GetIndexCount() const { return indexes.size(); }
 
+bool DataTable::HasIndexOnColumns(const std::vector<oid_t> &column_ids) const {
+  for (auto index : indexes) {
+    auto indexed_columns = index->GetKeySchema()->GetIndexedColumns();
+    for (auto column_id : column_ids) {
+      if (std::find(indexed_columns.begin(), indexed_columns.end(),
+                    column_id) != indexed_columns.end())
+        return true;
+    }
+  }
+
+  return false;
+}
+
 //===--------------------------------------------------------------------===//
 // FOREIGN KEYS
 //===--------------------------------------------------------------------===//
@@ -729,6 +1114,9 @@ void SetTransformedTileGroup(storage::TileGroup *orig_tile_group,
   auto header = orig_tile_group->GetHeader();
   auto new_header = new_tile_group->GetHeader();
   *new_header = *header;
+
+  // and share the version chains of the tuples
+  new_tile_group->SetDeltaStore(orig_tile_group->GetDeltaStore());
 }
 
 storage::TileGroup *DataTable::TransformTileGroup(oid_t tile_group_offset,
@@ -102,6 +102,12 @@ class DataTable : public AbstractTable {
   bool DeleteTuple(const concurrency::Transaction *transaction,
                    ItemPointer location);
 
+  // update the given columns of the tuple at given location in place,
+  // the tuple keeps its location in the indexes
+  bool UpdateTuple(const concurrency::Transaction *transaction,
+                   ItemPointer location, const std::vector<oid_t> &column_ids,
+                   const std::vector<Value> &values);
+
   //===--------------------------------------------------------------------===//
   // TILE GROUP
   //===--------------------------------------------------------------------===//
@@ -129,7 +135,9 @@ class DataTable : public AbstractTable {
   // INDEX
   //===--------------------------------------------------------------------===//
 
-  void AddIndex(index::Index *index);
+  // add an index and build it from the tuples in the table. Fails and drops
+  // the index again if a unique index finds duplicate keys.
+  bool AddIndex(index::Index *index);
 
   index::Index *GetIndexWithOid(const oid_t index_oid) const;
 
@@ -139,6 +147,9 @@ class DataTable : public AbstractTable {
 
   oid_t GetIndexCount() const;
 
+  // check if some index is built on any of the given columns
+  bool HasIndexOnColumns(const std::vector<oid_t> &column_ids) const;
+
   //===--------------------------------------------------------------------===//
   // FOREIGN KEYS
   //===--------------------------------------------------------------------===//
@@ -228,8 +239,28 @@ class DataTable : public AbstractTable {
   bool InsertInIndexes(const concurrency::Transaction *transaction,
                        const storage::Tuple *tuple, ItemPointer location);
 
-  /** @return True if it's a same-key update and it's successful */
-  bool UpdateInIndexes(const storage::Tuple *tuple, ItemPointer location);
+  // try to insert the new keys of a tuple updated in place into the indices
+  bool UpdateInIndexes(const concurrency::Transaction *transaction,
+                       ItemPointer location,
+                       const std::vector<oid_t> &column_ids,
+                       const std::vector<Value> &old_values);
+
+  // delete the entries of the dropped versions of a tuple updated in place
+  // whose keys none of the kept versions has
+  void DeleteInIndexes(ItemPointer location,
+                       const std::vector<const storage::Tuple *> &dropped,
+                       const std::vector<const storage::Tuple *> &kept);
+
+  // add the entries of the tuples in the table to a new index
+  void BuildIndex(index::Index *index);
+
+  // check that no two live tuples have the same key in a unique index
+  bool CheckUniqueKeys(index::Index *index);
+
+  // check if the visible version of the tuple at given location has the key
+  bool IsVisibleWithKey(const concurrency::Transaction *transaction,
+                        const ItemPointer &location, const index::Index *index,
+                        const storage::Tuple *key) const;
 
  private:
   //===--------------------------------------------------------------------===//
@@ -0,0 +1,153 @@
+//===----------------------------------------------------------------------===//
+//
+//                         PelotonDB
+//
+// delta_store.h
+//
+// Identification: src/backend/storage/delta_store.h
+//
+// Copyright (c) 2015, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <algorithm>
+#include <cassert>
+#include <deque>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+#include "backend/common/types.h"
+#include "backend/common/value.h"
+
+namespace peloton {
+namespace storage {
+
+//===--------------------------------------------------------------------===//
+// Tuple Delta
+//===--------------------------------------------------------------------===//
+
+/**
+ * Before-image of the columns changed by an in-place update.
+ *
+ * The newest version of a tuple always stays in its tuple slot. Every in-place
+ * update pushes a delta with the old values of the columns it overwrites, and
+ * the deltas form a newest-to-oldest chain through the prev item pointer of
+ * the tile group header. The version restored by a delta is valid in
+ * [begin_cid, end_cid), like a tuple slot.
+ */
+struct TupleDelta {
+  // owner of the delta until the update commits
+  txn_id_t txn_id;
+
+  // visibility range of the version restored by this delta
+  cid_t begin_cid;
+  cid_t end_cid;
+
+  // next older delta of the same tuple
+  ItemPointer prev;
+
+  // < column offset, old value >
+  std::vector<std::pair<oid_t, Value>> columns;
+};
+
+//===--------------------------------------------------------------------===//
+// Delta Store
+//===--------------------------------------------------------------------===//
+
+/**
+ * Store of the tuple deltas of a tile group.
+ *
+ * Deltas are addressed by their offset and keep a stable address until the
+ * tile group is dropped. The offsets of deltas unlinked by the garbage
+ * collection are reused for new deltas.
+ */
+class DeltaStore {
+  DeltaStore(DeltaStore const &) = delete;
+
+ public:
+  DeltaStore() {}
+
+  // add a delta and return its offset
+  oid_t AddDelta(TupleDelta &&delta) {
+    std::lock_guard<std::mutex> lock(delta_store_mutex);
+
+    if (free_offsets.empty() == false) {
+      oid_t delta_offset = free_offsets.back();
+      free_offsets.pop_back();
+      deltas[delta_offset] = std::move(delta);
+      return delta_offset;
+    }
+
+    deltas.push_back(std::move(delta));
+    return deltas.size() - 1;
+  }
+
+  // release the old values of a delta that no transaction can reach anymore
+  // and reuse its offset
+  void FreeDelta(const oid_t delta_offset) {
+    std::lock_guard<std::mutex> lock(delta_store_mutex);
+
+    assert(delta_offset < deltas.size());
+    std::vector<std::pair<oid_t, Value>>().swap(deltas[delta_offset].columns);
+    free_offsets.push_back(delta_offset);
+  }
+
+  // get the delta at the given offset
+  TupleDelta *GetDelta(const oid_t delta_offset) {
+    std::lock_guard<std::mutex> lock(delta_store_mutex);
+
+    assert(delta_offset < deltas.size());
+    return &deltas[delta_offset];
+  }
+
+  // free the delta once every transaction running when it was unlinked has
+  // finished, i.e. once the oldest snapshot is newer than the given one
+  void RetireDelta(const oid_t delta_offset, cid_t last_cid) {
+    std::lock_guard<std::mutex> lock(delta_store_mutex);
+
+    retired_deltas.emplace_back(last_cid, delta_offset);
+  }
+
+  // free the retired deltas no running transaction can hold
+  void FreeRetiredDeltas(cid_t oldest_snapshot) {
+    std::vector<oid_t> delta_offsets;
+
+    {
+      std::lock_guard<std::mutex> lock(delta_store_mutex);
+      auto retired_itr = std::partition(
+          retired_deltas.begin(), retired_deltas.end(),
+          [&](const std::pair<cid_t, oid_t> &retired_delta) {
+            return retired_delta.first >= oldest_snapshot;
+          });
+      for (auto itr = retired_itr; itr != retired_deltas.end(); ++itr)
+        delta_offsets.push_back(itr->second);
+      retired_deltas.erase(retired_itr, retired_deltas.end());
+    }
+
+    for (auto delta_offset : delta_offsets) FreeDelta(delta_offset);
+  }
+
+  // number of deltas in use
+  size_t GetDeltaCount() {
+    std::lock_guard<std::mutex> lock(delta_store_mutex);
+    return deltas.size() - free_offsets.size();
+  }
+
+ private:
+  // deltas never move once added
+  std::deque<TupleDelta> deltas;
+
+  // offsets of the freed deltas
+  std::vector<oid_t> free_offsets;
+
+  // < last commit id when unlinked, offset > of the deltas to free
+  std::vector<std::pair<cid_t, oid_t>> retired_deltas;
+
+  std::mutex delta_store_mutex;
+};
+
+}  // End storage namespace
+}  // End peloton namespace
@@ -257,11 +257,12 @@ class TileFactory {
   virtual ~TileFactory();
 
   // Creates tile that is not attached to a tile group.
-  // For use in the executor.
-  static Tile *GetTempTile(const catalog::Schema &schema, int tuple_count) {
+  // For use in the executor. A tile of copies of tuples refers to the tile
+  // group of the tuples, so that they can still be updated.
+  static Tile *GetTempTile(const catalog::Schema &schema, int tuple_count,
+                           TileGroup *tile_group = nullptr) {
     // These temporary tiles don't belong to any tile group.
     TileGroupHeader *header = nullptr;
-    TileGroup *tile_group = nullptr;
 
     Tile *tile = GetTile(BACKEND_TYPE_MM, INVALID_OID, INVALID_OID, INVALID_OID,
                          INVALID_OID, header, schema, tile_group, tuple_count);
@@ -19,6 +19,7 @@
 #include "backend/common/logger.h"
 #include "backend/common/types.h"
 #include "backend/storage/abstract_table.h"
+#include "backend/storage/data_table.h"
 #include "backend/storage/tile.h"
 #include "backend/storage/tuple.h"
 #include "backend/storage/tile_group_header.h"
@@ -38,7 +39,8 @@ TileGroup::TileGroup(BackendType backend_type,
       tile_group_header(tile_group_header),
       table(table),
       num_tuple_slots(tuple_count),
-      column_map(column_map) {
+      column_map(column_map),
+      delta_store(new DeltaStore()) {
   tile_count = tile_schemas.size();
 
   for (oid_t tile_itr = 0; tile_itr < tile_count; tile_itr++) {
@@ -138,6 +140,7 @@ oid_t TileGroup::InsertTuple(txn_id_t transaction_id, const Tuple *tuple) {
   tile_group_header->SetEndCommitId(tuple_slot_id, MAX_CID);
   tile_group_header->SetInsertCommit(tuple_slot_id, false);
   tile_group_header->SetDeleteCommit(tuple_slot_id, false);
+  tile_group_header->SetPrevItemPointer(tuple_slot_id, INVALID_ITEMPOINTER);
 
   return tuple_slot_id;
 }
@@ -196,7 +199,7 @@ oid_t TileGroup::InsertTuple(txn_id_t transaction_id, oid_t tuple_slot_id,
 bool TileGroup::DeleteTuple(txn_id_t transaction_id, oid_t tuple_slot_id,
                             cid_t last_cid) {
   // do a dirty delete
-  if (tile_group_header->LatchTupleSlot(tuple_slot_id, transaction_id)) {
+  if (tile_group_header->LatchTupleSlotOrWait(tuple_slot_id, transaction_id)) {
     if (tile_group_header->IsDeletable(tuple_slot_id, transaction_id,
                                        last_cid)) {
       return true;
@@ -224,6 +227,134 @@ bool TileGroup::DeleteTuple(txn_id_t transaction_id, oid_t tuple_slot_id,
   }
 }
 
+/**
+ * Get a value of the tuple at given slot that stays valid once the slot is
+ * overwritten. Inlined objects point into the slot, so they are copied out.
+ */
+Value TileGroup::GetValueCopy(oid_t tuple_slot_id, oid_t column_id) {
+  Value value = GetValue(tuple_slot_id, column_id);
+
+  auto value_type = value.GetValueType();
+  if ((value_type == VALUE_TYPE_VARCHAR ||
+       value_type == VALUE_TYPE_VARBINARY) &&
+      value.GetSourceInlined()) {
+    value.AllocateObjectFromInlinedValue(nullptr);
+    value.SetCleanUp(true);
+  }
+
+  return value;
+}
+
+/**
+ * Update the given columns of the tuple at given slot in place.
+ *
+ * The slot always holds the newest version. The old values of the updated
+ * columns are saved as a delta at the head of the version chain of the slot,
+ * and the slot is hidden from other transactions until the update commits.
+ * An own insert is overwritten directly as nobody else can see it.
+ */
+bool TileGroup::UpdateTuple(txn_id_t transaction_id, oid_t tuple_slot_id,
+                            cid_t last_cid,
+                            const std::vector<oid_t> &column_ids,
+                            const std::vector<Value> &values,
+                            std::vector<Value> *old_values) {
+  assert(column_ids.size() == values.size());
+  cid_t begin_cid = MAX_CID;
+
+  if (tile_group_header->LatchTupleSlotOrWait(tuple_slot_id, transaction_id)) {
+    if (tile_group_header->IsDeletable(tuple_slot_id, transaction_id,
+                                       last_cid) == false) {
+      LOG_INFO("Update failed: not updatable");
+      tile_group_header->ReleaseTupleSlot(tuple_slot_id, transaction_id);
+      return false;
+    }
+
+    // the delta restores the committed version
+    begin_cid = tile_group_header->GetBeginCommitId(tuple_slot_id);
+
+    // the version was committed after our snapshot, first updater wins
+    if (begin_cid > last_cid) {
+      LOG_INFO("Update failed: tuple is updated by newer transaction");
+      tile_group_header->ReleaseTupleSlot(tuple_slot_id, transaction_id);
+      return false;
+    }
+  } else if (tile_group_header->GetTransactionId(tuple_slot_id) ==
+             transaction_id) {
+    // a tuple deleted by ourselves can not be updated
+    if (tile_group_header->GetBeginCommitId(tuple_slot_id) != MAX_CID) {
+      LOG_INFO("Update failed: tuple is deleted by own transaction");
+      return false;
+    }
+
+    // is a own insert, no need to keep the old values
+    auto prev = tile_group_header->GetPrevItemPointer(tuple_slot_id);
+    if (prev.block == INVALID_OID ||
+        delta_store->GetDelta(prev.offset)->txn_id != transaction_id) {
+      if (old_values != nullptr) {
+        for (auto column_id : column_ids)
+          old_values->push_back(GetValueCopy(tuple_slot_id, column_id));
+      }
+
+      // nobody else has seen the old keys, nor will
+      auto data_table = static_cast<DataTable *>(table);
+      std::unique_ptr<Tuple> old_version;
+      if (data_table != nullptr && data_table->HasIndexOnColumns(column_ids))
+        old_version.reset(CopySlot(tuple_slot_id));
+
+      tile_group_header->BeginSlotWrite(tuple_slot_id);
+      for (oid_t column_itr = 0; column_itr < column_ids.size(); column_itr++)
+        SetValue(tuple_slot_id, column_ids[column_itr], values[column_itr]);
+      tile_group_header->EndSlotWrite(tuple_slot_id);
+
+      if (old_version != nullptr) {
+        std::unique_ptr<Tuple> new_version(CopySlot(tuple_slot_id));
+        data_table->DeleteInIndexes(ItemPointer(tile_group_id, tuple_slot_id),
+                                    {old_version.get()}, {new_version.get()});
+      }
+      return true;
+    }
+
+    // else, is a own update and the delta restores an uncommitted version
+  } else {
+    LOG_INFO(
+        "Update failed: Latch failed and Ownership check failed: %lu != %lu",
+        tile_group_header->GetTransactionId(tuple_slot_id), transaction_id);
+    return false;
+  }
+
+  // Save the old values of the updated columns
+  TupleDelta delta;
+  delta.txn_id = transaction_id;
+  delta.begin_cid = begin_cid;
+  delta.end_cid = MAX_CID;
+  delta.prev = tile_group_header->GetPrevItemPointer(tuple_slot_id);
+  delta.columns.reserve(column_ids.size());
+
+  for (auto column_id : column_ids) {
+    delta.columns.emplace_back(column_id,
+                               GetValueCopy(tuple_slot_id, column_id));
+    if (old_values != nullptr) {
+      old_values->push_back(delta.columns.back().second);
+    }
+  }
+
+  oid_t delta_offset = delta_store->AddDelta(std::move(delta));
+
+  // Link the delta and hide the new version until commit, readers copying
+  // the slot meanwhile retry
+  tile_group_header->BeginSlotWrite(tuple_slot_id);
+  tile_group_header->SetPrevItemPointer(
+      tuple_slot_id, ItemPointer(tile_group_id, delta_offset));
+  tile_group_header->SetBeginCommitId(tuple_slot_id, MAX_CID);
+
+  // Finally, overwrite the slot
+  for (oid_t column_itr = 0; column_itr < column_ids.size(); column_itr++)
+    SetValue(tuple_slot_id, column_ids[column_itr], values[column_itr]);
+  tile_group_header->EndSlotWrite(tuple_slot_id);
+
+  return true;
+}
+
 void TileGroup::CommitInsertedTuple(oid_t tuple_slot_id,
                                     txn_id_t transaction_id, cid_t commit_id) {
   // set the begin commit id to persist insert
@@ -256,6 +387,322 @@ void TileGroup::AbortDeletedTuple(oid_t tuple_slot_id,
   tile_group_header->ReleaseTupleSlot(tuple_slot_id, transaction_id);
 }
 
+/**
+ * Close the deltas of our update and make the new version visible.
+ * A no-op if the slot has no deltas of this transaction (own insert).
+ * The deltas that ended before the oldest snapshot are freed while we still
+ * hold the latch of the slot.
+ */
+void TileGroup::CommitUpdatedTuple(oid_t tuple_slot_id,
+                                   txn_id_t transaction_id, cid_t commit_id,
+                                   cid_t oldest_snapshot) {
+  bool updated = false;
+
+  auto prev = tile_group_header->GetPrevItemPointer(tuple_slot_id);
+  while (prev.block != INVALID_OID) {
+    auto delta = delta_store->GetDelta(prev.offset);
+    if (delta->txn_id != transaction_id) break;
+
+    delta->end_cid = commit_id;
+    delta->txn_id = INITIAL_TXN_ID;
+
+    updated = true;
+    prev = delta->prev;
+  }
+
+  if (updated == false) return;
+
+  tile_group_header->SetBeginCommitId(tuple_slot_id, commit_id);
+
+  ReclaimDeltas(tuple_slot_id, oldest_snapshot);
+
+  // might have been deleted by ourselves after the update
+  tile_group_header->ReleaseTupleSlot(tuple_slot_id, transaction_id);
+}
+
+/**
+ * Restore the old values from the deltas of our update, newest first.
+ * A no-op if the slot has no deltas of this transaction (own insert).
+ */
+void TileGroup::AbortUpdatedTuple(oid_t tuple_slot_id,
+                                  txn_id_t transaction_id, cid_t last_cid) {
+  bool updated = false;
+
+  // Drop the entries of the new keys first. Once the version chain of the
+  // slot is gone, index only scans take its key from any entry.
+  oid_t update_count = 0;
+  auto prev = tile_group_header->GetPrevItemPointer(tuple_slot_id);
+  while (prev.block != INVALID_OID) {
+    auto delta = delta_store->GetDelta(prev.offset);
+    if (delta->txn_id != transaction_id) break;
+    update_count++;
+    prev = delta->prev;
+  }
+  if (update_count > 0)
+    DeleteVersionsInIndexes(tuple_slot_id, update_count, true);
+
+  tile_group_header->BeginSlotWrite(tuple_slot_id);
+
+  prev = tile_group_header->GetPrevItemPointer(tuple_slot_id);
+  while (prev.block != INVALID_OID) {
+    auto delta = delta_store->GetDelta(prev.offset);
+    if (delta->txn_id != transaction_id) break;
+
+    for (auto &column : delta->columns)
+      SetValue(tuple_slot_id, column.first, column.second);
+
+    // restore the visibility of the old version before unlinking the delta
+    tile_group_header->SetBeginCommitId(tuple_slot_id, delta->begin_cid);
+    tile_group_header->SetPrevItemPointer(tuple_slot_id, delta->prev);
+
+    // the delta is dead now, but a reader may still be on its way to it
+    delta->begin_cid = MAX_CID;
+    delta->txn_id = INITIAL_TXN_ID;
+    delta_store->RetireDelta(prev.offset, last_cid);
+
+    updated = true;
+    prev = delta->prev;
+  }
+
+  tile_group_header->EndSlotWrite(tuple_slot_id);
+
+  if (updated == false) return;
+
+  // undo update (and a delete of our own update)
+  tile_group_header->SetTransactionId(tuple_slot_id, INITIAL_TXN_ID);
+}
+
+//===--------------------------------------------------------------------===//
+// Version Chain
+//===--------------------------------------------------------------------===//
+
+/**
+ * The version restored by a delta is visible if it is committed in the
+ * snapshot of the transaction. Uncommitted deltas of the transaction itself
+ * are never visible as it sees its own version in the slot.
+ */
+static bool IsDeltaVisible(const TupleDelta *delta, txn_id_t txn_id,
+                           cid_t at_lcid) {
+  return (delta->txn_id != txn_id) && (at_lcid >= delta->begin_cid) &&
+         (at_lcid < delta->end_cid);
+}
+
+bool TileGroup::HasVisibleVersion(oid_t tuple_slot_id, txn_id_t txn_id,
+                                  cid_t at_lcid) {
+  if (tile_group_header->IsVisible(tuple_slot_id, txn_id, at_lcid))
+    return true;
+
+  auto prev = tile_group_header->GetPrevItemPointer(tuple_slot_id);
+  while (prev.block != INVALID_OID) {
+    auto delta = delta_store->GetDelta(prev.offset);
+    if (IsDeltaVisible(delta, txn_id, at_lcid)) return true;
+    prev = delta->prev;
+  }
+
+  return false;
+}
+
+/**
+ * Rebuild the version visible to the transaction by applying the deltas,
+ * newest first, on top of the tuple in the slot.
+ *
+ * Only meant for tuples not visible in the slot itself. Object values in the
+ * rebuilt tuple are not copied, they live as long as the tile group.
+ *
+ * @return false if none of the older versions is visible.
+ */
+bool TileGroup::GetVisibleVersion(oid_t tuple_slot_id, txn_id_t txn_id,
+                                  cid_t at_lcid, Tuple *tuple) {
+  // Copy again if the slot was overwritten meanwhile
+  while (true) {
+    auto version = tile_group_header->BeginSlotRead(tuple_slot_id);
+    bool visible =
+        RebuildVisibleVersion(tuple_slot_id, txn_id, at_lcid, tuple);
+    if (tile_group_header->ValidateSlotRead(tuple_slot_id, version))
+      return visible;
+  }
+}
+
+/**
+ * Copy the version visible to the transaction, either the tuple in the slot
+ * or an older version rebuilt from the deltas. Unlike a reference to the
+ * slot, the copy stays consistent when the slot is updated in place later.
+ *
+ * @return false if no version is visible.
+ */
+bool TileGroup::CopyVisibleVersion(oid_t tuple_slot_id, txn_id_t txn_id,
+                                   cid_t at_lcid, Tuple *tuple) {
+  auto column_count = column_map.size();
+
+  while (true) {
+    auto version = tile_group_header->BeginSlotRead(tuple_slot_id);
+
+    bool visible;
+    if (tile_group_header->IsVisible(tuple_slot_id, txn_id, at_lcid)) {
+      for (oid_t column_itr = 0; column_itr < column_count; column_itr++)
+        tuple->SetValue(column_itr, GetValue(tuple_slot_id, column_itr),
+                        nullptr);
+      visible = true;
+    } else {
+      visible = RebuildVisibleVersion(tuple_slot_id, txn_id, at_lcid, tuple);
+    }
+
+    if (tile_group_header->ValidateSlotRead(tuple_slot_id, version))
+      return visible;
+  }
+}
+
+/**
+ * Copy the given columns of the tuple in the slot into a row of a tile.
+ * The slot version is the one BeginSlotRead returned before the caller
+ * checked the visibility of the tuple.
+ *
+ * @return false if the slot was overwritten meanwhile, the copy may be torn.
+ */
+bool TileGroup::CopyTuple(oid_t tuple_slot_id, uint32_t slot_version,
+                          const std::vector<oid_t> &column_ids, Tile *tile,
+                          oid_t tile_offset) {
+  for (oid_t column_itr = 0; column_itr < column_ids.size(); column_itr++)
+    tile->SetValue(GetValue(tuple_slot_id, column_ids[column_itr]),
+                   tile_offset, column_itr);
+
+  return tile_group_header->ValidateSlotRead(tuple_slot_id, slot_version);
+}
+
+bool TileGroup::RebuildVisibleVersion(oid_t tuple_slot_id, txn_id_t txn_id,
+                                      cid_t at_lcid, Tuple *tuple) {
+  auto prev = tile_group_header->GetPrevItemPointer(tuple_slot_id);
+  if (prev.block == INVALID_OID) return false;
+
+  auto column_count = column_map.size();
+  for (oid_t column_itr = 0; column_itr < column_count; column_itr++)
+    tuple->SetValue(column_itr, GetValue(tuple_slot_id, column_itr), nullptr);
+
+  while (prev.block != INVALID_OID) {
+    auto delta = delta_store->GetDelta(prev.offset);
+    for (auto &column : delta->columns)
+      tuple->SetValue(column.first, column.second, nullptr);
+
+    if (IsDeltaVisible(delta, txn_id, at_lcid)) return true;
+    prev = delta->prev;
+  }
+
+  return false;
+}
+
+/**
+ * A committed delta that ended at or before the oldest snapshot restores a
+ * version no running or future transaction can see, and so do all older
+ * deltas. Readers stop at a newer version before they get there.
+ *
+ * The newest delta is kept, writers link new deltas to it. Only called by
+ * the holder of the latch of the slot. The deltas of aborted updates that no
+ * running transaction can hold anymore are freed as well.
+ *
+ * The index entries of the keys that only the unlinked versions have are
+ * deleted along with them.
+ */
+void TileGroup::ReclaimDeltas(oid_t tuple_slot_id, cid_t oldest_snapshot) {
+  delta_store->FreeRetiredDeltas(oldest_snapshot);
+
+  auto prev = tile_group_header->GetPrevItemPointer(tuple_slot_id);
+  if (prev.block == INVALID_OID) return;
+
+  // The version the delta restores, numbered as in DeleteVersionsInIndexes
+  oid_t version_itr = 2;
+  auto newer = delta_store->GetDelta(prev.offset);
+  prev = newer->prev;
+  while (prev.block != INVALID_OID) {
+    auto delta = delta_store->GetDelta(prev.offset);
+    if (delta->txn_id == INITIAL_TXN_ID && delta->end_cid <= oldest_snapshot)
+      break;
+
+    newer = delta;
+    prev = delta->prev;
+    version_itr++;
+  }
+
+  if (prev.block == INVALID_OID) return;
+
+  // Retire the entries of the keys only the unlinked versions have, while
+  // the chain still leads to them
+  DeleteVersionsInIndexes(tuple_slot_id, version_itr, false);
+
+  // Unlink the tail of the chain
+  tile_group_header->BeginSlotWrite(tuple_slot_id);
+  newer->prev = INVALID_ITEMPOINTER;
+  tile_group_header->EndSlotWrite(tuple_slot_id);
+
+  while (prev.block != INVALID_OID) {
+    auto next = delta_store->GetDelta(prev.offset)->prev;
+    delta_store->FreeDelta(prev.offset);
+    prev = next;
+  }
+}
+
+Tuple *TileGroup::CopySlot(oid_t tuple_slot_id) {
+  Tuple *tuple = new Tuple(table->GetSchema(), true);
+
+  auto column_count = column_map.size();
+  for (oid_t column_itr = 0; column_itr < column_count; column_itr++)
+    tuple->SetValue(column_itr, GetValue(tuple_slot_id, column_itr), nullptr);
+
+  return tuple;
+}
+
+/**
+ * The versions of the tuple are numbered newest first, the tuple in the slot
+ * being the first one and every delta restoring the next one. Either the
+ * versions before the split version are dropped or the ones from it on.
+ * Only called by the holder of the latch of the slot.
+ */
+void TileGroup::DeleteVersionsInIndexes(oid_t tuple_slot_id,
+                                        oid_t split_version, bool drop_newer) {
+  auto data_table = static_cast<DataTable *>(table);
+  if (data_table == nullptr) return;
+
+  // The versions differ in the updated columns only
+  std::vector<oid_t> column_ids;
+  auto prev = tile_group_header->GetPrevItemPointer(tuple_slot_id);
+  while (prev.block != INVALID_OID) {
+    auto delta = delta_store->GetDelta(prev.offset);
+    for (auto &column : delta->columns) column_ids.push_back(column.first);
+    prev = delta->prev;
+  }
+  if (data_table->HasIndexOnColumns(column_ids) == false) return;
+
+  std::vector<std::unique_ptr<Tuple>> versions;
+  versions.emplace_back(CopySlot(tuple_slot_id));
+
+  auto column_count = column_map.size();
+  prev = tile_group_header->GetPrevItemPointer(tuple_slot_id);
+  while (prev.block != INVALID_OID) {
+    auto delta = delta_store->GetDelta(prev.offset);
+    std::unique_ptr<Tuple> version(new Tuple(table->GetSchema(), true));
+    for (oid_t column_itr = 0; column_itr < column_count; column_itr++)
+      version->SetValue(column_itr, versions.back()->GetValue(column_itr),
+                        nullptr);
+    for (auto &column : delta->columns)
+      version->SetValue(column.first, column.second, nullptr);
+
+    versions.push_back(std::move(version));
+    prev = delta->prev;
+  }
+
+  std::vector<const Tuple *> dropped, kept;
+  for (oid_t version_itr = 0; version_itr < versions.size(); version_itr++) {
+    if ((version_itr < split_version) == drop_newer)
+      dropped.push_back(versions[version_itr].get());
+    else
+      kept.push_back(versions[version_itr].get());
+  }
+
+  if (dropped.empty() == false) {
+    data_table->DeleteInIndexes(ItemPointer(tile_group_id, tuple_slot_id),
+                                dropped, kept);
+  }
+}
+
 // Sets the tile id and column id w.r.t that tile corresponding to
 // the specified tile group column id.
 void TileGroup::LocateTileAndColumn(oid_t column_offset, oid_t &tile_offset,
@@ -287,6 +734,20 @@ Value TileGroup::GetValue(oid_t tuple_id, oid_t column_id) {
   return GetTile(tile_offset)->GetValue(tuple_id, tile_column_id);
 }
 
+void TileGroup::SetValue(oid_t tuple_id, oid_t column_id,
+                         const Value &value) {
+  assert(tuple_id < GetNextTupleSlot());
+  oid_t tile_column_id, tile_offset;
+  LocateTileAndColumn(column_id, tile_offset, tile_column_id);
+
+  Tile *tile = GetTile(tile_offset);
+  auto column_type = tile->GetSchema()->GetType(tile_column_id);
+  if (value.GetValueType() == column_type)
+    tile->SetValue(value, tuple_id, tile_column_id);
+  else
+    tile->SetValue(value.CastAs(column_type), tuple_id, tile_column_id);
+}
+
 Tile *TileGroup::GetTile(const oid_t tile_offset) const {
   assert(tile_offset < tile_count);
   Tile *tile = tiles[tile_offset].get();
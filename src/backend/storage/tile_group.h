@@ -21,6 +21,7 @@
 
 #include "backend/common/types.h"
 #include "backend/common/printable.h"
+#include "backend/storage/delta_store.h"
 
 namespace peloton {
 
@@ -81,10 +82,19 @@ class TileGroup : public Printable {
   oid_t InsertTuple(txn_id_t transaction_id, oid_t tuple_slot_id,
                     const Tuple *tuple);
 
-  // delete tuple at given slot if it is not already locked
+  // delete tuple at given slot if it is not already locked,
+  // waits for a younger latch holder for a while
   bool DeleteTuple(txn_id_t transaction_id, oid_t tuple_slot_id,
                    cid_t last_cid);
 
+  // update the given columns of the tuple at given slot in place
+  // if it is not already locked, waits for a younger latch holder for a while,
+  // and hands back the values it replaced if old_values is given
+  bool UpdateTuple(txn_id_t transaction_id, oid_t tuple_slot_id,
+                   cid_t last_cid, const std::vector<oid_t> &column_ids,
+                   const std::vector<Value> &values,
+                   std::vector<Value> *old_values = nullptr);
+
   //===--------------------------------------------------------------------===//
   // Transaction Processing
   //===--------------------------------------------------------------------===//
@@ -103,6 +113,38 @@ class TileGroup : public Printable {
   // abort the deleted tuple
   void AbortDeletedTuple(oid_t tuple_slot_id, txn_id_t transaction_id);
 
+  // commit the tuple updated in place, and free its deltas older than the
+  // oldest snapshot of the running transactions
+  void CommitUpdatedTuple(oid_t tuple_slot_id, txn_id_t transaction_id,
+                          cid_t commit_id, cid_t oldest_snapshot);
+
+  // abort the tuple updated in place, its deltas are freed once the
+  // transactions running at the last commit id have finished
+  void AbortUpdatedTuple(oid_t tuple_slot_id, txn_id_t transaction_id,
+                         cid_t last_cid);
+
+  //===--------------------------------------------------------------------===//
+  // Version Chain
+  //===--------------------------------------------------------------------===//
+
+  // check if the tuple at given slot or one of its older versions is visible
+  bool HasVisibleVersion(oid_t tuple_slot_id, txn_id_t txn_id, cid_t at_lcid);
+
+  // rebuild the older version of the tuple at given slot that is visible
+  bool GetVisibleVersion(oid_t tuple_slot_id, txn_id_t txn_id, cid_t at_lcid,
+                         Tuple *tuple);
+
+  // copy the version of the tuple at given slot that is visible, the one in
+  // the slot or an older one
+  bool CopyVisibleVersion(oid_t tuple_slot_id, txn_id_t txn_id, cid_t at_lcid,
+                          Tuple *tuple);
+
+  // copy the given columns of the tuple at given slot into a row of a tile,
+  // false if a writer has been in the slot since the given slot version
+  bool CopyTuple(oid_t tuple_slot_id, uint32_t slot_version,
+                 const std::vector<oid_t> &column_ids, Tile *tile,
+                 oid_t tile_offset);
+
   //===--------------------------------------------------------------------===//
   // Utilities
   //===--------------------------------------------------------------------===//
@@ -160,12 +202,40 @@ class TileGroup : public Printable {
 
   Value GetValue(oid_t tuple_id, oid_t column_id);
 
+  // get a value that does not point into the slot
+  Value GetValueCopy(oid_t tuple_id, oid_t column_id);
+
+  void SetValue(oid_t tuple_id, oid_t column_id, const Value &value);
+
+  const std::shared_ptr<DeltaStore> &GetDeltaStore() const {
+    return delta_store;
+  }
+
+  void SetDeltaStore(const std::shared_ptr<DeltaStore> &store) {
+    delta_store = store;
+  }
+
   double GetSchemaDifference(const storage::column_map_type &new_column_map);
 
   // Sync the contents
   void Sync();
 
  protected:
+  // copy the tuple in the slot and apply its deltas until the visible one
+  bool RebuildVisibleVersion(oid_t tuple_slot_id, txn_id_t txn_id,
+                             cid_t at_lcid, Tuple *tuple);
+
+  // free the deltas of the slot no transaction can see anymore
+  void ReclaimDeltas(oid_t tuple_slot_id, cid_t oldest_snapshot);
+
+  // copy the tuple in the slot
+  Tuple *CopySlot(oid_t tuple_slot_id);
+
+  // delete the index entries of the versions of the tuple at given slot
+  // before, or from, the split version whose keys the others don't have
+  void DeleteVersionsInIndexes(oid_t tuple_slot_id, oid_t split_version,
+                               bool drop_newer);
+
   //===--------------------------------------------------------------------===//
   // Data members
   //===--------------------------------------------------------------------===//
@@ -201,6 +271,9 @@ class TileGroup : public Printable {
   // column to tile mapping :
   // <column offset> to <tile offset, tile column offset>
   column_map_type column_map;
+
+  // before-images of tuples updated in place
+  std::shared_ptr<DeltaStore> delta_store;
 };
 
 }  // End storage namespace
@@ -10,9 +10,12 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include <algorithm>
+#include <chrono>
 #include <iostream>
 #include <iomanip>
 #include <sstream>
+#include <thread>
 
 #include "backend/concurrency/transaction_manager.h"
 #include "backend/storage/storage_manager.h"
@@ -25,7 +28,8 @@ TileGroupHeader::TileGroupHeader(BackendType backend_type, int tuple_count)
     : backend_type(backend_type),
       data(nullptr),
       num_tuple_slots(tuple_count),
-      next_tuple_slot(0) {
+      next_tuple_slot(0),
+      slot_versions(new std::atomic<uint32_t>[tuple_count]()) {
   header_size = num_tuple_slots * header_entry_size;
 
   // allocate storage space for header
@@ -45,6 +49,7 @@ TileGroupHeader::TileGroupHeader(BackendType backend_type, int tuple_count)
     SetEndCommitId(tuple_slot_id, MAX_CID);
     SetInsertCommit(tuple_slot_id, false);
     SetDeleteCommit(tuple_slot_id, false);
+    SetPrevItemPointer(tuple_slot_id, INVALID_ITEMPOINTER);
   }
 }
 
@@ -56,6 +61,64 @@ TileGroupHeader::~TileGroupHeader() {
   data = nullptr;
 }
 
+uint32_t TileGroupHeader::BeginSlotRead(const oid_t tuple_slot_id) const {
+  uint32_t version =
+      slot_versions[tuple_slot_id].load(std::memory_order_acquire);
+
+  // the writer only holds the slot while it copies a few values
+  while (version % 2 == 1) {
+    std::this_thread::yield();
+    version = slot_versions[tuple_slot_id].load(std::memory_order_acquire);
+  }
+
+  return version;
+}
+
+//===--------------------------------------------------------------------===//
+// Write-Write Conflicts
+//===--------------------------------------------------------------------===//
+
+/**
+ * @brief Latch the slot, waiting for a while if it is latched by another
+ * transaction (wait-die).
+ * Only an older transaction waits for a younger latch holder, a younger one
+ * gives up right away. Waits therefore never form a cycle. The wait backs off
+ * exponentially and is bounded, as the holder keeps the latch until it ends.
+ * @return true if the slot is latched, false if the transaction has to die.
+ */
+bool TileGroupHeader::LatchTupleSlotOrWait(const oid_t tuple_slot_id,
+                                           txn_id_t transaction_id) {
+  const std::chrono::microseconds wait_limit(TUPLE_SLOT_WAIT_LIMIT);
+  const std::chrono::microseconds max_backoff(TUPLE_SLOT_MAX_BACKOFF);
+  std::chrono::microseconds backoff(1);
+  std::chrono::microseconds waited(0);
+
+  while (LatchTupleSlot(tuple_slot_id, transaction_id) == false) {
+    auto holder_id = GetTransactionId(tuple_slot_id);
+
+    // Released in the meantime, try again
+    if (holder_id == INITIAL_TXN_ID) continue;
+
+    // Own latch, deleted insert, or older holder
+    if (holder_id == transaction_id || holder_id == INVALID_TXN_ID ||
+        holder_id < transaction_id) {
+      return false;
+    }
+
+    if (waited >= wait_limit) {
+      LOG_INFO("Gave up waiting for slot %lu latched by txn %lu",
+               tuple_slot_id, holder_id);
+      return false;
+    }
+
+    std::this_thread::sleep_for(backoff);
+    waited += backoff;
+    backoff = std::min(backoff * 2, max_backoff);
+  }
+
+  return true;
+}
+
 //===--------------------------------------------------------------------===//
 // Tile Group Header
 //===--------------------------------------------------------------------===//
@@ -18,6 +18,7 @@
 #include "backend/logging/log_manager.h"
 
 #include <atomic>
+#include <memory>
 #include <mutex>
 #include <iostream>
 #include <cassert>
@@ -45,6 +46,9 @@ namespace storage {
  *|
  * 	-----------------------------------------------------------------------------
  *
+ * Prev ItemPointer points to the newest delta of a tuple updated in place,
+ * see DeltaStore.
+ *
  */
 
 class TileGroupHeader : public Printable {
@@ -162,6 +166,18 @@ class TileGroupHeader : public Printable {
     }
   }
 
+  // latch the slot, or wait for a younger latch holder to release it
+  bool LatchTupleSlotOrWait(const oid_t tuple_slot_id,
+                            txn_id_t transaction_id);
+
+  // after a failed write on the slot: whether another transaction has
+  // latched it or deleted it (a write-write conflict), as opposed to a
+  // failure of a slot the writer still holds
+  inline bool IsWriteConflict(const oid_t tuple_slot_id,
+                              txn_id_t transaction_id) const {
+    return GetTransactionId(tuple_slot_id) != transaction_id;
+  }
+
   inline bool ReleaseTupleSlot(const oid_t tuple_slot_id,
                                txn_id_t transaction_id) {
     txn_id_t *txn_id = (txn_id_t *)(data + (tuple_slot_id * header_entry_size));
@@ -285,6 +301,34 @@ class TileGroupHeader : public Printable {
     return deletable;
   }
 
+  //===--------------------------------------------------------------------===//
+  // In-place writes
+  //===--------------------------------------------------------------------===//
+
+  // A writer overwriting the slot in place holds its latch and makes the
+  // write version of the slot odd until it is done. Readers copy the slot
+  // between BeginSlotRead and ValidateSlotRead, and retry if it changed.
+
+  inline void BeginSlotWrite(const oid_t tuple_slot_id) {
+    slot_versions[tuple_slot_id].fetch_add(1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+  }
+
+  inline void EndSlotWrite(const oid_t tuple_slot_id) {
+    slot_versions[tuple_slot_id].fetch_add(1, std::memory_order_release);
+  }
+
+  // wait for a writer to finish and return the write version of the slot
+  uint32_t BeginSlotRead(const oid_t tuple_slot_id) const;
+
+  // true if no writer has been in the slot since BeginSlotRead
+  inline bool ValidateSlotRead(const oid_t tuple_slot_id,
+                               uint32_t version) const {
+    std::atomic_thread_fence(std::memory_order_acquire);
+    return slot_versions[tuple_slot_id].load(std::memory_order_relaxed) ==
+           version;
+  }
+
   void PrintVisibility(txn_id_t txn_id, cid_t at_cid);
 
   // Sync the contents
@@ -321,6 +365,9 @@ class TileGroupHeader : public Printable {
   // next free tuple slot
   oid_t next_tuple_slot;
 
+  // write version of every slot, odd while it is overwritten in place
+  std::unique_ptr<std::atomic<uint32_t>[]> slot_versions;
+
   // synch helpers
   std::mutex tile_header_mutex;
 };
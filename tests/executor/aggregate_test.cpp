@@ -10,6 +10,7 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include <map>
 #include <memory>
 #include <set>
 #include <string>
@@ -23,13 +24,16 @@
 
 #include "backend/common/types.h"
 #include "backend/common/value.h"
+#include "backend/common/value_peeker.h"
 #include "backend/executor/executor_context.h"
 #include "backend/executor/logical_tile.h"
 #include "backend/executor/aggregate_executor.h"
 #include "backend/executor/logical_tile_factory.h"
+#include "backend/executor/seq_scan_executor.h"
 #include "backend/expression/expression_util.h"
 #include "backend/planner/abstract_plan.h"
 #include "backend/planner/aggregate_plan.h"
+#include "backend/planner/seq_scan_plan.h"
 #include "backend/storage/data_table.h"
 
 #include "executor/executor_tests_util.h"
@@ -42,6 +46,90 @@ using ::testing::Return;
 namespace peloton {
 namespace test {
 
+namespace {
+
+/*
+ * SELECT b, COUNT(*), SUM(a), MIN(d), MAX(c), AVG(a), COUNT(DISTINCT d)
+ * from table GROUP BY b;
+ */
+std::map<int, std::vector<std::string>> RunHashGroupBy(
+    storage::DataTable *data_table, size_t memory_budget) {
+  planner::SeqScanPlan scan_node(data_table, nullptr, {0, 1, 2, 3});
+
+  std::vector<oid_t> group_by_columns = {1};
+
+  planner::ProjectInfo::DirectMapList direct_map_list = {
+      {0, {0, 1}}, {1, {1, 0}}, {2, {1, 1}}, {3, {1, 2}},
+      {4, {1, 3}}, {5, {1, 4}}, {6, {1, 5}}};
+  auto proj_info = new planner::ProjectInfo(planner::ProjectInfo::TargetList(),
+                                            std::move(direct_map_list));
+
+  std::vector<planner::AggregatePlan::AggTerm> agg_terms;
+  agg_terms.emplace_back(EXPRESSION_TYPE_AGGREGATE_COUNT_STAR, nullptr);
+  agg_terms.emplace_back(EXPRESSION_TYPE_AGGREGATE_SUM,
+                         expression::TupleValueFactory(0, 0));
+  agg_terms.emplace_back(EXPRESSION_TYPE_AGGREGATE_MIN,
+                         expression::TupleValueFactory(0, 3));
+  agg_terms.emplace_back(EXPRESSION_TYPE_AGGREGATE_MAX,
+                         expression::TupleValueFactory(0, 2));
+  agg_terms.emplace_back(EXPRESSION_TYPE_AGGREGATE_AVG,
+                         expression::TupleValueFactory(0, 0));
+  agg_terms.emplace_back(EXPRESSION_TYPE_AGGREGATE_COUNT,
+                         expression::TupleValueFactory(0, 3), true);
+
+  auto data_table_schema = data_table->GetSchema();
+  std::vector<catalog::Column> columns;
+  for (auto column_index : {1, 0, 0, 3, 2, 2, 0}) {
+    columns.push_back(data_table_schema->GetColumn(column_index));
+  }
+  auto output_table_schema = new catalog::Schema(columns);
+
+  planner::AggregatePlan node(proj_info, nullptr, std::move(agg_terms),
+                              std::move(group_by_columns), output_table_schema,
+                              AGGREGATE_TYPE_HASH);
+  node.SetMemoryBudget(memory_budget);
+
+  auto &txn_manager = concurrency::TransactionManager::GetInstance();
+  auto txn = txn_manager.BeginTransaction();
+  std::unique_ptr<executor::ExecutorContext> context(
+      new executor::ExecutorContext(txn));
+
+  executor::AggregateExecutor executor(&node, context.get());
+  executor::SeqScanExecutor scan_executor(&scan_node, context.get());
+  executor.AddChild(&scan_executor);
+
+  EXPECT_TRUE(executor.Init());
+
+  std::map<int, std::vector<std::string>> groups;
+  while (executor.Execute()) {
+    std::unique_ptr<executor::LogicalTile> result_tile(executor.GetOutput());
+    for (oid_t tuple_id : *result_tile) {
+      auto group =
+          ValuePeeker::PeekAsInteger(result_tile->GetValue(tuple_id, 0));
+      EXPECT_EQ(0, groups.count(group));
+
+      auto &values = groups[group];
+      for (oid_t column_itr = 1; column_itr < columns.size(); column_itr++) {
+        Value value = result_tile->GetValue(tuple_id, column_itr);
+        if (value.IsNull() == false &&
+            value.GetValueType() == VALUE_TYPE_VARCHAR) {
+          values.push_back(ValuePeeker::PeekStringCopyWithoutNull(value));
+        } else if (value.IsNull() == false &&
+                   value.GetValueType() == VALUE_TYPE_INTEGER) {
+          values.push_back(std::to_string(ValuePeeker::PeekInteger(value)));
+        } else {
+          values.push_back(value.GetInfo());
+        }
+      }
+    }
+  }
+
+  txn_manager.CommitTransaction();
+  return groups;
+}
+
+}  // namespace
+
 TEST(AggregateTests, SortedDistinctTest) {
   /*
    * SELECT d, a, b, c FROM table GROUP BY a, b, c, d;
@@ -762,5 +850,36 @@ TEST(AggregateTests, PlainSumCountDistinctTest) {
                   .IsTrue());
 }
 
+TEST(AggregateTests, HashSpillGroupByTest) {
+  const int tile_group_count = 10;
+  const int tuples_per_tile_group = 100;
+
+  auto &txn_manager = concurrency::TransactionManager::GetInstance();
+  auto txn = txn_manager.BeginTransaction();
+  std::unique_ptr<storage::DataTable> data_table(
+      ExecutorTestsUtil::CreateTable(tuples_per_tile_group, false));
+  ExecutorTestsUtil::PopulateTable(txn, data_table.get(),
+                                   tile_group_count * tuples_per_tile_group,
+                                   false, true, false);
+  txn_manager.CommitTransaction();
+
+  auto groups =
+      RunHashGroupBy(data_table.get(), DEFAULT_AGGREGATE_MEMORY_BUDGET);
+  EXPECT_LT(1, groups.size());
+
+  // Every row is counted once
+  int tuple_count = 0;
+  for (auto &group : groups) {
+    tuple_count += std::stoi(group.second[0]);
+  }
+  EXPECT_EQ(tile_group_count * tuples_per_tile_group, tuple_count);
+
+  // A few groups fit in memory, the rows of the others are spilled and
+  // aggregated a partition at a time
+  for (size_t memory_budget : {8 * 1024, 1}) {
+    EXPECT_EQ(groups, RunHashGroupBy(data_table.get(), memory_budget));
+  }
+}
+
 }  // namespace test
 }  // namespace peloton
@@ -0,0 +1,245 @@
+//===----------------------------------------------------------------------===//
+//
+//                         PelotonDB
+//
+// exchange_test.cpp
+//
+// Identification: tests/executor/exchange_test.cpp
+//
+// Copyright (c) 2015, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <map>
+#include <memory>
+#include <set>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "backend/common/types.h"
+#include "backend/common/value_peeker.h"
+#include "backend/concurrency/transaction_manager.h"
+#include "backend/executor/aggregate_executor.h"
+#include "backend/executor/exchange_executor.h"
+#include "backend/executor/executor_context.h"
+#include "backend/executor/hash_executor.h"
+#include "backend/executor/logical_tile.h"
+#include "backend/executor/seq_scan_executor.h"
+#include "backend/expression/expression_util.h"
+#include "backend/expression/tuple_value_expression.h"
+#include "backend/planner/aggregate_plan.h"
+#include "backend/planner/exchange_plan.h"
+#include "backend/planner/hash_plan.h"
+#include "backend/planner/seq_scan_plan.h"
+#include "backend/storage/data_table.h"
+
+#include "executor/executor_tests_util.h"
+#include "harness.h"
+
+namespace peloton {
+namespace test {
+
+namespace {
+
+const size_t worker_count = 4;
+
+const size_t tile_group_count = 100;
+
+const size_t tuple_count = 10 * tile_group_count;
+
+storage::DataTable *CreateParallelTable(bool group_by) {
+  auto &txn_manager = concurrency::TransactionManager::GetInstance();
+  auto txn = txn_manager.BeginTransaction();
+
+  auto data_table = ExecutorTestsUtil::CreateTable(10, false);
+  ExecutorTestsUtil::PopulateTable(txn, data_table, tuple_count, false, false,
+                                   group_by);
+
+  txn_manager.CommitTransaction();
+  return data_table;
+}
+
+// Give every worker of the exchange its own scan of the table
+void AddWorkerScans(
+    executor::ExchangeExecutor &exchange, const planner::SeqScanPlan &scan_node,
+    std::vector<std::unique_ptr<executor::SeqScanExecutor>> &scans) {
+  for (size_t worker = 0; worker < worker_count; worker++) {
+    scans.emplace_back(new executor::SeqScanExecutor(
+        &scan_node, exchange.AddWorkerContext()));
+    exchange.AddChild(scans.back().get());
+  }
+}
+
+}  // namespace
+
+TEST(ExchangeTests, ParallelScanTest) {
+  std::unique_ptr<storage::DataTable> data_table(CreateParallelTable(false));
+
+  planner::SeqScanPlan scan_node(data_table.get(), nullptr, {0, 1});
+  planner::ExchangePlan exchange_node(worker_count);
+
+  auto &txn_manager = concurrency::TransactionManager::GetInstance();
+  auto txn = txn_manager.BeginTransaction();
+  std::unique_ptr<executor::ExecutorContext> context(
+      new executor::ExecutorContext(txn));
+
+  executor::ExchangeExecutor exchange(&exchange_node, context.get());
+  std::vector<std::unique_ptr<executor::SeqScanExecutor>> scans;
+  AddWorkerScans(exchange, scan_node, scans);
+  EXPECT_EQ(worker_count, exchange.GetWorkerCount());
+
+  // Every tuple is returned once, also when the scan is run again
+  for (int run = 0; run < 2; run++) {
+    EXPECT_TRUE(exchange.Init());
+
+    std::set<int> values;
+    size_t result_tuple_count = 0;
+    while (exchange.Execute()) {
+      std::unique_ptr<executor::LogicalTile> result_tile(exchange.GetOutput());
+      for (oid_t tuple_id : *result_tile) {
+        values.insert(
+            ValuePeeker::PeekAsInteger(result_tile->GetValue(tuple_id, 0)));
+        result_tuple_count++;
+      }
+    }
+
+    EXPECT_EQ(tuple_count, result_tuple_count);
+    EXPECT_EQ(tuple_count, values.size());
+    EXPECT_EQ(ExecutorTestsUtil::PopulatedValue(0, 0), *values.begin());
+    EXPECT_EQ(ExecutorTestsUtil::PopulatedValue(tuple_count - 1, 0),
+              *values.rbegin());
+  }
+
+  txn_manager.CommitTransaction();
+}
+
+TEST(ExchangeTests, ParallelHashAggregateTest) {
+  /*
+   * SELECT a, SUM(b), COUNT(DISTINCT b) from table GROUP BY a;
+   */
+  std::unique_ptr<storage::DataTable> data_table(CreateParallelTable(true));
+
+  planner::SeqScanPlan scan_node(data_table.get(), nullptr, {0, 1, 2, 3});
+  planner::ExchangePlan exchange_node(worker_count);
+
+  std::vector<oid_t> group_by_columns = {0};
+
+  planner::ProjectInfo::DirectMapList direct_map_list = {
+      {0, {0, 0}}, {1, {1, 0}}, {2, {1, 1}}};
+  auto proj_info = new planner::ProjectInfo(planner::ProjectInfo::TargetList(),
+                                            std::move(direct_map_list));
+
+  std::vector<planner::AggregatePlan::AggTerm> agg_terms;
+  agg_terms.emplace_back(EXPRESSION_TYPE_AGGREGATE_SUM,
+                         expression::TupleValueFactory(0, 1));
+  agg_terms.emplace_back(EXPRESSION_TYPE_AGGREGATE_COUNT,
+                         expression::TupleValueFactory(0, 1), true);
+
+  auto data_table_schema = data_table->GetSchema();
+  std::vector<catalog::Column> columns;
+  for (auto column_index : {0, 1, 1}) {
+    columns.push_back(data_table_schema->GetColumn(column_index));
+  }
+  auto output_table_schema = new catalog::Schema(columns);
+
+  planner::AggregatePlan node(proj_info, nullptr, std::move(agg_terms),
+                              std::move(group_by_columns), output_table_schema,
+                              AGGREGATE_TYPE_HASH);
+
+  auto &txn_manager = concurrency::TransactionManager::GetInstance();
+  auto txn = txn_manager.BeginTransaction();
+  std::unique_ptr<executor::ExecutorContext> context(
+      new executor::ExecutorContext(txn));
+
+  executor::AggregateExecutor executor(&node, context.get());
+  executor::ExchangeExecutor exchange(&exchange_node, context.get());
+  std::vector<std::unique_ptr<executor::SeqScanExecutor>> scans;
+  AddWorkerScans(exchange, scan_node, scans);
+  executor.AddChild(&exchange);
+
+  std::map<int, std::pair<int, int>> expected_groups;
+  for (size_t tuple_id = 0; tuple_id < tuple_count; tuple_id++) {
+    auto group = ExecutorTestsUtil::PopulatedValue(
+        tuple_id / (tuple_count / 2), 0);
+    expected_groups[group].first +=
+        ExecutorTestsUtil::PopulatedValue(tuple_id, 1);
+    expected_groups[group].second++;
+  }
+
+  // Every worker keeps a single group in memory with the small budget, and
+  // spills the rows of the other one
+  for (size_t memory_budget : {DEFAULT_AGGREGATE_MEMORY_BUDGET, 1}) {
+    node.SetMemoryBudget(memory_budget);
+    EXPECT_TRUE(executor.Init());
+
+    // The first column has two values, each one for half of the tuples
+    std::map<int, std::pair<int, int>> groups;
+    while (executor.Execute()) {
+      std::unique_ptr<executor::LogicalTile> result_tile(executor.GetOutput());
+      for (oid_t tuple_id : *result_tile) {
+        auto group =
+            ValuePeeker::PeekAsInteger(result_tile->GetValue(tuple_id, 0));
+        groups[group] = std::make_pair(
+            ValuePeeker::PeekAsInteger(result_tile->GetValue(tuple_id, 1)),
+            ValuePeeker::PeekAsInteger(result_tile->GetValue(tuple_id, 2)));
+      }
+    }
+
+    EXPECT_EQ(2, groups.size());
+    EXPECT_EQ(expected_groups, groups);
+  }
+
+  txn_manager.CommitTransaction();
+}
+
+TEST(ExchangeTests, ParallelHashBuildTest) {
+  std::unique_ptr<storage::DataTable> data_table(CreateParallelTable(false));
+
+  planner::SeqScanPlan scan_node(data_table.get(), nullptr, {0, 1, 2, 3});
+  planner::ExchangePlan exchange_node(worker_count);
+
+  std::vector<planner::HashPlan::HashKeyPtrType> hash_keys;
+  hash_keys.emplace_back(new expression::TupleValueExpression(0, 1));
+  planner::HashPlan hash_node(hash_keys);
+
+  auto &txn_manager = concurrency::TransactionManager::GetInstance();
+  auto txn = txn_manager.BeginTransaction();
+  std::unique_ptr<executor::ExecutorContext> context(
+      new executor::ExecutorContext(txn));
+
+  executor::HashExecutor hash_executor(&hash_node, context.get());
+  executor::ExchangeExecutor exchange(&exchange_node, context.get());
+  std::vector<std::unique_ptr<executor::SeqScanExecutor>> scans;
+  AddWorkerScans(exchange, scan_node, scans);
+  hash_executor.AddChild(&exchange);
+
+  EXPECT_TRUE(hash_executor.Init());
+
+  std::vector<std::unique_ptr<executor::LogicalTile>> result_tiles;
+  while (hash_executor.Execute()) {
+    result_tiles.emplace_back(hash_executor.GetOutput());
+  }
+
+  txn_manager.CommitTransaction();
+
+  // Every tuple finds itself, under the offset of its tile
+  auto &hash_table = hash_executor.GetHashTable();
+  EXPECT_EQ(tuple_count, hash_table.GetEntryCount());
+
+  std::vector<oid_t> column_ids = {1};
+  executor::HashTable::Batch batch;
+  for (oid_t tile_itr = 0; tile_itr < result_tiles.size(); tile_itr++) {
+    hash_table.HashRows(result_tiles[tile_itr].get(), column_ids, batch);
+    for (size_t batch_itr = 0; batch_itr < batch.rows.size(); batch_itr++) {
+      auto entry_itr = hash_table.Find(batch, batch_itr);
+      ASSERT_NE(INVALID_OID, entry_itr);
+      EXPECT_EQ(tile_itr, hash_table.GetEntry(entry_itr).tile_itr);
+      EXPECT_EQ(batch.rows[batch_itr],
+                hash_table.GetEntry(entry_itr).tuple_id);
+    }
+  }
+}
+
+}  // namespace test
+}  // namespace peloton
@@ -0,0 +1,169 @@
+//===----------------------------------------------------------------------===//
+//
+//                         PelotonDB
+//
+// hash_table_test.cpp
+//
+// Identification: tests/executor/hash_table_test.cpp
+//
+// Copyright (c) 2015, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <memory>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "backend/common/types.h"
+#include "backend/concurrency/transaction_manager.h"
+#include "backend/executor/hash_table.h"
+#include "backend/executor/logical_tile.h"
+#include "backend/executor/logical_tile_factory.h"
+#include "backend/storage/data_table.h"
+
+#include "executor/executor_tests_util.h"
+#include "harness.h"
+
+namespace peloton {
+namespace test {
+
+namespace {
+
+const size_t tile_size = 10;
+
+const size_t tile_group_count = 5;
+
+// Wrap every tile group of a populated table in a logical tile
+void WrapTable(storage::DataTable *table, txn_id_t txn_id,
+               std::vector<std::unique_ptr<executor::LogicalTile>> &tiles) {
+  for (oid_t tile_group_itr = 0; tile_group_itr < table->GetTileGroupCount();
+       tile_group_itr++) {
+    tiles.emplace_back(executor::LogicalTileFactory::WrapTileGroup(
+        table->GetTileGroup(tile_group_itr), txn_id));
+  }
+}
+
+void RunHashTableTest(const std::vector<oid_t> &column_ids, bool reserve) {
+  auto &txn_manager = concurrency::TransactionManager::GetInstance();
+  auto txn = txn_manager.BeginTransaction();
+  auto txn_id = txn->GetTransactionId();
+
+  std::unique_ptr<storage::DataTable> build_table(
+      ExecutorTestsUtil::CreateTable(tile_size));
+  ExecutorTestsUtil::PopulateTable(txn, build_table.get(),
+                                   tile_size * tile_group_count, false, false,
+                                   false);
+
+  // The mutated table holds the keys of every third row of the other table
+  std::unique_ptr<storage::DataTable> probe_table(
+      ExecutorTestsUtil::CreateTable(tile_size));
+  ExecutorTestsUtil::PopulateTable(txn, probe_table.get(),
+                                   tile_size * tile_group_count, true, false,
+                                   false);
+
+  txn_manager.CommitTransaction();
+
+  std::vector<std::unique_ptr<executor::LogicalTile>> build_tiles;
+  std::vector<std::unique_ptr<executor::LogicalTile>> probe_tiles;
+  WrapTable(build_table.get(), txn_id, build_tiles);
+  WrapTable(probe_table.get(), txn_id, probe_tiles);
+
+  executor::HashTable hash_table(
+      column_ids,
+      executor::HashTable::GetColumnTypes(build_tiles[0].get(), column_ids));
+  if (reserve == true) {
+    hash_table.Reserve(1 << 20);
+    EXPECT_GT(hash_table.GetPartitionCount(), 1);
+  }
+
+  // Every row goes in twice
+  executor::HashTable::Batch batch;
+  for (oid_t tile_itr = 0; tile_itr < build_tiles.size(); tile_itr++) {
+    hash_table.HashRows(build_tiles[tile_itr].get(), column_ids, batch);
+    hash_table.Insert(batch, tile_itr * 2);
+    hash_table.Insert(batch, tile_itr * 2 + 1);
+  }
+  EXPECT_EQ(tile_size * tile_group_count * 2, hash_table.GetEntryCount());
+
+  // Every row finds both of its entries
+  for (oid_t tile_itr = 0; tile_itr < build_tiles.size(); tile_itr++) {
+    hash_table.HashRows(build_tiles[tile_itr].get(), column_ids, batch);
+    for (size_t batch_itr = 0; batch_itr < batch.rows.size(); batch_itr++) {
+      size_t match_count = 0;
+      hash_table.FindAll(batch, batch_itr, [&](oid_t entry_itr) -> bool {
+        auto &entry = hash_table.GetEntry(entry_itr);
+        EXPECT_EQ(tile_itr, entry.tile_itr / 2);
+        EXPECT_EQ(batch.rows[batch_itr], entry.tuple_id);
+        match_count++;
+        return true;
+      });
+      EXPECT_EQ(2, match_count);
+    }
+  }
+
+  size_t found_count = 0;
+  for (auto &probe_tile : probe_tiles) {
+    hash_table.HashRows(probe_tile.get(), column_ids, batch);
+    for (size_t batch_itr = 0; batch_itr < batch.rows.size(); batch_itr++) {
+      if (hash_table.Find(batch, batch_itr) != INVALID_OID) {
+        found_count++;
+      }
+    }
+  }
+  EXPECT_EQ((tile_size * tile_group_count + 2) / 3, found_count);
+}
+
+void RunFindOrInsertTest(const std::vector<oid_t> &column_ids) {
+  auto &txn_manager = concurrency::TransactionManager::GetInstance();
+  auto txn = txn_manager.BeginTransaction();
+  auto txn_id = txn->GetTransactionId();
+
+  std::unique_ptr<storage::DataTable> data_table(
+      ExecutorTestsUtil::CreateTable(tile_size));
+  ExecutorTestsUtil::PopulateTable(txn, data_table.get(),
+                                   tile_size * tile_group_count, false, false,
+                                   false);
+
+  txn_manager.CommitTransaction();
+
+  std::vector<std::unique_ptr<executor::LogicalTile>> tiles;
+  WrapTable(data_table.get(), txn_id, tiles);
+
+  executor::HashTable hash_table(
+      column_ids,
+      executor::HashTable::GetColumnTypes(tiles[0].get(), column_ids));
+
+  // The second pass finds the entries added by the first one
+  executor::HashTable::Batch batch;
+  std::vector<std::vector<oid_t>> first_entry_itrs(tiles.size());
+  std::vector<oid_t> entry_itrs;
+  for (oid_t tile_itr = 0; tile_itr < tiles.size(); tile_itr++) {
+    hash_table.HashRows(tiles[tile_itr].get(), column_ids, batch);
+    hash_table.FindOrInsert(batch, tile_itr, first_entry_itrs[tile_itr]);
+  }
+  for (oid_t tile_itr = 0; tile_itr < tiles.size(); tile_itr++) {
+    hash_table.HashRows(tiles[tile_itr].get(), column_ids, batch);
+    hash_table.FindOrInsert(batch, tile_itr, entry_itrs);
+    EXPECT_EQ(first_entry_itrs[tile_itr], entry_itrs);
+  }
+
+  EXPECT_EQ(tile_size * tile_group_count, hash_table.GetEntryCount());
+}
+
+}  // namespace
+
+TEST(HashTableTests, IntegerKeyTest) {
+  RunHashTableTest({0, 1}, false);
+  RunHashTableTest({0, 1}, true);
+  RunFindOrInsertTest({0, 1});
+}
+
+TEST(HashTableTests, VarcharKeyTest) {
+  RunHashTableTest({1, 3}, false);
+  RunHashTableTest({1, 3}, true);
+  RunFindOrInsertTest({1, 3});
+}
+
+}  // namespace test
+}  // namespace peloton
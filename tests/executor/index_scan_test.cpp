@@ -11,6 +11,7 @@
 //===----------------------------------------------------------------------===//
 
 #include <memory>
+#include <set>
 
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
@@ -22,7 +23,9 @@
 #include "backend/executor/logical_tile_factory.h"
 #include "backend/executor/index_scan_executor.h"
 #include "backend/storage/data_table.h"
+#include "backend/storage/tile_group.h"
 #include "backend/common/value_factory.h"
+#include "backend/common/value_peeker.h"
 
 #include "executor/executor_tests_util.h"
 #include "harness.h"
@@ -160,5 +163,157 @@ TEST(IndexScanTests, MultiColumnPredicateTest) {
   txn_manager.CommitTransaction();
 }
 
+namespace {
+
+// Index only scan of ATTR 0 <= 110 that projects the key columns in another
+// order than in the key
+void IndexOnlyScan(storage::DataTable *data_table, oid_t tuple_count) {
+  std::vector<oid_t> column_ids({1, 0});
+
+  auto index = data_table->GetIndex(1);
+  std::vector<oid_t> key_column_ids;
+  std::vector<ExpressionType> expr_types;
+  std::vector<Value> values;
+  std::vector<expression::AbstractExpression *> runtime_keys;
+
+  key_column_ids.push_back(0);
+  expr_types.push_back(
+      ExpressionType::EXPRESSION_TYPE_COMPARE_LESSTHANOREQUALTO);
+  values.push_back(ValueFactory::GetIntegerValue(110));
+
+  // Create index scan desc
+
+  planner::IndexScanPlan::IndexScanDesc index_scan_desc(
+      index, key_column_ids, expr_types, values, runtime_keys);
+
+  expression::AbstractExpression *predicate = nullptr;
+
+  // Create plan node.
+  planner::IndexScanPlan node(data_table, predicate, column_ids,
+                              index_scan_desc);
+
+  auto &txn_manager = concurrency::TransactionManager::GetInstance();
+  auto txn = txn_manager.BeginTransaction();
+  std::unique_ptr<executor::ExecutorContext> context(
+      new executor::ExecutorContext(txn));
+
+  // Run the executor
+  executor::IndexScanExecutor executor(&node, context.get());
+
+  EXPECT_TRUE(executor.Init());
+
+  // All the keys come from the index in key order
+  EXPECT_TRUE(executor.Execute());
+  std::unique_ptr<executor::LogicalTile> result_tile(executor.GetOutput());
+  EXPECT_THAT(result_tile, NotNull());
+  EXPECT_FALSE(executor.Execute());
+
+  EXPECT_EQ(result_tile->GetColumnCount(), 2);
+  EXPECT_EQ(result_tile->GetTupleCount(), tuple_count);
+  for (oid_t tuple_itr = 0; tuple_itr < result_tile->GetTupleCount();
+       tuple_itr++) {
+    EXPECT_EQ(result_tile->GetValue(tuple_itr, 0),
+              ValueFactory::GetIntegerValue(
+                  ExecutorTestsUtil::PopulatedValue(tuple_itr, 1)));
+    EXPECT_EQ(result_tile->GetValue(tuple_itr, 1),
+              ValueFactory::GetIntegerValue(
+                  ExecutorTestsUtil::PopulatedValue(tuple_itr, 0)));
+  }
+
+  txn_manager.CommitTransaction();
+}
+
+}  // namespace
+
+// Index scan that only projects key columns.
+TEST(IndexScanTests, IndexOnlyScanTest) {
+  // First, generate the table with index
+  std::unique_ptr<storage::DataTable> data_table(
+      ExecutorTestsUtil::CreateAndPopulateTable());
+
+  IndexOnlyScan(data_table.get(), 12);
+}
+
+// Index only scan after an update of a key was rolled back.
+TEST(IndexScanTests, IndexOnlyScanAbortTest) {
+  std::unique_ptr<storage::DataTable> data_table(
+      ExecutorTestsUtil::CreateAndPopulateTable());
+
+  // Move the first tuple to another key within the range, and roll back
+  auto &txn_manager = concurrency::TransactionManager::GetInstance();
+  auto txn = txn_manager.BeginTransaction();
+  ItemPointer location(data_table->GetTileGroup(0)->GetTileGroupId(), 0);
+  txn->RecordUpdate(location);
+  EXPECT_TRUE(data_table->UpdateTuple(txn, location, {0},
+                                      {ValueFactory::GetIntegerValue(5)}));
+  txn_manager.AbortTransaction();
+
+  // The entry of the new key is gone with the update
+  IndexOnlyScan(data_table.get(), 12);
+}
+
+// Index scan over a key updated in place, whose entries are in the first and
+// the last batch.
+TEST(IndexScanTests, UpdatedKeyScanTest) {
+  const int tuple_count = 200;
+  std::unique_ptr<storage::DataTable> data_table(
+      ExecutorTestsUtil::CreateTable(TESTS_TUPLES_PER_TILEGROUP));
+
+  auto &txn_manager = concurrency::TransactionManager::GetInstance();
+  auto txn = txn_manager.BeginTransaction();
+  ExecutorTestsUtil::PopulateTable(txn, data_table.get(), tuple_count, false,
+                                   false, false);
+  txn_manager.CommitTransaction();
+
+  // Move the first tuple past the other keys
+  txn = txn_manager.BeginTransaction();
+  ItemPointer location(data_table->GetTileGroup(0)->GetTileGroupId(), 0);
+  txn->RecordUpdate(location);
+  EXPECT_TRUE(data_table->UpdateTuple(txn, location, {0},
+                                      {ValueFactory::GetIntegerValue(100000)}));
+  txn_manager.CommitTransaction();
+
+  // ATTR 0 >= 0, reading the table and only the index
+  std::vector<std::vector<oid_t>> scan_column_ids = {{0, 2}, {0, 1}};
+  for (auto &column_ids : scan_column_ids) {
+    auto index = data_table->GetIndex(1);
+    std::vector<oid_t> key_column_ids({0});
+    std::vector<ExpressionType> expr_types(
+        {ExpressionType::EXPRESSION_TYPE_COMPARE_GREATERTHANOREQUALTO});
+    std::vector<Value> values({ValueFactory::GetIntegerValue(0)});
+    std::vector<expression::AbstractExpression *> runtime_keys;
+
+    planner::IndexScanPlan::IndexScanDesc index_scan_desc(
+        index, key_column_ids, expr_types, values, runtime_keys);
+    planner::IndexScanPlan node(data_table.get(), nullptr, column_ids,
+                                index_scan_desc);
+
+    txn = txn_manager.BeginTransaction();
+    std::unique_ptr<executor::ExecutorContext> context(
+        new executor::ExecutorContext(txn));
+    executor::IndexScanExecutor executor(&node, context.get());
+    EXPECT_TRUE(executor.Init());
+
+    // Every tuple once
+    std::set<int32_t> keys;
+    size_t result_tuple_count = 0;
+    while (executor.Execute()) {
+      std::unique_ptr<executor::LogicalTile> result_tile(executor.GetOutput());
+      for (oid_t tuple_id : *result_tile) {
+        keys.insert(
+            ValuePeeker::PeekInteger(result_tile->GetValue(tuple_id, 0)));
+        result_tuple_count++;
+      }
+    }
+
+    EXPECT_EQ(tuple_count, result_tuple_count);
+    EXPECT_EQ(tuple_count, keys.size());
+    EXPECT_EQ(0, keys.count(0));
+    EXPECT_EQ(1, keys.count(100000));
+
+    txn_manager.CommitTransaction();
+  }
+}
+
 }  // namespace test
 }  // namespace peloton
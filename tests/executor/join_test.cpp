@@ -23,8 +23,12 @@
 #include "backend/executor/hash_executor.h"
 #include "backend/executor/merge_join_executor.h"
 #include "backend/executor/nested_loop_join_executor.h"
+#include "backend/executor/nested_loop_index_join_executor.h"
+#include "backend/executor/seq_scan_executor.h"
+#include "backend/executor/executor_context.h"
 
 #include "backend/expression/abstract_expression.h"
+#include "backend/expression/container_tuple.h"
 #include "backend/expression/tuple_value_expression.h"
 #include "backend/expression/expression_util.h"
 
@@ -32,6 +36,10 @@
 #include "backend/planner/hash_plan.h"
 #include "backend/planner/merge_join_plan.h"
 #include "backend/planner/nested_loop_join_plan.h"
+#include "backend/planner/nested_loop_index_join_plan.h"
+#include "backend/planner/seq_scan_plan.h"
+
+#include "backend/index/index_factory.h"
 
 #include "backend/storage/data_table.h"
 #include "backend/storage/tile.h"
@@ -41,6 +49,7 @@
 #include "executor/join_tests_util.h"
 #include "harness.h"
 
+using ::testing::Invoke;
 using ::testing::NotNull;
 using ::testing::Return;
 
@@ -59,8 +68,7 @@ std::vector<planner::MergeJoinPlan::JoinClause> CreateJoinClauses() {
 std::vector<PlanNodeType> join_algorithms = {
     PLAN_NODE_TYPE_NESTLOOP,
     PLAN_NODE_TYPE_MERGEJOIN,
-// TODO: Uncomment this
-//    PLAN_NODE_TYPE_HASHJOIN
+    PLAN_NODE_TYPE_HASHJOIN
 };
 
 std::vector<PelotonJoinType> join_types = {
@@ -106,6 +114,15 @@ TEST(JoinTests, JoinPredicateTest) {
 
 }
 
+TEST(JoinTests, HashSemiJoinTest) {
+  // Only the hash join runs semi and anti joins
+  for (auto join_type : {JOIN_TYPE_SEMI, JOIN_TYPE_ANTI}) {
+    std::cout << "JOIN TYPE :: " << join_type << "\n";
+
+    ExecuteJoinTest(PLAN_NODE_TYPE_HASHJOIN, join_type, BASIC_TEST);
+  }
+}
+
 void ExecuteJoinTest(PlanNodeType join_algorithm, PelotonJoinType join_type, oid_t join_test_type) {
   //===--------------------------------------------------------------------===//
   // Mock table scan executors
@@ -300,9 +317,16 @@ void ExecuteJoinTest(PlanNodeType join_algorithm, PelotonJoinType join_type, oid
       // Construct the hash executor
       executor::HashExecutor hash_executor(&hash_plan_node, nullptr);
 
+      expression::AbstractExpression *left_table_attr_1 =
+          new expression::TupleValueExpression(0, 1);
+
+      std::vector<std::unique_ptr<const expression::AbstractExpression> >
+          outer_hash_keys;
+      outer_hash_keys.emplace_back(left_table_attr_1);
+
       // Create hash join plan node.
       planner::HashJoinPlan hash_join_plan_node(join_type, predicate,
-                                                projection);
+                                                projection, outer_hash_keys);
 
       // Construct the hash join executor
       executor::HashJoinExecutor hash_join_executor(&hash_join_plan_node,
@@ -364,6 +388,16 @@ void ExecuteJoinTest(PlanNodeType join_algorithm, PelotonJoinType join_type, oid
         EXPECT_EQ(tuples_with_null, 5);
         break;
 
+      case JOIN_TYPE_SEMI:
+        EXPECT_EQ(result_tuple_count, 10);
+        EXPECT_EQ(tuples_with_null, 10);
+        break;
+
+      case JOIN_TYPE_ANTI:
+        EXPECT_EQ(result_tuple_count, 5);
+        EXPECT_EQ(tuples_with_null, 5);
+        break;
+
       default:
         throw Exception("Unsupported join type : " + std::to_string(join_type));
         break;
@@ -373,6 +407,320 @@ void ExecuteJoinTest(PlanNodeType join_algorithm, PelotonJoinType join_type, oid
 
 }
 
+TEST(JoinTests, HashJoinPartitionTest) {
+  // The hash table over this many rows does not fit in one partition
+  size_t tuple_count = 20000;
+
+  for (auto join_type : {JOIN_TYPE_INNER, JOIN_TYPE_LEFT}) {
+    MockExecutor left_table_scan_executor, right_table_scan_executor;
+
+    auto &txn_manager = concurrency::TransactionManager::GetInstance();
+    auto txn = txn_manager.BeginTransaction();
+    auto txn_id = txn->GetTransactionId();
+
+    std::unique_ptr<storage::DataTable> left_table(
+        ExecutorTestsUtil::CreateTable(tuple_count, false));
+    ExecutorTestsUtil::PopulateTable(txn, left_table.get(), tuple_count,
+                                     false, false, false);
+
+    // Every third left row has a match
+    std::unique_ptr<storage::DataTable> right_table(
+        ExecutorTestsUtil::CreateTable(tuple_count, false));
+    ExecutorTestsUtil::PopulateTable(txn, right_table.get(), tuple_count, true,
+                                     false, false);
+
+    txn_manager.CommitTransaction();
+
+    EXPECT_CALL(left_table_scan_executor, DInit()).WillOnce(Return(true));
+    EXPECT_CALL(left_table_scan_executor, DExecute())
+        .WillOnce(Return(true))
+        .WillOnce(Return(false));
+    EXPECT_CALL(left_table_scan_executor, GetOutput())
+        .WillOnce(Return(executor::LogicalTileFactory::WrapTileGroup(
+            left_table->GetTileGroup(0), txn_id)));
+
+    EXPECT_CALL(right_table_scan_executor, DInit()).WillOnce(Return(true));
+    EXPECT_CALL(right_table_scan_executor, DExecute())
+        .WillOnce(Return(true))
+        .WillOnce(Return(false));
+    EXPECT_CALL(right_table_scan_executor, GetOutput())
+        .WillOnce(Return(executor::LogicalTileFactory::WrapTileGroup(
+            right_table->GetTileGroup(0), txn_id)));
+
+    std::vector<std::unique_ptr<const expression::AbstractExpression> >
+        hash_keys;
+    hash_keys.emplace_back(new expression::TupleValueExpression(1, 1));
+    planner::HashPlan hash_plan_node(hash_keys);
+    executor::HashExecutor hash_executor(&hash_plan_node, nullptr);
+
+    std::vector<std::unique_ptr<const expression::AbstractExpression> >
+        outer_hash_keys;
+    outer_hash_keys.emplace_back(new expression::TupleValueExpression(0, 1));
+    planner::HashJoinPlan hash_join_plan_node(
+        join_type, JoinTestsUtil::CreateJoinPredicate(),
+        JoinTestsUtil::CreateProjection(), outer_hash_keys);
+    executor::HashJoinExecutor hash_join_executor(&hash_join_plan_node,
+                                                  nullptr);
+
+    hash_join_executor.AddChild(&left_table_scan_executor);
+    hash_join_executor.AddChild(&hash_executor);
+    hash_executor.AddChild(&right_table_scan_executor);
+
+    oid_t result_tuple_count = 0;
+    oid_t tuples_with_null = 0;
+
+    EXPECT_TRUE(hash_join_executor.Init());
+    while (hash_join_executor.Execute() == true) {
+      std::unique_ptr<executor::LogicalTile> result_logical_tile(
+          hash_join_executor.GetOutput());
+      result_tuple_count += result_logical_tile->GetTupleCount();
+      tuples_with_null += CountTuplesWithNullFields(result_logical_tile.get());
+    }
+
+    EXPECT_GT(hash_executor.GetHashTable().GetPartitionCount(), 1);
+
+    size_t match_count = (tuple_count + 2) / 3;
+    if (join_type == JOIN_TYPE_INNER) {
+      EXPECT_EQ(result_tuple_count, match_count);
+      EXPECT_EQ(tuples_with_null, 0);
+    } else {
+      EXPECT_EQ(result_tuple_count, tuple_count);
+      EXPECT_EQ(tuples_with_null, tuple_count - match_count);
+    }
+  }
+}
+
+void ExecuteHashJoinEmptyInputTest(PelotonJoinType join_type,
+                                   bool left_empty) {
+  MockExecutor table_scan_executor;
+
+  size_t tile_group_size = TESTS_TUPLES_PER_TILEGROUP;
+  size_t tile_group_count = left_empty ? 2 : 3;
+
+  auto &txn_manager = concurrency::TransactionManager::GetInstance();
+  auto txn = txn_manager.BeginTransaction();
+  auto txn_id = txn->GetTransactionId();
+
+  std::unique_ptr<storage::DataTable> table(
+      ExecutorTestsUtil::CreateTable(tile_group_size));
+  ExecutorTestsUtil::PopulateTable(txn, table.get(),
+                                   tile_group_size * tile_group_count, false,
+                                   false, false);
+
+  // The other input scans a table without rows
+  std::unique_ptr<storage::DataTable> empty_table(
+      ExecutorTestsUtil::CreateTable(tile_group_size));
+
+  txn_manager.CommitTransaction();
+
+  // The join does not read the other input if it cannot return a row
+  std::vector<std::unique_ptr<executor::LogicalTile>> table_tiles;
+  for (size_t tile_group_itr = 0; tile_group_itr < tile_group_count;
+       tile_group_itr++) {
+    table_tiles.emplace_back(executor::LogicalTileFactory::WrapTileGroup(
+        table->GetTileGroup(tile_group_itr), txn_id));
+  }
+  size_t table_tile_itr = 0;
+
+  EXPECT_CALL(table_scan_executor, DInit()).WillOnce(Return(true));
+  EXPECT_CALL(table_scan_executor, DExecute())
+      .WillRepeatedly(Invoke([&]() -> bool {
+        return table_tile_itr < table_tiles.size();
+      }));
+  EXPECT_CALL(table_scan_executor, GetOutput())
+      .WillRepeatedly(Invoke([&]() -> executor::LogicalTile *{
+        return table_tiles[table_tile_itr++].release();
+      }));
+
+  txn = txn_manager.BeginTransaction();
+  std::unique_ptr<executor::ExecutorContext> context(
+      new executor::ExecutorContext(txn));
+
+  std::vector<oid_t> column_ids = {0, 1, 2, 3};
+  planner::SeqScanPlan empty_scan_node(empty_table.get(), nullptr,
+                                       column_ids);
+  executor::SeqScanExecutor empty_scan_executor(&empty_scan_node,
+                                                context.get());
+
+  std::vector<std::unique_ptr<const expression::AbstractExpression> >
+      hash_keys;
+  hash_keys.emplace_back(new expression::TupleValueExpression(1, 1));
+  planner::HashPlan hash_plan_node(hash_keys);
+  executor::HashExecutor hash_executor(&hash_plan_node, context.get());
+
+  std::vector<std::unique_ptr<const expression::AbstractExpression> >
+      outer_hash_keys;
+  outer_hash_keys.emplace_back(new expression::TupleValueExpression(0, 1));
+  planner::HashJoinPlan hash_join_plan_node(
+      join_type, JoinTestsUtil::CreateJoinPredicate(),
+      JoinTestsUtil::CreateProjection(), outer_hash_keys);
+  executor::HashJoinExecutor hash_join_executor(&hash_join_plan_node,
+                                                context.get());
+
+  if (left_empty) {
+    hash_join_executor.AddChild(&empty_scan_executor);
+    hash_join_executor.AddChild(&hash_executor);
+    hash_executor.AddChild(&table_scan_executor);
+  } else {
+    hash_join_executor.AddChild(&table_scan_executor);
+    hash_join_executor.AddChild(&hash_executor);
+    hash_executor.AddChild(&empty_scan_executor);
+  }
+
+  oid_t result_tuple_count = 0;
+  oid_t tuples_with_null = 0;
+
+  EXPECT_TRUE(hash_join_executor.Init());
+  while (hash_join_executor.Execute() == true) {
+    std::unique_ptr<executor::LogicalTile> result_logical_tile(
+        hash_join_executor.GetOutput());
+    result_tuple_count += result_logical_tile->GetTupleCount();
+    tuples_with_null += CountTuplesWithNullFields(result_logical_tile.get());
+  }
+
+  txn_manager.AbortTransaction();
+
+  // Every row of the other input is returned without a match, or none is
+  bool padded;
+  if (left_empty) {
+    padded = (join_type == JOIN_TYPE_RIGHT || join_type == JOIN_TYPE_OUTER);
+  } else {
+    padded = (join_type == JOIN_TYPE_LEFT || join_type == JOIN_TYPE_OUTER ||
+              join_type == JOIN_TYPE_ANTI);
+  }
+
+  oid_t expected_tuple_count =
+      padded ? tile_group_size * tile_group_count : 0;
+  EXPECT_EQ(result_tuple_count, expected_tuple_count);
+  EXPECT_EQ(tuples_with_null, expected_tuple_count);
+}
+
+TEST(JoinTests, HashJoinEmptyInputTest) {
+  for (auto join_type : {JOIN_TYPE_INNER, JOIN_TYPE_LEFT, JOIN_TYPE_RIGHT,
+                         JOIN_TYPE_OUTER, JOIN_TYPE_SEMI, JOIN_TYPE_ANTI}) {
+    std::cout << "JOIN TYPE :: " << join_type << "\n";
+
+    ExecuteHashJoinEmptyInputTest(join_type, true);
+    ExecuteHashJoinEmptyInputTest(join_type, false);
+  }
+}
+
+void ExecuteIndexJoinTest(IndexType index_type, PelotonJoinType join_type) {
+  MockExecutor left_table_scan_executor;
+
+  size_t tile_group_size = TESTS_TUPLES_PER_TILEGROUP;
+  size_t left_table_tile_group_count = 3;
+  size_t right_table_tile_group_count = 2;
+
+  auto &txn_manager = concurrency::TransactionManager::GetInstance();
+  auto txn = txn_manager.BeginTransaction();
+  auto txn_id = txn->GetTransactionId();
+
+  std::unique_ptr<storage::DataTable> left_table(
+      ExecutorTestsUtil::CreateTable(tile_group_size));
+  ExecutorTestsUtil::PopulateTable(
+      txn, left_table.get(), tile_group_size * left_table_tile_group_count,
+      false, false, false);
+
+  std::unique_ptr<storage::DataTable> right_table(
+      ExecutorTestsUtil::CreateTable(tile_group_size));
+  ExecutorTestsUtil::PopulateTable(
+      txn, right_table.get(), tile_group_size * right_table_tile_group_count,
+      false, false, false);
+
+  txn_manager.CommitTransaction();
+
+  // Index the join column of the right table
+  auto tuple_schema = right_table->GetSchema();
+  std::vector<oid_t> key_attrs = {1};
+  auto key_schema = catalog::Schema::CopySchema(tuple_schema, key_attrs);
+  key_schema->SetIndexedColumns(key_attrs);
+  auto index_metadata = new index::IndexMetadata(
+      "join_index", 125, index_type, INDEX_CONSTRAINT_TYPE_DEFAULT,
+      tuple_schema, key_schema, false);
+  index::Index *right_index = index::IndexFactory::GetInstance(index_metadata);
+  right_table->AddIndex(right_index);
+
+  std::unique_ptr<executor::LogicalTile> left_table_logical_tile1(
+      executor::LogicalTileFactory::WrapTileGroup(left_table->GetTileGroup(0),
+                                                  txn_id));
+  std::unique_ptr<executor::LogicalTile> left_table_logical_tile2(
+      executor::LogicalTileFactory::WrapTileGroup(left_table->GetTileGroup(1),
+                                                  txn_id));
+  std::unique_ptr<executor::LogicalTile> left_table_logical_tile3(
+      executor::LogicalTileFactory::WrapTileGroup(left_table->GetTileGroup(2),
+                                                  txn_id));
+
+  EXPECT_CALL(left_table_scan_executor, DInit()).WillOnce(Return(true));
+
+  EXPECT_CALL(left_table_scan_executor, DExecute())
+      .WillOnce(Return(true))
+      .WillOnce(Return(true))
+      .WillOnce(Return(true))
+      .WillOnce(Return(false));
+
+  EXPECT_CALL(left_table_scan_executor, GetOutput())
+      .WillOnce(Return(left_table_logical_tile1.release()))
+      .WillOnce(Return(left_table_logical_tile2.release()))
+      .WillOnce(Return(left_table_logical_tile3.release()));
+
+  // Look up the second column of the left rows in the index
+  std::vector<oid_t> outer_key_column_ids = {1};
+  std::vector<oid_t> inner_column_ids = {0, 1, 2, 3};
+  planner::NestedLoopIndexJoinPlan index_join_node(
+      join_type, JoinTestsUtil::CreateJoinPredicate(),
+      JoinTestsUtil::CreateProjection(), right_table.get(), right_index,
+      outer_key_column_ids, inner_column_ids);
+
+  txn = txn_manager.BeginTransaction();
+  std::unique_ptr<executor::ExecutorContext> context(
+      new executor::ExecutorContext(txn));
+
+  executor::NestedLoopIndexJoinExecutor index_join_executor(&index_join_node,
+                                                            context.get());
+  index_join_executor.AddChild(&left_table_scan_executor);
+
+  oid_t result_tuple_count = 0;
+  oid_t tuples_with_null = 0;
+
+  EXPECT_TRUE(index_join_executor.Init());
+  while (index_join_executor.Execute() == true) {
+    std::unique_ptr<executor::LogicalTile> result_logical_tile(
+        index_join_executor.GetOutput());
+
+    if (result_logical_tile != nullptr) {
+      result_tuple_count += result_logical_tile->GetTupleCount();
+      tuples_with_null += CountTuplesWithNullFields(result_logical_tile.get());
+    }
+  }
+
+  txn_manager.CommitTransaction();
+
+  switch (join_type) {
+    case JOIN_TYPE_INNER:
+      EXPECT_EQ(result_tuple_count, 10);
+      EXPECT_EQ(tuples_with_null, 0);
+      break;
+
+    case JOIN_TYPE_LEFT:
+      EXPECT_EQ(result_tuple_count, 15);
+      EXPECT_EQ(tuples_with_null, 5);
+      break;
+
+    default:
+      throw Exception("Unsupported join type : " + std::to_string(join_type));
+      break;
+  }
+}
+
+TEST(JoinTests, IndexJoinTest) {
+  for (auto index_type : {INDEX_TYPE_BTREE, INDEX_TYPE_OLCBTREE,
+                          INDEX_TYPE_HASH}) {
+    ExecuteIndexJoinTest(index_type, JOIN_TYPE_INNER);
+    ExecuteIndexJoinTest(index_type, JOIN_TYPE_LEFT);
+  }
+}
+
 oid_t CountTuplesWithNullFields(executor::LogicalTile *logical_tile) {
   assert(logical_tile);
 
@@ -165,5 +165,122 @@ TEST(MaterializationTests, TwoBaseTilesWithReorderTest) {
   }
 }
 
+// A temporary tile that the materialization created is passed through as it
+// is, it already has the layout of the output.
+TEST(MaterializationTests, PhysicalTilePassThroughTest) {
+  const int tuple_count = 9;
+  std::shared_ptr<storage::TileGroup> tile_group(
+      ExecutorTestsUtil::CreateTileGroup(tuple_count));
+
+  ExecutorTestsUtil::PopulateTiles(tile_group, tuple_count);
+
+  const std::vector<std::shared_ptr<storage::Tile> > source_base_tiles = {
+      tile_group->GetTileReference(0), tile_group->GetTileReference(1)};
+  std::unique_ptr<executor::LogicalTile> source_logical_tile(
+      executor::LogicalTileFactory::WrapTiles(source_base_tiles));
+
+  executor::MaterializationExecutor executor(nullptr, nullptr);
+  std::unique_ptr<executor::LogicalTile> physical_logical_tile(
+      ExecutorTestsUtil::ExecuteTile(&executor, source_logical_tile.release()));
+  storage::Tile *physical_base_tile = physical_logical_tile->GetBaseTile(0);
+
+  executor::MaterializationExecutor next_executor(nullptr, nullptr);
+  std::unique_ptr<executor::LogicalTile> result_logical_tile(
+      ExecutorTestsUtil::ExecuteTile(&next_executor,
+                                     physical_logical_tile.release()));
+
+  EXPECT_EQ(4, result_logical_tile->GetColumnCount());
+  for (oid_t column_itr = 0; column_itr < 4; column_itr++) {
+    EXPECT_EQ(physical_base_tile, result_logical_tile->GetBaseTile(column_itr));
+  }
+  for (int i = 0; i < tuple_count; i++) {
+    EXPECT_EQ(
+        ValueFactory::GetIntegerValue(ExecutorTestsUtil::PopulatedValue(i, 0)),
+        result_logical_tile->GetValue(i, 0));
+  }
+}
+
+// Materializing the visible rows of a large logical tile, whose columns are
+// copied in different ways: runs of bytes, a pass over the rows for all of
+// the columns of a tile, and a pass over the rows for every column.
+TEST(MaterializationTests, SparseLogicalTileTest) {
+  const int tuple_count = 40000;
+  std::shared_ptr<storage::TileGroup> tile_group(
+      ExecutorTestsUtil::CreateTileGroup(tuple_count));
+
+  ExecutorTestsUtil::PopulateTiles(tile_group, tuple_count);
+
+  const std::vector<std::shared_ptr<storage::Tile> > source_base_tiles = {
+      tile_group->GetTileReference(0), tile_group->GetTileReference(1)};
+
+  // Columns as they are, and reordered with the string
+  const std::vector<std::vector<oid_t> > output_column_lists = {{0, 1, 2},
+                                                                {1, 0, 3}};
+
+  for (auto &output_column_list : output_column_lists) {
+    std::unique_ptr<executor::LogicalTile> source_logical_tile(
+        executor::LogicalTileFactory::WrapTiles(source_base_tiles));
+
+    // Leave out every third row
+    for (int i = 1; i < tuple_count; i += 3) {
+      source_logical_tile->RemoveVisibility(i);
+    }
+
+    std::vector<catalog::Column> output_columns;
+    std::unordered_map<oid_t, oid_t> old_to_new_cols;
+    for (oid_t new_column_id = 0; new_column_id < output_column_list.size();
+         new_column_id++) {
+      oid_t old_column_id = output_column_list[new_column_id];
+      output_columns.push_back(
+          ExecutorTestsUtil::GetColumnInfo(old_column_id));
+      old_to_new_cols[old_column_id] = new_column_id;
+    }
+    std::unique_ptr<catalog::Schema> output_schema(
+        new catalog::Schema(output_columns));
+
+    bool physify_flag = true;  // is going to create a physical tile
+    planner::MaterializationPlan node(old_to_new_cols, output_schema.release(),
+                                      physify_flag);
+
+    executor::MaterializationExecutor executor(&node, nullptr);
+    std::unique_ptr<executor::LogicalTile> result_logical_tile(
+        ExecutorTestsUtil::ExecuteTile(&executor,
+                                       source_logical_tile.release()));
+
+    storage::Tile *result_base_tile = result_logical_tile->GetBaseTile(0);
+    EXPECT_EQ(tuple_count - tuple_count / 3,
+              result_base_tile->GetAllocatedTupleCount());
+
+    oid_t new_tuple_id = 0;
+    for (int i = 0; i < tuple_count; i++) {
+      if (i % 3 == 1) continue;
+
+      for (oid_t new_column_id = 0; new_column_id < output_column_list.size();
+           new_column_id++) {
+        oid_t old_column_id = output_column_list[new_column_id];
+        int populated_value =
+            ExecutorTestsUtil::PopulatedValue(i, old_column_id);
+
+        Value expected_value;
+        switch (old_column_id) {
+          case 2:
+            expected_value = ValueFactory::GetDoubleValue(populated_value);
+            break;
+          case 3:
+            expected_value =
+                ValueFactory::GetStringValue(std::to_string(populated_value));
+            break;
+          default:
+            expected_value = ValueFactory::GetIntegerValue(populated_value);
+        }
+
+        EXPECT_EQ(expected_value,
+                  result_base_tile->GetValue(new_tuple_id, new_column_id));
+      }
+      new_tuple_id++;
+    }
+  }
+}
+
 }  // namespace test
 }  // namespace peloton
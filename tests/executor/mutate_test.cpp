@@ -10,8 +10,11 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include <condition_variable>
 #include <memory>
+#include <mutex>
 #include <string>
+#include <thread>
 #include <utility>
 #include <vector>
 
@@ -20,10 +23,12 @@
 
 #include "backend/catalog/schema.h"
 #include "backend/common/value_factory.h"
+#include "backend/common/value_peeker.h"
 #include "backend/common/pool.h"
 
 #include "backend/executor/executor_context.h"
 #include "backend/executor/delete_executor.h"
+#include "backend/executor/index_scan_executor.h"
 #include "backend/executor/insert_executor.h"
 #include "backend/executor/seq_scan_executor.h"
 #include "backend/executor/update_executor.h"
@@ -32,6 +37,7 @@
 #include "backend/expression/tuple_value_expression.h"
 #include "backend/expression/comparison_expression.h"
 #include "backend/expression/abstract_expression.h"
+#include "backend/index/index.h"
 #include "backend/storage/tile.h"
 #include "backend/storage/tile_group.h"
 #include "backend/storage/table_factory.h"
@@ -42,6 +48,7 @@
 
 #include <atomic>
 #include "backend/planner/delete_plan.h"
+#include "backend/planner/index_scan_plan.h"
 #include "backend/planner/insert_plan.h"
 #include "backend/planner/seq_scan_plan.h"
 #include "backend/planner/update_plan.h"
@@ -344,5 +351,450 @@ TEST(MutateTests, InsertTest) {
   EXPECT_EQ(dest_data_table->GetTileGroupCount(), 1);
 }
 
+void UpdateTupleInPlace(storage::DataTable *table, double update_val,
+                        bool commit) {
+  auto &txn_manager = concurrency::TransactionManager::GetInstance();
+  auto txn = txn_manager.BeginTransaction();
+  std::unique_ptr<executor::ExecutorContext> context(
+      new executor::ExecutorContext(txn));
+
+  // Update the columns that are not indexed
+  planner::ProjectInfo::TargetList target_list;
+  planner::ProjectInfo::DirectMapList direct_map_list;
+  target_list.emplace_back(
+      2, expression::ConstantValueFactory(
+             ValueFactory::GetDoubleValue(update_val)));
+  target_list.emplace_back(
+      3, expression::ConstantValueFactory(
+             ValueFactory::GetStringValue(std::to_string(update_val))));
+  direct_map_list.emplace_back(0, std::pair<oid_t, oid_t>(0, 0));
+  direct_map_list.emplace_back(1, std::pair<oid_t, oid_t>(0, 1));
+
+  planner::UpdatePlan update_node(
+      table, new planner::ProjectInfo(std::move(target_list),
+                                      std::move(direct_map_list)));
+  executor::UpdateExecutor update_executor(&update_node, context.get());
+
+  // WHERE ATTR_0 < 50, i.e. the first tile group
+  expression::TupleValueExpression *tup_val_exp =
+      new expression::TupleValueExpression(0, 0);
+  expression::ConstantValueExpression *const_val_exp =
+      new expression::ConstantValueExpression(
+          ValueFactory::GetIntegerValue(50));
+  auto predicate = new expression::ComparisonExpression<expression::CmpLt>(
+      EXPRESSION_TYPE_COMPARE_LESSTHAN, tup_val_exp, const_val_exp);
+
+  std::vector<oid_t> column_ids = {0};
+  planner::SeqScanPlan seq_scan_node(table, predicate, column_ids);
+  executor::SeqScanExecutor seq_scan_executor(&seq_scan_node, context.get());
+
+  update_node.AddChild(&seq_scan_node);
+  update_executor.AddChild(&seq_scan_executor);
+
+  EXPECT_TRUE(update_executor.Init());
+  EXPECT_TRUE(update_executor.Execute());
+  EXPECT_EQ(context->num_processed, TESTS_TUPLES_PER_TILEGROUP);
+
+  if (commit)
+    txn_manager.CommitTransaction();
+  else
+    txn_manager.AbortTransaction();
+}
+
+// Update tuples in place and read the older versions from the delta chain
+TEST(MutateTests, InPlaceUpdateTest) {
+  auto &txn_manager = concurrency::TransactionManager::GetInstance();
+  std::unique_ptr<storage::DataTable> table(
+      ExecutorTestsUtil::CreateAndPopulateTable());
+  auto tile_group = table->GetTileGroup(0);
+  auto next_tuple_slot = tile_group->GetNextTupleSlot();
+
+  // Snapshot before the update
+  auto txn = txn_manager.BeginTransaction();
+  auto snapshot_txn_id = txn->GetTransactionId();
+  auto snapshot_cid = txn->GetLastCommitId();
+  txn_manager.CommitTransaction();
+
+  UpdateTupleInPlace(table.get(), 23.5, true);
+
+  // The tuples are overwritten in their slots
+  EXPECT_EQ(tile_group->GetNextTupleSlot(), next_tuple_slot);
+  for (oid_t tuple_id = 0; tuple_id < TESTS_TUPLES_PER_TILEGROUP;
+       tuple_id++) {
+    EXPECT_EQ(tile_group->GetValue(tuple_id, 2),
+              ValueFactory::GetDoubleValue(23.5));
+
+    // The older snapshot still sees the old values
+    storage::Tuple old_tuple(table->GetSchema(), true);
+    EXPECT_TRUE(tile_group->GetVisibleVersion(tuple_id, snapshot_txn_id,
+                                              snapshot_cid, &old_tuple));
+    EXPECT_EQ(old_tuple.GetValue(2),
+              ValueFactory::GetDoubleValue(
+                  ExecutorTestsUtil::PopulatedValue(tuple_id, 2)));
+    EXPECT_EQ(old_tuple.GetValue(3),
+              ValueFactory::GetStringValue(std::to_string(
+                  ExecutorTestsUtil::PopulatedValue(tuple_id, 3))));
+  }
+
+  // The update is rolled back on abort
+  UpdateTupleInPlace(table.get(), 42.5, false);
+
+  EXPECT_EQ(tile_group->GetNextTupleSlot(), next_tuple_slot);
+  for (oid_t tuple_id = 0; tuple_id < TESTS_TUPLES_PER_TILEGROUP;
+       tuple_id++) {
+    EXPECT_EQ(tile_group->GetValue(tuple_id, 2),
+              ValueFactory::GetDoubleValue(23.5));
+    EXPECT_EQ(tile_group->GetValue(tuple_id, 3),
+              ValueFactory::GetStringValue(std::to_string(23.5)));
+  }
+}
+
+// Readers copying an updated tuple never see a half-written version
+TEST(MutateTests, InPlaceUpdateReadTest) {
+  std::unique_ptr<storage::DataTable> table(
+      ExecutorTestsUtil::CreateAndPopulateTable());
+  auto tile_group = table->GetTileGroup(0);
+  const int update_count = 200;
+  std::atomic<bool> done(false);
+
+  // Both updated columns always hold the same number
+  std::thread reader([&]() {
+    auto &txn_manager = concurrency::TransactionManager::GetInstance();
+    while (done == false) {
+      auto txn = txn_manager.BeginTransaction();
+      storage::Tuple tuple(table->GetSchema(), true);
+      EXPECT_TRUE(tile_group->CopyVisibleVersion(
+          0, txn->GetTransactionId(), txn->GetLastCommitId(), &tuple));
+      auto number = ValuePeeker::PeekDouble(tuple.GetValue(2));
+      if (number != ExecutorTestsUtil::PopulatedValue(0, 2)) {
+        EXPECT_EQ(tuple.GetValue(3),
+                  ValueFactory::GetStringValue(std::to_string(number)));
+      }
+
+      // Read-only, it need not take a commit id the writer would wait for
+      txn_manager.AbortTransaction();
+    }
+  });
+
+  for (int update_itr = 0; update_itr < update_count; update_itr++) {
+    UpdateTupleInPlace(table.get(), update_itr + 0.5, update_itr % 2 == 0);
+  }
+
+  done = true;
+  reader.join();
+}
+
+// Tuples returned by a scan keep their values when updated in place later
+TEST(MutateTests, InPlaceUpdateScanTest) {
+  auto &txn_manager = concurrency::TransactionManager::GetInstance();
+  std::unique_ptr<storage::DataTable> table(
+      ExecutorTestsUtil::CreateAndPopulateTable());
+  auto tile_group = table->GetTileGroup(0);
+
+  auto txn = txn_manager.BeginTransaction();
+  std::unique_ptr<executor::ExecutorContext> context(
+      new executor::ExecutorContext(txn));
+
+  std::vector<oid_t> column_ids = {0, 2};
+  planner::SeqScanPlan seq_scan_node(table.get(), nullptr, column_ids);
+  executor::SeqScanExecutor seq_scan_executor(&seq_scan_node, context.get());
+
+  EXPECT_TRUE(seq_scan_executor.Init());
+  EXPECT_TRUE(seq_scan_executor.Execute());
+  std::unique_ptr<executor::LogicalTile> result_tile(
+      seq_scan_executor.GetOutput());
+  ASSERT_EQ(TESTS_TUPLES_PER_TILEGROUP, result_tile->GetTupleCount());
+
+  // Another transaction updates the first tuple and keeps it uncommitted
+  std::mutex update_mutex;
+  std::condition_variable update_cv;
+  bool updated = false, released = false;
+  std::thread writer([&]() {
+    auto writer_txn = txn_manager.BeginTransaction();
+    auto writer_txn_id = writer_txn->GetTransactionId();
+    auto writer_cid = writer_txn->GetLastCommitId();
+    EXPECT_TRUE(tile_group->UpdateTuple(
+        writer_txn_id, 0, writer_cid, {2}, {ValueFactory::GetDoubleValue(42.5)},
+        nullptr));
+
+    std::unique_lock<std::mutex> lock(update_mutex);
+    updated = true;
+    update_cv.notify_all();
+    update_cv.wait(lock, [&]() { return released; });
+
+    tile_group->AbortUpdatedTuple(0, writer_txn_id, writer_cid);
+    txn_manager.AbortTransaction();
+  });
+
+  {
+    std::unique_lock<std::mutex> lock(update_mutex);
+    update_cv.wait(lock, [&]() { return updated; });
+  }
+  EXPECT_EQ(tile_group->GetValue(0, 2), ValueFactory::GetDoubleValue(42.5));
+
+  // The scan does not see the uncommitted values
+  for (oid_t tuple_id : *result_tile) {
+    EXPECT_EQ(ValueFactory::GetIntegerValue(
+                  ExecutorTestsUtil::PopulatedValue(tuple_id, 0)),
+              result_tile->GetValue(tuple_id, 0));
+    EXPECT_EQ(ValueFactory::GetDoubleValue(
+                  ExecutorTestsUtil::PopulatedValue(tuple_id, 2)),
+              result_tile->GetValue(tuple_id, 1));
+  }
+
+  {
+    std::unique_lock<std::mutex> lock(update_mutex);
+    released = true;
+    update_cv.notify_all();
+  }
+  writer.join();
+
+  txn_manager.CommitTransaction();
+}
+
+// The deltas no transaction can see anymore are freed on commit
+TEST(MutateTests, InPlaceUpdateGarbageTest) {
+  std::unique_ptr<storage::DataTable> table(
+      ExecutorTestsUtil::CreateAndPopulateTable());
+  auto delta_store = table->GetTileGroup(0)->GetDeltaStore();
+
+  // An older snapshot keeps the deltas it might read
+  std::mutex snapshot_mutex;
+  std::condition_variable snapshot_cv;
+  bool snapshot_taken = false, snapshot_released = false;
+  std::thread snapshot([&]() {
+    auto &txn_manager = concurrency::TransactionManager::GetInstance();
+    txn_manager.BeginTransaction();
+
+    std::unique_lock<std::mutex> lock(snapshot_mutex);
+    snapshot_taken = true;
+    snapshot_cv.notify_all();
+    snapshot_cv.wait(lock, [&]() { return snapshot_released; });
+
+    txn_manager.CommitTransaction();
+  });
+
+  {
+    std::unique_lock<std::mutex> lock(snapshot_mutex);
+    snapshot_cv.wait(lock, [&]() { return snapshot_taken; });
+  }
+
+  for (int update_itr = 0; update_itr < 3; update_itr++) {
+    UpdateTupleInPlace(table.get(), update_itr + 0.5, true);
+  }
+  EXPECT_EQ(3 * TESTS_TUPLES_PER_TILEGROUP, delta_store->GetDeltaCount());
+
+  {
+    std::lock_guard<std::mutex> lock(snapshot_mutex);
+    snapshot_released = true;
+    snapshot_cv.notify_all();
+  }
+  snapshot.join();
+
+  // Only the newest delta of every tuple is left, and it is reused
+  for (int update_itr = 0; update_itr < 3; update_itr++) {
+    UpdateTupleInPlace(table.get(), update_itr + 10.5, true);
+    EXPECT_EQ(TESTS_TUPLES_PER_TILEGROUP, delta_store->GetDeltaCount());
+  }
+}
+
+// UPDATE table SET column = value WHERE ATTR_0 < bound, in one transaction
+bool UpdateColumn(storage::DataTable *table, oid_t column_id, Value value,
+                  int bound) {
+  auto &txn_manager = concurrency::TransactionManager::GetInstance();
+  auto txn = txn_manager.BeginTransaction();
+  std::unique_ptr<executor::ExecutorContext> context(
+      new executor::ExecutorContext(txn));
+
+  planner::ProjectInfo::TargetList target_list;
+  planner::ProjectInfo::DirectMapList direct_map_list;
+  target_list.emplace_back(column_id, expression::ConstantValueFactory(value));
+  for (oid_t column_itr = 0; column_itr < table->GetSchema()->GetColumnCount();
+       column_itr++) {
+    if (column_itr != column_id)
+      direct_map_list.emplace_back(column_itr,
+                                   std::pair<oid_t, oid_t>(0, column_itr));
+  }
+
+  planner::UpdatePlan update_node(
+      table, new planner::ProjectInfo(std::move(target_list),
+                                      std::move(direct_map_list)));
+  executor::UpdateExecutor update_executor(&update_node, context.get());
+
+  expression::TupleValueExpression *tup_val_exp =
+      new expression::TupleValueExpression(0, 0);
+  expression::ConstantValueExpression *const_val_exp =
+      new expression::ConstantValueExpression(
+          ValueFactory::GetIntegerValue(bound));
+  auto predicate = new expression::ComparisonExpression<expression::CmpLt>(
+      EXPRESSION_TYPE_COMPARE_LESSTHAN, tup_val_exp, const_val_exp);
+
+  std::vector<oid_t> column_ids = {0};
+  planner::SeqScanPlan seq_scan_node(table, predicate, column_ids);
+  executor::SeqScanExecutor seq_scan_executor(&seq_scan_node, context.get());
+
+  update_node.AddChild(&seq_scan_node);
+  update_executor.AddChild(&seq_scan_executor);
+
+  EXPECT_TRUE(update_executor.Init());
+  bool status = update_executor.Execute();
+
+  if (status)
+    txn_manager.CommitTransaction();
+  else
+    txn_manager.AbortTransaction();
+
+  return status;
+}
+
+// Count the tuples found by an index scan on one key column
+size_t IndexScanCount(storage::DataTable *table, index::Index *index,
+                      oid_t key_column_id, Value value) {
+  std::vector<oid_t> column_ids = {0, 1};
+  std::vector<oid_t> key_column_ids = {key_column_id};
+  std::vector<ExpressionType> expr_types = {EXPRESSION_TYPE_COMPARE_EQUAL};
+  std::vector<Value> values = {value};
+  std::vector<expression::AbstractExpression *> runtime_keys;
+
+  planner::IndexScanPlan::IndexScanDesc index_scan_desc(
+      index, key_column_ids, expr_types, values, runtime_keys);
+  planner::IndexScanPlan node(table, nullptr, column_ids, index_scan_desc);
+
+  auto &txn_manager = concurrency::TransactionManager::GetInstance();
+  auto txn = txn_manager.BeginTransaction();
+  std::unique_ptr<executor::ExecutorContext> context(
+      new executor::ExecutorContext(txn));
+
+  executor::IndexScanExecutor executor(&node, context.get());
+  EXPECT_TRUE(executor.Init());
+
+  size_t tuple_count = 0;
+  while (executor.Execute()) {
+    std::unique_ptr<executor::LogicalTile> result_tile(executor.GetOutput());
+    tuple_count += result_tile->GetTupleCount();
+  }
+
+  txn_manager.CommitTransaction();
+
+  return tuple_count;
+}
+
+// Update indexed columns in place, only the affected indexes get new entries
+TEST(MutateTests, InPlaceKeyUpdateTest) {
+  std::unique_ptr<storage::DataTable> table(
+      ExecutorTestsUtil::CreateAndPopulateTable());
+  auto tile_group = table->GetTileGroup(0);
+  auto next_tuple_slot = tile_group->GetNextTupleSlot();
+
+  auto primary_index = table->GetIndex(0);
+  auto secondary_index = table->GetIndex(1);
+  auto primary_entry_count = primary_index->ScanAllKeys().size();
+  auto secondary_entry_count = secondary_index->ScanAllKeys().size();
+
+  // Only the secondary index is built on column 1
+  EXPECT_TRUE(
+      UpdateColumn(table.get(), 1, ValueFactory::GetIntegerValue(7), 50));
+
+  EXPECT_EQ(tile_group->GetNextTupleSlot(), next_tuple_slot);
+  EXPECT_EQ(primary_index->ScanAllKeys().size(), primary_entry_count);
+  EXPECT_EQ(secondary_index->ScanAllKeys().size(),
+            secondary_entry_count + TESTS_TUPLES_PER_TILEGROUP);
+
+  // The tuples are only found under their new key
+  EXPECT_EQ(IndexScanCount(table.get(), secondary_index, 1,
+                           ValueFactory::GetIntegerValue(7)),
+            TESTS_TUPLES_PER_TILEGROUP);
+  EXPECT_EQ(IndexScanCount(table.get(), secondary_index, 1,
+                           ValueFactory::GetIntegerValue(
+                               ExecutorTestsUtil::PopulatedValue(1, 1))),
+            0);
+
+  // Updating a tuple back to an older key adds no entry
+  EXPECT_TRUE(UpdateColumn(
+      table.get(), 1,
+      ValueFactory::GetIntegerValue(ExecutorTestsUtil::PopulatedValue(0, 1)),
+      10));
+  EXPECT_EQ(secondary_index->ScanAllKeys().size(),
+            secondary_entry_count + TESTS_TUPLES_PER_TILEGROUP);
+  EXPECT_EQ(IndexScanCount(table.get(), secondary_index, 1,
+                           ValueFactory::GetIntegerValue(
+                               ExecutorTestsUtil::PopulatedValue(0, 1))),
+            1);
+
+  // The primary key of another tuple is taken, so the update is rolled back
+  auto taken_key =
+      ValueFactory::GetIntegerValue(ExecutorTestsUtil::PopulatedValue(6, 0));
+  EXPECT_FALSE(UpdateColumn(table.get(), 0, taken_key, 10));
+
+  EXPECT_EQ(tile_group->GetValue(0, 0),
+            ValueFactory::GetIntegerValue(
+                ExecutorTestsUtil::PopulatedValue(0, 0)));
+  EXPECT_EQ(IndexScanCount(table.get(), primary_index, 0, taken_key), 1);
+}
+
+// Updating a tuple back to an older key, that another tuple took meanwhile
+TEST(MutateTests, InPlaceKeyUpdateBackTest) {
+  std::unique_ptr<storage::DataTable> table(
+      ExecutorTestsUtil::CreateAndPopulateTable());
+  auto tile_group = table->GetTileGroup(0);
+  auto primary_index = table->GetIndex(0);
+
+  auto old_key =
+      ValueFactory::GetIntegerValue(ExecutorTestsUtil::PopulatedValue(0, 0));
+  auto moved_key = ValueFactory::GetIntegerValue(
+      ExecutorTestsUtil::PopulatedValue(1, 0) + 5);
+
+  // The first tuple leaves its key, and the second one takes it
+  EXPECT_TRUE(UpdateColumn(table.get(), 0, moved_key, 5));
+  EXPECT_TRUE(UpdateColumn(table.get(), 0, old_key,
+                           ExecutorTestsUtil::PopulatedValue(1, 0) + 1));
+  EXPECT_EQ(IndexScanCount(table.get(), primary_index, 0, old_key), 1);
+
+  // The entry of the first tuple for its old key is still there, but the key
+  // is taken, so the update is rolled back
+  EXPECT_FALSE(UpdateColumn(table.get(), 0, old_key,
+                            ExecutorTestsUtil::PopulatedValue(1, 0) + 6));
+
+  EXPECT_EQ(tile_group->GetValue(0, 0), moved_key);
+  EXPECT_EQ(tile_group->GetValue(1, 0), old_key);
+  EXPECT_EQ(IndexScanCount(table.get(), primary_index, 0, old_key), 1);
+  EXPECT_EQ(IndexScanCount(table.get(), primary_index, 0, moved_key), 1);
+}
+
+// The entries of the keys no snapshot can see anymore are retired on commit
+TEST(MutateTests, InPlaceKeyUpdateRetireTest) {
+  std::unique_ptr<storage::DataTable> table(
+      ExecutorTestsUtil::CreateAndPopulateTable());
+  auto primary_index = table->GetIndex(0);
+  auto entry_count = primary_index->ScanAllKeys().size();
+
+  // The first tuple takes ever smaller keys, the last two have an entry
+  std::vector<int> keys = {ExecutorTestsUtil::PopulatedValue(0, 0)};
+  for (int update_itr = 1; update_itr <= 3; update_itr++) {
+    keys.push_back(-2 * update_itr);
+    EXPECT_TRUE(UpdateColumn(table.get(), 0,
+                             ValueFactory::GetIntegerValue(keys.back()),
+                             keys.back() + 3));
+    EXPECT_EQ(primary_index->ScanAllKeys().size(), entry_count + 1);
+  }
+
+  EXPECT_EQ(IndexScanCount(table.get(), primary_index, 0,
+                           ValueFactory::GetIntegerValue(keys[0])),
+            0);
+  EXPECT_EQ(IndexScanCount(table.get(), primary_index, 0,
+                           ValueFactory::GetIntegerValue(keys[2])),
+            0);
+
+  // A key the tuple goes back to keeps its entry
+  EXPECT_TRUE(UpdateColumn(
+      table.get(), 0, ValueFactory::GetIntegerValue(keys[2]), keys[3] + 1));
+  EXPECT_TRUE(UpdateColumn(
+      table.get(), 0, ValueFactory::GetIntegerValue(keys[3]), keys[2] + 1));
+  EXPECT_EQ(primary_index->ScanAllKeys().size(), entry_count + 1);
+  EXPECT_EQ(IndexScanCount(table.get(), primary_index, 0,
+                           ValueFactory::GetIntegerValue(keys[3])),
+            1);
+}
+
 }  // namespace test
 }  // namespace peloton
@@ -10,9 +10,12 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include <algorithm>
+#include <map>
 #include <memory>
 #include <set>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include "gmock/gmock.h"
@@ -21,6 +24,7 @@
 #include "backend/planner/order_by_plan.h"
 #include "backend/common/types.h"
 #include "backend/common/value.h"
+#include "backend/common/value_peeker.h"
 #include "backend/executor/executor_context.h"
 #include "backend/executor/logical_tile.h"
 #include "backend/executor/order_by_executor.h"
@@ -74,6 +78,98 @@ void RunTest(executor::OrderByExecutor &executor, size_t expected_num_tuples,
   std::cout << std::endl;
 }
 
+// Sort keys of the tests below, (b ASC, d DESC)
+typedef std::pair<int32_t, std::string> SortKey;
+
+SortKey GetSortKey(executor::LogicalTile *tile, oid_t tuple_id) {
+  Value string_value = tile->GetValue(tuple_id, 3);
+  return SortKey(
+      ValuePeeker::PeekInteger(tile->GetValue(tuple_id, 1)),
+      std::string(static_cast<const char *>(
+                      ValuePeeker::PeekObjectValueWithoutNull(string_value)),
+                  ValuePeeker::PeekObjectLengthWithoutNull(string_value)));
+}
+
+/**
+ * @brief Sorts a table of random tuples on (b ASC, d DESC) with the given
+ * memory budget, and compares the result with std::sort.
+ */
+void RunSpillTest(size_t tuple_count, size_t memory_budget, bool has_limit,
+                  size_t limit) {
+  std::vector<oid_t> sort_keys({1, 3});
+  std::vector<bool> descend_flags({false, true});
+  std::vector<oid_t> output_columns({0, 1, 2, 3});
+  planner::OrderByPlan node(sort_keys, descend_flags, output_columns);
+  node.SetMemoryBudget(memory_budget);
+
+  std::unique_ptr<executor::ExecutorContext> context(
+      new executor::ExecutorContext(nullptr));
+
+  executor::OrderByExecutor executor(&node, context.get());
+  if (has_limit) executor.SetLimit(limit);
+  MockExecutor child_executor;
+  executor.AddChild(&child_executor);
+
+  size_t tile_size = 20;
+  auto &txn_manager = concurrency::TransactionManager::GetInstance();
+  auto txn = txn_manager.BeginTransaction();
+  auto txn_id = txn->GetTransactionId();
+  std::unique_ptr<storage::DataTable> data_table(
+      ExecutorTestsUtil::CreateTable(tile_size));
+  bool random = true;
+  ExecutorTestsUtil::PopulateTable(txn, data_table.get(), tuple_count, false,
+                                   random, false);
+  txn_manager.CommitTransaction();
+
+  // Remember the sort key of every tuple, by its unique first column
+  std::vector<SortKey> expected_keys;
+  std::map<int32_t, SortKey> keys;
+  EXPECT_CALL(child_executor, DInit()).WillOnce(Return(true));
+  auto &execute_call = EXPECT_CALL(child_executor, DExecute());
+  auto &output_call = EXPECT_CALL(child_executor, GetOutput());
+  for (oid_t tile_group_itr = 0;
+       tile_group_itr < data_table->GetTileGroupCount(); tile_group_itr++) {
+    std::unique_ptr<executor::LogicalTile> source_logical_tile(
+        executor::LogicalTileFactory::WrapTileGroup(
+            data_table->GetTileGroup(tile_group_itr), txn_id));
+    for (oid_t tuple_id : *source_logical_tile) {
+      auto key = GetSortKey(source_logical_tile.get(), tuple_id);
+      keys[ValuePeeker::PeekInteger(
+          source_logical_tile->GetValue(tuple_id, 0))] = key;
+      expected_keys.push_back(key);
+    }
+
+    execute_call.WillOnce(Return(true));
+    output_call.WillOnce(Return(source_logical_tile.release()));
+  }
+  execute_call.WillOnce(Return(false));
+
+  std::sort(expected_keys.begin(), expected_keys.end(),
+            [](const SortKey &a, const SortKey &b) {
+              return (a.first != b.first) ? (a.first < b.first)
+                                          : (a.second > b.second);
+            });
+  if (has_limit && limit < expected_keys.size()) {
+    expected_keys.resize(limit);
+  }
+
+  EXPECT_TRUE(executor.Init());
+  std::vector<SortKey> result_keys;
+  while (executor.Execute()) {
+    std::unique_ptr<executor::LogicalTile> result_tile(executor.GetOutput());
+    for (oid_t tuple_id : *result_tile) {
+      auto key = GetSortKey(result_tile.get(), tuple_id);
+      // The rest of the tuple comes along with its sort key
+      EXPECT_EQ(keys[ValuePeeker::PeekInteger(
+                    result_tile->GetValue(tuple_id, 0))],
+                key);
+      result_keys.push_back(key);
+    }
+  }
+
+  EXPECT_EQ(expected_keys, result_keys);
+}
+
 TEST(OrderByTests, IntAscTest) {
   // Create the plan node
   std::vector<oid_t> sort_keys({1});
@@ -325,6 +421,24 @@ TEST(OrderByTests, StringDescIntAscTest) {
 
   RunTest(executor, tile_size * 2, sort_keys, descend_flags);
 }
+
+TEST(OrderByTests, SpillTest) {
+  // Every tuple is spilled as a run of its own, more runs than are merged
+  // at once
+  RunSpillTest(200, 1, false, 0);
+
+  // A few runs of several tiles
+  RunSpillTest(200, 8 * 1024, false, 0);
+}
+
+TEST(OrderByTests, TopNTest) {
+  RunSpillTest(200, DEFAULT_SORT_MEMORY_BUDGET, true, 7);
+  RunSpillTest(200, DEFAULT_SORT_MEMORY_BUDGET, true, 0);
+  RunSpillTest(40, DEFAULT_SORT_MEMORY_BUDGET, true, 100);
+
+  // Too many tuples to keep, falls back to spilling
+  RunSpillTest(200, 2 * 1024, true, 150);
+}
 }
 
 }  // namespace test
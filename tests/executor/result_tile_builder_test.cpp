@@ -0,0 +1,238 @@
+//===----------------------------------------------------------------------===//
+//
+//                         PelotonDB
+//
+// result_tile_builder_test.cpp
+//
+// Identification: tests/executor/result_tile_builder_test.cpp
+//
+// Copyright (c) 2015, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "backend/catalog/schema.h"
+#include "backend/common/pool.h"
+#include "backend/common/types.h"
+#include "backend/common/value_factory.h"
+#include "backend/common/value_peeker.h"
+#include "backend/executor/logical_tile.h"
+#include "backend/executor/result_tile_builder.h"
+#include "backend/storage/data_table.h"
+#include "backend/storage/tile_group.h"
+#include "backend/storage/tuple.h"
+
+#include "executor/executor_tests_util.h"
+#include "harness.h"
+
+namespace peloton {
+namespace test {
+
+//===--------------------------------------------------------------------===//
+// Result Tile Builder Tests
+//===--------------------------------------------------------------------===//
+
+namespace {
+
+// Rows of the test table are all NULL every 7th row, and have a NULL string
+// every 3rd row otherwise
+bool IsNullRow(oid_t tuple_id) { return tuple_id % 7 == 6; }
+
+bool IsNullString(oid_t tuple_id) { return tuple_id % 3 == 0; }
+
+std::string GetString(oid_t tuple_id) {
+  int value = ExecutorTestsUtil::PopulatedValue(tuple_id, 3);
+  return "row " + std::to_string(value);
+}
+
+// Append the rows of the test table. The tuples and their pool go away
+// before the tiles are read.
+void AppendTableRows(storage::DataTable *table,
+                     executor::ResultTileBuilder &builder,
+                     size_t tuple_count) {
+  std::unique_ptr<VarlenPool> pool(new VarlenPool(BACKEND_TYPE_MM));
+
+  for (oid_t tuple_id = 0; tuple_id < tuple_count; tuple_id++) {
+    std::unique_ptr<storage::Tuple> tuple;
+    if (IsNullRow(tuple_id)) {
+      tuple.reset(ExecutorTestsUtil::GetNullTuple(table, pool.get()));
+    } else {
+      tuple.reset(ExecutorTestsUtil::GetTuple(table, tuple_id, pool.get()));
+      tuple->SetValue(3, IsNullString(tuple_id)
+                             ? ValueFactory::GetNullStringValue()
+                             : ValueFactory::GetStringValue(
+                                   GetString(tuple_id), pool.get()),
+                      pool.get());
+    }
+    builder.AppendTuple(tuple.get());
+  }
+}
+
+// Take the result tiles and check that they hold tuple_count rows, at most
+// tile_size in every tile and all but the last tile full
+std::vector<std::unique_ptr<executor::LogicalTile>> GetResultTiles(
+    executor::ResultTileBuilder &builder, size_t tuple_count,
+    size_t tile_size) {
+  EXPECT_EQ(tuple_count, builder.GetTupleCount());
+
+  std::vector<std::unique_ptr<executor::LogicalTile>> result_tiles;
+  for (auto result_tile : builder.GetResultTiles()) {
+    result_tiles.emplace_back(result_tile);
+  }
+  EXPECT_EQ((tuple_count + tile_size - 1) / tile_size, result_tiles.size());
+  EXPECT_EQ(0, builder.GetTupleCount());
+
+  size_t result_tuple_count = 0;
+  for (size_t tile_itr = 0; tile_itr < result_tiles.size(); tile_itr++) {
+    auto &result_tile = result_tiles[tile_itr];
+    EXPECT_EQ(builder.GetSchema()->GetColumnCount(),
+              result_tile->GetColumnCount());
+    if (tile_itr + 1 < result_tiles.size()) {
+      EXPECT_EQ(tile_size, result_tile->GetTupleCount());
+    } else {
+      EXPECT_LE(result_tile->GetTupleCount(), tile_size);
+      EXPECT_GT(result_tile->GetTupleCount(), 0);
+    }
+    result_tuple_count += result_tile->GetTupleCount();
+  }
+  EXPECT_EQ(tuple_count, result_tuple_count);
+
+  return result_tiles;
+}
+
+// Build the rows of the test table and check every row once, in order
+void RunTableTest(size_t tile_size, size_t tuple_count) {
+  std::unique_ptr<storage::DataTable> table(
+      ExecutorTestsUtil::CreateTable(TESTS_TUPLES_PER_TILEGROUP, false));
+  executor::ResultTileBuilder builder(table->GetSchema(), tile_size);
+
+  AppendTableRows(table.get(), builder, tuple_count);
+  auto result_tiles = GetResultTiles(builder, tuple_count, tile_size);
+
+  oid_t tuple_id = 0;
+  for (auto &result_tile : result_tiles) {
+    for (oid_t result_tuple_id : *result_tile) {
+      if (IsNullRow(tuple_id)) {
+        for (oid_t column_itr = 0; column_itr < 4; column_itr++) {
+          EXPECT_TRUE(result_tile->GetValue(result_tuple_id, column_itr)
+                          .IsNull());
+        }
+        tuple_id++;
+        continue;
+      }
+
+      EXPECT_EQ(ExecutorTestsUtil::PopulatedValue(tuple_id, 0),
+                ValuePeeker::PeekInteger(
+                    result_tile->GetValue(result_tuple_id, 0)));
+      EXPECT_EQ(ExecutorTestsUtil::PopulatedValue(tuple_id, 1),
+                ValuePeeker::PeekInteger(
+                    result_tile->GetValue(result_tuple_id, 1)));
+      EXPECT_EQ(ExecutorTestsUtil::PopulatedValue(tuple_id, 2),
+                ValuePeeker::PeekDouble(
+                    result_tile->GetValue(result_tuple_id, 2)));
+
+      Value string_value = result_tile->GetValue(result_tuple_id, 3);
+      if (IsNullString(tuple_id)) {
+        EXPECT_TRUE(string_value.IsNull());
+      } else {
+        EXPECT_EQ(GetString(tuple_id),
+                  std::string(static_cast<const char *>(
+                                  ValuePeeker::PeekObjectValueWithoutNull(
+                                      string_value)),
+                              ValuePeeker::PeekObjectLengthWithoutNull(
+                                  string_value)));
+      }
+      tuple_id++;
+    }
+  }
+  EXPECT_EQ(tuple_count, tuple_id);
+}
+
+}  // namespace
+
+TEST(ResultTileBuilderTests, EmptyInputTest) {
+  std::unique_ptr<storage::DataTable> table(
+      ExecutorTestsUtil::CreateTable(TESTS_TUPLES_PER_TILEGROUP, false));
+  executor::ResultTileBuilder builder(table->GetSchema());
+
+  EXPECT_EQ(0, builder.GetTupleCount());
+  EXPECT_TRUE(builder.GetResultTiles().empty());
+
+  // Still empty once the tiles have been taken
+  EXPECT_EQ(0, builder.GetTupleCount());
+  EXPECT_TRUE(builder.GetResultTiles().empty());
+
+  RunTableTest(TESTS_TUPLES_PER_TILEGROUP, 0);
+}
+
+TEST(ResultTileBuilderTests, TileBoundaryTest) {
+  const size_t tile_size = TESTS_TUPLES_PER_TILEGROUP;
+
+  // Around the end of the first and of the second tile
+  RunTableTest(tile_size, 1);
+  RunTableTest(tile_size, tile_size - 1);
+  RunTableTest(tile_size, tile_size);
+  RunTableTest(tile_size, tile_size + 1);
+  RunTableTest(tile_size, 2 * tile_size);
+  RunTableTest(tile_size, 2 * tile_size + 1);
+
+  // Single row tiles
+  RunTableTest(1, 3);
+}
+
+TEST(ResultTileBuilderTests, VarlenTest) {
+  // Strings are copied into the pools of the tiles, many tiles in a row
+  RunTableTest(DEFAULT_TUPLES_PER_TILEGROUP, 2500);
+}
+
+TEST(ResultTileBuilderTests, InlinedTest) {
+  // The first tile of the test tile group holds two integer columns
+  std::unique_ptr<storage::TileGroup> tile_group(
+      ExecutorTestsUtil::CreateTileGroup());
+  const catalog::Schema *schema = &tile_group->GetTileSchemas()[0];
+  ASSERT_TRUE(schema->IsInlined());
+
+  const size_t tile_size = TESTS_TUPLES_PER_TILEGROUP;
+  const size_t tuple_count = 3 * tile_size + 2;
+  executor::ResultTileBuilder builder(schema, tile_size);
+
+  // The builder starts over after the tiles have been taken
+  for (int round = 0; round < 2; round++) {
+    {
+      storage::Tuple tuple(schema, true);
+      for (oid_t tuple_id = 0; tuple_id < tuple_count; tuple_id++) {
+        tuple.SetValue(0, ValueFactory::GetIntegerValue(
+                              ExecutorTestsUtil::PopulatedValue(tuple_id, 0)),
+                       nullptr);
+        tuple.SetValue(1, ValueFactory::GetIntegerValue(
+                              ExecutorTestsUtil::PopulatedValue(tuple_id, 1)),
+                       nullptr);
+        builder.AppendTuple(&tuple);
+      }
+    }
+
+    auto result_tiles = GetResultTiles(builder, tuple_count, tile_size);
+
+    oid_t tuple_id = 0;
+    for (auto &result_tile : result_tiles) {
+      for (oid_t result_tuple_id : *result_tile) {
+        EXPECT_EQ(ExecutorTestsUtil::PopulatedValue(tuple_id, 0),
+                  ValuePeeker::PeekInteger(
+                      result_tile->GetValue(result_tuple_id, 0)));
+        EXPECT_EQ(ExecutorTestsUtil::PopulatedValue(tuple_id, 1),
+                  ValuePeeker::PeekInteger(
+                      result_tile->GetValue(result_tuple_id, 1)));
+        tuple_id++;
+      }
+    }
+    EXPECT_EQ(tuple_count, tuple_id);
+  }
+}
+
+}  // namespace test
+}  // namespace peloton
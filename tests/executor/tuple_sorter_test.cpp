@@ -0,0 +1,170 @@
+//===----------------------------------------------------------------------===//
+//
+//                         PelotonDB
+//
+// tuple_sorter_test.cpp
+//
+// Identification: tests/executor/tuple_sorter_test.cpp
+//
+// Copyright (c) 2015, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <algorithm>
+#include <cstring>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "backend/catalog/schema.h"
+#include "backend/common/pool.h"
+#include "backend/common/types.h"
+#include "backend/common/value_factory.h"
+#include "backend/common/value_peeker.h"
+#include "backend/executor/tuple_sorter.h"
+#include "backend/storage/tuple.h"
+
+#include "harness.h"
+
+namespace peloton {
+namespace test {
+
+namespace {
+
+const size_t tuple_count = 10000;
+
+// id, tinyint, bigint, double, varchar, smallint
+catalog::Schema *CreateSchema() {
+  std::vector<catalog::Column> columns = {
+      catalog::Column(VALUE_TYPE_INTEGER, GetTypeSize(VALUE_TYPE_INTEGER),
+                      "id", true),
+      catalog::Column(VALUE_TYPE_TINYINT, GetTypeSize(VALUE_TYPE_TINYINT),
+                      "tiny", true),
+      catalog::Column(VALUE_TYPE_BIGINT, GetTypeSize(VALUE_TYPE_BIGINT),
+                      "big", true),
+      catalog::Column(VALUE_TYPE_DOUBLE, GetTypeSize(VALUE_TYPE_DOUBLE),
+                      "number", true),
+      catalog::Column(VALUE_TYPE_VARCHAR, 32, "name", false),
+      catalog::Column(VALUE_TYPE_SMALLINT, GetTypeSize(VALUE_TYPE_SMALLINT),
+                      "small", true)};
+  return new catalog::Schema(columns);
+}
+
+// Random values with many ties, negatives and NULLs. Names share long
+// prefixes, so that they differ after the bytes in the normalized key.
+void CreateTuples(const catalog::Schema *schema, VarlenPool *pool,
+                  std::vector<std::unique_ptr<storage::Tuple>> &tuples) {
+  std::mt19937 generator(0);
+  std::uniform_int_distribution<int> distribution(-20, 20);
+  const std::vector<std::string> names = {
+      "", "a", "ab", "abc", "a common prefix of names", "a common prefix ",
+      "a common prefix of names!", "zzz", "a common prefix of nam"};
+
+  for (size_t tuple_itr = 0; tuple_itr < tuple_count; tuple_itr++) {
+    std::unique_ptr<storage::Tuple> tuple(new storage::Tuple(schema, true));
+    auto is_null = [&generator]() { return generator() % 10 == 0; };
+
+    tuple->SetValue(0, ValueFactory::GetIntegerValue(tuple_itr), pool);
+    tuple->SetValue(1, is_null() ? Value::GetNullValue(VALUE_TYPE_TINYINT)
+                                 : ValueFactory::GetTinyIntValue(
+                                       distribution(generator) * 6),
+                    pool);
+    tuple->SetValue(2, is_null() ? Value::GetNullValue(VALUE_TYPE_BIGINT)
+                                 : ValueFactory::GetBigIntValue(
+                                       distribution(generator) *
+                                       (int64_t(1) << 40)),
+                    pool);
+    tuple->SetValue(3, is_null() ? Value::GetNullValue(VALUE_TYPE_DOUBLE)
+                                 : ValueFactory::GetDoubleValue(
+                                       distribution(generator) / 4.0),
+                    pool);
+    tuple->SetValue(4, is_null() ? ValueFactory::GetNullStringValue()
+                                 : ValueFactory::GetStringValue(
+                                       names[generator() % names.size()], pool),
+                    pool);
+    tuple->SetValue(5, is_null() ? Value::GetNullValue(VALUE_TYPE_SMALLINT)
+                                 : ValueFactory::GetSmallIntValue(
+                                       distribution(generator) * 1000),
+                    pool);
+
+    tuples.push_back(std::move(tuple));
+  }
+}
+
+void RunSortTest(const std::vector<oid_t> &sort_keys,
+                 const std::vector<bool> &descend_flags,
+                 bool is_prefix_complete) {
+  std::unique_ptr<catalog::Schema> schema(CreateSchema());
+  VarlenPool pool(BACKEND_TYPE_MM);
+
+  executor::TupleSorter sorter(schema.get(), sort_keys, descend_flags);
+  EXPECT_EQ(is_prefix_complete, sorter.IsPrefixComplete());
+  EXPECT_LE(sorter.GetPrefixSize(), 32);
+
+  std::vector<std::unique_ptr<storage::Tuple>> tuples;
+  std::vector<std::unique_ptr<storage::Tuple>> expected_tuples;
+  CreateTuples(schema.get(), &pool, tuples);
+  CreateTuples(schema.get(), &pool, expected_tuples);
+
+  sorter.Sort(tuples);
+  std::sort(expected_tuples.begin(), expected_tuples.end(),
+            [&sorter](const std::unique_ptr<storage::Tuple> &ta,
+                      const std::unique_ptr<storage::Tuple> &tb) {
+              return sorter(ta.get(), tb.get());
+            });
+
+  // Same keys in the same order, and every tuple once
+  ASSERT_EQ(tuple_count, tuples.size());
+  std::vector<bool> is_found(tuple_count, false);
+  for (size_t tuple_itr = 0; tuple_itr < tuple_count; tuple_itr++) {
+    for (auto key : sort_keys) {
+      EXPECT_EQ(VALUE_COMPARE_EQUAL,
+                tuples[tuple_itr]->GetValue(key).Compare(
+                    expected_tuples[tuple_itr]->GetValue(key)));
+    }
+
+    auto id = ValuePeeker::PeekInteger(tuples[tuple_itr]->GetValue(0));
+    EXPECT_FALSE(is_found[id]);
+    is_found[id] = true;
+  }
+
+  // Prefixes are ordered like the tuples, and tie only on equal tuples when
+  // they hold all of the keys
+  std::vector<uint8_t> prefix(sorter.GetPrefixSize());
+  std::vector<uint8_t> next_prefix(sorter.GetPrefixSize());
+  for (size_t tuple_itr = 0; tuple_itr + 1 < tuple_count; tuple_itr++) {
+    sorter.EncodePrefix(tuples[tuple_itr].get(), prefix.data());
+    sorter.EncodePrefix(tuples[tuple_itr + 1].get(), next_prefix.data());
+
+    int compare = ::memcmp(prefix.data(), next_prefix.data(), prefix.size());
+    EXPECT_LE(compare, 0);
+    if (is_prefix_complete) {
+      bool is_less = sorter(tuples[tuple_itr].get(),
+                            tuples[tuple_itr + 1].get());
+      EXPECT_EQ(is_less, compare < 0);
+    }
+  }
+}
+
+}  // namespace
+
+TEST(TupleSorterTests, CompletePrefixTest) {
+  RunSortTest({1, 2, 3}, {false, true, false}, true);
+  RunSortTest({5, 3}, {true, true}, true);
+  RunSortTest({0}, {true}, true);
+}
+
+TEST(TupleSorterTests, IncompletePrefixTest) {
+  // Strings end the prefix
+  RunSortTest({4, 1}, {false, true}, false);
+  RunSortTest({5, 4, 3}, {true, true, false}, false);
+
+  // Keys that do not fit in 32 bytes
+  RunSortTest({3, 2, 3, 2, 1}, {false, true, true, false, false}, false);
+}
+
+}  // namespace test
+}  // namespace peloton
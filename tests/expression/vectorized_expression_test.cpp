@@ -0,0 +1,344 @@
+//===----------------------------------------------------------------------===//
+//
+//                         PelotonDB
+//
+// vectorized_expression_test.cpp
+//
+// Identification: tests/expression/vectorized_expression_test.cpp
+//
+// Copyright (c) 2015, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <memory>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "backend/common/types.h"
+#include "backend/common/value_factory.h"
+#include "backend/concurrency/transaction_manager.h"
+#include "backend/expression/container_tuple.h"
+#include "backend/expression/expression_util.h"
+#include "backend/expression/operator_expression.h"
+#include "backend/expression/predicate_compiler.h"
+#include "backend/expression/vector_expression.h"
+#include "backend/expression/vectorized_kernels.h"
+#include "backend/storage/data_table.h"
+#include "backend/storage/tile_group.h"
+
+#include "executor/executor_tests_util.h"
+#include "harness.h"
+
+namespace peloton {
+namespace test {
+
+namespace {
+
+const int tuple_count = 50;
+
+const int null_tuple_count = 5;
+
+const int tuples_per_tile_group = 10;
+
+// The numeric columns of the last tuples are NULL
+storage::DataTable *CreateTableWithNulls() {
+  auto &txn_manager = concurrency::TransactionManager::GetInstance();
+  auto txn = txn_manager.BeginTransaction();
+
+  auto data_table =
+      ExecutorTestsUtil::CreateTable(tuples_per_tile_group, false);
+  ExecutorTestsUtil::PopulateTable(txn, data_table,
+                                   tuple_count + null_tuple_count, false, false,
+                                   false);
+
+  txn_manager.CommitTransaction();
+
+  // Write the NULLs in place, the columns are declared NOT NULL
+  for (int tuple_itr = tuple_count; tuple_itr < tuple_count + null_tuple_count;
+       tuple_itr++) {
+    auto tile_group =
+        data_table->GetTileGroup(tuple_itr / tuples_per_tile_group);
+    oid_t tuple_id = tuple_itr % tuples_per_tile_group;
+    tile_group->SetValue(tuple_id, 0, Value::GetNullValue(VALUE_TYPE_INTEGER));
+    tile_group->SetValue(tuple_id, 1, Value::GetNullValue(VALUE_TYPE_INTEGER));
+    tile_group->SetValue(tuple_id, 2, Value::GetNullValue(VALUE_TYPE_DOUBLE));
+  }
+
+  return data_table;
+}
+
+expression::AbstractExpression *Column(int column_id) {
+  return expression::TupleValueFactory(0, column_id);
+}
+
+expression::AbstractExpression *Integer(int value) {
+  return expression::ConstantValueFactory(ValueFactory::GetIntegerValue(value));
+}
+
+expression::AbstractExpression *Double(double value) {
+  return expression::ConstantValueFactory(ValueFactory::GetDoubleValue(value));
+}
+
+expression::AbstractExpression *String(const std::string &value) {
+  return expression::ConstantValueFactory(ValueFactory::GetStringValue(value));
+}
+
+expression::AbstractExpression *InList(
+    expression::AbstractExpression *column,
+    const std::vector<expression::AbstractExpression *> &values) {
+  return expression::ComparisonFactory(
+      EXPRESSION_TYPE_COMPARE_IN, column,
+      new expression::VectorExpression(VALUE_TYPE_ARRAY, values));
+}
+
+/**
+ * @brief Evaluates the predicate over all tuples of the table, in batches,
+ * compiled and one tuple at a time.
+ * @return Count of tuples for which the predicate is true.
+ */
+size_t ExpectSameSelection(storage::DataTable *table,
+                           expression::AbstractExpression *expr) {
+  std::unique_ptr<expression::AbstractExpression> predicate(expr);
+  auto compiled_predicate = expression::PredicateCompiler::Compile(
+      predicate.get(), table->GetSchema(), nullptr);
+  size_t selected_count = 0;
+
+  for (oid_t tile_group_itr = 0; tile_group_itr < table->GetTileGroupCount();
+       tile_group_itr++) {
+    auto tile_group = table->GetTileGroup(tile_group_itr);
+
+    std::vector<oid_t> positions, expected_positions;
+    for (oid_t tuple_id = 0; tuple_id < tile_group->GetNextTupleSlot();
+         tuple_id++) {
+      expression::ContainerTuple<storage::TileGroup> tuple(tile_group.get(),
+                                                           tuple_id);
+      if (predicate->Evaluate(&tuple, nullptr, nullptr).IsTrue()) {
+        expected_positions.push_back(tuple_id);
+      }
+      positions.push_back(tuple_id);
+    }
+
+    std::vector<oid_t> compiled_positions(positions);
+    compiled_predicate->Select(tile_group.get(), compiled_positions, nullptr);
+    EXPECT_EQ(expected_positions, compiled_positions);
+
+    predicate->EvaluateSelection(tile_group.get(), positions, nullptr);
+    EXPECT_EQ(expected_positions, positions);
+    selected_count += positions.size();
+  }
+
+  return selected_count;
+}
+
+}  // namespace
+
+TEST(VectorizedExpressionTests, ComparisonTest) {
+  std::unique_ptr<storage::DataTable> table(CreateTableWithNulls());
+
+  // Column against constant, also with the constant on the left
+  EXPECT_EQ(10, ExpectSameSelection(
+                    table.get(),
+                    expression::ComparisonFactory(
+                        EXPRESSION_TYPE_COMPARE_LESSTHAN, Column(0),
+                        Integer(ExecutorTestsUtil::PopulatedValue(10, 0)))));
+  EXPECT_EQ(11, ExpectSameSelection(
+                    table.get(),
+                    expression::ComparisonFactory(
+                        EXPRESSION_TYPE_COMPARE_GREATERTHANOREQUALTO,
+                        Integer(ExecutorTestsUtil::PopulatedValue(10, 1)),
+                        Column(1))));
+  EXPECT_EQ(1, ExpectSameSelection(
+                   table.get(),
+                   expression::ComparisonFactory(
+                       EXPRESSION_TYPE_COMPARE_EQUAL, Column(2),
+                       Double(ExecutorTestsUtil::PopulatedValue(7, 2)))));
+
+  // Integer column against a floating point constant
+  EXPECT_EQ(tuple_count - 5,
+            ExpectSameSelection(table.get(),
+                                expression::ComparisonFactory(
+                                    EXPRESSION_TYPE_COMPARE_GREATERTHAN,
+                                    Column(0), Double(45.5))));
+
+  // Column against column
+  EXPECT_EQ(tuple_count,
+            ExpectSameSelection(
+                table.get(),
+                expression::ComparisonFactory(EXPRESSION_TYPE_COMPARE_NOTEQUAL,
+                                              Column(0), Column(2))));
+
+  // Comparison with NULL is never true
+  EXPECT_EQ(0, ExpectSameSelection(
+                   table.get(),
+                   expression::ComparisonFactory(
+                       EXPRESSION_TYPE_COMPARE_EQUAL, Column(0),
+                       expression::ConstantValueFactory(
+                           ValueFactory::GetNullValue()))));
+
+  // VARCHAR is evaluated one tuple at a time
+  EXPECT_EQ(1, ExpectSameSelection(
+                   table.get(),
+                   expression::ComparisonFactory(
+                       EXPRESSION_TYPE_COMPARE_EQUAL, Column(3),
+                       expression::ConstantValueFactory(
+                           ValueFactory::GetStringValue("33")))));
+}
+
+TEST(VectorizedExpressionTests, ArithmeticTest) {
+  std::unique_ptr<storage::DataTable> table(CreateTableWithNulls());
+
+  // a + b > c, where c = a + 2 and b = a + 1
+  EXPECT_EQ(tuple_count - 1,
+            ExpectSameSelection(
+                table.get(),
+                expression::ComparisonFactory(
+                    EXPRESSION_TYPE_COMPARE_GREATERTHAN,
+                    expression::OperatorFactory(EXPRESSION_TYPE_OPERATOR_PLUS,
+                                                Column(0), Column(1)),
+                    Column(2))));
+
+  // (b - a) * 10 = a / 10 * 10 + 10
+  EXPECT_EQ(1, ExpectSameSelection(
+                   table.get(),
+                   expression::ComparisonFactory(
+                       EXPRESSION_TYPE_COMPARE_EQUAL,
+                       expression::OperatorFactory(
+                           EXPRESSION_TYPE_OPERATOR_MULTIPLY,
+                           expression::OperatorFactory(
+                               EXPRESSION_TYPE_OPERATOR_MINUS, Column(1),
+                               Column(0)),
+                           Integer(10)),
+                       expression::OperatorFactory(
+                           EXPRESSION_TYPE_OPERATOR_PLUS,
+                           expression::OperatorFactory(
+                               EXPRESSION_TYPE_OPERATOR_MULTIPLY,
+                               expression::OperatorFactory(
+                                   EXPRESSION_TYPE_OPERATOR_DIVIDE, Column(0),
+                                   Integer(10)),
+                               Integer(10)),
+                           Integer(10)))));
+}
+
+TEST(VectorizedExpressionTests, ConjunctionTest) {
+  std::unique_ptr<storage::DataTable> table(CreateTableWithNulls());
+
+  // 100 <= a AND a < 200 AND d <> '150'
+  EXPECT_EQ(9, ExpectSameSelection(
+                   table.get(),
+                   expression::ConjunctionFactory(
+                       EXPRESSION_TYPE_CONJUNCTION_AND,
+                       expression::ConjunctionFactory(
+                           EXPRESSION_TYPE_CONJUNCTION_AND,
+                           expression::ComparisonFactory(
+                               EXPRESSION_TYPE_COMPARE_LESSTHANOREQUALTO,
+                               Integer(100), Column(0)),
+                           expression::ComparisonFactory(
+                               EXPRESSION_TYPE_COMPARE_LESSTHAN, Column(0),
+                               Integer(200))),
+                       expression::ComparisonFactory(
+                           EXPRESSION_TYPE_COMPARE_NOTEQUAL, Column(3),
+                           expression::ConstantValueFactory(
+                               ValueFactory::GetStringValue("153"))))));
+
+  // a < 50 OR a > 440 OR a IS NULL
+  EXPECT_EQ(5 + 5 + null_tuple_count,
+            ExpectSameSelection(
+                table.get(),
+                expression::ConjunctionFactory(
+                    EXPRESSION_TYPE_CONJUNCTION_OR,
+                    expression::ConjunctionFactory(
+                        EXPRESSION_TYPE_CONJUNCTION_OR,
+                        expression::ComparisonFactory(
+                            EXPRESSION_TYPE_COMPARE_LESSTHAN, Column(0),
+                            Integer(50)),
+                        expression::ComparisonFactory(
+                            EXPRESSION_TYPE_COMPARE_GREATERTHAN, Column(0),
+                            Integer(440))),
+                    new expression::OperatorIsNullExpression(Column(0)))));
+}
+
+TEST(VectorizedExpressionTests, CompiledPredicateTest) {
+  std::unique_ptr<storage::DataTable> table(CreateTableWithNulls());
+
+  // Range over an integer column, with bounds on both sides: 100 < a AND
+  // b > 0 AND 200 >= a
+  EXPECT_EQ(10, ExpectSameSelection(
+                    table.get(),
+                    expression::ConjunctionFactory(
+                        EXPRESSION_TYPE_CONJUNCTION_AND,
+                        expression::ConjunctionFactory(
+                            EXPRESSION_TYPE_CONJUNCTION_AND,
+                            expression::ComparisonFactory(
+                                EXPRESSION_TYPE_COMPARE_LESSTHAN, Integer(100),
+                                Column(0)),
+                            expression::ComparisonFactory(
+                                EXPRESSION_TYPE_COMPARE_GREATERTHAN, Column(1),
+                                Integer(0))),
+                        expression::ComparisonFactory(
+                            EXPRESSION_TYPE_COMPARE_GREATERTHANOREQUALTO,
+                            Integer(200), Column(0)))));
+
+  // Range over a floating point column with an integer bound
+  EXPECT_EQ(3, ExpectSameSelection(
+                   table.get(),
+                   expression::ConjunctionFactory(
+                       EXPRESSION_TYPE_CONJUNCTION_AND,
+                       expression::ComparisonFactory(
+                           EXPRESSION_TYPE_COMPARE_GREATERTHANOREQUALTO,
+                           Column(2), Double(10.5)),
+                       expression::ComparisonFactory(
+                           EXPRESSION_TYPE_COMPARE_LESSTHAN, Column(2),
+                           Integer(40)))));
+
+  // IN list with duplicates, a floating point value and NULL
+  EXPECT_EQ(2, ExpectSameSelection(
+                   table.get(),
+                   InList(Column(0),
+                          {Integer(ExecutorTestsUtil::PopulatedValue(3, 0)),
+                           Integer(ExecutorTestsUtil::PopulatedValue(3, 0)),
+                           Double(ExecutorTestsUtil::PopulatedValue(8, 0)),
+                           Double(1.5),
+                           expression::ConstantValueFactory(
+                               ValueFactory::GetNullValue())})));
+
+  // Column against column of the same type
+  EXPECT_EQ(tuple_count,
+            ExpectSameSelection(
+                table.get(),
+                expression::ComparisonFactory(EXPRESSION_TYPE_COMPARE_LESSTHAN,
+                                              Column(0), Column(1))));
+
+  // VARCHAR against constants, ordered as strings
+  EXPECT_EQ(1, ExpectSameSelection(
+                   table.get(),
+                   expression::ComparisonFactory(EXPRESSION_TYPE_COMPARE_EQUAL,
+                                                 Column(3), String("33"))));
+  EXPECT_EQ(27, ExpectSameSelection(
+                    table.get(),
+                    expression::ComparisonFactory(
+                        EXPRESSION_TYPE_COMPARE_LESSTHAN, Column(3),
+                        String("333"))));
+
+  // a IN (10, 20) OR c > 450 OR a + b = 1, the last one interpreted
+  EXPECT_EQ(2 + 5 + 1,
+            ExpectSameSelection(
+                table.get(),
+                expression::ConjunctionFactory(
+                    EXPRESSION_TYPE_CONJUNCTION_OR,
+                    expression::ConjunctionFactory(
+                        EXPRESSION_TYPE_CONJUNCTION_OR,
+                        InList(Column(0), {Integer(10), Integer(20)}),
+                        expression::ComparisonFactory(
+                            EXPRESSION_TYPE_COMPARE_GREATERTHAN, Column(2),
+                            Integer(450))),
+                    expression::ComparisonFactory(
+                        EXPRESSION_TYPE_COMPARE_EQUAL,
+                        expression::OperatorFactory(
+                            EXPRESSION_TYPE_OPERATOR_PLUS, Column(0),
+                            Column(1)),
+                        Integer(1)))));
+}
+
+}  // namespace test
+}  // namespace peloton
@@ -10,9 +10,12 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include <set>
+
 #include "gtest/gtest.h"
 #include "harness.h"
 
+#include "backend/common/exception.h"
 #include "backend/common/logger.h"
 #include "backend/index/index_factory.h"
 #include "backend/storage/tuple.h"
@@ -31,14 +34,11 @@ ItemPointer item0(120, 5);
 ItemPointer item1(120, 7);
 ItemPointer item2(123, 19);
 
-index::Index *BuildIndex() {
+index::Index *BuildIndex(IndexType index_type = INDEX_TYPE_BTREE) {
   // Build tuple and key schema
   std::vector<std::vector<std::string>> column_names;
   std::vector<catalog::Column> columns;
   std::vector<catalog::Schema *> schemas;
-  IndexType index_type = INDEX_TYPE_BTREE;
-  // TODO: Uncomment the line below
-  //index_type = INDEX_TYPE_BWTREE;
 
   catalog::Column column1(VALUE_TYPE_INTEGER, GetTypeSize(VALUE_TYPE_INTEGER),
                           "A", true);
@@ -105,6 +105,52 @@ TEST(IndexTests, BasicTest) {
   delete tuple_schema;
 }
 
+void ConditionalInsertTestWithIndexType(IndexType index_type) {
+  auto pool = TestingHarness::GetInstance().GetTestingPool();
+  std::vector<ItemPointer> locations;
+
+  // INDEX
+  std::unique_ptr<index::Index> index(BuildIndex(index_type));
+
+  std::unique_ptr<storage::Tuple> key0(new storage::Tuple(key_schema, true));
+
+  key0->SetValue(0, ValueFactory::GetIntegerValue(100), pool);
+  key0->SetValue(1, ValueFactory::GetStringValue("a"), pool);
+
+  // Only entries in block 120 are treated as conflicting
+  auto predicate = [](const ItemPointer &location) -> bool {
+    return location.block == item0.block;
+  };
+
+  // INSERT
+  EXPECT_TRUE(index->ConditionalInsertEntry(key0.get(), item2, predicate));
+  EXPECT_TRUE(index->ConditionalInsertEntry(key0.get(), item0, predicate));
+
+  // Conflicts with item0
+  EXPECT_FALSE(index->ConditionalInsertEntry(key0.get(), item1, predicate));
+
+  locations = index->ScanKey(key0.get());
+  EXPECT_EQ(locations.size(), 2);
+
+  // DELETE
+  index->DeleteEntry(key0.get(), item0);
+
+  EXPECT_TRUE(index->ConditionalInsertEntry(key0.get(), item1, predicate));
+
+  locations = index->ScanKey(key0.get());
+  EXPECT_EQ(locations.size(), 2);
+
+  delete tuple_schema;
+}
+
+TEST(IndexTests, ConditionalInsertTest) {
+  ConditionalInsertTestWithIndexType(INDEX_TYPE_BTREE);
+  ConditionalInsertTestWithIndexType(INDEX_TYPE_BWTREE);
+  ConditionalInsertTestWithIndexType(INDEX_TYPE_OLCBTREE);
+  ConditionalInsertTestWithIndexType(INDEX_TYPE_HASH);
+  ConditionalInsertTestWithIndexType(INDEX_TYPE_ART);
+}
+
 // INSERT HELPER FUNCTION
 void InsertTest(index::Index *index, VarlenPool *pool, size_t scale_factor){
 
@@ -219,12 +265,12 @@ void DeleteTest(index::Index *index, VarlenPool *pool, size_t scale_factor){
 
 }
 
-TEST(IndexTests, DeleteTest) {
+void DeleteTestWithIndexType(IndexType index_type) {
   auto pool = TestingHarness::GetInstance().GetTestingPool();
   std::vector<ItemPointer> locations;
 
   // INDEX
-  std::unique_ptr<index::Index> index(BuildIndex());
+  std::unique_ptr<index::Index> index(BuildIndex(index_type));
 
   // Single threaded test
   size_t scale_factor = 1;
@@ -256,12 +302,20 @@ TEST(IndexTests, DeleteTest) {
   delete tuple_schema;
 }
 
-TEST(IndexTests, MultiThreadedInsertTest) {
+TEST(IndexTests, DeleteTest) {
+  DeleteTestWithIndexType(INDEX_TYPE_BTREE);
+  DeleteTestWithIndexType(INDEX_TYPE_BWTREE);
+  DeleteTestWithIndexType(INDEX_TYPE_OLCBTREE);
+  DeleteTestWithIndexType(INDEX_TYPE_HASH);
+  DeleteTestWithIndexType(INDEX_TYPE_ART);
+}
+
+void MultiThreadedInsertTestWithIndexType(IndexType index_type) {
   auto pool = TestingHarness::GetInstance().GetTestingPool();
   std::vector<ItemPointer> locations;
 
   // INDEX
-  std::unique_ptr<index::Index> index(BuildIndex());
+  std::unique_ptr<index::Index> index(BuildIndex(index_type));
 
   // Parallel Test
   size_t num_threads = 4;
@@ -290,5 +344,616 @@ TEST(IndexTests, MultiThreadedInsertTest) {
   delete tuple_schema;
 }
 
+TEST(IndexTests, MultiThreadedInsertTest) {
+  MultiThreadedInsertTestWithIndexType(INDEX_TYPE_BTREE);
+  MultiThreadedInsertTestWithIndexType(INDEX_TYPE_BWTREE);
+  MultiThreadedInsertTestWithIndexType(INDEX_TYPE_OLCBTREE);
+  MultiThreadedInsertTestWithIndexType(INDEX_TYPE_HASH);
+  MultiThreadedInsertTestWithIndexType(INDEX_TYPE_ART);
+}
+
+TEST(IndexTests, BWTreeBasicTest) {
+  auto pool = TestingHarness::GetInstance().GetTestingPool();
+  std::vector<ItemPointer> locations;
+
+  // INDEX
+  std::unique_ptr<index::Index> index(BuildIndex(INDEX_TYPE_BWTREE));
+  EXPECT_EQ(index->GetTypeName(), "BWTree");
+
+  std::unique_ptr<storage::Tuple> key0(new storage::Tuple(key_schema, true));
+
+  key0->SetValue(0, ValueFactory::GetIntegerValue(100), pool);
+  key0->SetValue(1, ValueFactory::GetStringValue("a"), pool);
+
+  // Only entries in block 120 are treated as conflicting
+  auto predicate = [](const ItemPointer &location) -> bool {
+    return location.block == item0.block;
+  };
+
+  // INSERT
+  index->InsertEntry(key0.get(), item0);
+
+  locations = index->ScanKey(key0.get());
+  EXPECT_EQ(locations.size(), 1);
+  EXPECT_EQ(locations[0].block, item0.block);
+
+  // Conflicts with item0
+  EXPECT_FALSE(index->ConditionalInsertEntry(key0.get(), item1, predicate));
+
+  // DELETE
+  index->DeleteEntry(key0.get(), item0);
+
+  locations = index->ScanKey(key0.get());
+  EXPECT_EQ(locations.size(), 0);
+
+  EXPECT_TRUE(index->ConditionalInsertEntry(key0.get(), item1, predicate));
+
+  locations = index->ScanKey(key0.get());
+  EXPECT_EQ(locations.size(), 1);
+  EXPECT_EQ(locations[0].offset, item1.offset);
+
+  delete tuple_schema;
+}
+
+// INSERT HELPER FUNCTION
+void SequentialInsertTest(index::Index *index, VarlenPool *pool,
+                          size_t num_keys, std::atomic<size_t> *next_key) {
+  std::unique_ptr<storage::Tuple> key(new storage::Tuple(key_schema, true));
+  key->SetValue(1, ValueFactory::GetStringValue("a"), pool);
+
+  // The threads take turns inserting the next key
+  for (size_t key_itr = (*next_key)++; key_itr < num_keys;
+       key_itr = (*next_key)++) {
+    key->SetValue(0, ValueFactory::GetIntegerValue(key_itr), pool);
+    index->InsertEntry(key.get(), ItemPointer(key_itr, 0));
+    index->InsertEntry(key.get(), ItemPointer(key_itr, 1));
+  }
+}
+
+void SplitMergeTestWithIndexType(IndexType index_type) {
+  auto pool = TestingHarness::GetInstance().GetTestingPool();
+  std::vector<ItemPointer> locations;
+
+  // INDEX
+  std::unique_ptr<index::Index> index(BuildIndex(index_type));
+  auto empty_footprint = index->GetMemoryFootprint();
+
+  // Enough keys to split leaves and inner nodes
+  size_t num_threads = 4;
+  size_t num_keys = 20000;
+  std::atomic<size_t> next_key(0);
+  LaunchParallelTest(num_threads, SequentialInsertTest, index.get(), pool,
+                     num_keys, &next_key);
+
+  auto full_footprint = index->GetMemoryFootprint();
+  EXPECT_GT(full_footprint, empty_footprint);
+
+  // All entries come back in key order
+  locations = index->ScanAllKeys();
+  EXPECT_EQ(locations.size(), 2 * num_keys);
+  for (size_t location_itr = 0; location_itr < locations.size();
+       location_itr++) {
+    EXPECT_EQ(locations[location_itr].block, location_itr / 2);
+  }
+
+  std::unique_ptr<storage::Tuple> key(new storage::Tuple(key_schema, true));
+  key->SetValue(1, ValueFactory::GetStringValue("a"), pool);
+
+  key->SetValue(0, ValueFactory::GetIntegerValue(12345), pool);
+  locations = index->ScanKey(key.get());
+  EXPECT_EQ(locations.size(), 2);
+
+  // Delete most of the keys to merge leaves
+  for (size_t key_itr = 0; key_itr < num_keys; key_itr++) {
+    if (key_itr % 100 == 0) {
+      continue;
+    }
+    key->SetValue(0, ValueFactory::GetIntegerValue(key_itr), pool);
+    index->DeleteEntry(key.get(), ItemPointer(key_itr, 0));
+    index->DeleteEntry(key.get(), ItemPointer(key_itr, 1));
+  }
+
+  // The radix tree frees the removed leaves once no reader can reach them
+  if (index_type == INDEX_TYPE_ART) {
+    EXPECT_LT(index->GetMemoryFootprint(), full_footprint);
+  }
+
+  locations = index->ScanAllKeys();
+  EXPECT_EQ(locations.size(), 2 * num_keys / 100);
+  for (size_t location_itr = 0; location_itr < locations.size();
+       location_itr++) {
+    EXPECT_EQ(locations[location_itr].block, (location_itr / 2) * 100);
+  }
+
+  key->SetValue(0, ValueFactory::GetIntegerValue(12300), pool);
+  locations = index->ScanKey(key.get());
+  EXPECT_EQ(locations.size(), 2);
+
+  key->SetValue(0, ValueFactory::GetIntegerValue(12345), pool);
+  locations = index->ScanKey(key.get());
+  EXPECT_EQ(locations.size(), 0);
+
+  // Range scan on the leading column
+  std::vector<Value> values = {ValueFactory::GetIntegerValue(5000),
+                               ValueFactory::GetIntegerValue(6000)};
+  std::vector<oid_t> key_column_ids = {0, 0};
+  std::vector<ExpressionType> expr_types = {
+      EXPRESSION_TYPE_COMPARE_GREATERTHANOREQUALTO,
+      EXPRESSION_TYPE_COMPARE_LESSTHAN};
+  locations = index->Scan(values, key_column_ids, expr_types,
+                          SCAN_DIRECTION_TYPE_FORWARD);
+  EXPECT_EQ(locations.size(), 20);
+
+  index->Cleanup();
+
+  delete tuple_schema;
+}
+
+TEST(IndexTests, BWTreeSplitMergeTest) {
+  SplitMergeTestWithIndexType(INDEX_TYPE_BWTREE);
+}
+
+TEST(IndexTests, BWTreePIDReuseTest) {
+  auto pool = TestingHarness::GetInstance().GetTestingPool();
+
+  // INDEX
+  std::unique_ptr<index::Index> index(BuildIndex(INDEX_TYPE_BWTREE));
+
+  std::unique_ptr<storage::Tuple> key(new storage::Tuple(key_schema, true));
+  key->SetValue(1, ValueFactory::GetStringValue("a"), pool);
+
+  // Fill and empty the tree over and over, the removed leaves hand their PIDs
+  // over to the leaves of the next round, so the mapping table stays put
+  size_t num_keys = 20000;
+  size_t empty_footprint = 0;
+  for (size_t round_itr = 0; round_itr < 20; round_itr++) {
+    for (size_t key_itr = 0; key_itr < num_keys; key_itr++) {
+      key->SetValue(0, ValueFactory::GetIntegerValue(key_itr), pool);
+      index->InsertEntry(key.get(), ItemPointer(key_itr, 0));
+    }
+
+    for (size_t key_itr = 0; key_itr < num_keys; key_itr++) {
+      key->SetValue(0, ValueFactory::GetIntegerValue(key_itr), pool);
+      index->DeleteEntry(key.get(), ItemPointer(key_itr, 0));
+    }
+    EXPECT_EQ(index->ScanAllKeys().size(), 0);
+
+    // Two epochs later nobody can hold the PIDs anymore
+    index->Cleanup();
+    index->Cleanup();
+
+    if (round_itr == 0) {
+      empty_footprint = index->GetMemoryFootprint();
+    } else {
+      EXPECT_LT(index->GetMemoryFootprint(),
+                empty_footprint + empty_footprint / 4);
+    }
+  }
+
+  delete tuple_schema;
+}
+
+TEST(IndexTests, OLCBTreeSplitTest) {
+  SplitMergeTestWithIndexType(INDEX_TYPE_OLCBTREE);
+}
+
+TEST(IndexTests, ARTGrowTest) {
+  SplitMergeTestWithIndexType(INDEX_TYPE_ART);
+}
+
+void ScanCursorTestWithIndexType(IndexType index_type) {
+  auto pool = TestingHarness::GetInstance().GetTestingPool();
+  std::vector<ItemPointer> locations;
+
+  // INDEX
+  std::unique_ptr<index::Index> index(BuildIndex(index_type));
+
+  size_t num_keys = 1000;
+  std::atomic<size_t> next_key(0);
+  SequentialInsertTest(index.get(), pool, num_keys, &next_key);
+
+  // Small batches return the same entries as a full scan
+  std::vector<Value> values;
+  std::vector<oid_t> key_column_ids;
+  std::vector<ExpressionType> expr_types;
+  auto cursor = index->GetScanCursor(values, key_column_ids, expr_types,
+                                     SCAN_DIRECTION_TYPE_FORWARD);
+  size_t batch_count = 0;
+  while (cursor->GetNextBatch(locations, 7) == true) {
+    batch_count++;
+    EXPECT_LE(locations.size(), 7 * batch_count);
+  }
+  EXPECT_FALSE(cursor->GetNextBatch(locations, 7));
+
+  auto all_locations = index->ScanAllKeys();
+  EXPECT_EQ(locations.size(), 2 * num_keys);
+  EXPECT_EQ(locations.size(), all_locations.size());
+  for (size_t location_itr = 0; location_itr < locations.size();
+       location_itr++) {
+    EXPECT_EQ(locations[location_itr].block, all_locations[location_itr].block);
+    EXPECT_EQ(locations[location_itr].offset,
+              all_locations[location_itr].offset);
+  }
+
+  std::unique_ptr<storage::Tuple> key(new storage::Tuple(key_schema, true));
+  key->SetValue(1, ValueFactory::GetStringValue("a"), pool);
+
+  if (index_type == INDEX_TYPE_HASH) {
+    values = {ValueFactory::GetIntegerValue(500),
+              ValueFactory::GetStringValue("a")};
+    key_column_ids = {0, 1};
+    expr_types = {EXPRESSION_TYPE_COMPARE_EQUAL, EXPRESSION_TYPE_COMPARE_EQUAL};
+    cursor = index->GetScanCursor(values, key_column_ids, expr_types,
+                                  SCAN_DIRECTION_TYPE_FORWARD);
+
+    locations.clear();
+    EXPECT_TRUE(cursor->GetNextBatch(locations, 1));
+    EXPECT_TRUE(cursor->GetNextBatch(locations, 1));
+    EXPECT_FALSE(cursor->GetNextBatch(locations, 1));
+    EXPECT_EQ(locations.size(), 2);
+
+    delete tuple_schema;
+    return;
+  }
+
+  // A range scan stops after every batch
+  values = {ValueFactory::GetIntegerValue(100),
+            ValueFactory::GetIntegerValue(200)};
+  key_column_ids = {0, 0};
+  expr_types = {EXPRESSION_TYPE_COMPARE_GREATERTHANOREQUALTO,
+                EXPRESSION_TYPE_COMPARE_LESSTHAN};
+  cursor = index->GetScanCursor(values, key_column_ids, expr_types,
+                                SCAN_DIRECTION_TYPE_FORWARD);
+
+  locations.clear();
+  EXPECT_TRUE(cursor->GetNextBatch(locations, 3));
+  EXPECT_EQ(locations.size(), 3);
+  EXPECT_EQ(locations[0].block, 100);
+  EXPECT_EQ(locations[2].block, 101);
+
+  // Entries changed between batches neither repeat nor hide the others
+  key->SetValue(0, ValueFactory::GetIntegerValue(100), pool);
+  index->DeleteEntry(key.get(), ItemPointer(100, 0));
+  key->SetValue(0, ValueFactory::GetIntegerValue(101), pool);
+  index->InsertEntry(key.get(), ItemPointer(101, 2));
+  key->SetValue(0, ValueFactory::GetIntegerValue(102), pool);
+  index->DeleteEntry(key.get(), ItemPointer(102, 0));
+
+  while (cursor->GetNextBatch(locations, 16) == true) {
+  }
+  EXPECT_EQ(locations.size(), 200);
+
+  std::set<std::pair<oid_t, oid_t>> unique_locations;
+  for (auto location : locations) {
+    EXPECT_GE(location.block, 100);
+    EXPECT_LT(location.block, 200);
+    unique_locations.insert(std::make_pair(location.block, location.offset));
+  }
+  EXPECT_EQ(unique_locations.size(), 200);
+  EXPECT_EQ(unique_locations.count(std::make_pair(101, 2)), 1);
+  EXPECT_EQ(unique_locations.count(std::make_pair(102, 0)), 0);
+
+  delete tuple_schema;
+}
+
+TEST(IndexTests, ScanCursorTest) {
+  ScanCursorTestWithIndexType(INDEX_TYPE_BTREE);
+  ScanCursorTestWithIndexType(INDEX_TYPE_BWTREE);
+  ScanCursorTestWithIndexType(INDEX_TYPE_OLCBTREE);
+  ScanCursorTestWithIndexType(INDEX_TYPE_HASH);
+  ScanCursorTestWithIndexType(INDEX_TYPE_ART);
+}
+
+void RangeScanTestWithIndexType(IndexType index_type) {
+  auto pool = TestingHarness::GetInstance().GetTestingPool();
+  std::vector<ItemPointer> locations;
+
+  // INDEX
+  std::unique_ptr<index::Index> index(BuildIndex(index_type));
+
+  // Keys { 0..9 } x { "a", "b", "c" }
+  std::vector<std::string> strings = {"a", "b", "c"};
+  std::unique_ptr<storage::Tuple> key(new storage::Tuple(key_schema, true));
+  for (oid_t key_itr = 0; key_itr < 10; key_itr++) {
+    for (oid_t string_itr = 0; string_itr < strings.size(); string_itr++) {
+      key->SetValue(0, ValueFactory::GetIntegerValue(key_itr), pool);
+      key->SetValue(1, ValueFactory::GetStringValue(strings[string_itr]),
+                    pool);
+      index->InsertEntry(key.get(), ItemPointer(key_itr, string_itr));
+    }
+  }
+
+  // Range on the first column, filter on the second
+  std::vector<Value> values = {ValueFactory::GetIntegerValue(3),
+                               ValueFactory::GetIntegerValue(6),
+                               ValueFactory::GetStringValue("a")};
+  std::vector<oid_t> key_column_ids = {0, 0, 1};
+  std::vector<ExpressionType> expr_types = {
+      EXPRESSION_TYPE_COMPARE_GREATERTHANOREQUALTO,
+      EXPRESSION_TYPE_COMPARE_LESSTHAN, EXPRESSION_TYPE_COMPARE_GREATERTHAN};
+  locations = index->Scan(values, key_column_ids, expr_types,
+                          SCAN_DIRECTION_TYPE_FORWARD);
+  EXPECT_EQ(locations.size(), 6);
+  for (size_t location_itr = 0; location_itr < locations.size();
+       location_itr++) {
+    EXPECT_EQ(locations[location_itr].block, 3 + location_itr / 2);
+    EXPECT_EQ(locations[location_itr].offset, 1 + location_itr % 2);
+  }
+
+  // Equality on the first column, range on the second
+  values = {ValueFactory::GetIntegerValue(4),
+            ValueFactory::GetStringValue("b")};
+  key_column_ids = {0, 1};
+  expr_types = {EXPRESSION_TYPE_COMPARE_EQUAL,
+                EXPRESSION_TYPE_COMPARE_LESSTHANOREQUALTO};
+  locations = index->Scan(values, key_column_ids, expr_types,
+                          SCAN_DIRECTION_TYPE_FORWARD);
+  EXPECT_EQ(locations.size(), 2);
+  EXPECT_EQ(locations[0].block, 4);
+  EXPECT_EQ(locations[0].offset, 0);
+  EXPECT_EQ(locations[1].block, 4);
+  EXPECT_EQ(locations[1].offset, 1);
+
+  // Backward scans return the entries in descending key order
+  values = {ValueFactory::GetIntegerValue(6),
+            ValueFactory::GetIntegerValue(8)};
+  key_column_ids = {0, 0};
+  expr_types = {EXPRESSION_TYPE_COMPARE_GREATERTHAN,
+                EXPRESSION_TYPE_COMPARE_LESSTHANOREQUALTO};
+  locations = index->Scan(values, key_column_ids, expr_types,
+                          SCAN_DIRECTION_TYPE_BACKWARD);
+  EXPECT_EQ(locations.size(), 6);
+  for (size_t location_itr = 0; location_itr < locations.size();
+       location_itr++) {
+    EXPECT_EQ(locations[location_itr].block, 8 - location_itr / 3);
+    EXPECT_EQ(locations[location_itr].offset, 2 - location_itr % 3);
+  }
+
+  auto cursor = index->GetScanCursor(values, key_column_ids, expr_types,
+                                     SCAN_DIRECTION_TYPE_BACKWARD);
+  std::vector<ItemPointer> cursor_locations;
+  while (cursor->GetNextBatch(cursor_locations, 4) == true) {
+  }
+  EXPECT_EQ(cursor_locations.size(), 6);
+  EXPECT_EQ(cursor_locations[0].block, 8);
+  EXPECT_EQ(cursor_locations[5].block, 7);
+
+  // Predicates only on the second column skip through the first
+  values = {ValueFactory::GetStringValue("b")};
+  key_column_ids = {1};
+  expr_types = {EXPRESSION_TYPE_COMPARE_EQUAL};
+  cursor = index->GetScanCursor(values, key_column_ids, expr_types,
+                                SCAN_DIRECTION_TYPE_FORWARD);
+  cursor_locations.clear();
+  while (cursor->GetNextBatch(cursor_locations, 3) == true) {
+  }
+  EXPECT_EQ(cursor_locations.size(), 10);
+  for (size_t location_itr = 0; location_itr < cursor_locations.size();
+       location_itr++) {
+    EXPECT_EQ(cursor_locations[location_itr].block, location_itr);
+    EXPECT_EQ(cursor_locations[location_itr].offset, 1);
+  }
+
+  locations = index->Scan(values, key_column_ids, expr_types,
+                          SCAN_DIRECTION_TYPE_BACKWARD);
+  EXPECT_EQ(locations.size(), 10);
+  EXPECT_EQ(locations[0].block, 9);
+  EXPECT_EQ(locations[9].block, 0);
+
+  delete tuple_schema;
+}
+
+TEST(IndexTests, RangeScanTest) {
+  RangeScanTestWithIndexType(INDEX_TYPE_BTREE);
+  RangeScanTestWithIndexType(INDEX_TYPE_BWTREE);
+  RangeScanTestWithIndexType(INDEX_TYPE_OLCBTREE);
+  RangeScanTestWithIndexType(INDEX_TYPE_ART);
+}
+
+void NormalizedKeyTestWithIndexType(IndexType index_type) {
+  auto pool = TestingHarness::GetInstance().GetTestingPool();
+  std::vector<ItemPointer> locations;
+
+  // INDEX
+  std::unique_ptr<index::Index> index(BuildIndex(index_type));
+
+  // Signed integers and strings that share more than their prefix, in order
+  std::vector<int32_t> integers = {-70000, -1, 0, 1, 70000};
+  std::vector<std::string> strings = {"", "abc", "abcdefghijklmnopq",
+                                      "abcdefghijklmnopqrstuvwxyz_1",
+                                      "abcdefghijklmnopqrstuvwxyz_2"};
+
+  // Insert in reverse order
+  std::unique_ptr<storage::Tuple> key(new storage::Tuple(key_schema, true));
+  for (oid_t integer_itr = integers.size(); integer_itr-- > 0;) {
+    for (oid_t string_itr = strings.size(); string_itr-- > 0;) {
+      key->SetValue(0, ValueFactory::GetIntegerValue(integers[integer_itr]),
+                    pool);
+      key->SetValue(1, ValueFactory::GetStringValue(strings[string_itr]),
+                    pool);
+      index->InsertEntry(key.get(), ItemPointer(integer_itr, string_itr));
+    }
+  }
+
+  locations = index->ScanAllKeys();
+  EXPECT_EQ(locations.size(), integers.size() * strings.size());
+  for (size_t location_itr = 0; location_itr < locations.size();
+       location_itr++) {
+    EXPECT_EQ(locations[location_itr].block, location_itr / strings.size());
+    EXPECT_EQ(locations[location_itr].offset, location_itr % strings.size());
+  }
+
+  // Keys that differ only after the string prefix
+  key->SetValue(0, ValueFactory::GetIntegerValue(-1), pool);
+  key->SetValue(1, ValueFactory::GetStringValue(strings[4]), pool);
+  locations = index->ScanKey(key.get());
+  EXPECT_EQ(locations.size(), 1);
+  EXPECT_EQ(locations[0].block, 1);
+  EXPECT_EQ(locations[0].offset, 4);
+
+  // Range on the first column across the sign
+  std::vector<Value> values = {ValueFactory::GetIntegerValue(-1),
+                               ValueFactory::GetIntegerValue(0)};
+  std::vector<oid_t> key_column_ids = {0, 0};
+  std::vector<ExpressionType> expr_types = {
+      EXPRESSION_TYPE_COMPARE_GREATERTHAN,
+      EXPRESSION_TYPE_COMPARE_LESSTHANOREQUALTO};
+  locations = index->Scan(values, key_column_ids, expr_types,
+                          SCAN_DIRECTION_TYPE_FORWARD);
+  EXPECT_EQ(locations.size(), strings.size());
+  for (auto location : locations) {
+    EXPECT_EQ(location.block, 2);
+  }
+
+  delete tuple_schema;
+}
+
+TEST(IndexTests, NormalizedKeyTest) {
+  NormalizedKeyTestWithIndexType(INDEX_TYPE_BTREE);
+  NormalizedKeyTestWithIndexType(INDEX_TYPE_BWTREE);
+  NormalizedKeyTestWithIndexType(INDEX_TYPE_OLCBTREE);
+  NormalizedKeyTestWithIndexType(INDEX_TYPE_ART);
+}
+
+void MultiScanKeyTestWithIndexType(IndexType index_type) {
+  auto pool = TestingHarness::GetInstance().GetTestingPool();
+
+  // INDEX
+  std::unique_ptr<index::Index> index(BuildIndex(index_type));
+
+  size_t num_keys = 5000;
+  std::atomic<size_t> next_key(0);
+  LaunchParallelTest(1, SequentialInsertTest, index.get(), pool, num_keys,
+                     &next_key);
+
+  // Probe close keys in descending order, repeated keys, missing keys and
+  // keys far apart
+  std::vector<int> probe_values;
+  for (int key_itr = num_keys - 1; key_itr >= 0; key_itr -= 3) {
+    probe_values.push_back(key_itr);
+  }
+  probe_values.push_back(42);
+  probe_values.push_back(42);
+  probe_values.push_back(-1);
+  probe_values.push_back(num_keys + 10);
+  probe_values.push_back(0);
+  probe_values.push_back(num_keys - 1);
+
+  std::vector<std::unique_ptr<storage::Tuple>> keys;
+  std::vector<const storage::Tuple *> probe_keys;
+  for (auto probe_value : probe_values) {
+    std::unique_ptr<storage::Tuple> key(new storage::Tuple(key_schema, true));
+    key->SetValue(0, ValueFactory::GetIntegerValue(probe_value), pool);
+    key->SetValue(1, ValueFactory::GetStringValue("a"), pool);
+    probe_keys.push_back(key.get());
+    keys.push_back(std::move(key));
+  }
+
+  std::vector<std::vector<ItemPointer>> locations;
+  index->MultiScanKey(probe_keys, locations);
+  EXPECT_EQ(probe_values.size(), locations.size());
+
+  for (size_t probe_itr = 0; probe_itr < probe_values.size(); probe_itr++) {
+    auto probe_value = probe_values[probe_itr];
+    if (probe_value < 0 || probe_value >= (int)num_keys) {
+      EXPECT_EQ(0, locations[probe_itr].size());
+      continue;
+    }
+
+    EXPECT_EQ(2, locations[probe_itr].size());
+    for (auto &location : locations[probe_itr]) {
+      EXPECT_EQ(probe_value, location.block);
+    }
+  }
+
+  delete tuple_schema;
+}
+
+TEST(IndexTests, MultiScanKeyTest) {
+  MultiScanKeyTestWithIndexType(INDEX_TYPE_BTREE);
+  MultiScanKeyTestWithIndexType(INDEX_TYPE_BWTREE);
+  MultiScanKeyTestWithIndexType(INDEX_TYPE_OLCBTREE);
+  MultiScanKeyTestWithIndexType(INDEX_TYPE_HASH);
+  MultiScanKeyTestWithIndexType(INDEX_TYPE_ART);
+}
+
+TEST(IndexTests, HashIndexTest) {
+  auto pool = TestingHarness::GetInstance().GetTestingPool();
+  std::vector<ItemPointer> locations;
+
+  // INDEX
+  std::unique_ptr<index::Index> index(BuildIndex(INDEX_TYPE_HASH));
+  EXPECT_EQ(index->GetTypeName(), "Hash");
+  auto empty_footprint = index->GetMemoryFootprint();
+
+  // Enough keys to grow every segment several times
+  size_t num_threads = 4;
+  size_t num_keys = 20000;
+  std::atomic<size_t> next_key(0);
+  LaunchParallelTest(num_threads, SequentialInsertTest, index.get(), pool,
+                     num_keys, &next_key);
+
+  EXPECT_GT(index->GetMemoryFootprint(), empty_footprint);
+
+  locations = index->ScanAllKeys();
+  EXPECT_EQ(locations.size(), 2 * num_keys);
+
+  std::unique_ptr<storage::Tuple> key(new storage::Tuple(key_schema, true));
+  key->SetValue(1, ValueFactory::GetStringValue("a"), pool);
+
+  for (size_t key_itr = 0; key_itr < num_keys; key_itr += 97) {
+    key->SetValue(0, ValueFactory::GetIntegerValue(key_itr), pool);
+    locations = index->ScanKey(key.get());
+    EXPECT_EQ(locations.size(), 2);
+    EXPECT_EQ(locations[0].block, key_itr);
+  }
+
+  // Delete all but every hundredth key
+  for (size_t key_itr = 0; key_itr < num_keys; key_itr++) {
+    if (key_itr % 100 == 0) {
+      continue;
+    }
+    key->SetValue(0, ValueFactory::GetIntegerValue(key_itr), pool);
+    index->DeleteEntry(key.get(), ItemPointer(key_itr, 0));
+    index->DeleteEntry(key.get(), ItemPointer(key_itr, 1));
+  }
+
+  locations = index->ScanAllKeys();
+  EXPECT_EQ(locations.size(), 2 * num_keys / 100);
+
+  key->SetValue(0, ValueFactory::GetIntegerValue(12345), pool);
+  locations = index->ScanKey(key.get());
+  EXPECT_EQ(locations.size(), 0);
+
+  // Equality on all key columns is a single lookup
+  std::vector<Value> values = {ValueFactory::GetIntegerValue(12300),
+                               ValueFactory::GetStringValue("a")};
+  std::vector<oid_t> key_column_ids = {0, 1};
+  std::vector<ExpressionType> expr_types = {EXPRESSION_TYPE_COMPARE_EQUAL,
+                                            EXPRESSION_TYPE_COMPARE_EQUAL};
+  locations = index->Scan(values, key_column_ids, expr_types,
+                          SCAN_DIRECTION_TYPE_FORWARD);
+  EXPECT_EQ(locations.size(), 2);
+
+  // Range predicates and partial keys are rejected
+  values = {ValueFactory::GetIntegerValue(5000)};
+  key_column_ids = {0};
+  expr_types = {EXPRESSION_TYPE_COMPARE_EQUAL};
+  EXPECT_THROW(index->Scan(values, key_column_ids, expr_types,
+                           SCAN_DIRECTION_TYPE_FORWARD),
+               IndexException);
+
+  values = {ValueFactory::GetIntegerValue(5000),
+            ValueFactory::GetStringValue("a")};
+  key_column_ids = {0, 1};
+  expr_types = {EXPRESSION_TYPE_COMPARE_GREATERTHANOREQUALTO,
+                EXPRESSION_TYPE_COMPARE_EQUAL};
+  EXPECT_THROW(index->Scan(values, key_column_ids, expr_types,
+                           SCAN_DIRECTION_TYPE_FORWARD),
+               IndexException);
+
+  delete tuple_schema;
+}
+
 }  // End test namespace
 }  // End peloton namespace
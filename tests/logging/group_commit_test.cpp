@@ -0,0 +1,163 @@
+//===----------------------------------------------------------------------===//
+//
+//                         PelotonDB
+//
+// group_commit_test.cpp
+//
+// Identification: tests/logging/group_commit_test.cpp
+//
+// Copyright (c) 2015, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <cstdio>
+#include <thread>
+
+#include "gtest/gtest.h"
+#include "harness.h"
+
+#include "backend/logging/backend_logger.h"
+#include "backend/logging/frontend_logger.h"
+#include "backend/logging/log_manager.h"
+#include "backend/logging/records/transaction_record.h"
+
+//===--------------------------------------------------------------------===//
+// GUC Variables
+//===--------------------------------------------------------------------===//
+
+// Logging mode
+extern LoggingType peloton_logging_mode;
+
+namespace peloton {
+namespace test {
+
+//===--------------------------------------------------------------------===//
+// Group Commit Tests
+//===--------------------------------------------------------------------===//
+
+namespace {
+
+// Frontend logger without a log, to drive the group commit by hand
+class GroupCommitFrontendLogger : public logging::FrontendLogger {
+ public:
+  void FlushLogRecords(void) {}
+
+  void DoRecovery(void) {}
+
+  using logging::FrontendLogger::WaitForFlushRequest;
+
+  using logging::FrontendLogger::AdaptGroupCommitDelay;
+
+  size_t GetGroupCommitSize(void) const { return group_commit_size; }
+
+  int64_t GetGroupCommitDelay(void) const { return group_commit_delay; }
+
+  int64_t GetMaxGroupCommitDelay(void) const { return max_group_commit_delay; }
+};
+
+// Wait for a flush request, then adapt the delay to the group it closed
+void RunGroupCommit(GroupCommitFrontendLogger &frontend_logger,
+                    size_t committer_count) {
+  for (size_t committer_itr = 0; committer_itr < committer_count;
+       committer_itr++) {
+    frontend_logger.RequestFlush();
+  }
+  frontend_logger.WaitForFlushRequest();
+  EXPECT_EQ(frontend_logger.GetGroupCommitSize(), committer_count);
+
+  frontend_logger.AdaptGroupCommitDelay();
+}
+
+void CommitAndWait(void) {
+  auto &log_manager = logging::LogManager::GetInstance();
+  auto logger = log_manager.GetBackendLogger();
+
+  for (txn_id_t txn_id = 1; txn_id <= 10; txn_id++) {
+    auto record = new logging::TransactionRecord(
+        LOGRECORD_TYPE_TRANSACTION_COMMIT, txn_id);
+    logger->Log(record);
+
+    // The commit only returns once its record is durable
+    auto lsn = logger->GetLoggedLsn();
+    logger->WaitForFlushing();
+    EXPECT_GE(log_manager.GetDurableLsn(), lsn);
+  }
+
+  log_manager.RemoveBackendLogger(logger);
+}
+
+}  // namespace
+
+TEST(GroupCommitTests, BatchTest) {
+  GroupCommitFrontendLogger frontend_logger;
+
+  // The committers that request a flush before the frontend logger wakes up
+  // share it
+  LaunchParallelTest(8, [&frontend_logger]() {
+    frontend_logger.RequestFlush();
+  });
+  frontend_logger.WaitForFlushRequest();
+  EXPECT_EQ(frontend_logger.GetGroupCommitSize(), 8);
+
+  // The next flush starts a new group, here without any committer
+  frontend_logger.WaitForFlushRequest();
+  EXPECT_EQ(frontend_logger.GetGroupCommitSize(), 0);
+}
+
+TEST(GroupCommitTests, AdaptDelayTest) {
+  GroupCommitFrontendLogger frontend_logger;
+  EXPECT_EQ(frontend_logger.GetGroupCommitDelay(), 0);
+
+  // A lone committer does not wait for a group
+  RunGroupCommit(frontend_logger, 1);
+  EXPECT_EQ(frontend_logger.GetGroupCommitDelay(), 0);
+
+  // Shared flushes double the delay up to its bound
+  RunGroupCommit(frontend_logger, 4);
+  EXPECT_EQ(frontend_logger.GetGroupCommitDelay(), 1);
+  RunGroupCommit(frontend_logger, 4);
+  EXPECT_EQ(frontend_logger.GetGroupCommitDelay(), 2);
+
+  int64_t max_delay = frontend_logger.GetMaxGroupCommitDelay();
+  while (frontend_logger.GetGroupCommitDelay() < max_delay) {
+    RunGroupCommit(frontend_logger, 2);
+  }
+  RunGroupCommit(frontend_logger, 2);
+  EXPECT_EQ(frontend_logger.GetGroupCommitDelay(), max_delay);
+
+  // Flushes of single committers halve it again
+  RunGroupCommit(frontend_logger, 1);
+  EXPECT_EQ(frontend_logger.GetGroupCommitDelay(), max_delay / 2);
+  RunGroupCommit(frontend_logger, 0);
+  EXPECT_EQ(frontend_logger.GetGroupCommitDelay(), max_delay / 4);
+}
+
+TEST(GroupCommitTests, DurableCommitTest) {
+  auto logging_mode = peloton_logging_mode;
+  peloton_logging_mode = LOGGING_TYPE_DRAM_NVM;
+
+  std::string log_file_name = "group_commit.log";
+  std::remove(log_file_name.c_str());
+
+  auto &log_manager = logging::LogManager::GetInstance();
+  log_manager.SetLogFileName(log_file_name);
+  log_manager.SetSyncCommit(true);
+
+  // STANDBY -> RECOVERY -> LOGGING
+  std::thread thread(&logging::LogManager::StartStandbyMode, &log_manager);
+  log_manager.WaitForMode(LOGGING_STATUS_TYPE_STANDBY, true);
+  log_manager.StartRecoveryMode();
+  log_manager.WaitForMode(LOGGING_STATUS_TYPE_LOGGING, true);
+
+  LaunchParallelTest(4, CommitAndWait);
+
+  EXPECT_TRUE(log_manager.EndLogging());
+  thread.join();
+
+  log_manager.SetSyncCommit(false);
+  std::remove(log_file_name.c_str());
+  peloton_logging_mode = logging_mode;
+}
+
+}  // End test namespace
+}  // End peloton namespace
@@ -12,9 +12,13 @@
 
 #include "gtest/gtest.h"
 
+#include "backend/index/index_factory.h"
 #include "backend/storage/data_table.h"
 #include "backend/storage/tile_group.h"
+#include "backend/storage/tuple.h"
+#include "backend/common/value_peeker.h"
 #include "executor/executor_tests_util.h"
+#include "harness.h"
 
 namespace peloton {
 namespace test {
@@ -67,5 +71,122 @@ TEST(DataTableTests, TransformTileGroupTest) {
   data_table->TransformTileGroup(0, theta);
 }
 
+void BuildIndexTestWithIndexType(IndexType index_type) {
+  // Enough tuples for a few levels of nodes, spread over many tile groups
+  const int tuples_per_tilegroup = 1000;
+  const int tuple_count = 50 * tuples_per_tilegroup;
+
+  auto &txn_manager = concurrency::TransactionManager::GetInstance();
+  auto txn = txn_manager.BeginTransaction();
+  std::unique_ptr<storage::DataTable> data_table(
+      ExecutorTestsUtil::CreateTable(tuples_per_tilegroup, false));
+  ExecutorTestsUtil::PopulateTable(txn, data_table.get(), tuple_count, false,
+                                   false, false);
+  txn_manager.CommitTransaction();
+
+  // Index the populated table on the second column
+  auto tuple_schema = data_table->GetSchema();
+  std::vector<oid_t> key_attrs = {1};
+  auto key_schema = catalog::Schema::CopySchema(tuple_schema, key_attrs);
+  key_schema->SetIndexedColumns(key_attrs);
+
+  auto index_metadata = new index::IndexMetadata(
+      "build_index", 125, index_type, INDEX_CONSTRAINT_TYPE_DEFAULT,
+      tuple_schema, key_schema, false);
+  index::Index *index = index::IndexFactory::GetInstance(index_metadata);
+  data_table->AddIndex(index);
+
+  EXPECT_FALSE(index->IsBuilding());
+  EXPECT_EQ(tuple_count, index->ScanAllKeys().size());
+
+  // Every tuple is found under its key
+  auto pool = index->GetPool();
+  std::unique_ptr<storage::Tuple> key(new storage::Tuple(key_schema, true));
+  for (int tuple_id = 0; tuple_id < tuple_count; tuple_id += 997) {
+    key->SetValue(0, ValueFactory::GetIntegerValue(
+                         ExecutorTestsUtil::PopulatedValue(tuple_id, 1)),
+                  pool);
+    auto locations = index->ScanKey(key.get());
+    EXPECT_EQ(1, locations.size());
+    if (locations.size() != 1) continue;
+
+    auto tile_group = data_table->GetTileGroupById(locations[0].block);
+    EXPECT_EQ(ExecutorTestsUtil::PopulatedValue(tuple_id, 0),
+              ValuePeeker::PeekAsInteger(
+                  tile_group->GetValue(locations[0].offset, 0)));
+  }
+
+  // Tuples inserted after the build go to the index directly
+  txn = txn_manager.BeginTransaction();
+  ExecutorTestsUtil::PopulateTable(txn, data_table.get(), 10, true, false,
+                                   false);
+  txn_manager.CommitTransaction();
+
+  EXPECT_EQ(tuple_count + 10, index->ScanAllKeys().size());
+}
+
+TEST(DataTableTests, BuildIndexTest) {
+  BuildIndexTestWithIndexType(INDEX_TYPE_BTREE);
+  BuildIndexTestWithIndexType(INDEX_TYPE_OLCBTREE);
+  BuildIndexTestWithIndexType(INDEX_TYPE_BWTREE);
+  BuildIndexTestWithIndexType(INDEX_TYPE_HASH);
+  BuildIndexTestWithIndexType(INDEX_TYPE_ART);
+}
+
+TEST(DataTableTests, BuildUniqueIndexTest) {
+  const int tuples_per_tilegroup = 100;
+  const int tuple_count = 10 * tuples_per_tilegroup;
+
+  // The first column has two distinct values, the second one is unique
+  auto &txn_manager = concurrency::TransactionManager::GetInstance();
+  auto txn = txn_manager.BeginTransaction();
+  std::unique_ptr<storage::DataTable> data_table(
+      ExecutorTestsUtil::CreateTable(tuples_per_tilegroup, false));
+  ExecutorTestsUtil::PopulateTable(txn, data_table.get(), tuple_count, false,
+                                   false, true);
+  txn_manager.CommitTransaction();
+
+  auto tuple_schema = data_table->GetSchema();
+  auto build_unique_index = [&](oid_t column_id, IndexType index_type) {
+    std::vector<oid_t> key_attrs = {column_id};
+    auto key_schema = catalog::Schema::CopySchema(tuple_schema, key_attrs);
+    key_schema->SetIndexedColumns(key_attrs);
+
+    auto index_metadata = new index::IndexMetadata(
+        "unique_index", 126, index_type, INDEX_CONSTRAINT_TYPE_UNIQUE,
+        tuple_schema, key_schema, true);
+    std::unique_ptr<index::Index> index(
+        index::IndexFactory::GetInstance(index_metadata));
+    bool status = data_table->AddIndex(index.get());
+
+    // The table owns the index once it is added
+    if (status == true) index.release();
+    return status;
+  };
+
+  for (auto index_type : {INDEX_TYPE_BTREE, INDEX_TYPE_BWTREE,
+                          INDEX_TYPE_HASH, INDEX_TYPE_ART}) {
+    EXPECT_FALSE(build_unique_index(0, index_type));
+    EXPECT_EQ(0, data_table->GetIndexCount());
+  }
+
+  EXPECT_TRUE(build_unique_index(1, INDEX_TYPE_BTREE));
+  EXPECT_EQ(1, data_table->GetIndexCount());
+
+  // The index rejects duplicates of the existing tuples
+  txn = txn_manager.BeginTransaction();
+  storage::Tuple tuple(tuple_schema, true);
+  auto testing_pool = TestingHarness::GetInstance().GetTestingPool();
+  tuple.SetValue(0, ValueFactory::GetIntegerValue(1), testing_pool);
+  tuple.SetValue(1, ValueFactory::GetIntegerValue(
+                        ExecutorTestsUtil::PopulatedValue(5, 1)),
+                 testing_pool);
+  tuple.SetValue(2, ValueFactory::GetDoubleValue(2), testing_pool);
+  tuple.SetValue(3, ValueFactory::GetStringValue("3"), testing_pool);
+  ItemPointer location = data_table->InsertTuple(txn, &tuple);
+  EXPECT_EQ(INVALID_OID, location.block);
+  txn_manager.AbortTransaction();
+}
+
 }  // End test namespace
 }  // End peloton namespace
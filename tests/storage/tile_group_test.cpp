@@ -10,6 +10,9 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include <chrono>
+#include <thread>
+
 #include "gtest/gtest.h"
 #include "harness.h"
 
@@ -518,5 +521,34 @@ TEST(TileGroupTests, TileCopyTest) {
   delete schema;
 }
 
+// Write-write conflicts on a slot are resolved by wait-die
+TEST(TileGroupTests, WaitDieTest) {
+  storage::TileGroupHeader header(BACKEND_TYPE_MM, 1);
+  oid_t tuple_slot_id = header.GetNextEmptyTupleSlot();
+  header.SetTransactionId(tuple_slot_id, INITIAL_TXN_ID);
+
+  txn_id_t older_txn_id = 10, holder_txn_id = 20, younger_txn_id = 30;
+  EXPECT_TRUE(header.LatchTupleSlot(tuple_slot_id, holder_txn_id));
+
+  // A younger transaction dies right away, on a write-write conflict
+  EXPECT_FALSE(header.LatchTupleSlotOrWait(tuple_slot_id, younger_txn_id));
+  EXPECT_TRUE(header.IsWriteConflict(tuple_slot_id, younger_txn_id));
+  EXPECT_FALSE(header.IsWriteConflict(tuple_slot_id, holder_txn_id));
+
+  // An older transaction gives up once it has waited long enough
+  EXPECT_FALSE(header.LatchTupleSlotOrWait(tuple_slot_id, older_txn_id));
+  EXPECT_EQ(header.GetTransactionId(tuple_slot_id), holder_txn_id);
+
+  // It gets the latch if the holder ends in the meantime
+  std::thread holder([&] {
+    std::this_thread::sleep_for(std::chrono::microseconds(500));
+    header.ReleaseTupleSlot(tuple_slot_id, holder_txn_id);
+  });
+  EXPECT_TRUE(header.LatchTupleSlotOrWait(tuple_slot_id, older_txn_id));
+  holder.join();
+
+  EXPECT_EQ(header.GetTransactionId(tuple_slot_id), older_txn_id);
+}
+
 }  // End test namespace
 }  // End peloton namespace